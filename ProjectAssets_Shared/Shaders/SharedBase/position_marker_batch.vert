@@ -0,0 +1,36 @@
+uniform mat4 inverseViewMatrix;
+
+// Per instance data.  Every marker is an instance of the same mesh.
+attribute vec3 markerPosition;
+attribute vec4 markerColor;
+
+varying vec3 vNormal;
+varying vec3 vLightDir;
+varying float vFog;
+varying float vDistance;
+varying vec3 vPos;
+varying vec4 vMarkerColor;
+
+void calculateDistance(mat4, vec4, out float);
+float computeFog(float, float, float);
+
+
+void main()
+{
+   // The batch is in world space, so the marker position just offsets the mesh.
+   vec4 vertex = vec4(gl_Vertex.xyz + markerPosition, 1.0);
+   gl_Position = gl_ModelViewProjectionMatrix * vertex;
+   gl_TexCoord[0]  = gl_MultiTexCoord0;
+   vMarkerColor = markerColor;
+
+   //moves the position, normal, and light direction into world space   
+   vPos = (inverseViewMatrix * gl_ModelViewMatrix * vertex).xyz;
+   mat3 inverseView3x3 = mat3(inverseViewMatrix[0].xyz, inverseViewMatrix[1].xyz, inverseViewMatrix[2].xyz);
+
+   vNormal = inverseView3x3 * gl_NormalMatrix * gl_Normal;
+
+   vLightDir = normalize(inverseView3x3 * gl_LightSource[0].position.xyz);
+
+   calculateDistance(gl_ModelViewMatrix, vertex, vDistance);
+   vFog = computeFog(gl_Fog.end * 0.15, gl_Fog.end, vDistance);  
+}
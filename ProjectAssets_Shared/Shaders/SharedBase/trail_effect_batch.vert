@@ -0,0 +1,14 @@
+uniform mat4 inverseViewMatrix;
+
+// Batched trails carry their width in the third texture coordinate
+// since many trails share one geometry and one set of uniforms.
+void main(void)
+{
+   vec3 widthNormal = cross(gl_Normal.xyz, gl_Color.xyz) * gl_Color.w;
+   widthNormal = normalize(widthNormal);
+   widthNormal *= gl_MultiTexCoord0.z * 0.5; // direction;
+   
+   gl_Position = ftransform() + (gl_ProjectionMatrix * gl_ModelViewMatrix * vec4(widthNormal, 0.0));
+   
+   gl_TexCoord[0]  = vec4(gl_MultiTexCoord0.xy, 0.0, 1.0);
+}
@@ -0,0 +1,122 @@
+/* -*-c++-*-
+* Using 'The MIT License'
+* Copyright (C) 2009, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+*/
+#ifndef NETDEMO_AIAGENTBATCH_H
+#define NETDEMO_AIAGENTBATCH_H
+
+#include <DemoExport.h>
+#include <AIUtility.h>
+#include <AIPhysicsModel.h>
+
+#include <osg/Referenced>
+#include <osg/Vec3>
+
+#include <vector>
+
+namespace NetDemo
+{
+   class BaseAIHelper;
+
+   /**
+   * Steps the steering behavior and the physics model of many AI agents that use the same kind of steering behavior.
+   * The state of the agents is copied into one array per field, so the steering math runs in a tight loop over
+   * the agents without the virtual Think call, and separate ranges of agents can be stepped on different threads.
+   *
+   * AddAgent copies the state from a helper, Step runs the math, and Scatter writes the results back to the
+   * helpers and pushes their physics objects, which has to happen on the main thread.
+   */
+   class NETDEMO_EXPORT AIAgentBatch: public osg::Referenced
+   {
+   public:
+      enum BehaviorType
+      {
+         BEHAVIOR_NONE, //no behavior, or DoNothing, so only the physics model is stepped
+         BEHAVIOR_ALIGN,
+         BEHAVIOR_FOLLOW_PATH,
+         BEHAVIOR_BOMB_DIVE,
+         NUM_BEHAVIOR_TYPES,
+         BEHAVIOR_UNKNOWN = NUM_BEHAVIOR_TYPES //a behavior the batches don't know how to step
+      };
+
+      /// @return the kind of steering behavior the helper is currently using.
+      static BehaviorType GetBehaviorType(const BaseAIHelper& helper);
+
+      AIAgentBatch(BehaviorType type);
+
+      BehaviorType GetType() const;
+
+      /// Copies the state, goal, controls and behavior settings of the helper to the end of the arrays.
+      void AddAgent(BaseAIHelper& helper);
+      void Clear();
+
+      unsigned GetNumAgents() const;
+      BaseAIHelper* GetAgent(unsigned index);
+
+      /**
+      * Steps the agents in [begin, end).  This only touches the arrays, so ranges that don't overlap
+      * can be stepped on different threads.
+      */
+      void Step(float dt, unsigned begin, unsigned end);
+
+      /// Writes the state and the controls back to the helpers and applies the forces of the physics model.
+      void Scatter(float dt);
+
+   protected:
+      virtual ~AIAgentBatch();
+
+   private:
+      void StepPhysicsModel(float dt, unsigned begin, unsigned end);
+
+      BehaviorType mType;
+      std::vector<BaseAIHelper*> mAgents;
+      std::vector<unsigned char> mUsesPhysicsModel;
+
+      //BaseAIGameState
+      std::vector<osg::Vec3> mPos;
+      std::vector<osg::Vec3> mForward;
+      std::vector<osg::Vec3> mUp;
+      std::vector<osg::Vec3> mVel;
+      std::vector<float> mAngularVel;
+      std::vector<float> mVerticalVel;
+      std::vector<float> mVerticalAccel;
+      std::vector<float> mPitch;
+      std::vector<float> mRoll;
+      std::vector<float> mTimeStep;
+
+      //BaseAIGoalState, the limits are only read together by the physics model
+      std::vector<osg::Vec3> mGoalPos;
+      std::vector<AIPhysicsModel::Limits> mLimits;
+
+      //BaseAIControls
+      std::vector<float> mThrust;
+      std::vector<float> mLift;
+      std::vector<float> mYaw;
+
+      //the behavior settings, the time to target of an Align or the speed of a BombDive
+      std::vector<float> mBehaviorValue;
+      std::vector<FollowPathSettings> mFollowPathSettings;
+   };
+
+} //namespace NetDemo
+
+#endif //NETDEMO_AIAGENTBATCH_H
@@ -41,6 +41,27 @@ namespace NetDemo
    class NETDEMO_EXPORT AIPhysicsModel: public osg::Referenced
    {
    public:
+     /**
+     * The constraints of the goal state that the physics model reads.
+     */
+     struct Limits
+     {
+        Limits();
+        explicit Limits(const BaseAIGoalState& goal);
+
+        float mDragCoef;
+        float mVerticalDragCoef;
+        float mMaxVel;
+        float mMaxAccel;
+        float mMaxAngularVel;
+        float mMaxVerticalVel;
+        float mMaxVerticalAccel;
+        float mMaxPitch;
+        float mMaxRoll;
+        float mMaxTiltPerSecond;
+        float mMaxRollPerSecond;
+     };
+
      AIPhysicsModel();
 
      virtual void Init();
@@ -58,6 +79,27 @@ namespace NetDemo
 
      //not const because it may clamp timestep
      float GetCurrentTimeStep();
+     void SetCurrentTimeStep(float dt);
+
+     /**
+     * Pushes the physics object along with the thrust and lift of the controls.  This is the last part of Update,
+     * which AIAgentBatch calls on the main thread after it has stepped the state of the agent.
+     */
+     void ApplyControlForces(const BaseAIGameState& state, const BaseAIControls& controls);
+
+     /**
+     * Steps the state of one agent with its controls, which is Update without the forces.  Update and
+     * AIAgentBatch both call this.  dt is the clamped time step of the model, which turns the heading,
+     * and timeStep is the time step of the state, which moves everything else.
+     */
+     static void Integrate(float dt, float timeStep, float thrust, float lift, float yaw, const Limits& limits,
+              osg::Vec3& pos, osg::Vec3& forward, osg::Vec3& up, osg::Vec3& vel,
+              float& angularVel, float& verticalVel, float& verticalAccel, float& pitch, float& roll);
+
+     /// @return the time step limited to the range the model allows.
+     static float ClampTimeStep(float dt);
+     static float Clamp(float x, float from, float to);
+     static float Dampen(float last, float current, float max, float falloff);
 
    protected:
      AIPhysicsModel(const AIPhysicsModel&);  //not implemented by design
@@ -65,16 +107,6 @@ namespace NetDemo
      ~AIPhysicsModel();
 
      void ClampTimeStep();
-     void UpdateHeading(const BaseAIControls& controls);
-     void UpdatePosition(const BaseAIControls& controls);
-     void UpdateVelocity(const BaseAIControls& controls);
-     void UpdateAngularVelocity(const BaseAIControls& controls);
-     void UpdateVerticalVelocity(const BaseAIControls& controls);
-     void UpdateTilt(const BaseAIControls& controls, osg::Vec3& tilt);
-     void UpdateRoll(const BaseAIControls& controls, osg::Vec3& roll);
-     void OrthoNormalize(BaseAIGameState& stateIn);
-     float Clamp(float x, float from, float to);
-     float Dampen(float last, float current, float max, float falloff);
 
      float mTimeStep;
 
@@ -58,6 +58,8 @@ namespace NetDemo
 
      const SteeringBehaviorArray& GetSteeringBehaviors() const;
      bool SetCurrentSteeringBehavior(unsigned id);
+     /// @return the behavior OutputControl uses, or NULL if there isn't one.
+     BaseAISteeringBehavior* GetCurrentSteeringBehavior() const;
 
      unsigned AddSteeringBehavior(BaseAISteeringBehavior* steeringbehavior);
 
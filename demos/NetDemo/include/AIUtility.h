@@ -225,10 +225,18 @@ namespace NetDemo
 
       /*virtual*/ void Think(float dt, BaseClass::ConstKinematicGoalParam current_goal, BaseClass::ConstKinematicParam current_state, BaseClass::SteeringOutByRefParam result);
 
+      float GetTimeToTarget() const { return mTimeToTarget; }
+
+      /**
+      * The math behind Think, without the virtual call or the state structs, so AIAgentBatch can run it over many agents.
+      * @return the yaw control.
+      */
+      static float ComputeYaw(float dt, float timeToTarget, const osg::Vec3& goalPos, const osg::Vec3& forward, float angularVel);
+
    protected:
-      float Sgn(float x);
-      osg::Vec3 GetTargetPosition(float dt, const BaseAIGoalState& goal);
-      float GetTargetForward(float dt, const osg::Vec3& targetPos, const BaseAIGoalState& current_goal, const BaseAIGameState& current_state, osg::Vec3& vec_in);
+      static float Sgn(float x);
+      static osg::Vec3 GetTargetPosition(float dt, const osg::Vec3& goalPos);
+      static float GetTargetForward(float dt, const osg::Vec3& targetPos, const osg::Vec3& pos, const osg::Vec3& vel, osg::Vec3& vec_in);
 
       float mLookAhead, mTimeToTarget;
    };
@@ -243,10 +251,27 @@ namespace NetDemo
 
       /*virtual*/ void Think(float dt, BaseClass::ConstKinematicGoalParam current_goal, BaseClass::ConstKinematicParam current_state, BaseClass::SteeringOutByRefParam result);
 
+      float GetSpeed() const { return mSpeed; }
+
+      /// The math behind Think.  @return the thrust control.
+      static float ComputeThrust(float speed, const osg::Vec3& goalPos, const osg::Vec3& pos, const osg::Vec3& vel);
+
    private:
       float mSpeed;
    };
 
+   /**
+   * The settings of a FollowPath, kept together so AIAgentBatch can store them per agent.
+   */
+   struct FollowPathSettings
+   {
+      FollowPathSettings(float minSpeed = 0.0f, float maxSpeed = 0.0f, float lookAhead = 0.0f, float timeToTarget = 0.0f,
+               float timeToTargetHeight = 0.0f, float lookAheadRot = 0.0f, float timeToTargetRot = 0.0f);
+
+      float mMinSpeed, mMaxSpeed, mLookAhead, mTimeToTarget, mTimeToTargetHeight;
+      float mLookAheadRot, mTimeToTargetRot;
+   };
+
    /**
    * Follow path can be used to follow waypoints
    */
@@ -257,18 +282,20 @@ namespace NetDemo
 
       FollowPath(float minSpeed, float maxSpeed, float lookAhead, float timeToTarget, float timeToTargetHeight, float lookAheadRot, float timeToTargetRot)
          : BaseClass(lookAheadRot, timeToTargetRot)
-         , mMinSpeed(minSpeed)
-         , mMaxSpeed(maxSpeed)
-         , mLookAhead(lookAhead)
-         , mTimeToTarget(timeToTarget)
-         , mTimeToTargetHeight(timeToTargetHeight)
+         , mSettings(minSpeed, maxSpeed, lookAhead, timeToTarget, timeToTargetHeight, lookAheadRot, timeToTargetRot)
       {}
 
       /*virtual*/ void Think(float dt, BaseClass::ConstKinematicGoalParam current_goal, BaseClass::ConstKinematicParam current_state, BaseClass::SteeringOutByRefParam result);
 
+      const FollowPathSettings& GetSettings() const { return mSettings; }
+
+      /// The math behind Think.  Sets the thrust, lift and yaw of the result.
+      static void ComputeControls(float dt, const FollowPathSettings& settings, const osg::Vec3& goalPos, const osg::Vec3& pos,
+               const osg::Vec3& forward, const osg::Vec3& vel, float angularVel, BaseAIControls& result);
+
    private:
 
-      float mMinSpeed, mMaxSpeed, mLookAhead, mTimeToTarget, mTimeToTargetHeight;
+      FollowPathSettings mSettings;
    };
 
 
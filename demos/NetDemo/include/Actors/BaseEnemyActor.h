@@ -71,6 +71,8 @@ namespace NetDemo
          // Called when the actor has been added to the game manager.
          // You can respond to OnEnteredWorld on either the proxy or actor or both.
          virtual void OnEnteredWorld();
+         /// Takes the AI out of the AIAgentComponent.
+         virtual void OnRemovedFromWorld();
 
          virtual void OnTickLocal(const dtGame::TickMessage& tickMessage);
          virtual void OnTickRemote(const dtGame::TickMessage& tickMessage);
@@ -61,6 +61,19 @@ namespace NetDemo
       virtual void Spawn();
       virtual void Update(float dt);
 
+      /**
+      * When the step is batched, Update only runs the state machine and the steering pipeline up to the
+      * controls, and an AIAgentComponent steps the steering behavior and the physics model with the other agents.
+      */
+      void SetStepBatched(bool batched);
+      bool IsStepBatched() const;
+
+      /// Runs the steering behavior and the physics model the way Update does, for an agent the batches can't step.
+      void StepUnbatched(float dt);
+
+      /// @return false if Update moves the agent without the physics model, so a batch should only run the steering.
+      virtual bool UsesPhysicsModel() const;
+
       virtual void PreSync(const dtCore::Transform& trans);
       virtual void PostSync(dtCore::Transform& trans) const;
 
@@ -116,6 +129,7 @@ namespace NetDemo
       dtCore::RefPtr<AIPhysicsModel> mPhysicsModel;
       
       BaseSteeringTargeter* mDefaultTargeter;
+      bool mStepBatched;
 
       dtUtil::RefString mPrototypeName;
    };
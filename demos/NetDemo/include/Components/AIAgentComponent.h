@@ -0,0 +1,112 @@
+/* -*-c++-*-
+* Delta3D Open Source Game and Simulation Engine
+* Copyright (C) 2009, Alion Science and Technology, BMH Operation
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef NETDEMO_AIAGENTCOMPONENT
+#define NETDEMO_AIAGENTCOMPONENT
+
+#include <DemoExport.h>
+#include <AIAgentBatch.h>
+
+#include <dtCore/refptr.h>
+#include <dtGame/gmcomponent.h>
+#include <dtUtil/getsetmacros.h>
+
+#include <vector>
+
+namespace NetDemo
+{
+   class AIAgentStepTask;
+   class BaseAIHelper;
+
+   /**
+   * Steps the steering behaviors and physics models of the enemy AI in batches grouped by the type
+   * of steering behavior, instead of one agent at a time from each actor's tick.  Large batches are split
+   * across the thread pool.  The actors still run their state machines on the local tick, and the
+   * agents are stepped after that, on the remote tick.
+   */
+   class NETDEMO_EXPORT AIAgentComponent : public dtGame::GMComponent
+   {
+   public:
+      typedef dtGame::GMComponent BaseClass;
+      static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+      static const std::string DEFAULT_NAME;
+
+      static const unsigned DEFAULT_MIN_AGENTS_PER_TASK;
+
+      /// Constructor
+      AIAgentComponent(dtCore::SystemComponentType& type = *TYPE);
+
+      /**
+      * Handles incoming messages
+      */
+      virtual void ProcessMessage(const dtGame::Message& message);
+
+      virtual void OnRemovedFromGM();
+
+      /// Whether to split the batches across the thread pool.
+      DT_DECLARE_ACCESSOR(bool, UseWorkerThreads);
+      /// The fewest agents worth giving a thread pool task.
+      DT_DECLARE_ACCESSOR(unsigned, MinAgentsPerTask);
+
+      /// Adds the agent and marks it step batched, so its own Update only runs the state machine and targeters.
+      void AddAgent(BaseAIHelper& helper);
+      /// Removes the agent and lets it step itself again.
+      void RemoveAgent(BaseAIHelper& helper);
+      bool HasAgent(const BaseAIHelper& helper) const;
+      unsigned GetNumAgents() const;
+
+      /// Steps the steering behaviors and physics models of all the agents and writes the results back.
+      void StepAgents(float dt);
+
+      /// @return how many agents of the type the last StepAgents stepped.  BEHAVIOR_UNKNOWN counts those stepped one at a time.
+      unsigned GetNumStepped(AIAgentBatch::BehaviorType type) const;
+
+      struct BenchmarkResult
+      {
+         BenchmarkResult();
+
+         unsigned mNumAgents;
+         unsigned mNumFrames;
+         double mUnbatchedMillis;
+         double mBatchedMillis;
+         /// The largest distance between where an agent ended up stepped one way and the other.
+         float mMaxPositionDifference;
+      };
+
+      /**
+      * Creates agents without actors, half following paths and half dive bombing, and steps them for a number of frames,
+      * once with each helper updating itself and once with an AIAgentComponent.  The times are logged.
+      */
+      static BenchmarkResult RunBenchmark(unsigned numAgents, unsigned numFrames, bool useWorkerThreads = true);
+
+   protected:
+
+      /// Destructor
+      virtual ~AIAgentComponent();
+
+   private:
+      std::vector<dtCore::RefPtr<BaseAIHelper> > mAgents;
+      std::vector<BaseAIHelper*> mUnknownAgents;
+      dtCore::RefPtr<AIAgentBatch> mBatches[AIAgentBatch::NUM_BEHAVIOR_TYPES];
+      std::vector<dtCore::RefPtr<AIAgentStepTask> > mTasks;
+      unsigned mNumStepped[AIAgentBatch::NUM_BEHAVIOR_TYPES + 1];
+   };
+}//namespace NetDemo
+
+#endif //NETDEMO_AIAGENTCOMPONENT
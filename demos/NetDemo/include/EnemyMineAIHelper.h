@@ -52,6 +52,9 @@ namespace NetDemo
          /*virtual*/ void Spawn();
          /*virtual*/ void Update(float dt);
 
+         /// The mine pushes itself at its target in Update instead of using the physics model.
+         /*virtual*/ bool UsesPhysicsModel() const;
+
       protected:
          EnemyMineAIHelper(const EnemyMineAIHelper&);  //not implemented by design
          EnemyMineAIHelper& operator=(const EnemyMineAIHelper&);  //not implemented by design
@@ -57,6 +57,7 @@ namespace NetDemo
          virtual void InitializeComponents(dtGame::GameManager& gm);
 
       private:
+         int mAIBenchmarkAgents;
    };
 }
 
@@ -0,0 +1,246 @@
+/* -*-c++-*-
+* Using 'The MIT License'
+* Copyright (C) 2009, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+*/
+
+#include <AIAgentBatch.h>
+#include <AIPhysicsModel.h>
+#include <BaseAIHelper.h>
+
+#include <typeinfo>
+
+namespace NetDemo
+{
+
+   //////////////////////////////////////////////////////////////////////////
+   //AIAgentBatch
+   //////////////////////////////////////////////////////////////////////////
+   AIAgentBatch::BehaviorType AIAgentBatch::GetBehaviorType(const BaseAIHelper& helper)
+   {
+      const BaseAISteeringBehavior* behavior = helper.GetSteeringModel()->GetCurrentSteeringBehavior();
+
+      //exact types only, a subclass may have overridden Think
+      if(behavior == NULL || typeid(*behavior) == typeid(DoNothing))
+      {
+         return BEHAVIOR_NONE;
+      }
+      else if(typeid(*behavior) == typeid(FollowPath))
+      {
+         return BEHAVIOR_FOLLOW_PATH;
+      }
+      else if(typeid(*behavior) == typeid(Align))
+      {
+         return BEHAVIOR_ALIGN;
+      }
+      else if(typeid(*behavior) == typeid(BombDive))
+      {
+         return BEHAVIOR_BOMB_DIVE;
+      }
+
+      return BEHAVIOR_UNKNOWN;
+   }
+
+   AIAgentBatch::AIAgentBatch(BehaviorType type)
+      : mType(type)
+   {
+   }
+
+   AIAgentBatch::~AIAgentBatch()
+   {
+   }
+
+   AIAgentBatch::BehaviorType AIAgentBatch::GetType() const
+   {
+      return mType;
+   }
+
+   unsigned AIAgentBatch::GetNumAgents() const
+   {
+      return unsigned(mAgents.size());
+   }
+
+   BaseAIHelper* AIAgentBatch::GetAgent(unsigned index)
+   {
+      return mAgents[index];
+   }
+
+   void AIAgentBatch::Clear()
+   {
+      //clear keeps the capacity, so refilling the batch each frame doesn't allocate
+      mAgents.clear();
+      mUsesPhysicsModel.clear();
+
+      mPos.clear();
+      mForward.clear();
+      mUp.clear();
+      mVel.clear();
+      mAngularVel.clear();
+      mVerticalVel.clear();
+      mVerticalAccel.clear();
+      mPitch.clear();
+      mRoll.clear();
+      mTimeStep.clear();
+
+      mGoalPos.clear();
+      mLimits.clear();
+
+      mThrust.clear();
+      mLift.clear();
+      mYaw.clear();
+
+      mBehaviorValue.clear();
+      mFollowPathSettings.clear();
+   }
+
+   void AIAgentBatch::AddAgent(BaseAIHelper& helper)
+   {
+      mAgents.push_back(&helper);
+      mUsesPhysicsModel.push_back(helper.UsesPhysicsModel() ? 1 : 0);
+
+      const BaseAIGameState& state = helper.mCurrentState;
+      mPos.push_back(state.GetPos());
+      mForward.push_back(state.GetForward());
+      mUp.push_back(state.GetUp());
+      mVel.push_back(state.GetVel());
+      mAngularVel.push_back(state.GetAngularVel());
+      mVerticalVel.push_back(state.GetVerticalVel());
+      mVerticalAccel.push_back(state.GetVerticalAccel());
+      mPitch.push_back(state.GetPitch());
+      mRoll.push_back(state.GetRoll());
+      mTimeStep.push_back(state.GetTimeStep());
+
+      const BaseAIGoalState& goal = helper.mGoalState;
+      mGoalPos.push_back(goal.GetPos());
+      mLimits.push_back(AIPhysicsModel::Limits(goal));
+
+      const BaseAIControls& controls = helper.mCurrentControls;
+      mThrust.push_back(controls.GetThrust());
+      mLift.push_back(controls.GetLift());
+      mYaw.push_back(controls.GetYaw());
+
+      //GetBehaviorType has already matched the exact type of the behavior
+      const BaseAISteeringBehavior* behavior = helper.GetSteeringModel()->GetCurrentSteeringBehavior();
+      float behaviorValue = 0.0f;
+      if(mType == BEHAVIOR_FOLLOW_PATH)
+      {
+         mFollowPathSettings.push_back(static_cast<const FollowPath*>(behavior)->GetSettings());
+      }
+      else if(mType == BEHAVIOR_ALIGN)
+      {
+         behaviorValue = static_cast<const Align*>(behavior)->GetTimeToTarget();
+      }
+      else if(mType == BEHAVIOR_BOMB_DIVE)
+      {
+         behaviorValue = static_cast<const BombDive*>(behavior)->GetSpeed();
+      }
+      mBehaviorValue.push_back(behaviorValue);
+   }
+
+   void AIAgentBatch::Step(float dt, unsigned begin, unsigned end)
+   {
+      //the behaviors are given the time step of the state, the same as AISteeringModel::OutputControl
+      switch(mType)
+      {
+      case BEHAVIOR_ALIGN:
+         for(unsigned i = begin; i < end; ++i)
+         {
+            mYaw[i] = Align::ComputeYaw(mTimeStep[i], mBehaviorValue[i], mGoalPos[i], mForward[i], mAngularVel[i]);
+         }
+         break;
+
+      case BEHAVIOR_FOLLOW_PATH:
+         {
+            BaseAIControls controls;
+            for(unsigned i = begin; i < end; ++i)
+            {
+               FollowPath::ComputeControls(mTimeStep[i], mFollowPathSettings[i], mGoalPos[i], mPos[i],
+                        mForward[i], mVel[i], mAngularVel[i], controls);
+               mThrust[i] = controls.GetThrust();
+               mLift[i] = controls.GetLift();
+               mYaw[i] = controls.GetYaw();
+            }
+         }
+         break;
+
+      case BEHAVIOR_BOMB_DIVE:
+         for(unsigned i = begin; i < end; ++i)
+         {
+            mThrust[i] = BombDive::ComputeThrust(mBehaviorValue[i], mGoalPos[i], mPos[i], mVel[i]);
+         }
+         break;
+
+      default:
+         break;
+      }
+
+      StepPhysicsModel(AIPhysicsModel::ClampTimeStep(dt), begin, end);
+   }
+
+   void AIAgentBatch::StepPhysicsModel(float dt, unsigned begin, unsigned end)
+   {
+      for(unsigned i = begin; i < end; ++i)
+      {
+         if(mUsesPhysicsModel[i] == 0)
+         {
+            continue;
+         }
+
+         AIPhysicsModel::Integrate(dt, mTimeStep[i], mThrust[i], mLift[i], mYaw[i], mLimits[i],
+                  mPos[i], mForward[i], mUp[i], mVel[i], mAngularVel[i], mVerticalVel[i], mVerticalAccel[i],
+                  mPitch[i], mRoll[i]);
+      }
+   }
+
+   void AIAgentBatch::Scatter(float dt)
+   {
+      for(unsigned i = 0; i < mAgents.size(); ++i)
+      {
+         BaseAIHelper& helper = *mAgents[i];
+
+         BaseAIControls& controls = helper.mCurrentControls;
+         controls.SetThrust(mThrust[i]);
+         controls.SetLift(mLift[i]);
+         controls.SetYaw(mYaw[i]);
+
+         if(mUsesPhysicsModel[i] == 0)
+         {
+            continue;
+         }
+
+         BaseAIGameState& state = helper.mCurrentState;
+         state.SetPos(mPos[i]);
+         state.SetForward(mForward[i]);
+         state.SetUp(mUp[i]);
+         state.SetVel(mVel[i]);
+         state.SetAngularVel(mAngularVel[i]);
+         state.SetVerticalVel(mVerticalVel[i]);
+         state.SetVerticalAccel(mVerticalAccel[i]);
+         state.SetPitch(mPitch[i]);
+         state.SetRoll(mRoll[i]);
+
+         AIPhysicsModel* physicsModel = helper.GetPhysicsModel();
+         physicsModel->SetCurrentTimeStep(dt);
+         physicsModel->ApplyControlForces(state, controls);
+      }
+   }
+
+} //namespace NetDemo
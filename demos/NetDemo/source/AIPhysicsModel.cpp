@@ -33,9 +33,41 @@
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/matrixutil.h>
 
+#include <cmath>
+
 namespace NetDemo
 {
 
+   AIPhysicsModel::Limits::Limits()
+      : mDragCoef(0.0f)
+      , mVerticalDragCoef(0.0f)
+      , mMaxVel(0.0f)
+      , mMaxAccel(0.0f)
+      , mMaxAngularVel(0.0f)
+      , mMaxVerticalVel(0.0f)
+      , mMaxVerticalAccel(0.0f)
+      , mMaxPitch(0.0f)
+      , mMaxRoll(0.0f)
+      , mMaxTiltPerSecond(0.0f)
+      , mMaxRollPerSecond(0.0f)
+   {
+   }
+
+   AIPhysicsModel::Limits::Limits(const BaseAIGoalState& goal)
+      : mDragCoef(goal.GetDragCoef())
+      , mVerticalDragCoef(goal.GetVerticalDragCoef())
+      , mMaxVel(goal.GetMaxVel())
+      , mMaxAccel(goal.GetMaxAccel())
+      , mMaxAngularVel(goal.GetMaxAngularVel())
+      , mMaxVerticalVel(goal.GetMaxVerticalVel())
+      , mMaxVerticalAccel(goal.GetMaxVerticalAccel())
+      , mMaxPitch(goal.GetMaxPitch())
+      , mMaxRoll(goal.GetMaxRoll())
+      , mMaxTiltPerSecond(goal.GetMaxTiltPerSecond())
+      , mMaxRollPerSecond(goal.GetMaxRollPerSecond())
+   {
+   }
+
    AIPhysicsModel::AIPhysicsModel()
       : mTimeStep(0.0f)
       , mCurrentState(NULL)
@@ -69,34 +101,107 @@ namespace NetDemo
       mTimeStep = dt;
       ClampTimeStep();
 
-      osg::Vec3 tempUpVector(0.0f, 0.0f, 1.0f);
-
       mCurrentState = &aiAgent.mCurrentState;
       mGoalState = &aiAgent.mGoalState;
 
       const BaseAIControls& steeringOut = aiAgent.mCurrentControls;
+      BaseAIGameState& state = *mCurrentState;
+
+      osg::Vec3 pos = state.GetPos();
+      osg::Vec3 forward = state.GetForward();
+      osg::Vec3 up = state.GetUp();
+      osg::Vec3 vel = state.GetVel();
+      float angularVel = state.GetAngularVel();
+      float verticalVel = state.GetVerticalVel();
+      float verticalAccel = state.GetVerticalAccel();
+      float pitch = state.GetPitch();
+      float roll = state.GetRoll();
+
+      Integrate(mTimeStep, state.GetTimeStep(), steeringOut.GetThrust(), steeringOut.GetLift(), steeringOut.GetYaw(),
+               Limits(*mGoalState), pos, forward, up, vel, angularVel, verticalVel, verticalAccel, pitch, roll);
+
+      state.SetPos(pos);
+      state.SetForward(forward);
+      state.SetUp(up);
+      state.SetVel(vel);
+      state.SetAngularVel(angularVel);
+      state.SetVerticalVel(verticalVel);
+      state.SetVerticalAccel(verticalAccel);
+      state.SetPitch(pitch);
+      state.SetRoll(roll);
+
+      ApplyControlForces(state, steeringOut);
+   }
 
-      UpdateTilt(steeringOut, tempUpVector);
-      UpdateVelocity(steeringOut);
+   void AIPhysicsModel::Integrate(float dt, float timeStep, float thrust, float lift, float yaw, const Limits& limits,
+            osg::Vec3& pos, osg::Vec3& forward, osg::Vec3& up, osg::Vec3& vel,
+            float& angularVel, float& verticalVel, float& verticalAccel, float& pitch, float& roll)
+   {
+      //tilt, the model used to rotate an up vector by the pitch here, but it never used the result
+      pitch = Dampen(pitch, thrust * limits.mMaxPitch, limits.mMaxTiltPerSecond * timeStep, pitch / limits.mMaxPitch);
+      pitch = Clamp(pitch, -limits.mMaxPitch, limits.mMaxPitch);
 
-      UpdateRoll(steeringOut, tempUpVector);
-      UpdateAngularVelocity(steeringOut);
+      //velocity
+      float maxAccel = limits.mMaxAccel * timeStep;
+      osg::Vec3 newVel = vel;
+      newVel += forward * Clamp((thrust * limits.mMaxVel) - vel.length(), -maxAccel, maxAccel);
+      newVel -= vel * limits.mDragCoef;
 
-      UpdateVerticalVelocity(steeringOut);
+      //we don't clamp the controls so this is necessary
+      if (newVel.length() > limits.mMaxVel)
+      {
+         newVel.normalize();
+         newVel *= limits.mMaxVel;
+      }
+      vel = newVel;
+
+      //roll, the same as the tilt
+      roll = Dampen(roll, yaw * limits.mMaxRoll, limits.mMaxRollPerSecond * timeStep, roll / limits.mMaxRoll);
+      if (roll > limits.mMaxRoll) roll = limits.mMaxRoll;
+      else if (roll < -limits.mMaxRoll) roll = -limits.mMaxRoll;
 
-      UpdateHeading(steeringOut);
-      UpdatePosition(steeringOut);
+      //angular velocity
+      angularVel = yaw * limits.mMaxAngularVel;
 
-      OrthoNormalize(*mCurrentState);
+      //vertical velocity
+      verticalAccel = lift * limits.mMaxVerticalAccel;
+      verticalVel += verticalAccel * timeStep;
+      verticalVel -= verticalVel * limits.mVerticalDragCoef;
+      verticalVel = Clamp(verticalVel, -limits.mMaxVerticalVel, limits.mMaxVerticalVel);
+
+      //heading, the rotation about z that osg::Matrix::rotate makes, written out
+      //since the AI does not currently use acceleration (just simplifies things quite a bit)
+      //we are doing this to smooth out the ability to change heading
+      float thetaAngle = angularVel * dt;
+      float cosTheta = std::cos(thetaAngle);
+      float sinTheta = std::sin(thetaAngle);
+      osg::Vec3 deltaForward(forward[0] * cosTheta - forward[1] * sinTheta,
+                             forward[0] * sinTheta + forward[1] * cosTheta,
+                             forward[2]);
+      forward = (forward + forward + deltaForward) / 3.0f;
+
+      //position
+      pos += vel * timeStep;
+      pos[2] += verticalVel * timeStep;
+
+      //ortho normalize
+      forward.normalize();
+      osg::Vec3 rightVector = forward ^ osg::Vec3(0.0f, 0.0f, 1.0f);
+      rightVector.normalize();
+      up = rightVector ^ forward;
+      up.normalize();
+   }
 
+   void AIPhysicsModel::ApplyControlForces(const BaseAIGameState& state, const BaseAIControls& steeringOut)
+   {
       if(mPhysicsActComp.valid())
       {
          dtPhysics::PhysicsObject* physicsObject = GetPhysicsActComp()->GetMainPhysicsObject();
 
          if(physicsObject != NULL)
          {
-            osg::Vec3 up = mCurrentState->GetUp();
-            osg::Vec3 at = mCurrentState->GetForward();
+            osg::Vec3 up = state.GetUp();
+            osg::Vec3 at = state.GetForward();
             
             float maxLiftForce = 20.0f;
             float maxThrustForce = 10.0f;
@@ -193,109 +298,6 @@ namespace NetDemo
    }
 
 
-   void AIPhysicsModel::OrthoNormalize(BaseAIGameState& currentState)
-   {
-      osg::Vec3 tempUpVector(0.0f, 0.0f, 1.0f);
-
-      osg::Vec3 fwd = currentState.GetForward();
-      fwd.normalize();
-      currentState.SetForward(fwd);
-
-      osg::Vec3 rightVector = currentState.GetForward() ^ tempUpVector;
-      rightVector.normalize();
-      osg::Vec3 up = rightVector ^ currentState.GetForward();
-      up.normalize();
-      currentState.SetUp(up);
-   }
-
-   void AIPhysicsModel::UpdateHeading(const BaseAIControls& controls)
-   {
-      float thetaAngle = mCurrentState->GetAngularVel() * mTimeStep;
-
-      osg::Matrix rotation = osg::Matrix::rotate(thetaAngle, osg::Vec3(0.0, 0.0, 1.0));
-
-      //since the AI does not currently use acceleration (just simplifies things quite a bit)
-      //we are doing this to smooth out the ability to change heading
-      osg::Vec3 deltaForward = osg::Matrix::transform3x3(mCurrentState->GetForward(), rotation);
-      osg::Vec3 newForward = mCurrentState->GetForward() + mCurrentState->GetForward() + deltaForward;
-      newForward /= 3.0f;
-      mCurrentState->SetForward(newForward);
-   }
-
-   void AIPhysicsModel::UpdateAngularVelocity(const BaseAIControls& controls)
-   {
-      float newVelocity = controls.GetYaw() * mGoalState->GetMaxAngularVel();
-      mCurrentState->SetAngularVel(newVelocity);
-   }
-
-   void AIPhysicsModel::UpdateVerticalVelocity(const BaseAIControls& controls)
-   {
-      //update acceleration
-      mCurrentState->SetVerticalAccel(controls.GetLift() * mGoalState->GetMaxVerticalAccel());
-
-      //update velocity
-      mCurrentState->SetVerticalVel(mCurrentState->GetVerticalVel() + (mCurrentState->GetVerticalAccel() * mCurrentState->GetTimeStep()));
-      mCurrentState->SetVerticalVel(mCurrentState->GetVerticalVel() - (mCurrentState->GetVerticalVel() * mGoalState->GetVerticalDragCoef()));
-      mCurrentState->SetVerticalVel(Clamp(mCurrentState->GetVerticalVel(), -mGoalState->GetMaxVerticalVel(), mGoalState->GetMaxVerticalVel()));
-   }
-
-   void AIPhysicsModel::UpdatePosition(const BaseAIControls& controls)
-   {
-      osg::Vec3 newPos = mCurrentState->GetPos() + (mCurrentState->GetVel() * mCurrentState->GetTimeStep());
-      newPos[2] += mCurrentState->GetVerticalVel() * mCurrentState->GetTimeStep();
-      mCurrentState->SetPos(newPos);
-   }
-
-   void AIPhysicsModel::UpdateVelocity(const BaseAIControls& controls)
-   {
-      float newVelocity = (controls.GetThrust() * mGoalState->GetMaxVel());
-      float maxAccel = mGoalState->GetMaxAccel() * mCurrentState->GetTimeStep();
-
-      osg::Vec3 newVel = mCurrentState->GetVel();
-      newVel += mCurrentState->GetForward() * Clamp(newVelocity - mCurrentState->GetVel().length(), -maxAccel, maxAccel);
-      newVel -= (mCurrentState->GetVel() * mGoalState->GetDragCoef());
-
-
-      //we don't clamp the controls so this is necessary
-      if (newVel.length() > mGoalState->GetMaxVel())
-      {
-         newVel.normalize();
-         newVel *= mGoalState->GetMaxVel();
-      }
-      mCurrentState->SetVel(newVel);
-   }
-
-   void AIPhysicsModel::UpdateTilt(const BaseAIControls& controls, osg::Vec3& tilt)
-   {
-      mCurrentState->SetPitch(Dampen(mCurrentState->GetPitch(), (controls.GetThrust() * mGoalState->GetMaxPitch()), mGoalState->GetMaxTiltPerSecond() * mCurrentState->GetTimeStep(), (mCurrentState->GetPitch() / mGoalState->GetMaxPitch())));
-
-      mCurrentState->SetPitch(Clamp(mCurrentState->GetPitch(), -mGoalState->GetMaxPitch(), mGoalState->GetMaxPitch()));
-
-      osg::Vec3 rightVec = (mCurrentState->GetForward() ^ mCurrentState->GetUp());
-      rightVec.normalize();
-
-      osg::Matrix rotation = osg::Matrix::rotate( -mCurrentState->GetPitch(), rightVec);
-
-      tilt = osg::Matrix::transform3x3(tilt, rotation); 
-
-   }
-
-
-   void AIPhysicsModel::UpdateRoll(const BaseAIControls& controls, osg::Vec3& roll)
-   {
-      mCurrentState->SetRoll(Dampen(mCurrentState->GetRoll(), controls.GetYaw() * mGoalState->GetMaxRoll(), mGoalState->GetMaxRollPerSecond() * mCurrentState->GetTimeStep(), (mCurrentState->GetRoll() / mGoalState->GetMaxRoll())));
-
-      //mCurrentState->mRoll *= ((0.1 + mCurrentState->GetVel().length()) / mGoalState->mMaxVel);
-
-      if (mCurrentState->GetRoll() > mGoalState->GetMaxRoll()) mCurrentState->SetRoll(mGoalState->GetMaxRoll());
-      else if (mCurrentState->GetRoll() < -mGoalState->GetMaxRoll()) mCurrentState->SetRoll(-mGoalState->GetMaxRoll());
-
-      osg::Matrix rotation = osg::Matrix::rotate(-mCurrentState->GetRoll(), mCurrentState->GetForward());
-
-      roll = osg::Matrix::transform3x3(roll, rotation); 
-
-   }
-
    float AIPhysicsModel::Clamp(float x, float from, float to)
    {
       if(x < from)
@@ -330,16 +332,26 @@ namespace NetDemo
       return mTimeStep;
    }
 
+   void AIPhysicsModel::SetCurrentTimeStep(float dt)
+   {
+      mTimeStep = dt;
+      ClampTimeStep();
+   }
+
    void AIPhysicsModel::ClampTimeStep()
+   {
+      mTimeStep = ClampTimeStep(mTimeStep);
+   }
+
+   float AIPhysicsModel::ClampTimeStep(float dt)
    {
       //we will allow ticking from 10fps to 100fps
       const float MAX_TICK = 0.1f;
       const float MIN_TICK = 0.01f;
 
-      if(mTimeStep > MAX_TICK) mTimeStep = MAX_TICK;
-
-      if(mTimeStep > MAX_TICK) mTimeStep = MAX_TICK;
-      else if(mTimeStep < MIN_TICK) mTimeStep = MIN_TICK;
+      if(dt > MAX_TICK) dt = MAX_TICK;
+      else if(dt < MIN_TICK) dt = MIN_TICK;
+      return dt;
    }
 
 
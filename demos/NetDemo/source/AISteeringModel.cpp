@@ -84,6 +84,16 @@ namespace NetDemo
      return false;
    }
 
+   BaseAISteeringBehavior* AISteeringModel::GetCurrentSteeringBehavior() const
+   {
+      if(mCurrentBehavior < mSteeringBehaviors.size())
+      {
+         return mSteeringBehaviors[mCurrentBehavior];
+      }
+
+      return NULL;
+   }
+
    void AISteeringModel::Init()
    {
    }
@@ -242,21 +242,25 @@ namespace NetDemo
    //////////////////////////////////////////////////////////////////////////
    void BombDive::Think(float dt, BaseClass::ConstKinematicGoalParam current_goal, BaseClass::ConstKinematicParam current_state, BaseClass::SteeringOutByRefParam result)
    { 
+      result.SetThrust(ComputeThrust(mSpeed, current_goal.GetPos(), current_state.GetPos(), current_state.GetVel()));
+   }
 
-      osg::Vec3 vel = current_state.GetVel();
+   float BombDive::ComputeThrust(float speed, const osg::Vec3& goalPos, const osg::Vec3& pos, const osg::Vec3& currentVel)
+   {
+      osg::Vec3 vel = currentVel;
       vel.normalize();
-      osg::Vec3 dirToTarget = current_goal.GetPos() - current_state.GetPos();
+      osg::Vec3 dirToTarget = goalPos - pos;
       dirToTarget.normalize();
       float dot = dirToTarget * vel;
       dtUtil::Clamp(dot, 0.0f, 1.0f);
 
-      if(current_state.GetVel().length() < mSpeed)
+      if(currentVel.length() < speed)
       {
-         result.SetThrust(2.0f * dot);
+         return 2.0f * dot;
       }
       else
       {
-         result.SetThrust(0.0f);
+         return 0.0f;
       }
    }
 
@@ -277,10 +281,10 @@ namespace NetDemo
       }
    }
 
-   osg::Vec3 Align::GetTargetPosition(float dt, const BaseAIGoalState& goal)
+   osg::Vec3 Align::GetTargetPosition(float dt, const osg::Vec3& goalPos)
    {
       //project our target forward in time if it has a velocity
-      osg::Vec3 targetPos = goal.GetPos();
+      osg::Vec3 targetPos = goalPos;
       //if(goal.HasLinearVelocity())
       //{
       //   targetPos += goal.GetLinearVelocity() * dt;
@@ -288,9 +292,9 @@ namespace NetDemo
       return targetPos;
    }
 
-   float Align::GetTargetForward(float dt, const osg::Vec3& targetPos, const BaseAIGoalState& current_goal, const BaseAIGameState& current_state, osg::Vec3& vec_in)
+   float Align::GetTargetForward(float dt, const osg::Vec3& targetPos, const osg::Vec3& pos, const osg::Vec3& vel, osg::Vec3& vec_in)
    {
-      osg::Vec3 projectedPos = current_state.GetPos() + (current_state.GetVel() * dt);
+      osg::Vec3 projectedPos = pos + (vel * dt);
 
       osg::Vec3 goalForward = targetPos - projectedPos;
 
@@ -301,16 +305,21 @@ namespace NetDemo
 
    void Align::Think(float dt, BaseClass::ConstKinematicGoalParam current_goal, BaseClass::ConstKinematicParam current_state, BaseClass::SteeringOutByRefParam result)
    { 
+      result.SetYaw(ComputeYaw(dt, mTimeToTarget, current_goal.GetPos(), current_state.GetForward(), current_state.GetAngularVel()));
+   }
+
+   float Align::ComputeYaw(float dt, float timeToTarget, const osg::Vec3& goalPos, const osg::Vec3& forward, float angularVel)
+   {
       dtUtil::Clamp(dt, 0.0167f, 0.1f);
 
-      float lookAhead = mTimeToTarget * dt;
-      osg::Vec3 targetPos = GetTargetPosition(lookAhead, current_goal);
+      float lookAhead = timeToTarget * dt;
+      osg::Vec3 targetPos = GetTargetPosition(lookAhead, goalPos);
       osg::Vec3 goalForward;
-      //float dist = GetTargetForward(lookAhead, targetPos, current_goal, current_state, goalForward);
+      //float dist = GetTargetForward(lookAhead, targetPos, pos, vel, goalForward);
 
-      osg::Vec3 currForward = current_state.GetForward();
+      osg::Vec3 currForward = forward;
 
-      float thetaAngle = (current_state.GetAngularVel() * lookAhead);
+      float thetaAngle = (angularVel * lookAhead);
       osg::Matrix rotation = osg::Matrix::rotate(thetaAngle, osg::Vec3(0.0, 0.0, 1.0));
       currForward = osg::Matrix::transform3x3(currForward, rotation); 
       currForward.normalize();
@@ -321,9 +330,9 @@ namespace NetDemo
       float angle = acos(dot);
       if(angle > 0.05f)
       {     
-         float yaw = angle / fabs(current_state.GetAngularVel());
-         dtUtil::Clamp(yaw, 0.0001f, mTimeToTarget);
-         yaw /= mTimeToTarget;
+         float yaw = angle / fabs(angularVel);
+         dtUtil::Clamp(yaw, 0.0001f, timeToTarget);
+         yaw /= timeToTarget;
          yaw = Sgn(sign) * yaw;
 
          if(!dtUtil::IsFinite(yaw)) 
@@ -331,30 +340,48 @@ namespace NetDemo
             yaw = 0.0f;
          }
 
-         result.SetYaw(yaw);
+         return yaw;
       }  
       else
       {
-         result.SetYaw(0.0f);
+         return 0.0f;
       }
    }
 
+   //////////////////////////////////////////////////////////////////////////
+   //FollowPathSettings
+   //////////////////////////////////////////////////////////////////////////
+   FollowPathSettings::FollowPathSettings(float minSpeed, float maxSpeed, float lookAhead, float timeToTarget, float timeToTargetHeight, float lookAheadRot, float timeToTargetRot)
+      : mMinSpeed(minSpeed)
+      , mMaxSpeed(maxSpeed)
+      , mLookAhead(lookAhead)
+      , mTimeToTarget(timeToTarget)
+      , mTimeToTargetHeight(timeToTargetHeight)
+      , mLookAheadRot(lookAheadRot)
+      , mTimeToTargetRot(timeToTargetRot)
+   {
+   }
+
    //////////////////////////////////////////////////////////////////////////
    //Follow Path
    //////////////////////////////////////////////////////////////////////////
    void FollowPath::Think(float dt, BaseClass::ConstKinematicGoalParam current_goal, BaseClass::ConstKinematicParam current_state, BaseClass::SteeringOutByRefParam result)
    {
-      dtUtil::Clamp(dt, 0.0167f, 0.1f);
+      ComputeControls(dt, mSettings, current_goal.GetPos(), current_state.GetPos(), current_state.GetForward(),
+               current_state.GetVel(), current_state.GetAngularVel(), result);
+   }
 
-      float lookAhead = mLookAhead * dt;
-      BaseClass::Think(lookAhead, current_goal, current_state, result);
+   void FollowPath::ComputeControls(float dt, const FollowPathSettings& settings, const osg::Vec3& goalPos, const osg::Vec3& pos,
+            const osg::Vec3& forward, const osg::Vec3& vel, float angularVel, BaseAIControls& result)
+   {
+      dtUtil::Clamp(dt, 0.0167f, 0.1f);
 
-      const osg::Vec3 goalPos = current_goal.GetPos();
-      const osg::Vec3 pos = current_state.GetPos();
+      float lookAhead = settings.mLookAhead * dt;
+      result.SetYaw(ComputeYaw(lookAhead, settings.mTimeToTargetRot, goalPos, forward, angularVel));
 
       osg::Vec3 goalForward;
-      float dist = GetTargetForward(mTimeToTarget, goalPos, current_goal, current_state, goalForward);
-      osg::Vec3 currForward = current_state.GetForward();
+      float dist = GetTargetForward(settings.mTimeToTarget, goalPos, pos, vel, goalForward);
+      osg::Vec3 currForward = forward;
 
       float angle = 0.0f;
       float dot = goalForward * currForward;
@@ -362,12 +389,12 @@ namespace NetDemo
 
       angle = acos(dot);
 
-      float timeRemaining = dist / current_state.GetVel().length();
+      float timeRemaining = dist / vel.length();
 
-      dtUtil::Clamp(timeRemaining, 0.00001f, mTimeToTarget);
-      timeRemaining /= mTimeToTarget;
+      dtUtil::Clamp(timeRemaining, 0.00001f, settings.mTimeToTarget);
+      timeRemaining /= settings.mTimeToTarget;
 
-      osg::Vec3 velNorm = current_state.GetVel();
+      osg::Vec3 velNorm = vel;
       velNorm.normalize();
 
       float thrustSign = velNorm * goalForward;
@@ -379,7 +406,7 @@ namespace NetDemo
       }
       else 
       {
-         thrust = timeRemaining * dtUtil::MapRangeValue(angle, 0.0f, float(osg::PI), mMaxSpeed, mMinSpeed);
+         thrust = timeRemaining * dtUtil::MapRangeValue(angle, 0.0f, float(osg::PI), settings.mMaxSpeed, settings.mMinSpeed);
       }
 
       if(!dtUtil::IsFinite(thrust)) 
@@ -390,18 +417,18 @@ namespace NetDemo
       result.SetThrust(thrust);
 
       //compute height
-      float zVel = current_state.GetVel()[2];
-      if(fabs(zVel) < 0.0001) zVel = BaseClass::Sgn(zVel) * 0.0001;
+      float zVel = vel[2];
+      if(fabs(zVel) < 0.0001) zVel = Sgn(zVel) * 0.0001;
 
-      float heightLookAhead = zVel * mTimeToTargetHeight;
+      float heightLookAhead = zVel * settings.mTimeToTargetHeight;
 
       float heightDiff = goalPos[2] - (pos[2] + heightLookAhead);
       float remainingFallTime = fabs(heightDiff / zVel);
-      dtUtil::Clamp(remainingFallTime, 0.00001f, mTimeToTarget);
-      remainingFallTime /= mTimeToTarget;
+      dtUtil::Clamp(remainingFallTime, 0.00001f, settings.mTimeToTarget);
+      remainingFallTime /= settings.mTimeToTarget;
 
       float gConstant = 0.5f;
-      float sgnHeightDiff = BaseClass::Sgn(heightDiff);
+      float sgnHeightDiff = Sgn(heightDiff);
       float lift = remainingFallTime * sgnHeightDiff;
       if(!dtUtil::IsFinite(lift)) 
       {
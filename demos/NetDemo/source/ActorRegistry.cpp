@@ -35,6 +35,7 @@
 #include <dtCore/scene.h>
 
 #include <AIComponent.h>
+#include <Components/AIAgentComponent.h>
 #include <Components/GUIComponent.h>
 #include <Components/InputComponent.h>
 #include <Components/SpawnComponent.h>
@@ -104,6 +105,8 @@ namespace NetDemo
    const dtCore::RefPtr<dtCore::SystemComponentType> GameLogicComponent::TYPE(new dtCore::SystemComponentType("GameLogicComponent","GMComponents.SimCore.NetDemo", "", BaseClass::TYPE));
    const dtCore::RefPtr<dtCore::SystemComponentType> GUIComponent::TYPE(new dtCore::SystemComponentType("GUIComponent","GMComponents.SimCore.NetDemo", "", dtGame::GMComponent::BaseGMComponentType));
    const std::string SpawnComponent::DEFAULT_NAME = "SpawnComponent";
+   const dtCore::RefPtr<dtCore::SystemComponentType> AIAgentComponent::TYPE(new dtCore::SystemComponentType("AIAgentComponent","GMComponents.SimCore.NetDemo", "", dtGame::GMComponent::BaseGMComponentType));
+   const std::string AIAgentComponent::DEFAULT_NAME = "AIAgentComponent";
 
 
    ///////////////////////////////////////////////////////////////////////////
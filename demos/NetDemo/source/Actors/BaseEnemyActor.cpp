@@ -42,6 +42,7 @@
 #include <NetDemoUtils.h>
 #include <ActorRegistry.h>
 #include <Actors/TowerActor.h>
+#include <Components/AIAgentComponent.h>
 
 
 namespace NetDemo
@@ -96,6 +97,34 @@ namespace NetDemo
 
       BaseClass::OnEnteredWorld();
 
+      // The AI only runs where the enemy is local.  If there is an agent component, it steps the AI
+      // with the other enemies after the tick, otherwise the AI steps itself.
+      if (!IsRemote())
+      {
+         AIAgentComponent* agentComp = NULL;
+         GetGameActorProxy().GetGameManager()->GetComponentByName(AIAgentComponent::DEFAULT_NAME, agentComp);
+         if (agentComp != NULL)
+         {
+            agentComp->AddAgent(*mAIHelper);
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////
+   void BaseEnemyActor::OnRemovedFromWorld()
+   {
+      AIAgentComponent* agentComp = NULL;
+      dtGame::GameManager* gm = GetGameActorProxy().GetGameManager();
+      if (gm != NULL)
+      {
+         gm->GetComponentByName(AIAgentComponent::DEFAULT_NAME, agentComp);
+      }
+      if (agentComp != NULL)
+      {
+         agentComp->RemoveAgent(*mAIHelper);
+      }
+
+      BaseClass::OnRemovedFromWorld();
    }
 
 
@@ -48,6 +48,7 @@ namespace NetDemo
       , mSteeringModel(new AISteeringModel())
       , mPhysicsModel(new AIPhysicsModel())
       , mDefaultTargeter(new BaseSteeringTargeter())
+      , mStepBatched(false)
    {
       mTargeters.push_back(mDefaultTargeter);
    }
@@ -162,7 +163,41 @@ namespace NetDemo
 
       mStateMachine.Update(dt);
       mSteeringModel->Step(dt, *this);
-      mPhysicsModel->Update(dt, *this);
+
+      if(!mStepBatched)
+      {
+         mPhysicsModel->Update(dt, *this);
+      }
+   }
+
+   void BaseAIHelper::SetStepBatched(bool batched)
+   {
+      mStepBatched = batched;
+   }
+
+   bool BaseAIHelper::IsStepBatched() const
+   {
+      return mStepBatched;
+   }
+
+   void BaseAIHelper::StepUnbatched(float dt)
+   {
+      const float MAX_TICK = 0.1f;
+      if(dt > MAX_TICK) dt = MAX_TICK;
+
+      BaseClass::AIPath path;
+      FindPath(mCurrentState, mGoalState, path);
+      mSteeringModel->OutputControl(path, mCurrentState, mCurrentControls);
+
+      if(UsesPhysicsModel())
+      {
+         mPhysicsModel->Update(dt, *this);
+      }
+   }
+
+   bool BaseAIHelper::UsesPhysicsModel() const
+   {
+      return true;
    }
 
    void BaseAIHelper::RegisterStates()
@@ -206,7 +241,11 @@ namespace NetDemo
    
    void BaseAIHelper::OutputControl(const BaseClass::AIPath& pathToFollow, const BaseClass::AIState& current_state, BaseClass::AIControlState& result) const
    {
-      mSteeringModel->OutputControl(pathToFollow, current_state, result);
+      //a batched agent gets its controls from the AIAgentComponent after the actors tick
+      if(!mStepBatched)
+      {
+         mSteeringModel->OutputControl(pathToFollow, current_state, result);
+      }
    }
 
    void BaseAIHelper::UpdateState(float dt, const BaseClass::AIControlState& steerData)
@@ -0,0 +1,367 @@
+/* -*-c++-*-
+* Delta3D Open Source Game and Simulation Engine
+* Copyright (C) 2009, Alion Science and Technology, BMH Operation
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include <Components/AIAgentComponent.h>
+#include <BaseAIHelper.h>
+
+#include <SimCore/FrameProfiler.h>
+
+#include <dtGame/basemessages.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+#include <dtUtil/threadpool.h>
+
+#include <OpenThreads/Thread>
+#include <osg/Timer>
+
+#include <algorithm>
+
+namespace NetDemo
+{
+   /////////////////////////////////////////////////////////////
+   // Steps a range of the agents in a batch on a worker thread.
+   /////////////////////////////////////////////////////////////
+   class AIAgentStepTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      AIAgentStepTask()
+         : mBatch(NULL)
+         , mDt(0.0f)
+         , mBegin(0)
+         , mEnd(0)
+      {
+      }
+
+      void Set(AIAgentBatch& batch, float dt, unsigned begin, unsigned end)
+      {
+         mBatch = &batch;
+         mDt = dt;
+         mBegin = begin;
+         mEnd = end;
+      }
+
+      virtual void operator()()
+      {
+         mBatch->Step(mDt, mBegin, mEnd);
+      }
+
+   private:
+      AIAgentBatch* mBatch;
+      float mDt;
+      unsigned mBegin;
+      unsigned mEnd;
+   };
+
+   const unsigned AIAgentComponent::DEFAULT_MIN_AGENTS_PER_TASK = 64;
+
+   /////////////////////////////////////////////////////////////
+   AIAgentComponent::BenchmarkResult::BenchmarkResult()
+      : mNumAgents(0)
+      , mNumFrames(0)
+      , mUnbatchedMillis(0.0)
+      , mBatchedMillis(0.0)
+      , mMaxPositionDifference(0.0f)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////
+   AIAgentComponent::AIAgentComponent(dtCore::SystemComponentType& type)
+   : BaseClass(type)
+   , mUseWorkerThreads(true)
+   , mMinAgentsPerTask(DEFAULT_MIN_AGENTS_PER_TASK)
+   {
+      for(unsigned i = 0; i < AIAgentBatch::NUM_BEHAVIOR_TYPES; ++i)
+      {
+         mBatches[i] = new AIAgentBatch(AIAgentBatch::BehaviorType(i));
+      }
+      std::fill(mNumStepped, mNumStepped + AIAgentBatch::NUM_BEHAVIOR_TYPES + 1, 0U);
+   }
+
+   /////////////////////////////////////////////////////////////
+   AIAgentComponent::~AIAgentComponent()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////
+   DT_IMPLEMENT_ACCESSOR(AIAgentComponent, bool, UseWorkerThreads);
+   DT_IMPLEMENT_ACCESSOR(AIAgentComponent, unsigned, MinAgentsPerTask);
+
+   /////////////////////////////////////////////////////////////
+   void AIAgentComponent::OnRemovedFromGM()
+   {
+      for(unsigned i = 0; i < mAgents.size(); ++i)
+      {
+         mAgents[i]->SetStepBatched(false);
+      }
+      mAgents.clear();
+   }
+
+   /////////////////////////////////////////////////////////////
+   void AIAgentComponent::ProcessMessage(const dtGame::Message& message)
+   {
+      //The GM sends the remote tick after every actor has handled the local tick,
+      //so the agents are stepped with the goals their state machines chose this frame.
+      if(message.GetMessageType() == dtGame::MessageType::TICK_REMOTE)
+      {
+         float dt = float(static_cast<const dtGame::TickMessage&>(message).GetDeltaSimTime());
+         StepAgents(dt);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////
+   void AIAgentComponent::AddAgent(BaseAIHelper& helper)
+   {
+      if(!HasAgent(helper))
+      {
+         helper.SetStepBatched(true);
+         mAgents.push_back(&helper);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////
+   void AIAgentComponent::RemoveAgent(BaseAIHelper& helper)
+   {
+      for(unsigned i = 0; i < mAgents.size(); ++i)
+      {
+         if(mAgents[i] == &helper)
+         {
+            helper.SetStepBatched(false);
+            mAgents[i] = mAgents.back();
+            mAgents.pop_back();
+            break;
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////
+   bool AIAgentComponent::HasAgent(const BaseAIHelper& helper) const
+   {
+      for(unsigned i = 0; i < mAgents.size(); ++i)
+      {
+         if(mAgents[i] == &helper)
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /////////////////////////////////////////////////////////////
+   unsigned AIAgentComponent::GetNumAgents() const
+   {
+      return unsigned(mAgents.size());
+   }
+
+   /////////////////////////////////////////////////////////////
+   unsigned AIAgentComponent::GetNumStepped(AIAgentBatch::BehaviorType type) const
+   {
+      return unsigned(type) <= unsigned(AIAgentBatch::NUM_BEHAVIOR_TYPES) ? mNumStepped[type] : 0U;
+   }
+
+   /////////////////////////////////////////////////////////////
+   void AIAgentComponent::StepAgents(float dt)
+   {
+      SIMCORE_PROFILE_SCOPE("AIAgentComponent::StepAgents");
+
+      for(unsigned i = 0; i < AIAgentBatch::NUM_BEHAVIOR_TYPES; ++i)
+      {
+         mBatches[i]->Clear();
+      }
+      mUnknownAgents.clear();
+
+      //an agent can change its behavior at any time, so the batches are refilled every step
+      for(unsigned i = 0; i < mAgents.size(); ++i)
+      {
+         BaseAIHelper& helper = *mAgents[i];
+         AIAgentBatch::BehaviorType type = AIAgentBatch::GetBehaviorType(helper);
+         if(type == AIAgentBatch::BEHAVIOR_UNKNOWN)
+         {
+            mUnknownAgents.push_back(&helper);
+         }
+         else
+         {
+            mBatches[type]->AddAgent(helper);
+         }
+      }
+
+      //these go through the virtual behavior and touch the physics objects, so they step on this thread
+      for(unsigned i = 0; i < mUnknownAgents.size(); ++i)
+      {
+         mUnknownAgents[i]->StepUnbatched(dt);
+      }
+      mNumStepped[AIAgentBatch::BEHAVIOR_UNKNOWN] = unsigned(mUnknownAgents.size());
+
+      unsigned minPerTask = mMinAgentsPerTask > 0 ? mMinAgentsPerTask : 1;
+      unsigned maxTasksPerBatch = mUseWorkerThreads ? unsigned(OpenThreads::GetNumberOfProcessors()) : 1U;
+      if(maxTasksPerBatch < 1)
+      {
+         maxTasksPerBatch = 1;
+      }
+
+      unsigned numTasks = 0;
+      unsigned numBatched = 0;
+      for(unsigned i = 0; i < AIAgentBatch::NUM_BEHAVIOR_TYPES; ++i)
+      {
+         AIAgentBatch& batch = *mBatches[i];
+         unsigned numAgents = batch.GetNumAgents();
+         mNumStepped[i] = numAgents;
+         numBatched += numAgents;
+         if(numAgents == 0)
+         {
+            continue;
+         }
+
+         unsigned batchTasks = std::max(1U, std::min(numAgents / minPerTask, maxTasksPerBatch));
+         unsigned perTask = (numAgents + batchTasks - 1) / batchTasks;
+         for(unsigned begin = 0; begin < numAgents; begin += perTask)
+         {
+            if(mTasks.size() <= numTasks)
+            {
+               mTasks.push_back(new AIAgentStepTask);
+            }
+            mTasks[numTasks]->Set(batch, dt, begin, std::min(begin + perTask, numAgents));
+            ++numTasks;
+         }
+      }
+
+      SIMCORE_PROFILE_COUNT("AIAgentComponent.AgentsBatched", numBatched);
+
+      if(!mUseWorkerThreads || numTasks < 2 || numBatched < 2 * minPerTask)
+      {
+         for(unsigned i = 0; i < numTasks; ++i)
+         {
+            (*mTasks[i])();
+         }
+      }
+      else
+      {
+         for(unsigned i = 0; i < numTasks; ++i)
+         {
+            dtUtil::ThreadPool::AddTask(*mTasks[i], dtUtil::ThreadPool::IMMEDIATE);
+         }
+
+         dtUtil::ThreadPool::ExecuteTasks();
+
+         for(unsigned i = 0; i < numTasks; ++i)
+         {
+            mTasks[i]->WaitUntilComplete();
+            mTasks[i]->ResetData();
+         }
+      }
+
+      for(unsigned i = 0; i < AIAgentBatch::NUM_BEHAVIOR_TYPES; ++i)
+      {
+         mBatches[i]->Scatter(dt);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////
+   AIAgentComponent::BenchmarkResult AIAgentComponent::RunBenchmark(unsigned numAgents, unsigned numFrames, bool useWorkerThreads)
+   {
+      BenchmarkResult result;
+      result.mNumAgents = numAgents;
+      result.mNumFrames = numFrames;
+
+      const float dt = 1.0f / 60.0f;
+
+      //two identical sets of agents, one stepped each way
+      std::vector<dtCore::RefPtr<BaseAIHelper> > agents[2];
+      //the steering models only hold raw pointers to their behaviors
+      std::vector<dtCore::RefPtr<BaseAISteeringBehavior> > behaviors;
+      for(unsigned set = 0; set < 2; ++set)
+      {
+         agents[set].reserve(numAgents);
+         for(unsigned i = 0; i < numAgents; ++i)
+         {
+            dtCore::RefPtr<BaseAIHelper> helper = new BaseAIHelper();
+            helper->Init(NULL);
+
+            dtCore::RefPtr<BaseAISteeringBehavior> behavior;
+            if(i % 2 == 0)
+            {
+               //the settings of the EnemyHelixAIHelper
+               behavior = new FollowPath(0.0f, 2.5f, 2.0f, 10.0f, 25.0f, 2.5f, 1.0f);
+            }
+            else
+            {
+               behavior = new BombDive(helper->mGoalState.GetMaxVel());
+            }
+            behaviors.push_back(behavior);
+            helper->GetSteeringModel()->AddSteeringBehavior(behavior.get());
+
+            //a grid of agents, each heading across it, with a time step in the state so they actually move
+            float x = float(i % 100) * 20.0f;
+            float y = float(i / 100) * 20.0f;
+            helper->mCurrentState.SetPos(osg::Vec3(x, y, 50.0f));
+            helper->mCurrentState.SetTimeStep(dt);
+            helper->mGoalState.SetPos(osg::Vec3(2000.0f - x, 2000.0f - y, 100.0f));
+            helper->Spawn();
+
+            agents[set].push_back(helper);
+         }
+      }
+
+      osg::Timer* timer = osg::Timer::instance();
+
+      osg::Timer_t start = timer->tick();
+      for(unsigned frame = 0; frame < numFrames; ++frame)
+      {
+         for(unsigned i = 0; i < numAgents; ++i)
+         {
+            agents[0][i]->Update(dt);
+         }
+      }
+      result.mUnbatchedMillis = timer->delta_m(start, timer->tick());
+
+      dtCore::RefPtr<AIAgentComponent> component = new AIAgentComponent();
+      component->SetUseWorkerThreads(useWorkerThreads);
+      for(unsigned i = 0; i < numAgents; ++i)
+      {
+         component->AddAgent(*agents[1][i]);
+      }
+
+      start = timer->tick();
+      for(unsigned frame = 0; frame < numFrames; ++frame)
+      {
+         for(unsigned i = 0; i < numAgents; ++i)
+         {
+            agents[1][i]->Update(dt);
+         }
+         component->StepAgents(dt);
+      }
+      result.mBatchedMillis = timer->delta_m(start, timer->tick());
+
+      for(unsigned i = 0; i < numAgents; ++i)
+      {
+         float difference = (agents[0][i]->mCurrentState.GetPos() - agents[1][i]->mCurrentState.GetPos()).length();
+         result.mMaxPositionDifference = std::max(result.mMaxPositionDifference, difference);
+      }
+
+      LOG_ALWAYS("AI agent benchmark, " + dtUtil::ToString(numAgents) + " agents for " + dtUtil::ToString(numFrames)
+               + " frames: unbatched " + dtUtil::ToString(result.mUnbatchedMillis) + " ms, batched "
+               + dtUtil::ToString(result.mBatchedMillis) + " ms, largest position difference "
+               + dtUtil::ToString(result.mMaxPositionDifference) + " m.");
+
+      agents[0].clear();
+      agents[1].clear();
+      return result;
+   }
+
+}//namespace NetDemo
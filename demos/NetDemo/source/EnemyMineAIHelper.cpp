@@ -80,6 +80,11 @@ namespace NetDemo
      BaseClass::Spawn();
    }
 
+   bool EnemyMineAIHelper::UsesPhysicsModel() const
+   {
+      return false;
+   }
+
    void EnemyMineAIHelper::Update(float dt)
    {
       const float MAX_TICK = 0.1f;
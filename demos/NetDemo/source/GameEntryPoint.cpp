@@ -13,6 +13,7 @@
 
 #include <GameEntryPoint.h>
 #include <NetDemoMessageTypes.h>
+#include <Components/AIAgentComponent.h>
 #include <Components/InputComponent.h>
 #include <Components/GameLogicComponent.h>
 #include <ConfigParameters.h>
@@ -21,6 +22,8 @@
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <SimCore/Components/ViewerMessageProcessor.h>
 #include <SimCore/Components/VolumeRenderingComponent.h>
+#include <SimCore/Components/WeaponEventAggregatorComponent.h>
+#include <SimCore/Components/PhysicsRayQueryComponent.h>
 
 #include <dtCore/project.h>
 
@@ -54,6 +57,7 @@ namespace NetDemo
 
    ///////////////////////////////////////////////////////////////////////////
    GameEntryPoint::GameEntryPoint()
+   : mAIBenchmarkAgents(0)
    {
    }
 
@@ -76,7 +80,10 @@ namespace NetDemo
       }
       SetMapName(appName);
       SetMapIsRequired(false);
-      GetOrCreateArgParser(argc, argv)->getApplicationUsage()->setCommandLineUsage("Res Game Application [options] value ...");
+      osg::ArgumentParser* parser = GetOrCreateArgParser(argc, argv);
+      parser->getApplicationUsage()->setCommandLineUsage("Res Game Application [options] value ...");
+      parser->getApplicationUsage()->addCommandLineOption("--aiBenchmark", "Steps this many AI agents without actors, unbatched and batched, and logs the times");
+      parser->read("--aiBenchmark", mAIBenchmarkAgents);
       BaseClass::Initialize(app, argc, argv);
    }
 
@@ -88,6 +95,11 @@ namespace NetDemo
       GameLogicComponent* gameAppComp = NULL;
       gameManager.GetComponentByName(GameLogicComponent::DEFAULT_NAME, gameAppComp);
       gameAppComp->SetMapName( GetMapName() );
+
+      if (mAIBenchmarkAgents > 0)
+      {
+         AIAgentComponent::RunBenchmark(unsigned(mAIBenchmarkAgents), 600);
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////
@@ -130,6 +142,21 @@ namespace NetDemo
       renderingSupportComponent->SetEnableStaticTerrainPhysics(false);
       gm.AddComponent(*renderingSupportComponent, dtGame::GameManager::ComponentPriority::NORMAL);
 
+      // Sends the weapon fire and detonations of each frame as one message. This demo only
+      // networks with itself, so there is no need for the individual HLA style messages.
+      dtCore::RefPtr<SimCore::Components::WeaponEventAggregatorComponent> weaponEventComp
+         = new SimCore::Components::WeaponEventAggregatorComponent();
+      gm.AddComponent(*weaponEventComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+      // Runs the vehicles' ground safety ray casts together at the end of each frame.
+      dtCore::RefPtr<SimCore::Components::PhysicsRayQueryComponent> rayQueryComp
+         = new SimCore::Components::PhysicsRayQueryComponent();
+      gm.AddComponent(*rayQueryComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+      // Steps the local enemy AI in batches.
+      dtCore::RefPtr<AIAgentComponent> aiAgentComp = new AIAgentComponent();
+      gm.AddComponent(*aiAgentComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
       // Keyboard, mouse input, etc...
       InputComponent* inputComp = new InputComponent();
       gm.AddComponent(*inputComp, dtGame::GameManager::ComponentPriority::NORMAL);
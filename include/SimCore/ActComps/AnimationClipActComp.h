@@ -25,11 +25,13 @@
 #include <SimCore/Export.h>
 #include <dtGame/actorcomponent.h>
 #include <dtCore/propertycontainer.h>
+#include <dtCore/refptr.h>
+#include <osg/AnimationPath>
+#include <vector>
 
 namespace osg
 {
     class Node;
-    class NodeVisitor;
 }
 
 namespace SimCore
@@ -89,6 +91,43 @@ namespace SimCore
 
 
 
+        /*
+         * Plays a segment of a shared animation path. The key frames stay in the source path,
+         * which is shared by every instance of a model loaded from the cache, so each instance
+         * only keeps its own clip window. The loop mode is the one set on this path.
+         */
+        class SIMCORE_EXPORT AnimationClipPath : public osg::AnimationPath
+        {
+        public:
+            typedef osg::AnimationPath BaseClass;
+
+            AnimationClipPath();
+            AnimationClipPath(const osg::AnimationPath& source);
+            AnimationClipPath(const AnimationClipPath& clipPath, const osg::CopyOp& copyop = osg::CopyOp::SHALLOW_COPY);
+
+            META_Object(SimCore, AnimationClipPath);
+
+            const osg::AnimationPath* GetSource() const;
+
+            /// Sets the segment of the source to play. If the end time isn't after the begin time, the whole source plays.
+            void SetClipTimes(double beginTime, double endTime);
+            double GetBeginTime() const;
+            double GetEndTime() const;
+
+            /// Gets the control point of the source, with the time measured from the beginning of the segment.
+            /*override*/ bool getInterpolatedControlPoint(double time, ControlPoint& controlPoint) const;
+
+        protected:
+            virtual ~AnimationClipPath();
+
+        private:
+            dtCore::RefPtr<const osg::AnimationPath> mSource;
+            double mBeginTime;
+            double mEndTime;
+        };
+
+
+
         /*
          * Class that simplifies control over rigid keyframed animation.
          */
@@ -120,6 +159,9 @@ namespace SimCore
             void RemoveAnimationPropertyContainer(int index);
 
             size_t GetNumAnimationPropertyContainers() const;
+
+            /// @return the number of animation callbacks found in the model by the last call to ProcessModel.
+            unsigned GetNumAnimationCallbacks() const;
             
             void SetPaused(bool paused);
             bool IsPaused() const;
@@ -146,16 +188,22 @@ namespace SimCore
 
             void ApplyAnimationClipParameters(
                 AnimationPropertyContainer& animParams,
-                osg::NodeVisitor& visitor,
                 bool play,
                 bool reset);
 
+            void ResetCallbacks();
+            void SetCallbacksPaused(bool paused);
+
             bool mIsValid;
             bool mPaused;
             int mCurrentAnimation;
 
             typedef std::vector<dtCore::RefPtr<AnimationPropertyContainer> > AnimPropVector;
             AnimPropVector mAnimProps;
+
+            // The animation callbacks in the model, found once by ProcessModel.
+            typedef std::vector<dtCore::RefPtr<osg::AnimationPathCallback> > AnimCallbackVector;
+            AnimCallbackVector mAnimCallbacks;
         };
     }
 }
@@ -29,6 +29,7 @@
 // INCLUDE DIRECTIVES
 ////////////////////////////////////////////////////////////////////////////////
 #include <SimCore/Export.h>
+#include <dtCore/observerptr.h>
 #include <dtCore/resourcedescriptor.h>
 #include <dtUtil/getsetmacros.h>
 #include <dtGame/actorcomponentbase.h>
@@ -49,6 +50,11 @@ namespace dtGame
    class TickMessage;
 }
 
+namespace SimCore
+{
+   class TrailEffectBatch;
+}
+
 
 
 namespace SimCore
@@ -71,10 +77,15 @@ namespace SimCore
             static const dtUtil::RefString PROPERTY_TRAIL_ATTACH_NODE_NAME;
             static const dtUtil::RefString PROPERTY_TRAIL_CLAMP_INTERVAL;
             static const dtUtil::RefString PROPERTY_TRAIL_ENABLE_DISTANCE;
+            static const dtUtil::RefString PROPERTY_TRAIL_RIBBON_WIDTH;
 
             // Default Values
             static const float DEFAULT_TRAIL_CLAMP_INTERVAL;
             static const float DEFAULT_TRAIL_ENABLE_DISTANCE;
+            static const float DEFAULT_TRAIL_RIBBON_WIDTH;
+
+            /// The distance the owner moves between the points of the ribbon.
+            static const float RIBBON_POINT_SPACING;
 
             TrailEffectActComp();
 
@@ -107,6 +118,13 @@ namespace SimCore
              */
             DT_DECLARE_ACCESSOR(dtCore::ResourceDescriptor, TrailParticlesFile);
 
+            /**
+             * Width of a ribbon drawn along the ground behind the owner, through the shared batch of the
+             * TrailEffectBatchComponent.  Defaults to DEFAULT_TRAIL_RIBBON_WIDTH; zero means no ribbon.
+             * Ribbons are only drawn for unattached trails.
+             */
+            DT_DECLARE_ACCESSOR(float, TrailRibbonWidth);
+
             ////////////////////////////////////////////////////////////////////
             // SPECIAL METHODS
             ////////////////////////////////////////////////////////////////////
@@ -122,6 +140,9 @@ namespace SimCore
             void SetEnabled(bool enable);
             bool IsEnabled() const;
 
+            /// @return true if the trail has a ribbon in the shared batch.
+            bool HasRibbon() const;
+
             /**
              * Primary method for updating the effect.
              */
@@ -187,6 +208,16 @@ namespace SimCore
              */
             void SetParticlePosition(const osg::Vec3& pos);
 
+            /**
+             * Adds the ribbon to the batch of the TrailEffectBatchComponent.
+             * @return false if there is no ribbon width, the trail is attached, or there is no batch.
+             */
+            bool AddRibbon();
+            void RemoveRibbon();
+
+            /// Adds a ribbon point if the owner has moved far enough.
+            void UpdateRibbon(const osg::Vec3& pos);
+
          private:
             void SetDefaults();
 
@@ -194,6 +225,13 @@ namespace SimCore
             float mClampTimer;
             osg::Vec3 mClampPoint;
             dtCore::RefPtr<dtCore::ParticleSystem> mParticles;
+
+            dtCore::ObserverPtr<SimCore::TrailEffectBatch> mRibbonBatch;
+            int mRibbonId;
+            bool mRibbonEnabled;
+            // The ribbon starts over at the next point, after being disabled.
+            bool mRibbonRestart;
+            osg::Vec3 mLastRibbonPoint;
       };
 
    }
@@ -27,6 +27,7 @@
 
 #include <SimCore/Export.h>
 #include <dtGame/actorcomponent.h>
+#include <dtCore/observerptr.h>
 #include <dtUtil/getsetmacros.h>
 #include <dtUtil/refstring.h>
 #include <osg/Matrix>
@@ -44,6 +45,11 @@ namespace dtGame
 
 namespace SimCore
 {
+   namespace Components
+   {
+      class WheelAnimationComponent;
+   }
+
    namespace ActComps
    {
       class SIMCORE_EXPORT Axle : public osg::Referenced
@@ -114,8 +120,22 @@ namespace SimCore
 
          virtual void BuildPropertyMap();
 
+         /// Turns the wheels for a tick.  This is only registered when there is no WheelAnimationComponent to do it.
          void Update(const dtGame::TickMessage& msg);
 
+         /**
+          * Works out the wheel speed and the steering for a tick from the vehicle's motion.
+          * @param dt the time since the last call.
+          * @param velocity the world velocity of the vehicle.
+          * @param heading the current heading of the vehicle.
+          * @param forward the world forward vector of the vehicle.
+          */
+         void CalcWheelMotion(float dt, const osg::Vec3& velocity, float heading, const osg::Vec3& forward,
+                  float& speedMps, float& steerAngle);
+
+         /// Makes heading the one the next CalcWheelMotion steers from, after a time the wheels weren't updated.
+         void ResetLastFrameHeading(float heading);
+
          void FindAxles(dtUtil::NodeCollector* nodeCollector = NULL);
 
          DT_DECLARE_ARRAY_ACCESSOR(dtCore::RefPtr<Axle>, Axle, Axles)
@@ -124,6 +144,7 @@ namespace SimCore
          virtual ~WheelActComp();
       private:
          float mLastFrameHeading;
+         dtCore::ObserverPtr<SimCore::Components::WheelAnimationComponent> mWheelAnimation;
       };
 
    }
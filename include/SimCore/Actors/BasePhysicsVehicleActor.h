@@ -104,7 +104,7 @@ namespace SimCore
             /// called fourth - after UpdateRotationDOFS. Does nothing by default.
             virtual void UpdateSoundEffects(float deltaTime);
 
-            /// Check if the actor is on ground.
+            /// Check if the actor is on ground.  The ray is traced right away in the tick.
             void KeepOnGround(float dt);
 
             /**
@@ -31,6 +31,7 @@
 //#include <SimCore/Actors/ViewerMaterialActor.h>
 #include <dtUtil/getsetmacros.h>
 #include <dtCore/resourcedescriptor.h>
+#include <dtCore/observerptr.h>
 
 namespace dtGame
 {
@@ -39,6 +40,11 @@ namespace dtGame
 
 namespace SimCore
 {
+   namespace Components
+   {
+      class DetonationActorPool;
+   }
+
    namespace Actors
    {
       class ViewerMaterialActor;
@@ -89,6 +95,26 @@ namespace SimCore
             // Invoked when a actor is added to the Game Manager
             virtual void OnEnteredWorld();
 
+            /**
+             * Starts the explosion, sound, light and smoke effects.  A detonation does this when it
+             * enters the world, unless it belongs to a pool, in which case it is called each time
+             * the detonation is taken from the pool.
+             */
+            void Detonate();
+
+            /// Stops all effects and timers so a pooled detonation can be reused.
+            void StopDetonation();
+
+            /// @return true from the call to Detonate until the effects end or StopDetonation is called.
+            bool IsDetonating() const { return mDetonating; }
+
+            /**
+             * Sets the pool this detonation goes back to when its effects end, rather than being deleted.
+             * Pooled detonations keep their sound and particle systems loaded between uses.
+             */
+            void SetPool(Components::DetonationActorPool* pool);
+            Components::DetonationActorPool* GetPool();
+
             /**
              * Gets the delay time to be used for flash bang
              * @return mDelayTime
@@ -235,7 +261,16 @@ namespace SimCore
            
             void SetImpactEffects();
 
+            /// Called when the effects are over. Pooled detonations go back to the pool, others are deleted.
+            void FinishDetonation();
+
+            void RemoveDynamicLight();
+
             IMPACT_TYPE mCurrentImpact;
+            /// The impact type the effects were last loaded for, or -1 if they aren't loaded.
+            int mLoadedImpact;
+            unsigned mDynamicLightId;
+            bool mDetonating;
 
             float mDelayTime;
             float mRenderExplosionTimerSecs;
@@ -252,6 +287,7 @@ namespace SimCore
             dtCore::RefPtr<dtCore::ParticleSystem> mExplosionSystem;
             dtCore::RefPtr<dtCore::ParticleSystem> mSmokeSystem;
             dtCore::RefPtr<dtAudio::Sound> mSound;
+            dtCore::ObserverPtr<Components::DetonationActorPool> mPool;
       };
 
       class SIMCORE_EXPORT DetonationActorProxy : public dtGame::GameActorProxy
@@ -271,7 +307,7 @@ namespace SimCore
             /// Builds the invokables of this actor
             void BuildInvokables();
 
-            /// Invokable that tells the game manager to delete ourselves and play our sound
+            /// Invokable that plays our sound and moves the effects along, and ends the detonation.
             void HandleDetonationActorTimers(const dtGame::TimerElapsedMessage& timeMsg);
 
             /// Clear all timers from the GameManager
@@ -291,7 +327,6 @@ namespace SimCore
 
             /// Destructor
             virtual ~DetonationActorProxy();
-            virtual void OnEnteredWorld();
       };
    }
 }
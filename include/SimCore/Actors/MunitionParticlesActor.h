@@ -27,6 +27,8 @@
 #include <SimCore/Actors/PhysicsParticleSystemActor.h>
 #include <SimCore/Actors/VolumetricLine.h>
 #include <SimCore/Components/RenderingSupportComponent.h>//for dynamic lights, cant be forward declared
+#include <SimCore/Components/PhysicsRayQueryComponent.h>
+#include <vector>
 
 namespace dtCore
 {
@@ -71,13 +73,38 @@ namespace SimCore
          dtCore::RefPtr<dtCore::Transformable> mDynamicLight;
       };
 
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////
+      /**
+       * A round moved by the ballistic solver of the MunitionParticlesActor.  Rounds are kept
+       * by value in one array, and only tracers have a particle for the visuals.
+       */
+      struct SIMCORE_EXPORT BallisticRound
+      {
+         BallisticRound();
+
+         osg::Vec3 mPosition;
+         /// The position before the last step.  The segment from here to mPosition is checked for hits.
+         osg::Vec3 mLastPosition;
+         osg::Vec3 mVelocity;
+         float mTimeLeft;
+         bool mHit;
+         /// The visuals of a tracer round, or NULL.  It has no physics object.
+         dtCore::RefPtr<MunitionsPhysicsParticle> mTracer;
+      };
+
       /////////////////////////////////////////////////////////////////////////////////////////////////////////
       class SIMCORE_EXPORT MunitionParticlesActor: public PhysicsParticleSystemActor
       {
       public:
+         typedef std::vector<BallisticRound> BallisticRoundList;
+
+         static const osg::Vec3 BALLISTIC_GRAVITY;
+
          /// constructor for NxAgeiaBaseActor
          MunitionParticlesActor(dtGame::GameActorProxy& parent);
 
+         virtual void OnEnteredWorld();
+
          /**
          * This method is an invokable called when an object is local and
          * receives a tick.
@@ -110,16 +137,60 @@ namespace SimCore
 
          bool ResolveISectorCollision(MunitionsPhysicsParticle& particleToCheck);
 
+         /**
+          * Set to fire rounds that follow the ballistic solver instead of each having a physics body.
+          * The segments the rounds move along each frame are traced together in the PhysicsRayQueryComponent
+          * batch if there is one.  Defaults to false.
+          */
+         DT_DECLARE_ACCESSOR_INLINE(bool, UseBallisticSolver);
+
+         /**
+          * The linear drag of the ballistic rounds, in 1/s.  The velocity relaxes toward gravity / drag,
+          * which is solved exactly for the step.  Defaults to 0, which is a plain parabola.
+          */
+         DT_DECLARE_ACCESSOR_INLINE(float, BallisticDrag);
+
+         unsigned GetNumBallisticRounds() const { return unsigned(mBallisticRounds.size()); }
+         const BallisticRound& GetBallisticRound(unsigned index) const { return mBallisticRounds[index]; }
+
+         /// Removes the ballistic rounds and their tracers.
+         void ClearBallisticRounds();
+
+         /**
+          * Moves the rounds forward dt seconds under gravity and linear drag, and counts down their time.
+          * The last position of each round is set to where it started the step.
+          */
+         static void AdvanceBallisticRounds(BallisticRoundList& rounds, const osg::Vec3& gravity, float drag, float dt);
+
       protected:
 
          //////////////////////////////////////////////////////////////////
          virtual void AddParticle();
 
+         void AddBallisticRound();
+
+         void UpdateBallisticRounds(float dt);
+
+         /// Drops the rounds that hit something or timed out.
+         void RemoveSpentRounds();
+
+         /// Called with the hits of the segments submitted to the ray query component, in the order they were submitted.
+         void OnBallisticRoundHits(const SimCore::Components::PhysicsRayQueryComponent::HitList& hits);
+
+         void ResolveBallisticHits(unsigned roundIndex, const SimCore::Components::PhysicsRayQueryComponent::HitList& hits);
+
       private:
          bool           mUseTracers;               /// Do we use tracers for this particle system?
          int            mCurrentTracerRoundNumber; /// Current count for knowing when to create a tracer
          int            mFrequencyOfTracers;       /// Everytime it hits this number it will reset mCurrentTracerRoundNumber
          dtCore::ObserverPtr<SimCore::Actors::WeaponActor>  mWeapon;
+
+         BallisticRoundList mBallisticRounds;
+         // The rounds whose segments are waiting in the ray query batch, in submission order.
+         std::vector<unsigned> mPendingHitRounds;
+         unsigned mNextPendingHitRound;
+         SimCore::Components::PhysicsRayQueryComponent::HitList mHits;
+         dtCore::ObserverPtr<SimCore::Components::PhysicsRayQueryComponent> mRayQueryComponent;
       };
 
       ////////////////////////////////////////////////////////
@@ -5,6 +5,8 @@
 #include <dtUtil/refstring.h>
 #include <SimCore/Export.h>
 #include <osg/ShapeDrawable>
+#include <osg/Texture2D>
+#include <osg/Uniform>
 
 namespace dtUtil
 {
@@ -28,6 +30,10 @@ namespace SimCore
             typedef BaseEntity BaseClass;
 
             static const std::string COLOR_UNIFORM;
+            /// The resource of the marker mesh, shared with the PositionMarkerComponent batch.
+            static const std::string MESH_RESOURCE;
+            /// The offset of the mesh from the actor origin.
+            static const osg::Vec3 MESH_OFFSET;
 
             PositionMarker(dtGame::GameActorProxy& parent);
             virtual ~PositionMarker();
@@ -71,14 +77,29 @@ namespace SimCore
             const BaseEntity* GetAssociatedEntity() const;
             BaseEntity* GetAssociatedEntity();
 
+            /**
+             * Sets the icon image.  The texture comes from GetIconTexture, so the markers with the same icon
+             * share one texture.  Pass an empty string to clear the icon.
+             */
             void LoadImage(const std::string& theFile);
 
+            /**
+             * @return the shared texture for the icon file, loading it if no marker is using it yet,
+             *         or NULL if the file can't be loaded.
+             */
+            static dtCore::RefPtr<osg::Texture2D> GetIconTexture(const std::string& theFile);
+
+            /// @return the number of icon textures that are loaded and still used by a marker.
+            static unsigned GetNumIconTextures();
+
             void SetInitialAlpha(float alpha);
 
             float GetInitialAlpha() const;
 
             float CalculateCurrentAlpha() const;
+            float CalculateCurrentAlpha(double simTime) const;
             osg::Vec3 CalculateCurrentColor() const;
+            osg::Vec3 CalculateCurrentColor(double simTime) const;
 
             const osg::Vec3& GetInitialColor() const;
             osg::Vec4 GetInitialColorWithAlpha() const;
@@ -107,16 +128,32 @@ namespace SimCore
 
             osg::Vec4 GetCurrentColorUniform();
 
+            /**
+             * Sets the color uniform for the given sim time.  This is called by the PositionMarkerComponent
+             * or, if there is none, by the marker's own timer.
+             * @return true if the marker has faded out and should be deleted.
+             */
+            bool UpdateFade(double simTime);
+
             void UpdateColorForForce();
 
             /// @return true if this position marker should be visible based on the options given.
             bool ShouldBeVisible(const SimCore::VisibilityOptions& options);
 
+            /**
+             * Shows or hides the marker's own mesh without changing IsVisible.  The PositionMarkerComponent
+             * hides it while the marker is registered, since the component draws all its markers as instances.
+             */
+            void SetMeshVisible(bool visible);
+            bool IsMeshVisible() const;
+
          protected:
             void SetInitialColor(const osg::Vec3& vec);
             void SetCurrentColorUniform(const osg::Vec4& vec);
             float CalculateFadeOutFraction() const;
+            float CalculateFadeOutFraction(double simTime) const;
             float CalculateStaleFraction() const;
+            float CalculateStaleFraction(double simTime) const;
 
          private:
             double mReportTime;
@@ -131,6 +168,9 @@ namespace SimCore
             BaseEntityActorProxy::ServiceEnum* mSourceService;
             osg::Vec4 mFriendlyColor, mNeutralColor, mOpposingColor, mOtherColor, mStaleColor;
             dtUtil::Log* mLogger;
+            dtCore::RefPtr<osg::Uniform> mColorUniform;
+            dtCore::RefPtr<osg::Node> mMeshNode;
+            bool mMeshVisible;
       };
 
       class SIMCORE_EXPORT PositionMarkerActorProxy : public BaseEntityActorProxy
@@ -30,10 +30,12 @@
 #include <SimCore/PhysicsTypes.h>
 
 #include <SimCore/TerrainPhysicsMode.h>
+#include <SimCore/TerrainElevationRaster.h>
 
 #include <dtUtil/threadpool.h>
 
 #include <dtUtil/readnodethreadpooltask.h>
+#include <osg/Timer>
 
 namespace dtGame
 {
@@ -99,6 +101,26 @@ namespace SimCore
          /// This is called if CheckForTerrainLoaded returns true.
          virtual void SetupTerrainPhysics();
 
+         /**
+          * Turns on the height raster used by Utils::KeepTransformOnGround over open terrain.  Defaults to false,
+          * so only maps that clamp many transforms that way pay for sampling the terrain.
+          */
+         void SetElevationRasterEnabled(bool enable);
+         bool GetElevationRasterEnabled() const;
+
+         /**
+          * The directory within the Terrains folder of the project context to cache the height raster tiles in.
+          * Empty, the default, doesn't cache them.
+          */
+         void SetElevationCacheDirectory(const std::string& dir);
+         const std::string& GetElevationCacheDirectory() const;
+
+         /**
+          * @return the height raster of the loaded terrain, which builds its tiles as they are queried,
+          *         or NULL if it is turned off or the terrain hasn't loaded.
+          */
+         TerrainElevationRaster* GetElevationRaster();
+
       protected:
 
          /// Destructor
@@ -108,18 +130,27 @@ namespace SimCore
 
          void LoadMeshFromFile(const std::string& filename, const std::string& materialType);
 
+         /// Makes the height raster for the newly loaded terrain.
+         void SetupElevationRaster();
+
          dtCore::RefPtr<dtPhysics::PhysicsActComp> mHelper;
 
          TerrainPhysicsMode* mTerrainPhysicsMode;
          dtCore::RefPtr<osg::Node> mTerrainNode;
 
          dtCore::RefPtr<dtUtil::ReadNodeThreadPoolTask> mLoadNodeTask;
+         // When the load task was started, for the startup trace.
+         osg::Timer_t mLoadStartTick;
 
          std::string mLoadedFile, mCollisionResourceString, mPhysicsDirectory;
          //This doesn't load the file unless it's in a scene, so this flag tells it to load
          bool mNeedToLoad;
 
          bool mLoadTerrainMeshWithCaching;
+
+         bool mElevationRasterEnabled;
+         std::string mElevationCacheDirectory;
+         dtCore::RefPtr<TerrainElevationRaster> mElevationRaster;
       };
 
       class SIMCORE_EXPORT TerrainActorProxy : public dtGame::GameActorProxy
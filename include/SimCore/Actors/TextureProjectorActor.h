@@ -29,6 +29,12 @@
 #include <SimCore/Projector.h>
 
 #include <osg/observer_ptr>
+#include <osg/ref_ptr>
+
+namespace osg
+{
+   class Texture2D;
+}
 
 namespace dtGame
 {
@@ -57,6 +63,20 @@ namespace SimCore
             // You can respond to OnEnteredWorld on either the proxy or actor or both.
             virtual void OnEnteredWorld();
 
+            /**
+             * Projects the image onto the attached node from the current position and adds the
+             * projector to the TextureProjectorComponent.  Called when the actor enters the world,
+             * and again each time the component reuses the actor.  The image is only loaded again
+             * if the file changed.
+             * @return false if the component, the attached node or the image could not be found.
+             */
+            bool Project();
+
+            /// Turns the projector off and resets the time, so the actor can be reused.
+            void StopProjecting();
+
+            bool IsProjecting() const { return mProjecting; }
+
          protected:
             /// destructor
             virtual ~TextureProjectorActor(void);
@@ -83,6 +103,9 @@ namespace SimCore
             std::string                mImageProjectorFile;
             dtCore::RefPtr<Projector>     mProjector;
             osg::observer_ptr<osg::Node>  mEntityToAttachTo;
+            osg::ref_ptr<osg::Texture2D>  mTexture;
+            std::string                mLoadedImageFile;
+            bool                       mProjecting;
       };
 
       ////////////////////////////////////////////////////////
@@ -62,6 +62,9 @@ namespace SimCore
 
             /*override*/ void OnEnteredWorld();
 
+            /// Tells the ViewerMaterialComponent, so its lookups by name and FID code stay current.
+            /*override*/ void SetName(const std::string& name);
+
             /**
             * The Material actor is global.
             */
@@ -39,6 +39,13 @@ namespace dtAudio
 
 namespace SimCore
 {
+   struct WeaponEvent;
+
+   namespace Components
+   {
+      class WeaponEventAggregatorComponent;
+   }
+
    namespace Actors
    {
       class WeaponFlashActor;
@@ -311,6 +318,10 @@ namespace SimCore
             void SendDetonationMessage( unsigned short quantity, const osg::Vec3& finalVelocity,
                const osg::Vec3& location, const dtCore::Transformable* target = NULL );
 
+            // Sends the event through the WeaponEventAggregatorComponent if there is one,
+            // otherwise as a single shot fired or detonation message.
+            void SendWeaponEvent( const SimCore::WeaponEvent& weaponEvent );
+
             void LoadSoundFire( const std::string& filePath );
             void LoadSoundDryFire( const std::string& filePath );
             void LoadSoundJammed( const std::string& filePath );
@@ -449,6 +460,9 @@ namespace SimCore
             // the weapon fire messages.
             dtCore::ObserverPtr<dtCore::ActorProxy> mOwner;
 
+            // Batches weapon events when it is in the game manager.
+            dtCore::ObserverPtr<SimCore::Components::WeaponEventAggregatorComponent> mEventAggregator;
+
             // The flash actor that is responsible for rendering
             // and the timing of flash effects.
             dtCore::RefPtr<WeaponFlashActor> mFlash;
@@ -27,19 +27,87 @@
 // INCLUDE DIRECTIVES
 ////////////////////////////////////////////////////////////////////////////////
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <dtCore/refptr.h>
 #include <dtUtil/datastream.h>
+#include <osg/Referenced>
+#include <SimCore/ByteSwap.h>
+#include <SimCore/MappedFile.h>
 
 namespace SimCore
 {
+   /////////////////////////////////////////////////////////////////////////////
+   // ARRAY 2D VIEW CODE
+   /////////////////////////////////////////////////////////////////////////////
+   /**
+    * A read only view of a row major grid that doesn't own the values.  It may point into an
+    * Array2DParser, a network buffer or a mapped file.  If the memory belongs to a referenced object,
+    * such as a MappedFile, the view can hold a reference to it to keep it valid.
+    */
+   template<typename T>
+   class Array2DView
+   {
+   public:
+      typedef T value_type;
+
+      Array2DView()
+      : mData(NULL)
+      , mColumns(0)
+      , mRows(0)
+      {
+      }
+
+      Array2DView(const T* data, size_t columns, size_t rows, const osg::Referenced* owner = NULL)
+      : mData(data)
+      , mColumns(columns)
+      , mRows(rows)
+      , mOwner(owner)
+      {
+      }
+
+      T GetValue(unsigned indexRow, unsigned indexCol) const
+      {
+         return mData[(indexRow * mColumns) + indexCol];
+      }
+
+      /// @return the first value of a row.  The rest of the row follows it.
+      const T* GetRow(unsigned indexRow) const { return mData + (indexRow * mColumns); }
+
+      const T* GetData() const { return mData; }
+      size_t GetColumns() const { return mColumns; }
+      size_t GetRows() const { return mRows; }
+      size_t GetSize() const { return mColumns * mRows; }
+      bool IsEmpty() const { return GetSize() == 0; }
+
+      const osg::Referenced* GetOwner() const { return mOwner.get(); }
+
+   private:
+      const T* mData;
+      size_t mColumns;
+      size_t mRows;
+      dtCore::RefPtr<const osg::Referenced> mOwner;
+   };
+
    /////////////////////////////////////////////////////////////////////////////
    // FLOAT ARRAY 2D CODE
    /////////////////////////////////////////////////////////////////////////////
+   /**
+    * A grid of values with the encoding used by the custom HLA 2D array parameters:
+    * the number of columns and rows as shorts, then the values, row by row.
+    * The values are converted to and from the storage byte order in bulk.
+    */
    template<typename T>
    class Array2DParser
    {
    public:
       typedef T value_type;
       typedef typename std::vector<T> VectorType;
+      typedef Array2DView<T> ViewType;
+
+      static const size_t HEADER_SIZE = 2 * sizeof(short);
 
       Array2DParser()
       : mColumns(0)
@@ -52,6 +120,22 @@ namespace SimCore
       void SetLittleEndianStorage(bool littleEndian) { mLittleEndian = littleEndian; }
       bool GetLittleEndianStorage() const { return mLittleEndian; }
 
+      /**
+       * Sets the size of the grid in one allocation.  New values are zero.  Use it before
+       * filling a grid with SetValue, which otherwise grows the grid as it goes.
+       */
+      void Resize(size_t rows, size_t columns)
+      {
+         mColumns = columns;
+         mData.resize(rows * columns);
+      }
+
+      /// Reserves room for a grid of this size, so decoding one up to this size doesn't allocate.
+      void Reserve(size_t rows, size_t columns)
+      {
+         mData.reserve(rows * columns);
+      }
+
       void SetValue(T value, unsigned indexRow, unsigned indexCol)
       {
          unsigned actualIndex = (indexRow * mColumns) + indexCol;
@@ -69,7 +153,13 @@ namespace SimCore
                rows += 1;
             }
 
-            mData.resize(rows * mColumns);
+            // Grow geometrically so filling a grid a row at a time doesn't reallocate for every row.
+            size_t newSize = rows * mColumns;
+            if (newSize > mData.capacity())
+            {
+               mData.reserve(std::max(newSize, mData.capacity() * 2));
+            }
+            mData.resize(newSize);
          }
 
          mData[actualIndex] = value;
@@ -104,9 +194,14 @@ namespace SimCore
       VectorType& GetData() { return mData; }
       const VectorType& GetData() const { return mData; }
 
+      /// @return a view of the values in this parser.  It is invalid once the parser changes size.
+      ViewType GetView() const
+      {
+         return ViewType(mData.empty() ? NULL : &mData[0], mColumns, GetRows());
+      }
+
       size_t Encode(char* buffer, const size_t maxSize) const
       {
-         typedef typename VectorType::const_iterator ConstIter;
          dtUtil::DataStream ds(buffer, maxSize, false);
          ds.SetForceLittleEndian(mLittleEndian);
          ds.ClearBuffer();
@@ -115,53 +210,189 @@ namespace SimCore
          ds << cols;
          ds << rows;
 
-         ConstIter i, iend;
-         i = mData.begin();
-         iend = mData.end();
-         for (; i != iend; ++i)
+         size_t valuesSize = mData.size() * sizeof(T);
+         if (valuesSize == 0 || HEADER_SIZE + valuesSize > maxSize)
+         {
+            return ds.GetBufferSize();
+         }
+
+         char* values = buffer + HEADER_SIZE;
+         if (NeedsSwap(mLittleEndian))
          {
-            ds << *i;
+            CopySwapBytes(values, &mData[0], mData.size(), sizeof(T));
          }
-         return ds.GetBufferSize();
+         else
+         {
+            std::memcpy(values, &mData[0], valuesSize);
+         }
+         return HEADER_SIZE + valuesSize;
       }
 
+      /**
+       * Decodes the grid into this parser.  The values are copied from the buffer and
+       * converted in one pass.  If the grid fits in the reserved size, nothing is allocated.
+       * If the buffer is too short for the values it claims to have, the data is left empty.
+       */
       void Decode(const char* buffer, size_t bufferSize)
       {
-         dtUtil::DataStream ds(const_cast<char*>(buffer), bufferSize, false);
-         ds.SetForceLittleEndian(mLittleEndian);
-         short cols = 0, rows = 0;
-         ds >> cols;
-         ds >> rows;
+         mData.clear();
+
+         size_t cols = 0, rows = 0;
+         if (!DecodeHeader(buffer, bufferSize, mLittleEndian, cols, rows))
+         {
+            return;
+         }
 
          mColumns = cols;
+         size_t length = cols * rows;
+         if (length == 0)
+         {
+            return;
+         }
 
-         // apparently, if it has 0 rows, but 1 column, it really means it has 1 row.
-         if (cols > 0 && rows == 0)
+         mData.resize(length);
+         const char* values = buffer + HEADER_SIZE;
+         if (NeedsSwap(mLittleEndian))
          {
-            rows = 1;
+            CopySwapBytes(&mData[0], values, length, sizeof(T));
+         }
+         else
+         {
+            std::memcpy(&mData[0], values, length * sizeof(T));
          }
+      }
 
-         size_t length = cols*rows;
-         mData.clear();
-         mData.reserve(length);
-         for (size_t i = 0; i < length; ++i)
+      /**
+       * Makes a view straight into the encoded buffer without copying, which is only possible
+       * when the storage byte order matches the cpu and the values in the buffer are aligned.
+       * The buffer must outlive the view, or owner must be set to whatever holds the buffer.
+       * @return false if the values can't be used in place, in which case use Decode.
+       */
+      bool DecodeView(const char* buffer, size_t bufferSize, ViewType& outView,
+               const osg::Referenced* owner = NULL) const
+      {
+         size_t cols = 0, rows = 0;
+         if (!DecodeHeader(buffer, bufferSize, mLittleEndian, cols, rows))
+         {
+            return false;
+         }
+
+         const char* values = buffer + HEADER_SIZE;
+         if (cols * rows > 0 && (NeedsSwap(mLittleEndian) || (reinterpret_cast<size_t>(values) % sizeof(T)) != 0))
          {
-            T f;
-            ds >> f;
-            mData.push_back(f);
+            return false;
          }
+
+         outView = ViewType(reinterpret_cast<const T*>(values), cols, rows, owner);
+         return true;
       }
 
       size_t GetEncodedSize() const
       {
-         return (2 * sizeof(short)) + (mData.size() * sizeof(T));
+         return HEADER_SIZE + (mData.size() * sizeof(T));
       }
 
       void ClearData() { mData.clear(); }
 
+      /// Writes the encoded grid to a file, so it can be loaded with LoadFile.  @return false if it couldn't be written.
+      bool SaveFile(const std::string& fileName) const
+      {
+         std::vector<char> buffer(GetEncodedSize());
+         size_t size = Encode(&buffer[0], buffer.size());
+
+         std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+         if (!file.is_open())
+         {
+            return false;
+         }
+         file.write(&buffer[0], std::streamsize(size));
+         return !file.fail();
+      }
+
+      /**
+       * Memory maps a grid file written by SaveFile.  If the file is stored in the cpu byte order,
+       * outView points straight into the mapping, which the view keeps open, and nothing is read
+       * until it is used.  Otherwise the grid is decoded into this parser and outView points at it.
+       * @return false if the file couldn't be mapped or is too short.
+       */
+      bool LoadFile(const std::string& fileName, ViewType& outView)
+      {
+         dtCore::RefPtr<MappedFile> file = new MappedFile;
+         if (!file->Open(fileName))
+         {
+            return false;
+         }
+
+         if (DecodeView(file->GetData(), file->GetSize(), outView, file.get()))
+         {
+            return true;
+         }
+
+         size_t cols = 0, rows = 0;
+         if (!DecodeHeader(file->GetData(), file->GetSize(), mLittleEndian, cols, rows))
+         {
+            return false;
+         }
+
+         Decode(file->GetData(), file->GetSize());
+         outView = GetView();
+         return true;
+      }
+
    protected:
 
    private:
+      /// @return true if the values are stored in the opposite byte order from the cpu.
+      static bool NeedsSwap(bool forceLittleEndian)
+      {
+         // The header goes through DataStream, so the values use the byte order it writes.
+         static const bool swapWhenForced = IsDataStreamSwapping(true);
+         static const bool swapOtherwise = IsDataStreamSwapping(false);
+         return forceLittleEndian ? swapWhenForced : swapOtherwise;
+      }
+
+      static bool IsDataStreamSwapping(bool forceLittleEndian)
+      {
+         char probe[sizeof(short)] = { 0, 0 };
+         dtUtil::DataStream ds(probe, sizeof(probe), false);
+         ds.SetForceLittleEndian(forceLittleEndian);
+         ds.ClearBuffer();
+         ds << short(1);
+         bool storedLittleEndian = probe[0] == 1;
+         return storedLittleEndian != IsCpuLittleEndian();
+      }
+
+      /// Reads the size of the grid.  @return false if the buffer is shorter than the header and values.
+      static bool DecodeHeader(const char* buffer, size_t bufferSize, bool littleEndian,
+               size_t& outCols, size_t& outRows)
+      {
+         if (buffer == NULL || bufferSize < HEADER_SIZE)
+         {
+            return false;
+         }
+
+         dtUtil::DataStream ds(const_cast<char*>(buffer), HEADER_SIZE, false);
+         ds.SetForceLittleEndian(littleEndian);
+         short cols = 0, rows = 0;
+         ds >> cols;
+         ds >> rows;
+
+         if (cols < 0 || rows < 0)
+         {
+            return false;
+         }
+
+         // apparently, if it has 0 rows, but 1 column, it really means it has 1 row.
+         if (cols > 0 && rows == 0)
+         {
+            rows = 1;
+         }
+
+         outCols = size_t(cols);
+         outRows = size_t(rows);
+         return HEADER_SIZE + (outCols * outRows * sizeof(T)) <= bufferSize;
+      }
+
       size_t mColumns;
       bool mLittleEndian;
       VectorType mData;
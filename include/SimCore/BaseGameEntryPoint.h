@@ -24,11 +24,14 @@
 #define _BASE_GAME_ENTRY_POINT_H_
 
 #include <dtGame/defaultgameentrypoint.h>
+#include <dtGame/gamemanager.h>
 #include <SimCore/Export.h>
+#include <SimCore/StartupPreloader.h>
 #include <dtCore/refptr.h>
 #include <dtCore/baseactorobject.h>
 #include <osg/Vec3>
 #include <string>
+#include <vector>
 #include <dtUtil/getsetmacros.h>
 
 namespace osg
@@ -38,7 +41,7 @@ namespace osg
 
 namespace dtGame
 {
-   class GameManager;
+   class GMComponent;
 }
 
 namespace SimCore
@@ -72,6 +75,31 @@ namespace SimCore
          static const std::string CONFIG_PROP_MUNITION_CONFIG_FILE;
          static const std::string CONFIG_PROP_MUNITION_DEFAULT;
          static const std::string CONFIG_PROP_HIGH_RES_GROUND_CLAMP_RANGE;
+         /// The file to write the startup trace to.  The --startupTrace command line option overrides it.
+         static const std::string CONFIG_PROP_STARTUP_TRACE_FILE;
+         /// Set to false to do all the startup loading on the main thread.  Defaults to true.
+         static const std::string CONFIG_PROP_STARTUP_PRELOAD;
+         /**
+          * The milliseconds per frame given to deferrable work, see FrameBudgetComponent.  Set to 0 to run it all every frame.
+          * Defaults to mDefaultFrameBudgetMillis, which is 0 unless the application's entry point sets it.
+          */
+         static const std::string CONFIG_PROP_FRAME_BUDGET_MILLIS;
+         /// Set to true to profile the frames with the ProfilerComponent.  Defaults to false.
+         static const std::string CONFIG_PROP_PROFILE;
+         /// The file to write the profile trace to.  Setting it turns on profiling.
+         static const std::string CONFIG_PROP_PROFILE_TRACE_FILE;
+         /// The distance past which remote vehicles' wheels update less often, see WheelAnimationComponent.
+         static const std::string CONFIG_PROP_WHEEL_LOD_DISTANCE;
+         /// The distance past which remote vehicles' wheels don't turn.  Set to 0 to animate them at any distance.
+         static const std::string CONFIG_PROP_WHEEL_MAX_DISTANCE;
+         /// The file to capture the incoming network messages to, see NetworkCaptureComponent.  Empty, the default, captures nothing.
+         static const std::string CONFIG_PROP_NETWORK_CAPTURE_FILE;
+         /// A network capture file to play back into the GM, see NetworkReplayComponent.
+         static const std::string CONFIG_PROP_NETWORK_REPLAY_FILE;
+         /// How fast to play the network capture.  1, the default, is real time, and 0 is as fast as possible.
+         static const std::string CONFIG_PROP_NETWORK_REPLAY_TIME_SCALE;
+         /// Set to true to load the terrain physics around the physics actors with the TerrainPhysicsPagingComponent instead of the cull visitor.  Defaults to false.
+         static const std::string CONFIG_PROP_TERRAIN_PHYSICS_PAGING;
 
          /// Constructor
          BaseGameEntryPoint();
@@ -103,6 +131,12 @@ namespace SimCore
           */
          bool IsUIRunning() const { return !GetMapIsRequired(); }
 
+         /**
+          * The tasks that load data on the thread pool during startup.  Subclasses may add their own
+          * in OnStartup.  It is started before the actor registry is loaded and is NULL once shut down.
+          */
+         StartupPreloader* GetStartupPreloader() { return mStartupPreloader.get(); }
+
       protected:
 
 
@@ -117,6 +151,16 @@ namespace SimCore
           */
          void AssignAspectRatio(dtGame::GameManager& gm);
 
+         /// Adds the component, recording how long its OnAddedToGM takes in the startup trace.
+         void AddTracedComponent(dtGame::GameManager& gm, dtGame::GMComponent& component,
+            const dtGame::GameManager::ComponentPriority& priority = dtGame::GameManager::ComponentPriority::NORMAL);
+
+         /**
+          * Collects the full paths of the models used by the actors in the map, to be loaded by the
+          * startup preloader.  The default collects every static mesh property.
+          */
+         virtual void GetMapModelFiles(const std::string& mapName, std::vector<std::string>& outFiles);
+
          /// Destructor
          virtual ~BaseGameEntryPoint();
 
@@ -127,10 +171,17 @@ namespace SimCore
          //int mStatisticsInterval;
          osg::Vec3 mStartPos;
          bool mMissingRequiredCommandLineOption;
+         /// The frame budget used when the config doesn't set CONFIG_PROP_FRAME_BUDGET_MILLIS.
+         double mDefaultFrameBudgetMillis;
 
       private:
+         void AddShaderPreloads(StartupPreloader& preloader);
+         void AddModelPreloads(StartupPreloader& preloader);
+
          // If the audio was started by this class, or was already running.
          bool mStartedAudio;
+         std::string mStartupTraceFile;
+         dtCore::RefPtr<StartupPreloader> mStartupPreloader;
    };
 }
 #endif
@@ -0,0 +1,53 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _SIMCORE_BYTE_SWAP_H_
+#define _SIMCORE_BYTE_SWAP_H_
+
+#include <SimCore/Export.h>
+
+#include <cstddef>
+
+namespace SimCore
+{
+   /// @return true if the cpu stores values least significant byte first.
+   SIMCORE_EXPORT bool IsCpuLittleEndian();
+
+   /**
+    * Copies count elements of elementSize bytes from src to dest, reversing the bytes of each one,
+    * such as to convert an array between network and cpu byte order.  Uses SSE2 when it is
+    * available for 2, 4 and 8 byte elements.  dest and src may be the same array, but must not
+    * otherwise overlap, and neither has to be aligned.
+    */
+   SIMCORE_EXPORT void CopySwapBytes(void* dest, const void* src, size_t count, size_t elementSize);
+
+   /// Reverses the bytes of each element of the array in place.
+   SIMCORE_EXPORT void SwapBytes(void* data, size_t count, size_t elementSize);
+
+   template<typename T>
+   inline void SwapBytes(T* data, size_t count)
+   {
+      SwapBytes(data, count, sizeof(T));
+   }
+}
+
+#endif
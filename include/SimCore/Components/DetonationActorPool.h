@@ -0,0 +1,162 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef DETONATION_ACTOR_POOL_H
+#define DETONATION_ACTOR_POOL_H
+
+#include <SimCore/Export.h>
+#include <SimCore/Actors/DetonationActor.h>
+#include <osg/Referenced>
+#include <dtCore/observerptr.h>
+#include <dtCore/uniqueid.h>
+#include <map>
+#include <vector>
+
+namespace dtGame
+{
+   class GameManager;
+}
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // Detonation Actor Pool Code
+      //////////////////////////////////////////////////////////////////////////
+      /**
+       * Keeps finished detonation actors in the game manager so they can be reused,
+       * rather than creating a new actor from the prototype for every detonation.
+       * Pooled actors keep their sound and particle systems loaded, so reusing one
+       * doesn't touch the disk.  Actors are pooled by their detonation prototype and
+       * impact type, since those decide which effects are loaded.
+       */
+      class SIMCORE_EXPORT DetonationActorPool : public osg::Referenced
+      {
+         public:
+            static const unsigned DEFAULT_MAX_IDLE_PER_TYPE = 16;
+
+            struct SIMCORE_EXPORT Statistics
+            {
+               Statistics();
+
+               /// @return the fraction of acquired detonations that were reused, or 0 if none were acquired.
+               float GetHitRate() const;
+
+               /// @return the average time to get a detonation into the scene, or 0 if none were recorded.
+               double GetAverageSpawnTimeMS() const;
+
+               unsigned mAcquired;
+               unsigned mHits;
+               unsigned mReleased;
+               // Released actors deleted because their idle list was full.
+               unsigned mDiscarded;
+               unsigned mSpawns;
+               double mTotalSpawnTimeMS;
+               double mMaxSpawnTimeMS;
+            };
+
+            DetonationActorPool();
+
+            void SetGameManager( dtGame::GameManager* gameManager );
+            dtGame::GameManager* GetGameManager();
+
+            // Set the most finished detonations kept for each prototype and impact type.
+            // Any more than this are deleted when they finish.
+            void SetMaxIdlePerType( unsigned maxIdle );
+            unsigned GetMaxIdlePerType() const;
+
+            /**
+             * Gets an idle detonation for the prototype and impact type, or creates one from the prototype.
+             * Call Detonate on it once it is placed.  A new actor must be added to the game manager first.
+             * @param outReused Set to true if the actor is already in the game manager.
+             * @return the detonation, or NULL if the prototype could not be created.
+             */
+            dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> Acquire( const dtCore::UniqueId& prototypeId,
+               SimCore::Actors::DetonationActor::IMPACT_TYPE impact, bool& outReused );
+
+            /**
+             * Stops the detonation and makes it available to Acquire again.
+             * @return false if the detonation doesn't belong to this pool.
+             */
+            bool Release( SimCore::Actors::DetonationActorProxy& proxy );
+
+            /// Stops tracking a pooled detonation, such as one deleted from the game manager.
+            void Remove( const dtCore::UniqueId& actorId );
+
+            bool IsPooled( const dtCore::UniqueId& actorId ) const;
+
+            /// @return true if the actor belongs to this pool and is waiting to be reused.
+            bool IsIdle( const dtCore::UniqueId& actorId ) const;
+
+            unsigned GetNumPooled() const;
+            unsigned GetNumIdle() const;
+
+            /**
+             * Creates detonations ahead of time and adds them to the game manager, so their effects
+             * are loaded before the first detonation of that type.
+             * @return the number of detonations added to the pool.
+             */
+            unsigned Preload( const dtCore::UniqueId& prototypeId,
+               SimCore::Actors::DetonationActor::IMPACT_TYPE impact, unsigned count );
+
+            /**
+             * Forgets all pooled detonations.  It doesn't delete them from the game manager,
+             * so call it when the map is unloaded or the game manager is reset.
+             */
+            void Clear();
+
+            /// Records how long it took to get a detonation into the scene, including Acquire.
+            void RecordSpawnTime( double milliseconds );
+
+            const Statistics& GetStatistics() const;
+            void ResetStatistics();
+
+         protected:
+            virtual ~DetonationActorPool();
+
+         private:
+            typedef std::pair<dtCore::UniqueId, int> PoolKey;
+            typedef std::vector<dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> > ProxyList;
+            typedef std::map<PoolKey, ProxyList> IdleListMap;
+
+            struct PooledActor
+            {
+               PooledActor( const PoolKey& key ) : mKey(key), mIdle(false) {}
+               PoolKey mKey;
+               bool mIdle;
+            };
+            typedef std::map<dtCore::UniqueId, PooledActor> PooledActorMap;
+
+            dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> CreateDetonation( const PoolKey& key );
+
+            dtCore::ObserverPtr<dtGame::GameManager> mGM;
+            unsigned mMaxIdlePerType;
+            IdleListMap mIdleLists;
+            PooledActorMap mPooledActors;
+            Statistics mStats;
+      };
+
+   }
+}
+
+#endif
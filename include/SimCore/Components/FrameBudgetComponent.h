@@ -0,0 +1,210 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _FRAME_BUDGET_COMPONENT_H_
+#define _FRAME_BUDGET_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtUtil/functor.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Referenced>
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      class FrameBudgetComponent;
+
+      /**
+       * A piece of work that can wait a few frames, such as refreshing the labels or sorting the lights.
+       * The owner calls Request when there is work to do, and the FrameBudgetComponent calls the work
+       * function in the first frame that has time for it.  Jobs with a higher priority get time first.
+       *
+       * The work function is usually bound to the owner, so the owner must remove the job from the
+       * component before it goes away.
+       */
+      class SIMCORE_EXPORT FrameBudgetJob : public osg::Referenced
+      {
+      public:
+         typedef dtUtil::Functor<void, TYPELIST_0()> WorkFunc;
+
+         static const unsigned PRIORITY_LOW = 10;
+         static const unsigned PRIORITY_NORMAL = 50;
+         static const unsigned PRIORITY_HIGH = 100;
+
+         /**
+          * @param name the name of the job, unique within the component.
+          * @param subsystem the name the overruns are reported under, usually the name of the owning class.
+          */
+         FrameBudgetJob(const std::string& name, const std::string& subsystem, const WorkFunc& work,
+                  unsigned priority = PRIORITY_NORMAL);
+
+         const std::string& GetName() const;
+         const std::string& GetSubsystem() const;
+
+         /// Jobs with a higher priority get their time first.
+         DT_DECLARE_ACCESSOR(unsigned, Priority);
+
+         /// The job runs anyway once it has been put off for this many frames.  Defaults to 10.
+         DT_DECLARE_ACCESSOR(unsigned, MaxDeferredFrames);
+
+         /// Asks for the work to run.  Requesting it again before it runs does nothing.
+         void Request();
+         bool IsRequested() const;
+
+         /// @return how many frames the current request has been put off.
+         unsigned GetFramesDeferred() const;
+
+         /**
+          * The time the work is expected to take, which decides if it fits in what is left of a frame.
+          * It starts at the value set here and follows the measured run times.
+          */
+         void SetExpectedMillis(double millis);
+         double GetExpectedMillis() const;
+
+         /// @return the time the work took the last time it ran.
+         double GetLastMillis() const;
+
+         /// @return the component the job is in, or NULL.
+         FrameBudgetComponent* GetFrameBudget();
+
+         /// Removes the job from its component, if it is in one.
+         void RemoveFromFrameBudget();
+
+         /// Runs the work now and measures it.  The component calls this.
+         void Run();
+
+      protected:
+         virtual ~FrameBudgetJob();
+
+      private:
+         friend class FrameBudgetComponent;
+
+         std::string mName;
+         std::string mSubsystem;
+         WorkFunc mWork;
+         bool mRequested;
+         unsigned mFramesDeferred;
+         double mExpectedMillis;
+         double mLastMillis;
+         dtCore::ObserverPtr<FrameBudgetComponent> mFrameBudget;
+      };
+
+      /**
+       * @class FrameBudgetComponent
+       * @brief Gives the deferrable work of the frame a fixed number of milliseconds.
+       *
+       * Once per frame, at frame synch, the requested jobs are run highest priority first until the
+       * budget is used up.  A job that doesn't fit in what is left is put off to a later frame, unless
+       * nothing has run yet this frame or it has already been put off for its maximum number of frames.
+       * The runs, deferrals and overruns are counted per subsystem.  A job overruns when it finishes
+       * after the budget is used up.
+       *
+       * Add it with a lower priority than the components that request jobs, so jobs requested while
+       * handling frame synch still run in the same frame.
+       */
+      class SIMCORE_EXPORT FrameBudgetComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const double DEFAULT_FRAME_BUDGET_MILLIS;
+
+         struct SIMCORE_EXPORT SubsystemStats
+         {
+            SubsystemStats();
+
+            unsigned mNumRuns;
+            unsigned mNumDeferred;
+            /// Runs that happened only because the job hit its maximum deferred frames.
+            unsigned mNumForced;
+            unsigned mNumOverruns;
+            double mTotalMillis;
+            double mMaxMillis;
+         };
+
+         typedef std::map<std::string, SubsystemStats> SubsystemStatsMap;
+
+         FrameBudgetComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// The time given to the jobs each frame.  Defaults to 4 ms.
+         DT_DECLARE_ACCESSOR(double, FrameBudgetMillis);
+
+         /**
+          * Requests the job, first adding it to the component on the game manager if it isn't in one.
+          * @return false if there is no frame budget component, in which case the caller should do the work now.
+          */
+         static bool RequestJob(dtGame::GameManager& gm, FrameBudgetJob& job);
+
+         /// Adds the job, taking it from any other component it is in.  Jobs with the same name are replaced.
+         void AddJob(FrameBudgetJob& job);
+         void RemoveJob(FrameBudgetJob& job);
+         FrameBudgetJob* FindJob(const std::string& name);
+         unsigned GetNumJobs() const;
+
+         /// Runs the requested jobs that fit in the budget.  This happens at frame synch.
+         void RunFrame();
+
+         /// @return the time the jobs took in the last frame.
+         double GetLastFrameMillis() const;
+
+         /// @return true if any job was put off or overran in the last frame.
+         bool IsOverBudget() const;
+
+         /// @return the stats of the subsystem, or NULL if none of its jobs have been requested yet.
+         const SubsystemStats* GetSubsystemStats(const std::string& subsystem) const;
+         const SubsystemStatsMap& GetAllSubsystemStats() const;
+         void ResetStats();
+
+         /// Writes a line per subsystem with its runs, deferrals, overruns and times.
+         void WriteReport(std::ostream& out) const;
+
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~FrameBudgetComponent();
+
+      private:
+         typedef std::vector<dtCore::RefPtr<FrameBudgetJob> > JobList;
+
+         JobList mJobs;
+         // The requested jobs of the frame being run, kept to reuse the memory.
+         std::vector<FrameBudgetJob*> mRunList;
+         SubsystemStatsMap mStats;
+         double mLastFrameMillis;
+         bool mOverBudget;
+      };
+   }
+}
+
+#endif
@@ -0,0 +1,256 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef SIMCORE_LABEL_GLYPH_BATCH_H
+#define SIMCORE_LABEL_GLYPH_BATCH_H
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+#include <SimCore/Export.h>
+#include <dtCore/refptr.h>
+#include <dtCore/uniqueid.h>
+
+#include <osg/Array>
+#include <osg/Referenced>
+#include <osg/Vec2>
+#include <osg/Vec4>
+
+#include <map>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+namespace osg
+{
+   class Camera;
+   class DrawArrays;
+   class Geometry;
+   class Texture2D;
+}
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // GLYPH ATLAS CODE
+      //////////////////////////////////////////////////////////////////////////
+      /**
+       * The glyphs of a font packed into a single texture, so every label can be drawn
+       * from one geometry.  Glyph sizes are in pixels.
+       */
+      class SIMCORE_EXPORT LabelGlyphAtlas : public osg::Referenced
+      {
+         public:
+            struct SIMCORE_EXPORT Glyph
+            {
+               Glyph();
+
+               osg::Vec2 mTexMin;
+               osg::Vec2 mTexMax;
+               float mWidth;
+               float mHeight;
+               float mAdvance;
+               bool mValid;
+            };
+
+            LabelGlyphAtlas();
+
+            /**
+             * Sets up a fixed width font laid out in a grid of equal cells, starting with firstChar
+             * in the top left cell and going left to right, then top to bottom.
+             */
+            void SetupGrid(unsigned columns, unsigned rows, unsigned char firstChar, float glyphWidth, float glyphHeight);
+
+            /**
+             * Loads a grid font image, such as one exported by a bitmap font generator, and sets up the grid
+             * with the glyph size set to the cell size.
+             * @return false if the image could not be loaded.
+             */
+            bool LoadGridFont(const std::string& imageFile, unsigned columns, unsigned rows, unsigned char firstChar);
+
+            /**
+             * Builds the atlas at runtime from a font file, such as a TrueType font, by rasterizing the
+             * printable ASCII glyphs with osgText.  Each glyph gets a cell as tall as the line, with the glyph
+             * placed on a shared baseline, so the labels lay out the same as with a grid font.  An opaque
+             * block is added for the solid texture coordinate, so the labels get backgrounds.
+             * @param fontFile the font, found in the data file path list.
+             * @param pixelSize the font size in pixels.
+             * @return false if the font could not be loaded.
+             */
+            bool LoadFont(const std::string& fontFile, unsigned pixelSize);
+
+            void SetGlyph(unsigned char c, const Glyph& glyph);
+
+            /// @return the glyph for the character, the '?' glyph if it is missing, or NULL if neither are in the atlas.
+            const Glyph* GetGlyph(unsigned char c) const;
+
+            /// The distance between lines, in pixels.
+            void SetLineHeight(float height);
+            float GetLineHeight() const;
+
+            /// @return the width of the text in pixels.
+            float GetTextWidth(const std::string& text) const;
+
+            /**
+             * Sets a texture coordinate of an opaque texel.  If set, labels get a background quad in
+             * the label color behind white text, like the CEGUI labels.  Otherwise the text is drawn in the label color.
+             */
+            void SetSolidTexCoord(const osg::Vec2& texCoord);
+            void ClearSolidTexCoord();
+            bool HasSolidTexCoord() const;
+            const osg::Vec2& GetSolidTexCoord() const;
+
+            void SetTexture(osg::Texture2D* texture);
+            osg::Texture2D* GetTexture();
+
+         protected:
+            virtual ~LabelGlyphAtlas();
+
+         private:
+            std::vector<Glyph> mGlyphs;
+            float mLineHeight;
+            osg::Vec2 mSolidTexCoord;
+            bool mHasSolidTexCoord;
+            dtCore::RefPtr<osg::Texture2D> mTexture;
+      };
+
+
+
+      //////////////////////////////////////////////////////////////////////////
+      // GLYPH BATCH CODE
+      //////////////////////////////////////////////////////////////////////////
+      /**
+       * Draws all the entity labels from one vertex buffer of glyph quads using a LabelGlyphAtlas,
+       * instead of one CEGUI window per label.  The glyph layout of a label is only rebuilt when
+       * its text changes.  The buffer is refilled in a single pass over the labels sorted by depth,
+       * farthest first, when any label moves, changes or goes away.
+       *
+       * Call BeginFrame, then SetLabel for each visible label, then EndFrame.
+       */
+      class SIMCORE_EXPORT LabelGlyphBatch : public osg::Referenced
+      {
+         public:
+            /// Space in pixels between the text and the edge of the background.
+            static const float BACKGROUND_PADDING;
+
+            LabelGlyphBatch(LabelGlyphAtlas& atlas);
+
+            LabelGlyphAtlas& GetAtlas();
+
+            /// Sets the size of the viewport in pixels.  Labels are placed in this space.
+            void SetScreenSize(float width, float height);
+            const osg::Vec2& GetScreenSize() const;
+
+            void BeginFrame();
+
+            /**
+             * Shows a label this frame.
+             * @param screenPos the bottom center of the label in normalized screen coordinates, with 0,0 in the bottom left.
+             * @param depth the normalized depth.  Nearer labels are drawn over farther ones.
+             * @param line2 a second line below the text, or empty for one line.
+             */
+            void SetLabel(const dtCore::UniqueId& id, const std::string& text, const std::string& line2,
+                     const osg::Vec4& color, const osg::Vec2& screenPos, float depth);
+
+            /// Drops the labels that weren't set since BeginFrame, and refills the vertex data if anything changed.
+            void EndFrame();
+
+            void Clear();
+
+            unsigned GetNumLabels() const;
+
+            /// @return the number of quads in the vertex data, including the backgrounds.
+            unsigned GetNumQuads() const;
+
+            /// @return how many times a label's glyph layout has been built, which only happens when its text changes.
+            unsigned GetNumLayoutsBuilt() const;
+
+            /// The vertex data, with 4 vertices per quad in screen pixels.
+            const osg::Vec3Array& GetVertices() const;
+            const osg::Vec2Array& GetTexCoords() const;
+            const osg::Vec4Array& GetColors() const;
+
+            osg::Geometry& GetGeometry();
+
+            /// @return the orthographic camera that draws the labels over the scene.
+            osg::Camera& GetNode();
+
+         protected:
+            virtual ~LabelGlyphBatch();
+
+         private:
+            struct BatchedLabel
+            {
+               BatchedLabel();
+
+               std::string mText;
+               std::string mLine2;
+               osg::Vec4 mColor;
+               osg::Vec2 mScreenPos;
+               float mDepth;
+               bool mUsed;
+               bool mHasBackground;
+               // The quads relative to the bottom center of the label, 4 vertices each.
+               std::vector<osg::Vec2> mLocalVerts;
+               std::vector<osg::Vec2> mTexCoords;
+            };
+
+            class CompareLabelDepth
+            {
+            public:
+               bool operator () (const BatchedLabel* one, const BatchedLabel* two) const
+               {
+                  return one->mDepth > two->mDepth;
+               }
+            };
+
+            void LayoutLabel(BatchedLabel& label);
+            void AddLine(BatchedLabel& label, const std::string& line, float bottom);
+            void AddQuad(BatchedLabel& label, const osg::Vec2& min, const osg::Vec2& max,
+                     const osg::Vec2& texMin, const osg::Vec2& texMax);
+            void FillVertexData();
+
+            typedef std::map<dtCore::UniqueId, BatchedLabel> LabelMap;
+
+            dtCore::RefPtr<LabelGlyphAtlas> mAtlas;
+            LabelMap mLabels;
+            std::vector<const BatchedLabel*> mSortList;
+            osg::Vec2 mScreenSize;
+            unsigned mNumLayoutsBuilt;
+            bool mDirty;
+
+            dtCore::RefPtr<osg::Vec3Array> mVertices;
+            dtCore::RefPtr<osg::Vec2Array> mTexCoords;
+            dtCore::RefPtr<osg::Vec4Array> mColors;
+            dtCore::RefPtr<osg::DrawArrays> mDrawArrays;
+            dtCore::RefPtr<osg::Geometry> mGeometry;
+            dtCore::RefPtr<osg::Camera> mCamera;
+      };
+
+   }
+}
+
+#endif
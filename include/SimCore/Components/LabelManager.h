@@ -31,6 +31,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <SimCore/Export.h>
 #include <SimCore/Components/BaseHUDElements.h>
+#include <SimCore/Components/LabelGlyphBatch.h>
 #include <dtCore/observerptr.h>
 #include <dtGame/gamemanager.h>
 
@@ -57,11 +58,18 @@ namespace dtCore
    class BaseActorObject;
 }
 
+namespace dtUtil
+{
+   class ConfigProperties;
+   class Enumeration;
+}
+
 namespace SimCore
 {
    namespace Components
    {
       class LabelManager;
+      class FrameBudgetJob;
 
       //////////////////////////////////////////////////////////////////////////
       // CLASS CODE
@@ -198,6 +206,18 @@ namespace SimCore
          public:
             typedef std::map<dtCore::UniqueId, dtCore::RefPtr<SimCore::Components::HUDLabel> > LabelMap;
 
+            /// The label backend, either BACKEND_CEGUI, the default, or BACKEND_GLYPH_BATCH.
+            static const std::string CONFIG_PROP_BACKEND;
+            /// The resource of the font the glyph atlas is built from.
+            static const std::string CONFIG_PROP_FONT;
+            /// The size in pixels of the glyph atlas font.
+            static const std::string CONFIG_PROP_FONT_SIZE;
+
+            static const std::string BACKEND_CEGUI;
+            static const std::string BACKEND_GLYPH_BATCH;
+            static const std::string DEFAULT_FONT;
+            static const unsigned DEFAULT_FONT_SIZE = 14;
+
             LabelManager();
 
             void Init(dtGUI::GUI* gui);
@@ -219,8 +239,35 @@ namespace SimCore
 
             dtCore::RefPtr<HUDLabel> GetOrCreateLabel(dtCore::BaseActorObject& actor);
 
+            /// Sets the glyph atlas used to draw the labels when the glyph batch is on.
+            void SetGlyphAtlas(LabelGlyphAtlas* atlas);
+            LabelGlyphAtlas* GetGlyphAtlas();
+
+            /**
+             * Draws all the labels from one LabelGlyphBatch instead of a CEGUI window per label, which is much
+             * cheaper with hundreds of labels in view.  The glyph atlas must be set first.  The batched labels
+             * follow the same options and get their colors from AssignLabelColor.  The second line is only shown
+             * when the options show the damage state.
+             */
+            void SetUseGlyphBatch(bool useBatch);
+            bool GetUseGlyphBatch() const;
+
+            /// @return the glyph batch, or NULL if it isn't in use.
+            LabelGlyphBatch* GetGlyphBatch();
+
+            /**
+             * Picks the label backend from the config.  For the glyph batch, the atlas is built from the configured
+             * font unless one was already set.  The labels stay CEGUI windows if the font can't be loaded.
+             * Call this after the game manager is set.
+             */
+            void LoadConfiguration(const dtUtil::ConfigProperties& config);
+
             void AddLabel(SimCore::Components::HUDLabel& label);
 
+            /**
+             * Refreshes the labels.  This is called at frame synch, unless there is a FrameBudgetComponent
+             * on the game manager, in which case it is requested as a job and may be put off a few frames.
+             */
             void Update(float dt);
 
             void UpdateFormatting(float dt);
@@ -249,7 +296,29 @@ namespace SimCore
          private:
             void ClearLabelsFromGUILayer();
 
+            /// The work of the frame budget job.
+            void RefreshLabels();
+
+            /// Fills the glyph batch with the labels found by the update tasks.
+            void UpdateGlyphBatch(dtCore::Camera& deltaCamera);
+
+            /// @return the color for labels of the force, looked up once through AssignLabelColor.
+            const osg::Vec4& GetForceColor(const dtUtil::Enumeration* force, const dtCore::BaseActorObject& actor);
+
+            /// A label found by an update task, to be drawn by the glyph batch.
+            struct BatchedLabelInfo
+            {
+               dtCore::UniqueId mId;
+               std::string mText;
+               std::string mLine2;
+               const dtUtil::Enumeration* mForce;
+               dtCore::RefPtr<dtCore::BaseActorObject> mActor;
+               osg::Vec2 mScreenPos;
+               float mDepth;
+            };
+
             typedef std::vector<SimCore::Components::HUDLabel*> CEGUISortList;
+            typedef std::map<const dtUtil::Enumeration*, osg::Vec4> ForceColorMap;
 
             dtCore::ObserverPtr<dtGame::GameManager> mGM;
             LabelOptions mOptions;
@@ -259,6 +328,16 @@ namespace SimCore
 
             OpenThreads::Mutex mTaskMutex;
             float mTimeUntilSort;
+
+            bool mUseGlyphBatch;
+            dtCore::RefPtr<LabelGlyphAtlas> mGlyphAtlas;
+            dtCore::RefPtr<LabelGlyphBatch> mGlyphBatch;
+            std::vector<BatchedLabelInfo> mBatchedLabels;
+            // The colors are read from the look of a label that is never shown.
+            dtCore::RefPtr<HUDLabel> mColorLabel;
+            ForceColorMap mForceColors;
+
+            dtCore::RefPtr<FrameBudgetJob> mRefreshJob;
       };
 
    }
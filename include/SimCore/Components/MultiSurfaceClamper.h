@@ -49,6 +49,14 @@ namespace dtCore
    class TransformableActorProxy;
 }
 
+namespace SimCore
+{
+   namespace Components
+   {
+      class FrameBudgetComponent;
+   }
+}
+
 
 
 namespace SimCore
@@ -212,8 +220,9 @@ namespace SimCore
              * @param data Ground Clamping Data containing clamping options and runtime data.
              * @param tranformChanged Flag to make a better determination for clamping.
              * @param velocity Instantaneous velocity of the object for the current frame.
-             * @return INTERMITTENT if velocity is zero and the transform has not changed; otherwise
-             *         suggestedCalmpType is returned.
+             * @return INTERMITTENT if velocity is zero and the transform has not changed, or if the
+             *         frame is over budget and the object is beyond the high resolution range;
+             *         otherwise suggestedCalmpType is returned.
              */
             virtual dtGame::BaseGroundClamper::GroundClampRangeType& GetBestClampType(
                dtGame::BaseGroundClamper::GroundClampRangeType& suggestedClampType,
@@ -335,6 +344,14 @@ namespace SimCore
              */
             bool IsWaterOnlyDomain( SimCore::Actors::BaseEntityActorProxy::DomainEnum& domain ) const;
 
+            /**
+             * Set the frame budget to watch.  While it reports that the frame is over budget,
+             * entities beyond the high resolution clamping range are clamped intermittently.
+             * Water craft are always clamped.
+             */
+            void SetFrameBudget( FrameBudgetComponent* frameBudget );
+            FrameBudgetComponent* GetFrameBudget();
+
             /**
              * Set the water surface to be detected when trying to clamp water craft.
              */
@@ -375,6 +392,9 @@ namespace SimCore
             double mCurrentSimTime;
             SimCore::Actors::BaseEntityActorProxy::DomainEnum* mDefaultDomain;
             dtCore::ObserverPtr<SimCore::Actors::BaseWaterActor> mSurfaceWater;
+            dtCore::ObserverPtr<FrameBudgetComponent> mFrameBudget;
+            // Set by ClampToGround for the object being clamped.
+            bool mDeferClamping;
       };
    }
 
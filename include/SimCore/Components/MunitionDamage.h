@@ -227,6 +227,7 @@ namespace SimCore
             void SetDirectFireProbabilities( float none, float mobility, float firepower, float mobilityFirepower, float kill );
             void SetDirectFireProbabilities( const DamageProbability& probabilities );
             const DamageProbability* GetDirectFireProbabilities() { return mDirectFireProbs.get(); }
+            const DamageProbability* GetDirectFireProbabilities() const { return mDirectFireProbs.get(); }
 
             // Set damage probabilities for munitions such as High Explosives (HE),
             // Improved Conventional Munition (ICM), and other PROXIMITY types.
@@ -236,6 +237,7 @@ namespace SimCore
             void SetIndirectFireProbabilities( float none, float mobility, float firepower, float mobilityFirepower, float kill );
             void SetIndirectFireProbabilities( const DamageProbability& probabilities );
             const DamageProbability* GetIndirectFireProbabilities() { return mIndirectFireProbs.get(); }
+            const DamageProbability* GetIndirectFireProbabilities() const { return mIndirectFireProbs.get(); }
 
             void GetDamageProbabilities( DamageProbability& outProbabilities,
                float& outDistanceFromImpact, const osg::Vec3& modelDimensions,
@@ -83,6 +83,9 @@ namespace SimCore
 
             const MunitionDamage* GetMunitionDamage( const std::string& name ) const;
 
+            // Fills the list with all the munition damages in this table, sorted by name.
+            void GetMunitionDamageList( std::vector<const MunitionDamage*>& outList ) const;
+
             void Clear();
 
          protected:
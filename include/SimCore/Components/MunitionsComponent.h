@@ -40,8 +40,11 @@
 #include <SimCore/Components/MunitionDamageTable.h>
 #include <SimCore/Components/MunitionTypeTable.h>
 #include <SimCore/Components/WeaponEffectsManager.h>
+#include <SimCore/Messages.h>
+#include <SimCore/StartupPreloader.h>
 #include <dtGame/gmcomponent.h>
 #include <deque>
+#include <map>
 
 
 
@@ -73,6 +76,40 @@ namespace SimCore
    {
       class DamageType;
       class DamageHelper;
+      class DetonationActorPool;
+
+
+
+      //////////////////////////////////////////////////////////////////////////
+      // Munition Table Preload Task Code
+      //////////////////////////////////////////////////////////////////////////
+      /**
+       * Reads the munition damage tables on the thread pool during startup.
+       * Made by MunitionsComponent::CreateMunitionTablePreload, which then uses
+       * the tables the next time it loads the same file.
+       */
+      class SIMCORE_EXPORT MunitionTablePreloadTask : public SimCore::StartupPreloadTask
+      {
+      public:
+         static const std::string DEFAULT_NAME;
+
+         MunitionTablePreloadTask( const std::string& resourcePath, bool useCache );
+
+         const std::string& GetResourcePath() const;
+
+         /// The tables read by the task.  Only valid once the task has finished.
+         std::vector<dtCore::RefPtr<MunitionDamageTable> >& GetTables();
+
+      protected:
+         virtual ~MunitionTablePreloadTask();
+
+         virtual void Run();
+
+      private:
+         std::string mResourcePath;
+         bool mUseCache;
+         std::vector<dtCore::RefPtr<MunitionDamageTable> > mTables;
+      };
 
 
 
@@ -114,6 +151,18 @@ namespace SimCore
          // @return number of successfully loaded tables.
          unsigned int LoadMunitionDamageTables( const std::string& munitionConfigPath );
 
+         // Reads the tables from a munition config file without adding them.  This doesn't
+         // touch the component or the project, so it may be called from any thread.
+         // @param resourcePath The full path of the MunitionsConfig.xml
+         // @return number of successfully read tables.
+         static unsigned int ReadMunitionDamageTables( const std::string& resourcePath, bool useCache,
+            std::vector<dtCore::RefPtr<MunitionDamageTable> >& outTables );
+
+         // Makes a task that reads the tables in MunitionConfigFileName so they are ready by the time
+         // the component loads them on restart.  The task must be added to a StartupPreloader that is started.
+         // @return the task, or NULL if the config file can't be found.
+         dtCore::RefPtr<MunitionTablePreloadTask> CreateMunitionTablePreload();
+
          // Searches for a table by name of an entity class.
          // @param entityClassName The name of the entity class that should have
          //        a table of munition data that was loaded from the MunitionsConfig.xml
@@ -179,6 +228,13 @@ namespace SimCore
           */
          DT_DECLARE_ACCESSOR(std::string, MunitionConfigFileName);
 
+         /**
+          * Set whether LoadMunitionDamageTables uses a compiled binary copy of the munition config.
+          * The binary copy is written to MunitionsConfigCache::GetCacheDirectory and is rebuilt whenever the xml changes.
+          * It defaults to true.
+          */
+         DT_DECLARE_ACCESSOR(bool, UseMunitionConfigCache);
+
          /**
           * Encapsulates the complexity of picking a munition based on the message sent in.
           * It will allow using one of the defaults set if no exact match is found, and it can use
@@ -226,6 +282,9 @@ namespace SimCore
          // are too many in our queue, it calls CleanupCreatedMunitionsQueue().
          void AddMunitionToCreatedMunitionsQueue(const dtCore::UniqueId &uniqueId);
 
+         // Returns the number of munitions in the created munitions queue, counting a reused detonation once.
+         unsigned GetNumCreatedMunitions() const;
+
          /**
           * Returns the maximum number of munitions that are allowed to be active. This is a performance
           * setting. The Munitions Component will track created munitions. When it needs to create a new
@@ -234,8 +293,31 @@ namespace SimCore
           */
          DT_DECLARE_ACCESSOR(unsigned, MaximumActiveMunitions);
 
+         /**
+          * Set whether finished detonation actors are kept for reuse rather than deleted.
+          * Reused detonations keep their sounds and particle systems loaded.
+          * It defaults to true, and may be set with the config property <component name>.UseDetonationPool.
+          */
+         DT_DECLARE_ACCESSOR(bool, UseDetonationPool);
+
+         /**
+          * The number of detonations created for each munition type when a map is loaded, so
+          * their effects are loaded before the first detonation.  It defaults to 0, and may be set
+          * with the config property <component name>.DetonationPoolPreloadCount.
+          */
+         DT_DECLARE_ACCESSOR(unsigned, DetonationPoolPreloadCount);
+
+         DetonationActorPool& GetDetonationActorPool();
+         const DetonationActorPool& GetDetonationActorPool() const;
+
          void ConvertMunitionInfoActorsToDetonationActors(const std::string& mapName);
 
+         /// @return the number of weapon event batch messages processed.
+         unsigned GetNumWeaponEventBatchesProcessed() const;
+
+         /// @return the number of shot fired and detonation events processed from batch messages.
+         unsigned GetNumBatchedWeaponEventsProcessed() const;
+
       protected:
 
          // Destructor
@@ -250,11 +332,20 @@ namespace SimCore
          void OnDetonation(const dtGame::Message& msg);
          void OnShotFired(const dtGame::Message& msg);
 
-         void RunIsectorForFIDCodes(bool hitEntity, const DetonationMessage& message, int fidID);
+         // Processes each event in the batch as if it had arrived as its own shot fired or detonation message.
+         void OnWeaponEventBatch(const dtGame::Message& msg);
+
+         void RunIsectorForFIDCodes(bool hitEntity, const DetonationMessage& message, int& fidID);
          dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> CreateDetonationPrototype(const DetonationMessage& message);
 
+         // Creates the detonations requested by DetonationPoolPreloadCount for each munition type.
+         void PreloadDetonations();
+
          void ConvertSingleMunitionInfo(SimCore::Actors::MunitionEffectsInfoActorProxy& infoProxy, SimCore::Actors::DetonationActorProxy& detonationProxy);
 
+         // Adds or replaces the tables.  @return successes, less the tables that could not be added.
+         unsigned int AddMunitionDamageTables( const std::vector<dtCore::RefPtr<MunitionDamageTable> >& tables, unsigned int successes );
+
       private:
 
          // This map holds onto all damages helpers. Each damage helper is mapped
@@ -294,14 +385,33 @@ namespace SimCore
          // Effects include gun flash, fire sounds and tracers.
          dtCore::RefPtr<WeaponEffectsManager> mEffectsManager;
 
+         // Finished detonations waiting to be reused.
+         dtCore::RefPtr<DetonationActorPool> mDetonationPool;
+
+         // Tables being read during startup, used by the next LoadMunitionDamageTables for the same file.
+         dtCore::RefPtr<MunitionTablePreloadTask> mTablePreload;
+
          // A queue of all the munitions that the component has created. This is
          // useful for when we get in trouble with particles and such. If we have too
          // many munitions, then we can simply kill off the oldest.
-         std::deque<dtCore::UniqueId> mCreatedMunitionsQueue;
+         // Each entry has a serial number.  A reused detonation gets a new entry, and the serial
+         // in mQueuedMunitionSerials says which entry is current, so the old one is skipped
+         // instead of searched for.
+         typedef std::pair<dtCore::UniqueId, unsigned> QueuedMunition;
+         std::deque<QueuedMunition> mCreatedMunitionsQueue;
+         std::map<dtCore::UniqueId, unsigned> mQueuedMunitionSerials;
+         unsigned mNextQueueSerial;
 
          // The name of the default damage table to use if an actor has none assigned.
          std::string mDefaultDamageTableName;
 
+         // Reused for unpacking weapon event batches.
+         std::vector<WeaponEvent> mBatchedEvents;
+         dtCore::RefPtr<ShotFiredMessage> mBatchedShotMessage;
+         dtCore::RefPtr<DetonationMessage> mBatchedDetonationMessage;
+         unsigned mNumWeaponEventBatchesProcessed;
+         unsigned mNumBatchedWeaponEventsProcessed;
+
       };
 
    }
@@ -0,0 +1,129 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef _MUNITION_CONFIG_CACHE_H_
+#define _MUNITION_CONFIG_CACHE_H_
+
+#include <SimCore/Export.h>
+
+#include <dtCore/base.h>
+#include <dtCore/refptr.h>
+#include <vector>
+
+namespace dtUtil
+{
+   class DataStream;
+}
+
+namespace SimCore
+{
+   namespace Components
+   {
+      class DamageProbability;
+      class DamageRanges;
+      class MunitionDamage;
+      class MunitionDamageTable;
+
+      //////////////////////////////////////////////////////////////////////////
+      // Munition Config Cache Code
+      //////////////////////////////////////////////////////////////////////////
+      /**
+       * Compiled binary form of the munition damage tables read by MunitionsConfig.
+       * The cache remembers the modification time and size of the xml it was compiled from,
+       * so a cache left over from an older xml file is refused and should be regenerated.
+       * The whole file is read with a single read and decoded in place.
+       */
+      class SIMCORE_EXPORT MunitionsConfigCache : public dtCore::Base
+      {
+      public:
+         typedef std::vector<dtCore::RefPtr<MunitionDamageTable> > TableList;
+
+         static const std::string CACHE_FILE_EXTENSION;
+         static const unsigned CACHE_FILE_MAGIC;
+         static const unsigned CACHE_FILE_VERSION;
+
+         /// Identifies the version of the xml file a cache was compiled from.
+         struct SIMCORE_EXPORT SourceStamp
+         {
+            SourceStamp();
+
+            bool operator== (const SourceStamp& other) const;
+            bool operator!= (const SourceStamp& other) const;
+
+            double mModifiedTime;
+            unsigned mFileSize;
+         };
+
+         MunitionsConfigCache();
+
+         /**
+          * @return the directory the caches are written to, in the user's home directory so the
+          *         data directories can stay read only.  Empty if there is no home directory.
+          */
+         static std::string GetCacheDirectory();
+
+         /**
+          * @return the cache file path used for the given xml file.  It is in the cache directory and
+          *         named after the full path of the xml, so files of the same name don't collide.
+          *         It falls back to the path next to the xml file if there is no cache directory.
+          */
+         static std::string GetCacheFilePath( const std::string& xmlFilePath );
+
+         /// @return false if the xml file can't be found.
+         static bool GetSourceStamp( const std::string& xmlFilePath, SourceStamp& outStamp );
+
+         /**
+          * Writes the tables compiled from the xml file to the cache file, making its directory if needed.
+          * @return false if the xml file is missing or the cache could not be written.
+          */
+         bool Save( const std::string& xmlFilePath, const std::string& cacheFilePath,
+            const TableList& tables ) const;
+
+         /**
+          * Loads the tables from the cache file if it was compiled from the current xml file.
+          * outTables is left alone if the cache is missing, stale or invalid.
+          * @return the number of tables loaded; 0 if the xml should be parsed instead.
+          */
+         unsigned int Load( const std::string& xmlFilePath, const std::string& cacheFilePath,
+            TableList& outTables ) const;
+
+         void Encode( dtUtil::DataStream& ds, const SourceStamp& stamp, const TableList& tables ) const;
+
+         /// @return false if the data is invalid or doesn't match the expected stamp.
+         bool Decode( dtUtil::DataStream& ds, const SourceStamp& expectedStamp, TableList& outTables ) const;
+
+      protected:
+         virtual ~MunitionsConfigCache();
+
+         void EncodeMunitionDamage( dtUtil::DataStream& ds, const MunitionDamage& damage ) const;
+         void EncodeProbabilities( dtUtil::DataStream& ds, const DamageProbability& probs ) const;
+         void EncodeRanges( dtUtil::DataStream& ds, const DamageRanges& ranges ) const;
+
+         dtCore::RefPtr<MunitionDamage> DecodeMunitionDamage( dtUtil::DataStream& ds ) const;
+         void DecodeProbabilities( dtUtil::DataStream& ds, DamageProbability& probs ) const;
+         void DecodeRanges( dtUtil::DataStream& ds, DamageRanges& ranges ) const;
+      };
+
+   }
+}
+
+#endif
@@ -0,0 +1,113 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _NETWORK_CAPTURE_COMPONENT_H_
+#define _NETWORK_CAPTURE_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Timer>
+#include <fstream>
+#include <string>
+
+namespace dtUtil
+{
+   class DataStream;
+}
+
+namespace SimCore
+{
+   namespace Components
+   {
+      /**
+       * @class NetworkCaptureComponent
+       * @brief Writes the messages that come in from the network to a binary capture file.
+       *
+       * Every message whose source is another machine, such as the actor creates, updates and deletes
+       * and the detonations that the HLA or client/server component sends to the GM, is written
+       * with the real time since the capture started.  A NetworkReplayComponent plays the file back
+       * into a GM without the network, so the processing of the traffic can be benchmarked offline.
+       *
+       * The file starts with the magic number and version.  Each record is the time in seconds as a double,
+       * the message type id as an unsigned short, and the size of the message data as an unsigned,
+       * followed by the message data.  Everything is little endian.
+       */
+      class SIMCORE_EXPORT NetworkCaptureComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const unsigned CAPTURE_FILE_MAGIC;
+         static const unsigned CAPTURE_FILE_VERSION;
+         /// The size of the magic number and version at the start of the file.
+         static const unsigned FILE_HEADER_SIZE;
+         /// The size of the time, type id and data size at the start of each record.
+         static const unsigned RECORD_HEADER_SIZE;
+
+         NetworkCaptureComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// The file to capture to.  If it is set when the component is added to the GM, the capture starts then.
+         DT_DECLARE_ACCESSOR(std::string, CaptureFile);
+
+         /**
+          * Opens the capture file, replacing any file that is there, and starts capturing.
+          * @return false if the file can't be opened.
+          */
+         bool StartCapture();
+
+         /// Closes the capture file.
+         void StopCapture();
+
+         bool IsCapturing() const;
+
+         /// @return the number of messages written since the capture started.
+         unsigned GetNumCaptured() const;
+
+         /// Writes the message to the capture file.  ProcessMessage calls this for the network messages.
+         void CaptureMessage(const dtGame::Message& message);
+
+         /// Writes the message data that NetworkReplayComponent::DecodeMessage reads.
+         static void EncodeMessage(dtUtil::DataStream& ds, const dtGame::Message& message);
+
+         virtual void OnAddedToGM();
+
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~NetworkCaptureComponent();
+
+      private:
+         std::ofstream mOut;
+         osg::Timer_t mStartTick;
+         unsigned mNumCaptured;
+      };
+   }
+}
+
+#endif
@@ -0,0 +1,238 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _NETWORK_REPLAY_COMPONENT_H_
+#define _NETWORK_REPLAY_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Timer>
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dtUtil
+{
+   class DataStream;
+}
+
+namespace dtGame
+{
+   class MachineInfo;
+}
+
+namespace SimCore
+{
+   namespace Components
+   {
+      class NetworkReplayComponent;
+
+      /**
+       * @class NetworkReplayProbeComponent
+       * @brief Tells the NetworkReplayComponent when the GM takes each replayed message off its queue.
+       *
+       * The replay component adds it with the highest priority, so the latency it measures doesn't include
+       * the time a message waits in the queue behind the ones sent before it.
+       */
+      class SIMCORE_EXPORT NetworkReplayProbeComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         NetworkReplayProbeComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         void SetReplayComponent(NetworkReplayComponent* replayComp);
+         NetworkReplayComponent* GetReplayComponent();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~NetworkReplayProbeComponent();
+
+      private:
+         dtCore::ObserverPtr<NetworkReplayComponent> mReplayComp;
+      };
+
+      /**
+       * @class NetworkReplayComponent
+       * @brief Plays a file written by the NetworkCaptureComponent back into the GM, as if it came from the network.
+       *
+       * The messages are sent in the order they were captured, each with a source machine matching the one it was
+       * captured from, so the message processor and the other components handle them as remote messages.
+       * With a time scale of 1 they are sent at the times they were captured, with 2 at double speed, and with 0
+       * or less as fast as possible, limited only by the max messages per tick.
+       *
+       * The component measures the latency of each message from when the GM takes it off the queue, which a
+       * NetworkReplayProbeComponent with the highest priority reports, to when it reaches this component.  Add it
+       * with the lowest priority to have that cover the processing by the other components.  The time each message
+       * waited in the queue is measured separately.  A message that doesn't arrive within the message timeout is
+       * counted as dropped, so it doesn't hold up the replay.
+       */
+      class SIMCORE_EXPORT NetworkReplayComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         NetworkReplayComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// How fast to play the capture.  1, the default, is real time.  0 or less plays it as fast as possible.
+         DT_DECLARE_ACCESSOR(float, TimeScale);
+
+         /// The most messages to send each tick.  0, the default, means no limit.
+         DT_DECLARE_ACCESSOR(unsigned, MaxMessagesPerTick);
+
+         /// Seconds a sent message has to reach this component before it is counted as dropped.  Defaults to 5.
+         DT_DECLARE_ACCESSOR(float, MessageTimeout);
+
+         /**
+          * Reads a capture file into memory, stopping any replay.
+          * @return false if the file can't be read or isn't a capture file.  The records before any truncated one are kept.
+          */
+         bool LoadCapture(const std::string& fileName);
+
+         /// @return the number of messages in the loaded capture.
+         unsigned GetNumRecords() const;
+
+         /// Starts sending the loaded messages from the beginning, and resets the stats.
+         void StartReplay();
+         void StopReplay();
+         bool IsReplaying() const;
+
+         /// @return true once every message has been sent and has reached this component or been dropped.
+         bool IsFinished() const;
+
+         /**
+          * Sends the messages that are due at the current replay time.  ProcessMessage calls this on each local tick.
+          * @return the number of messages sent.
+          */
+         unsigned SendDueMessages();
+
+         /// @return the number of messages sent.
+         unsigned GetNumSent() const;
+         /// @return the number of sent messages that have reached this component.
+         unsigned GetNumProcessed() const;
+         /// @return the number of sent messages that never reached this component or timed out.
+         unsigned GetNumDropped() const;
+         /// @return the number of records that couldn't be made into messages, such as ones with unknown message types.
+         unsigned GetNumSkipped() const;
+
+         /// @return the real time in seconds since the replay started, up to when the last message was processed.
+         double GetElapsedSeconds() const;
+         /// @return the processed messages per real second.
+         double GetMessagesPerSecond() const;
+         /// The latency is from when the GM took the message off the queue to when it reached this component.
+         double GetMeanLatencyMillis() const;
+         double GetMaxLatencyMillis() const;
+         /// @return the mean time from sending a message to the GM taking it off the queue.
+         double GetMeanQueueMillis() const;
+
+         /// Called by the probe when the GM takes a message off the queue.
+         void OnMessageDequeued(const dtGame::Message& message);
+
+         /// Writes the throughput and latency stats on one line.
+         void WriteStats(std::ostream& out) const;
+
+         /**
+          * Reads message data written by NetworkCaptureComponent::EncodeMessage into a new message
+          * made by the GM's message factory.
+          * @return NULL if the message type isn't known or the data is bad.
+          */
+         dtCore::RefPtr<dtGame::Message> DecodeMessage(unsigned short typeId, dtUtil::DataStream& ds);
+
+         virtual void OnAddedToGM();
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~NetworkReplayComponent();
+
+      private:
+         struct ReplayRecord
+         {
+            double mTime;
+            unsigned mOffset;
+            unsigned mSize;
+            unsigned short mTypeId;
+         };
+
+         struct SentMessage
+         {
+            dtCore::RefPtr<const dtGame::Message> mMessage;
+            osg::Timer_t mSentTick;
+            osg::Timer_t mDequeuedTick;
+            bool mDequeued;
+            // The probe saw a later message first, so the GM dropped this one.
+            bool mDropped;
+         };
+
+         /// Stops the replay and logs the stats.
+         void FinishReplay();
+
+         /// Removes the oldest in flight message.
+         void PopInFlight();
+
+         /// Drops the messages that are past the timeout or that the probe found were dropped.
+         void DropLostMessages();
+
+         /// @return the machine info for the source, making one the first time the source is seen.
+         const dtGame::MachineInfo& GetSourceMachine(const dtCore::UniqueId& id, const std::string& name);
+
+         std::vector<char> mBuffer;
+         std::vector<ReplayRecord> mRecords;
+         std::map<dtCore::UniqueId, dtCore::RefPtr<dtGame::MachineInfo> > mSourceMachines;
+         std::deque<SentMessage> mInFlight;
+         // The number of in flight messages, from the front, that the probe has seen or skipped.
+         unsigned mNumDequeued;
+         dtCore::RefPtr<NetworkReplayProbeComponent> mProbe;
+         unsigned mNextRecord;
+         bool mReplaying;
+         bool mFinished;
+
+         osg::Timer_t mStartTick;
+         osg::Timer_t mLastProcessedTick;
+         unsigned mNumSent;
+         unsigned mNumProcessed;
+         unsigned mNumSkipped;
+         unsigned mNumDropped;
+         double mTotalLatency;
+         double mMaxLatency;
+         double mTotalQueueWait;
+      };
+   }
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include <dtCore/particlesystem.h>
 #include <dtCore/observerptr.h>
 #include <dtGame/gmcomponent.h>
+#include <dtCore/refptr.h>
 #include <osgParticle/ForceOperator>
 
 namespace dtGame
@@ -42,10 +43,20 @@ namespace osgParticle
    class ParticleSystem;
 }
 
+namespace SimCore
+{
+   namespace Actors
+   {
+      class PhysicsParticleSystemActor;
+   }
+}
+
 namespace SimCore
 {
    namespace Components
    {
+      class FrameBudgetJob;
+
       //////////////////////////////////////////////////////////
       // Particle Priority code
       //////////////////////////////////////////////////////////
@@ -165,6 +176,12 @@ namespace SimCore
       /**
       * @class ParticleManagerComponent
       * @brief subclassed Manages shaders and wind on particle systems.
+      *
+      * Particle systems and physics particle actors are kept in dense arrays as they are
+      * registered.  Wind changes only record the new wind; the forces are applied on the
+      * next tick in one pass over both arrays, however many changes came in.  Physics
+      * particle actors are dropped when their delete message arrives, and particle systems
+      * that went away are dropped as those passes come across them.
       */
       class SIMCORE_EXPORT ParticleManagerComponent : public dtGame::GMComponent
       {
@@ -180,6 +197,9 @@ namespace SimCore
          // Clean all allocated memory
          void Clear();
 
+         // Removes the force update job from the frame budget.
+         virtual void OnRemovedFromGM();
+
          // Clear and re-initialize
          void Reset();
 
@@ -203,6 +223,30 @@ namespace SimCore
          // @return bool TRUE if the particle system id is registered with this component
          bool HasRegistered( const dtCore::UniqueId& particlesId) const;
 
+         // @return the number of particle systems registered, including any whose particle
+         // system has been deleted but not yet found by a pass.
+         unsigned GetNumRegistered() const;
+
+         // Registers a physics particle actor so it gets the wind.  The current wind is applied right away.
+         // The actor is removed when its delete message is processed.
+         // @return TRUE if the actor was registered, FALSE if it already was.
+         bool RegisterPhysicsParticles( Actors::PhysicsParticleSystemActor& particles );
+
+         // @return TRUE if the actor had been registered and was removed.
+         bool UnregisterPhysicsParticles( const dtCore::UniqueId& actorId );
+
+         bool HasRegisteredPhysicsParticles( const dtCore::UniqueId& actorId ) const;
+
+         unsigned GetNumPhysicsParticlesRegistered() const;
+
+         // Sets the wind applied to wind enabled particles.  This is normally taken from the
+         // environment actor.  The forces are updated on the next tick.
+         void SetWind( const osg::Vec3& wind );
+         const osg::Vec3& GetWind() const;
+
+         // @return TRUE if the wind changed since the forces were last applied.
+         bool IsForceUpdatePending() const;
+
          // Sets a timer to regularly tell this component
          // to update its particle information.
          // Setting the value to 0 or lower will disable the update timer.
@@ -222,6 +266,9 @@ namespace SimCore
          // Info is removed if its weak reference to the particle system is NULL.
          void UpdateParticleInfo();
 
+         // Applies the wind to every registered particle system and physics particle actor
+         // in one pass, if it has changed since the last pass.  When there is a FrameBudgetComponent,
+         // the pass runs as a low priority job there instead of in the tick.
          void UpdateParticleForces();
 
          // Applies a vector force to layers of the particle system that have operators
@@ -259,8 +306,30 @@ namespace SimCore
 
       private:
 
-         typedef std::map< dtCore::UniqueId, dtCore::RefPtr<ParticleInfo> > ParticleInfoMap;
-         ParticleInfoMap mIdToInfoMap;
+         struct ParticleEntry
+         {
+            dtCore::UniqueId mId;
+            dtCore::RefPtr<ParticleInfo> mInfo;
+         };
+
+         struct PhysicsParticleEntry
+         {
+            dtCore::UniqueId mId;
+            dtCore::ObserverPtr<Actors::PhysicsParticleSystemActor> mActor;
+         };
+
+         typedef std::map<dtCore::UniqueId, unsigned> IdToIndexMap;
+
+         ParticleInfo* FindInfo( const dtCore::UniqueId& particlesId );
+         void RemoveParticleEntry( unsigned index );
+         void RemovePhysicsParticleEntry( unsigned index );
+
+         // Dense arrays so the force passes don't walk a map.  Entries are removed by moving
+         // the last entry into their place, and the index maps are kept up to date.
+         std::vector<ParticleEntry> mParticles;
+         IdToIndexMap mIdToParticleIndex;
+         std::vector<PhysicsParticleEntry> mPhysicsParticles;
+         IdToIndexMap mIdToPhysicsParticleIndex;
 
          std::map< dtCore::UniqueId, dtCore::RefPtr<ActorInfo> >     mIdToActorMap;
 
@@ -272,6 +341,7 @@ namespace SimCore
          // Forces to be applied to registered particles
          osg::Vec3 mWind;
          bool mWindWasUpdated;
+         dtCore::RefPtr<FrameBudgetJob> mForceUpdateJob;
       };
    } // namespace
 }// namespace
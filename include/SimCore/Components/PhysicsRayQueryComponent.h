@@ -0,0 +1,174 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef _PHYSICS_RAY_QUERY_COMPONENT_H_
+#define _PHYSICS_RAY_QUERY_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtPhysics/raycast.h>
+#include <dtUtil/functor.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Vec3>
+#include <vector>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      class RayQueryTask;
+
+      /**
+       * @class PhysicsRayQueryComponent
+       * @brief Collects ray queries during the tick and runs them together as one batch.
+       *
+       * The hits arrive at the end of the frame, so only submit queries that can wait that long,
+       * such as the paths of ballistic rounds.  Checks that must hold every frame, like keeping a
+       * vehicle on the ground, should trace their rays right away.
+       *
+       * Queries are traced either against the physics world or against the scene graph.
+       * The batch runs at the end of the frame, after the physics step.  The physics queries are
+       * split across the immediate queue of the thread pool.  The scene queries are traced on the
+       * main thread while the workers run, because OSG computes the bounds of the scene lazily
+       * during the traversal, which isn't safe to do from several threads.  Nothing changes the
+       * physics world while the batch runs, since the main thread waits for it.  The callbacks are
+       * then called on the main thread in the order the queries were submitted.
+       *
+       * The hit lists passed to the callbacks are owned by the component and reused every
+       * frame, so copy anything that is needed after the callback returns.
+       */
+      class SIMCORE_EXPORT PhysicsRayQueryComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const unsigned DEFAULT_MIN_QUERIES_PER_TASK = 16;
+
+         typedef std::vector<dtPhysics::RayCast::Report> HitList;
+         /// Called with the hits of a query, sorted by distance.  The list is empty if nothing was hit.
+         typedef dtUtil::Functor<void, TYPELIST_1(const HitList&)> QueryCallback;
+
+         PhysicsRayQueryComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// Whether batches are split across the thread pool.  Defaults to true.
+         DT_DECLARE_ACCESSOR(bool, UseWorkerThreads);
+
+         /// Batches with fewer queries than twice this are run on the main thread.  Defaults to 16.
+         DT_DECLARE_ACCESSOR(unsigned, MinQueriesPerTask);
+
+         /// The node mask used to trace scene queries.  Defaults to all nodes.
+         DT_DECLARE_ACCESSOR(unsigned, SceneTraversalMask);
+
+         /**
+          * Queues a ray against the physics world.  The origin, direction and collision group
+          * filter of the ray are used.
+          * @param owner If it is given, the callback is skipped if the owner is deleted before
+          *              the batch runs.  Pass the actor or component that the callback is bound to.
+          */
+         void SubmitPhysicsQuery( const dtPhysics::RayCast& ray, const QueryCallback& callback, osg::Referenced* owner = NULL );
+
+         /**
+          * Queues a line segment against the scene graph.  Only the hit position and normal of the reports are set.
+          * @see SubmitPhysicsQuery
+          */
+         void SubmitSceneQuery( const osg::Vec3& start, const osg::Vec3& end, const QueryCallback& callback, osg::Referenced* owner = NULL );
+
+         unsigned GetNumPendingQueries() const;
+
+         /// Traces all the queued queries and calls their callbacks.  This happens at the end of every frame.
+         void RunQueries();
+
+         /// Drops the queued queries without calling their callbacks.
+         void ClearQueries();
+
+         /// @return the number of queries run in the last batch.
+         unsigned GetLastBatchQueryCount() const;
+
+         /// @return the number of queries in the last batch that were traced on worker threads.
+         unsigned GetLastBatchWorkerQueryCount() const;
+
+         /// @return the time it took to trace the last batch, not counting the callbacks.
+         double GetLastBatchQueryTimeMS() const;
+
+         /// @return the number of queries run since the statistics were reset.
+         unsigned GetTotalQueryCount() const;
+
+         /// @return the time spent tracing batches since the statistics were reset.
+         double GetTotalQueryTimeMS() const;
+
+         void ResetStatistics();
+
+         virtual void OnAddedToGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+         /// Used by the worker tasks.
+         struct Query
+         {
+            Query();
+
+            bool mIsPhysics;
+            dtPhysics::RayCast mRay;
+            osg::Vec3 mStart;
+            osg::Vec3 mEnd;
+            QueryCallback mCallback;
+            dtCore::ObserverPtr<osg::Referenced> mOwner;
+            bool mHasOwner;
+         };
+
+         /**
+          * Traces the query into the hit list.  Physics queries are safe to trace from the worker
+          * tasks.  Scene queries must be traced on the main thread.
+          */
+         void TraceQuery( const Query& query, HitList& outHits );
+
+      protected:
+         virtual ~PhysicsRayQueryComponent();
+
+      private:
+         Query& AddQuery( const QueryCallback& callback, osg::Referenced* owner );
+
+         std::vector<Query> mQueries;
+         // The batch being run, swapped with mQueries.
+         std::vector<Query> mRunningQueries;
+         unsigned mNumQueries;
+         // One hit list per query.  They keep their capacity between frames.
+         std::vector<HitList> mHitLists;
+         // The indices of the physics queries in the running batch, which are split between the tasks.
+         std::vector<unsigned> mPhysicsQueryIndices;
+         std::vector<dtCore::RefPtr<RayQueryTask> > mTasks;
+
+         unsigned mLastBatchQueryCount;
+         unsigned mLastBatchWorkerQueryCount;
+         double mLastBatchQueryTimeMS;
+         unsigned mTotalQueryCount;
+         double mTotalQueryTimeMS;
+      };
+   }
+}
+
+#endif
@@ -0,0 +1,131 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _POSITION_MARKER_COMPONENT_H_
+#define _POSITION_MARKER_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Array>
+#include <vector>
+
+namespace osg
+{
+   class Geode;
+   class Geometry;
+}
+
+namespace dtCore
+{
+   class ShaderProgram;
+}
+
+namespace SimCore
+{
+   namespace Actors
+   {
+      class PositionMarker;
+   }
+
+   namespace Components
+   {
+      /**
+       * @class PositionMarkerComponent
+       * @brief Fades and deletes all the position markers in one pass every update interval.
+       *
+       * A PositionMarker registers itself here in OnEnteredWorld instead of starting its own repeating timer,
+       * so the markers are updated together from one array with the sim time read once per pass.
+       * Markers that have faded out and are set to delete on fade out are deleted by the pass.
+       *
+       * The component also draws the registered markers.  It owns one copy of the marker mesh with the
+       * position and color of every visible marker in per instance vertex attributes, so all the markers
+       * are drawn with a single instanced draw call.  The markers hide their own mesh while registered.
+       */
+      class SIMCORE_EXPORT PositionMarkerComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const float DEFAULT_UPDATE_INTERVAL;
+
+         /// The vertex attribute locations of the per instance data in the batch shader.
+         static const unsigned POSITION_ATTRIBUTE = 6;
+         static const unsigned COLOR_ATTRIBUTE = 7;
+
+         PositionMarkerComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// The sim time between passes over the markers.  Defaults to 1 second.
+         DT_DECLARE_ACCESSOR(float, UpdateInterval);
+
+         /// Adds the marker.  Registering it again does nothing.
+         void RegisterMarker(SimCore::Actors::PositionMarker& marker);
+         void UnregisterMarker(SimCore::Actors::PositionMarker& marker);
+         bool IsRegistered(const SimCore::Actors::PositionMarker& marker) const;
+
+         unsigned GetNumMarkers() const;
+
+         /// Sets the fade color of every marker for the sim time, and deletes the ones that have faded out.
+         void UpdateMarkers(double simTime);
+
+         /**
+          * Copies the position and current color of every visible marker into the instance arrays
+          * and sets the instance count of the draw.  This is called every tick.
+          */
+         void UpdateBatch();
+
+         /// @return the number of marker instances in the last batch update.
+         unsigned GetNumInstances() const;
+
+         /// @return the geometry all the markers are drawn with.  Exposed mainly for testing.
+         osg::Geometry* GetBatchGeometry();
+
+         virtual void OnAddedToGM();
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~PositionMarkerComponent();
+
+      private:
+         void BuildBatch();
+
+         std::vector<dtCore::ObserverPtr<SimCore::Actors::PositionMarker> > mMarkers;
+         double mNextUpdateTime;
+
+         dtCore::RefPtr<osg::Geode> mBatchGeode;
+         dtCore::RefPtr<osg::Geometry> mBatchGeom;
+         dtCore::RefPtr<osg::Vec3Array> mInstancePositions;
+         dtCore::RefPtr<osg::Vec4Array> mInstanceColors;
+         dtCore::RefPtr<dtCore::ShaderProgram> mBatchShader;
+      };
+   }
+}
+
+#endif
@@ -0,0 +1,85 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _PROFILER_COMPONENT_H_
+#define _PROFILER_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Timer>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      /**
+       * @class ProfilerComponent
+       * @brief Runs the FrameProfiler while it is on the game manager.
+       *
+       * It collects the profiler records each frame, and sends the stats in a ProfileStatsMessage
+       * every StatsInterval seconds, so a debug display can show them.  If a trace file is set, the
+       * collected records are written to it as a Chrome trace when the component is removed.
+       * Add it with a low priority so the frame synch work of the other components is collected in the same frame.
+       */
+      class SIMCORE_EXPORT ProfilerComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const float DEFAULT_STATS_INTERVAL;
+
+         ProfilerComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// The real time in seconds between stats messages.  Defaults to 1.  Set to 0 to send none.
+         DT_DECLARE_ACCESSOR(float, StatsInterval);
+
+         /// The Chrome trace file to write when the component is removed.  Empty, the default, keeps no trace.
+         DT_DECLARE_ACCESSOR(std::string, TraceFile);
+
+         /// Collects the profiler records.  This happens at frame synch.
+         void CollectFrame();
+
+         /// Sends the stats since the last message and resets them.
+         void SendStats();
+
+         virtual void OnAddedToGM();
+
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~ProfilerComponent();
+
+      private:
+         osg::Timer_t mPeriodStartTick;
+         unsigned mNumFrames;
+      };
+   }
+}
+
+#endif
@@ -67,6 +67,7 @@ namespace SimCore
    {
       //class in cpp
       class UpdateViewCallback;
+      class FrameBudgetJob;
 
       ///////////////////////////////////////////////////////
       //    The Component
@@ -276,6 +277,15 @@ namespace SimCore
             void TimeoutAndDeleteLights(float dt);
             void TransformAndSortLights();
 
+            /// Moves the lights with their targets.
+            void TransformLights();
+
+            /**
+             * Sorts the lights nearest to the camera first.  When there is a FrameBudgetComponent, the
+             * lights are still moved every frame, but the sort is a job that may be put off a few frames.
+             */
+            void SortLights();
+
             void UpdateDynamicLightUniforms(osg::Uniform* lightArray, osg::Uniform* spotLightArray);
             void UpdateDynamicLightUniforms(const LightArray& lights, osg::Uniform* lightArray, osg::Uniform* spotLightArray);
 
@@ -356,6 +366,8 @@ namespace SimCore
             SpotLightPrototypeMap mSpotLightPrototypes;
 
             LightArray mLights;
+
+            dtCore::RefPtr<FrameBudgetJob> mLightSortJob;
       };
    } // namespace
 } // namespace
@@ -0,0 +1,70 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef _STARTUP_TRACE_COMPONENT_H_
+#define _STARTUP_TRACE_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <osg/Timer>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      /**
+       * @class StartupTraceComponent
+       * @brief Records the map load in the StartupTracer and writes the trace file.
+       *
+       * The map load runs over several ticks, so it is timed from the map change message to the
+       * map loaded message.  The trace is written once the map has loaded, and again when the
+       * component is removed, to pick up anything that finished later, like the terrain.
+       * Add it with a low priority so the other components have handled the map loaded message first.
+       */
+      class SIMCORE_EXPORT StartupTraceComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         StartupTraceComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~StartupTraceComponent();
+
+      private:
+         osg::Timer_t mMapChangeStartTick;
+         osg::Timer_t mMapLoadStartTick;
+         bool mMapChanging;
+         bool mMapLoading;
+      };
+   }
+}
+
+#endif
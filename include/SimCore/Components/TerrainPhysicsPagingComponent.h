@@ -0,0 +1,269 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef _TERRAIN_PHYSICS_PAGING_COMPONENT_H_
+#define _TERRAIN_PHYSICS_PAGING_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <SimCore/Actors/PagedTerrainPhysicsActor.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Geode>
+#include <osg/Matrix>
+#include <osg/PagedLOD>
+#include <osg/Vec3>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // Terrain Geode Index Code
+      //////////////////////////////////////////////////////////////////////////
+      class GeodeIndexVisitor;
+
+      /**
+       * A uniform grid over the ground plane of the geodes in a terrain node.  The world
+       * bounds and matrix of each geode are worked out once when the index is built,
+       * so finding the geodes near a point doesn't walk the scene graph.
+       *
+       * The paged LOD nodes found while building are watched.  When the database pager
+       * adds or expires a child of one, UpdatePagedNodes reindexes just that tile.
+       */
+      class SIMCORE_EXPORT TerrainGeodeIndex : public osg::Referenced
+      {
+         public:
+            static const float DEFAULT_CELL_SIZE;
+            /// The paged node of the geodes that aren't under a paged LOD.
+            static const unsigned NO_PAGED_NODE;
+
+            struct Entry
+            {
+               Entry();
+
+               dtCore::ObserverPtr<osg::Geode> mGeode;
+               osg::Vec3 mWorldCenter;
+               float mRadius;
+               osg::Matrix mWorldMatrix;
+               // Geodes under a proxy node need their physics built right away with the world matrix,
+               // the same as the cull visitor does.
+               bool mUnderProxyNode;
+               unsigned mQueryStamp;
+               // The index of the paged node that owns the geode.
+               unsigned mPagedNode;
+            };
+
+            TerrainGeodeIndex();
+
+            /// The width of the grid cells.  Changing it clears the index.
+            void SetCellSize( float cellSize );
+            float GetCellSize() const;
+
+            /// Clears the index and adds every active geode under the node.
+            void Build( osg::Node& terrainNode );
+
+            void Clear();
+
+            unsigned GetNumGeodes() const;
+            unsigned GetNumCells() const;
+            unsigned GetNumPagedNodes() const;
+
+            /**
+             * Reindexes the tiles of the paged LOD nodes that have gained or lost children, and
+             * drops the ones that were deleted.  This only looks at the paged LOD nodes, not the whole terrain.
+             * @return the number of paged nodes reindexed or dropped.
+             */
+            unsigned UpdatePagedNodes();
+
+            /**
+             * Adds the geodes with a bound within the radius of the point on the ground plane to the result.
+             * A geode is only added once for all the queries between calls to BeginQueries, so queries
+             * for several points can share one result list.
+             */
+            void Query( const osg::Vec3& point, float radius, std::vector<const Entry*>& result );
+
+            /// Starts a new set of queries.  See Query.
+            void BeginQueries();
+
+         protected:
+            virtual ~TerrainGeodeIndex();
+
+         private:
+            friend class GeodeIndexVisitor;
+
+            typedef std::pair<int, int> CellKey;
+            typedef std::map<CellKey, std::vector<unsigned> > CellMap;
+
+            struct PagedNode
+            {
+               dtCore::ObserverPtr<osg::PagedLOD> mNode;
+               // Only used to forget the node after it is deleted.
+               const osg::PagedLOD* mNodeKey;
+               unsigned mNumChildren;
+               osg::Matrix mWorldMatrix;
+               bool mUnderProxyNode;
+               std::vector<unsigned> mEntries;
+            };
+
+            // Used while building.  Adds a geode with its world matrix.
+            void AddGeode( osg::Geode& geode, const osg::Matrix& worldMatrix, bool underProxyNode, unsigned pagedNode );
+            unsigned AddPagedNode( osg::PagedLOD& node, const osg::Matrix& worldMatrix, bool underProxyNode );
+            bool IsPagedNodeWatched( const osg::PagedLOD& node ) const;
+            void IndexPagedNode( unsigned pagedNode );
+            void RemovePagedNodeEntries( PagedNode& pagedNode );
+            void RemoveEntry( unsigned entryIndex );
+
+            int ToCell( float value ) const;
+            // @return false if the entry is too big for the cells.
+            bool GetCellRange( const Entry& entry, int& minX, int& maxX, int& minY, int& maxY ) const;
+            void CheckEntry( unsigned entryIndex, const osg::Vec3& point, float radius, std::vector<const Entry*>& result );
+
+            float mCellSize;
+            unsigned mQueryStamp;
+            std::vector<Entry> mEntries;
+            // Entries of paged out geodes, reused by the next geodes added.
+            std::vector<unsigned> mFreeEntries;
+            CellMap mCells;
+            // Geodes too big to put in the cells.
+            std::vector<unsigned> mLargeEntries;
+            std::vector<PagedNode> mPagedNodes;
+            std::set<const osg::PagedLOD*> mWatchedNodes;
+      };
+
+      //////////////////////////////////////////////////////////////////////////
+      // Terrain Physics Paging Component Code
+      //////////////////////////////////////////////////////////////////////////
+      /**
+       * @class TerrainPhysicsPagingComponent
+       * @brief Loads the terrain tiles around every physics-active entity into the physics engine.
+       *
+       * This replaces the terrain physics in SimCoreCullVisitor, which only pages tiles around
+       * the camera and only when the scene is culled.  This component keeps a TerrainGeodeIndex
+       * of the terrain actor and, on its own schedule, hands the geodes near each focus point to
+       * the PagedTerrainPhysicsActor.  The focus points are the local actors with dynamic physics,
+       * any actors added with AddFocusActor, and optionally the camera.  Nothing here depends on
+       * rendering, so it works on a dedicated server.
+       *
+       * The cull visitor physics in the RenderingSupportComponent is turned off while this
+       * component is in the game manager, since both would mark the same tiles.
+       *
+       * The index is built when the map or the terrain is loaded.  After that, only the tiles
+       * the database pager pages in or out are reindexed.  The local physics actors are tracked
+       * as they are created and deleted.
+       */
+      class SIMCORE_EXPORT TerrainPhysicsPagingComponent : public dtGame::GMComponent
+      {
+         public:
+            typedef dtGame::GMComponent BaseClass;
+
+            static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+            // The default component name, used when looking it up on the GM.
+            static const std::string DEFAULT_NAME;
+
+            TerrainPhysicsPagingComponent( dtCore::SystemComponentType& type = *TYPE );
+
+            /// Tiles with a bound within this distance of a focus point are loaded into physics.  Defaults to 1250.
+            DT_DECLARE_ACCESSOR(float, CookingRadius);
+
+            /// Seconds between updates of which tiles are loaded.  Defaults to 0.5.
+            DT_DECLARE_ACCESSOR(float, UpdateInterval);
+
+            /// Whether the camera is a focus point.  Defaults to true, but dedicated servers should turn it off.
+            DT_DECLARE_ACCESSOR(bool, IncludeCamera);
+
+            /// Whether local actors with a dynamic physics object are focus points.  Defaults to true.
+            DT_DECLARE_ACCESSOR(bool, IncludeLocalPhysicsActors);
+
+            /// Makes the actor a focus point whether or not it is local or has physics.
+            void AddFocusActor( const dtCore::UniqueId& actorId );
+            void RemoveFocusActor( const dtCore::UniqueId& actorId );
+            bool IsFocusActor( const dtCore::UniqueId& actorId ) const;
+
+            /// Finds the terrain and rebuilds the geode index now.
+            void RebuildIndex();
+
+            /// Rebuilds the geode index from the node.  RebuildIndex calls this with the node of the terrain actor.
+            void SetTerrainNode( osg::Node* terrainNode );
+            osg::Node* GetTerrainNode();
+
+            /// @return the number of local physics actors being tracked as focus points.
+            unsigned GetNumPhysicsActors() const;
+
+            TerrainGeodeIndex& GetGeodeIndex();
+
+            /// Finds or creates the actor that holds the terrain physics.
+            SimCore::Actors::PagedTerrainPhysicsActor* GetLandActor();
+
+            /// Collects the focus points and updates which tiles are loaded now.
+            void UpdateTerrainPhysics();
+
+            /// Fills the list with the positions tiles are loaded around.
+            void GetFocusPoints( std::vector<osg::Vec3>& outPoints );
+
+            unsigned GetLastNumFocusPoints() const;
+            unsigned GetLastNumGeodesChecked() const;
+            /// @return the number of paged tiles reindexed by the last update.
+            unsigned GetLastNumTilesReindexed() const;
+            double GetLastUpdateTimeMS() const;
+
+            virtual void OnAddedToGM();
+            virtual void OnRemovedFromGM();
+
+            virtual void ProcessMessage( const dtGame::Message& message );
+
+         protected:
+            virtual ~TerrainPhysicsPagingComponent();
+
+         private:
+            void ProcessTick( float deltaTime );
+            void AddActorPosition( dtGame::GameActorProxy& actor, std::vector<osg::Vec3>& outPoints );
+            // Starts tracking the actor if it is local and has a dynamic physics object.
+            void TrackPhysicsActor( dtGame::GameActorProxy& actor );
+            void TrackAllPhysicsActors();
+            void DisableCullVisitorPhysics();
+            void Reset();
+
+            typedef std::map<dtCore::UniqueId, dtCore::ObserverPtr<dtGame::GameActorProxy> > ActorMap;
+
+            dtCore::RefPtr<TerrainGeodeIndex> mIndex;
+            dtCore::ObserverPtr<SimCore::Actors::PagedTerrainPhysicsActor> mLandActor;
+            dtCore::ObserverPtr<osg::Node> mTerrainNode;
+            std::set<dtCore::UniqueId> mFocusActors;
+            ActorMap mPhysicsActors;
+            std::vector<osg::Vec3> mFocusPoints;
+            std::vector<const TerrainGeodeIndex::Entry*> mGeodesToCheck;
+            float mTimeUntilUpdate;
+            unsigned mLastNumFocusPoints;
+            unsigned mLastNumGeodesChecked;
+            unsigned mLastNumTilesReindexed;
+            double mLastUpdateTimeMS;
+      };
+   }
+}
+
+#endif
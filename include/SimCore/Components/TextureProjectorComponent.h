@@ -24,8 +24,12 @@
 #define _TEXTURE_PROJECTOR_COMPONENT_H_
 
 #include <dtGame/gmcomponent.h>
+#include <dtCore/uniqueid.h>
 #include <SimCore/Export.h>
 
+#include <map>
+#include <vector>
+
 namespace dtGame
 {
    class Message;
@@ -37,15 +41,27 @@ namespace SimCore
    namespace Actors
    {
       class TextureProjectorActor;
+      class TextureProjectorActorProxy;
    }
 
    namespace Components
    {
+      /**
+       * Removes texture projectors, such as scorch marks and craters, once they have been projected
+       * for their max time, and removes the ones closest to expiring when there are too many.
+       * The projectors are kept in a heap ordered by the sim time they expire, so a tick only looks
+       * at the ones that have expired.  Expired projectors are turned off and kept as idle actors,
+       * so AcquireTextureProjector can reuse them for the next decal instead of creating a new actor.
+       */
       class SIMCORE_EXPORT TextureProjectorComponent : public dtGame::GMComponent
       {
       public:
          static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
          static const dtUtil::RefString DEFAULT_NAME;
+
+         static const unsigned DEFAULT_MAX_NUMBER_OF_PROJECTED_TEXTURES = 100;
+         static const unsigned DEFAULT_MAX_IDLE_PROJECTORS = 32;
+
          TextureProjectorComponent(dtCore::SystemComponentType& type = *TYPE);
 
       protected:
@@ -54,15 +70,70 @@ namespace SimCore
          virtual ~TextureProjectorComponent();
 
       public:
+         /// Called by the actor when it starts projecting.
          void AddTextureProjectorActorToComponent(Actors::TextureProjectorActor &toAdd);
          void RemoveTextureProjectorActorFromComponent(Actors::TextureProjectorActor &toRemove);
 
+         /**
+          * Gets an idle projector to reuse, or creates a new one.  Set the image and the node to
+          * attach to, and place it.  A reused projector is already in the game manager, so
+          * call Project on it.  A new one starts projecting when it is added to the game manager.
+          * @param outReused Set to true if the projector is already in the game manager.
+          * @return the projector, or NULL if it could not be created.
+          */
+         dtCore::RefPtr<Actors::TextureProjectorActorProxy> AcquireTextureProjector(bool& outReused);
+
+         /// The most projectors that may be projecting at once.  The ones closest to expiring are removed first.
+         void SetMaxNumberOfProjectedTextures(unsigned maxNum);
+         unsigned GetMaxNumberOfProjectedTextures() const;
+
+         /// The most expired projectors kept for reuse.  Any more are deleted.
+         void SetMaxIdleProjectors(unsigned maxIdle);
+         unsigned GetMaxIdleProjectors() const;
+
+         unsigned GetNumProjectedTextures() const;
+         unsigned GetNumIdleProjectors() const;
+
          void ProcessTick(const dtGame::TickMessage &msg);
          void ProcessMessage(const dtGame::Message &msg);
 
+         /// Lets go of the projectors.
+         virtual void OnRemovedFromGM();
+
       private:
+         struct ExpiryEntry
+         {
+            double mExpireSimTime;
+            // Matched against mActiveProjectors so entries for removed projectors can be skipped.
+            unsigned mSerial;
+            dtCore::RefPtr<Actors::TextureProjectorActor> mActor;
+
+            /// Orders the heap so the earliest expiry is on top.
+            bool operator<(const ExpiryEntry& other) const { return mExpireSimTime > other.mExpireSimTime; }
+         };
+
+         void PushExpiry(Actors::TextureProjectorActor& actor, unsigned serial);
+
+         /// @return true if the entry is still the current one for its projector.
+         bool IsCurrent(const ExpiryEntry& entry) const;
+
+         /// Turns the projector off and keeps it for reuse, or deletes it if the idle list is full.
+         void RetireProjector(Actors::TextureProjectorActor& actor);
+
+         /// Rebuilds the heap without stale entries once they outnumber the live ones.
+         void CompactExpiryHeap();
+
+         void RemoveIdleProjector(const dtCore::UniqueId& id);
+
+         void Clear();
+
          unsigned int mMaxNumberOfProjectedTextures;
-         std::list<dtCore::RefPtr<Actors::TextureProjectorActor> > mActorList;
+         unsigned mMaxIdleProjectors;
+         unsigned mNextSerial;
+         double mSimTime;
+         std::vector<ExpiryEntry> mExpiryHeap;
+         std::map<dtCore::UniqueId, unsigned> mActiveProjectors;
+         std::vector<dtCore::RefPtr<Actors::TextureProjectorActorProxy> > mIdleProjectors;
       };
    }
 }
@@ -0,0 +1,70 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _TRAIL_EFFECT_BATCH_COMPONENT_H_
+#define _TRAIL_EFFECT_BATCH_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/refptr.h>
+
+namespace SimCore
+{
+   class TrailEffectBatch;
+
+   namespace Components
+   {
+      /**
+       * @class TrailEffectBatchComponent
+       * @brief Owns the TrailEffectBatch that all the ribbon trails in the scene are drawn with.
+       *
+       * Trail producers, such as a TrailEffectActComp with a ribbon width, look this up by name
+       * and add their trails to its batch, so all the ribbons are drawn by one geometry.  The batch
+       * is added to the scene when the component is added to the GM.
+       */
+      class SIMCORE_EXPORT TrailEffectBatchComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         TrailEffectBatchComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// @return the shared batch.  It exists while the component is in a GM.
+         SimCore::TrailEffectBatch* GetBatch();
+
+         virtual void OnAddedToGM();
+         virtual void OnRemovedFromGM();
+
+      protected:
+         virtual ~TrailEffectBatchComponent();
+
+      private:
+         dtCore::RefPtr<SimCore::TrailEffectBatch> mBatch;
+      };
+   }
+}
+
+#endif
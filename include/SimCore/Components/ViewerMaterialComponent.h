@@ -30,6 +30,9 @@
 
 #include <SimCore/Actors/ViewerMaterialActor.h>
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace dtGame
@@ -43,6 +46,10 @@ namespace SimCore
 {
    namespace Components
    {
+      /**
+       * Keeps the surface materials, indexed by name and by FID code in hash tables, since they are
+       * looked up for every detonation and physics contact.
+       */
       class SIMCORE_EXPORT ViewerMaterialComponent : public dtGame::GMComponent
       {
          friend class SimCore::Actors::ViewerMaterialActor;
@@ -51,6 +58,21 @@ namespace SimCore
          static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
          static const dtUtil::RefString DEFAULT_NAME;
 
+         /**
+          * A handle to a material that callers doing many lookups can keep instead of the name.
+          * It stays valid until the materials are removed on a map change.
+          */
+         struct SIMCORE_EXPORT MaterialHandle
+         {
+            MaterialHandle();
+
+            bool operator==(const MaterialHandle& other) const;
+            bool operator!=(const MaterialHandle& other) const;
+
+            unsigned mIndex;
+            unsigned mGeneration;
+         };
+
          /// Constructor
          ViewerMaterialComponent(dtCore::SystemComponentType& type = *TYPE);
 
@@ -71,6 +93,19 @@ namespace SimCore
          //////////////////////////////////////////////////////////////////////////////////////
          SimCore::Actors::ViewerMaterialActor& CreateOrChangeMaterialByFID(const unsigned int fidIDToMakeWith);
 
+         /// @return a handle to the material, or an invalid handle if there is no material with the name.
+         MaterialHandle FindMaterialHandle(const std::string& materialName);
+         /// @return a handle to the material of the FID code, or an invalid handle if there is none.
+         MaterialHandle FindMaterialHandleByFID(const unsigned int fidIDToCheckWith);
+
+         /// @return true if the handle still refers to a material.
+         bool IsValidHandle(const MaterialHandle& handle) const;
+
+         /// @return the material of the handle, or the default material if the handle isn't valid.
+         const SimCore::Actors::ViewerMaterialActor& GetConstMaterial(const MaterialHandle& handle);
+
+         unsigned GetNumMaterials() const;
+
       protected:
          /// Destructor
          virtual ~ViewerMaterialComponent(void);
@@ -89,21 +124,41 @@ namespace SimCore
          const std::string FID_ID_ToString(const unsigned int nID);
 
          // called from an actor - ie from stage.
-         void RegisterAMaterialWithComponent(SimCore::Actors::ViewerMaterialActor* material)
-         {
-            std::vector<dtCore::RefPtr<SimCore::Actors::ViewerMaterialActor> >::iterator iter =  mOurMaterials.begin();
-            for(;iter != mOurMaterials.end(); ++iter)
-            {
-               if((*iter)->GetName() == material->GetName())
-               {
-                  return;
-               }
-            }
-            mOurMaterials.push_back(material);
-         }
+         void RegisterAMaterialWithComponent(SimCore::Actors::ViewerMaterialActor* material);
+
+         // called from an actor when its name changes.
+         void OnMaterialRenamed(SimCore::Actors::ViewerMaterialActor& material);
 
       private:
+         /// @return the index of the material in mOurMaterials, or NOT_FOUND.
+         unsigned FindMaterialIndex(const std::string& materialName);
+         unsigned FindMaterialIndexByFID(unsigned fid);
+         void AddMaterial(SimCore::Actors::ViewerMaterialActor& material);
+         void RebuildNameIndex();
+         /// @return the default material, which is made if it doesn't exist yet.
+         const SimCore::Actors::ViewerMaterialActor& GetDefaultMaterial();
+
+         /**
+          * The material of an FID code and the name it had, so a renamed material isn't returned for the code.
+          * Codes without a material are kept too, with an index of NOT_FOUND, so the misses don't search again.
+          * All the entries are cleared when a material is added or renamed.
+          */
+         struct FIDEntry
+         {
+            unsigned mIndex;
+            std::string mName;
+         };
+
+         typedef std::unordered_map<std::string, unsigned> NameIndex;
+         typedef std::unordered_map<unsigned, FIDEntry> FIDIndex;
+
          std::vector<dtCore::RefPtr<SimCore::Actors::ViewerMaterialActor> >  mOurMaterials;
+         NameIndex                                          mNameIndex;
+         FIDIndex                                           mFIDIndex;
+         // The FID codes already warned about not having a material.
+         std::unordered_set<unsigned>                       mWarnedFIDs;
+         // Changed when the materials are removed, so old handles become invalid.
+         unsigned                                           mGeneration;
          bool                                               mClearMaterialsOnMapChange;
       };
    }
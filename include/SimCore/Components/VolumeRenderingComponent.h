@@ -45,6 +45,8 @@ namespace SimCore
 {
    namespace Components
    {
+      class VolumePointTask;
+
       /**
        * The volume rendering component allows the user to create simple shapes (sphere, box, etc.) using the internal ShapeVolumeRecord class
        * which simulate volumes of fog or clouds (or by overriding the shader any sort of volume) by randomly placing particles within the volume
@@ -72,6 +74,9 @@ namespace SimCore
        *     vrc->CreateShapeVolume(svr);
        *   }
        *
+       * The particle positions of a new volume are generated on a thread pool thread from the volume's random seed,
+       * so the same seed always gives the same volume.  The volume is added to the scene once its positions are ready,
+       * normally on the next tick.
        */
 
       class SIMCORE_EXPORT VolumeRenderingComponent : public dtGame::GMComponent
@@ -117,8 +122,18 @@ namespace SimCore
             ParticleVolumeDrawable();
             ParticleVolumeDrawable(const ParticleVolumeDrawable& bd, const osg::CopyOp& copyop = osg::CopyOp::SHALLOW_COPY);         
 
+            //sets up the billboards and fills the volume with points generated from the record's random seed
             void Init(unsigned mNumParticles, ShapeVolumeRecord* svr);
 
+            //sets up the billboards only, the points are set afterward with SetPoints
+            void InitBillboards(unsigned numParticles, ShapeVolumeRecord* svr);
+            void SetPoints(const PointList& points);
+
+            //fills the list with random points in the shape, the points only depend on the arguments so the same
+            //seed always gives the same points, and it is safe to call from any thread
+            static void CreateRandomPointsInVolume(Shape s, unsigned numPoints, const osg::Vec3& center, const osg::Vec3& radius,
+                     unsigned seed, PointList& pointArrayToFill);
+
             const osg::Vec4& GetPointLocation(unsigned i) const;
             void SetPointLocation(unsigned i, const osg::Vec4& newOffset);
 
@@ -141,7 +156,6 @@ namespace SimCore
 
          private:
             void CreateBillboards(unsigned numParticles, float width, float height);
-            void CreateRandomPointsInVolume(Shape s, float numPoints, const osg::Vec3& center, const osg::Vec3& radius, PointList& pointArrayToFill);
 
             float mParticleRadius;
             unsigned mNumParticles;
@@ -256,9 +270,19 @@ namespace SimCore
             //this is created for you by the component
             dtCore::RefPtr<ParticleVolumeDrawable> mParticleDrawable;
 
+            //the seed for the random particle positions, the same seed always gives the same positions
+            //if this is left at 0 a seed is made from the id
+            unsigned mRandomSeed;
+
+            //the squared distance from the camera at the last update, this is used internally to sort the volumes
+            float mCameraDistanceSqr;
+
             //use this to get the static counted id
             ShapeRecordId GetId() const;
 
+            //returns the seed used for the particle positions
+            unsigned GetRandomSeed() const;
+
             private:
                //this is the id used to look up the volumes, alternatively one can hold onto a ref or observer pointer
                ShapeRecordId mId;
@@ -271,6 +295,23 @@ namespace SimCore
          //ShapeVolumeArray
          typedef std::vector<dtCore::RefPtr<ShapeVolumeRecord> > ShapeVolumeArray;
 
+         //////////////////////////////////////////////////////////////////////////
+         //TimingStats, totals since the component was created or ResetTimingStats was called
+         struct SIMCORE_EXPORT TimingStats
+         {
+            TimingStats();
+
+            unsigned mNumVolumesCreated;
+            //the time spent in CreateShapeVolume on the calling thread
+            double mCreateMillis;
+            //the time spent generating particle positions, mostly on worker threads
+            double mPointGenerationMillis;
+            unsigned mNumUpdates;
+            //the time spent updating the volumes each tick
+            double mUpdateMillis;
+            double mLastUpdateMillis;
+         };
+
          public:
 
          /// Constructor
@@ -320,6 +361,26 @@ namespace SimCore
 
          //an internal function made public for unit testing
          void TimeoutAndDeleteVolumes(float dt);
+
+         //an internal function made public for unit testing, moves the volumes with their targets and sorts them nearest first
+         void TransformAndSortVolumes();
+
+         //returns the volumes, sorted nearest to the camera first as of the last update
+         const ShapeVolumeArray& GetVolumes() const;
+
+         //when true, the default, the particle positions of new volumes are generated on the thread pool
+         void SetGeneratePointsInBackground(bool background);
+         bool GetGeneratePointsInBackground() const;
+
+         //returns the number of volumes waiting on their particle positions
+         unsigned GetNumPendingVolumes() const;
+         bool IsVolumePending(ShapeRecordId id) const;
+
+         //blocks until all the pending volumes have their particle positions and adds them to the scene
+         void WaitForPendingVolumes();
+
+         const TimingStats& GetTimingStats() const;
+         void ResetTimingStats();
       protected:
 
          /// Destructor
@@ -329,9 +390,13 @@ namespace SimCore
          void UpdateVolumes(float dt);
          ShapeVolumeRecord* FindVolume(ShapeRecordId id);
 
-         void TransformAndSortVolumes();
+         void SortVolumes();
          void SetPosition(ShapeVolumeRecord* dl);
 
+         //adds the pending volumes whose particle positions are ready to the scene
+         void CollectFinishedVolumes(bool wait);
+         void FinishParticleVolume(ShapeVolumeRecord& svr, const ParticleVolumeDrawable::PointList& points);
+
          void CreateDrawable(ShapeVolumeRecord& newShape);
          void RemoveDrawable(ShapeVolumeRecord& svr);
          void CreateSimpleShape(ShapeVolumeRecord& newShape);
@@ -361,7 +426,18 @@ namespace SimCore
          dtCore::RefPtr<osg::Uniform> mNoiseTextureUniform;
 
          ShapeVolumeArray mVolumes;
+         //the number of volumes at the front of mVolumes that were sorted on the last update
+         unsigned mNumSortedVolumes;
+
+         struct PendingVolume
+         {
+            dtCore::ObserverPtr<ShapeVolumeRecord> mVolume;
+            dtCore::RefPtr<VolumePointTask> mTask;
+         };
+         std::vector<PendingVolume> mPendingVolumes;
+         bool mGeneratePointsInBackground;
 
+         TimingStats mTimingStats;
       };
    }// namespace Components
 }//namespace SimCore
@@ -33,6 +33,7 @@
 #include <dtCore/observerptr.h>
 #include <dtUtil/refstring.h>
 #include <SimCore/Actors/VolumetricLine.h>
+#include <vector>
 
 
 
@@ -468,9 +469,39 @@ namespace SimCore
             // Clear all weapon and tracer effects
             void Clear();
 
+            // The most line segments tested by one update of the isector.
+            static const unsigned MAX_IMPACT_QUERIES_PER_UPDATE;
+
+            // A shot line to test for the time until the shot hits something.
+            struct SIMCORE_EXPORT ImpactQuery
+            {
+               ImpactQuery();
+
+               osg::Vec3 mFirePoint;
+               osg::Vec3 mVelocity;
+               float mMaxTime;
+               // The node of the entity that fired the shot. Hits on its own geometry are ignored.
+               dtCore::ObserverPtr<osg::Node> mOwnerNode;
+               // The result, which is mMaxTime if nothing was hit.
+               float mTimeToImpact;
+            };
+            typedef std::vector<ImpactQuery> ImpactQueryList;
+
             float CalcTimeToImpact( const osg::Vec3& weaponFirePoint, const osg::Vec3& initialVelocity,
                float maxTime = 10.0f, SimCore::Actors::BaseEntity* owner = NULL );
 
+            // Find the time to impact of many shots with as few scene traversals as possible.
+            // Each query's mTimeToImpact is set to the time until its shot line hits
+            // something other than its owner.
+            void CalcTimesToImpact( ImpactQueryList& queries );
+
+            // Tracers started by ApplyMunitionEffect fly for their full life time until
+            // the next Update, which finds the time to impact of all of them in one batch.
+            unsigned GetNumPendingImpactQueries() const;
+
+            // Find the time to impact of the tracers started since the last Update and shorten their life times.
+            void ResolvePendingImpactQueries();
+
          protected:
            virtual ~WeaponEffectsManager();
 
@@ -490,6 +521,10 @@ namespace SimCore
             typedef std::vector<dtCore::RefPtr<MunitionEffectRequest> > MunitionEffectRequestList;
             MunitionEffectRequestList mTracerRequests;
             MunitionEffectRequestList mTracerRequestsDeletable;
+
+            // Tracers waiting on their time to impact, and their shot lines.
+            MunitionEffectArray mPendingImpactEffects;
+            ImpactQueryList mPendingImpactQueries;
       };
 
    }
@@ -0,0 +1,108 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef _WEAPON_EVENT_AGGREGATOR_COMPONENT_H_
+#define _WEAPON_EVENT_AGGREGATOR_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <SimCore/Messages.h>
+#include <dtGame/gmcomponent.h>
+#include <dtUtil/getsetmacros.h>
+#include <vector>
+
+namespace SimCore
+{
+   namespace Components
+   {
+
+      /**
+       * @class WeaponEventAggregatorComponent
+       * @brief Collects the shot fired and detonation events from weapons and sends them
+       * once per frame in a single WeaponEventBatchMessage, both locally and to the network.
+       * Weapon actors use this component instead of sending their own messages when it
+       * has been added to the game manager.
+       *
+       * NOTE: The batch message has no HLA mapping, so don't add this component to
+       * applications that must publish individual weapon fire and detonation interactions.
+       */
+      class SIMCORE_EXPORT WeaponEventAggregatorComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const unsigned DEFAULT_MAX_EVENTS_PER_BATCH = 512;
+
+         WeaponEventAggregatorComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// Sets whether batches are sent to the network as well as locally.  It defaults to true.
+         DT_DECLARE_ACCESSOR(bool, SendToNetwork);
+
+         /**
+          * A batch is sent early if this many events are queued before the end of the frame.
+          * It is clamped to WeaponEventBatchMessage::MAX_EVENTS.
+          */
+         DT_DECLARE_ACCESSOR(unsigned, MaxEventsPerBatch);
+
+         /// Queues an event to go out with the next batch.
+         void QueueEvent( const WeaponEvent& weaponEvent );
+
+         unsigned GetNumQueuedEvents() const;
+
+         /// Sends all queued events as one batch message.  This happens at the end of every frame.
+         void Flush();
+
+         /// Drops the queued events without sending them.
+         void ClearQueue();
+
+         /// @return the number of events sent in batches.
+         unsigned GetNumEventsSent() const;
+
+         /// @return the number of batch messages sent.
+         unsigned GetNumBatchesSent() const;
+
+         /**
+          * @return the number of messages not sent because events were batched.  Each event
+          * would have been sent once locally and, if sending to the network, once to the network.
+          */
+         unsigned GetNumMessagesSaved() const;
+
+         void ResetStatistics();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~WeaponEventAggregatorComponent();
+
+      private:
+         std::vector<WeaponEvent> mQueuedEvents;
+         unsigned mNumEventsSent;
+         unsigned mNumBatchesSent;
+         unsigned mNumMessagesSaved;
+      };
+   }
+}
+
+#endif
@@ -72,6 +72,8 @@ namespace SimCore
 
    namespace Components
    {
+      class FrameBudgetJob;
+
       /**
        * @class WeatherComponent
        * @brief component used to handle all weather changes in the application.
@@ -97,6 +99,8 @@ namespace SimCore
          //creates our day time actor
          /*virtual*/ void OnAddedToGM();
 
+         virtual void OnRemovedFromGM();
+
          // Set the main environmental actor responsible for all environment rendering
          void SetEphemerisEnvironment( SimCore::Actors::IGEnvironmentActor* env );
 
@@ -231,7 +235,15 @@ namespace SimCore
           */
          void AssignNewProxy(const dtCore::UniqueId &id);
 
+         /**
+          * Marks the weather or the time of day to be updated.  With a FrameBudgetComponent, the update is a job
+          * that may wait a few frames, so a burst of updates from the network is applied once.  Otherwise it runs now.
+          */
+         void RequestUpdate(bool weather, bool dayTime);
+
       private:
+         /// The work of the frame budget job.
+         void RunRequestedUpdates();
 
          typedef std::vector<dtCore::RefPtr<dtAudio::Sound> > SoundArray;
          bool RemoveSoundFromArray(dtAudio::Sound&, SoundArray&);
@@ -252,6 +264,9 @@ namespace SimCore
          double mMaxVisibility;
          double mMaxElevationVis;
          bool   mUpdatesEnabled;
+         bool   mWeatherRequested;
+         bool   mDayTimeRequested;
+         dtCore::RefPtr<FrameBudgetJob> mUpdateJob;
 
          SimCore::Actors::PrecipitationType* mCurrentPrecipType;
 
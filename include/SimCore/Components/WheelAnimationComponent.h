@@ -0,0 +1,140 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _WHEEL_ANIMATION_COMPONENT_H_
+#define _WHEEL_ANIMATION_COMPONENT_H_
+
+#include <SimCore/Export.h>
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/Vec3>
+#include <vector>
+
+namespace dtCore
+{
+   class Transformable;
+}
+
+namespace dtGame
+{
+   class DeadReckoningActorComponent;
+}
+
+namespace SimCore
+{
+   namespace ActComps
+   {
+      class Axle;
+      class WheelActComp;
+   }
+
+   namespace Components
+   {
+      /**
+       * @class WheelAnimationComponent
+       * @brief Turns the wheels of all the registered vehicles in one pass each remote tick.
+       *
+       * A WheelActComp that needs updating registers itself here in OnEnteredWorld instead of
+       * registering its own tick invokable.  The axles of all the vehicles are kept in one array,
+       * and each vehicle's speed and heading come from its dead reckoning component.
+       *
+       * Vehicles farther from the camera than the LOD distance only update every LOD update interval,
+       * turning their wheels by the whole time since their last update.  Vehicles beyond the max
+       * distance aren't animated at all.
+       */
+      class SIMCORE_EXPORT WheelAnimationComponent : public dtGame::GMComponent
+      {
+      public:
+         typedef dtGame::GMComponent BaseClass;
+
+         static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+         // The default component name, used when looking it up on the GM.
+         static const std::string DEFAULT_NAME;
+
+         static const float DEFAULT_LOD_DISTANCE;
+         static const float DEFAULT_LOD_UPDATE_INTERVAL;
+         static const float DEFAULT_MAX_DISTANCE;
+
+         WheelAnimationComponent( dtCore::SystemComponentType& type = *TYPE );
+
+         /// Vehicles farther than this from the camera update less often.  Defaults to 300 meters.
+         DT_DECLARE_ACCESSOR(float, LodDistance);
+
+         /// The time between updates of the vehicles past the LOD distance.  Defaults to 0.25 seconds.
+         DT_DECLARE_ACCESSOR(float, LodUpdateInterval);
+
+         /// Vehicles farther than this from the camera aren't animated.  Zero or less means no limit.  Defaults to 2000 meters.
+         DT_DECLARE_ACCESSOR(float, MaxDistance);
+
+         /// Adds the vehicle.  Registering it again does nothing.
+         void RegisterWheels(SimCore::ActComps::WheelActComp& wheels);
+         void UnregisterWheels(SimCore::ActComps::WheelActComp& wheels);
+         bool IsRegistered(const SimCore::ActComps::WheelActComp& wheels) const;
+
+         unsigned GetNumVehicles() const;
+
+         /// @return the number of axles in the array, which is rebuilt when the vehicles or their axles change.
+         unsigned GetNumAxles() const;
+
+         /// @return the number of vehicles that were updated by the last call to UpdateWheels.
+         unsigned GetNumUpdatedVehicles() const;
+
+         /// Turns the wheels for a tick of the given length, choosing the LOD by the distance from the view position.
+         void UpdateWheels(float dt, const osg::Vec3& viewPosition);
+
+         virtual void OnRemovedFromGM();
+
+         virtual void ProcessMessage( const dtGame::Message& message );
+
+      protected:
+         virtual ~WheelAnimationComponent();
+
+      private:
+         struct VehicleEntry
+         {
+            VehicleEntry();
+
+            dtCore::ObserverPtr<SimCore::ActComps::WheelActComp> mWheels;
+            dtCore::ObserverPtr<dtCore::Transformable> mTransformable;
+            dtCore::ObserverPtr<dtGame::DeadReckoningActorComponent> mDeadReckoning;
+            unsigned mFirstAxle;
+            unsigned mNumAxles;
+            // The time since the vehicle was last updated.
+            float mPendingTime;
+            // Set while past the max distance, so the heading is reset when it is updated again.
+            bool mBeyondMaxDistance;
+         };
+
+         /// Drops deleted vehicles and rebuilds the axle array if any vehicle's axles changed.
+         void RefreshAxles();
+
+         std::vector<VehicleEntry> mVehicles;
+         std::vector<dtCore::RefPtr<SimCore::ActComps::Axle> > mAxles;
+         bool mAxlesDirty;
+         unsigned mNumUpdatedVehicles;
+      };
+   }
+}
+
+#endif
@@ -54,6 +54,7 @@ namespace SimCore
          static void SetTerrainNode(osg::Transform* terrainNodeCheckAgainst){mTerrainNode = terrainNodeCheckAgainst;}
          static osg::Transform* GetTerrainNode() {return mTerrainNode.get();}
 
+         /// The FID codes of the geodes not to draw.  These are kept in FIDCodeIndex::GetInstance().
          static const std::vector<int>& GetDisabledFIDCodes();
          static void SetDisabledFIDCodes(const std::vector<int>& fidCodeArray);
          
@@ -68,8 +69,6 @@ namespace SimCore
          /// we are in the terrain
          static dtCore::ObserverPtr<osg::Transform>             mTerrainNode;
 
-         static std::vector<int>                                mFIDCodes;
-         
          /// are we in the terrain currently? mNodeWeCheckAgainst passed, so work 
          /// is being done this frame
          bool                                            mCurrentlyInTerrain;
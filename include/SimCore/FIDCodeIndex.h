@@ -0,0 +1,153 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef SIMCORE_FID_CODE_INDEX_H
+#define SIMCORE_FID_CODE_INDEX_H
+
+#include <SimCore/Export.h>
+#include <dtCore/observerptr.h>
+#include <osg/Referenced>
+
+#include <map>
+#include <vector>
+
+namespace osg
+{
+   class Drawable;
+   class Geode;
+   class Node;
+}
+
+namespace SimCore
+{
+   /**
+    * Resolves the FID (feature identification) codes of terrain geodes once, when the terrain
+    * is loaded, so they don't have to be looked up on every cull.  Each distinct code gets a
+    * compact feature class index, and each geode is tagged with the classes of its drawables.
+    * The disabled codes are kept as a bitset over the classes.  Changing them only updates the
+    * geodes of the classes that changed.
+    *
+    * The FID code of a drawable is the first value of the osg::IntArray set as the user data of its
+    * state set, which is where the OpenFlight loader puts the feature codes.
+    */
+   class SIMCORE_EXPORT FIDCodeIndex
+   {
+      public:
+         /// The class of a code that isn't in the index.
+         static const unsigned NO_CLASS;
+
+         /**
+          * The compiled codes of a geode, set as the user data of the geode.
+          */
+         class SIMCORE_EXPORT GeodeInfo : public osg::Referenced
+         {
+            public:
+               GeodeInfo();
+
+               /// The classes of the coded drawables, without duplicates.
+               std::vector<unsigned> mClasses;
+               /// true if a drawable has a state set but no FID code, which means the geode is always drawn.
+               bool mHasUncoded;
+               /// true if the geode should not be drawn.  Kept current with the disabled codes.
+               bool mCulled;
+
+            protected:
+               virtual ~GeodeInfo();
+         };
+
+         /// @return the index shared by the CustomCullVisitor and the terrain.
+         static FIDCodeIndex& GetInstance();
+
+         FIDCodeIndex();
+         ~FIDCodeIndex();
+
+         /**
+          * Reads the FID code of a drawable.
+          * @return false if the drawable has no code.
+          */
+         static bool ReadFIDCode(const osg::Drawable& drawable, int& fidCode);
+
+         /**
+          * Tags every geode under the node with its feature classes.  A geode with user data
+          * of another type is left alone, and ShouldDraw looks up its codes the slow way.
+          * Geodes that have been deleted or compiled again since the last call are dropped from the index.
+          * @return the number of geodes tagged.
+          */
+         unsigned Compile(osg::Node& node);
+
+         /**
+          * Untags every geode under the node and drops them from the index.  Call it when the node is unloaded.
+          * @return the number of geodes untagged.
+          */
+         unsigned Remove(osg::Node& node);
+
+         /// @return the info compiled onto the geode, or NULL if it hasn't been compiled.
+         static GeodeInfo* GetGeodeInfo(const osg::Geode& geode);
+
+         /// @return the class of the code, or NO_CLASS if it isn't in the index.
+         unsigned FindClass(int fidCode) const;
+         unsigned GetOrAddClass(int fidCode);
+         unsigned GetNumClasses() const;
+         int GetFIDCode(unsigned classIndex) const;
+
+         /// Sets the codes of the geodes that should not be drawn.
+         void SetDisabledCodes(const std::vector<int>& fidCodes);
+         const std::vector<int>& GetDisabledCodes() const;
+
+         bool IsClassDisabled(unsigned classIndex) const;
+         bool IsCodeDisabled(int fidCode) const;
+
+         /// @return true if the geode should be drawn with the current disabled codes.
+         bool ShouldDraw(const osg::Geode& geode) const;
+
+         /// @return the number of geodes updated by the last call to SetDisabledCodes.
+         unsigned GetNumGeodesUpdated() const;
+
+         /// @return the number of geodes in the lists of all the classes, so a geode with two classes counts twice.
+         unsigned GetNumIndexedGeodes() const;
+
+         /// Forgets the classes and the geodes.  The geodes keep their tags, which are no longer valid.
+         void Clear();
+
+      private:
+         FIDCodeIndex(const FIDCodeIndex&);
+         FIDCodeIndex& operator=(const FIDCodeIndex&);
+
+         bool IsCulled(const GeodeInfo& info) const;
+
+         /// Drops the geodes that have been deleted, untagged or compiled again.
+         void PruneGeodes();
+
+         typedef std::map<int, unsigned> ClassMap;
+         typedef std::vector<dtCore::ObserverPtr<GeodeInfo> > GeodeList;
+
+         ClassMap mClassMap;
+         std::vector<int> mClassCodes;
+         std::vector<bool> mDisabledClasses;
+         // The tagged geodes of each class, so only the affected ones are updated.
+         std::vector<GeodeList> mClassGeodes;
+         std::vector<int> mDisabledCodes;
+         unsigned mNumGeodesUpdated;
+   };
+}
+
+#endif
@@ -0,0 +1,228 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _FRAME_PROFILER_H_
+#define _FRAME_PROFILER_H_
+
+#include <SimCore/Export.h>
+
+#include <OpenThreads/Mutex>
+#include <osg/Timer>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace SimCore
+{
+   /**
+    * Times the per-frame hot paths of the components and counts things like messages handled,
+    * so the cost of a frame can be broken down.  Code marks a zone with SIMCORE_PROFILE_SCOPE or
+    * SIMCORE_PROFILE_COUNT.  Each thread records into its own ring buffer, and Collect, called once
+    * a frame on the main thread, drains the buffers into per-zone stats and, if tracing is on, into
+    * events that can be written as a Chrome trace file, the same as the StartupTracer.
+    *
+    * Nothing is recorded while the profiler is disabled, and a disabled zone costs a check of a
+    * static bool.  The ProfilerComponent enables it, collects each frame and sends the stats
+    * to the game manager.
+    */
+   class SIMCORE_EXPORT FrameProfiler
+   {
+      public:
+         typedef unsigned ZoneId;
+
+         static const ZoneId INVALID_ZONE;
+         static const std::string DEFAULT_CATEGORY;
+
+         /// The number of records each thread can hold between collections.  More are dropped.
+         static const unsigned BUFFER_CAPACITY = 8192;
+
+         /// The default limit on the events kept for the trace, so a long run doesn't use up the memory.
+         static const unsigned DEFAULT_MAX_TRACE_EVENTS = 1000000;
+
+         struct SIMCORE_EXPORT ZoneStats
+         {
+            ZoneStats();
+
+            unsigned mNumCalls;
+            double mTotalMillis;
+            double mMaxMillis;
+            long long mCount;
+         };
+
+         static FrameProfiler& GetInstance();
+
+         /// Cheap enough to check in any hot path.
+         static bool IsEnabled() { return mEnabled; }
+         void SetEnabled(bool enabled);
+
+         /**
+          * @return the id of the zone with the name, registering it if it is new.  This locks, so
+          * look up the id once, which the macros do with a function static.
+          */
+         ZoneId RegisterZone(const std::string& name, const std::string& category = DEFAULT_CATEGORY);
+
+         /// @return the id of the zone, or INVALID_ZONE if it hasn't been registered.
+         ZoneId FindZone(const std::string& name) const;
+
+         unsigned GetNumZones() const;
+         const std::string& GetZoneName(ZoneId zone) const;
+
+         /// Records a timed run of a zone on the calling thread.
+         void RecordTime(ZoneId zone, osg::Timer_t startTick, osg::Timer_t endTick);
+
+         /// Adds to the count of a zone on the calling thread.
+         void RecordCount(ZoneId zone, long long value);
+
+         /// Drains the thread buffers into the stats and the trace.  Call it once a frame on the main thread.
+         void Collect();
+
+         /// @return the stats of the zone since they were last reset.  Only includes what has been collected.
+         ZoneStats GetZoneStats(ZoneId zone) const;
+         void ResetStats();
+
+         /// Writes a line for each zone that was used since the stats were reset.
+         void WriteStats(std::ostream& stream) const;
+
+         /// @return the number of records lost because a thread buffer was full.
+         unsigned GetNumDroppedRecords() const;
+
+         /// Set to keep the collected records as trace events.  Off by default.
+         void SetTraceEnabled(bool enabled);
+         bool IsTraceEnabled() const;
+
+         void SetMaxTraceEvents(unsigned maxEvents);
+         unsigned GetMaxTraceEvents() const;
+
+         unsigned GetNumTraceEvents() const;
+         void ClearTrace();
+
+         /// Writes the trace events as a Chrome trace json object.  Counts are written as counter events.
+         void WriteChromeTrace(std::ostream& stream) const;
+
+         /// Writes the trace to the file.  @return false if the file could not be written.
+         bool WriteChromeTrace(const std::string& fileName) const;
+
+         /**
+          * Records the time from its construction to its destruction in a zone.
+          */
+         class SIMCORE_EXPORT ScopedTimer
+         {
+            public:
+               ScopedTimer(ZoneId zone)
+               : mZone(INVALID_ZONE)
+               , mStartTick(0)
+               {
+                  if (FrameProfiler::IsEnabled())
+                  {
+                     mZone = zone;
+                     mStartTick = osg::Timer::instance()->tick();
+                  }
+               }
+
+               ~ScopedTimer()
+               {
+                  if (mZone != INVALID_ZONE)
+                  {
+                     FrameProfiler::GetInstance().RecordTime(mZone, mStartTick, osg::Timer::instance()->tick());
+                  }
+               }
+
+            private:
+               // Not implemented.
+               ScopedTimer(const ScopedTimer&);
+               ScopedTimer& operator=(const ScopedTimer&);
+
+               ZoneId mZone;
+               osg::Timer_t mStartTick;
+         };
+
+      private:
+         FrameProfiler();
+         ~FrameProfiler();
+
+         struct Zone
+         {
+            std::string mName;
+            std::string mCategory;
+            ZoneStats mStats;
+         };
+
+         struct Record
+         {
+            ZoneId mZone;
+            bool mIsCount;
+            osg::Timer_t mStartTick;
+            // The end tick of a time, or the value of a count.
+            long long mValue;
+         };
+
+         struct TraceEvent
+         {
+            ZoneId mZone;
+            bool mIsCount;
+            unsigned mThreadIndex;
+            double mStartMicros;
+            // The duration of a time in microseconds, or the value of a count.
+            double mValue;
+         };
+
+         class ThreadBuffer;
+
+         ThreadBuffer& GetThreadBuffer();
+         void AddRecord(const Record& record);
+
+         static bool mEnabled;
+
+         mutable OpenThreads::Mutex mMutex;
+         std::vector<Zone> mZones;
+         std::vector<ThreadBuffer*> mBuffers;
+         std::vector<Record> mCollectList;
+         std::vector<TraceEvent> mTraceEvents;
+         osg::Timer_t mStartTick;
+         unsigned mMaxTraceEvents;
+         bool mTraceEnabled;
+   };
+}
+
+#define SIMCORE_PROFILE_JOIN_IMPL(a, b) a##b
+#define SIMCORE_PROFILE_JOIN(a, b) SIMCORE_PROFILE_JOIN_IMPL(a, b)
+
+/**
+ * Times the rest of the enclosing scope in the named zone.  The name must be a constant,
+ * since the zone is registered once per call site.
+ */
+#define SIMCORE_PROFILE_SCOPE(name) \
+   static const SimCore::FrameProfiler::ZoneId SIMCORE_PROFILE_JOIN(simCoreProfileZone, __LINE__) = \
+      SimCore::FrameProfiler::GetInstance().RegisterZone(name); \
+   SimCore::FrameProfiler::ScopedTimer SIMCORE_PROFILE_JOIN(simCoreProfileTimer, __LINE__)(SIMCORE_PROFILE_JOIN(simCoreProfileZone, __LINE__))
+
+/// Adds value to the count of the named zone.
+#define SIMCORE_PROFILE_COUNT(name, value) \
+   if (SimCore::FrameProfiler::IsEnabled()) \
+   { \
+      static const SimCore::FrameProfiler::ZoneId SIMCORE_PROFILE_JOIN(simCoreProfileZone, __LINE__) = \
+         SimCore::FrameProfiler::GetInstance().RegisterZone(name); \
+      SimCore::FrameProfiler::GetInstance().RecordCount(SIMCORE_PROFILE_JOIN(simCoreProfileZone, __LINE__), (value)); \
+   } else (void)0
+
+#endif
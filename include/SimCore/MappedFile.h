@@ -0,0 +1,82 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _SIMCORE_MAPPED_FILE_H_
+#define _SIMCORE_MAPPED_FILE_H_
+
+#include <SimCore/Export.h>
+
+#include <osg/Referenced>
+
+#include <cstddef>
+#include <string>
+
+namespace SimCore
+{
+   /**
+    * A read only memory mapping of a whole file, so large data files can be used
+    * in place without reading them into memory first.  Pages are loaded by the
+    * operating system as they are touched.  The mapping stays open until Close is
+    * called or the object is deleted, so anything pointing into the data should
+    * hold a reference to it.
+    */
+   class SIMCORE_EXPORT MappedFile : public osg::Referenced
+   {
+      public:
+         MappedFile();
+
+         /// Maps the file, closing any file that was already open.  @return false if it could not be mapped.
+         bool Open(const std::string& fileName);
+
+         void Close();
+
+         bool IsOpen() const;
+
+         const std::string& GetFileName() const;
+
+         /// @return the start of the file data, or NULL if no file is open or the file is empty.
+         const char* GetData() const;
+
+         size_t GetSize() const;
+
+      protected:
+         virtual ~MappedFile();
+
+      private:
+         // Not copyable.
+         MappedFile(const MappedFile&);
+         MappedFile& operator=(const MappedFile&);
+
+         std::string mFileName;
+         const char* mData;
+         size_t mSize;
+         bool mOpen;
+#ifdef DELTA_WIN32
+         void* mFileHandle;
+         void* mMappingHandle;
+#else
+         int mFileDescriptor;
+#endif
+   };
+}
+
+#endif
@@ -45,6 +45,7 @@ namespace SimCore
       static const MessageType ATTACH_TO_ACTOR;
       static const MessageType DETONATION;
       static const MessageType SHOT_FIRED;
+      static const MessageType WEAPON_EVENT_BATCH;
 
       ///Marks an update to the Stealth actor field of view.
       static const MessageType STEALTH_ACTOR_FOV;
@@ -60,6 +61,9 @@ namespace SimCore
 
       static const MessageType INFO_TERRAIN_LOADED;
 
+      /// Carries the FrameProfiler stats, see the ProfilerComponent.
+      static const MessageType INFO_PROFILE_STATS;
+
       // These are NON-CONST because they are used in an actor property
       static MessageType BINOCULARS;
       static MessageType COMPASS;
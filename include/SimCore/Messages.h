@@ -26,6 +26,7 @@
 #include <dtGame/message.h>
 #include <dtGame/messagemacros.h>
 #include <SimCore/Export.h>
+#include <vector>
 
 namespace SimCore
 {
@@ -80,6 +81,18 @@ namespace SimCore
       DECLARE_PARAMETER_INLINE(bool, Enabled)
    DT_DECLARE_MESSAGE_END()
 
+   /**
+    * Sent periodically by the ProfilerComponent with the FrameProfiler stats of the period.
+    */
+   DT_DECLARE_MESSAGE_BEGIN(ProfileStatsMessage, dtGame::Message, SIMCORE_EXPORT)
+      /// The real time the stats cover.
+      DECLARE_PARAMETER_INLINE(float, PeriodSeconds)
+      /// The frames in the period.
+      DECLARE_PARAMETER_INLINE(unsigned int, NumFrames)
+      /// The stats as written by FrameProfiler::WriteStats, a line per zone.
+      DECLARE_PARAMETER_INLINE(std::string, Stats)
+   DT_DECLARE_MESSAGE_END()
+
    /**
     * @class AttachToActorMessage
     * @brief message class used when attaching to another actor.
@@ -350,5 +363,76 @@ namespace SimCore
          dtCore::NamedUnsignedShortIntParameter* mDataSize;
          dtCore::NamedStringParameter* mDataParameter;
    };
+
+   /**
+    * One shot fired or detonation, as carried in a WeaponEventBatchMessage.
+    * The fields match the parameters of the ShotFiredMessage and DetonationMessage.
+    */
+   struct SIMCORE_EXPORT WeaponEvent
+   {
+      WeaponEvent();
+
+      /// Copies the fields into a shot fired message, including the sending and about actor ids.
+      void FillShotFiredMessage(ShotFiredMessage& msg) const;
+
+      /// Copies the fields into a detonation message, including the sending and about actor ids.
+      void FillDetonationMessage(DetonationMessage& msg) const;
+
+      bool mIsDetonation;
+      dtCore::UniqueId mSendingActorId;
+      /// The direct fire target.  It is empty for indirect fire.
+      dtCore::UniqueId mTargetId;
+      std::string mMunitionType;
+      unsigned short mEventIdentifier;
+      unsigned short mQuantityFired;
+      unsigned short mRateOfFire;
+      unsigned short mFuseType;
+      unsigned short mWarheadType;
+      /// The firing location, or the detonation location.
+      osg::Vec3 mLocation;
+      /// The initial velocity, or the final velocity.
+      osg::Vec3 mVelocity;
+      /// Only used by detonations that have a target.
+      osg::Vec3 mRelativeDetonationLocation;
+      unsigned char mDetonationResultCode;
+   };
+
+   /**
+    * Carries many weapon events packed into one binary buffer, so that busy weapons
+    * send one message per frame rather than a full message per event.
+    * Actor ids and munition names are only written once per batch.
+    * @see SimCore::Components::WeaponEventAggregatorComponent
+    */
+   class SIMCORE_EXPORT WeaponEventBatchMessage : public dtGame::Message
+   {
+      public:
+         static const std::string PARAM_EVENT_COUNT;
+         static const std::string PARAM_DATA;
+
+         /// The most events that fit in one batch.
+         static const unsigned MAX_EVENTS = 20000;
+
+         /// Constructor
+         WeaponEventBatchMessage();
+
+         unsigned GetEventCount() const;
+
+         /// Packs the events into this message, replacing any it already holds.  There may be no more than MAX_EVENTS.
+         void SetEvents(const std::vector<WeaponEvent>& events);
+
+         /**
+          * Unpacks the events, adding them to the end of the list.
+          * @return false if the data is invalid, in which case nothing is added.
+          */
+         bool GetEvents(std::vector<WeaponEvent>& eventsToFill) const;
+
+      protected:
+         /// Destructor
+         virtual ~WeaponEventBatchMessage();
+
+      private:
+         dtCore::NamedUnsignedIntParameter* mEventCount;
+         dtCore::NamedStringParameter* mData;
+   };
 }
 #endif
@@ -0,0 +1,218 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _STARTUP_PRELOADER_H_
+#define _STARTUP_PRELOADER_H_
+
+#include <SimCore/Export.h>
+
+#include <dtCore/refptr.h>
+#include <dtUtil/threadpool.h>
+
+#include <OpenThreads/Block>
+#include <OpenThreads/Condition>
+#include <OpenThreads/Mutex>
+#include <osg/Referenced>
+
+#include <string>
+#include <vector>
+
+namespace SimCore
+{
+   class StartupPreloader;
+
+   /**
+    * A piece of startup work that can run on the thread pool while the main thread
+    * sets up the game manager.  Subclasses do the work in Run, which must not touch
+    * the game manager, the scene or the project, since those aren't thread safe.
+    * Resolve any resource paths before the task is added.
+    */
+   class SIMCORE_EXPORT StartupPreloadTask : public dtUtil::ThreadPoolTask
+   {
+      public:
+         StartupPreloadTask(const std::string& name);
+
+         const std::string& GetName() const;
+
+         /**
+          * The task won't start until the dependency has finished.  The dependency must be added to
+          * the preloader first, and all the dependencies must be set before this task is added.
+          */
+         void AddDependency(StartupPreloadTask& dependency);
+
+         unsigned GetNumDependencies() const;
+         StartupPreloadTask* GetDependency(unsigned index);
+
+         /// @return true once the task has run.
+         bool IsFinished() const;
+
+         /// Blocks the calling thread until the task has finished.  The preloader must have been started.
+         void WaitUntilFinished();
+
+         /// Traces and runs the task, then starts any tasks that were waiting on it.
+         virtual void operator()();
+
+      protected:
+         virtual ~StartupPreloadTask();
+
+         /// Does the work.  Called on a thread pool thread.
+         virtual void Run() = 0;
+
+      private:
+         friend class StartupPreloader;
+
+         std::string mName;
+         std::vector<dtCore::RefPtr<StartupPreloadTask> > mDependencies;
+         StartupPreloader* mPreloader;
+         OpenThreads::Block mFinishedBlock;
+         // These are guarded by the preloader mutex.
+         bool mQueued;
+         bool mFinished;
+   };
+
+   /**
+    * Runs a set of StartupPreloadTasks on the IO queue of the thread pool.  Each task states
+    * the tasks it depends on, and is only queued once they have all finished, so independent
+    * tasks run concurrently and dependent ones run in order.  Since a task's dependencies
+    * have to be added before it, the dependencies can't form a cycle.
+    */
+   class SIMCORE_EXPORT StartupPreloader : public osg::Referenced
+   {
+      public:
+         StartupPreloader();
+
+         /**
+          * Adds a task.  If the preloader is started and the dependencies of the task have
+          * finished, it is queued right away.
+          * @return false if the task is already in a preloader or one of its dependencies isn't in this one.
+          */
+         bool AddTask(StartupPreloadTask& task);
+
+         StartupPreloadTask* FindTask(const std::string& name);
+
+         unsigned GetNumTasks() const;
+
+         /// Queues the tasks that have no dependencies.  The rest are queued as their dependencies finish.
+         void Start();
+
+         bool IsStarted() const;
+
+         /// @return true if every task has finished.
+         bool IsComplete() const;
+
+         /// Blocks the calling thread until every task has finished.
+         void WaitUntilComplete();
+
+      protected:
+         /// Waits for the running tasks, since they call back into the preloader.
+         virtual ~StartupPreloader();
+
+      private:
+         friend class StartupPreloadTask;
+
+         bool IsReady(const StartupPreloadTask& task) const;
+         void OnTaskFinished(StartupPreloadTask& task);
+         static void QueueTasks(const std::vector<StartupPreloadTask*>& tasks);
+
+         mutable OpenThreads::Mutex mMutex;
+         OpenThreads::Condition mCompleteCondition;
+         std::vector<dtCore::RefPtr<StartupPreloadTask> > mTasks;
+         unsigned mNumFinished;
+         bool mStarted;
+   };
+
+   /**
+    * Loads model files into the osgDB object cache, the same way IGActor::LoadFile does
+    * when it is told to use the cache, so the actors that use them find them already loaded.
+    */
+   class SIMCORE_EXPORT ModelPreloadTask : public StartupPreloadTask
+   {
+      public:
+         ModelPreloadTask(const std::string& name);
+
+         /// Adds the full path of a model file to load.
+         void AddFile(const std::string& fileName);
+         const std::vector<std::string>& GetFiles() const;
+
+         unsigned GetNumLoaded() const;
+
+      protected:
+         virtual ~ModelPreloadTask();
+
+         virtual void Run();
+
+      private:
+         std::vector<std::string> mFiles;
+         unsigned mNumLoaded;
+   };
+
+   /**
+    * Finds the shader source files named in a shader definition file such as Shaders/ShaderDefs.xml.
+    * The ShaderManager reads and compiles the sources on the main thread, so ShaderSourcePreloadTask
+    * reads them ahead of time to take the disk access off the main thread.
+    */
+   class SIMCORE_EXPORT ShaderDefinitionScanTask : public StartupPreloadTask
+   {
+      public:
+         static const std::string DEFAULT_NAME;
+
+         /// @param definitionFile the full path to the shader definition xml.
+         ShaderDefinitionScanTask(const std::string& definitionFile);
+
+         /// The full paths of the source files.  Only valid once the task has finished.
+         const std::vector<std::string>& GetSourceFiles() const;
+
+      protected:
+         virtual ~ShaderDefinitionScanTask();
+
+         virtual void Run();
+
+      private:
+         std::string mDefinitionFile;
+         std::vector<std::string> mSourceFiles;
+   };
+
+   /**
+    * Reads the files found by a ShaderDefinitionScanTask, which it depends on,
+    * so the operating system has them cached when the ShaderManager loads them.
+    */
+   class SIMCORE_EXPORT ShaderSourcePreloadTask : public StartupPreloadTask
+   {
+      public:
+         static const std::string DEFAULT_NAME;
+
+         ShaderSourcePreloadTask(ShaderDefinitionScanTask& scanTask);
+
+         unsigned GetNumBytesRead() const;
+
+      protected:
+         virtual ~ShaderSourcePreloadTask();
+
+         virtual void Run();
+
+      private:
+         dtCore::RefPtr<ShaderDefinitionScanTask> mScanTask;
+         unsigned mNumBytesRead;
+   };
+}
+
+#endif
@@ -0,0 +1,127 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _STARTUP_TRACER_H_
+#define _STARTUP_TRACER_H_
+
+#include <SimCore/Export.h>
+
+#include <OpenThreads/Mutex>
+#include <osg/Timer>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace SimCore
+{
+   /**
+    * Records how long each phase of application startup takes, such as loading the actor registry,
+    * adding the components, loading the map and building the terrain physics.  The phases are
+    * written as a Chrome trace json file that can be opened in chrome://tracing, so phases that
+    * run on the thread pool show up side by side with the main thread.
+    *
+    * Nothing is recorded until the tracer is enabled.  BaseGameEntryPoint enables it with
+    * the --startupTrace command line option or the SimCore.StartupTraceFile config property.
+    * Phases may be recorded from any thread.
+    */
+   class SIMCORE_EXPORT StartupTracer
+   {
+      public:
+         static const std::string DEFAULT_CATEGORY;
+
+         static StartupTracer& GetInstance();
+
+         void SetEnabled(bool enabled);
+         bool IsEnabled() const;
+
+         /// The file WriteOutputFile writes to.
+         void SetOutputFile(const std::string& fileName);
+         const std::string& GetOutputFile() const;
+
+         /// @return the current time, to be passed to RecordPhase.
+         osg::Timer_t Tick() const;
+
+         /// Records a phase that ran on the calling thread.  Does nothing if the tracer is disabled.
+         void RecordPhase(const std::string& name, const std::string& category, osg::Timer_t startTick, osg::Timer_t endTick);
+
+         unsigned GetNumPhases() const;
+
+         /// @return true if a phase with the name has been recorded.
+         bool HasPhase(const std::string& name) const;
+
+         void Clear();
+
+         /// Writes the phases as a Chrome trace json object.
+         void WriteChromeTrace(std::ostream& stream) const;
+
+         /// Writes the phases to the file.  @return false if the file could not be written.
+         bool WriteChromeTrace(const std::string& fileName) const;
+
+         /// Writes the trace to the output file if the tracer is enabled and the file is set.
+         bool WriteOutputFile() const;
+
+         /// Writes the value as a quoted json string, escaping it as needed.
+         static void WriteJsonString(std::ostream& stream, const std::string& value);
+
+         /**
+          * Records the time from its construction to its destruction as a phase.
+          */
+         class SIMCORE_EXPORT Phase
+         {
+            public:
+               Phase(const std::string& name, const std::string& category = DEFAULT_CATEGORY);
+               ~Phase();
+
+            private:
+               // Not implemented.
+               Phase(const Phase&);
+               Phase& operator=(const Phase&);
+
+               std::string mName;
+               std::string mCategory;
+               osg::Timer_t mStartTick;
+               bool mEnabled;
+         };
+
+      private:
+         StartupTracer();
+         ~StartupTracer();
+
+         struct Event
+         {
+            std::string mName;
+            std::string mCategory;
+            int mThreadId;
+            double mStartMicros;
+            double mDurationMicros;
+         };
+
+         mutable OpenThreads::Mutex mMutex;
+         std::vector<Event> mEvents;
+         osg::Timer_t mStartTick;
+         bool mEnabled;
+         std::string mOutputFile;
+   };
+}
+
+#endif
@@ -0,0 +1,193 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#ifndef _SIMCORE_TERRAIN_ELEVATION_RASTER_H_
+#define _SIMCORE_TERRAIN_ELEVATION_RASTER_H_
+
+#include <SimCore/Export.h>
+#include <dtCore/observerptr.h>
+#include <dtUtil/getsetmacros.h>
+#include <osg/BoundingBox>
+#include <osg/Node>
+#include <osg/Referenced>
+#include <osg/Vec3>
+#include <string>
+#include <vector>
+
+namespace dtUtil
+{
+   class DataStream;
+}
+
+namespace SimCore
+{
+   /**
+    * A grid of the terrain heights sampled from the terrain geometry, so the height and normal of open
+    * ground can be looked up without intersecting the scene.  The area of the terrain is split into square
+    * tiles, which are sampled the first time they are queried, or all at once with BuildAllTiles.
+    * Each tile keeps coarser levels of the grid, each with half the samples of the one before, for queries
+    * that don't need the full detail.
+    *
+    * A sample is the highest surface found by a vertical ray.  Cells where the ray found more surfaces
+    * under the top one, such as under bridges and overhangs, or where the height jumps by more than the
+    * max step between samples, such as at the walls of buildings, are flagged as complex.  Queries in those
+    * cells return COMPLEX_TERRAIN, and the caller should fall back to an exact intersection.
+    *
+    * If a cache directory is set, built tiles are saved there, and loaded instead of sampled the next
+    * time, as long as the cache key and the grid settings match.
+    */
+   class SIMCORE_EXPORT TerrainElevationRaster : public osg::Referenced
+   {
+      public:
+         enum QueryResult
+         {
+            /// The point is outside the terrain, or there is no terrain under it.
+            NO_DATA,
+            /// The height is the single surface of open terrain.
+            OPEN_TERRAIN,
+            /// The height is the top surface, but there are others or a wall nearby, so it may not be the right one.
+            COMPLEX_TERRAIN
+         };
+
+         static const float DEFAULT_CELL_SIZE;
+         static const unsigned DEFAULT_TILE_CELLS;
+         static const float DEFAULT_MAX_STEP;
+         static const float DEFAULT_MIN_CLEARANCE;
+
+         static const unsigned CACHE_FILE_MAGIC;
+         static const unsigned CACHE_FILE_VERSION;
+         static const std::string CACHE_FILE_EXTENSION;
+
+         /**
+          * @param cellSize the distance in meters between samples.
+          * @param tileCells the number of cells along each side of a tile, which is rounded up to a power of two.
+          */
+         TerrainElevationRaster(float cellSize = DEFAULT_CELL_SIZE, unsigned tileCells = DEFAULT_TILE_CELLS);
+
+         float GetCellSize() const;
+         unsigned GetTileCells() const;
+         /// @return the number of levels in each tile, the full detail level 0 included.
+         unsigned GetNumLevels() const;
+
+         /// Height jumps between neighboring samples bigger than this flag the cell as complex.  Defaults to 3 meters.
+         DT_DECLARE_ACCESSOR(float, MaxStep);
+
+         /// Surfaces under the top one closer than this are ignored, so double sided geometry isn't complex.  Defaults to 1 meter.
+         DT_DECLARE_ACCESSOR(float, MinClearance);
+
+         /// The directory to cache the tiles in.  Empty, the default, doesn't cache them.
+         DT_DECLARE_ACCESSOR(std::string, CacheDirectory);
+
+         /// Identifies the terrain in the cache files, such as the terrain file name and time stamp.
+         DT_DECLARE_ACCESSOR(std::string, CacheKey);
+
+         /// If true, the default, a missing tile is built the first time it's queried.
+         DT_DECLARE_ACCESSOR(bool, BuildOnQuery);
+
+         /**
+          * Sets the terrain to sample and clears the tiles.  The raster covers the bounding box of the node,
+          * and the node is sampled with its own transform, so pass the root node of the terrain.
+          */
+         void SetTerrain(osg::Node* terrain);
+         osg::Node* GetTerrain();
+
+         /// @return the area covered by the tiles.
+         const osg::BoundingBox& GetBounds() const;
+
+         unsigned GetNumTilesX() const;
+         unsigned GetNumTilesY() const;
+
+         /**
+          * Builds the tile, loading it from the cache if possible.
+          * @return false if the tile index is outside the raster, or the tile isn't cached and there's no terrain to sample.
+          */
+         bool BuildTile(unsigned tileX, unsigned tileY);
+
+         /// Builds all the tiles that aren't built yet, such as at load time.  @return the number built.
+         unsigned BuildAllTiles();
+
+         bool IsTileBuilt(unsigned tileX, unsigned tileY) const;
+
+         /// @return the number of tiles sampled from the terrain.
+         unsigned GetNumTilesSampled() const;
+         /// @return the number of tiles loaded from the cache.
+         unsigned GetNumTilesLoaded() const;
+
+         /// Drops the built tiles.  The cache files are kept.
+         void ClearTiles();
+
+         /**
+          * Looks up the terrain height at a point by interpolating the samples of its cell.
+          * @param level the detail level, 0 being the full detail.  Levels past the last use the last.
+          */
+         QueryResult GetHeight(float x, float y, float& outHeight, unsigned level = 0);
+
+         /// Looks up the terrain height and the normal of the cell the point is in.
+         QueryResult GetHeightAndNormal(float x, float y, float& outHeight, osg::Vec3& outNormal, unsigned level = 0);
+
+         /// @return the path of the cache file of a tile, or empty if there is no cache directory.
+         std::string GetTileCacheFile(unsigned tileX, unsigned tileY) const;
+
+      protected:
+         virtual ~TerrainElevationRaster();
+
+      private:
+         struct Level
+         {
+            Level();
+
+            unsigned mNumPoints;
+            float mSpacing;
+            // (mNumPoints x mNumPoints) heights, row by row, with NO_HEIGHT where nothing was hit.
+            std::vector<float> mHeights;
+            // ((mNumPoints - 1) x (mNumPoints - 1)) cells, non zero if complex.
+            std::vector<unsigned char> mComplex;
+         };
+
+         typedef std::vector<Level> Tile;
+
+         /// Samples the full detail level of the tile from the terrain.
+         void SampleTile(unsigned tileX, unsigned tileY, Level& level, std::vector<unsigned char>& multiSurface);
+         /// Flags the complex cells of level 0 and builds the coarser levels.
+         void FinishTile(Tile& tile, const std::vector<unsigned char>& multiSurface);
+
+         bool SaveTile(unsigned tileX, unsigned tileY, const Tile& tile, const std::vector<unsigned char>& multiSurface) const;
+         bool LoadTile(unsigned tileX, unsigned tileY, Tile& tile, std::vector<unsigned char>& multiSurface) const;
+
+         /// @return the level of the tile the point is in, building the tile if needed, or NULL.
+         const Level* FindLevel(float x, float y, unsigned level, float& outLocalX, float& outLocalY);
+
+         float mCellSize;
+         unsigned mTileCells;
+         unsigned mNumLevels;
+         float mTileSize;
+
+         dtCore::ObserverPtr<osg::Node> mTerrain;
+         osg::BoundingBox mBounds;
+         unsigned mNumTilesX, mNumTilesY;
+         std::vector<Tile> mTiles;
+         unsigned mNumTilesSampled;
+         unsigned mNumTilesLoaded;
+   };
+}
+
+#endif
@@ -29,6 +29,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <SimCore/Export.h>
 #include <osg/Array>
+#include <dtCore/observerptr.h>
 #include <dtCore/transformable.h>
 
 
@@ -54,6 +55,8 @@ namespace dtCore
 ////////////////////////////////////////////////////////////////////////////////
 namespace SimCore
 {
+   class TrailEffectBatch;
+
    class SIMCORE_EXPORT TrailEffect : public dtCore::Transformable
    {
       public:
@@ -78,6 +81,14 @@ namespace SimCore
 
          void BuildDrawable();
 
+         /**
+          * Renders this trail as part of a shared batch instead of with its own geometry.
+          * The batch's segment count is used while batched.  Pass NULL to go back
+          * to a standalone drawable.
+          */
+         void SetBatch(TrailEffectBatch* batch);
+         TrailEffectBatch* GetBatch();
+
       protected:
          virtual ~TrailEffect();
 
@@ -94,6 +105,8 @@ namespace SimCore
          dtCore::RefPtr<osg::Vec4Array> mData;
          dtCore::RefPtr<osg::DrawElementsUInt> mIndices;
          dtCore::RefPtr<dtCore::ShaderProgram> mShader;
+         dtCore::ObserverPtr<TrailEffectBatch> mBatch;
+         int mBatchTrailId;
    };
 }
 
@@ -0,0 +1,189 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2009, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#ifndef _SIMCORE_TRAIL_EFFECT_BATCH_H_
+#define _SIMCORE_TRAIL_EFFECT_BATCH_H_
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+#include <SimCore/Export.h>
+#include <osg/Array>
+#include <dtCore/transformable.h>
+#include <vector>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// FORWARD DECLARATIONS
+////////////////////////////////////////////////////////////////////////////////
+namespace osg
+{
+   class Geode;
+   class Geometry;
+   class DrawElementsUInt;
+}
+
+namespace SimCore
+{
+   class TrailEffectBatchDrawCounter;
+}
+
+namespace dtCore
+{
+   class ShaderProgram;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CODE
+////////////////////////////////////////////////////////////////////////////////
+namespace SimCore
+{
+   /**
+    * Renders many trail ribbons from one geometry.  Each trail owns a fixed slot of
+    * (segment count + 1) * 2 vertices in shared ring-buffered arrays, and all trails are
+    * drawn with a single triangle list.  New points are queued and applied to every trail
+    * in one pass per frame, from the update traversal, so the arrays are only dirtied once.
+    */
+   class SIMCORE_EXPORT TrailEffectBatch : public dtCore::Transformable
+   {
+      public:
+         typedef dtCore::Transformable BaseClass;
+
+         static const int DEFAULT_SEGMENT_COUNT = 10;
+         static const int DEFAULT_INITIAL_CAPACITY = 64;
+         static const int INVALID_TRAIL = -1;
+
+         /**
+          * Per frame numbers for the last call to Update.
+          */
+         struct FrameStats
+         {
+            FrameStats();
+
+            unsigned mActiveTrails;
+            unsigned mUpdatedTrails;
+            unsigned mPointsApplied;
+            /// The draws of the shared geometry since the previous update, counted by a draw callback.
+            unsigned mDrawCalls;
+            unsigned mVerticesUploaded;
+            double mUpdateTimeMS;
+         };
+
+         TrailEffectBatch(int segmentCount = DEFAULT_SEGMENT_COUNT, int initialCapacity = DEFAULT_INITIAL_CAPACITY);
+
+         int GetSegmentCount() const;
+
+         /// @return the number of trail slots allocated.  It grows as needed.
+         int GetCapacity() const;
+
+         int GetNumActiveTrails() const;
+
+         /**
+          * Reserves a slot for a new trail with all its points at the start point.
+          * @return the trail id used in the other calls.
+          */
+         int AddTrail(const osg::Vec3& startPoint, float width = 1.0f);
+
+         /// Frees the trail slot so it can be reused.  The trail is hidden on the next update.
+         void RemoveTrail(int trailId);
+
+         bool IsTrailActive(int trailId) const;
+
+         void SetTrailWidth(int trailId, float width);
+         float GetTrailWidth(int trailId) const;
+
+         /// Queues the next point of the trail.  It is applied on the next update.
+         void SetNextPoint(int trailId, const osg::Vec3& worldPoint);
+
+         /// Moves all the points of the trail to the given position on the next update.
+         void ResetPoints(int trailId, const osg::Vec3& worldPoint);
+
+         /**
+          * Applies all the queued points to the shared arrays in one pass.  This is called from the
+          * update traversal, but may be called directly if the batch isn't in a scene.
+          */
+         void Update();
+
+         const FrameStats& GetLastFrameStats() const;
+
+         /// @return the shared geometry.  Exposed mainly for testing.
+         osg::Geometry* GetGeometry();
+         const osg::Geometry* GetGeometry() const;
+
+      protected:
+         virtual ~TrailEffectBatch();
+
+         void BuildDrawable();
+
+         /// Allocates more trail slots, keeping the data of the current ones.
+         void Grow(int newCapacity);
+
+         /// Writes the triangle indices for a slot, oldest point to newest.
+         void WriteSlotIndices(int trailId);
+
+         /// Points all the slot indices at the same vertex so nothing is drawn.
+         void ClearSlotIndices(int trailId);
+
+         void ApplyPoint(int trailId, const osg::Vec3& worldPoint);
+
+         void ApplyReset(int trailId, const osg::Vec3& worldPoint);
+
+      private:
+         struct TrailSlot
+         {
+            TrailSlot();
+
+            bool mActive;
+            bool mReset;
+            bool mDirty;
+            int mCurrentIndex;
+            float mWidth;
+            osg::Vec3 mResetPoint;
+            std::vector<osg::Vec3> mPendingPoints;
+         };
+
+         int VertsPerTrail() const;
+         int IndicesPerTrail() const;
+
+         int mSegmentCount;
+         int mNumActive;
+         std::vector<TrailSlot> mSlots;
+         std::vector<int> mFreeSlots;
+         std::vector<int> mDirtySlots;
+         FrameStats mStats;
+
+         dtCore::RefPtr<osg::Geode> mGeode;
+         dtCore::RefPtr<osg::Geometry>  mGeom;
+         dtCore::RefPtr<osg::Vec3Array> mVerts;
+         dtCore::RefPtr<osg::Vec4Array> mData;
+         dtCore::RefPtr<osg::Vec3Array> mNormals;
+         dtCore::RefPtr<osg::Vec3Array> mTexCoords;
+         dtCore::RefPtr<osg::DrawElementsUInt> mIndices;
+         dtCore::RefPtr<dtCore::ShaderProgram> mShader;
+         dtCore::RefPtr<TrailEffectBatchDrawCounter> mDrawCounter;
+   };
+}
+
+#endif
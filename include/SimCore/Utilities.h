@@ -33,6 +33,8 @@
 #include <dtGame/gamemanager.h>
 #include <dtGame/exceptionenum.h>
 #include <SimCore/CollisionGroupEnum.h>
+#include <dtPhysics/raycast.h>
+#include <vector>
 
 namespace dtPhysics
 {
@@ -81,6 +83,7 @@ namespace Utils
 
    /**
     * Uses an isector to check if an object's transform is too high or two low and should be adjusted to be on the terrain.
+    * If the terrain actor is a TerrainActor with a height raster, open terrain is looked up in the raster instead.
     * @param dropHeight The height above the highest terrain point found to set the transform if it is object
     * @param maxDepthBelow the distance below the terrain at which the transform should not be moved back up, or < 0 to ignore.
     * @param maxHeightAbove The point above terrain above which point it should not move it back down, or < 0 to ignore
@@ -114,6 +117,23 @@ namespace Utils
    bool SIMCORE_EXPORT KeepBodyOnGround(dtPhysics::TransformType& transformToUpdate, float bodyHeight = 1.0f, float dropHeight = 0.5f,
             float maxDepthBelow = 5.0f, float maxHeightAbove = 20.0f, float testRange = 1000.0f,
             dtPhysics::CollisionGroupFilter collisionFlags = 1 << SimCore::CollisionGroup::GROUP_TERRAIN);
+
+   /**
+    * Sets up the ray that KeepBodyOnGround casts, so it can be traced somewhere else.  Pass the sorted
+    * hits to KeepBodyOnGroundFromHits.
+    */
+   void SIMCORE_EXPORT SetupKeepOnGroundRay(dtPhysics::RayCast& ray, const dtPhysics::VectorType& pos,
+            float testRange = 1000.0f, dtPhysics::CollisionGroupFilter collisionFlags = 1 << SimCore::CollisionGroup::GROUP_TERRAIN);
+
+   /**
+    * Does the same adjustment as KeepBodyOnGround, but with the hits from a ray that was already traced.
+    * @param hits The hits from the ray made by SetupKeepOnGroundRay, sorted by distance.
+    * @see KeepBodyOnGround for the other parameters.
+    * @return true if an adjustment was made.
+    */
+   bool SIMCORE_EXPORT KeepBodyOnGroundFromHits(dtPhysics::TransformType& transformToUpdate,
+            const std::vector<dtPhysics::RayCast::Report>& hits, float bodyHeight = 1.0f, float dropHeight = 0.5f,
+            float maxDepthBelow = 5.0f, float maxHeightAbove = 20.0f, float testRange = 1000.0f);
 }
 }
 
@@ -0,0 +1,147 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+#ifndef STEALTH_ENTITY_SEARCH_INDEX_COMPONENT_H_
+#define STEALTH_ENTITY_SEARCH_INDEX_COMPONENT_H_
+
+#include <dtGame/gmcomponent.h>
+#include <dtCore/observerptr.h>
+#include <dtCore/uniqueid.h>
+#include <StealthViewer/GMApp/Export.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dtGame
+{
+   class GameActorProxy;
+}
+
+namespace StealthGM
+{
+   /**
+    * Keeps a searchable index of the call signs (names) of all the entities in the GM.
+    * The index is maintained from the actor create, update and delete messages, so searching
+    * and cycling through entities never has to scan every actor in the GM.
+    *
+    * Prefix searches use an ordered name index.  Substring searches use a trigram index to narrow
+    * the candidates before the actual string compare.
+    */
+   class STEALTH_GAME_EXPORT EntitySearchIndexComponent : public dtGame::GMComponent
+   {
+   public:
+      typedef dtGame::GMComponent BaseClass;
+      static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
+
+      static const std::string DEFAULT_NAME;
+
+      /// Constructor
+      EntitySearchIndexComponent(dtCore::SystemComponentType& type = *TYPE);
+
+      /**
+       * Override to process messages
+       * @param msg The message to process
+       */
+      virtual void ProcessMessage(const dtGame::Message& msg);
+
+      virtual void OnAddedToGM();
+      virtual void OnRemovedFromGM();
+
+      /// Clears the index and adds all of the entities currently in the GM.
+      void Rebuild();
+
+      /// Removes everything from the index.
+      void Clear();
+
+      /**
+       * Adds the actor to the index if it is an entity, or re-indexes it if its name changed.
+       * @return true if the actor is an entity and is in the index.
+       */
+      bool IndexActor(dtGame::GameActorProxy& actor);
+
+      /// Removes the actor with the given id from the index.
+      void RemoveActor(const dtCore::UniqueId& id);
+
+      /// @return the number of entities in the index.
+      unsigned GetNumEntities() const;
+
+      /**
+       * Entities are held in a dense array so they can be stepped through in constant time.
+       * The order changes as entities are removed.
+       * @return The entity at the given position or NULL if it has been deleted.
+       */
+      dtGame::GameActorProxy* GetEntityAt(unsigned index) const;
+
+      /**
+       * Finds the ids of all entities with a name starting with the given string.
+       * @param prefix The prefix to match.  An empty string matches all entities.
+       * @param toFill The vector to fill.  It is NOT cleared first.
+       * @param maxResults stops after finding this many.  0 means no limit.
+       */
+      void FindByPrefix(const std::string& prefix, std::vector<dtCore::UniqueId>& toFill, unsigned maxResults = 0) const;
+
+      /**
+       * Finds the ids of all entities with a name that contains the given string.
+       * @param text The text to search for.  An empty string matches all entities.
+       * @param toFill The vector to fill.  It is NOT cleared first.
+       * @param maxResults stops after finding this many.  0 means no limit.
+       */
+      void FindBySubstring(const std::string& text, std::vector<dtCore::UniqueId>& toFill, unsigned maxResults = 0) const;
+
+      /// @return the indexed actor with the given id, or NULL if it's not in the index or has been deleted.
+      dtGame::GameActorProxy* GetEntity(const dtCore::UniqueId& id) const;
+
+   protected:
+
+      /// Destructor
+      virtual ~EntitySearchIndexComponent();
+
+   private:
+      /// Trigrams are packed into the low 24 bits of an unsigned int.
+      typedef unsigned Trigram;
+
+      struct IndexEntry
+      {
+         dtCore::UniqueId mId;
+         std::string mName;
+         dtCore::ObserverPtr<dtGame::GameActorProxy> mActor;
+      };
+
+      static void GetTrigrams(const std::string& name, std::set<Trigram>& toFill);
+
+      void AddNameKeys(const IndexEntry& entry);
+      void RemoveNameKeys(const IndexEntry& entry);
+
+      typedef std::vector<IndexEntry> EntryArray;
+      typedef std::map<dtCore::UniqueId, unsigned> IdToEntryMap;
+      typedef std::multimap<std::string, dtCore::UniqueId> NameIndex;
+      typedef std::map<Trigram, std::set<dtCore::UniqueId> > TrigramIndex;
+
+      EntryArray mEntries;
+      IdToEntryMap mIdToEntry;
+      NameIndex mNameIndex;
+      TrigramIndex mTrigramIndex;
+   };
+}
+
+#endif
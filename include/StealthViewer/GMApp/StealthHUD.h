@@ -48,10 +48,16 @@
 
 namespace SimCore
 {
+   class ProfileStatsMessage;
    class ToolMessage;
    class UnitOfAngle;
    class UnitOfLength;
 
+   namespace Components
+   {
+      class FrameBudgetJob;
+   }
+
    namespace Tools
    {
       class Compass360;
@@ -109,6 +115,11 @@ namespace StealthGM
        */
       virtual void ProcessMessage(const dtGame::Message& message);
 
+      /**
+       * Takes the HUD refresh job out of the frame budget.
+       */
+      virtual void OnRemovedFromGM();
+
       /**
        * Sets up the basic GUI.
        */
@@ -201,6 +212,9 @@ namespace StealthGM
 
       void ProcessToolMessage(const SimCore::ToolMessage& toolMessage);
 
+      /// Shows the stats of the profiler in the debug panel.
+      void UpdateProfileText(const SimCore::ProfileStatsMessage& statsMessage);
+
    private:
 
       /**
@@ -244,6 +258,9 @@ namespace StealthGM
       dtCore::RefPtr<SimCore::Components::StealthButton> mHelpButton;
       dtCore::RefPtr<SimCore::Components::HUDText> mHelpText;
 
+      // Profiler debug panel
+      dtCore::RefPtr<SimCore::Components::HUDText> mProfileText;
+
       // Label Manager
       dtCore::RefPtr<SimCore::Components::LabelManager> mLabelManager;
       dtCore::RefPtr<SimCore::Components::HUDElement> mLabelLayer;
@@ -251,6 +268,9 @@ namespace StealthGM
       // Tools
       dtCore::RefPtr<SimCore::Tools::Compass360> mCompass360;
 
+      // Runs TickHUD inside the frame budget when a FrameBudgetComponent exists.
+      dtCore::RefPtr<SimCore::Components::FrameBudgetJob> mRefreshJob;
+
       // The HUD will need a reference to the motion model
       // in order to get all data that needs to be displayed.
       dtCore::ObserverPtr<dtCore::MotionModel> mMotionModel;
@@ -29,7 +29,9 @@
 #define _ENTITY_SEARCH_H_
 
 #include <dtGame/gameactor.h>
+#include <dtCore/uniqueid.h>
 #include <string>
+#include <vector>
 
 namespace StealthQt
 {
@@ -51,6 +53,29 @@ namespace StealthQt
             const std::string &force, 
             const std::string &damageState);
 
+         /**
+          * Finds the ids of all entities with a name starting with the call sign.  This uses the
+          * entity search index if it has been added to the GM, otherwise it has to scan all the actors.
+          * The results still need to be checked with MatchesFilter for force, damage state and visibility.
+          * @param toFill The vector to fill
+          * @param gm The game manager to search
+          * @param callSign The call sign to look for
+          */
+         static void FindCandidateEntities(std::vector<dtCore::UniqueId>& toFill,
+            dtGame::GameManager& gm,
+            const std::string& callSign);
+
+         /**
+          * Checks an entity against the search parameters
+          * @param actor The actor to check
+          * @param force The force to look for
+          * @param damageState The damagestate to look for
+          * @return true if the actor is a visible entity matching the force and damage state.
+          */
+         static bool MatchesFilter(dtGame::GameActorProxy& actor,
+            const std::string& force,
+            const std::string& damageState);
+
          /**
           * Returns an entity's last update time
           * @param proxy, the proxy to check
@@ -364,6 +364,9 @@ namespace StealthQt
          /// Called when the entity info timer elapses
          void OnRefreshEntityInfoTimerElapsed();
 
+         /// Called to add the next batch of search results to the search table
+         void OnSearchResultsTimerElapsed();
+
          /// Called when the auto refresh button is changed
          void OnAutoRefreshEntityInfoCheckBoxChanged(int state);
 
@@ -508,6 +511,7 @@ namespace StealthQt
          QTimer mGenericTickTimer;
          QTimer mRefreshEntityInfoTimer;
          QTimer mHLAErrorTimer;
+         QTimer mSearchResultsTimer;
 
          dtGame::GameApplicationLoader* mGameLoader;
          dtCore::RefPtr<dtGame::GameManager> mGM;
@@ -515,6 +519,12 @@ namespace StealthQt
 
          std::vector<dtCore::ObserverPtr<dtGame::GameActorProxy> > mFoundActors;
 
+         // Search candidates still to be filtered and added to the search table.
+         std::vector<dtCore::UniqueId> mPendingSearchResults;
+         unsigned mPendingSearchIndex;
+         std::string mSearchForce;
+         std::string mSearchDamageState;
+
          QDoubleValidator* mLODScaleValidator;
          QDoubleValidator* mLatValidator;
          QDoubleValidator* mLonValidator;
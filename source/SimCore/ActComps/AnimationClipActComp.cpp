@@ -27,8 +27,10 @@
 #include <dtCore/arrayactorpropertycomplex.h>
 #include <dtCore/enumactorproperty.h>
 #include <dtGame/gameactor.h>
+#include <dtUtil/mathdefines.h>
 #include <osg/AnimationPath>
 #include <osg/NodeVisitor>
+#include <cmath>
 
 
 using namespace dtAnim;
@@ -146,6 +148,105 @@ namespace SimCore
 
 
 
+      ////////////////////////////////////////////////////////////////////////////////
+      // ANIMATION CLIP PATH
+      ////////////////////////////////////////////////////////////////////////////////
+      AnimationClipPath::AnimationClipPath()
+      : BaseClass()
+      , mBeginTime(0.0)
+      , mEndTime(0.0)
+      {
+      }
+
+      AnimationClipPath::AnimationClipPath(const osg::AnimationPath& source)
+      : BaseClass()
+      , mSource(&source)
+      , mBeginTime(0.0)
+      , mEndTime(0.0)
+      {
+         setLoopMode(source.getLoopMode());
+      }
+
+      AnimationClipPath::AnimationClipPath(const AnimationClipPath& clipPath, const osg::CopyOp& copyop)
+      : BaseClass(clipPath, copyop)
+      , mSource(clipPath.mSource)
+      , mBeginTime(clipPath.mBeginTime)
+      , mEndTime(clipPath.mEndTime)
+      {
+      }
+
+      AnimationClipPath::~AnimationClipPath()
+      {
+      }
+
+      const osg::AnimationPath* AnimationClipPath::GetSource() const
+      {
+         return mSource.get();
+      }
+
+      void AnimationClipPath::SetClipTimes(double beginTime, double endTime)
+      {
+         mBeginTime = beginTime;
+         mEndTime = endTime;
+      }
+
+      double AnimationClipPath::GetBeginTime() const
+      {
+         return mBeginTime;
+      }
+
+      double AnimationClipPath::GetEndTime() const
+      {
+         return mEndTime;
+      }
+
+      bool AnimationClipPath::getInterpolatedControlPoint(double time, ControlPoint& controlPoint) const
+      {
+         if ( ! mSource.valid())
+         {
+            return false;
+         }
+
+         double beginTime = mBeginTime;
+         double endTime = mEndTime;
+         if (endTime <= beginTime)
+         {
+            beginTime = mSource->getFirstTime();
+            endTime = mSource->getLastTime();
+         }
+
+         double period = endTime - beginTime;
+         if (period <= 0.0)
+         {
+            time = 0.0;
+         }
+         else if (getLoopMode() == SWING)
+         {
+            double modulatedTime = std::fmod(time, 2.0 * period);
+            if (modulatedTime < 0.0)
+            {
+               modulatedTime += 2.0 * period;
+            }
+            time = modulatedTime > period ? 2.0 * period - modulatedTime : modulatedTime;
+         }
+         else if (getLoopMode() == LOOP)
+         {
+            time = std::fmod(time, period);
+            if (time < 0.0)
+            {
+               time += period;
+            }
+         }
+         else
+         {
+            time = dtUtil::Clamp(time, 0.0, period);
+         }
+
+         return mSource->getInterpolatedControlPoint(beginTime + time, controlPoint);
+      }
+
+
+
       ////////////////////////////////////////////////////////////////////////////////
       // ANIMATION CLIP ACTOR COMPONENT
       ////////////////////////////////////////////////////////////////////////////////
@@ -256,6 +357,11 @@ namespace SimCore
          return mAnimProps.size();
       }
 
+      unsigned AnimationClipActComp::GetNumAnimationCallbacks() const
+      {
+         return mAnimCallbacks.size();
+      }
+
       void AnimationClipActComp::SetPaused(bool paused)
       {
          if (mPaused != paused)
@@ -305,14 +411,7 @@ namespace SimCore
             return;
          }
 
-         osg::Node* node = GetOwnerNode();
-         if (node != NULL)
-         {
-            AnimCallbackVisitor visitor;
-            node->accept(visitor);
-
-            visitor.ResetCallbacks();
-         }
+         ResetCallbacks();
       }
 
       void AnimationClipActComp::OnEnteredWorld()
@@ -377,25 +476,34 @@ namespace SimCore
                InternalPauseAnimation(true);
             }
 
+            // Find the callbacks once so playing and pausing don't have to search the model.
             AnimCallbackVisitor visitor;
             node->accept(visitor);
+            mAnimCallbacks.clear();
 
-            // Convert the animation paths to path types
-            // that can play segments of a full animation.
-            // This could take a significant amount of time 
-            // depending on the number of objects and length of
-            // animation to be copied between animation paths.
-            typedef AnimCallbackVisitor::AnimCallbackVector AnimCallbackVector;
-            AnimCallbackVector::iterator iter = visitor.GetAnimCallbacks().begin();
-            AnimCallbackVector::iterator iterEnd = visitor.GetAnimCallbacks().end();
+            // Wrap the animation paths with paths that can play segments of a full animation.
+            // The wrappers refer to the key frames of the original paths rather than copying them,
+            // so the instances of a model share them.
+            AnimCallbackVisitor::AnimCallbackVector::iterator iter = visitor.GetAnimCallbacks().begin();
+            AnimCallbackVisitor::AnimCallbackVector::iterator iterEnd = visitor.GetAnimCallbacks().end();
             for (; iter != iterEnd; ++iter)
             {
-               dtCore::RefPtr<AnimClipPath> newPath
-               = new AnimClipPath(*(iter->get()->getAnimationPath()));
-               iter->get()->setAnimationPath(newPath);
+               osg::AnimationPathCallback* callback = iter->get();
+               osg::AnimationPath* path = callback->getAnimationPath();
+               if (path == NULL)
+               {
+                  continue;
+               }
+
+               if (dynamic_cast<AnimationClipPath*>(path) == NULL)
+               {
+                  callback->setAnimationPath(new AnimationClipPath(*path));
+               }
+
+               mAnimCallbacks.push_back(callback);
             }
 
-            mIsValid = ! visitor.GetAnimCallbacks().empty();
+            mIsValid = ! mAnimCallbacks.empty();
 
             // Ensure proper states.
             InternalPauseAnimation(mPaused);
@@ -409,16 +517,6 @@ namespace SimCore
             return;
          }
 
-         osg::Node* node = GetOwnerNode();
-         AnimCallbackVisitor visitor;
-         if (node == NULL)
-         {
-            LOG_ERROR("Could not access actor root node.");
-            return;
-         }
-
-         node->accept(visitor);
-
          // Apply another set of parameters if another index has been specified.
          if (mCurrentAnimation != animIndex)
          {
@@ -435,7 +533,7 @@ namespace SimCore
                return;
             }
 
-            ApplyAnimationClipParameters(*animProps, visitor, true, true);
+            ApplyAnimationClipParameters(*animProps, true, true);
 
             mCurrentAnimation = animIndex;
          }
@@ -443,10 +541,10 @@ namespace SimCore
          {
             if (reset)
             {
-               visitor.ResetCallbacks();
+               ResetCallbacks();
             }
 
-            visitor.SetPaused(false);
+            SetCallbacksPaused(false);
          }
 
          mPaused = false;
@@ -459,52 +557,34 @@ namespace SimCore
             return;
          }
 
-         osg::Node* node = GetOwnerNode();
-
-         if (node != NULL)
-         {
-            AnimCallbackVisitor visitor;
-            node->accept(visitor);
-
-            visitor.SetPaused(pause);
-            mPaused = pause;
-         }
+         SetCallbacksPaused(pause);
+         mPaused = pause;
       }
 
       void AnimationClipActComp::ApplyAnimationClipParameters(
             AnimationPropertyContainer& animParams,
-            osg::NodeVisitor& visitorBaseType,
             bool play, bool reset)
       {
-         AnimCallbackVisitor* visitor = static_cast<AnimCallbackVisitor*>(&visitorBaseType);
-
-         AnimClipPath* curPath = NULL;
-         osg::AnimationPath::LoopMode curLoopMode = osg::AnimationPath::NO_LOOPING;
+         osg::AnimationPath::LoopMode loopMode = osg::AnimationPath::NO_LOOPING;
+         if(animParams.GetPlayMode() == PlayModeEnum::LOOP)
+         {
+            loopMode = osg::AnimationPath::LOOP;
+         }
+         else if(animParams.GetPlayMode() == PlayModeEnum::SWING)
+         {
+            loopMode = osg::AnimationPath::SWING;
+         }
 
-         typedef AnimCallbackVisitor::AnimCallbackVector AnimCallbackVector;
-         AnimCallbackVector::iterator iter = visitor->GetAnimCallbacks().begin();
-         AnimCallbackVector::iterator iterEnd = visitor->GetAnimCallbacks().end();
+         AnimationClipPath* curPath = NULL;
+         AnimCallbackVector::iterator iter = mAnimCallbacks.begin();
+         AnimCallbackVector::iterator iterEnd = mAnimCallbacks.end();
          for (; iter != iterEnd; ++iter)
          {
-            if(animParams.GetPlayMode() == PlayModeEnum::LOOP)
-            {
-               curLoopMode = osg::AnimationPath::LOOP;
-            }
-            else if(animParams.GetPlayMode() == PlayModeEnum::SWING)
-            {
-               curLoopMode = osg::AnimationPath::SWING;
-            }
-            else
-            {
-               curLoopMode = osg::AnimationPath::NO_LOOPING;
-            }
-
-            curPath = dynamic_cast<AnimClipPath*>(iter->get()->getAnimationPath());
+            curPath = dynamic_cast<AnimationClipPath*>(iter->get()->getAnimationPath());
             if(curPath != NULL)
             {
-               curPath->setBeginTime(animParams.GetBeginTime());
-               curPath->setEndTime(animParams.GetEndTime());
-               curPath->setLoopMode(curLoopMode);
+               curPath->SetClipTimes(animParams.GetBeginTime(), animParams.GetEndTime());
+               curPath->setLoopMode(loopMode);
             }
 
             iter->get()->setTimeMultiplier(animParams.GetTimeScale());
@@ -512,10 +592,30 @@ namespace SimCore
 
          if (reset)
          {
-            visitor->ResetCallbacks();
+            ResetCallbacks();
          }
 
-         visitor->SetPaused(!play);
+         SetCallbacksPaused(!play);
+      }
+
+      void AnimationClipActComp::ResetCallbacks()
+      {
+         AnimCallbackVector::iterator iter = mAnimCallbacks.begin();
+         AnimCallbackVector::iterator iterEnd = mAnimCallbacks.end();
+         for (; iter != iterEnd; ++iter)
+         {
+            iter->get()->reset();
+         }
+      }
+
+      void AnimationClipActComp::SetCallbacksPaused(bool paused)
+      {
+         AnimCallbackVector::iterator iter = mAnimCallbacks.begin();
+         AnimCallbackVector::iterator iterEnd = mAnimCallbacks.end();
+         for (; iter != iterEnd; ++iter)
+         {
+            iter->get()->setPause(paused);
+         }
       }
 
    }
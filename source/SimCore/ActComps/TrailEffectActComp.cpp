@@ -46,6 +46,8 @@
 #include <SimCore/Actors/Platform.h>
 #include <SimCore/Actors/TerrainActorProxy.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
+#include <SimCore/Components/TrailEffectBatchComponent.h>
+#include <SimCore/TrailEffectBatch.h>
 
 
 
@@ -63,9 +65,12 @@ namespace SimCore
       const dtUtil::RefString TrailEffectActComp::PROPERTY_TRAIL_ATTACH_NODE_NAME("Trail Attach Node Name");
       const dtUtil::RefString TrailEffectActComp::PROPERTY_TRAIL_CLAMP_INTERVAL("Trail Clamp Interval");
       const dtUtil::RefString TrailEffectActComp::PROPERTY_TRAIL_ENABLE_DISTANCE("Trail Enable Distance");
+      const dtUtil::RefString TrailEffectActComp::PROPERTY_TRAIL_RIBBON_WIDTH("Trail Ribbon Width");
 
       const float TrailEffectActComp::DEFAULT_TRAIL_CLAMP_INTERVAL = 1.0f;
       const float TrailEffectActComp::DEFAULT_TRAIL_ENABLE_DISTANCE = 1.0f;
+      const float TrailEffectActComp::DEFAULT_TRAIL_RIBBON_WIDTH = 3.0f;
+      const float TrailEffectActComp::RIBBON_POINT_SPACING = 2.0f;
 
 
 
@@ -146,6 +151,9 @@ namespace SimCore
          : BaseClass(TYPE)
          , mOwnerIsPlatform(false)
          , mClampTimer(0.0f)
+         , mRibbonId(SimCore::TrailEffectBatch::INVALID_TRAIL)
+         , mRibbonEnabled(false)
+         , mRibbonRestart(false)
       {
          SetDefaults();
       }
@@ -155,6 +163,9 @@ namespace SimCore
          : BaseClass(actType)
          , mOwnerIsPlatform(false)
          , mClampTimer(0.0f)
+         , mRibbonId(SimCore::TrailEffectBatch::INVALID_TRAIL)
+         , mRibbonEnabled(false)
+         , mRibbonRestart(false)
       {
          SetDefaults();
       }
@@ -170,6 +181,7 @@ namespace SimCore
          SetTrailClampInterval(DEFAULT_TRAIL_CLAMP_INTERVAL);
          SetTrailEnableDistance(DEFAULT_TRAIL_ENABLE_DISTANCE);
          SetTrailAttached(false);
+         SetTrailRibbonWidth(DEFAULT_TRAIL_RIBBON_WIDTH);
       }
 
 
@@ -183,6 +195,7 @@ namespace SimCore
       DT_IMPLEMENT_ACCESSOR(TrailEffectActComp, bool, TrailAttached);
       DT_IMPLEMENT_ACCESSOR(TrailEffectActComp, std::string, TrailAttachNodeName);
       DT_IMPLEMENT_ACCESSOR_GETTER(TrailEffectActComp, dtCore::ResourceDescriptor, TrailParticlesFile); // Setter is implemented below
+      DT_IMPLEMENT_ACCESSOR_GETTER(TrailEffectActComp, float, TrailRibbonWidth); // Setter is implemented below
 
       //////////////////////////////////////////////////////////////////////////
       void TrailEffectActComp::SetTrailParticlesFile(const dtCore::ResourceDescriptor& file)
@@ -190,6 +203,16 @@ namespace SimCore
          mTrailParticlesFile = file;
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void TrailEffectActComp::SetTrailRibbonWidth(float width)
+      {
+         mTrailRibbonWidth = width;
+         if (HasRibbon())
+         {
+            mRibbonBatch->SetTrailWidth(mRibbonId, width);
+         }
+      }
+
 
 
       //////////////////////////////////////////////////////////////////////////
@@ -423,6 +446,12 @@ namespace SimCore
          {
             mParticles->SetEnabled(enable);
          }
+
+         if (enable && ! mRibbonEnabled)
+         {
+            mRibbonRestart = true;
+         }
+         mRibbonEnabled = enable;
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -431,6 +460,76 @@ namespace SimCore
          return mParticles.valid() && mParticles->IsEnabled();
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      bool TrailEffectActComp::HasRibbon() const
+      {
+         return mRibbonBatch.valid() && mRibbonBatch->IsTrailActive(mRibbonId);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool TrailEffectActComp::AddRibbon()
+      {
+         if (mTrailRibbonWidth <= 0.0f || ! IsTickable() || HasRibbon())
+         {
+            return false;
+         }
+
+         dtGame::GameActorProxy* actor = NULL;
+         GetOwner(actor);
+         if (actor == NULL || actor->GetGameManager() == NULL)
+         {
+            return false;
+         }
+
+         SimCore::Components::TrailEffectBatchComponent* batchComp = NULL;
+         actor->GetGameManager()->GetComponentByName(SimCore::Components::TrailEffectBatchComponent::DEFAULT_NAME, batchComp);
+         if (batchComp == NULL || batchComp->GetBatch() == NULL)
+         {
+            // Ribbons are on by default, so an application without the batch just goes without them.
+            LOG_INFO("Could not access the Trail Effect Batch Component to add a trail ribbon.");
+            return false;
+         }
+
+         GetOwnerPosition(*this, mLastRibbonPoint);
+         mRibbonBatch = batchComp->GetBatch();
+         mRibbonId = mRibbonBatch->AddTrail(mLastRibbonPoint, mTrailRibbonWidth);
+         mRibbonEnabled = true;
+         mRibbonRestart = false;
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TrailEffectActComp::RemoveRibbon()
+      {
+         if (mRibbonBatch.valid())
+         {
+            mRibbonBatch->RemoveTrail(mRibbonId);
+         }
+         mRibbonBatch = NULL;
+         mRibbonId = SimCore::TrailEffectBatch::INVALID_TRAIL;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TrailEffectActComp::UpdateRibbon(const osg::Vec3& pos)
+      {
+         if ( ! mRibbonEnabled || ! HasRibbon())
+         {
+            return;
+         }
+
+         if (mRibbonRestart)
+         {
+            mRibbonBatch->ResetPoints(mRibbonId, pos);
+            mLastRibbonPoint = pos;
+            mRibbonRestart = false;
+         }
+         else if ((pos - mLastRibbonPoint).length2() >= RIBBON_POINT_SPACING * RIBBON_POINT_SPACING)
+         {
+            mRibbonBatch->SetNextPoint(mRibbonId, pos);
+            mLastRibbonPoint = pos;
+         }
+      }
+
       //////////////////////////////////////////////////////////////////////////
       void TrailEffectActComp::Update(float timeDelta)
       {
@@ -484,6 +583,7 @@ namespace SimCore
 
             pos.z() = mClampPoint.z();
             SetParticlePosition(pos);
+            UpdateRibbon(pos);
          }
       }
 
@@ -508,8 +608,10 @@ namespace SimCore
       {
          BaseClass::OnEnteredWorld();
 
-         // Register tick handlers only if the particle effect is valid.
-         if(LoadParticles() && IsTickable())
+         // Register tick handlers only if there is a particle effect or ribbon to move.
+         bool hasParticles = LoadParticles();
+         bool hasRibbon = AddRibbon();
+         if((hasParticles || hasRibbon) && IsTickable())
          {
             RegisterForTick();
          }
@@ -541,6 +643,7 @@ namespace SimCore
          UnregisterForTick();
 
          DetachParticles();
+         RemoveRibbon();
       }
 
 
@@ -565,6 +668,13 @@ namespace SimCore
             "Max distance above the surface in which the trail effect remains enabled",
             PropRegType, propRegHelper);
 
+         DT_REGISTER_PROPERTY_WITH_NAME_AND_LABEL(
+            TrailRibbonWidth,
+            PROPERTY_TRAIL_RIBBON_WIDTH,
+            PROPERTY_TRAIL_RIBBON_WIDTH,
+            "Width of a ribbon drawn along the ground behind the actor with the other ribbons in one batch. Zero means no ribbon.",
+            PropRegType, propRegHelper);
+
          // BOOLEAN PROPERTIES
          DT_REGISTER_PROPERTY_WITH_NAME_AND_LABEL(
             TrailAttached,
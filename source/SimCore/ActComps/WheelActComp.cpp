@@ -24,6 +24,7 @@
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/ActComps/WheelActComp.h>
 #include <SimCore/Actors/IGActor.h>
+#include <SimCore/Components/WheelAnimationComponent.h>
 #include <dtGame/basemessages.h>
 #include <osgSim/DOFTransform>
 #include <osg/MatrixTransform>
@@ -299,6 +300,16 @@ namespace SimCore
          if (GetAutoUpdateMode() == AutoUpdateModeEnum::LOCAL_AND_REMOTE
                   || (actor->IsRemote() && GetAutoUpdateMode() == AutoUpdateModeEnum::REMOTE_ONLY))
          {
+            // The wheel animation component updates all the vehicles in one pass, so use it if there is one.
+            SimCore::Components::WheelAnimationComponent* wheelAnimation = NULL;
+            actor->GetGameManager()->GetComponentByName(SimCore::Components::WheelAnimationComponent::DEFAULT_NAME, wheelAnimation);
+            if (wheelAnimation != NULL)
+            {
+               wheelAnimation->RegisterWheels(*this);
+               mWheelAnimation = wheelAnimation;
+               return;
+            }
+
             std::string tickInvokable = "Tick Remote " + GetType()->GetFullName();
             if (actor->GetInvokable(tickInvokable) == NULL)
             {
@@ -312,6 +323,12 @@ namespace SimCore
       /////////////////////////////////////////////////////
       void WheelActComp::OnRemovedFromWorld()
       {
+         if (mWheelAnimation.valid())
+         {
+            mWheelAnimation->UnregisterWheels(*this);
+            mWheelAnimation = NULL;
+         }
+
          ClearAllAxles();
       }
 
@@ -414,33 +431,46 @@ namespace SimCore
          actor->GetDrawable(xformable);
          xformable->GetTransform(xform);
          osg::Vec3 fwd;
-         osg::Vec3 right;
          xform.GetRow(1, fwd);
-         xform.GetRow(0, right);
-
-         osg::Vec3 vvecNormal = vvec;
-         float length = vvecNormal.normalize();
 
          float steerAngle = 0.0f;
          float mps = 0.0f;
+         CalcWheelMotion(msg.GetDeltaSimTime(), vvec, curHeading, fwd, mps, steerAngle);
 
-         if (length > FLT_EPSILON)
+         for (unsigned i = 0; i < GetNumAxles(); ++i)
          {
-            float dot = fwd * vvecNormal;
+            Axle* axle = GetAxle(i);
+            axle->UpdateAxleRotation(msg.GetDeltaSimTime(), steerAngle, mps);
+         }
+      }
 
-            mps = dot * length;
+      /////////////////////////////////////////////////////
+      void WheelActComp::CalcWheelMotion(float dt, const osg::Vec3& velocity, float heading, const osg::Vec3& forward,
+               float& speedMps, float& steerAngle)
+      {
+         speedMps = 0.0f;
+         steerAngle = 0.0f;
 
-            steerAngle = (curHeading - mLastFrameHeading) / msg.GetDeltaSimTime();
-            mLastFrameHeading = curHeading;
-         }
+         osg::Vec3 vvecNormal = velocity;
+         float length = vvecNormal.normalize();
 
-         for (unsigned i = 0; i < GetNumAxles(); ++i)
+         if (length > FLT_EPSILON)
          {
-            Axle* axle = GetAxle(i);
-            axle->UpdateAxleRotation(msg.GetDeltaSimTime(), steerAngle, mps);
+            float dot = forward * vvecNormal;
+
+            speedMps = dot * length;
+
+            steerAngle = (heading - mLastFrameHeading) / dt;
+            mLastFrameHeading = heading;
          }
       }
 
+      /////////////////////////////////////////////////////
+      void WheelActComp::ResetLastFrameHeading(float heading)
+      {
+         mLastFrameHeading = heading;
+      }
+
    }
 
 }
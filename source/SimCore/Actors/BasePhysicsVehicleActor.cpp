@@ -449,6 +449,8 @@ namespace SimCore
          }
          else
          {
+            // Done now, rather than batched in the PhysicsRayQueryComponent, so the vehicle
+            // is never drawn or simulated for a frame below the ground.
             if (SimCore::Utils::KeepBodyOnGround(xform, GetBoundingBox().zMax() - GetBoundingBox().zMin(), mTerrainPresentDropHeight))
             {
                SetTransform(xform);
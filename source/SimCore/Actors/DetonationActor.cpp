@@ -43,6 +43,7 @@
 
 #include <dtABC/application.h>
 
+#include <SimCore/Components/DetonationActorPool.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <SimCore/Components/TimedDeleterComponent.h>
@@ -167,15 +168,6 @@ namespace SimCore
 
       }
 
-      ///////////////////////////////////////////////////////////////////////
-      void DetonationActorProxy::OnEnteredWorld()
-      {
-         DetonationActor* da = GetDrawable<DetonationActor>();
-         float time = da->GetDelayTime();
-         GetGameManager()->SetTimer("PlayDetonationSoundTimer", this, time);
-
-      }
-
       ///////////////////////////////////////////////////////////////////////
       void DetonationActorProxy::HandleDetonationActorTimers(const dtGame::TimerElapsedMessage& timeMsg)
       {
@@ -194,6 +186,10 @@ namespace SimCore
          {
             GetDrawable<DetonationActor>()->StopRenderingSmoke();
          }
+         else if(timeMsg.GetTimerName() == "DetonationFinished")
+         {
+            GetDrawable<DetonationActor>()->FinishDetonation();
+         }
          else
             LOG_ERROR("Received a timer message of the correct type, but wrong name");
       }
@@ -204,6 +200,7 @@ namespace SimCore
          GetGameManager()->ClearTimer("PlayDetonationSoundTimer", this);
          GetGameManager()->ClearTimer("ExplosionRendered", this);
          GetGameManager()->ClearTimer("SmokeRendered", this);
+         GetGameManager()->ClearTimer("DetonationFinished", this);
          //GetGameManager()->ClearTimer("DeleteActor", this);
       }
 
@@ -215,6 +212,9 @@ namespace SimCore
       : IGActor(owner)
       , mSmokeLifeTime(0.0f)
       , mCurrentImpact(IMPACT_TERRAIN)
+      , mLoadedImpact(-1)
+      , mDynamicLightId(0)
+      , mDetonating(false)
       , mDelayTime(3.0f)
       , mRenderExplosionTimerSecs(2.0f)
       , mDeleteActorTimerSecs(5.0f)
@@ -251,12 +251,21 @@ namespace SimCore
 
       void DetonationActor::OnRemovedFromWorld()
       {
+         mDetonating = false;
+         mLoadedImpact = -1;
+
          if(mSound.valid())
          {
             dtAudio::AudioManager::GetInstance().FreeSound(mSound.get());
             RemoveChild(mSound.get());
             mSound = NULL;
          }
+
+         if(mPool.valid())
+         {
+            mPool->Remove(GetUniqueId());
+            mPool = NULL;
+         }
       }
 
       ///////////////////////////////////////////////////////////////////////
@@ -278,6 +287,31 @@ namespace SimCore
             RegisterParticleSystem( *mSmokeSystem, &attrs );
          }
 
+         // Pooled detonations wait in the world with their effects loaded until they are used.
+         if(!mPool.valid())
+         {
+            Detonate();
+         }
+      }
+
+      ///////////////////////////////////////////////////////////////////////
+      void DetonationActor::Detonate()
+      {
+         dtGame::GameManager* gm = GetGameActorProxy().GetGameManager();
+         if(gm == NULL)
+         {
+            LOG_ERROR("Unable to detonate a detonation actor that is not in the game manager.");
+            return;
+         }
+
+         if(mDetonating)
+         {
+            StopDetonation();
+         }
+         mDetonating = true;
+
+         SetImpactEffects();
+
          if(!mCurrentLightName.empty())
          {
             AddDynamicLight(mCurrentLightName);
@@ -319,20 +353,85 @@ namespace SimCore
          ///////////////////////////////////////////////////////////////////////
 
          RenderDetonation();
-         GetGameActorProxy().GetGameManager()->SetTimer("ExplosionRendered", &GetGameActorProxy(), mRenderExplosionTimerSecs);
+         gm->SetTimer("PlayDetonationSoundTimer", &GetGameActorProxy(), mDelayTime);
+         gm->SetTimer("ExplosionRendered", &GetGameActorProxy(), mRenderExplosionTimerSecs);
+
+         float lifeTime = mRenderExplosionTimerSecs + mSmokeLifeTime + mDeleteActorTimerSecs;
+         if(mPool.valid())
+         {
+            gm->SetTimer("DetonationFinished", &GetGameActorProxy(), lifeTime);
+         }
+         else
+         {
+            // Register to delete after X time to make sure the detonation goes away when it should.
+            SimCore::Components::TimedDeleterComponent* timeDeleteComp;
+            gm->GetComponentByName(SimCore::Components::TimedDeleterComponent::DEFAULT_NAME,timeDeleteComp);
+            if(timeDeleteComp != NULL)
+            {
+               timeDeleteComp->AddId(GetUniqueId(), lifeTime);
+            }
+         }
+      }
+
+      ///////////////////////////////////////////////////////////////////////
+      void DetonationActor::StopDetonation()
+      {
+         mDetonating = false;
+
+         DetonationActorProxy* proxy = static_cast<DetonationActorProxy*>(&GetGameActorProxy());
+         if(proxy->GetGameManager() != NULL)
+         {
+            proxy->ClearTimers();
+         }
 
-         // Register to delete after X time to make sure the detonation goes away when it should.
-         SimCore::Components::TimedDeleterComponent* timeDeleteComp;
-         GetGameActorProxy().GetGameManager()->GetComponentByName(SimCore::Components::TimedDeleterComponent::DEFAULT_NAME,timeDeleteComp);
-         if(timeDeleteComp != NULL)
+         // Reset the emitters so the effects start from the beginning when detonated again.
+         mExplosionSystem->SetEnabled(false);
+         mExplosionSystem->ResetTime();
+         mSmokeSystem->SetEnabled(false);
+         mSmokeSystem->ResetTime();
+
+         if(mSound.valid() && mSound->IsPlaying())
          {
-            timeDeleteComp->AddId(GetUniqueId(), mRenderExplosionTimerSecs + mSmokeLifeTime + mDeleteActorTimerSecs);
+            mSound->Stop();
          }
+
+         RemoveDynamicLight();
+         mCollidedMaterial = NULL;
+      }
+
+      ///////////////////////////////////////////////////////////////////////
+      void DetonationActor::FinishDetonation()
+      {
+         // The pool may have been cleared while this was detonating, in which case it won't take it back.
+         if(!mPool.valid() || !mPool->Release(static_cast<DetonationActorProxy&>(GetGameActorProxy())))
+         {
+            StopDetonation();
+            GetGameActorProxy().GetGameManager()->DeleteActor(GetGameActorProxy());
+         }
+      }
+
+      ///////////////////////////////////////////////////////////////////////
+      void DetonationActor::SetPool(Components::DetonationActorPool* pool)
+      {
+         mPool = pool;
+      }
+
+      ///////////////////////////////////////////////////////////////////////
+      Components::DetonationActorPool* DetonationActor::GetPool()
+      {
+         return mPool.get();
       }
 
       ///////////////////////////////////////////////////////////////////////
       void DetonationActor::SetImpactEffects()
       {
+         // A pooled detonation keeps the effects it loaded the last time it was used.
+         if(mLoadedImpact == int(mCurrentImpact))
+         {
+            return;
+         }
+         mLoadedImpact = int(mCurrentImpact);
+
          //we first check what we collided with and select the appropriate particle system
          if(mCurrentImpact == IMPACT_ENTITY && !GetEntityImpactEffect().IsEmpty())
          {
@@ -525,9 +624,31 @@ namespace SimCore
             {
                SimCore::Components::RenderingSupportComponent::DynamicLight* dl =
                   renderComp->AddDynamicLightByPrototypeName(lightName);
-               dl->mTarget = this;
+               if(dl != NULL)
+               {
+                  dl->mTarget = this;
+                  mDynamicLightId = dl->GetId();
+               }
+            }
+         }
+      }
+
+      ///////////////////////////////////////////////////////////////////////
+      void DetonationActor::RemoveDynamicLight()
+      {
+         if(mDynamicLightId != 0 && GetGameActorProxy().GetGameManager() != NULL)
+         {
+            SimCore::Components::RenderingSupportComponent* renderComp;
+            GetGameActorProxy().GetGameManager()->GetComponentByName(
+                  SimCore::Components::RenderingSupportComponent::DEFAULT_NAME,
+                  renderComp);
+
+            if(renderComp != NULL)
+            {
+               renderComp->RemoveDynamicLight(mDynamicLightId);
             }
          }
+         mDynamicLightId = 0;
       }
 
       //////////////////////////////////////////////////////////////////////////
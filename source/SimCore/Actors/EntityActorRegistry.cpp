@@ -71,17 +71,28 @@
 
 #include <SimCore/Components/BaseGameAppComponent.h>
 #include <SimCore/Components/ControlStateComponent.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
+#include <SimCore/Components/ProfilerComponent.h>
+#include <SimCore/Components/WheelAnimationComponent.h>
+#include <SimCore/Components/PositionMarkerComponent.h>
+#include <SimCore/Components/TrailEffectBatchComponent.h>
+#include <SimCore/Components/NetworkCaptureComponent.h>
+#include <SimCore/Components/NetworkReplayComponent.h>
 #include <SimCore/Components/MunitionsComponent.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
+#include <SimCore/Components/PhysicsRayQueryComponent.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
+#include <SimCore/Components/StartupTraceComponent.h>
 #include <SimCore/Components/ViewerMaterialComponent.h>
 #include <SimCore/Components/PortalComponent.h>
 #include <SimCore/Components/TextureProjectorComponent.h>
 #include <SimCore/Components/WeatherComponent.h>
 #include <SimCore/Components/Conversations/ConversationComponent.h>
 #include <SimCore/Components/TimedDeleterComponent.h>
+#include <SimCore/Components/TerrainPhysicsPagingComponent.h>
+#include <SimCore/Components/WeaponEventAggregatorComponent.h>
 #include <SimCore/Components/BaseInputComponent.h>
 
 #include <SimCore/ActComps/AnimationClipActComp.h>
@@ -154,6 +165,66 @@ namespace SimCore
             dtGame::GMComponent::BaseGMComponentType));
       const std::string TimedDeleterComponent::DEFAULT_NAME(TimedDeleterComponent::TYPE->GetName());
 
+      const dtCore::RefPtr<dtCore::SystemComponentType> WeaponEventAggregatorComponent::TYPE(new dtCore::SystemComponentType("WeaponEventAggregatorComponent","GMComponents.SimCore",
+            "Sends the weapon fire and detonation events of a frame in one batch message.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string WeaponEventAggregatorComponent::DEFAULT_NAME(WeaponEventAggregatorComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> TerrainPhysicsPagingComponent::TYPE(new dtCore::SystemComponentType("TerrainPhysicsPagingComponent","GMComponents.SimCore",
+            "Loads the terrain tiles around physics entities into the physics engine.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string TerrainPhysicsPagingComponent::DEFAULT_NAME(TerrainPhysicsPagingComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> PhysicsRayQueryComponent::TYPE(new dtCore::SystemComponentType("PhysicsRayQueryComponent","GMComponents.SimCore",
+            "Runs the ray queries of a frame together as one batch.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string PhysicsRayQueryComponent::DEFAULT_NAME(PhysicsRayQueryComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> StartupTraceComponent::TYPE(new dtCore::SystemComponentType("StartupTraceComponent","GMComponents.SimCore",
+            "Records the map load in the startup trace and writes the trace file.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string StartupTraceComponent::DEFAULT_NAME(StartupTraceComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> FrameBudgetComponent::TYPE(new dtCore::SystemComponentType("FrameBudgetComponent","GMComponents.SimCore",
+            "Runs the deferrable work of each frame within a time budget, by priority.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string FrameBudgetComponent::DEFAULT_NAME(FrameBudgetComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> ProfilerComponent::TYPE(new dtCore::SystemComponentType("ProfilerComponent","GMComponents.SimCore",
+            "Collects the frame profiler records and sends the stats periodically.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string ProfilerComponent::DEFAULT_NAME(ProfilerComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> WheelAnimationComponent::TYPE(new dtCore::SystemComponentType("WheelAnimationComponent","GMComponents.SimCore",
+            "Turns the wheels of the remote vehicles in one pass, less often for far vehicles.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string WheelAnimationComponent::DEFAULT_NAME(WheelAnimationComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> PositionMarkerComponent::TYPE(new dtCore::SystemComponentType("PositionMarkerComponent","GMComponents.SimCore",
+            "Fades and deletes all the position markers in one pass every second.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string PositionMarkerComponent::DEFAULT_NAME(PositionMarkerComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> TrailEffectBatchComponent::TYPE(new dtCore::SystemComponentType("TrailEffectBatchComponent","GMComponents.SimCore",
+            "Owns the shared batch that draws all the ribbon trails with one geometry.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string TrailEffectBatchComponent::DEFAULT_NAME(TrailEffectBatchComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> NetworkCaptureComponent::TYPE(new dtCore::SystemComponentType("NetworkCaptureComponent","GMComponents.SimCore",
+            "Writes the messages that come in from the network to a capture file.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string NetworkCaptureComponent::DEFAULT_NAME(NetworkCaptureComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> NetworkReplayComponent::TYPE(new dtCore::SystemComponentType("NetworkReplayComponent","GMComponents.SimCore",
+            "Plays a network capture file back into the GM and measures the message throughput and latency.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string NetworkReplayComponent::DEFAULT_NAME(NetworkReplayComponent::TYPE->GetName());
+
+      const dtCore::RefPtr<dtCore::SystemComponentType> NetworkReplayProbeComponent::TYPE(new dtCore::SystemComponentType("NetworkReplayProbeComponent","GMComponents.SimCore",
+            "Tells the network replay component when the GM takes each replayed message off the queue.",
+            dtGame::GMComponent::BaseGMComponentType));
+      const std::string NetworkReplayProbeComponent::DEFAULT_NAME(NetworkReplayProbeComponent::TYPE->GetName());
+
 
       const dtCore::RefPtr<dtCore::SystemComponentType> VolumeRenderingComponent::TYPE(new dtCore::SystemComponentType("VolumeRenderingComponent","GMComponents.SimCore",
             "Rendering volumetric effects.",
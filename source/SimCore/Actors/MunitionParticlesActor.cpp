@@ -29,6 +29,7 @@
 #include <SimCore/Actors/EntityActorRegistry.h>
 #include <SimCore/Actors/WeaponActor.h>
 #include <SimCore/CollisionGroupEnum.h>
+#include <SimCore/FrameProfiler.h>
 
 #include <dtCore/enginepropertytypes.h>
 
@@ -39,6 +40,7 @@
 #include <dtCore/scene.h>
 #include <dtCore/transform.h>
 #include <dtUtil/mathdefines.h>
+#include <dtUtil/stringutils.h>
 
 #include <osg/Geode>
 #include <osg/Geometry>
@@ -53,6 +55,8 @@
 #include <dtPhysics/palutil.h>
 #include <pal/palCollision.h>
 
+#include <cmath>
+
 using namespace SimCore::CollisionGroup;
 
 namespace SimCore
@@ -64,6 +68,15 @@ namespace SimCore
       //////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+      // The groups a round can hit.
+      static const dtPhysics::CollisionGroupFilter MUNITION_HIT_GROUPS =
+         (1 << GROUP_TERRAIN)
+         | (1 << GROUP_WATER)
+         | (1 << GROUP_VEHICLE_GROUND)
+         | (1 << GROUP_VEHICLE_WATER)
+         | (1 << GROUP_HUMAN_LOCAL)
+         | (1 << GROUP_HUMAN_REMOTE);
+
       ///////////////////////////////////////////////////////////////////////////////////////////////////
       // This class is used to prevent self collision.
       //////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -244,12 +257,25 @@ namespace SimCore
          SetTracer(line);
       }
 
+      ////////////////////////////////////////////////////////////////////
+      BallisticRound::BallisticRound()
+      : mTimeLeft(0.0f)
+      , mHit(false)
+      {
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      const osg::Vec3 MunitionParticlesActor::BALLISTIC_GRAVITY(0.0f, 0.0f, -9.80665f);
+
       ////////////////////////////////////////////////////////////////////
       MunitionParticlesActor::MunitionParticlesActor(dtGame::GameActorProxy& owner)
       : PhysicsParticleSystemActor(owner)
+      , mUseBallisticSolver(false)
+      , mBallisticDrag(0.0f)
       , mUseTracers(false)
       , mCurrentTracerRoundNumber(0)
       , mFrequencyOfTracers(10)
+      , mNextPendingHitRound(0)
       {
       }
 
@@ -258,11 +284,26 @@ namespace SimCore
       {
       }
 
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::OnEnteredWorld()
+      {
+         PhysicsParticleSystemActor::OnEnteredWorld();
+
+         SimCore::Components::PhysicsRayQueryComponent* rayQueryComp = NULL;
+         GetGameActorProxy().GetGameManager()->GetComponentByName(SimCore::Components::PhysicsRayQueryComponent::DEFAULT_NAME, rayQueryComp);
+         mRayQueryComponent = rayQueryComp;
+      }
+
       ////////////////////////////////////////////////////////////////////
       void MunitionParticlesActor::OnTickLocal(const dtGame::TickMessage& tickMessage)
       {
          float ElapsedTime = tickMessage.GetDeltaSimTime();
 
+         if (!mBallisticRounds.empty())
+         {
+            UpdateBallisticRounds(ElapsedTime);
+         }
+
          ParticleList::iterator iter = mOurParticleList.begin();
          for (;iter!= mOurParticleList.end();)
          {
@@ -312,17 +353,8 @@ namespace SimCore
 
                MunitionRaycastReport report(mWeapon.valid() && mWeapon->GetOwner() != NULL ? mWeapon->GetOwner()->GetDrawable() : NULL);
 
-               // CR: Create the bit mask once rather than every time the method is called.
-               static const dtPhysics::CollisionGroupFilter GROUPS_FLAGS =
-                  (1 << GROUP_TERRAIN)
-                  | (1 << GROUP_WATER)
-                  | (1 << GROUP_VEHICLE_GROUND)
-                  | (1 << GROUP_VEHICLE_WATER)
-                  | (1 << GROUP_HUMAN_LOCAL)
-                  | (1 << GROUP_HUMAN_REMOTE);
-
                // TODO fix collision groups.
-               ray.SetCollisionGroupFilter(GROUPS_FLAGS);
+               ray.SetCollisionGroupFilter(MUNITION_HIT_GROUPS);
 
                dtPhysics::PhysicsWorld::GetInstance().TraceRay(ray, report);
                if (report.mGotAHit)
@@ -365,6 +397,270 @@ namespace SimCore
          AddParticle();
       }
 
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::AdvanceBallisticRounds(BallisticRoundList& rounds, const osg::Vec3& gravity, float drag, float dt)
+      {
+         if (dt <= 0.0f)
+         {
+            return;
+         }
+
+         // With linear drag the velocity relaxes exponentially toward the terminal velocity gravity / drag:
+         //   v(t) = vt + (v0 - vt) e^(-drag t)
+         //   p(t) = p0 + vt t + (v0 - vt) (1 - e^(-drag t)) / drag
+         // The factors are the same for every round, so the loop is just multiply adds.
+         float velocityScale = 1.0f;
+         float positionScale = dt;
+         osg::Vec3 terminalVelocity;
+         osg::Vec3 gravityOffset = gravity * (0.5f * dt * dt);
+         if (drag > 0.0f)
+         {
+            velocityScale = std::exp(-drag * dt);
+            positionScale = (1.0f - velocityScale) / drag;
+            terminalVelocity = gravity / drag;
+            gravityOffset = terminalVelocity * dt;
+         }
+
+         const unsigned numRounds = unsigned(rounds.size());
+         for (unsigned i = 0; i < numRounds; ++i)
+         {
+            BallisticRound& round = rounds[i];
+            round.mLastPosition = round.mPosition;
+            if (drag > 0.0f)
+            {
+               osg::Vec3 relativeVelocity = round.mVelocity - terminalVelocity;
+               round.mPosition += gravityOffset + relativeVelocity * positionScale;
+               round.mVelocity = terminalVelocity + relativeVelocity * velocityScale;
+            }
+            else
+            {
+               round.mPosition += round.mVelocity * positionScale + gravityOffset;
+               round.mVelocity += gravity * dt;
+            }
+            round.mTimeLeft -= dt;
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::RemoveSpentRounds()
+      {
+         unsigned numKept = 0;
+         const unsigned numRounds = unsigned(mBallisticRounds.size());
+         for (unsigned i = 0; i < numRounds; ++i)
+         {
+            BallisticRound& round = mBallisticRounds[i];
+            if (round.mHit || round.mTimeLeft <= 0.0f)
+            {
+               if (round.mTracer.valid())
+               {
+                  RemoveChild(round.mTracer->mObj.get());
+                  round.mTracer = NULL;
+               }
+               continue;
+            }
+
+            if (numKept != i)
+            {
+               mBallisticRounds[numKept] = round;
+               round.mTracer = NULL;
+            }
+            ++numKept;
+         }
+         mBallisticRounds.resize(numKept);
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::ClearBallisticRounds()
+      {
+         for (unsigned i = 0; i < mBallisticRounds.size(); ++i)
+         {
+            mBallisticRounds[i].mHit = true;
+         }
+         RemoveSpentRounds();
+         mPendingHitRounds.clear();
+         mNextPendingHitRound = 0;
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::UpdateBallisticRounds(float dt)
+      {
+         SIMCORE_PROFILE_SCOPE("MunitionParticlesActor::UpdateBallisticRounds");
+
+         // The hits of last frame's segments have all come back by now, so the indices can change.
+         RemoveSpentRounds();
+         mPendingHitRounds.clear();
+         mNextPendingHitRound = 0;
+
+         osg::Vec3 gravity = mGravityEnabled ? BALLISTIC_GRAVITY : osg::Vec3();
+         AdvanceBallisticRounds(mBallisticRounds, gravity, mBallisticDrag, dt);
+
+         const unsigned numRounds = unsigned(mBallisticRounds.size());
+         for (unsigned i = 0; i < numRounds; ++i)
+         {
+            BallisticRound& round = mBallisticRounds[i];
+            if (round.mTracer.valid())
+            {
+               // Point the tracer along the direction of travel.
+               dtCore::Transform xform;
+               xform.Set(round.mPosition, round.mPosition + round.mVelocity, osg::Vec3(0.0f, 0.0f, 1.0f));
+               round.mTracer->mObj->SetTransform(xform);
+               round.mTracer->SetLastPosition(round.mPosition);
+            }
+         }
+
+         if (!mWeapon.valid())
+         {
+            return;
+         }
+
+         dtPhysics::RayCast ray;
+         ray.SetCollisionGroupFilter(MUNITION_HIT_GROUPS);
+         for (unsigned i = 0; i < numRounds; ++i)
+         {
+            const BallisticRound& round = mBallisticRounds[i];
+            if (round.mTimeLeft <= 0.0f || dtUtil::Equivalent(round.mPosition, round.mLastPosition, 1e-5f))
+            {
+               continue;
+            }
+
+            ray.SetOrigin(round.mLastPosition);
+            ray.SetDirection(round.mPosition - round.mLastPosition);
+            if (mRayQueryComponent.valid())
+            {
+               mPendingHitRounds.push_back(i);
+               mRayQueryComponent->SubmitPhysicsQuery(ray,
+                  SimCore::Components::PhysicsRayQueryComponent::QueryCallback(this, &MunitionParticlesActor::OnBallisticRoundHits), this);
+            }
+            else
+            {
+               dtPhysics::PhysicsWorld::GetInstance().TraceRay(ray, mHits, true);
+               ResolveBallisticHits(i, mHits);
+            }
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::OnBallisticRoundHits(const SimCore::Components::PhysicsRayQueryComponent::HitList& hits)
+      {
+         if (mNextPendingHitRound >= mPendingHitRounds.size())
+         {
+            return;
+         }
+
+         unsigned roundIndex = mPendingHitRounds[mNextPendingHitRound];
+         ++mNextPendingHitRound;
+         ResolveBallisticHits(roundIndex, hits);
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::ResolveBallisticHits(unsigned roundIndex, const SimCore::Components::PhysicsRayQueryComponent::HitList& hits)
+      {
+         if (hits.empty() || roundIndex >= mBallisticRounds.size() || !mWeapon.valid())
+         {
+            return;
+         }
+
+         dtCore::DeltaDrawable* ownerDrawable = mWeapon->GetOwner() != NULL ? mWeapon->GetOwner()->GetDrawable() : NULL;
+
+         // The hits are sorted by distance, so the first one that isn't the owner is the closest.
+         SimCore::Components::PhysicsRayQueryComponent::HitList::const_iterator i, iend;
+         i = hits.begin();
+         iend = hits.end();
+         for (; i != iend; ++i)
+         {
+            const dtPhysics::RayCast::Report& hit = *i;
+            dtPhysics::PhysicsObject* physObject = hit.mHasHitObject ? hit.mHitObject.get() : NULL;
+            if (physObject == NULL || !physObject->IsCollisionResponseEnabled())
+            {
+               continue;
+            }
+
+            dtGame::GameActorProxy* hitActor = NULL;
+            dtPhysics::PhysicsActComp* physActComp = dynamic_cast<dtPhysics::PhysicsActComp*>(physObject->GetUserData());
+            if (physActComp != NULL)
+            {
+               physActComp->GetOwner(hitActor);
+            }
+
+            if (ownerDrawable != NULL && hitActor != NULL && hitActor->GetDrawable() == ownerDrawable)
+            {
+               continue;
+            }
+
+            BallisticRound& round = mBallisticRounds[roundIndex];
+            round.mHit = true;
+            round.mPosition = hit.mHitPos;
+
+            dtPhysics::CollisionContact contactReport;
+            contactReport.mNormal = hit.mHitNormal;
+            contactReport.mPosition = hit.mHitPos;
+            contactReport.mDistance = hit.mDistance;
+            mWeapon->ReceiveContactReport(contactReport, hitActor);
+            return;
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////
+      void MunitionParticlesActor::AddBallisticRound()
+      {
+         bool isTracer = GetSystemToUseTracers() && mCurrentTracerRoundNumber >= mFrequencyOfTracers;
+         if (GetSystemToUseTracers())
+         {
+            ++mCurrentTracerRoundNumber;
+            if (isTracer)
+            {
+               mCurrentTracerRoundNumber = 0;
+            }
+         }
+
+         dtCore::Transform ourTransform;
+         GetTransform(ourTransform);
+
+         osg::Vec3 xyz;
+         ourTransform.GetTranslation(xyz);
+         osg::Matrix ourRotationMatrix;
+         ourTransform.GetRotation(ourRotationMatrix);
+
+         osg::Vec3 positionRandMax = ourRotationMatrix.preMult(mStartingPositionRandMax);
+         osg::Vec3 positionRandMin = ourRotationMatrix.preMult(mStartingPositionRandMin);
+
+         mBallisticRounds.push_back(BallisticRound());
+         BallisticRound& round = mBallisticRounds.back();
+         round.mPosition.set(GetRandBetweenTwoFloats(xyz[0] + positionRandMax[0], xyz[0] + positionRandMin[0]),
+                  GetRandBetweenTwoFloats(xyz[1] + positionRandMax[1], xyz[1] + positionRandMin[1]),
+                  GetRandBetweenTwoFloats(xyz[2] + positionRandMax[2], xyz[2] + positionRandMin[2]));
+         round.mLastPosition = round.mPosition;
+         round.mTimeLeft = mParticleLengthOfStay;
+
+         osg::Vec3 linearVelocities;
+         linearVelocities[0] = GetRandBetweenTwoFloats(mStartingLinearVelocityScaleMax[0], mStartingLinearVelocityScaleMin[0]);
+         linearVelocities[1] = GetRandBetweenTwoFloats(mStartingLinearVelocityScaleMax[1], mStartingLinearVelocityScaleMin[1]);
+         linearVelocities[2] = GetRandBetweenTwoFloats(mStartingLinearVelocityScaleMax[2], mStartingLinearVelocityScaleMin[2]);
+         round.mVelocity = ourRotationMatrix.preMult(linearVelocities) + mParentsWorldRelativeVelocityVector;
+
+         if (isTracer)
+         {
+            SimCore::Components::RenderingSupportComponent* renderComp = NULL;
+            GetGameActorProxy().GetGameManager()->GetComponentByName(
+                     SimCore::Components::RenderingSupportComponent::DEFAULT_NAME,
+                     renderComp);
+
+            // The name only has to be unique within this system, so it doesn't need a unique id.
+            std::string name = GetName() + " Round " + dtUtil::ToString(mAmountOfParticlesThatHaveSpawnedTotal);
+            round.mTracer = new MunitionsPhysicsParticle(renderComp, name, mParticleLengthOfStay);
+            round.mTracer->mObj = new dtCore::Transformable(name);
+            round.mTracer->CreateTracer();
+            round.mTracer->SetInitialPosition(round.mPosition);
+
+            dtCore::Transform xform;
+            xform.Set(round.mPosition, round.mPosition + round.mVelocity, osg::Vec3(0.0f, 0.0f, 1.0f));
+            round.mTracer->mObj->SetTransform(xform);
+            AddChild(round.mTracer->mObj.get());
+         }
+
+         ++mAmountOfParticlesThatHaveSpawnedTotal;
+      }
+
       ////////////////////////////////////////////////////////////////////
       void MunitionParticlesActor::AddParticle()
       {
@@ -373,6 +669,12 @@ namespace SimCore
             LOG_ERROR("Firing when the actor is being deleted.");
          }
 
+         if (mUseBallisticSolver)
+         {
+            AddBallisticRound();
+            return;
+         }
+
          bool isTracer = GetSystemToUseTracers() && mCurrentTracerRoundNumber >= mFrequencyOfTracers;
 
          //we obtain the rendering support component so that the particle effect can add a dynamic light effect
@@ -598,6 +900,16 @@ namespace SimCore
                   dtCore::BooleanActorProperty::SetFuncType(drawable, &MunitionParticlesActor::SetSystemToUseTracers),
                   dtCore::BooleanActorProperty::GetFuncType(drawable, &MunitionParticlesActor::GetSystemToUseTracers),
                   "", GROUP));
+
+         AddProperty(new dtCore::BooleanActorProperty("UseBallisticSolver", "Use Ballistic Solver",
+                  dtCore::BooleanActorProperty::SetFuncType(drawable, &MunitionParticlesActor::SetUseBallisticSolver),
+                  dtCore::BooleanActorProperty::GetFuncType(drawable, &MunitionParticlesActor::GetUseBallisticSolver),
+                  "Moves the rounds along their ballistic path without a physics body each.  Only tracers get visuals.", GROUP));
+
+         AddProperty(new dtCore::FloatActorProperty("BallisticDrag", "Ballistic Drag",
+                  dtCore::FloatActorProperty::SetFuncType(drawable, &MunitionParticlesActor::SetBallisticDrag),
+                  dtCore::FloatActorProperty::GetFuncType(drawable, &MunitionParticlesActor::GetBallisticDrag),
+                  "The linear drag of the ballistic rounds in 1/s.", GROUP));
       }
 
       ////////////////////////////////////////////////////////////////////
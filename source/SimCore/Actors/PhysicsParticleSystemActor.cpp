@@ -29,6 +29,7 @@
 #include <SimCore/Actors/EntityActorRegistry.h>
 #include <SimCore/Actors/IGActor.h>
 #include <SimCore/CollisionGroupEnum.h>
+#include <SimCore/Components/ParticleManagerComponent.h>
 
 #include <dtCore/scene.h>
 #include <dtCore/uniqueid.h>
@@ -415,6 +416,14 @@ namespace SimCore
             LOG_WARNING("You need to set your collision group to something other than 0 for the particle system, its going to give you an issue and not act correctly.");
          }
 
+         // Register for the wind.  The particle manager drops it when the actor is deleted.
+         SimCore::Components::ParticleManagerComponent* particleComp = NULL;
+         GetGameActorProxy().GetGameManager()->GetComponentByName(
+                  SimCore::Components::ParticleManagerComponent::DEFAULT_NAME, particleComp);
+         if (particleComp != NULL)
+         {
+            particleComp->RegisterPhysicsParticles(*this);
+         }
       }
 
       ////////////////////////////////////////////////////////////////////
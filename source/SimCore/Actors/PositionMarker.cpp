@@ -1,6 +1,7 @@
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/Actors/PositionMarker.h>
 #include <SimCore/VisibilityOptions.h>
+#include <SimCore/Components/PositionMarkerComponent.h>
 
 #include <dtGame/basemessages.h>
 #include <dtGame/invokable.h>
@@ -9,6 +10,7 @@
 
 
 #include <dtCore/enginepropertytypes.h>
+#include <dtCore/observerptr.h>
 #include <dtCore/project.h>
 
 #include <dtUtil/functor.h>
@@ -23,12 +25,39 @@
 
 #include <osgDB/ReadFile>
 
+#include <map>
+
 namespace SimCore
 {
    namespace Actors
    {
       ////////////////////////////////////////////////////////////////////////
       const std::string PositionMarker::COLOR_UNIFORM("forceColor");
+      const std::string PositionMarker::MESH_RESOURCE("StaticMeshes:Hemisphere.ive");
+      const osg::Vec3 PositionMarker::MESH_OFFSET(0.0, 0.0, 3.0);
+
+      ////////////////////////////////////////////////////////////////////////
+      // The icon textures by file name.  They are only held by the markers using them, so a texture
+      // is freed when the last marker with that icon goes away.
+      typedef std::map<std::string, dtCore::ObserverPtr<osg::Texture2D> > IconTextureMap;
+      static IconTextureMap& GetIconTextureMap()
+      {
+         static IconTextureMap iconTextures;
+         return iconTextures;
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      // All the markers blend the same way, so they share the blend function.
+      static osg::BlendFunc* GetSharedBlendFunc()
+      {
+         static dtCore::RefPtr<osg::BlendFunc> blendFunc;
+         if (!blendFunc.valid())
+         {
+            blendFunc = new osg::BlendFunc();
+            blendFunc->setFunction( osg::BlendFunc::SRC_ALPHA ,osg::BlendFunc::ONE_MINUS_SRC_ALPHA );
+         }
+         return blendFunc.get();
+      }
 
       ////////////////////////////////////////////////////////////////////////
       PositionMarker::PositionMarker(dtGame::GameActorProxy& owner)
@@ -46,9 +75,10 @@ namespace SimCore
          , mOpposingColor(1.0, 0.1, 0.1, 1.0)
          , mOtherColor(0.5, 0.5, 0.5, 1.0)
          , mStaleColor(0.6, 0.6, 0.6, 1.0)
+         , mMeshVisible(true)
       {
          dtCore::RefPtr<osg::Node> original, copied;
-         std::string resourceDesc("StaticMeshes:Hemisphere.ive");
+         const std::string& resourceDesc = MESH_RESOURCE;
          std::string filename = dtCore::Project::GetInstance().GetResourcePath(resourceDesc);
          if(!filename.empty())
          {
@@ -64,16 +94,15 @@ namespace SimCore
          dtCore::RefPtr<osg::MatrixTransform> mt = new osg::MatrixTransform();
          mt->addChild(copied.get());
          osg::Matrix m;
-         m.setTrans(osg::Vec3(0.0, 0.0, 3.0));
+         m.setTrans(MESH_OFFSET);
          mt->setMatrix(m);
          osg::Group* g = GetOSGNode()->asGroup();
          g->addChild(mt.get());
+         mMeshNode = mt;
 
          osg::StateSet* ss = g->getOrCreateStateSet();
          ss->setMode(GL_BLEND,osg::StateAttribute::ON);
-         dtCore::RefPtr<osg::BlendFunc> trans = new osg::BlendFunc();
-         trans->setFunction( osg::BlendFunc::SRC_ALPHA ,osg::BlendFunc::ONE_MINUS_SRC_ALPHA );
-         ss->setAttributeAndModes(trans.get());
+         ss->setAttributeAndModes(GetSharedBlendFunc());
          ss->setRenderingHint( osg::StateSet::TRANSPARENT_BIN );
 
          //Need to call the current incarnation to make it set the color.
@@ -247,29 +276,46 @@ namespace SimCore
       ////////////////////////////////////////////////////////////////////////
       float PositionMarker::CalculateCurrentAlpha() const
       {
-         float fadeOutFraction = CalculateFadeOutFraction();
+         return CalculateCurrentAlpha(GetGameActorProxy().GetGameManager()->GetSimulationTime());
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      float PositionMarker::CalculateCurrentAlpha(double simTime) const
+      {
+         float fadeOutFraction = CalculateFadeOutFraction(simTime);
          float alpha = mInitialAlpha - (fadeOutFraction * fadeOutFraction);
          return alpha;
       }
 
       ////////////////////////////////////////////////////////////////////////
       osg::Vec3 PositionMarker::CalculateCurrentColor() const
+      {
+         return CalculateCurrentColor(GetGameActorProxy().GetGameManager()->GetSimulationTime());
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      osg::Vec3 PositionMarker::CalculateCurrentColor(double simTime) const
       {
          osg::Vec3 staleVec3(mStaleColor.x(), mStaleColor.y(), mStaleColor.z());
          osg::Vec3 colorDiff = staleVec3 - mInitialColor;
-         float fadeOutFraction = CalculateStaleFraction();
+         float fadeOutFraction = CalculateStaleFraction(simTime);
          colorDiff *= fadeOutFraction;
          return mInitialColor + colorDiff;
       }
 
       ////////////////////////////////////////////////////////////////////////
       float PositionMarker::CalculateFadeOutFraction() const
+      {
+         return CalculateFadeOutFraction(GetGameActorProxy().GetGameManager()->GetSimulationTime());
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      float PositionMarker::CalculateFadeOutFraction(double simTime) const
       {
          if (GetFadeOutTime() <= 0.0)
          {
             return 0.0;
          }
-         double simTime = GetGameActorProxy().GetGameManager()->GetSimulationTime();
          float ageOfMarker = simTime - GetReportTime();
          float fadeOutFraction = ageOfMarker / (double(GetFadeOutTime()) * 60.0);
          dtUtil::Clamp(fadeOutFraction, 0.0f, 1.0f);
@@ -278,12 +324,17 @@ namespace SimCore
 
       ////////////////////////////////////////////////////////////////////////
       float PositionMarker::CalculateStaleFraction() const
+      {
+         return CalculateStaleFraction(GetGameActorProxy().GetGameManager()->GetSimulationTime());
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      float PositionMarker::CalculateStaleFraction(double simTime) const
       {
          if (GetStaleTime() <= 0.0)
          {
             return 0.0;
          }
-         double simTime = GetGameActorProxy().GetGameManager()->GetSimulationTime();
          float ageOfMarker = simTime - GetReportTime();
          float fadeOutFraction = ageOfMarker / (double(GetStaleTime()) * 60.0);;
          dtUtil::Clamp(fadeOutFraction, 0.0f, 1.0f);
@@ -312,22 +363,43 @@ namespace SimCore
       ////////////////////////////////////////////////////////////////////////
       void PositionMarker::SetCurrentColorUniform(const osg::Vec4& vec)
       {
-         osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
-         osg::Uniform* uniform = ss->getOrCreateUniform(COLOR_UNIFORM, osg::Uniform::FLOAT_VEC4, 1);
-         uniform->setDataVariance(osg::Object::DYNAMIC);
-         uniform->set(vec);
+         if (!mColorUniform.valid())
+         {
+            osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
+            mColorUniform = ss->getOrCreateUniform(COLOR_UNIFORM, osg::Uniform::FLOAT_VEC4, 1);
+            mColorUniform->setDataVariance(osg::Object::DYNAMIC);
+         }
+         mColorUniform->set(vec);
       }
 
       ////////////////////////////////////////////////////////////////////////
       osg::Vec4 PositionMarker::GetCurrentColorUniform()
       {
-         osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
-         osg::Uniform* uniform = ss->getOrCreateUniform(COLOR_UNIFORM, osg::Uniform::FLOAT_VEC4, 1);
          osg::Vec4 returnVal;
-         uniform->get(returnVal);
+         if (mColorUniform.valid())
+         {
+            mColorUniform->get(returnVal);
+         }
+         else
+         {
+            osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
+            ss->getOrCreateUniform(COLOR_UNIFORM, osg::Uniform::FLOAT_VEC4, 1)->get(returnVal);
+         }
          return returnVal;
       }
 
+      ////////////////////////////////////////////////////////////////////////
+      bool PositionMarker::UpdateFade(double simTime)
+      {
+         if (GetDeleteOnFadeOut() && CalculateFadeOutFraction(simTime) >= 1.0)
+         {
+            return true;
+         }
+
+         SetCurrentColorUniform(osg::Vec4(CalculateCurrentColor(simTime), CalculateCurrentAlpha(simTime)));
+         return false;
+      }
+
       ////////////////////////////////////////////////////////////////////////
       void PositionMarker::SetFriendlyColor(const osg::Vec4& vec)
       {
@@ -402,22 +474,64 @@ namespace SimCore
             return;
          }
 
-         dtCore::RefPtr<osg::Image> icon  = osgDB::readImageFile( theFile );
-         if(icon == NULL)
+         dtCore::RefPtr<osg::Texture2D> tex = GetIconTexture(theFile);
+         if (!tex.valid())
          {
-            LOG_ERROR(std::string("Couldn't find image file \"") + theFile + "\"");
             osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
             ss->setTextureAttributeAndModes(0, NULL, osg::StateAttribute::OFF);
             return;
          }
 
-         dtCore::RefPtr<osg::Texture2D> tex = new osg::Texture2D;
+         osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
+         ss->setTextureAttributeAndModes(0, tex.get(), osg::StateAttribute::ON);
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<osg::Texture2D> PositionMarker::GetIconTexture(const std::string& theFile)
+      {
+         IconTextureMap& iconTextures = GetIconTextureMap();
+         dtCore::ObserverPtr<osg::Texture2D>& cached = iconTextures[theFile];
+         dtCore::RefPtr<osg::Texture2D> tex = cached.get();
+         if (tex.valid())
+         {
+            return tex;
+         }
+
+         dtCore::RefPtr<osg::Image> icon  = osgDB::readImageFile( theFile );
+         if(icon == NULL)
+         {
+            LOG_ERROR(std::string("Couldn't find image file \"") + theFile + "\"");
+            iconTextures.erase(theFile);
+            return NULL;
+         }
+
+         tex = new osg::Texture2D;
          tex->setWrap( osg::Texture::WRAP_S, osg::Texture::CLAMP );
          tex->setWrap( osg::Texture::WRAP_T, osg::Texture::CLAMP );
          tex->setImage( icon.get() );
+         cached = tex.get();
+         return tex;
+      }
 
-         osg::StateSet* ss = GetOSGNode()->getOrCreateStateSet();
-         ss->setTextureAttributeAndModes(0, tex.get(), osg::StateAttribute::ON);
+      ////////////////////////////////////////////////////////////////////////
+      unsigned PositionMarker::GetNumIconTextures()
+      {
+         IconTextureMap& iconTextures = GetIconTextureMap();
+         unsigned count = 0;
+         IconTextureMap::iterator i = iconTextures.begin();
+         while (i != iconTextures.end())
+         {
+            if (i->second.valid())
+            {
+               ++count;
+               ++i;
+            }
+            else
+            {
+               iconTextures.erase(i++);
+            }
+         }
+         return count;
       }
 
       ////////////////////////////////////////////////////////////////////////
@@ -426,11 +540,21 @@ namespace SimCore
          BaseClass::OnEnteredWorld();
          //RegisterWithDeadReckoningComponent(); // moved to base class
          // Register always.  this could be revisited, but the logic is somewhat complex;
-         GetGameActorProxy().RegisterForMessagesAboutSelf(
-                  dtGame::MessageType::INFO_TIMER_ELAPSED,
-                  PositionMarkerActorProxy::INVOKABLE_TIME_ELAPSED);
+         SimCore::Components::PositionMarkerComponent* markerComp = NULL;
+         GetGameActorProxy().GetGameManager()->GetComponentByName(
+                  SimCore::Components::PositionMarkerComponent::DEFAULT_NAME, markerComp);
+         if (markerComp != NULL)
+         {
+            markerComp->RegisterMarker(*this);
+         }
+         else
+         {
+            GetGameActorProxy().RegisterForMessagesAboutSelf(
+                     dtGame::MessageType::INFO_TIMER_ELAPSED,
+                     PositionMarkerActorProxy::INVOKABLE_TIME_ELAPSED);
 
-         GetGameActorProxy().GetGameManager()->SetTimer(__FILE__, &GetGameActorProxy(), 8.0, true, true);
+            GetGameActorProxy().GetGameManager()->SetTimer(__FILE__, &GetGameActorProxy(), 8.0, true, true);
+         }
 
          SetCurrentColorUniform(osg::Vec4(CalculateCurrentColor(), CalculateCurrentAlpha()));
       }
@@ -438,16 +562,12 @@ namespace SimCore
       ////////////////////////////////////////////////////////////////////////
       void PositionMarker::OnTimer(const dtGame::TimerElapsedMessage& timerElapsed)
       {
-         if (CalculateFadeOutFraction() >= 1.0 && GetDeleteOnFadeOut())
+         if (UpdateFade(GetGameActorProxy().GetGameManager()->GetSimulationTime()))
          {
             //Bug, this won't record properly.  The actor is remote, but it must time itself out.
             // I could probably send myself a delete message :-).
             GetGameActorProxy().GetGameManager()->DeleteActor(GetGameActorProxy());
          }
-         else
-         {
-            SetCurrentColorUniform(osg::Vec4(CalculateCurrentColor(), CalculateCurrentAlpha()));
-         }
       }
 
       ////////////////////////////////////////////////////////////////////////////////////
@@ -481,6 +601,19 @@ namespace SimCore
          || (basicOptions.mTracks && GetMappingName() != "Blip");
       }
 
+      ////////////////////////////////////////////////////////////////////////
+      void PositionMarker::SetMeshVisible(bool visible)
+      {
+         mMeshVisible = visible;
+         SetNodeVisible(visible, *mMeshNode);
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      bool PositionMarker::IsMeshVisible() const
+      {
+         return mMeshVisible;
+      }
+
       ////////////////////////////////////////////////////////////////////////
       ////////////////////////////////////////////////////////////////////////
       /////////////    Actor Proxy    ////////////////////////////////////////
@@ -23,7 +23,9 @@
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/Actors/TerrainActorProxy.h>
 #include <SimCore/CollisionGroupEnum.h>
+#include <SimCore/FIDCodeIndex.h>
 #include <SimCore/MessageType.h>
+#include <SimCore/StartupTracer.h>
 #include <dtCore/enginepropertytypes.h>
 #include <dtCore/actorproxyicon.h>
 #include <dtCore/project.h>
@@ -54,6 +56,7 @@
 #include <osgUtil/GLObjectsVisitor>
 
 #include <iostream>
+#include <sstream>
 
 #include <dtPhysics/physicsreaderwriter.h>
 #include <dtPhysics/geometry.h>
@@ -129,6 +132,20 @@ namespace SimCore
             dtCore::StringActorProperty::GetFuncType(ta, &TerrainActor::GetPhysicsDirectory),
             "The directory name of MULTIPLE physics model files to use for collision within the Terrains folder in your map project.", GROUP_));
 
+         static const dtUtil::RefString PROPERTY_ELEVATION_RASTER_ENABLED("ElevationRasterEnabled");
+         AddProperty(new dtCore::BooleanActorProperty(
+            PROPERTY_ELEVATION_RASTER_ENABLED, PROPERTY_ELEVATION_RASTER_ENABLED,
+            dtCore::BooleanActorProperty::SetFuncType(ta, &TerrainActor::SetElevationRasterEnabled),
+            dtCore::BooleanActorProperty::GetFuncType(ta, &TerrainActor::GetElevationRasterEnabled),
+            "Use a height raster sampled from the terrain for the ground clamping of Utils::KeepTransformOnGround over open terrain.  "
+            "Off by default, since sampling the terrain costs memory and startup time.", GROUP_));
+
+         static const dtUtil::RefString PROPERTY_ELEVATION_CACHE_DIRECTORY("ElevationCacheDirectory");
+         AddProperty(new dtCore::StringActorProperty(PROPERTY_ELEVATION_CACHE_DIRECTORY, PROPERTY_ELEVATION_CACHE_DIRECTORY,
+            dtCore::StringActorProperty::SetFuncType(ta, &TerrainActor::SetElevationCacheDirectory),
+            dtCore::StringActorProperty::GetFuncType(ta, &TerrainActor::GetElevationCacheDirectory),
+            "The directory within the Terrains folder in your map project to cache the terrain height raster in.  Empty caches nothing.", GROUP_));
+
       }
 
       /////////////////////////////////////////////////////////////////////////////
@@ -201,8 +218,10 @@ namespace SimCore
       TerrainActor::TerrainActor(dtGame::GameActorProxy& owner)
       : IGActor(owner)
       , mTerrainPhysicsMode(&SimCore::TerrainPhysicsMode::DEFERRED)
+      , mLoadStartTick(0)
       , mNeedToLoad(false)
       , mLoadTerrainMeshWithCaching(false)
+      , mElevationRasterEnabled(false)
       {
          SetName(DEFAULT_NAME);
       }
@@ -284,6 +303,8 @@ namespace SimCore
             return;
          }
 
+         SimCore::StartupTracer::Phase phase("Terrain Physics", "Terrain");
+
          if (mTerrainPhysicsMode == &SimCore::TerrainPhysicsMode::IMMEDIATE)
          {
             dtCore::Transform xform;
@@ -443,6 +464,12 @@ namespace SimCore
             {
                GetMatrixNode()->removeChild(0, GetMatrixNode()->getNumChildren());
             }
+            if (mTerrainNode.valid())
+            {
+               FIDCodeIndex::GetInstance().Remove(*mTerrainNode);
+               mTerrainNode = NULL;
+            }
+            mElevationRaster = NULL;
             // If the terrain changes, unload the physics.
             dtPhysics::PhysicsActComp* pac = NULL;
             GetComponent(pac);
@@ -468,6 +495,7 @@ namespace SimCore
 
                mLoadNodeTask->SetUseFileCaching(mLoadTerrainMeshWithCaching);
                mLoadNodeTask->SetFileToLoad(fileName);
+               mLoadStartTick = SimCore::StartupTracer::GetInstance().Tick();
 
                dtCore::RefPtr<osgDB::Options> options;
                if (!options.valid())
@@ -525,6 +553,10 @@ namespace SimCore
          // It is "complete" so wait to make sure the task clears the thread pool.
          mLoadNodeTask->WaitUntilComplete();
 
+         // Recorded here, on the main thread, since the load runs in the thread pool.
+         SimCore::StartupTracer& tracer = SimCore::StartupTracer::GetInstance();
+         tracer.RecordPhase("Terrain Mesh Load", "Terrain", mLoadStartTick, tracer.Tick());
+
          if (mLoadNodeTask->GetLoadedNode() != NULL)
          {
             mTerrainNode = mLoadNodeTask->GetLoadedNode();
@@ -538,6 +570,10 @@ namespace SimCore
             //osgUtil::GLObjectsVisitor nodeVisitor(osgUtil::GLObjectsVisitor::SWITCH_ON_VERTEX_BUFFER_OBJECTS);
             //mTerrainNode->accept(nodeVisitor);
             GetMatrixNode()->addChild(mTerrainNode.get());
+            SetupElevationRaster();
+
+            // Resolve the feature codes once now, rather than on every cull.
+            FIDCodeIndex::GetInstance().Compile(*mTerrainNode);
 
             if (!GetShaderGroup().empty())
             {
@@ -557,6 +593,76 @@ namespace SimCore
 
       }
 
+      ///////////////////////////////////////////////////////////////////
+      void TerrainActor::SetupElevationRaster()
+      {
+         mElevationRaster = NULL;
+         if (!mElevationRasterEnabled || !mTerrainNode.valid())
+         {
+            return;
+         }
+
+         mElevationRaster = new TerrainElevationRaster();
+         if (!mElevationCacheDirectory.empty())
+         {
+            try
+            {
+               mElevationRaster->SetCacheDirectory(dtCore::Project::GetInstance().GetContext() + "/Terrains/" + mElevationCacheDirectory);
+            }
+            catch (dtUtil::Exception& e)
+            {
+               e.LogException(dtUtil::Log::LOG_ERROR);
+            }
+
+            // The cache is only good for this version of the terrain file.
+            std::ostringstream key;
+            dtUtil::FileInfo info = dtUtil::FileUtils::GetInstance().GetFileInfo(mLoadedFile);
+            key << mLoadedFile << ' ' << info.size << ' ' << info.lastModified;
+            mElevationRaster->SetCacheKey(key.str());
+         }
+         // The tiles are sampled in world space, so sample from the actor's transform node.
+         mElevationRaster->SetTerrain(GetOSGNode());
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      void TerrainActor::SetElevationRasterEnabled(bool enable)
+      {
+         mElevationRasterEnabled = enable;
+         if (!enable)
+         {
+            mElevationRaster = NULL;
+         }
+         else if (!mElevationRaster.valid())
+         {
+            // Does nothing until the terrain has loaded.
+            SetupElevationRaster();
+         }
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      bool TerrainActor::GetElevationRasterEnabled() const
+      {
+         return mElevationRasterEnabled;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      void TerrainActor::SetElevationCacheDirectory(const std::string& dir)
+      {
+         mElevationCacheDirectory = dir;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      const std::string& TerrainActor::GetElevationCacheDirectory() const
+      {
+         return mElevationCacheDirectory;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+      TerrainElevationRaster* TerrainActor::GetElevationRaster()
+      {
+         return mElevationRaster.get();
+      }
+
       ///////////////////////////////////////////////////////////////////
       void TerrainActor::SetLoadTerrainMeshWithCaching(bool enable)
       {
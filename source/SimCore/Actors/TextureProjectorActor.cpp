@@ -51,6 +51,7 @@ namespace SimCore
          , mCurrentTime(0)
          , mMaxTime(5)
          , mCurrentAlpha(0)
+         , mProjecting(false)
       {
          mImageProjectorFile = "";
       }
@@ -65,17 +66,27 @@ namespace SimCore
       /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       void TextureProjectorActor::OnTickLocal(const dtGame::TickMessage& tickMessage)
       {
-         mCurrentTime +=
-            tickMessage.GetDeltaSimTime();
+         // Idle projectors waiting to be reused don't age.
+         if (mProjecting)
+         {
+            mCurrentTime +=
+               tickMessage.GetDeltaSimTime();
+         }
       }
       /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       void TextureProjectorActor::OnEnteredWorld()
+      {
+         Project();
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      bool TextureProjectorActor::Project()
       {
          if(mEntityToAttachTo == NULL)
          {
             LOG_ERROR("mEntityToAttachTo was null when TextureProjectorActor was\
-                      trying to OnEnteredWorld(), Bailing out");
-            return;
+                      trying to Project(), Bailing out");
+            return false;
          }
 
          Components::TextureProjectorComponent* tpComponent =
@@ -86,15 +97,26 @@ namespace SimCore
          {
             LOG_ERROR("Couldnt find texture projector component bailing out,\
                       make sure it was initialized first!");
-            return;
+            return false;
          }
 
-         osg::ref_ptr<osg::Image> spotImage  = osgDB::readImageFile( mImageProjectorFile );
-         if(spotImage == NULL)
+         // A reused projector usually shows the same image, so only load it if it changed.
+         if (!mTexture.valid() || mLoadedImageFile != mImageProjectorFile)
          {
-            LOG_ERROR("Couldnt find image file for the projectors image file.\
-                      Bailing out of function OnEnteredWorld()!");
-            return;
+            osg::ref_ptr<osg::Image> spotImage  = osgDB::readImageFile( mImageProjectorFile );
+            if(spotImage == NULL)
+            {
+               LOG_ERROR("Couldnt find image file for the projectors image file.\
+                         Bailing out of function Project()!");
+               return false;
+            }
+
+            mTexture = new osg::Texture2D;
+            mTexture->setWrap( osg::Texture::WRAP_S, osg::Texture::CLAMP );
+            mTexture->setWrap( osg::Texture::WRAP_T, osg::Texture::CLAMP );
+            mTexture->setImage( spotImage.get() );
+            mLoadedImageFile = mImageProjectorFile;
+            mProjector = NULL;
          }
 
          dtCore::Transform ourTransform;
@@ -107,11 +129,6 @@ namespace SimCore
          ourTransform.Set(currentPos, lookAtPos, osg::Vec3(0,0,1));
          ourTransform.Get(ourMatrix);
 
-         osg::ref_ptr<osg::Texture2D> tex    = new osg::Texture2D;
-         tex->setWrap( osg::Texture::WRAP_S, osg::Texture::CLAMP );
-         tex->setWrap( osg::Texture::WRAP_T, osg::Texture::CLAMP );
-         tex->setImage( spotImage.get() );
-
          //tx1->setMatrix(ourMatrix);
 
          //osg::ref_ptr<osg::MatrixTransform> tx2 = new osg::MatrixTransform;
@@ -122,10 +139,13 @@ namespace SimCore
          //osg::Quat quaterion;
          //quaterion.set(ourMatrix);
 
-         mProjector = new Projector(tex.get(), 2);
+         if (!mProjector.valid())
+         {
+            mProjector = new Projector(mTexture.get(), 2);
+            mProjector->setFOV(75 * (M_PI/180));
+         }
          mProjector->setPositionAndAttitude(ourMatrix);
          //mProjector->setPositionAndAttitude(ourTransform.GetTranslation(), quaterion);
-         mProjector->setFOV(75 * (M_PI/180));
          mProjector->on();
 
          //mProjector->setPositionAndAttitude(ourMatrix);
@@ -146,7 +166,26 @@ namespace SimCore
          //sset->setTextureMode( 1, GL_TEXTURE_GEN_Q, osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE );
          //mEntityToAttachTo->getParent(0)->addChild(sourceMatrix.get());
 
+         mProjecting = true;
          tpComponent->AddTextureProjectorActorToComponent(*this);
+         return true;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorActor::StopProjecting()
+      {
+         if (mProjector.valid())
+         {
+            mProjector->off();
+            if (mEntityToAttachTo.valid() && mEntityToAttachTo->getStateSet() == mProjector.get())
+            {
+               mEntityToAttachTo->setStateSet(NULL);
+            }
+         }
+
+         mEntityToAttachTo = NULL;
+         mCurrentTime = 0;
+         mProjecting = false;
       }
 
       ////////////////////////////////////////////////////////////////////
@@ -178,6 +178,21 @@ namespace SimCore
              materialComponent->RegisterAMaterialWithComponent(this);
        }
 
+      void ViewerMaterialActor::SetName(const std::string& name)
+      {
+         dtGame::GameActorProxy::SetName(name);
+
+         if (GetGameManager() != NULL)
+         {
+            SimCore::Components::ViewerMaterialComponent* materialComponent = NULL;
+            GetGameManager()->GetComponentByName(SimCore::Components::ViewerMaterialComponent::DEFAULT_NAME, materialComponent);
+            if (materialComponent != NULL)
+            {
+               materialComponent->OnMaterialRenamed(*this);
+            }
+         }
+      }
+
 
    }
 }
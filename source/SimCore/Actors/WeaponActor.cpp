@@ -48,6 +48,7 @@
 #include <SimCore/Messages.h>
 #include <SimCore/MessageType.h>
 #include <SimCore/Components/MunitionsComponent.h>
+#include <SimCore/Components/WeaponEventAggregatorComponent.h>
 
 #include <SimCore/Components/RenderingSupportComponent.h> //for dynamic lights
 
@@ -446,6 +447,11 @@ namespace SimCore
             // Attempt a reload
             LoadMunitionType( mMunitionTypeName );
          }
+
+         SimCore::Components::WeaponEventAggregatorComponent* aggregator = NULL;
+         GetGameActorProxy().GetGameManager()->GetComponentByName(
+            SimCore::Components::WeaponEventAggregatorComponent::DEFAULT_NAME, aggregator );
+         mEventAggregator = aggregator;
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -624,11 +630,8 @@ namespace SimCore
             }
          }
 
-         dtGame::GameManager* gm = GetGameActorProxy().GetGameManager();
-
-         // Prepare a shot fired message
-         dtCore::RefPtr<SimCore::ShotFiredMessage> msg;
-         gm->GetMessageFactory().CreateMessage( SimCore::MessageType::SHOT_FIRED, msg );
+         // Prepare a shot fired event
+         SimCore::WeaponEvent weaponEvent;
 
          // Get the location of this weapon
          dtCore::Transform xform;
@@ -640,19 +643,19 @@ namespace SimCore
 
          // Required Parameters:
          // --- EventIdentifier
-         msg->SetEventIdentifier( mMessageCount++ );
+         weaponEvent.mEventIdentifier = mMessageCount++;
          // --- FiringLocation
-         msg->SetFiringLocation( thisPos );
+         weaponEvent.mLocation = thisPos;
          // --- FiringObjectIdentifier
-         msg->SetSendingActorId( mOwner.valid() ? mOwner->GetId() : GetUniqueId() );
+         weaponEvent.mSendingActorId = mOwner.valid() ? mOwner->GetId() : GetUniqueId();
          // --- FuseType
-         msg->SetFuseType( (unsigned short) mMunitionType->GetFuseType() );
+         weaponEvent.mFuseType = (unsigned short) mMunitionType->GetFuseType();
          // --- WarheadType
-         msg->SetWarheadType( (unsigned short) mMunitionType->GetWarheadType() );
+         weaponEvent.mWarheadType = (unsigned short) mMunitionType->GetWarheadType();
          // --- MunitionType
-         msg->SetMunitionType( mMunitionType->GetName() );
+         weaponEvent.mMunitionType = mMunitionType->GetName();
          // --- InitialVelocityVector
-         msg->SetInitialVelocityVector( initialVelocity );
+         weaponEvent.mVelocity = initialVelocity;
 
          // Optional Parameters:
          // --- FireControlSolutionRange
@@ -662,15 +665,14 @@ namespace SimCore
          // --- MunitionObjectIdentifier
          // ? for Missiles ?
          // --- QuantityFired
-         msg->SetQuantityFired( quantity < 1 ? 1 : quantity );
+         weaponEvent.mQuantityFired = quantity < 1 ? 1 : quantity;
          // --- RateOfFire (rounds per minute)
          unsigned rate = mFireRate <= 0.0f ? 0 : (unsigned)(60.0f / mFireRate + 0.5f);
-         msg->SetRateOfFire( rate < 1 ? 1 : rate );
+         weaponEvent.mRateOfFire = rate < 1 ? 1 : rate;
          // --- TargetObjectIdentifier - for Direct Fire
-         if( target != NULL ) { msg->SetAboutActorId( target->GetUniqueId() ); }
+         if( target != NULL ) { weaponEvent.mTargetId = target->GetUniqueId(); }
 
-         gm->SendMessage(*msg);
-         gm->SendNetworkMessage(*msg);
+         SendWeaponEvent( weaponEvent );
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -690,54 +692,82 @@ namespace SimCore
             }
          }
 
-         dtGame::GameManager* gm = GetGameActorProxy().GetGameManager();
-
-         // Prepare a detonation message
-         dtCore::RefPtr<SimCore::DetonationMessage> msg;
-         gm->GetMessageFactory().CreateMessage(SimCore::MessageType::DETONATION, msg);
+         // Prepare a detonation event
+         SimCore::WeaponEvent weaponEvent;
+         weaponEvent.mIsDetonation = true;
 
          // Required Parameters:
          // --- EventIdentifier
-         msg->SetEventIdentifier( mMessageCount++ );
+         weaponEvent.mEventIdentifier = mMessageCount++;
          // --- DetonationLocation
-         msg->SetDetonationLocation( location );
+         weaponEvent.mLocation = location;
          // --- DetonationResultCode
             // 1 == Entity Impact
             // 3 == Ground Impact
             // 5 == Detonation
-            msg->SetDetonationResultCode( target != NULL ? 1 : 3 ); // TO BE DYNAMIC
+            weaponEvent.mDetonationResultCode = target != NULL ? 1 : 3; // TO BE DYNAMIC
          // --- MunitionType
-         msg->SetMunitionType( mMunitionType->GetName() );
+         weaponEvent.mMunitionType = mMunitionType->GetName();
          // --- FuseType
-         msg->SetFuseType( (unsigned short) mMunitionType->GetFuseType() );
+         weaponEvent.mFuseType = (unsigned short) mMunitionType->GetFuseType();
          // --- WarheadType
-         msg->SetWarheadType( (unsigned short) mMunitionType->GetWarheadType() );
+         weaponEvent.mWarheadType = (unsigned short) mMunitionType->GetWarheadType();
          // --- QuantityFired - number of rounds in a burst (ICM munitions)
-         msg->SetQuantityFired( quantity );
+         weaponEvent.mQuantityFired = quantity;
          // FiringObjectIdentifier
-         msg->SetSendingActorId( mOwner.valid() ? mOwner->GetId() : GetUniqueId() );
+         weaponEvent.mSendingActorId = mOwner.valid() ? mOwner->GetId() : GetUniqueId();
 
          // Direct Fire Parameters:
          if( target != NULL )
          {
             // TargetObjectIdentifier
-            msg->SetAboutActorId( target->GetUniqueId() );
+            weaponEvent.mTargetId = target->GetUniqueId();
             // RelativeDetonationLocation
             dtCore::Transform xform;
             target->GetTransform( xform );
             osg::Vec3 targetTrans;
             xform.GetTranslation(targetTrans);
-            msg->SetRelativeDetonationLocation( location - targetTrans);
+            weaponEvent.mRelativeDetonationLocation = location - targetTrans;
          }
 
          // Optional Parameters:
          // FinalVelocityVector
-         msg->SetFinalVelocityVector( finalVelocity );
+         weaponEvent.mVelocity = finalVelocity;
          // MunitionObjectIdentifier
          // ? for Missiles ?
          // RateOfFire (rounds per minute)
          unsigned rate = mFireRate <= 0.0f ? 0 : (unsigned)(60.0f / mFireRate + 0.5f);
-         msg->SetRateOfFire( rate < 1 ? 1 : rate );
+         weaponEvent.mRateOfFire = rate < 1 ? 1 : rate;
+
+         SendWeaponEvent( weaponEvent );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponActor::SendWeaponEvent( const SimCore::WeaponEvent& weaponEvent )
+      {
+         if( mEventAggregator.valid() )
+         {
+            mEventAggregator->QueueEvent( weaponEvent );
+            return;
+         }
+
+         dtGame::GameManager* gm = GetGameActorProxy().GetGameManager();
+
+         dtCore::RefPtr<SimCore::BaseWeaponEventMessage> msg;
+         if( weaponEvent.mIsDetonation )
+         {
+            dtCore::RefPtr<SimCore::DetonationMessage> detMsg;
+            gm->GetMessageFactory().CreateMessage( SimCore::MessageType::DETONATION, detMsg );
+            weaponEvent.FillDetonationMessage( *detMsg );
+            msg = detMsg.get();
+         }
+         else
+         {
+            dtCore::RefPtr<SimCore::ShotFiredMessage> shotMsg;
+            gm->GetMessageFactory().CreateMessage( SimCore::MessageType::SHOT_FIRED, shotMsg );
+            weaponEvent.FillShotFiredMessage( *shotMsg );
+            msg = shotMsg.get();
+         }
 
          gm->SendMessage( *msg );
          gm->SendNetworkMessage( *msg );
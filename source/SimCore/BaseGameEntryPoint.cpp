@@ -30,8 +30,18 @@
 #include <SimCore/Components/TimedDeleterComponent.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
 #include <SimCore/Components/WeatherComponent.h>
+#include <SimCore/Components/StartupTraceComponent.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
+#include <SimCore/Components/ProfilerComponent.h>
+#include <SimCore/Components/WheelAnimationComponent.h>
+#include <SimCore/Components/TrailEffectBatchComponent.h>
+#include <SimCore/Components/PositionMarkerComponent.h>
+#include <SimCore/Components/NetworkCaptureComponent.h>
+#include <SimCore/Components/NetworkReplayComponent.h>
+#include <SimCore/Components/TerrainPhysicsPagingComponent.h>
 #include <SimCore/Messages.h>
 #include <SimCore/MessageType.h>
+#include <SimCore/StartupTracer.h>
 
 #include <SimCore/Components/ViewerMaterialComponent.h>
 #include <SimCore/Actors/EntityActorRegistry.h>
@@ -39,6 +49,7 @@
 
 #include <SimCore/Tools/Binoculars.h>
 
+#include <dtUtil/configproperties.h>
 #include <dtUtil/fileutils.h>
 #include <dtUtil/log.h>
 #include <dtUtil/stringutils.h>
@@ -64,6 +75,9 @@
 #include <dtGame/exceptionenum.h>
 
 #include <dtUtil/datapathutils.h>
+#include <dtCore/actorproxy.h>
+
+#include <OpenThreads/Thread>
 
 #include <dtAnim/animationcomponent.h>
 #include <dtAnim/animnodebuilder.h>
@@ -75,6 +89,9 @@
 //#include <osgUtil/RenderBin>
 #include <osgViewer/View>
 
+#include <algorithm>
+#include <set>
+
 using dtCore::RefPtr;
 using dtCore::ObserverPtr;
 
@@ -93,12 +110,24 @@ namespace SimCore
    const std::string BaseGameEntryPoint::CONFIG_PROP_MUNITION_MAP("MunitionMap");
    const std::string BaseGameEntryPoint::CONFIG_PROP_MUNITION_CONFIG_FILE("MunitionsConfigFile");
    const std::string BaseGameEntryPoint::CONFIG_PROP_HIGH_RES_GROUND_CLAMP_RANGE("HighResGroundClampingRange");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_STARTUP_TRACE_FILE("StartupTraceFile");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_STARTUP_PRELOAD("StartupPreload");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_FRAME_BUDGET_MILLIS("FrameBudgetMillis");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_PROFILE("Profile");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_PROFILE_TRACE_FILE("ProfileTraceFile");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_WHEEL_LOD_DISTANCE("WheelAnimationLodDistance");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_WHEEL_MAX_DISTANCE("WheelAnimationMaxDistance");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_NETWORK_CAPTURE_FILE("NetworkCaptureFile");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_NETWORK_REPLAY_FILE("NetworkReplayFile");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_NETWORK_REPLAY_TIME_SCALE("NetworkReplayTimeScale");
+   const std::string BaseGameEntryPoint::CONFIG_PROP_TERRAIN_PHYSICS_PAGING("TerrainPhysicsPaging");
 
    //////////////////////////////////////////////////////////////////////////
    BaseGameEntryPoint::BaseGameEntryPoint()
    : mAspectRatio(0.0f)
    , mLingeringShotEffectSecs(300.0f)
    , mMissingRequiredCommandLineOption(false)
+   , mDefaultFrameBudgetMillis(0.0)
    , mStartedAudio(false)
    {
    }
@@ -123,6 +152,7 @@ namespace SimCore
       parser->getApplicationUsage()->addCommandLineOption("--UI", "Specify this to disable old functionality in favor of the UI");
       parser->getApplicationUsage()->addCommandLineOption("--aspectRatio", "The aspect ratio to use for the camera [1.33 or 1.6]");
       parser->getApplicationUsage()->addCommandLineOption("--lingeringShotSecs", "The number of seconds for a shot to linger after impact. The default value is 300 (5 minutes)");
+      parser->getApplicationUsage()->addCommandLineOption("--startupTrace", "Writes how long each phase of startup takes to the given file, in the chrome://tracing json format");
 
       // Only change the value if a command line option is received.
       int tempBool = 0;
@@ -139,6 +169,8 @@ namespace SimCore
 
       parser->read("--lingeringShotSecs", mLingeringShotEffectSecs);
 
+      parser->read("--startupTrace", mStartupTraceFile);
+
       //if (!parser->read("--statisticsInterval", mStatisticsInterval))
       //{
       //   mStatisticsInterval = 0;
@@ -234,7 +266,36 @@ namespace SimCore
    //////////////////////////////////////////////////////////////////////////
    void BaseGameEntryPoint::OnStartup(dtABC::BaseABC& app, dtGame::GameManager& gameManager)
    {
-      BaseClass::OnStartup(app, gameManager);
+      dtUtil::ConfigProperties& config = gameManager.GetConfiguration();
+
+      StartupTracer& tracer = StartupTracer::GetInstance();
+      if (mStartupTraceFile.empty())
+      {
+         mStartupTraceFile = config.GetConfigPropertyValue(CONFIG_PROP_STARTUP_TRACE_FILE);
+      }
+      if (!mStartupTraceFile.empty())
+      {
+         tracer.SetOutputFile(mStartupTraceFile);
+         tracer.SetEnabled(true);
+      }
+
+      StartupTracer::Phase startupPhase("BaseGameEntryPoint::OnStartup");
+
+      // The preloads run on the thread pool while the components are set up below.  Each one that
+      // needs data from the main thread is added once that data is ready.
+      mStartupPreloader = new StartupPreloader;
+      bool usePreload = dtUtil::ToType<bool>(config.GetConfigPropertyValue(CONFIG_PROP_STARTUP_PRELOAD, "true"));
+      if (usePreload)
+      {
+         // The shader definitions are loaded with the actor registry, so these overlap with it.
+         AddShaderPreloads(*mStartupPreloader);
+         mStartupPreloader->Start();
+      }
+
+      {
+         StartupTracer::Phase phase("DefaultGameEntryPoint::OnStartup");
+         BaseClass::OnStartup(app, gameManager);
+      }
 
       dtCore::Camera* camera = gameManager.GetApplication().GetCamera();
 
@@ -262,8 +323,17 @@ namespace SimCore
 
 	   camera->AddChild(dtAudio::AudioManager::GetListener());
 
-      gameManager.LoadActorRegistry(LIBRARY_NAME);
-      
+      {
+         StartupTracer::Phase phase("Load Actor Registry");
+         gameManager.LoadActorRegistry(LIBRARY_NAME);
+      }
+
+      if (usePreload)
+      {
+         // Reading the map needs the actor registry.
+         AddModelPreloads(*mStartupPreloader);
+      }
+
       RefPtr<dtGame::DeadReckoningComponent>               drComp                     = new dtGame::DeadReckoningComponent;
       RefPtr<Components::ViewerNetworkPublishingComponent> rulesComp                  = new Components::ViewerNetworkPublishingComponent;
       RefPtr<Components::TimedDeleterComponent>            mTimedDeleterComp          = new Components::TimedDeleterComponent;
@@ -272,23 +342,97 @@ namespace SimCore
       RefPtr<Components::MunitionsComponent>               munitionsComp              = new Components::MunitionsComponent;
       RefPtr<Components::ViewerMaterialComponent>          viewerMaterialComponent    = new Components::ViewerMaterialComponent;
       RefPtr<dtAnim::AnimationComponent>                   animationComponent         = new dtAnim::AnimationComponent;
+      RefPtr<Components::WheelAnimationComponent>          wheelAnimationComp         = new Components::WheelAnimationComponent;
+      RefPtr<Components::PositionMarkerComponent>          positionMarkerComp         = new Components::PositionMarkerComponent;
+      RefPtr<Components::TrailEffectBatchComponent>        trailBatchComp             = new Components::TrailEffectBatchComponent;
 
-      gameManager.AddComponent(*weatherComp, dtGame::GameManager::ComponentPriority::NORMAL);
-      gameManager.AddComponent(*drComp, dtGame::GameManager::ComponentPriority::NORMAL);
-      gameManager.AddComponent(*rulesComp, dtGame::GameManager::ComponentPriority::HIGHER);
-      gameManager.AddComponent(*mTimedDeleterComp, dtGame::GameManager::ComponentPriority::NORMAL);
-      gameManager.AddComponent(*mParticleComp, dtGame::GameManager::ComponentPriority::NORMAL);
-      gameManager.AddComponent(*viewerMaterialComponent, dtGame::GameManager::ComponentPriority::NORMAL);
-      gameManager.AddComponent(*munitionsComp, dtGame::GameManager::ComponentPriority::NORMAL);
-      gameManager.AddComponent(*animationComponent, dtGame::GameManager::ComponentPriority::NORMAL);
+      wheelAnimationComp->SetLodDistance(dtUtil::ToFloat(config.GetConfigPropertyValue(CONFIG_PROP_WHEEL_LOD_DISTANCE,
+         dtUtil::ToString(Components::WheelAnimationComponent::DEFAULT_LOD_DISTANCE))));
+      wheelAnimationComp->SetMaxDistance(dtUtil::ToFloat(config.GetConfigPropertyValue(CONFIG_PROP_WHEEL_MAX_DISTANCE,
+         dtUtil::ToString(Components::WheelAnimationComponent::DEFAULT_MAX_DISTANCE))));
 
-      std::string highResGroundClampingRange = gameManager.GetConfiguration().GetConfigPropertyValue(
+      munitionsComp->SetMunitionConfigFileName(
+         config.GetConfigPropertyValue(CONFIG_PROP_MUNITION_CONFIG_FILE, "Configs:MunitionsConfig.xml"));
+      if (usePreload)
+      {
+         // The component uses the preloaded tables when it gets the restart message.
+         dtCore::RefPtr<Components::MunitionTablePreloadTask> tableTask = munitionsComp->CreateMunitionTablePreload();
+         if (tableTask.valid())
+         {
+            mStartupPreloader->AddTask(*tableTask);
+         }
+      }
+
+      AddTracedComponent(gameManager, *weatherComp);
+      AddTracedComponent(gameManager, *drComp);
+      AddTracedComponent(gameManager, *rulesComp, dtGame::GameManager::ComponentPriority::HIGHER);
+      AddTracedComponent(gameManager, *mTimedDeleterComp);
+      AddTracedComponent(gameManager, *mParticleComp);
+      AddTracedComponent(gameManager, *viewerMaterialComponent);
+      AddTracedComponent(gameManager, *munitionsComp);
+      AddTracedComponent(gameManager, *animationComponent);
+      AddTracedComponent(gameManager, *wheelAnimationComp);
+      AddTracedComponent(gameManager, *positionMarkerComp);
+      AddTracedComponent(gameManager, *trailBatchComp);
+
+      if (dtUtil::ToType<bool>(config.GetConfigPropertyValue(CONFIG_PROP_TERRAIN_PHYSICS_PAGING, "false")))
+      {
+         AddTracedComponent(gameManager, *new Components::TerrainPhysicsPagingComponent);
+      }
+
+      if (tracer.IsEnabled())
+      {
+         AddTracedComponent(gameManager, *new Components::StartupTraceComponent, dtGame::GameManager::ComponentPriority::LOWER);
+      }
+
+      RefPtr<Components::FrameBudgetComponent> frameBudgetComp;
+      double frameBudgetMillis = dtUtil::ToType<double>(config.GetConfigPropertyValue(CONFIG_PROP_FRAME_BUDGET_MILLIS,
+         dtUtil::ToString(mDefaultFrameBudgetMillis)));
+      if (frameBudgetMillis > 0.0)
+      {
+         // Lower, so the jobs requested at frame synch run in the same frame.
+         frameBudgetComp = new Components::FrameBudgetComponent;
+         frameBudgetComp->SetFrameBudgetMillis(frameBudgetMillis);
+         AddTracedComponent(gameManager, *frameBudgetComp, dtGame::GameManager::ComponentPriority::LOWER);
+      }
+
+      std::string profileTraceFile = config.GetConfigPropertyValue(CONFIG_PROP_PROFILE_TRACE_FILE);
+      if (!profileTraceFile.empty() || dtUtil::ToType<bool>(config.GetConfigPropertyValue(CONFIG_PROP_PROFILE, "false")))
+      {
+         RefPtr<Components::ProfilerComponent> profilerComp = new Components::ProfilerComponent;
+         profilerComp->SetTraceFile(profileTraceFile);
+         AddTracedComponent(gameManager, *profilerComp, dtGame::GameManager::ComponentPriority::LOWER);
+      }
+
+      std::string networkCaptureFile = config.GetConfigPropertyValue(CONFIG_PROP_NETWORK_CAPTURE_FILE);
+      if (!networkCaptureFile.empty())
+      {
+         RefPtr<Components::NetworkCaptureComponent> captureComp = new Components::NetworkCaptureComponent;
+         captureComp->SetCaptureFile(networkCaptureFile);
+         AddTracedComponent(gameManager, *captureComp);
+      }
+
+      std::string networkReplayFile = config.GetConfigPropertyValue(CONFIG_PROP_NETWORK_REPLAY_FILE);
+      if (!networkReplayFile.empty())
+      {
+         // Lowest, so the measured latency covers the other components.
+         RefPtr<Components::NetworkReplayComponent> replayComp = new Components::NetworkReplayComponent;
+         replayComp->SetTimeScale(dtUtil::ToFloat(config.GetConfigPropertyValue(CONFIG_PROP_NETWORK_REPLAY_TIME_SCALE, "1.0")));
+         AddTracedComponent(gameManager, *replayComp, dtGame::GameManager::ComponentPriority::LOWEST);
+         if (replayComp->LoadCapture(networkReplayFile))
+         {
+            replayComp->StartReplay();
+         }
+      }
+
+      std::string highResGroundClampingRange = config.GetConfigPropertyValue(
          CONFIG_PROP_HIGH_RES_GROUND_CLAMP_RANGE, "200");
  
       // Setup the DR Component.
       dtCore::RefPtr<Components::MultiSurfaceClamper> clamper = new Components::MultiSurfaceClamper;
       
       clamper->SetHighResGroundClampingRange( dtUtil::ToFloat(highResGroundClampingRange) );
+      clamper->SetFrameBudget( frameBudgetComp.get() );
       drComp->SetGroundClamper( *clamper );
 
       // Setup the Weather Component.
@@ -298,15 +442,144 @@ namespace SimCore
       //WeatherComp->SetUseEphemeris(true);
       weatherComp->UpdateFog();
 
-      munitionsComp->SetMunitionConfigFileName(
-         gameManager.GetConfiguration().GetConfigPropertyValue(CONFIG_PROP_MUNITION_CONFIG_FILE, "Configs:MunitionsConfig.xml"));
+      {
+         StartupTracer::Phase phase("InitializeComponents");
+         InitializeComponents(gameManager);
+      }
+   }
 
-      InitializeComponents(gameManager);
+   /////////////////////////////////////////////////////////////////////////////////////////
+   void BaseGameEntryPoint::OnShutdown(dtABC::BaseABC& app, dtGame::GameManager& gameManager)
+   {
+      // The tasks may still be running if the app quit during startup.
+      if (mStartupPreloader.valid())
+      {
+         mStartupPreloader->WaitUntilComplete();
+         mStartupPreloader = NULL;
+      }
+   }
 
+   /////////////////////////////////////////////////////////////////////////////////////////
+   void BaseGameEntryPoint::AddTracedComponent(dtGame::GameManager& gm, dtGame::GMComponent& component,
+      const dtGame::GameManager::ComponentPriority& priority)
+   {
+      StartupTracer::Phase phase(component.GetName() + " OnAddedToGM", "Component");
+      gm.AddComponent(component, priority);
    }
 
    /////////////////////////////////////////////////////////////////////////////////////////
-   void BaseGameEntryPoint::OnShutdown(dtABC::BaseABC& app, dtGame::GameManager& gameManager)
+   void BaseGameEntryPoint::GetMapModelFiles(const std::string& mapName, std::vector<std::string>& outFiles)
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+
+      // The game manager opens the same map when it loads it, so this doesn't load it twice.
+      dtCore::Map* map = NULL;
+      try
+      {
+         map = &project.GetMap(mapName);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         LOG_WARNING("Unable to read the map \"" + mapName + "\" to preload its models: " + ex.What());
+         return;
+      }
+
+      std::set<std::string> found;
+      std::vector<dtCore::RefPtr<dtCore::ActorProxy> > proxies;
+      map->GetAllProxies(proxies);
+
+      std::vector<dtCore::ActorProperty*> properties;
+      for (unsigned i = 0; i < proxies.size(); ++i)
+      {
+         properties.clear();
+         proxies[i]->GetPropertyList(properties);
+         for (unsigned j = 0; j < properties.size(); ++j)
+         {
+            if (properties[j]->GetDataType() != dtCore::DataType::STATIC_MESH)
+            {
+               continue;
+            }
+
+            dtCore::ResourceDescriptor rd = static_cast<dtCore::ResourceActorProperty*>(properties[j])->GetValue();
+            if (rd.IsEmpty() || !found.insert(rd.GetResourceIdentifier()).second)
+            {
+               continue;
+            }
+
+            try
+            {
+               std::string fileName = project.GetResourcePath(rd);
+               if (!fileName.empty())
+               {
+                  outFiles.push_back(fileName);
+               }
+            }
+            catch (const dtUtil::Exception&)
+            {
+               // The actor will report the missing file when it loads it.
+            }
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////
+   void BaseGameEntryPoint::AddShaderPreloads(StartupPreloader& preloader)
+   {
+      std::string shaderDefs = dtUtil::FindFileInPathList("Shaders/ShaderDefs.xml");
+      if (shaderDefs.empty())
+      {
+         return;
+      }
+
+      // The sources can't be read until the scan has found them.
+      dtCore::RefPtr<ShaderDefinitionScanTask> scanTask = new ShaderDefinitionScanTask(shaderDefs);
+      dtCore::RefPtr<ShaderSourcePreloadTask> sourceTask = new ShaderSourcePreloadTask(*scanTask);
+      preloader.AddTask(*scanTask);
+      preloader.AddTask(*sourceTask);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////
+   void BaseGameEntryPoint::AddModelPreloads(StartupPreloader& preloader)
    {
+      const std::string& mapName = GetMapName();
+      if (mapName.empty())
+      {
+         return;
+      }
+
+      const std::set<std::string>& mapNames = dtCore::Project::GetInstance().GetMapNames();
+      if (mapNames.find(mapName) == mapNames.end())
+      {
+         return;
+      }
+
+      std::vector<std::string> files;
+      {
+         StartupTracer::Phase phase("Find Map Models");
+         GetMapModelFiles(mapName, files);
+      }
+
+      if (files.empty())
+      {
+         return;
+      }
+
+      // Split the models over a few tasks so they load side by side.
+      unsigned numTasks = unsigned(OpenThreads::GetNumberOfProcessors());
+      numTasks = std::max(1U, std::min(numTasks, unsigned(files.size())));
+
+      std::vector<dtCore::RefPtr<ModelPreloadTask> > tasks;
+      for (unsigned i = 0; i < numTasks; ++i)
+      {
+         tasks.push_back(new ModelPreloadTask("Model Preload " + dtUtil::ToString(i + 1)));
+      }
+      for (unsigned i = 0; i < files.size(); ++i)
+      {
+         tasks[i % numTasks]->AddFile(files[i]);
+      }
+      for (unsigned i = 0; i < numTasks; ++i)
+      {
+         preloader.AddTask(*tasks[i]);
+      }
    }
 }
@@ -0,0 +1,124 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/ByteSwap.h>
+
+#include <osg/Endian>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMCORE_BYTE_SWAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace SimCore
+{
+   ////////////////////////////////////////////////////////////////////
+   bool IsCpuLittleEndian()
+   {
+      return osg::getCpuByteOrder() == osg::LittleEndian;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   static void CopySwapScalar(char* dest, const char* src, size_t count, size_t elementSize)
+   {
+      if (dest != src)
+      {
+         std::memcpy(dest, src, count * elementSize);
+      }
+
+      for (size_t i = 0; i < count; ++i)
+      {
+         std::reverse(dest, dest + elementSize);
+         dest += elementSize;
+      }
+   }
+
+#ifdef SIMCORE_BYTE_SWAP_SSE2
+   ////////////////////////////////////////////////////////////////////
+   static inline __m128i SwapBytesInWords(__m128i v)
+   {
+      return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   /// Swaps 16 bytes worth of elements at a time, and returns how many elements were done.
+   static size_t CopySwapSSE2(char* dest, const char* src, size_t count, size_t elementSize)
+   {
+      const size_t perBlock = 16 / elementSize;
+      const size_t numBlocks = count / perBlock;
+      for (size_t i = 0; i < numBlocks; ++i)
+      {
+         __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+         v = SwapBytesInWords(v);
+         if (elementSize == 4)
+         {
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+         }
+         else if (elementSize == 8)
+         {
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+         }
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), v);
+         src += 16;
+         dest += 16;
+      }
+      return numBlocks * perBlock;
+   }
+#endif
+
+   ////////////////////////////////////////////////////////////////////
+   void CopySwapBytes(void* dest, const void* src, size_t count, size_t elementSize)
+   {
+      char* destBytes = static_cast<char*>(dest);
+      const char* srcBytes = static_cast<const char*>(src);
+
+      if (elementSize <= 1)
+      {
+         if (dest != src)
+         {
+            std::memmove(dest, src, count * elementSize);
+         }
+         return;
+      }
+
+      size_t done = 0;
+#ifdef SIMCORE_BYTE_SWAP_SSE2
+      if (elementSize == 2 || elementSize == 4 || elementSize == 8)
+      {
+         done = CopySwapSSE2(destBytes, srcBytes, count, elementSize);
+      }
+#endif
+      size_t offset = done * elementSize;
+      CopySwapScalar(destBytes + offset, srcBytes + offset, count - done, elementSize);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void SwapBytes(void* data, size_t count, size_t elementSize)
+   {
+      CopySwapBytes(data, data, count, elementSize);
+   }
+}
@@ -0,0 +1,323 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/DetonationActorPool.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtUtil/log.h>
+
+#include <algorithm>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // Statistics Code
+      //////////////////////////////////////////////////////////////////////////
+      DetonationActorPool::Statistics::Statistics()
+         : mAcquired(0)
+         , mHits(0)
+         , mReleased(0)
+         , mDiscarded(0)
+         , mSpawns(0)
+         , mTotalSpawnTimeMS(0.0)
+         , mMaxSpawnTimeMS(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      float DetonationActorPool::Statistics::GetHitRate() const
+      {
+         return mAcquired == 0 ? 0.0f : float(mHits) / float(mAcquired);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double DetonationActorPool::Statistics::GetAverageSpawnTimeMS() const
+      {
+         return mSpawns == 0 ? 0.0 : mTotalSpawnTimeMS / double(mSpawns);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      // Detonation Actor Pool Code
+      //////////////////////////////////////////////////////////////////////////
+      DetonationActorPool::DetonationActorPool()
+         : mMaxIdlePerType(DEFAULT_MAX_IDLE_PER_TYPE)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DetonationActorPool::~DetonationActorPool()
+      {
+         Clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void DetonationActorPool::SetGameManager( dtGame::GameManager* gameManager )
+      {
+         mGM = gameManager;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      dtGame::GameManager* DetonationActorPool::GetGameManager()
+      {
+         return mGM.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void DetonationActorPool::SetMaxIdlePerType( unsigned maxIdle )
+      {
+         mMaxIdlePerType = maxIdle;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned DetonationActorPool::GetMaxIdlePerType() const
+      {
+         return mMaxIdlePerType;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> DetonationActorPool::Acquire(
+         const dtCore::UniqueId& prototypeId, SimCore::Actors::DetonationActor::IMPACT_TYPE impact, bool& outReused )
+      {
+         ++mStats.mAcquired;
+         // The hit rate of a frame is Hits / Acquired.
+         SIMCORE_PROFILE_COUNT("DetonationActorPool::Acquired", 1);
+         PoolKey key( prototypeId, int(impact) );
+
+         IdleListMap::iterator idleIter = mIdleLists.find( key );
+         if( idleIter != mIdleLists.end() && ! idleIter->second.empty() )
+         {
+            dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> proxy = idleIter->second.back();
+            idleIter->second.pop_back();
+
+            PooledActorMap::iterator pooledIter = mPooledActors.find( proxy->GetId() );
+            if( pooledIter != mPooledActors.end() )
+            {
+               pooledIter->second.mIdle = false;
+            }
+
+            ++mStats.mHits;
+            SIMCORE_PROFILE_COUNT("DetonationActorPool::Hits", 1);
+            outReused = true;
+            return proxy;
+         }
+
+         outReused = false;
+         return CreateDetonation( key );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> DetonationActorPool::CreateDetonation( const PoolKey& key )
+      {
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> proxy;
+         if( ! mGM.valid() )
+         {
+            LOG_ERROR( "Unable to create a pooled detonation without a game manager." );
+            return proxy;
+         }
+
+         mGM->CreateActorFromPrototype( key.first, proxy );
+
+         SimCore::Actors::DetonationActor* detonation = NULL;
+         if( proxy.valid() )
+         {
+            proxy->GetDrawable( detonation );
+         }
+
+         if( detonation == NULL )
+         {
+            return NULL;
+         }
+
+         detonation->SetImpactType( SimCore::Actors::DetonationActor::IMPACT_TYPE(key.second) );
+         detonation->SetPool( this );
+         mPooledActors.insert( std::make_pair( proxy->GetId(), PooledActor(key) ) );
+         return proxy;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool DetonationActorPool::Release( SimCore::Actors::DetonationActorProxy& proxy )
+      {
+         PooledActorMap::iterator pooledIter = mPooledActors.find( proxy.GetId() );
+         if( pooledIter == mPooledActors.end() )
+         {
+            return false;
+         }
+
+         if( pooledIter->second.mIdle )
+         {
+            return true;
+         }
+
+         SimCore::Actors::DetonationActor* detonation = NULL;
+         proxy.GetDrawable( detonation );
+         detonation->StopDetonation();
+         ++mStats.mReleased;
+
+         ProxyList& idleList = mIdleLists[pooledIter->second.mKey];
+         if( idleList.size() < mMaxIdlePerType )
+         {
+            pooledIter->second.mIdle = true;
+            idleList.push_back( &proxy );
+         }
+         else
+         {
+            mPooledActors.erase( pooledIter );
+            detonation->SetPool( NULL );
+            ++mStats.mDiscarded;
+
+            if( mGM.valid() )
+            {
+               mGM->DeleteActor( proxy );
+            }
+         }
+
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void DetonationActorPool::Remove( const dtCore::UniqueId& actorId )
+      {
+         PooledActorMap::iterator pooledIter = mPooledActors.find( actorId );
+         if( pooledIter == mPooledActors.end() )
+         {
+            return;
+         }
+
+         if( pooledIter->second.mIdle )
+         {
+            ProxyList& idleList = mIdleLists[pooledIter->second.mKey];
+            ProxyList::iterator i = idleList.begin();
+            for( ; i != idleList.end(); ++i )
+            {
+               if( (*i)->GetId() == actorId )
+               {
+                  idleList.erase( i );
+                  break;
+               }
+            }
+         }
+
+         mPooledActors.erase( pooledIter );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool DetonationActorPool::IsPooled( const dtCore::UniqueId& actorId ) const
+      {
+         return mPooledActors.find( actorId ) != mPooledActors.end();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool DetonationActorPool::IsIdle( const dtCore::UniqueId& actorId ) const
+      {
+         PooledActorMap::const_iterator pooledIter = mPooledActors.find( actorId );
+         return pooledIter != mPooledActors.end() && pooledIter->second.mIdle;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned DetonationActorPool::GetNumPooled() const
+      {
+         return unsigned(mPooledActors.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned DetonationActorPool::GetNumIdle() const
+      {
+         unsigned count = 0;
+         IdleListMap::const_iterator i = mIdleLists.begin();
+         for( ; i != mIdleLists.end(); ++i )
+         {
+            count += unsigned(i->second.size());
+         }
+         return count;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned DetonationActorPool::Preload( const dtCore::UniqueId& prototypeId,
+         SimCore::Actors::DetonationActor::IMPACT_TYPE impact, unsigned count )
+      {
+         PoolKey key( prototypeId, int(impact) );
+         ProxyList& idleList = mIdleLists[key];
+
+         unsigned added = 0;
+         while( added < count && idleList.size() < mMaxIdlePerType )
+         {
+            dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> proxy = CreateDetonation( key );
+            if( ! proxy.valid() )
+            {
+               break;
+            }
+
+            // Pooled detonations load their effects when they enter the world, but don't detonate.
+            mGM->AddActor( *proxy, false, false );
+            mPooledActors.find( proxy->GetId() )->second.mIdle = true;
+            idleList.push_back( proxy );
+            ++added;
+         }
+
+         return added;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void DetonationActorPool::Clear()
+      {
+         IdleListMap::iterator idleIter = mIdleLists.begin();
+         for( ; idleIter != mIdleLists.end(); ++idleIter )
+         {
+            ProxyList::iterator i = idleIter->second.begin();
+            for( ; i != idleIter->second.end(); ++i )
+            {
+               (*i)->GetDrawable<SimCore::Actors::DetonationActor>()->SetPool( NULL );
+            }
+         }
+
+         mIdleLists.clear();
+         mPooledActors.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void DetonationActorPool::RecordSpawnTime( double milliseconds )
+      {
+         ++mStats.mSpawns;
+         mStats.mTotalSpawnTimeMS += milliseconds;
+         mStats.mMaxSpawnTimeMS = std::max( mStats.mMaxSpawnTimeMS, milliseconds );
+         SIMCORE_PROFILE_COUNT("DetonationActorPool::Spawns", 1);
+         SIMCORE_PROFILE_COUNT("DetonationActorPool::SpawnMicros", (long long)(milliseconds * 1000.0));
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const DetonationActorPool::Statistics& DetonationActorPool::GetStatistics() const
+      {
+         return mStats;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void DetonationActorPool::ResetStatistics()
+      {
+         mStats = Statistics();
+      }
+
+   }
+}
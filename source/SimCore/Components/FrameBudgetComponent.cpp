@@ -0,0 +1,430 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/message.h>
+#include <dtUtil/log.h>
+
+#include <osg/Timer>
+
+#include <algorithm>
+#include <sstream>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      struct CompareJobPriority
+      {
+         bool operator()(const FrameBudgetJob* one, const FrameBudgetJob* two) const
+         {
+            // The jobs that have waited longer go first within a priority.
+            if (one->GetPriority() != two->GetPriority())
+            {
+               return one->GetPriority() > two->GetPriority();
+            }
+            return one->GetFramesDeferred() > two->GetFramesDeferred();
+         }
+      };
+
+      //////////////////////////////////////////////////////////////////////////
+      // FRAME BUDGET JOB CODE
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetJob::FrameBudgetJob(const std::string& name, const std::string& subsystem, const WorkFunc& work,
+               unsigned priority)
+         : mPriority(priority)
+         , mMaxDeferredFrames(10)
+         , mName(name)
+         , mSubsystem(subsystem)
+         , mWork(work)
+         , mRequested(false)
+         , mFramesDeferred(0)
+         , mExpectedMillis(0.0)
+         , mLastMillis(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetJob::~FrameBudgetJob()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(FrameBudgetJob, unsigned, Priority);
+      DT_IMPLEMENT_ACCESSOR(FrameBudgetJob, unsigned, MaxDeferredFrames);
+
+      //////////////////////////////////////////////////////////////////////////
+      const std::string& FrameBudgetJob::GetName() const
+      {
+         return mName;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const std::string& FrameBudgetJob::GetSubsystem() const
+      {
+         return mSubsystem;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetJob::Request()
+      {
+         mRequested = true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool FrameBudgetJob::IsRequested() const
+      {
+         return mRequested;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned FrameBudgetJob::GetFramesDeferred() const
+      {
+         return mFramesDeferred;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetJob::SetExpectedMillis(double millis)
+      {
+         mExpectedMillis = millis;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double FrameBudgetJob::GetExpectedMillis() const
+      {
+         return mExpectedMillis;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double FrameBudgetJob::GetLastMillis() const
+      {
+         return mLastMillis;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetComponent* FrameBudgetJob::GetFrameBudget()
+      {
+         return mFrameBudget.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetJob::RemoveFromFrameBudget()
+      {
+         if (mFrameBudget.valid())
+         {
+            mFrameBudget->RemoveJob(*this);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetJob::Run()
+      {
+         // Cleared first so the work can request itself again.
+         mRequested = false;
+         mFramesDeferred = 0;
+
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+         mWork();
+         mLastMillis = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+
+         // Follow the measured time, but smooth out the odd slow frame.
+         mExpectedMillis = 0.75 * mExpectedMillis + 0.25 * mLastMillis;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      // FRAME BUDGET COMPONENT CODE
+      //////////////////////////////////////////////////////////////////////////
+      const double FrameBudgetComponent::DEFAULT_FRAME_BUDGET_MILLIS = 4.0;
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetComponent::SubsystemStats::SubsystemStats()
+         : mNumRuns(0)
+         , mNumDeferred(0)
+         , mNumForced(0)
+         , mNumOverruns(0)
+         , mTotalMillis(0.0)
+         , mMaxMillis(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetComponent::FrameBudgetComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mFrameBudgetMillis(DEFAULT_FRAME_BUDGET_MILLIS)
+         , mLastFrameMillis(0.0)
+         , mOverBudget(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetComponent::~FrameBudgetComponent()
+      {
+         for (unsigned i = 0; i < mJobs.size(); ++i)
+         {
+            mJobs[i]->mFrameBudget = NULL;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(FrameBudgetComponent, double, FrameBudgetMillis);
+
+      //////////////////////////////////////////////////////////////////////////
+      bool FrameBudgetComponent::RequestJob(dtGame::GameManager& gm, FrameBudgetJob& job)
+      {
+         if (job.GetFrameBudget() == NULL)
+         {
+            FrameBudgetComponent* frameBudget = NULL;
+            gm.GetComponentByName(DEFAULT_NAME, frameBudget);
+            if (frameBudget == NULL)
+            {
+               return false;
+            }
+
+            frameBudget->AddJob(job);
+         }
+
+         job.Request();
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::AddJob(FrameBudgetJob& job)
+      {
+         if (job.mFrameBudget == this)
+         {
+            return;
+         }
+
+         // Hold a reference, since removing it from the other component may let it go.
+         dtCore::RefPtr<FrameBudgetJob> jobRef = &job;
+         job.RemoveFromFrameBudget();
+
+         FrameBudgetJob* oldJob = FindJob(job.GetName());
+         if (oldJob != NULL)
+         {
+            LOG_WARNING("Replacing the frame budget job \"" + job.GetName() + "\".");
+            RemoveJob(*oldJob);
+         }
+
+         job.mFrameBudget = this;
+         mJobs.push_back(&job);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::RemoveJob(FrameBudgetJob& job)
+      {
+         if (job.mFrameBudget != this)
+         {
+            return;
+         }
+
+         job.mFrameBudget = NULL;
+         // The run list is only used inside RunFrame, so clear the job out of it in case a job removes another.
+         std::replace(mRunList.begin(), mRunList.end(), &job, static_cast<FrameBudgetJob*>(NULL));
+         for (unsigned i = 0; i < mJobs.size(); ++i)
+         {
+            if (mJobs[i] == &job)
+            {
+               mJobs.erase(mJobs.begin() + i);
+               break;
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetJob* FrameBudgetComponent::FindJob(const std::string& name)
+      {
+         for (unsigned i = 0; i < mJobs.size(); ++i)
+         {
+            if (mJobs[i]->GetName() == name)
+            {
+               return mJobs[i].get();
+            }
+         }
+         return NULL;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned FrameBudgetComponent::GetNumJobs() const
+      {
+         return unsigned(mJobs.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::RunFrame()
+      {
+         mRunList.clear();
+         for (unsigned i = 0; i < mJobs.size(); ++i)
+         {
+            if (mJobs[i]->IsRequested())
+            {
+               mRunList.push_back(mJobs[i].get());
+            }
+         }
+
+         mOverBudget = false;
+         mLastFrameMillis = 0.0;
+         if (mRunList.empty())
+         {
+            return;
+         }
+
+         std::stable_sort(mRunList.begin(), mRunList.end(), CompareJobPriority());
+
+         // Keep the jobs alive in case one removes another.
+         JobList jobsRef(mJobs);
+
+         osg::Timer* timer = osg::Timer::instance();
+         osg::Timer_t startTick = timer->tick();
+         bool anyRun = false;
+
+         for (unsigned i = 0; i < mRunList.size(); ++i)
+         {
+            FrameBudgetJob* job = mRunList[i];
+            if (job == NULL)
+            {
+               continue;
+            }
+
+            SubsystemStats& stats = mStats[job->GetSubsystem()];
+
+            double remaining = mFrameBudgetMillis - timer->delta_m(startTick, timer->tick());
+            bool forced = job->GetFramesDeferred() >= job->GetMaxDeferredFrames();
+            if (anyRun && !forced && job->GetExpectedMillis() > remaining)
+            {
+               ++job->mFramesDeferred;
+               ++stats.mNumDeferred;
+               mOverBudget = true;
+               continue;
+            }
+
+            if (forced && anyRun && job->GetExpectedMillis() > remaining)
+            {
+               ++stats.mNumForced;
+            }
+
+            job->Run();
+            anyRun = true;
+
+            ++stats.mNumRuns;
+            stats.mTotalMillis += job->GetLastMillis();
+            stats.mMaxMillis = std::max(stats.mMaxMillis, job->GetLastMillis());
+
+            if (timer->delta_m(startTick, timer->tick()) > mFrameBudgetMillis)
+            {
+               ++stats.mNumOverruns;
+               mOverBudget = true;
+            }
+         }
+
+         mRunList.clear();
+         mLastFrameMillis = timer->delta_m(startTick, timer->tick());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double FrameBudgetComponent::GetLastFrameMillis() const
+      {
+         return mLastFrameMillis;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool FrameBudgetComponent::IsOverBudget() const
+      {
+         return mOverBudget;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const FrameBudgetComponent::SubsystemStats* FrameBudgetComponent::GetSubsystemStats(const std::string& subsystem) const
+      {
+         SubsystemStatsMap::const_iterator found = mStats.find(subsystem);
+         if (found == mStats.end())
+         {
+            return NULL;
+         }
+         return &found->second;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const FrameBudgetComponent::SubsystemStatsMap& FrameBudgetComponent::GetAllSubsystemStats() const
+      {
+         return mStats;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::ResetStats()
+      {
+         mStats.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::WriteReport(std::ostream& out) const
+      {
+         out << "Frame budget " << mFrameBudgetMillis << " ms" << std::endl;
+
+         SubsystemStatsMap::const_iterator i, iend;
+         i = mStats.begin();
+         iend = mStats.end();
+         for (; i != iend; ++i)
+         {
+            const SubsystemStats& stats = i->second;
+            double average = stats.mNumRuns > 0 ? stats.mTotalMillis / double(stats.mNumRuns) : 0.0;
+            out << i->first
+                << ": runs " << stats.mNumRuns
+                << ", deferred " << stats.mNumDeferred
+                << ", forced " << stats.mNumForced
+                << ", overruns " << stats.mNumOverruns
+                << ", average " << average << " ms"
+                << ", max " << stats.mMaxMillis << " ms" << std::endl;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::OnRemovedFromGM()
+      {
+         if (dtUtil::Log::GetInstance().IsLevelEnabled(dtUtil::Log::LOG_INFO) && !mStats.empty())
+         {
+            std::ostringstream ss;
+            WriteReport(ss);
+            LOG_INFO(ss.str());
+         }
+
+         while (!mJobs.empty())
+         {
+            RemoveJob(*mJobs.back());
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void FrameBudgetComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         if (message.GetMessageType() == dtGame::MessageType::SYSTEM_FRAME_SYNCH)
+         {
+            RunFrame();
+         }
+      }
+   }
+}
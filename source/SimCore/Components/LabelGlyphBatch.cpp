@@ -0,0 +1,685 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/LabelGlyphBatch.h>
+
+#include <dtUtil/log.h>
+#include <dtUtil/nodemask.h>
+
+#include <osg/BlendFunc>
+#include <osg/Camera>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Image>
+#include <osg/Texture2D>
+#include <osg/Vec2i>
+#include <osgDB/ReadFile>
+#include <osgText/Font>
+
+#include <algorithm>
+#include <cmath>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // GLYPH ATLAS CODE
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphAtlas::Glyph::Glyph()
+      : mWidth(0.0f)
+      , mHeight(0.0f)
+      , mAdvance(0.0f)
+      , mValid(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphAtlas::LabelGlyphAtlas()
+      : mGlyphs(256)
+      , mLineHeight(0.0f)
+      , mHasSolidTexCoord(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphAtlas::~LabelGlyphAtlas()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphAtlas::SetupGrid(unsigned columns, unsigned rows, unsigned char firstChar,
+               float glyphWidth, float glyphHeight)
+      {
+         if (columns == 0 || rows == 0)
+         {
+            return;
+         }
+
+         float cellS = 1.0f / float(columns);
+         float cellT = 1.0f / float(rows);
+         for (unsigned i = 0; i < columns * rows && unsigned(firstChar) + i < mGlyphs.size(); ++i)
+         {
+            unsigned column = i % columns;
+            unsigned row = i / columns;
+
+            Glyph& glyph = mGlyphs[firstChar + i];
+            // Texture coordinates start at the bottom, but the grid starts at the top.
+            glyph.mTexMin.set(float(column) * cellS, 1.0f - float(row + 1) * cellT);
+            glyph.mTexMax.set(float(column + 1) * cellS, 1.0f - float(row) * cellT);
+            glyph.mWidth = glyphWidth;
+            glyph.mHeight = glyphHeight;
+            glyph.mAdvance = glyphWidth;
+            glyph.mValid = true;
+         }
+
+         mLineHeight = glyphHeight;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool LabelGlyphAtlas::LoadGridFont(const std::string& imageFile, unsigned columns, unsigned rows, unsigned char firstChar)
+      {
+         dtCore::RefPtr<osg::Image> image = osgDB::readImageFile(imageFile);
+         if (!image.valid() || columns == 0 || rows == 0)
+         {
+            LOG_ERROR("Unable to load the label font image \"" + imageFile + "\".");
+            return false;
+         }
+
+         dtCore::RefPtr<osg::Texture2D> texture = new osg::Texture2D(image.get());
+         texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+         texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+         texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+         texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+         // The image is only needed on the card.
+         texture->setUnRefImageDataAfterApply(true);
+         SetTexture(texture.get());
+
+         SetupGrid(columns, rows, firstChar, float(image->s()) / float(columns), float(image->t()) / float(rows));
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool LabelGlyphAtlas::LoadFont(const std::string& fontFile, unsigned pixelSize)
+      {
+         static const unsigned char FIRST_CHAR = ' ';
+         static const unsigned char LAST_CHAR = '~';
+         static const int ATLAS_WIDTH = 512;
+         // Space between the cells so linear filtering doesn't bleed between glyphs.
+         static const int CELL_SPACING = 1;
+         static const int SOLID_BLOCK_SIZE = 4;
+
+         dtCore::RefPtr<osgText::Font> font = osgText::readFontFile(fontFile);
+         if (!font.valid() || pixelSize == 0)
+         {
+            LOG_ERROR("Unable to load the label font \"" + fontFile + "\".");
+            return false;
+         }
+
+         osgText::FontResolution resolution(pixelSize, pixelSize);
+         std::vector<dtCore::RefPtr<osgText::Glyph> > fontGlyphs(LAST_CHAR - FIRST_CHAR + 1);
+
+         // The first pass finds how far the glyphs go above and below the baseline, which sets the cell height.
+         float ascent = 0.0f, descent = 0.0f;
+         for (unsigned c = FIRST_CHAR; c <= LAST_CHAR; ++c)
+         {
+            osgText::Glyph* fontGlyph = font->getGlyph(resolution, c);
+            if (fontGlyph == NULL)
+            {
+               continue;
+            }
+            fontGlyphs[c - FIRST_CHAR] = fontGlyph;
+            const osg::Vec2& bearing = fontGlyph->getHorizontalBearing();
+            ascent = std::max(ascent, bearing.y() + float(fontGlyph->t()));
+            descent = std::max(descent, -bearing.y());
+         }
+
+         int cellHeight = int(std::ceil(ascent + descent));
+         int baseline = int(std::ceil(descent));
+         if (cellHeight <= 0)
+         {
+            LOG_ERROR("The label font \"" + fontFile + "\" has no printable glyphs.");
+            return false;
+         }
+
+         // The second pass packs the cells into rows, left to right, bottom to top.
+         std::vector<osg::Vec2i> cellOrigins(fontGlyphs.size());
+         std::vector<int> cellWidths(fontGlyphs.size(), 0);
+         int x = SOLID_BLOCK_SIZE + CELL_SPACING, y = 0;
+         for (unsigned i = 0; i < fontGlyphs.size(); ++i)
+         {
+            if (!fontGlyphs[i].valid())
+            {
+               continue;
+            }
+
+            int width = std::max(1, int(std::ceil(fontGlyphs[i]->getHorizontalAdvance())));
+            width = std::min(width, ATLAS_WIDTH);
+            if (x + width > ATLAS_WIDTH)
+            {
+               x = 0;
+               y += cellHeight + CELL_SPACING;
+            }
+            cellOrigins[i].set(x, y);
+            cellWidths[i] = width;
+            x += width + CELL_SPACING;
+         }
+
+         int atlasHeight = 1;
+         while (atlasHeight < y + cellHeight)
+         {
+            atlasHeight *= 2;
+         }
+
+         // White texels with the glyph coverage in the alpha, so the text takes the label color.
+         dtCore::RefPtr<osg::Image> image = new osg::Image();
+         image->allocateImage(ATLAS_WIDTH, atlasHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+         unsigned char* pixels = image->data();
+         for (int i = 0; i < ATLAS_WIDTH * atlasHeight; ++i)
+         {
+            pixels[i * 4] = pixels[i * 4 + 1] = pixels[i * 4 + 2] = 255;
+            pixels[i * 4 + 3] = 0;
+         }
+
+         for (int row = 0; row < SOLID_BLOCK_SIZE && row < atlasHeight; ++row)
+         {
+            for (int column = 0; column < SOLID_BLOCK_SIZE; ++column)
+            {
+               image->data(column, row)[3] = 255;
+            }
+         }
+
+         float atlasWidthF = float(ATLAS_WIDTH), atlasHeightF = float(atlasHeight);
+         mGlyphs.assign(mGlyphs.size(), Glyph());
+         for (unsigned i = 0; i < fontGlyphs.size(); ++i)
+         {
+            osgText::Glyph* fontGlyph = fontGlyphs[i].get();
+            if (fontGlyph == NULL)
+            {
+               continue;
+            }
+
+            const osg::Vec2i& origin = cellOrigins[i];
+            int width = cellWidths[i];
+            const osg::Vec2& bearing = fontGlyph->getHorizontalBearing();
+            int left = int(bearing.x());
+            int bottom = baseline + int(bearing.y());
+
+            // Parts of the glyph outside the cell, such as a long tail, are clipped.
+            for (int gy = 0; gy < fontGlyph->t(); ++gy)
+            {
+               int ty = bottom + gy;
+               if (ty < 0 || ty >= cellHeight)
+               {
+                  continue;
+               }
+               for (int gx = 0; gx < fontGlyph->s(); ++gx)
+               {
+                  int tx = left + gx;
+                  if (tx < 0 || tx >= width)
+                  {
+                     continue;
+                  }
+                  float coverage = fontGlyph->getColor(gx, gy).a();
+                  image->data(origin.x() + tx, origin.y() + ty)[3] = (unsigned char)(coverage * 255.0f + 0.5f);
+               }
+            }
+
+            Glyph& glyph = mGlyphs[FIRST_CHAR + i];
+            glyph.mTexMin.set(float(origin.x()) / atlasWidthF, float(origin.y()) / atlasHeightF);
+            glyph.mTexMax.set(float(origin.x() + width) / atlasWidthF, float(origin.y() + cellHeight) / atlasHeightF);
+            glyph.mWidth = float(width);
+            glyph.mHeight = float(cellHeight);
+            glyph.mAdvance = float(width);
+            glyph.mValid = true;
+         }
+
+         dtCore::RefPtr<osg::Texture2D> texture = new osg::Texture2D(image.get());
+         texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+         texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+         texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+         texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+         SetTexture(texture.get());
+
+         mLineHeight = float(cellHeight);
+         // The middle of the opaque block, away from the edges that blend with the empty texels.
+         SetSolidTexCoord(osg::Vec2(float(SOLID_BLOCK_SIZE) * 0.5f / atlasWidthF, float(SOLID_BLOCK_SIZE) * 0.5f / atlasHeightF));
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphAtlas::SetGlyph(unsigned char c, const Glyph& glyph)
+      {
+         mGlyphs[c] = glyph;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const LabelGlyphAtlas::Glyph* LabelGlyphAtlas::GetGlyph(unsigned char c) const
+      {
+         if (mGlyphs[c].mValid)
+         {
+            return &mGlyphs[c];
+         }
+         else if (mGlyphs['?'].mValid)
+         {
+            return &mGlyphs['?'];
+         }
+         return NULL;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphAtlas::SetLineHeight(float height)
+      {
+         mLineHeight = height;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      float LabelGlyphAtlas::GetLineHeight() const
+      {
+         return mLineHeight;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      float LabelGlyphAtlas::GetTextWidth(const std::string& text) const
+      {
+         float width = 0.0f;
+         for (std::string::const_iterator i = text.begin(); i != text.end(); ++i)
+         {
+            const Glyph* glyph = GetGlyph((unsigned char)(*i));
+            if (glyph != NULL)
+            {
+               width += glyph->mAdvance;
+            }
+         }
+         return width;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphAtlas::SetSolidTexCoord(const osg::Vec2& texCoord)
+      {
+         mSolidTexCoord = texCoord;
+         mHasSolidTexCoord = true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphAtlas::ClearSolidTexCoord()
+      {
+         mHasSolidTexCoord = false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool LabelGlyphAtlas::HasSolidTexCoord() const
+      {
+         return mHasSolidTexCoord;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const osg::Vec2& LabelGlyphAtlas::GetSolidTexCoord() const
+      {
+         return mSolidTexCoord;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphAtlas::SetTexture(osg::Texture2D* texture)
+      {
+         mTexture = texture;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      osg::Texture2D* LabelGlyphAtlas::GetTexture()
+      {
+         return mTexture.get();
+      }
+
+
+
+      //////////////////////////////////////////////////////////////////////////
+      // GLYPH BATCH CODE
+      //////////////////////////////////////////////////////////////////////////
+      const float LabelGlyphBatch::BACKGROUND_PADDING = 5.0f;
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphBatch::BatchedLabel::BatchedLabel()
+      : mDepth(0.0f)
+      , mUsed(false)
+      , mHasBackground(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphBatch::LabelGlyphBatch(LabelGlyphAtlas& atlas)
+      : mAtlas(&atlas)
+      , mScreenSize(1.0f, 1.0f)
+      , mNumLayoutsBuilt(0)
+      , mDirty(false)
+      , mVertices(new osg::Vec3Array())
+      , mTexCoords(new osg::Vec2Array())
+      , mColors(new osg::Vec4Array())
+      , mDrawArrays(new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 0))
+      , mGeometry(new osg::Geometry())
+      , mCamera(new osg::Camera())
+      {
+         // The arrays change most frames, so don't compile them into a display list.
+         mGeometry->setUseDisplayList(false);
+         mGeometry->setUseVertexBufferObjects(true);
+         mGeometry->setDataVariance(osg::Object::DYNAMIC);
+         mGeometry->setVertexArray(mVertices.get());
+         mGeometry->setTexCoordArray(0, mTexCoords.get());
+         mGeometry->setColorArray(mColors.get());
+         mGeometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+         mGeometry->addPrimitiveSet(mDrawArrays.get());
+
+         osg::Geode* geode = new osg::Geode();
+         geode->addDrawable(mGeometry.get());
+
+         osg::StateSet* ss = geode->getOrCreateStateSet();
+         if (atlas.GetTexture() != NULL)
+         {
+            ss->setTextureAttributeAndModes(0, atlas.GetTexture(), osg::StateAttribute::ON);
+         }
+         ss->setAttributeAndModes(new osg::BlendFunc(osg::BlendFunc::SRC_ALPHA, osg::BlendFunc::ONE_MINUS_SRC_ALPHA),
+                  osg::StateAttribute::ON);
+         ss->setMode(GL_LIGHTING, osg::StateAttribute::OFF | osg::StateAttribute::PROTECTED);
+         ss->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+         // The labels are drawn in the order they are in the arrays.
+         ss->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+         mCamera->setReferenceFrame(osg::Transform::ABSOLUTE_RF);
+         mCamera->setViewMatrix(osg::Matrix::identity());
+         mCamera->setProjectionMatrixAsOrtho2D(0.0, mScreenSize.x(), 0.0, mScreenSize.y());
+         mCamera->setRenderOrder(osg::Camera::POST_RENDER);
+         mCamera->setClearMask(GL_NONE);
+         mCamera->setNodeMask(dtUtil::NodeMask::FOREGROUND);
+         mCamera->addChild(geode);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphBatch::~LabelGlyphBatch()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphAtlas& LabelGlyphBatch::GetAtlas()
+      {
+         return *mAtlas;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::SetScreenSize(float width, float height)
+      {
+         if (mScreenSize.x() != width || mScreenSize.y() != height)
+         {
+            mScreenSize.set(width, height);
+            mCamera->setProjectionMatrixAsOrtho2D(0.0, width, 0.0, height);
+            mDirty = true;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const osg::Vec2& LabelGlyphBatch::GetScreenSize() const
+      {
+         return mScreenSize;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::BeginFrame()
+      {
+         LabelMap::iterator i, iend;
+         i = mLabels.begin();
+         iend = mLabels.end();
+         for (; i != iend; ++i)
+         {
+            i->second.mUsed = false;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::SetLabel(const dtCore::UniqueId& id, const std::string& text, const std::string& line2,
+               const osg::Vec4& color, const osg::Vec2& screenPos, float depth)
+      {
+         std::pair<LabelMap::iterator, bool> inserted = mLabels.insert(std::make_pair(id, BatchedLabel()));
+         BatchedLabel& label = inserted.first->second;
+         label.mUsed = true;
+
+         if (inserted.second || label.mText != text || label.mLine2 != line2)
+         {
+            label.mText = text;
+            label.mLine2 = line2;
+            LayoutLabel(label);
+            mDirty = true;
+         }
+
+         if (label.mColor != color || label.mScreenPos != screenPos || label.mDepth != depth)
+         {
+            label.mColor = color;
+            label.mScreenPos = screenPos;
+            label.mDepth = depth;
+            mDirty = true;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::EndFrame()
+      {
+         LabelMap::iterator i = mLabels.begin();
+         while (i != mLabels.end())
+         {
+            if (!i->second.mUsed)
+            {
+               mLabels.erase(i++);
+               mDirty = true;
+            }
+            else
+            {
+               ++i;
+            }
+         }
+
+         if (mDirty)
+         {
+            FillVertexData();
+            mDirty = false;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::Clear()
+      {
+         mLabels.clear();
+         mSortList.clear();
+         FillVertexData();
+         mDirty = false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned LabelGlyphBatch::GetNumLabels() const
+      {
+         return unsigned(mLabels.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned LabelGlyphBatch::GetNumQuads() const
+      {
+         return unsigned(mVertices->size() / 4);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned LabelGlyphBatch::GetNumLayoutsBuilt() const
+      {
+         return mNumLayoutsBuilt;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const osg::Vec3Array& LabelGlyphBatch::GetVertices() const
+      {
+         return *mVertices;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const osg::Vec2Array& LabelGlyphBatch::GetTexCoords() const
+      {
+         return *mTexCoords;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const osg::Vec4Array& LabelGlyphBatch::GetColors() const
+      {
+         return *mColors;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      osg::Geometry& LabelGlyphBatch::GetGeometry()
+      {
+         return *mGeometry;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      osg::Camera& LabelGlyphBatch::GetNode()
+      {
+         return *mCamera;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::LayoutLabel(BatchedLabel& label)
+      {
+         ++mNumLayoutsBuilt;
+         label.mLocalVerts.clear();
+         label.mTexCoords.clear();
+
+         float lineHeight = mAtlas->GetLineHeight();
+         float numLines = label.mLine2.empty() ? 1.0f : 2.0f;
+
+         label.mHasBackground = mAtlas->HasSolidTexCoord();
+         if (label.mHasBackground)
+         {
+            float halfWidth = std::max(mAtlas->GetTextWidth(label.mText), mAtlas->GetTextWidth(label.mLine2)) / 2.0f
+               + BACKGROUND_PADDING;
+            const osg::Vec2& solid = mAtlas->GetSolidTexCoord();
+            AddQuad(label, osg::Vec2(-halfWidth, 0.0f), osg::Vec2(halfWidth, numLines * lineHeight), solid, solid);
+         }
+
+         // The second line goes under the text.
+         AddLine(label, label.mText, (numLines - 1.0f) * lineHeight);
+         if (!label.mLine2.empty())
+         {
+            AddLine(label, label.mLine2, 0.0f);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::AddLine(BatchedLabel& label, const std::string& line, float bottom)
+      {
+         // Each line is centered on the label position.
+         float penX = -mAtlas->GetTextWidth(line) / 2.0f;
+         for (std::string::const_iterator i = line.begin(); i != line.end(); ++i)
+         {
+            const LabelGlyphAtlas::Glyph* glyph = mAtlas->GetGlyph((unsigned char)(*i));
+            if (glyph == NULL)
+            {
+               continue;
+            }
+
+            // Spaces only move the pen.
+            if (*i != ' ' && glyph->mWidth > 0.0f && glyph->mHeight > 0.0f)
+            {
+               AddQuad(label, osg::Vec2(penX, bottom), osg::Vec2(penX + glyph->mWidth, bottom + glyph->mHeight),
+                        glyph->mTexMin, glyph->mTexMax);
+            }
+            penX += glyph->mAdvance;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::AddQuad(BatchedLabel& label, const osg::Vec2& min, const osg::Vec2& max,
+               const osg::Vec2& texMin, const osg::Vec2& texMax)
+      {
+         label.mLocalVerts.push_back(min);
+         label.mLocalVerts.push_back(osg::Vec2(max.x(), min.y()));
+         label.mLocalVerts.push_back(max);
+         label.mLocalVerts.push_back(osg::Vec2(min.x(), max.y()));
+
+         label.mTexCoords.push_back(texMin);
+         label.mTexCoords.push_back(osg::Vec2(texMax.x(), texMin.y()));
+         label.mTexCoords.push_back(texMax);
+         label.mTexCoords.push_back(osg::Vec2(texMin.x(), texMax.y()));
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelGlyphBatch::FillVertexData()
+      {
+         mSortList.clear();
+         unsigned numVerts = 0;
+         LabelMap::const_iterator i, iend;
+         i = mLabels.begin();
+         iend = mLabels.end();
+         for (; i != iend; ++i)
+         {
+            mSortList.push_back(&i->second);
+            numVerts += unsigned(i->second.mLocalVerts.size());
+         }
+
+         // Farthest first so the nearer labels are drawn over them.
+         CompareLabelDepth compDepth;
+         std::sort(mSortList.begin(), mSortList.end(), compDepth);
+
+         mVertices->resize(numVerts);
+         mTexCoords->resize(numVerts);
+         mColors->resize(numVerts);
+
+         static const osg::Vec4 WHITE(1.0f, 1.0f, 1.0f, 1.0f);
+
+         unsigned v = 0;
+         for (unsigned l = 0; l < mSortList.size(); ++l)
+         {
+            const BatchedLabel& label = *mSortList[l];
+
+            // Snap to whole pixels so the glyphs aren't blurred.
+            float originX = std::floor(label.mScreenPos.x() * mScreenSize.x() + 0.5f);
+            float originY = std::floor(label.mScreenPos.y() * mScreenSize.y() + 0.5f);
+
+            // Text over a background is white, like the CEGUI labels, otherwise it is the label color.
+            unsigned numBackgroundVerts = label.mHasBackground ? 4 : 0;
+            const osg::Vec4& textColor = label.mHasBackground ? WHITE : label.mColor;
+
+            for (unsigned j = 0; j < label.mLocalVerts.size(); ++j, ++v)
+            {
+               const osg::Vec2& local = label.mLocalVerts[j];
+               (*mVertices)[v].set(originX + local.x(), originY + local.y(), 0.0f);
+               (*mTexCoords)[v] = label.mTexCoords[j];
+               (*mColors)[v] = j < numBackgroundVerts ? label.mColor : textColor;
+            }
+         }
+
+         mDrawArrays->setCount(numVerts);
+         mDrawArrays->dirty();
+         mVertices->dirty();
+         mTexCoords->dirty();
+         mColors->dirty();
+         mGeometry->dirtyBound();
+      }
+
+   }
+}
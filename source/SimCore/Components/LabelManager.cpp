@@ -34,22 +34,28 @@
 #include <SimCore/Actors/EntityActorRegistry.h>
 #include <SimCore/Actors/Platform.h>
 #include <SimCore/Components/BaseHUDElements.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
 #include <SimCore/Components/LabelManager.h>
+#include <SimCore/FrameProfiler.h>
 
 // TEMP:
 #include <dtCore/system.h>
 #include <dtCore/transform.h>
 #include <dtCore/enginepropertytypes.h>
+#include <dtCore/project.h>
 
 #include <dtUtil/boundingshapeutils.h>
+#include <dtUtil/configproperties.h>
 #include <dtUtil/exception.h>
 #include <dtUtil/log.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/threadpool.h>
 
+#include <osg/Camera>
 #include <osg/FrameStamp>
 #include <osg/Matrix>
 #include <osg/MatrixTransform>
+#include <osg/Viewport>
 #include <osgUtil/SceneView>
 #include <osgDB/WriteFile>
 // TEMP:
@@ -372,17 +378,33 @@ namespace SimCore
          return result;
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      const std::string LabelManager::CONFIG_PROP_BACKEND("LabelManager.Backend");
+      const std::string LabelManager::CONFIG_PROP_FONT("LabelManager.Font");
+      const std::string LabelManager::CONFIG_PROP_FONT_SIZE("LabelManager.FontSize");
+
+      const std::string LabelManager::BACKEND_CEGUI("CEGUI");
+      const std::string LabelManager::BACKEND_GLYPH_BATCH("GlyphBatch");
+      const std::string LabelManager::DEFAULT_FONT("CEGUI:fonts:DejaVuSans.ttf");
+
       //////////////////////////////////////////////////////////////////////////
       LabelManager::LabelManager()
       : mTimeUntilSort(0.0f)
+      , mUseGlyphBatch(false)
       {
          dtCore::System::GetInstance().TickSignal.connect_slot(this, &LabelManager::OnSystem);
+         mRefreshJob = new FrameBudgetJob("Label Refresh", "LabelManager",
+                  dtUtil::MakeFunctor(&LabelManager::RefreshLabels, this), FrameBudgetJob::PRIORITY_HIGH);
+         // Stale labels are noticed quickly.
+         mRefreshJob->SetMaxDeferredFrames(3);
       }
 
       //////////////////////////////////////////////////////////////////////////
       LabelManager::~LabelManager()
       {
          dtCore::System::GetInstance().TickSignal.disconnect(this);
+         mRefreshJob->RemoveFromFrameBudget();
+         SetUseGlyphBatch(false);
          ClearLabelsFromGUILayer();
       }
 
@@ -492,6 +514,113 @@ namespace SimCore
          return label;
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void LabelManager::SetGlyphAtlas(LabelGlyphAtlas* atlas)
+      {
+         // The batch draws with the atlas it was made with, so make a new one.
+         bool useBatch = mUseGlyphBatch;
+         SetUseGlyphBatch(false);
+         mGlyphAtlas = atlas;
+         SetUseGlyphBatch(useBatch);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphAtlas* LabelManager::GetGlyphAtlas()
+      {
+         return mGlyphAtlas.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelManager::SetUseGlyphBatch(bool useBatch)
+      {
+         if (useBatch == mUseGlyphBatch)
+         {
+            return;
+         }
+
+         if (useBatch)
+         {
+            if (!mGlyphAtlas.valid() || !mGM.valid())
+            {
+               LOG_WARNING("The label glyph batch needs a glyph atlas and a game manager, so the labels will stay CEGUI windows.");
+               return;
+            }
+
+            // The CEGUI labels are no longer needed.
+            ClearLabelsFromGUILayer();
+
+            mGlyphBatch = new LabelGlyphBatch(*mGlyphAtlas);
+            mGM->GetScene().GetSceneNode()->addChild(&mGlyphBatch->GetNode());
+         }
+         else
+         {
+            osg::Camera& node = mGlyphBatch->GetNode();
+            while (node.getNumParents() > 0)
+            {
+               node.getParent(0)->removeChild(&node);
+            }
+            mGlyphBatch = NULL;
+            mBatchedLabels.clear();
+            mForceColors.clear();
+         }
+
+         mUseGlyphBatch = useBatch;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool LabelManager::GetUseGlyphBatch() const
+      {
+         return mUseGlyphBatch;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      LabelGlyphBatch* LabelManager::GetGlyphBatch()
+      {
+         return mGlyphBatch.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void LabelManager::LoadConfiguration(const dtUtil::ConfigProperties& config)
+      {
+         std::string backend = config.GetConfigPropertyValue(CONFIG_PROP_BACKEND, BACKEND_CEGUI);
+         if (backend != BACKEND_GLYPH_BATCH)
+         {
+            if (backend != BACKEND_CEGUI)
+            {
+               LOG_WARNING("Unknown label backend \"" + backend + "\", so the labels will be CEGUI windows.");
+            }
+            SetUseGlyphBatch(false);
+            return;
+         }
+
+         if (!mGlyphAtlas.valid())
+         {
+            std::string font = config.GetConfigPropertyValue(CONFIG_PROP_FONT, DEFAULT_FONT);
+            std::string sizeValue = config.GetConfigPropertyValue(CONFIG_PROP_FONT_SIZE);
+            unsigned fontSize = sizeValue.empty() ? DEFAULT_FONT_SIZE : dtUtil::ToType<unsigned>(sizeValue);
+
+            std::string fontFile;
+            try
+            {
+               fontFile = dtCore::Project::GetInstance().GetResourcePath(dtCore::ResourceDescriptor(font));
+            }
+            catch (const dtUtil::Exception& ex)
+            {
+               ex.LogException(dtUtil::Log::LOG_ERROR);
+            }
+
+            dtCore::RefPtr<LabelGlyphAtlas> atlas = new LabelGlyphAtlas();
+            if (fontFile.empty() || !atlas->LoadFont(fontFile, fontSize))
+            {
+               LOG_ERROR("The label font \"" + font + "\" could not be loaded, so the labels will be CEGUI windows.");
+               return;
+            }
+            SetGlyphAtlas(atlas.get());
+         }
+
+         SetUseGlyphBatch(true);
+      }
+
       //////////////////////////////////////////////////////////////////////////
       void LabelManager::AddLabel(SimCore::Components::HUDLabel& label )
       {
@@ -539,6 +668,8 @@ namespace SimCore
       //////////////////////////////////////////////////////////////////////////
       void LabelManager::Update(float dt)
       {
+         SIMCORE_PROFILE_SCOPE("LabelManager::Update");
+
          // Get all entities from the game manager.
          typedef dtCore::ActorPtrVector ProxyList;
          ProxyList proxies;
@@ -554,6 +685,7 @@ namespace SimCore
          dtCore::Camera* deltaCamera = mGM->GetApplication().GetCamera();
 
          mCEGUISortList.clear(); // This should always happen between frames.
+         mBatchedLabels.clear();
 
          LabelMap newLabels;
 
@@ -576,6 +708,11 @@ namespace SimCore
 
          dtUtil::ThreadPool::ExecuteTasks();
 
+         if (mUseGlyphBatch)
+         {
+            UpdateGlyphBatch(*deltaCamera);
+         }
+
          //We stored add the labels we're using now in the new map, so we swap with the last set
          //for the next frame.
          mLastLabels.swap(newLabels);
@@ -584,6 +721,12 @@ namespace SimCore
       //////////////////////////////////////////////////////////////////////////
       void LabelManager::UpdateFormatting(float dt)
       {
+         // Batched labels have no windows to format.
+         if (mUseGlyphBatch)
+         {
+            return;
+         }
+
          // We have to set the text and size of the labels in the main thread since
          // it has a valid glContext and the other threads don't
          LabelMap::iterator i = mLastLabels.begin();
@@ -659,9 +802,6 @@ namespace SimCore
             return;
          }
 
-         // Find a label that is not being used.
-         label = GetOrCreateLabel(actor);
-
          dtCore::StringActorProperty* mappingTypeProp = NULL;
          actor.GetProperty(SimCore::Actors::BaseEntityActorProxy::PROPERTY_MAPPING_NAME, mappingTypeProp);
          if (mappingTypeProp != NULL)
@@ -673,6 +813,37 @@ namespace SimCore
             nameBuffer = actor.GetName();
          }
 
+         if (mUseGlyphBatch)
+         {
+            BatchedLabelInfo info;
+            info.mId = xformable->GetUniqueId();
+            info.mText = nameBuffer;
+
+            dtCore::ActorProperty* damProp = NULL;
+            actor.GetProperty(SimCore::Actors::BaseEntityActorProxy::PROPERTY_DAMAGE_STATE, damProp);
+            if (damProp != NULL && GetOptions().ShowDamageState())
+            {
+               info.mLine2 = damProp->ToString();
+            }
+
+            const SimCore::Actors::BaseEntity* entity = NULL;
+            actor.GetDrawable(entity);
+            info.mForce = entity != NULL ? &entity->GetForceAffiliation() : &SimCore::Actors::BaseEntityActorProxy::ForceEnum::OTHER;
+            info.mActor = &actor;
+
+            // Undo the conversion to CEGUI coordinates.
+            osg::Vec2 pos = CalculateLabelScreenPosition(radius, center, deltaCamera, screenPos, osg::Vec2());
+            info.mScreenPos.set(pos.x() + 0.5f, -pos.y());
+            info.mDepth = screenPos.z();
+
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mTaskMutex);
+            mBatchedLabels.push_back(info);
+            return;
+         }
+
+         // Find a label that is not being used.
+         label = GetOrCreateLabel(actor);
+
          if (nameBuffer != label->GetText())
          {
             label->SetText(nameBuffer);
@@ -713,6 +884,47 @@ namespace SimCore
 
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void LabelManager::UpdateGlyphBatch(dtCore::Camera& deltaCamera)
+      {
+         const osg::Viewport* viewport = deltaCamera.GetOSGCamera()->getViewport();
+         if (viewport != NULL)
+         {
+            mGlyphBatch->SetScreenSize(viewport->width(), viewport->height());
+         }
+
+         mGlyphBatch->BeginFrame();
+         for (unsigned i = 0; i < mBatchedLabels.size(); ++i)
+         {
+            const BatchedLabelInfo& info = mBatchedLabels[i];
+            mGlyphBatch->SetLabel(info.mId, info.mText, info.mLine2,
+                     GetForceColor(info.mForce, *info.mActor), info.mScreenPos, info.mDepth);
+         }
+         mGlyphBatch->EndFrame();
+
+         mBatchedLabels.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const osg::Vec4& LabelManager::GetForceColor(const dtUtil::Enumeration* force, const dtCore::BaseActorObject& actor)
+      {
+         ForceColorMap::iterator found = mForceColors.find(force);
+         if (found != mForceColors.end())
+         {
+            return found->second;
+         }
+
+         if (!mColorLabel.valid())
+         {
+            mColorLabel = new SimCore::Components::HUDLabel("LabelColors" + dtCore::UniqueId().ToString(), "Label/EntityLabel");
+         }
+
+         AssignLabelColor(actor, *mColorLabel);
+         osg::Vec4 color;
+         mColorLabel->GetColor(color);
+         return mForceColors.insert(std::make_pair(force, color)).first->second;
+      }
+
       //////////////////////////////////////////////////////////////////////////
       const std::string LabelManager::AssignLabelColor( const dtCore::BaseActorObject& actor, HUDLabel& label)
       {
@@ -861,6 +1073,11 @@ namespace SimCore
          // which we need, so here is where the update occurs.
          if (phase == dtCore::System::MESSAGE_FRAME_SYNCH)
          {
+            if (mGM.valid() && FrameBudgetComponent::RequestJob(*mGM, *mRefreshJob))
+            {
+               return;
+            }
+
             try
             {
                Update(deltaSim);
@@ -879,6 +1096,24 @@ namespace SimCore
 
 
 
+      //////////////////////////////////////////////////////////////////////////
+      void LabelManager::RefreshLabels()
+      {
+         // Errors are logged here so they don't stop the other frame budget jobs.
+         try
+         {
+            Update(0.0f);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            ex.LogException(dtUtil::Log::LOG_ERROR);
+         }
+         catch (const CEGUI::Exception& ce)
+         {
+            LOG_ERROR(ce.getMessage().c_str());
+         }
+      }
+
       //////////////////////////////////////////////////////////////////////////
       // CLASS CODE
       //////////////////////////////////////////////////////////////////////////
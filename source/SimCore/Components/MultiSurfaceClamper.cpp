@@ -27,6 +27,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/Components/MultiSurfaceClamper.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
+#include <SimCore/FrameProfiler.h>
 #include <dtCore/batchisector.h>
 #include <dtCore/scene.h>
 #include <dtCore/transform.h>
@@ -363,6 +365,7 @@ namespace SimCore
          : BaseClass()
          , mCurrentSimTime(0.0)
          , mDefaultDomain(&SimCore::Actors::BaseEntityActorProxy::DomainEnum::GROUND)
+         , mDeferClamping(false)
       {
          SetIntermittentGroundClampingTimeDelta(2.0f);
       }
@@ -398,7 +401,7 @@ namespace SimCore
             // NOTE: Animation component does not specify a velocity but does set
             // transformChanged flag to TRUE. Checking the flag will allow the animated
             // characters clamp as expected.
-            else if (!transformChanged && velocity.length2() == 0.0f)
+            else if (mDeferClamping || (!transformChanged && velocity.length2() == 0.0f))
             {
                clampType = &dtGame::BaseGroundClamper::GroundClampRangeType::INTERMITTENT_SAVE_OFFSET;
             }
@@ -413,6 +416,8 @@ namespace SimCore
          dtCore::TransformableActorProxy& proxy, dtGame::GroundClampingData& data,
          bool transformChanged, const osg::Vec3& velocity)
       {
+         SIMCORE_PROFILE_SCOPE("MultiSurfaceClamper::ClampToGround");
+
          // Maintain the current simulation time across subsequent methods.
          mCurrentSimTime = currentTime;
 
@@ -437,9 +442,33 @@ namespace SimCore
             }
          }
 
+         // Far away entities can hold their offset from the ground for a while when the frame is busy.
+         mDeferClamping = false;
+         if( mFrameBudget.valid() && mFrameBudget->IsOverBudget() )
+         {
+            osg::Vec3 pos;
+            xform.GetTranslation( pos );
+            float range = GetHighResGroundClampingRange();
+            mDeferClamping = (pos - GetLastEyePoint()).length2() > range * range;
+         }
+
          // Continue with regular clamping operations.
          BaseClass::ClampToGround(type, currentTime, xform, proxy, data,
             transformChanged, velocity);
+
+         mDeferClamping = false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MultiSurfaceClamper::SetFrameBudget( FrameBudgetComponent* frameBudget )
+      {
+         mFrameBudget = frameBudget;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      FrameBudgetComponent* MultiSurfaceClamper::GetFrameBudget()
+      {
+         return mFrameBudget.get();
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -122,6 +122,19 @@ namespace SimCore
          return iter != mNameToMunitionMap.end() ? iter->second.get() : NULL;
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionDamageTable::GetMunitionDamageList( std::vector<const MunitionDamage*>& outList ) const
+      {
+         outList.reserve( outList.size() + mNameToMunitionMap.size() );
+
+         std::map< std::string, dtCore::RefPtr<MunitionDamage> >::const_iterator iter =
+            mNameToMunitionMap.begin();
+         for( ; iter != mNameToMunitionMap.end(); ++iter )
+         {
+            outList.push_back( iter->second.get() );
+         }
+      }
+
       //////////////////////////////////////////////////////////////////////////
       void MunitionDamageTable::Clear()
       {
@@ -27,6 +27,7 @@
 #include <prefix/SimCorePrefix.h>
 #include <dtUtil/mswin.h>
 #include <algorithm>
+#include <set>
 // DELTA 3D
 #include <dtABC/application.h>
 #include <dtAudio/audiomanager.h>
@@ -38,18 +39,25 @@
 #include <dtGame/basemessages.h>
 #include <dtGame/deadreckoningcomponent.h>
 #include <dtGame/gamemanager.h>
+#include <dtGame/messagefactory.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/matrixutil.h>
 #include <dtUtil/configproperties.h>
+#include <osg/Timer>
 
 // SIM Core
 #include <SimCore/Messages.h>
 #include <SimCore/MessageType.h>
+#include <SimCore/FIDCodeIndex.h>
+#include <SimCore/FrameProfiler.h>
+#include <SimCore/StartupTracer.h>
 // Components
 #include <SimCore/Components/DamageHelper.h>
+#include <SimCore/Components/DetonationActorPool.h>
 #include <SimCore/Components/MunitionDamage.h>
 #include <SimCore/Components/MunitionsComponent.h>
 #include <SimCore/Components/MunitionsConfig.h>
+#include <SimCore/Components/MunitionsConfigCache.h>
 #include <SimCore/Components/ViewerMaterialComponent.h>
 // Actors
 #include <SimCore/Actors/Platform.h>
@@ -67,6 +75,42 @@ namespace SimCore
 {
    namespace Components
    {
+      //////////////////////////////////////////////////////////////////////////
+      // Munition Table Preload Task Code
+      //////////////////////////////////////////////////////////////////////////
+      const std::string MunitionTablePreloadTask::DEFAULT_NAME("Munition Damage Tables Preload");
+
+      //////////////////////////////////////////////////////////////////////////
+      MunitionTablePreloadTask::MunitionTablePreloadTask( const std::string& resourcePath, bool useCache )
+         : SimCore::StartupPreloadTask(DEFAULT_NAME)
+         , mResourcePath(resourcePath)
+         , mUseCache(useCache)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      MunitionTablePreloadTask::~MunitionTablePreloadTask()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const std::string& MunitionTablePreloadTask::GetResourcePath() const
+      {
+         return mResourcePath;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      std::vector<dtCore::RefPtr<MunitionDamageTable> >& MunitionTablePreloadTask::GetTables()
+      {
+         return mTables;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionTablePreloadTask::Run()
+      {
+         MunitionsComponent::ReadMunitionDamageTables( mResourcePath, mUseCache, mTables );
+      }
+
       //////////////////////////////////////////////////////////////////////////
       // Munitions Component Code
       //////////////////////////////////////////////////////////////////////////
@@ -77,10 +121,17 @@ namespace SimCore
       MunitionsComponent::MunitionsComponent( dtCore::SystemComponentType& type )
          : dtGame::GMComponent(type)
          , mMunitionConfigFileName("Configs:MunitionsConfig.xml")
+         , mUseMunitionConfigCache(true)
          , mMaximumActiveMunitions(200U)
+         , mUseDetonationPool(true)
+         , mDetonationPoolPreloadCount(0U)
          , mMunitionTypeTable(new MunitionTypeTable())
          , mIsector(new dtCore::BatchIsector)
          , mEffectsManager(new WeaponEffectsManager)
+         , mDetonationPool(new DetonationActorPool)
+         , mNextQueueSerial(0U)
+         , mNumWeaponEventBatchesProcessed(0)
+         , mNumBatchedWeaponEventsProcessed(0)
       {
       }
 
@@ -91,13 +142,29 @@ namespace SimCore
          ClearRegisteredEntities();
          ClearTables();
          if( mMunitionTypeTable.valid() ) { mMunitionTypeTable->Clear(); }
+         mDetonationPool->Clear();
       }
 
       //////////////////////////////////////////////////////////////////////////
       DT_IMPLEMENT_ACCESSOR(MunitionsComponent, std::string, DefaultMunitionName);
       DT_IMPLEMENT_ACCESSOR(MunitionsComponent, std::string, DefaultKineticRoundMunitionName);
       DT_IMPLEMENT_ACCESSOR(MunitionsComponent, std::string, MunitionConfigFileName);
+      DT_IMPLEMENT_ACCESSOR(MunitionsComponent, bool, UseMunitionConfigCache);
       DT_IMPLEMENT_ACCESSOR_GETTER(MunitionsComponent, unsigned, MaximumActiveMunitions);
+      DT_IMPLEMENT_ACCESSOR(MunitionsComponent, bool, UseDetonationPool);
+      DT_IMPLEMENT_ACCESSOR(MunitionsComponent, unsigned, DetonationPoolPreloadCount);
+
+      //////////////////////////////////////////////////////////////////////////
+      DetonationActorPool& MunitionsComponent::GetDetonationActorPool()
+      {
+         return *mDetonationPool;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const DetonationActorPool& MunitionsComponent::GetDetonationActorPool() const
+      {
+         return *mDetonationPool;
+      }
 
       //////////////////////////////////////////////////////////////////////////
       DamageHelper* MunitionsComponent::CreateDamageHelper( SimCore::Actors::BaseEntity& entity,
@@ -227,18 +294,91 @@ namespace SimCore
             return 0;
          }
 
+         StartupTracer::Phase phase( "Munition Damage Tables" );
+
          // Capture new tables in a vector
          std::vector<dtCore::RefPtr<MunitionDamageTable> > tables;
 
-         // Parse the new table data
-         dtCore::RefPtr<MunitionsConfig> mParser = new MunitionsConfig();
-         unsigned int successes =
-            mParser->LoadMunitionTables( resourcePath, tables );
-         mParser = NULL;
+         unsigned int successes = 0;
+
+         // Use the tables read during startup if they are from the same file.
+         if( mTablePreload.valid() && mTablePreload->GetResourcePath() == resourcePath )
+         {
+            mTablePreload->WaitUntilFinished();
+            tables.swap( mTablePreload->GetTables() );
+            successes = unsigned(tables.size());
+            mTablePreload = NULL;
+         }
+
+         if( successes == 0 )
+         {
+            successes = ReadMunitionDamageTables( resourcePath, GetUseMunitionConfigCache(), tables );
+         }
+
+         return AddMunitionDamageTables( tables, successes );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<MunitionTablePreloadTask> MunitionsComponent::CreateMunitionTablePreload()
+      {
+         mTablePreload = NULL;
+         if (mMunitionConfigFileName.empty())
+         {
+            return NULL;
+         }
+
+         // The project isn't thread safe, so the path is found here rather than in the task.
+         std::string resourcePath = dtCore::Project::GetInstance()
+            .GetResourcePath(dtCore::ResourceDescriptor( mMunitionConfigFileName ));
+         if( resourcePath.empty() )
+         {
+            return NULL;
+         }
+
+         mTablePreload = new MunitionTablePreloadTask( resourcePath, GetUseMunitionConfigCache() );
+         return mTablePreload;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned int MunitionsComponent::ReadMunitionDamageTables( const std::string& resourcePath, bool useCache,
+         std::vector<dtCore::RefPtr<MunitionDamageTable> >& outTables )
+      {
+         unsigned int successes = 0;
 
+         // Try the compiled copy first; it is refused if the xml has changed since it was written.
+         dtCore::RefPtr<MunitionsConfigCache> cache;
+         std::string cachePath;
+         if( useCache )
+         {
+            cache = new MunitionsConfigCache();
+            cachePath = MunitionsConfigCache::GetCacheFilePath( resourcePath );
+            successes = cache->Load( resourcePath, cachePath, outTables );
+         }
+
+         if( successes == 0 )
+         {
+            // Parse the new table data
+            dtCore::RefPtr<MunitionsConfig> mParser = new MunitionsConfig();
+            successes = mParser->LoadMunitionTables( resourcePath, outTables );
+            mParser = NULL;
+
+            // Regenerate the compiled copy for next time. Failing to write it is harmless.
+            if( cache.valid() && successes > 0 )
+            {
+               cache->Save( resourcePath, cachePath, outTables );
+            }
+         }
+
+         return successes;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned int MunitionsComponent::AddMunitionDamageTables(
+         const std::vector<dtCore::RefPtr<MunitionDamageTable> >& tables, unsigned int successes )
+      {
          // Iterate through new tables and add/replace them into the table map
          MunitionDamageTable* existingTable = NULL;
-         std::vector<dtCore::RefPtr<MunitionDamageTable> >::iterator iter = tables.begin();
+         std::vector<dtCore::RefPtr<MunitionDamageTable> >::const_iterator iter = tables.begin();
          for( ; iter != tables.end(); ++iter )
          {
             MunitionDamageTable* curTable = iter->get();
@@ -277,6 +417,8 @@ namespace SimCore
       /////////////////////////////////////////////////////////////////////
       void MunitionsComponent::ProcessMessage( const dtGame::Message& message )
       {
+         SIMCORE_PROFILE_SCOPE("MunitionsComponent::ProcessMessage");
+
          const dtGame::MessageType& type = message.GetMessageType();
 
          // Update the effects manager
@@ -306,6 +448,10 @@ namespace SimCore
          {
             OnShotFired(message);
          }
+         else if (type == SimCore::MessageType::WEAPON_EVENT_BATCH)
+         {
+            OnWeaponEventBatch(message);
+         }
          // Capture the player
          else if (message.GetMessageType() == dtGame::MessageType::INFO_PLAYER_ENTERED_WORLD)
          {
@@ -348,12 +494,14 @@ namespace SimCore
             }
 
             CleanupCreatedMunitionsQueue();
+            PreloadDetonations();
          }
          else if (type == dtGame::MessageType::INFO_RESTARTED
             || type == dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN)
          {
             mPlayer = NULL;
             ClearCreatedMunitionsQueue();
+            mDetonationPool->Clear();
             ClearRegisteredEntities();
             ClearTables();
             mMunitionTypeTable->Clear();
@@ -463,6 +611,63 @@ namespace SimCore
          }
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponent::OnWeaponEventBatch(const dtGame::Message& message)
+      {
+         const WeaponEventBatchMessage& batchMessage =
+            static_cast<const WeaponEventBatchMessage&> (message);
+
+         mBatchedEvents.clear();
+         if (!batchMessage.GetEvents(mBatchedEvents))
+         {
+            LOG_WARNING("Received an invalid weapon event batch message.");
+            return;
+         }
+
+         ++mNumWeaponEventBatchesProcessed;
+         mNumBatchedWeaponEventsProcessed += unsigned(mBatchedEvents.size());
+
+         // The same two messages are refilled for each event.  They carry the source of the batch
+         // so the remote checks in OnShotFired still work.
+         dtGame::MessageFactory& factory = GetGameManager()->GetMessageFactory();
+         std::vector<WeaponEvent>::const_iterator iter = mBatchedEvents.begin();
+         for( ; iter != mBatchedEvents.end(); ++iter )
+         {
+            if (iter->mIsDetonation)
+            {
+               if (!mBatchedDetonationMessage.valid())
+               {
+                  factory.CreateMessage(SimCore::MessageType::DETONATION, mBatchedDetonationMessage);
+               }
+               iter->FillDetonationMessage(*mBatchedDetonationMessage);
+               mBatchedDetonationMessage->SetSource(message.GetSource());
+               OnDetonation(*mBatchedDetonationMessage);
+            }
+            else
+            {
+               if (!mBatchedShotMessage.valid())
+               {
+                  factory.CreateMessage(SimCore::MessageType::SHOT_FIRED, mBatchedShotMessage);
+               }
+               iter->FillShotFiredMessage(*mBatchedShotMessage);
+               mBatchedShotMessage->SetSource(message.GetSource());
+               OnShotFired(*mBatchedShotMessage);
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned MunitionsComponent::GetNumWeaponEventBatchesProcessed() const
+      {
+         return mNumWeaponEventBatchesProcessed;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned MunitionsComponent::GetNumBatchedWeaponEventsProcessed() const
+      {
+         return mNumBatchedWeaponEventsProcessed;
+      }
+
       //////////////////////////////////////////////////////////////////////////
       DamageHelper* MunitionsComponent::GetHelperByEntityId( const dtCore::UniqueId& id )
       {
@@ -688,9 +893,31 @@ namespace SimCore
 
          int fidID = 0;
          RunIsectorForFIDCodes(hitEntity, message, fidID);
-         
-         // Prepare a detonation actor to be placed into the scene
-         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy>  proxy = CreateDetonationPrototype(message);
+
+         Actors::DetonationActor::IMPACT_TYPE impact = Actors::DetonationActor::IMPACT_TERRAIN;
+         if(entityIsHuman)
+         {
+            impact = Actors::DetonationActor::IMPACT_HUMAN;
+         }
+         else if(hitEntity)
+         {
+            impact = Actors::DetonationActor::IMPACT_ENTITY;
+         }
+
+         osg::Timer_t spawnStart = osg::Timer::instance()->tick();
+
+         // Prepare a detonation actor to be placed into the scene.  A pooled one may already be in it.
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> proxy;
+         bool reused = false;
+         if(mUseDetonationPool && !munitionType.GetDetonationActor().ToString().empty())
+         {
+            proxy = mDetonationPool->Acquire(munitionType.GetDetonationActor(), impact, reused);
+         }
+         else
+         {
+            proxy = CreateDetonationPrototype(message);
+         }
+
          if(!proxy.valid())
          {
             LOG_ERROR("Unable to create detonation prototype, aborting ApplyDetonationEffects()");
@@ -707,19 +934,7 @@ namespace SimCore
             return;
          }
 
-         //set the impact type
-         if(entityIsHuman)
-         {
-            da->SetImpactType(Actors::DetonationActor::IMPACT_HUMAN);
-         }
-         else if(hitEntity)
-         {
-            da->SetImpactType(Actors::DetonationActor::IMPACT_ENTITY);
-         }
-         else
-         {
-            da->SetImpactType(Actors::DetonationActor::IMPACT_TERRAIN);
-         }
+         da->SetImpactType(impact);
 
          // Set the detonation's position
          osg::Vec3 pos = message.GetDetonationLocation();
@@ -753,9 +968,44 @@ namespace SimCore
          da->SetPhysicsEnabled( ! avoidPhysics );
 
          // Add the newly created detonation to the scene
-         GetGameManager()->AddActor(da->GetGameActorProxy(), false, false);
+         if(!reused)
+         {
+            GetGameManager()->AddActor(da->GetGameActorProxy(), false, false);
+         }
 
+         // Pooled detonations don't start when they enter the world.
+         if(da->GetPool() != NULL)
+         {
+            da->Detonate();
+         }
+
+         // A reused detonation may still have an entry from the last time it was used,
+         // which this one replaces.
          AddMunitionToCreatedMunitionsQueue(da->GetUniqueId());
+
+         mDetonationPool->RecordSpawnTime(osg::Timer::instance()->delta_m(spawnStart, osg::Timer::instance()->tick()));
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponent::PreloadDetonations()
+      {
+         if(!mUseDetonationPool || mDetonationPoolPreloadCount == 0)
+         {
+            return;
+         }
+
+         // Munition types often share a detonation prototype.
+         std::set<dtCore::UniqueId> prototypeIds;
+         const std::vector<dtCore::RefPtr<SimCore::Actors::MunitionTypeActor> >& munitionTypes
+            = mMunitionTypeTable->GetOrderedList();
+         for(unsigned i = 0; i < munitionTypes.size(); ++i)
+         {
+            const dtCore::UniqueId& prototypeId = munitionTypes[i]->GetDetonationActor();
+            if(!prototypeId.ToString().empty() && prototypeIds.insert(prototypeId).second)
+            {
+               mDetonationPool->Preload(prototypeId, Actors::DetonationActor::IMPACT_TERRAIN, mDetonationPoolPreloadCount);
+            }
+         }
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -787,6 +1037,19 @@ namespace SimCore
 
          mIsector->SetScene( &GetGameManager()->GetScene() );
          mEffectsManager->SetGameManager( GetGameManager() );
+         mDetonationPool->SetGameManager( GetGameManager() );
+
+         std::string poolValue = config.GetConfigPropertyValue(GetName() + ".UseDetonationPool");
+         if (!poolValue.empty())
+         {
+            SetUseDetonationPool(dtUtil::ToType<bool>(poolValue));
+         }
+
+         std::string preloadValue = config.GetConfigPropertyValue(GetName() + ".DetonationPoolPreloadCount");
+         if (!preloadValue.empty())
+         {
+            SetDetonationPoolPreloadCount(dtUtil::ToType<unsigned>(preloadValue));
+         }
 
          std::string stringValue = config.GetConfigPropertyValue(this->GetName() + ".MaximumActiveMunitions");
          if (!stringValue.empty())
@@ -896,21 +1159,23 @@ namespace SimCore
          return effects;
       }
 
-      // This simple structure is a remove functor for the remove_if operator on the
-      // active munitions deque. It basically checks to see if the unique id exists
+      // This simple structure checks the entries of the active munitions deque.
+      // It basically checks to see if the unique id exists
       // in the GM or not so that we can delete old id's from our queue when we clean up.
       struct RemoveOldMunitionsChecker
       {
-         RemoveOldMunitionsChecker(dtGame::GameManager &gm) : theGM(gm) { }
+         RemoveOldMunitionsChecker(dtGame::GameManager &gm, const DetonationActorPool& pool) : theGM(gm), thePool(pool) { }
 
          // check to see if the unique id exists in the GM (return false) or not (return true).
+         // Pooled detonations waiting to be reused are no longer active.
          bool operator()(const dtCore::UniqueId idToCheck)
          {
-            bool bFound = theGM.FindActorById(idToCheck) == NULL;
+            bool bFound = theGM.FindActorById(idToCheck) == NULL || thePool.IsIdle(idToCheck);
             return bFound;
          }
 
          dtGame::GameManager &theGM;
+         const DetonationActorPool& thePool;
       };
 
 
@@ -928,6 +1193,7 @@ namespace SimCore
       void MunitionsComponent::ClearCreatedMunitionsQueue()
       {
          mCreatedMunitionsQueue.clear();
+         mQueuedMunitionSerials.clear();
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -936,12 +1202,31 @@ namespace SimCore
          if (!mCreatedMunitionsQueue.empty())
          {
             // First, we remove all of entries in our queue that are no longer valid. Usually happens if the
-            // Actors were deleted, probably from timing out.
-               mCreatedMunitionsQueue.erase(std::remove_if(mCreatedMunitionsQueue.begin(),
-                  mCreatedMunitionsQueue.end(), RemoveOldMunitionsChecker(*GetGameManager())), mCreatedMunitionsQueue.end());
+            // Actors were deleted, probably from timing out, or the entry was replaced when the detonation was reused.
+            RemoveOldMunitionsChecker isOld(*GetGameManager(), *mDetonationPool);
+            std::deque<QueuedMunition>::iterator kept = mCreatedMunitionsQueue.begin();
+            std::deque<QueuedMunition>::iterator i, iend = mCreatedMunitionsQueue.end();
+            for (i = mCreatedMunitionsQueue.begin(); i != iend; ++i)
+            {
+               std::map<dtCore::UniqueId, unsigned>::iterator serial = mQueuedMunitionSerials.find(i->first);
+               if (serial == mQueuedMunitionSerials.end() || serial->second != i->second)
+               {
+                  continue;
+               }
+
+               if (isOld(i->first))
+               {
+                  mQueuedMunitionSerials.erase(serial);
+                  continue;
+               }
+
+               *kept = *i;
+               ++kept;
+            }
+            mCreatedMunitionsQueue.erase(kept, mCreatedMunitionsQueue.end());
 
             // if we still have too many valid munitions, remove them from the front until we have the right size.
-            int curSize = mCreatedMunitionsQueue.size();
+            int curSize = mQueuedMunitionSerials.size();
             for (int i = curSize - mMaximumActiveMunitions; i > 0; i --)
             {
                RemoveOldestMunitionFromQueue();
@@ -952,32 +1237,62 @@ namespace SimCore
       //////////////////////////////////////////////////////////////////////////
       void MunitionsComponent::RemoveOldestMunitionFromQueue()
       {
-         if (!mCreatedMunitionsQueue.empty())
+         // Skip the entries replaced when their detonation was reused.
+         while (!mCreatedMunitionsQueue.empty())
          {
-            const dtCore::UniqueId frontId = mCreatedMunitionsQueue.front();
+            const QueuedMunition front = mCreatedMunitionsQueue.front();
             mCreatedMunitionsQueue.pop_front();
 
+            std::map<dtCore::UniqueId, unsigned>::iterator serial = mQueuedMunitionSerials.find(front.first);
+            if (serial == mQueuedMunitionSerials.end() || serial->second != front.second)
+            {
+               continue;
+            }
+            mQueuedMunitionSerials.erase(serial);
+
+            const dtCore::UniqueId& frontId = front.first;
+
             dtCore::ActorProxy *frontProxy = GetGameManager()->FindActorById(frontId);
             if (frontProxy != NULL)
-               GetGameManager()->DeleteActor(*frontProxy);
+            {
+               // Pooled detonations are put back in the pool instead.
+               SimCore::Actors::DetonationActorProxy* detonationProxy
+                  = dynamic_cast<SimCore::Actors::DetonationActorProxy*>(frontProxy);
+               if (detonationProxy == NULL || !mDetonationPool->Release(*detonationProxy))
+               {
+                  GetGameManager()->DeleteActor(*frontProxy);
+               }
+            }
+            break;
          }
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      unsigned MunitionsComponent::GetNumCreatedMunitions() const
+      {
+         return unsigned(mQueuedMunitionSerials.size());
+      }
+
       //////////////////////////////////////////////////////////////////////////
       void MunitionsComponent::AddMunitionToCreatedMunitionsQueue(const dtCore::UniqueId& uniqueId)
       {
          // Add it to the back, and then clean up if we have too many.
-         mCreatedMunitionsQueue.push_back(uniqueId);
-
-         unsigned curSize = mCreatedMunitionsQueue.size();
-         if (curSize > mMaximumActiveMunitions)
+         // An earlier entry for the same id is now out of date, and is dropped when it is reached.
+         ++mNextQueueSerial;
+         mQueuedMunitionSerials[uniqueId] = mNextQueueSerial;
+         mCreatedMunitionsQueue.push_back(QueuedMunition(uniqueId, mNextQueueSerial));
+
+         // The out of date entries are dropped by the cleanup too, so they can't build up
+         // to more than the live ones.
+         unsigned curSize = mQueuedMunitionSerials.size();
+         if (curSize > mMaximumActiveMunitions || mCreatedMunitionsQueue.size() > 2U * mMaximumActiveMunitions)
          {
             CleanupCreatedMunitionsQueue();
          }
       }
 
       //////////////////////////////////////////////////////////////////////////
-      void MunitionsComponent::RunIsectorForFIDCodes(bool hitEntity, const DetonationMessage& message, int fidID)
+      void MunitionsComponent::RunIsectorForFIDCodes(bool hitEntity, const DetonationMessage& message, int& fidID)
       {
          //set to a default value
          fidID = 0;
@@ -1023,25 +1338,9 @@ namespace SimCore
 
             SingleISector.GetHitPoint(hp);
             const osg::Drawable* drawable = SingleISector.GetIntersectionHit(0)._drawable.get();
-            if( drawable != NULL && drawable->getStateSet() != NULL)
+            if( drawable != NULL )
             {
-               RefPtr<const osg::IntArray> mOurList
-                  = dynamic_cast<const osg::IntArray*>(drawable->getStateSet()->getUserData());
-               if( mOurList.valid() )
-               {
-                  if( ! mOurList->empty() )
-                  {
-                     int value[4];
-                     int iter = 0;
-                     osg::IntArray::const_iterator listiter = mOurList->begin();
-                     for(; listiter != mOurList->end(); listiter++)
-                     {
-                        value[iter] = *listiter;
-                        ++iter;
-                     }
-                     fidID = value[0];
-                  }
-               }
+               SimCore::FIDCodeIndex::ReadFIDCode(*drawable, fidID);
             }
 
             if (dtUtil::Log::GetInstance().IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
@@ -0,0 +1,447 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <prefix/SimCorePrefix.h>
+
+#include <dtUtil/datapathutils.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
+
+#include <osgDB/FileNameUtils>
+
+#include <SimCore/Components/MunitionDamage.h>
+#include <SimCore/Components/MunitionDamageTable.h>
+#include <SimCore/Components/MunitionsConfigCache.h>
+#include <SimCore/MappedFile.h>
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      // Which optional parts of a munition damage were written.
+      enum MunitionDamageParts
+      {
+         PART_DIRECT_FIRE = 0x01,
+         PART_INDIRECT_FIRE = 0x02,
+         PART_RANGE_1_3 = 0x04,
+         PART_RANGE_2_3 = 0x08,
+         PART_RANGE_MAX = 0x10
+      };
+
+      //////////////////////////////////////////////////////////////////////////
+      // Constants
+      //////////////////////////////////////////////////////////////////////////
+      const std::string MunitionsConfigCache::CACHE_FILE_EXTENSION(".bin");
+      const unsigned MunitionsConfigCache::CACHE_FILE_MAGIC = 0x4E554D53; // "SMUN"
+      const unsigned MunitionsConfigCache::CACHE_FILE_VERSION = 1;
+
+      //////////////////////////////////////////////////////////////////////////
+      // Source Stamp Code
+      //////////////////////////////////////////////////////////////////////////
+      MunitionsConfigCache::SourceStamp::SourceStamp()
+         : mModifiedTime(0.0)
+         , mFileSize(0U)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool MunitionsConfigCache::SourceStamp::operator== (const SourceStamp& other) const
+      {
+         return mModifiedTime == other.mModifiedTime && mFileSize == other.mFileSize;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool MunitionsConfigCache::SourceStamp::operator!= (const SourceStamp& other) const
+      {
+         return ! (*this == other);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      // Munition Config Cache Code
+      //////////////////////////////////////////////////////////////////////////
+      MunitionsConfigCache::MunitionsConfigCache()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      MunitionsConfigCache::~MunitionsConfigCache()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      std::string MunitionsConfigCache::GetCacheDirectory()
+      {
+         std::string home = dtUtil::GetHomeDirectory();
+         if( home.empty() )
+         {
+            return home;
+         }
+         return home + "/.delta3d/cache/SimCore";
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      std::string MunitionsConfigCache::GetCacheFilePath( const std::string& xmlFilePath )
+      {
+         std::string cacheDir = GetCacheDirectory();
+         if( cacheDir.empty() )
+         {
+            return xmlFilePath + CACHE_FILE_EXTENSION;
+         }
+
+         std::ostringstream hash;
+         hash << std::hex << std::hash<std::string>()( xmlFilePath );
+         return cacheDir + "/" + osgDB::getSimpleFileName( xmlFilePath ) + "_" + hash.str() + CACHE_FILE_EXTENSION;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      static bool MakeCacheDirectory( const std::string& dir )
+      {
+         dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+         if( dir.empty() || fileUtils.DirExists( dir ) )
+         {
+            return true;
+         }
+
+         // The parents of the cache directory may not exist yet either.
+         if( ! MakeCacheDirectory( osgDB::getFilePath( dir ) ) )
+         {
+            return false;
+         }
+
+         try
+         {
+            fileUtils.MakeDirectory( dir );
+         }
+         catch( const dtUtil::Exception& ex )
+         {
+            LOG_INFO( "Unable to make the munition config cache directory \"" + dir + "\": " + ex.What() );
+            return false;
+         }
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool MunitionsConfigCache::GetSourceStamp( const std::string& xmlFilePath, SourceStamp& outStamp )
+      {
+         dtUtil::FileInfo info = dtUtil::FileUtils::GetInstance().GetFileInfo( xmlFilePath );
+         if( info.fileType != dtUtil::REGULAR_FILE )
+         {
+            return false;
+         }
+
+         outStamp.mModifiedTime = double(info.lastModified);
+         outStamp.mFileSize = unsigned(info.size);
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool MunitionsConfigCache::Save( const std::string& xmlFilePath, const std::string& cacheFilePath,
+         const TableList& tables ) const
+      {
+         SourceStamp stamp;
+         if( ! GetSourceStamp( xmlFilePath, stamp ) )
+         {
+            return false;
+         }
+
+         if( ! MakeCacheDirectory( osgDB::getFilePath( cacheFilePath ) ) )
+         {
+            return false;
+         }
+
+         dtUtil::DataStream ds;
+         Encode( ds, stamp, tables );
+
+         std::ofstream out( cacheFilePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+         if( ! out.is_open() )
+         {
+            LOG_INFO( "Unable to write the munition config cache \"" + cacheFilePath + "\"." );
+            return false;
+         }
+
+         out.write( ds.GetBuffer(), ds.GetBufferSize() );
+         return out.good();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned int MunitionsConfigCache::Load( const std::string& xmlFilePath, const std::string& cacheFilePath,
+         TableList& outTables ) const
+      {
+         SourceStamp stamp;
+         if( ! GetSourceStamp( xmlFilePath, stamp ) )
+         {
+            return 0;
+         }
+
+         // Decode straight from the mapped file rather than copying it into memory first.
+         dtCore::RefPtr<SimCore::MappedFile> file = new SimCore::MappedFile;
+         if( ! file->Open( cacheFilePath ) || file->GetData() == NULL )
+         {
+            return 0;
+         }
+
+         TableList tables;
+         // The stream is only read, so it doesn't write to the read only mapping.
+         dtUtil::DataStream ds( const_cast<char*>(file->GetData()), unsigned(file->GetSize()), false );
+         if( ! Decode( ds, stamp, tables ) )
+         {
+            LOG_DEBUG( "The munition config cache \"" + cacheFilePath + "\" is out of date or invalid." );
+            return 0;
+         }
+
+         outTables.insert( outTables.end(), tables.begin(), tables.end() );
+         return unsigned(tables.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsConfigCache::Encode( dtUtil::DataStream& ds, const SourceStamp& stamp,
+         const TableList& tables ) const
+      {
+         ds.SetForceLittleEndian( true );
+         ds << CACHE_FILE_MAGIC;
+         ds << CACHE_FILE_VERSION;
+         ds << stamp.mModifiedTime;
+         ds << stamp.mFileSize;
+         ds << unsigned(tables.size());
+
+         std::vector<const MunitionDamage*> damages;
+         TableList::const_iterator iter = tables.begin();
+         for( ; iter != tables.end(); ++iter )
+         {
+            const MunitionDamageTable& table = **iter;
+            ds << table.GetName();
+            ds << table.IsDefault();
+
+            damages.clear();
+            table.GetMunitionDamageList( damages );
+            ds << unsigned(damages.size());
+
+            std::vector<const MunitionDamage*>::const_iterator damageIter = damages.begin();
+            for( ; damageIter != damages.end(); ++damageIter )
+            {
+               EncodeMunitionDamage( ds, **damageIter );
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool MunitionsConfigCache::Decode( dtUtil::DataStream& ds, const SourceStamp& expectedStamp,
+         TableList& outTables ) const
+      {
+         ds.SetForceLittleEndian( true );
+
+         try
+         {
+            unsigned magic = 0, version = 0;
+            ds >> magic;
+            ds >> version;
+            if( magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION )
+            {
+               return false;
+            }
+
+            SourceStamp stamp;
+            ds >> stamp.mModifiedTime;
+            ds >> stamp.mFileSize;
+            if( stamp != expectedStamp )
+            {
+               return false;
+            }
+
+            unsigned tableCount = 0;
+            ds >> tableCount;
+            // Guard against garbage counts; every table takes more than one byte.
+            if( tableCount > ds.GetBufferSize() )
+            {
+               return false;
+            }
+
+            TableList tables;
+            tables.reserve( tableCount );
+            for( unsigned i = 0; i < tableCount; ++i )
+            {
+               std::string name;
+               bool isDefault = false;
+               unsigned damageCount = 0;
+               ds >> name;
+               ds >> isDefault;
+               ds >> damageCount;
+               if( damageCount > ds.GetBufferSize() )
+               {
+                  return false;
+               }
+
+               dtCore::RefPtr<MunitionDamageTable> table = new MunitionDamageTable( name, isDefault );
+               for( unsigned d = 0; d < damageCount; ++d )
+               {
+                  table->AddMunitionDamage( DecodeMunitionDamage( ds ) );
+               }
+               tables.push_back( table );
+            }
+
+            outTables.swap( tables );
+         }
+         catch( const dtUtil::Exception& ex )
+         {
+            std::ostringstream ss;
+            ss << "Failure decoding the munition config cache: " << ex.What();
+            LOG_WARNING( ss.str() );
+            return false;
+         }
+
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsConfigCache::EncodeMunitionDamage( dtUtil::DataStream& ds, const MunitionDamage& damage ) const
+      {
+         ds << damage.GetName();
+         ds << damage.GetCutoffRange();
+         ds << damage.GetNewtonForce();
+         ds << damage.GetAccumulationFactor();
+
+         const DamageProbability* directFire = damage.GetDirectFireProbabilities();
+         const DamageProbability* indirectFire = damage.GetIndirectFireProbabilities();
+         const DamageRanges* range1_3 = damage.GetDamageRanges1_3();
+         const DamageRanges* range2_3 = damage.GetDamageRanges2_3();
+         const DamageRanges* rangeMax = damage.GetDamageRangesMax();
+
+         unsigned parts = 0;
+         if( directFire != NULL ) { parts |= PART_DIRECT_FIRE; }
+         if( indirectFire != NULL ) { parts |= PART_INDIRECT_FIRE; }
+         if( range1_3 != NULL ) { parts |= PART_RANGE_1_3; }
+         if( range2_3 != NULL ) { parts |= PART_RANGE_2_3; }
+         if( rangeMax != NULL ) { parts |= PART_RANGE_MAX; }
+         ds << parts;
+
+         if( directFire != NULL ) { EncodeProbabilities( ds, *directFire ); }
+         if( indirectFire != NULL ) { EncodeProbabilities( ds, *indirectFire ); }
+         if( range1_3 != NULL ) { EncodeRanges( ds, *range1_3 ); }
+         if( range2_3 != NULL ) { EncodeRanges( ds, *range2_3 ); }
+         if( rangeMax != NULL ) { EncodeRanges( ds, *rangeMax ); }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsConfigCache::EncodeProbabilities( dtUtil::DataStream& ds, const DamageProbability& probs ) const
+      {
+         ds << probs.GetNoDamage();
+         ds << probs.GetMobilityDamage();
+         ds << probs.GetFirepowerDamage();
+         ds << probs.GetMobilityFirepowerDamage();
+         ds << probs.GetKillDamage();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsConfigCache::EncodeRanges( dtUtil::DataStream& ds, const DamageRanges& ranges ) const
+      {
+         ds << ranges.GetAngleOfFall();
+         const osg::Vec4& forward = ranges.GetForwardRanges();
+         const osg::Vec4& deflect = ranges.GetDeflectRanges();
+         for( unsigned i = 0; i < 4; ++i ) { ds << forward[i]; }
+         for( unsigned i = 0; i < 4; ++i ) { ds << deflect[i]; }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<MunitionDamage> MunitionsConfigCache::DecodeMunitionDamage( dtUtil::DataStream& ds ) const
+      {
+         std::string name;
+         float cutoff = 0.0f, newtonForce = 0.0f, accumulation = 0.0f;
+         unsigned parts = 0;
+         ds >> name;
+         ds >> cutoff;
+         ds >> newtonForce;
+         ds >> accumulation;
+         ds >> parts;
+
+         dtCore::RefPtr<MunitionDamage> damage = new MunitionDamage( name );
+         damage->SetCutoffRange( cutoff );
+         damage->SetNewtonForce( newtonForce );
+         damage->SetAccumulationFactor( accumulation );
+
+         // The set functions copy the values, so one temporary of each will do.
+         dtCore::RefPtr<DamageProbability> probs = new DamageProbability( "Probabilities" );
+         if( parts & PART_DIRECT_FIRE )
+         {
+            DecodeProbabilities( ds, *probs );
+            damage->SetDirectFireProbabilities( *probs );
+         }
+         if( parts & PART_INDIRECT_FIRE )
+         {
+            DecodeProbabilities( ds, *probs );
+            damage->SetIndirectFireProbabilities( *probs );
+         }
+
+         dtCore::RefPtr<DamageRanges> ranges = new DamageRanges( "Ranges" );
+         if( parts & PART_RANGE_1_3 )
+         {
+            DecodeRanges( ds, *ranges );
+            damage->SetDamageRanges1_3( ranges );
+         }
+         if( parts & PART_RANGE_2_3 )
+         {
+            DecodeRanges( ds, *ranges );
+            damage->SetDamageRanges2_3( ranges );
+         }
+         if( parts & PART_RANGE_MAX )
+         {
+            DecodeRanges( ds, *ranges );
+            damage->SetDamageRangesMax( ranges );
+         }
+
+         return damage;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsConfigCache::DecodeProbabilities( dtUtil::DataStream& ds, DamageProbability& probs ) const
+      {
+         float none = 0.0f, mobility = 0.0f, firepower = 0.0f, mobilityFirepower = 0.0f, kill = 0.0f;
+         ds >> none;
+         ds >> mobility;
+         ds >> firepower;
+         ds >> mobilityFirepower;
+         ds >> kill;
+
+         probs.Set( none, mobility, firepower, mobilityFirepower, kill );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsConfigCache::DecodeRanges( dtUtil::DataStream& ds, DamageRanges& ranges ) const
+      {
+         float angleOfFall = 0.0f;
+         osg::Vec4 forward, deflect;
+         ds >> angleOfFall;
+         for( unsigned i = 0; i < 4; ++i ) { ds >> forward[i]; }
+         for( unsigned i = 0; i < 4; ++i ) { ds >> deflect[i]; }
+
+         ranges.SetAngleOfFall( angleOfFall );
+         ranges.SetForwardRanges( forward );
+         ranges.SetDeflectRanges( deflect );
+      }
+
+   }
+}
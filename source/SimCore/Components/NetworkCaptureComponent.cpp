@@ -0,0 +1,164 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/NetworkCaptureComponent.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/machineinfo.h>
+#include <dtGame/message.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/log.h>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      // "NCAP"
+      const unsigned NetworkCaptureComponent::CAPTURE_FILE_MAGIC = 0x5041434E;
+      const unsigned NetworkCaptureComponent::CAPTURE_FILE_VERSION = 1;
+      const unsigned NetworkCaptureComponent::FILE_HEADER_SIZE = sizeof(unsigned) * 2;
+      const unsigned NetworkCaptureComponent::RECORD_HEADER_SIZE = sizeof(double) + sizeof(unsigned short) + sizeof(unsigned);
+
+      //////////////////////////////////////////////////////////////////////////
+      NetworkCaptureComponent::NetworkCaptureComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mStartTick(0)
+         , mNumCaptured(0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      NetworkCaptureComponent::~NetworkCaptureComponent()
+      {
+         StopCapture();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(NetworkCaptureComponent, std::string, CaptureFile);
+
+      //////////////////////////////////////////////////////////////////////////
+      bool NetworkCaptureComponent::StartCapture()
+      {
+         StopCapture();
+
+         mOut.open( mCaptureFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+         if( ! mOut.is_open() )
+         {
+            LOG_ERROR( "Unable to open the network capture file \"" + mCaptureFile + "\"." );
+            return false;
+         }
+
+         dtUtil::DataStream ds;
+         ds.SetForceLittleEndian( true );
+         ds << CAPTURE_FILE_MAGIC;
+         ds << CAPTURE_FILE_VERSION;
+         mOut.write( ds.GetBuffer(), ds.GetBufferSize() );
+
+         mStartTick = osg::Timer::instance()->tick();
+         mNumCaptured = 0;
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkCaptureComponent::StopCapture()
+      {
+         if( mOut.is_open() )
+         {
+            mOut.close();
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool NetworkCaptureComponent::IsCapturing() const
+      {
+         return mOut.is_open();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkCaptureComponent::GetNumCaptured() const
+      {
+         return mNumCaptured;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkCaptureComponent::CaptureMessage( const dtGame::Message& message )
+      {
+         SIMCORE_PROFILE_SCOPE("NetworkCaptureComponent::CaptureMessage");
+
+         if( ! mOut.is_open() )
+         {
+            return;
+         }
+
+         dtUtil::DataStream body;
+         body.SetForceLittleEndian( true );
+         EncodeMessage( body, message );
+
+         dtUtil::DataStream header;
+         header.SetForceLittleEndian( true );
+         header << osg::Timer::instance()->delta_s( mStartTick, osg::Timer::instance()->tick() );
+         header << message.GetMessageType().GetId();
+         header << body.GetBufferSize();
+
+         mOut.write( header.GetBuffer(), header.GetBufferSize() );
+         mOut.write( body.GetBuffer(), body.GetBufferSize() );
+         ++mNumCaptured;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkCaptureComponent::EncodeMessage( dtUtil::DataStream& ds, const dtGame::Message& message )
+      {
+         ds << message.GetSource().GetUniqueId().ToString();
+         ds << message.GetSource().GetName();
+         ds << message.GetAboutActorId().ToString();
+         ds << message.GetSendingActorId().ToString();
+         message.ToDataStream( ds );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkCaptureComponent::OnAddedToGM()
+      {
+         if( ! mCaptureFile.empty() )
+         {
+            StartCapture();
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkCaptureComponent::OnRemovedFromGM()
+      {
+         StopCapture();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkCaptureComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         if( mOut.is_open() && message.GetSource() != GetGameManager()->GetMachineInfo() )
+         {
+            CaptureMessage( message );
+         }
+      }
+   }
+}
@@ -0,0 +1,555 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/NetworkReplayComponent.h>
+#include <SimCore/Components/NetworkCaptureComponent.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/machineinfo.h>
+#include <dtGame/message.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/log.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // Network Replay Probe Component Code
+      //////////////////////////////////////////////////////////////////////////
+      NetworkReplayProbeComponent::NetworkReplayProbeComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      NetworkReplayProbeComponent::~NetworkReplayProbeComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayProbeComponent::SetReplayComponent( NetworkReplayComponent* replayComp )
+      {
+         mReplayComp = replayComp;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      NetworkReplayComponent* NetworkReplayProbeComponent::GetReplayComponent()
+      {
+         return mReplayComp.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayProbeComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         if( mReplayComp.valid() )
+         {
+            mReplayComp->OnMessageDequeued( message );
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      // Network Replay Component Code
+      //////////////////////////////////////////////////////////////////////////
+      NetworkReplayComponent::NetworkReplayComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mTimeScale(1.0f)
+         , mMaxMessagesPerTick(0)
+         , mMessageTimeout(5.0f)
+         , mNumDequeued(0)
+         , mNextRecord(0)
+         , mReplaying(false)
+         , mFinished(false)
+         , mStartTick(0)
+         , mLastProcessedTick(0)
+         , mNumSent(0)
+         , mNumProcessed(0)
+         , mNumSkipped(0)
+         , mNumDropped(0)
+         , mTotalLatency(0.0)
+         , mMaxLatency(0.0)
+         , mTotalQueueWait(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      NetworkReplayComponent::~NetworkReplayComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(NetworkReplayComponent, float, TimeScale);
+      DT_IMPLEMENT_ACCESSOR(NetworkReplayComponent, unsigned, MaxMessagesPerTick);
+      DT_IMPLEMENT_ACCESSOR(NetworkReplayComponent, float, MessageTimeout);
+
+      //////////////////////////////////////////////////////////////////////////
+      bool NetworkReplayComponent::LoadCapture( const std::string& fileName )
+      {
+         StopReplay();
+         mBuffer.clear();
+         mRecords.clear();
+         mNextRecord = 0;
+         mFinished = false;
+
+         std::ifstream in( fileName.c_str(), std::ios::in | std::ios::binary );
+         if( ! in.is_open() )
+         {
+            LOG_ERROR( "Unable to open the network capture file \"" + fileName + "\"." );
+            return false;
+         }
+
+         // Read it all at once and decode from memory.
+         in.seekg( 0, std::ios::end );
+         std::streamoff fileSize = in.tellg();
+         in.seekg( 0, std::ios::beg );
+         if( fileSize < std::streamoff(NetworkCaptureComponent::FILE_HEADER_SIZE) )
+         {
+            LOG_ERROR( "The network capture file \"" + fileName + "\" is too short." );
+            return false;
+         }
+
+         mBuffer.resize( size_t(fileSize) );
+         if( ! in.read( &mBuffer[0], fileSize ) )
+         {
+            mBuffer.clear();
+            return false;
+         }
+
+         try
+         {
+            unsigned magic = 0, version = 0;
+            dtUtil::DataStream fileHeader( &mBuffer[0], NetworkCaptureComponent::FILE_HEADER_SIZE, false );
+            fileHeader.SetForceLittleEndian( true );
+            fileHeader >> magic;
+            fileHeader >> version;
+            if( magic != NetworkCaptureComponent::CAPTURE_FILE_MAGIC || version != NetworkCaptureComponent::CAPTURE_FILE_VERSION )
+            {
+               LOG_ERROR( "\"" + fileName + "\" is not a network capture file, or is from another version." );
+               mBuffer.clear();
+               return false;
+            }
+
+            // Index the records so they can be decoded as they are sent.
+            unsigned offset = NetworkCaptureComponent::FILE_HEADER_SIZE;
+            while( offset + NetworkCaptureComponent::RECORD_HEADER_SIZE <= mBuffer.size() )
+            {
+               ReplayRecord record;
+               dtUtil::DataStream recordHeader( &mBuffer[offset], NetworkCaptureComponent::RECORD_HEADER_SIZE, false );
+               recordHeader.SetForceLittleEndian( true );
+               recordHeader >> record.mTime;
+               recordHeader >> record.mTypeId;
+               recordHeader >> record.mSize;
+
+               offset += NetworkCaptureComponent::RECORD_HEADER_SIZE;
+               if( record.mSize > mBuffer.size() - offset )
+               {
+                  break;
+               }
+
+               record.mOffset = offset;
+               mRecords.push_back( record );
+               offset += record.mSize;
+            }
+
+            if( offset != mBuffer.size() )
+            {
+               LOG_WARNING( "The network capture file \"" + fileName + "\" ends with a truncated record." );
+            }
+         }
+         catch( const dtUtil::Exception& ex )
+         {
+            std::ostringstream ss;
+            ss << "Failure reading the network capture file \"" << fileName << "\": " << ex.What();
+            LOG_ERROR( ss.str() );
+            return false;
+         }
+
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkReplayComponent::GetNumRecords() const
+      {
+         return mRecords.size();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::StartReplay()
+      {
+         mInFlight.clear();
+         mNumDequeued = 0;
+         mNextRecord = 0;
+         mReplaying = true;
+         mFinished = false;
+         mStartTick = osg::Timer::instance()->tick();
+         mLastProcessedTick = mStartTick;
+         mNumSent = 0;
+         mNumProcessed = 0;
+         mNumSkipped = 0;
+         mNumDropped = 0;
+         mTotalLatency = 0.0;
+         mMaxLatency = 0.0;
+         mTotalQueueWait = 0.0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::StopReplay()
+      {
+         mReplaying = false;
+         mInFlight.clear();
+         mNumDequeued = 0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool NetworkReplayComponent::IsReplaying() const
+      {
+         return mReplaying;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool NetworkReplayComponent::IsFinished() const
+      {
+         return mFinished;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkReplayComponent::SendDueMessages()
+      {
+         if( ! mReplaying )
+         {
+            return 0;
+         }
+
+         SIMCORE_PROFILE_SCOPE("NetworkReplayComponent::SendDueMessages");
+
+         double replayTime = mTimeScale * osg::Timer::instance()->delta_s( mStartTick, osg::Timer::instance()->tick() );
+
+         unsigned numSent = 0;
+         while( mNextRecord < mRecords.size() && ( mMaxMessagesPerTick == 0 || numSent < mMaxMessagesPerTick ) )
+         {
+            const ReplayRecord& record = mRecords[mNextRecord];
+            if( mTimeScale > 0.0f && record.mTime > replayTime )
+            {
+               break;
+            }
+            ++mNextRecord;
+
+            dtUtil::DataStream ds( &mBuffer[0] + record.mOffset, record.mSize, false );
+            ds.SetForceLittleEndian( true );
+            dtCore::RefPtr<dtGame::Message> msg = DecodeMessage( record.mTypeId, ds );
+            if( ! msg.valid() )
+            {
+               ++mNumSkipped;
+               continue;
+            }
+
+            SentMessage sent;
+            sent.mMessage = msg.get();
+            sent.mSentTick = osg::Timer::instance()->tick();
+            sent.mDequeuedTick = 0;
+            sent.mDequeued = false;
+            sent.mDropped = false;
+            mInFlight.push_back( sent );
+
+            GetGameManager()->SendMessage( *msg );
+            ++numSent;
+         }
+
+         mNumSent += numSent;
+         SIMCORE_PROFILE_COUNT("NetworkReplayComponent::Sent", numSent);
+
+         DropLostMessages();
+
+         if( mNextRecord >= mRecords.size() && mInFlight.empty() )
+         {
+            FinishReplay();
+         }
+         return numSent;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkReplayComponent::GetNumSent() const
+      {
+         return mNumSent;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkReplayComponent::GetNumProcessed() const
+      {
+         return mNumProcessed;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkReplayComponent::GetNumDropped() const
+      {
+         return mNumDropped;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned NetworkReplayComponent::GetNumSkipped() const
+      {
+         return mNumSkipped;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double NetworkReplayComponent::GetElapsedSeconds() const
+      {
+         osg::Timer_t endTick = mReplaying ? osg::Timer::instance()->tick() : mLastProcessedTick;
+         return osg::Timer::instance()->delta_s( mStartTick, endTick );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double NetworkReplayComponent::GetMessagesPerSecond() const
+      {
+         double elapsed = GetElapsedSeconds();
+         if( elapsed <= 0.0 )
+         {
+            return 0.0;
+         }
+         return double(mNumProcessed) / elapsed;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double NetworkReplayComponent::GetMeanLatencyMillis() const
+      {
+         if( mNumProcessed == 0 )
+         {
+            return 0.0;
+         }
+         return 1000.0 * mTotalLatency / double(mNumProcessed);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double NetworkReplayComponent::GetMaxLatencyMillis() const
+      {
+         return 1000.0 * mMaxLatency;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double NetworkReplayComponent::GetMeanQueueMillis() const
+      {
+         if( mNumProcessed == 0 )
+         {
+            return 0.0;
+         }
+         return 1000.0 * mTotalQueueWait / double(mNumProcessed);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::WriteStats( std::ostream& out ) const
+      {
+         out << "Network replay: " << mNumProcessed << " of " << mNumSent << " messages processed, "
+             << mNumSkipped << " skipped, " << mNumDropped << " dropped, in " << GetElapsedSeconds() << " s, "
+             << GetMessagesPerSecond() << " messages/s, latency mean " << GetMeanLatencyMillis()
+             << " ms, max " << GetMaxLatencyMillis() << " ms, queue wait mean " << GetMeanQueueMillis() << " ms";
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<dtGame::Message> NetworkReplayComponent::DecodeMessage( unsigned short typeId, dtUtil::DataStream& ds )
+      {
+         dtCore::RefPtr<dtGame::Message> msg;
+         try
+         {
+            dtGame::MessageFactory& factory = GetGameManager()->GetMessageFactory();
+            msg = factory.CreateMessage( factory.GetMessageTypeById( typeId ) );
+
+            std::string sourceId, sourceName, aboutId, sendingId;
+            ds >> sourceId;
+            ds >> sourceName;
+            ds >> aboutId;
+            ds >> sendingId;
+            if( ! msg->FromDataStream( ds ) )
+            {
+               return NULL;
+            }
+
+            msg->SetSource( GetSourceMachine( dtCore::UniqueId( sourceId ), sourceName ) );
+            msg->SetAboutActorId( dtCore::UniqueId( aboutId ) );
+            msg->SetSendingActorId( dtCore::UniqueId( sendingId ) );
+         }
+         catch( const dtUtil::Exception& ex )
+         {
+            LOG_DEBUG( "Skipping a captured message that can't be decoded: " + ex.What() );
+            return NULL;
+         }
+         return msg;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      const dtGame::MachineInfo& NetworkReplayComponent::GetSourceMachine( const dtCore::UniqueId& id, const std::string& name )
+      {
+         dtCore::RefPtr<dtGame::MachineInfo>& machine = mSourceMachines[id];
+         if( ! machine.valid() )
+         {
+            machine = new dtGame::MachineInfo( name );
+            machine->SetUniqueId( id );
+         }
+         return *machine;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::FinishReplay()
+      {
+         mReplaying = false;
+         mFinished = true;
+
+         std::ostringstream ss;
+         WriteStats( ss );
+         LOG_ALWAYS( ss.str() );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::PopInFlight()
+      {
+         mInFlight.pop_front();
+         if( mNumDequeued > 0 )
+         {
+            --mNumDequeued;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::DropLostMessages()
+      {
+         osg::Timer_t now = osg::Timer::instance()->tick();
+         while( ! mInFlight.empty() && ( mInFlight.front().mDropped
+            || osg::Timer::instance()->delta_s( mInFlight.front().mSentTick, now ) > mMessageTimeout ) )
+         {
+            ++mNumDropped;
+            PopInFlight();
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::OnMessageDequeued( const dtGame::Message& message )
+      {
+         if( mNumDequeued >= mInFlight.size() )
+         {
+            return;
+         }
+
+         unsigned found = mNumDequeued;
+         if( &message != mInFlight[found].mMessage.get() )
+         {
+            // Only look further for the replayed messages.  The GM dispatches the messages in the order
+            // they were sent, so the ones before a later replayed message were dropped.
+            if( mSourceMachines.find( message.GetSource().GetUniqueId() ) == mSourceMachines.end() )
+            {
+               return;
+            }
+
+            while( found < mInFlight.size() && &message != mInFlight[found].mMessage.get() )
+            {
+               ++found;
+            }
+            if( found == mInFlight.size() )
+            {
+               return;
+            }
+
+            for( unsigned i = mNumDequeued; i < found; ++i )
+            {
+               mInFlight[i].mDropped = true;
+            }
+         }
+
+         mInFlight[found].mDequeuedTick = osg::Timer::instance()->tick();
+         mInFlight[found].mDequeued = true;
+         mNumDequeued = found + 1;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::OnAddedToGM()
+      {
+         BaseClass::OnAddedToGM();
+
+         // Kept in the GM after this is removed, since the GM may be going through its components then.
+         NetworkReplayProbeComponent* probe = NULL;
+         GetGameManager()->GetComponentByName( NetworkReplayProbeComponent::DEFAULT_NAME, probe );
+         mProbe = probe;
+         if( ! mProbe.valid() )
+         {
+            mProbe = new NetworkReplayProbeComponent();
+            GetGameManager()->AddComponent( *mProbe, dtGame::GameManager::ComponentPriority::HIGHEST );
+         }
+         mProbe->SetReplayComponent( this );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::OnRemovedFromGM()
+      {
+         StopReplay();
+         mSourceMachines.clear();
+         if( mProbe.valid() && mProbe->GetReplayComponent() == this )
+         {
+            mProbe->SetReplayComponent( NULL );
+         }
+         mProbe = NULL;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void NetworkReplayComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         // The messages the probe skipped over will never get here.
+         while( ! mInFlight.empty() && mInFlight.front().mDropped )
+         {
+            ++mNumDropped;
+            PopInFlight();
+         }
+
+         if( ! mInFlight.empty() && &message == mInFlight.front().mMessage.get() )
+         {
+            const SentMessage& sent = mInFlight.front();
+            mLastProcessedTick = osg::Timer::instance()->tick();
+
+            // Without the probe, the queue wait can't be separated out.
+            osg::Timer_t dequeuedTick = sent.mDequeued ? sent.mDequeuedTick : sent.mSentTick;
+            double latency = osg::Timer::instance()->delta_s( dequeuedTick, mLastProcessedTick );
+            mTotalLatency += latency;
+            if( latency > mMaxLatency )
+            {
+               mMaxLatency = latency;
+            }
+            mTotalQueueWait += osg::Timer::instance()->delta_s( sent.mSentTick, dequeuedTick );
+            ++mNumProcessed;
+            PopInFlight();
+
+            if( mReplaying && mNextRecord >= mRecords.size() && mInFlight.empty() )
+            {
+               FinishReplay();
+            }
+         }
+         else if( message.GetMessageType() == dtGame::MessageType::TICK_LOCAL )
+         {
+            SendDueMessages();
+         }
+      }
+   }
+}
@@ -33,6 +33,7 @@
 #include <SimCore/Actors/PhysicsParticleSystemActor.h>
 #include <SimCore/Actors/IGEnvironmentActor.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <osgParticle/ParticleSystem>
 #include <osgParticle/ModularProgram>
@@ -267,20 +268,30 @@ namespace SimCore
          , mUpdateTimerName("ParticleMgrComp("+type.GetName()+"):UpdateTimer")
          , mWindWasUpdated(false)
       {
-
+         mForceUpdateJob = new FrameBudgetJob("Particle Forces", "ParticleManagerComponent",
+            dtUtil::MakeFunctor(&ParticleManagerComponent::UpdateParticleForces, this), FrameBudgetJob::PRIORITY_LOW);
       }
 
       //////////////////////////////////////////////////////////
       ParticleManagerComponent::~ParticleManagerComponent()
       {
+         mForceUpdateJob->RemoveFromFrameBudget();
+      }
 
+      //////////////////////////////////////////////////////////
+      void ParticleManagerComponent::OnRemovedFromGM()
+      {
+         mForceUpdateJob->RemoveFromFrameBudget();
       }
 
       //////////////////////////////////////////////////////////
       void ParticleManagerComponent::Clear()
       {
          mGlobalParticleCount = 0;
-         mIdToInfoMap.clear();
+         mParticles.clear();
+         mIdToParticleIndex.clear();
+         mPhysicsParticles.clear();
+         mIdToPhysicsParticleIndex.clear();
          mIdToActorMap.clear();
 
          // Normally the timer would be disabled here but
@@ -314,7 +325,11 @@ namespace SimCore
          // Avoid the most common messages that will not need to be processed
          if( msgType == dtGame::MessageType::TICK_LOCAL )
          {
-            UpdateParticleForces();
+            // A wind change can wait a few frames if the frame is busy.
+            if( mWindWasUpdated && ! FrameBudgetComponent::RequestJob(*GetGameManager(), *mForceUpdateJob) )
+            {
+               UpdateParticleForces();
+            }
             return;
          }
          if( msgType == dtGame::MessageType::TICK_REMOTE )
@@ -357,23 +372,14 @@ namespace SimCore
 
             // Capture the wind force that must be applied to new
             // particle systems registered to this component.
-            mWind = envActor->GetWind();
-            mWindWasUpdated = true;
-
-            // Update the physics particles wind....
-            std::vector<dtCore::ActorProxy*> toFill;
-            GetGameManager()->FindActorsByClassName("PhysicsParticleSystemActor", toFill);
-            if (!toFill.empty())
-            {
-               std::vector<dtCore::ActorProxy*>::iterator toFillInIter = toFill.begin();
-               for (; toFillInIter != toFill.end(); ++toFillInIter)
-               {
-                   SimCore::Actors::PhysicsParticleSystemActor* currentParticleSystem = NULL;
-                   (*toFillInIter)->GetDrawable(currentParticleSystem);
-                   currentParticleSystem->SetOverTimeForceVecMin(mWind);
-                   currentParticleSystem->SetOverTimeForceVecMax(mWind);
-               }
-            }
+            // The registered particles get it on the next tick.
+            SetWind(envActor->GetWind());
+         }
+         else if (msgType == dtGame::MessageType::INFO_ACTOR_DELETED)
+         {
+            const dtCore::UniqueId& id = message.GetAboutActorId();
+            UnregisterPhysicsParticles(id);
+            mIdToActorMap.erase(id);
          }
 
          // Is this a global application state change?
@@ -411,14 +417,12 @@ namespace SimCore
 
          particles.GetOSGNode()->setNodeMask(dtUtil::NodeMask::TRANSPARENT_EFFECTS);
 
-         bool success = mIdToInfoMap.insert(
-            std::make_pair( particles.GetUniqueId(), new ParticleInfo( particles, attrFlags, priority ) )
-            ).second;
-
-         if( !success )
-         {
-            LOG_WARNING("Failure registering particle system. Particle system may have already been registered.");
-         }
+         ParticleEntry entry;
+         entry.mId = particles.GetUniqueId();
+         entry.mInfo = new ParticleInfo( particles, attrFlags, priority );
+         mIdToParticleIndex.insert( std::make_pair( entry.mId, unsigned(mParticles.size()) ) );
+         mParticles.push_back( entry );
+         bool success = true;
 
          // Determine if the particle system is effected by wind force
          if( attrFlags != NULL && attrFlags->mEnableWind )
@@ -433,12 +437,11 @@ namespace SimCore
       //////////////////////////////////////////////////////////
       bool ParticleManagerComponent::Unregister( const dtCore::ParticleSystem& particles )
       {
-         std::map< dtCore::UniqueId, dtCore::RefPtr<ParticleInfo> >::iterator itor =
-            mIdToInfoMap.find(particles.GetUniqueId());
+         IdToIndexMap::iterator itor = mIdToParticleIndex.find(particles.GetUniqueId());
 
-         if( itor != mIdToInfoMap.end() )
+         if( itor != mIdToParticleIndex.end() )
          {
-            mIdToInfoMap.erase(itor);
+            RemoveParticleEntry(itor->second);
             return true;
          }
          return false;
@@ -448,7 +451,114 @@ namespace SimCore
       //////////////////////////////////////////////////////////
       bool ParticleManagerComponent::HasRegistered( const dtCore::UniqueId& particlesId) const
       {
-         return mIdToInfoMap.find(particlesId) != mIdToInfoMap.end();
+         return mIdToParticleIndex.find(particlesId) != mIdToParticleIndex.end();
+      }
+
+      //////////////////////////////////////////////////////////
+      unsigned ParticleManagerComponent::GetNumRegistered() const
+      {
+         return unsigned(mParticles.size());
+      }
+
+      //////////////////////////////////////////////////////////
+      ParticleInfo* ParticleManagerComponent::FindInfo( const dtCore::UniqueId& particlesId )
+      {
+         IdToIndexMap::iterator itor = mIdToParticleIndex.find(particlesId);
+         return itor != mIdToParticleIndex.end() ? mParticles[itor->second].mInfo.get() : NULL;
+      }
+
+      //////////////////////////////////////////////////////////
+      void ParticleManagerComponent::RemoveParticleEntry( unsigned index )
+      {
+         mIdToParticleIndex.erase(mParticles[index].mId);
+
+         // Move the last entry into the hole.
+         unsigned lastIndex = unsigned(mParticles.size()) - 1;
+         if( index != lastIndex )
+         {
+            mParticles[index] = mParticles[lastIndex];
+            mIdToParticleIndex[mParticles[index].mId] = index;
+         }
+         mParticles.pop_back();
+      }
+
+      //////////////////////////////////////////////////////////
+      bool ParticleManagerComponent::RegisterPhysicsParticles( Actors::PhysicsParticleSystemActor& particles )
+      {
+         // Keyed by the actor id, since that's what the delete message is about.
+         const dtCore::UniqueId& id = particles.GetGameActorProxy().GetId();
+         if( HasRegisteredPhysicsParticles(id) )
+         {
+            return false;
+         }
+
+         PhysicsParticleEntry entry;
+         entry.mId = id;
+         entry.mActor = &particles;
+         mIdToPhysicsParticleIndex.insert( std::make_pair( id, unsigned(mPhysicsParticles.size()) ) );
+         mPhysicsParticles.push_back( entry );
+
+         particles.SetOverTimeForceVecMin(mWind);
+         particles.SetOverTimeForceVecMax(mWind);
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////
+      bool ParticleManagerComponent::UnregisterPhysicsParticles( const dtCore::UniqueId& actorId )
+      {
+         IdToIndexMap::iterator itor = mIdToPhysicsParticleIndex.find(actorId);
+         if( itor == mIdToPhysicsParticleIndex.end() )
+         {
+            return false;
+         }
+
+         RemovePhysicsParticleEntry(itor->second);
+         return true;
+      }
+
+      //////////////////////////////////////////////////////////
+      bool ParticleManagerComponent::HasRegisteredPhysicsParticles( const dtCore::UniqueId& actorId ) const
+      {
+         return mIdToPhysicsParticleIndex.find(actorId) != mIdToPhysicsParticleIndex.end();
+      }
+
+      //////////////////////////////////////////////////////////
+      unsigned ParticleManagerComponent::GetNumPhysicsParticlesRegistered() const
+      {
+         return unsigned(mPhysicsParticles.size());
+      }
+
+      //////////////////////////////////////////////////////////
+      void ParticleManagerComponent::RemovePhysicsParticleEntry( unsigned index )
+      {
+         mIdToPhysicsParticleIndex.erase(mPhysicsParticles[index].mId);
+
+         unsigned lastIndex = unsigned(mPhysicsParticles.size()) - 1;
+         if( index != lastIndex )
+         {
+            mPhysicsParticles[index] = mPhysicsParticles[lastIndex];
+            mIdToPhysicsParticleIndex[mPhysicsParticles[index].mId] = index;
+         }
+         mPhysicsParticles.pop_back();
+      }
+
+      //////////////////////////////////////////////////////////
+      void ParticleManagerComponent::SetWind( const osg::Vec3& wind )
+      {
+         mWind = wind;
+         mWindWasUpdated = true;
+      }
+
+      //////////////////////////////////////////////////////////
+      const osg::Vec3& ParticleManagerComponent::GetWind() const
+      {
+         return mWind;
+      }
+
+      //////////////////////////////////////////////////////////
+      bool ParticleManagerComponent::IsForceUpdatePending() const
+      {
+         return mWindWasUpdated;
       }
 
       //////////////////////////////////////////////////////////
@@ -503,33 +613,23 @@ namespace SimCore
          unsigned int totalSystems = 0;
          unsigned int totalSystemsRemoved = 0;
 
-         std::map< dtCore::UniqueId, dtCore::RefPtr<ParticleInfo> >::iterator itor = mIdToInfoMap.begin();
-         std::vector< dtCore::UniqueId > idsToDelete;
-
          // Update the component's report data by updating each ParticleInfo.
-         // Collect the keys of any infos that fail update
-         for( ; itor != mIdToInfoMap.end(); ++itor)
+         // Infos that fail the update are removed in place, so the index
+         // only moves on when the entry stays.
+         unsigned int i = 0;
+         while( i < mParticles.size() )
          {
-            if( ! itor->second.valid() || ! itor->second->Update() )
+            ParticleInfo* info = mParticles[i].mInfo.get();
+            if( info == NULL || ! info->Update() )
             {
-               idsToDelete.push_back(itor->first);
+               RemoveParticleEntry(i);
+               totalSystemsRemoved++;
             }
             else
             {
-               mGlobalParticleCount += itor->second->GetAllocatedCount();
+               mGlobalParticleCount += info->GetAllocatedCount();
                totalSystems++;
-            }
-         }
-
-         // Delete the failed info entries
-         for( unsigned int i = 0; i < idsToDelete.size(); i ++)
-         {
-            std::map< dtCore::UniqueId, dtCore::RefPtr<ParticleInfo> >::iterator itor =
-               mIdToInfoMap.find(idsToDelete[i]);
-            if (itor != mIdToInfoMap.end())
-            {
-               mIdToInfoMap.erase(itor);
-               totalSystemsRemoved++;
+               ++i;
             }
          }
 
@@ -555,36 +655,57 @@ namespace SimCore
             return;
          }
 
-         //bool forceInfoUpdate = false;
+         mWindWasUpdated = false;
+
          dtCore::ParticleSystem* curParticles = NULL;
          ParticleInfo::ForceOperatorList* curForces = NULL;
          ParticleInfo* curInfo = NULL;
-         ParticleInfoMap::iterator infoIter = mIdToInfoMap.begin();
-         for( ; infoIter != mIdToInfoMap.end(); ++infoIter )
+         unsigned int i = 0;
+         while( i < mParticles.size() )
          {
-            curInfo = infoIter->second.get();
+            curInfo = mParticles[i].mInfo.get();
             if( curInfo == NULL || curInfo->GetParticleSystem() == NULL )
             {
+               // The particle system is gone, so drop it while we're here.
+               RemoveParticleEntry(i);
                continue;
             }
+            ++i;
 
-            curParticles = curInfo->GetParticleSystem();
             curForces = &curInfo->GetWindForces();
+            if( curForces->empty() )
+            {
+               continue;
+            }
+
+            // The local force only depends on the particle system, so work it out once for all its layers.
+            curParticles = curInfo->GetParticleSystem();
+            osg::Vec3 localWind = ConvertWorldToLocalForce( mWind, *curParticles );
 
             ParticleInfo::ForceOperatorList::iterator forceIter = curForces->begin();
             for( ; forceIter != curForces->end(); ++forceIter )
             {
-               if( ! forceIter->valid() )
+               if( forceIter->valid() )
                {
-                  // DEBUG: std::cout << "\tContinue 2" << std::endl;
-                  continue;
+                  (*forceIter)->setForce( localWind );
                }
-
-               // Change the force's
-               (*forceIter)->setForce( ConvertWorldToLocalForce( mWind, *curParticles ) );
-
             } // End Forces Loop
          }// End Particle Infos Loop
+
+         i = 0;
+         while( i < mPhysicsParticles.size() )
+         {
+            SimCore::Actors::PhysicsParticleSystemActor* physicsParticles = mPhysicsParticles[i].mActor.get();
+            if( physicsParticles == NULL )
+            {
+               RemovePhysicsParticleEntry(i);
+               continue;
+            }
+            ++i;
+
+            physicsParticles->SetOverTimeForceVecMin(mWind);
+            physicsParticles->SetOverTimeForceVecMax(mWind);
+         }
       }
 
       //////////////////////////////////////////////////////////
@@ -625,13 +746,7 @@ namespace SimCore
       {
          dtCore::ParticleLayer* curLayer = NULL;
          osgParticle::ForceOperator* forceOp = NULL;
-         ParticleInfo* info = NULL;
-
-         ParticleInfoMap::iterator foundIter = mIdToInfoMap.find(ps.GetUniqueId());
-         if( foundIter != mIdToInfoMap.end() )
-         {
-            info = foundIter->second.get();
-         }
+         ParticleInfo* info = FindInfo(ps.GetUniqueId());
 
          // Go through all particle layers and apply the force to each
          dtCore::ParticleSystem::LayerList& layers = ps.GetAllLayers();
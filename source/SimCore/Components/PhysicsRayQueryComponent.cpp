@@ -0,0 +1,394 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/PhysicsRayQueryComponent.h>
+
+#include <dtCore/scene.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+#include <dtPhysics/palphysicsworld.h>
+#include <dtUtil/configproperties.h>
+#include <dtUtil/stringutils.h>
+#include <dtUtil/threadpool.h>
+
+#include <OpenThreads/Thread>
+#include <osg/Timer>
+#include <osgUtil/IntersectionVisitor>
+#include <osgUtil/LineSegmentIntersector>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // Ray Query Task - Traces a range of the physics queries in a batch on a worker thread.
+      //////////////////////////////////////////////////////////////////////////
+      class RayQueryTask : public dtUtil::ThreadPoolTask
+      {
+      public:
+         RayQueryTask()
+            : mComponent(NULL)
+            , mQueries(NULL)
+            , mIndices(NULL)
+            , mHitLists(NULL)
+            , mBegin(0)
+            , mEnd(0)
+         {
+         }
+
+         void Set(PhysicsRayQueryComponent& component,
+            const std::vector<PhysicsRayQueryComponent::Query>& queries,
+            const std::vector<unsigned>& indices,
+            std::vector<PhysicsRayQueryComponent::HitList>& hitLists,
+            unsigned begin, unsigned end)
+         {
+            mComponent = &component;
+            mQueries = &queries;
+            mIndices = &indices;
+            mHitLists = &hitLists;
+            mBegin = begin;
+            mEnd = end;
+         }
+
+         virtual void operator()()
+         {
+            for (unsigned i = mBegin; i < mEnd; ++i)
+            {
+               unsigned index = (*mIndices)[i];
+               mComponent->TraceQuery((*mQueries)[index], (*mHitLists)[index]);
+            }
+         }
+
+      private:
+         PhysicsRayQueryComponent* mComponent;
+         const std::vector<PhysicsRayQueryComponent::Query>* mQueries;
+         const std::vector<unsigned>* mIndices;
+         std::vector<PhysicsRayQueryComponent::HitList>* mHitLists;
+         unsigned mBegin;
+         unsigned mEnd;
+      };
+
+      //////////////////////////////////////////////////////////////////////////
+      // Physics Ray Query Component Code
+      //////////////////////////////////////////////////////////////////////////
+      PhysicsRayQueryComponent::Query::Query()
+         : mIsPhysics(true)
+         , mHasOwner(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      PhysicsRayQueryComponent::PhysicsRayQueryComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mUseWorkerThreads(true)
+         , mMinQueriesPerTask(DEFAULT_MIN_QUERIES_PER_TASK)
+         , mSceneTraversalMask(0xFFFFFFFF)
+         , mNumQueries(0)
+         , mLastBatchQueryCount(0)
+         , mLastBatchWorkerQueryCount(0)
+         , mLastBatchQueryTimeMS(0.0)
+         , mTotalQueryCount(0)
+         , mTotalQueryTimeMS(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      PhysicsRayQueryComponent::~PhysicsRayQueryComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(PhysicsRayQueryComponent, bool, UseWorkerThreads);
+      DT_IMPLEMENT_ACCESSOR(PhysicsRayQueryComponent, unsigned, MinQueriesPerTask);
+      DT_IMPLEMENT_ACCESSOR(PhysicsRayQueryComponent, unsigned, SceneTraversalMask);
+
+      //////////////////////////////////////////////////////////////////////////
+      PhysicsRayQueryComponent::Query& PhysicsRayQueryComponent::AddQuery( const QueryCallback& callback, osg::Referenced* owner )
+      {
+         // The query list is reused between frames, so only grow it when it is full.
+         if (mNumQueries == mQueries.size())
+         {
+            mQueries.push_back(Query());
+         }
+
+         Query& query = mQueries[mNumQueries];
+         ++mNumQueries;
+
+         query.mCallback = callback;
+         query.mOwner = owner;
+         query.mHasOwner = owner != NULL;
+         return query;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::SubmitPhysicsQuery( const dtPhysics::RayCast& ray, const QueryCallback& callback, osg::Referenced* owner )
+      {
+         Query& query = AddQuery(callback, owner);
+         query.mIsPhysics = true;
+         query.mRay = ray;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::SubmitSceneQuery( const osg::Vec3& start, const osg::Vec3& end, const QueryCallback& callback, osg::Referenced* owner )
+      {
+         Query& query = AddQuery(callback, owner);
+         query.mIsPhysics = false;
+         query.mStart = start;
+         query.mEnd = end;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned PhysicsRayQueryComponent::GetNumPendingQueries() const
+      {
+         return mNumQueries;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::TraceQuery( const Query& query, HitList& outHits )
+      {
+         outHits.clear();
+
+         if (query.mIsPhysics)
+         {
+            dtPhysics::RayCast ray = query.mRay;
+            dtPhysics::PhysicsWorld::GetInstance().TraceRay(ray, outHits, true);
+            return;
+         }
+
+         if (GetGameManager() == NULL)
+         {
+            return;
+         }
+
+         osg::ref_ptr<osgUtil::LineSegmentIntersector> intersector =
+            new osgUtil::LineSegmentIntersector(query.mStart, query.mEnd);
+         osgUtil::IntersectionVisitor visitor(intersector.get());
+         visitor.setTraversalMask(mSceneTraversalMask);
+         GetGameManager()->GetScene().GetSceneNode()->accept(visitor);
+
+         // The intersections are already sorted by distance.
+         const osgUtil::LineSegmentIntersector::Intersections& intersections = intersector->getIntersections();
+         osgUtil::LineSegmentIntersector::Intersections::const_iterator i = intersections.begin();
+         for (; i != intersections.end(); ++i)
+         {
+            dtPhysics::RayCast::Report report;
+            report.mHasHitObject = false;
+            report.mHitPos = i->getWorldIntersectPoint();
+            report.mHitNormal = i->getWorldIntersectNormal();
+            outHits.push_back(report);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::RunQueries()
+      {
+         if (mNumQueries == 0)
+         {
+            mLastBatchQueryCount = 0;
+            mLastBatchWorkerQueryCount = 0;
+            mLastBatchQueryTimeMS = 0.0;
+            return;
+         }
+
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+         // Queries submitted from the callbacks go in the other list and run with the next batch.
+         // Both lists are kept, so neither allocates once they are big enough.
+         std::vector<Query>& queries = mRunningQueries;
+         queries.swap(mQueries);
+         unsigned numQueries = mNumQueries;
+         mNumQueries = 0;
+
+         if (mHitLists.size() < numQueries)
+         {
+            mHitLists.resize(numQueries);
+         }
+
+         // Only the physics queries go to the workers.
+         mPhysicsQueryIndices.clear();
+         for (unsigned i = 0; i < numQueries; ++i)
+         {
+            if (queries[i].mIsPhysics)
+            {
+               mPhysicsQueryIndices.push_back(i);
+            }
+         }
+         unsigned numPhysicsQueries = unsigned(mPhysicsQueryIndices.size());
+
+         unsigned minPerTask = mMinQueriesPerTask > 0 ? mMinQueriesPerTask : 1;
+         unsigned numTasks = numPhysicsQueries / minPerTask;
+         unsigned maxTasks = unsigned(OpenThreads::GetNumberOfProcessors());
+         if (numTasks > maxTasks)
+         {
+            numTasks = maxTasks;
+         }
+
+         if (!mUseWorkerThreads || numTasks < 2)
+         {
+            for (unsigned i = 0; i < numQueries; ++i)
+            {
+               TraceQuery(queries[i], mHitLists[i]);
+            }
+            mLastBatchWorkerQueryCount = 0;
+         }
+         else
+         {
+            while (mTasks.size() < numTasks)
+            {
+               mTasks.push_back(new RayQueryTask);
+            }
+
+            unsigned perTask = (numPhysicsQueries + numTasks - 1) / numTasks;
+            for (unsigned i = 0; i < numTasks; ++i)
+            {
+               unsigned begin = i * perTask;
+               unsigned end = begin + perTask < numPhysicsQueries ? begin + perTask : numPhysicsQueries;
+               mTasks[i]->Set(*this, queries, mPhysicsQueryIndices, mHitLists, begin, end);
+               dtUtil::ThreadPool::AddTask(*mTasks[i], dtUtil::ThreadPool::IMMEDIATE);
+            }
+
+            dtUtil::ThreadPool::ExecuteTasks();
+
+            // The scene graph computes its bounds lazily while it is traversed, so the scene
+            // queries are traced here, on the main thread, while the workers run.
+            for (unsigned i = 0; i < numQueries; ++i)
+            {
+               if (!queries[i].mIsPhysics)
+               {
+                  TraceQuery(queries[i], mHitLists[i]);
+               }
+            }
+
+            for (unsigned i = 0; i < numTasks; ++i)
+            {
+               mTasks[i]->WaitUntilComplete();
+               mTasks[i]->ResetData();
+            }
+            mLastBatchWorkerQueryCount = numPhysicsQueries;
+         }
+
+         mLastBatchQueryCount = numQueries;
+         mLastBatchQueryTimeMS = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+         mTotalQueryCount += numQueries;
+         mTotalQueryTimeMS += mLastBatchQueryTimeMS;
+
+         for (unsigned i = 0; i < numQueries; ++i)
+         {
+            Query& query = queries[i];
+            if (!query.mHasOwner || query.mOwner.valid())
+            {
+               query.mCallback(mHitLists[i]);
+            }
+            query.mOwner = NULL;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::ClearQueries()
+      {
+         for (unsigned i = 0; i < mNumQueries; ++i)
+         {
+            mQueries[i].mOwner = NULL;
+         }
+         mNumQueries = 0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned PhysicsRayQueryComponent::GetLastBatchQueryCount() const
+      {
+         return mLastBatchQueryCount;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned PhysicsRayQueryComponent::GetLastBatchWorkerQueryCount() const
+      {
+         return mLastBatchWorkerQueryCount;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double PhysicsRayQueryComponent::GetLastBatchQueryTimeMS() const
+      {
+         return mLastBatchQueryTimeMS;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned PhysicsRayQueryComponent::GetTotalQueryCount() const
+      {
+         return mTotalQueryCount;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double PhysicsRayQueryComponent::GetTotalQueryTimeMS() const
+      {
+         return mTotalQueryTimeMS;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::ResetStatistics()
+      {
+         mLastBatchQueryCount = 0;
+         mLastBatchWorkerQueryCount = 0;
+         mLastBatchQueryTimeMS = 0.0;
+         mTotalQueryCount = 0;
+         mTotalQueryTimeMS = 0.0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::OnAddedToGM()
+      {
+         BaseClass::OnAddedToGM();
+
+         dtUtil::ConfigProperties& config = GetGameManager()->GetConfiguration();
+
+         std::string value = config.GetConfigPropertyValue(GetName() + ".UseWorkerThreads");
+         if (!value.empty())
+         {
+            SetUseWorkerThreads(dtUtil::ToType<bool>(value));
+         }
+
+         value = config.GetConfigPropertyValue(GetName() + ".MinQueriesPerTask");
+         if (!value.empty())
+         {
+            SetMinQueriesPerTask(dtUtil::ToType<unsigned>(value));
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PhysicsRayQueryComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         const dtGame::MessageType& type = message.GetMessageType();
+
+         // Everything that needs a query this frame has ticked and the physics has stepped.
+         if (type == dtGame::MessageType::TICK_END_OF_FRAME)
+         {
+            RunQueries();
+         }
+         else if (type == dtGame::MessageType::INFO_RESTARTED
+            || type == dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN)
+         {
+            ClearQueries();
+         }
+      }
+
+   }
+}
@@ -0,0 +1,345 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/PositionMarkerComponent.h>
+#include <SimCore/Actors/PositionMarker.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <dtCore/project.h>
+#include <dtCore/scene.h>
+#include <dtCore/shadermanager.h>
+#include <dtCore/shaderprogram.h>
+#include <dtCore/transform.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+#include <dtUtil/log.h>
+
+#include <osg/BlendFunc>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+#include <osg/Program>
+#include <osg/VertexAttribDivisor>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      const float PositionMarkerComponent::DEFAULT_UPDATE_INTERVAL = 1.0f;
+
+      //////////////////////////////////////////////////////////////////////////
+      // Finds the first geometry of the marker mesh.
+      class MarkerGeometryFinder : public osg::NodeVisitor
+      {
+      public:
+         MarkerGeometryFinder()
+            : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+         {
+         }
+
+         virtual void apply(osg::Geode& geode)
+         {
+            for (unsigned i = 0; i < geode.getNumDrawables() && !mGeometry.valid(); ++i)
+            {
+               mGeometry = geode.getDrawable(i)->asGeometry();
+            }
+         }
+
+         dtCore::RefPtr<osg::Geometry> mGeometry;
+      };
+
+      //////////////////////////////////////////////////////////////////////////
+      PositionMarkerComponent::PositionMarkerComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mUpdateInterval(DEFAULT_UPDATE_INTERVAL)
+         , mNextUpdateTime(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      PositionMarkerComponent::~PositionMarkerComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(PositionMarkerComponent, float, UpdateInterval);
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::RegisterMarker(SimCore::Actors::PositionMarker& marker)
+      {
+         if (IsRegistered(marker))
+         {
+            return;
+         }
+         mMarkers.push_back(&marker);
+         // The batch draws it from now on.
+         marker.SetMeshVisible(false);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::UnregisterMarker(SimCore::Actors::PositionMarker& marker)
+      {
+         for (unsigned i = 0; i < mMarkers.size(); ++i)
+         {
+            if (mMarkers[i].get() == &marker)
+            {
+               mMarkers[i] = mMarkers.back();
+               mMarkers.pop_back();
+               marker.SetMeshVisible(true);
+               return;
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool PositionMarkerComponent::IsRegistered(const SimCore::Actors::PositionMarker& marker) const
+      {
+         for (unsigned i = 0; i < mMarkers.size(); ++i)
+         {
+            if (mMarkers[i].get() == &marker)
+            {
+               return true;
+            }
+         }
+         return false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned PositionMarkerComponent::GetNumMarkers() const
+      {
+         return mMarkers.size();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::UpdateMarkers(double simTime)
+      {
+         SIMCORE_PROFILE_SCOPE("PositionMarkerComponent::UpdateMarkers");
+
+         for (unsigned i = 0; i < mMarkers.size(); )
+         {
+            dtCore::RefPtr<SimCore::Actors::PositionMarker> marker = mMarkers[i].get();
+            bool remove = ! marker.valid();
+            if ( ! remove && marker->UpdateFade(simTime))
+            {
+               remove = true;
+               // Remote markers time themselves out too, so this delete isn't sent on the network.
+               GetGameManager()->DeleteActor(marker->GetGameActorProxy());
+            }
+
+            if (remove)
+            {
+               mMarkers[i] = mMarkers.back();
+               mMarkers.pop_back();
+            }
+            else
+            {
+               ++i;
+            }
+         }
+
+         SIMCORE_PROFILE_COUNT("PositionMarkerComponent::Markers", mMarkers.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::UpdateBatch()
+      {
+         if (!mBatchGeom.valid())
+         {
+            return;
+         }
+
+         mInstancePositions->clear();
+         mInstanceColors->clear();
+
+         dtCore::Transform xform;
+         osg::Vec3 pos;
+         for (unsigned i = 0; i < mMarkers.size(); ++i)
+         {
+            SimCore::Actors::PositionMarker* marker = mMarkers[i].get();
+            if (marker == NULL || !marker->IsVisible())
+            {
+               continue;
+            }
+
+            marker->GetTransform(xform);
+            xform.GetTranslation(pos);
+            mInstancePositions->push_back(pos + SimCore::Actors::PositionMarker::MESH_OFFSET);
+            mInstanceColors->push_back(marker->GetCurrentColorUniform());
+         }
+
+         unsigned numInstances = mInstancePositions->size();
+         mInstancePositions->dirty();
+         mInstanceColors->dirty();
+         for (unsigned i = 0; i < mBatchGeom->getNumPrimitiveSets(); ++i)
+         {
+            mBatchGeom->getPrimitiveSet(i)->setNumInstances(numInstances);
+         }
+
+         // An instance count of 0 means a plain draw to OSG, so the batch is masked off instead.
+         mBatchGeode->setNodeMask(numInstances > 0 ? ~0U : 0x0);
+
+         SIMCORE_PROFILE_COUNT("PositionMarkerComponent::Instances", numInstances);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned PositionMarkerComponent::GetNumInstances() const
+      {
+         return mInstancePositions.valid() ? mInstancePositions->size() : 0U;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      osg::Geometry* PositionMarkerComponent::GetBatchGeometry()
+      {
+         return mBatchGeom.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::BuildBatch()
+      {
+         mInstancePositions = new osg::Vec3Array;
+         mInstanceColors = new osg::Vec4Array;
+
+         dtCore::RefPtr<osg::Node> original, copied;
+         MarkerGeometryFinder finder;
+         std::string filename = dtCore::Project::GetInstance().GetResourcePath(SimCore::Actors::PositionMarker::MESH_RESOURCE);
+         if (!filename.empty() && SimCore::Actors::IGActor::LoadFileStatic(filename, original, copied))
+         {
+            copied->accept(finder);
+         }
+
+         if (finder.mGeometry.valid())
+         {
+            // The instance counts are set on the primitives, so they can't be shared with the cached mesh.
+            mBatchGeom = new osg::Geometry(*finder.mGeometry, osg::CopyOp::DEEP_COPY_PRIMITIVES);
+         }
+         else
+         {
+            LOG_ERROR("Cannot load the position marker batch mesh: " + SimCore::Actors::PositionMarker::MESH_RESOURCE);
+            mBatchGeom = new osg::Geometry;
+         }
+
+         // GEOMETRY - the instance arrays change every tick, so keep them in buffer objects.
+         mBatchGeom->setDataVariance(osg::Object::DYNAMIC);
+         mBatchGeom->setUseDisplayList(false);
+         mBatchGeom->setUseVertexBufferObjects(true);
+         mBatchGeom->setVertexAttribArray(POSITION_ATTRIBUTE, mInstancePositions.get());
+         mBatchGeom->setVertexAttribBinding(POSITION_ATTRIBUTE, osg::Geometry::BIND_PER_VERTEX);
+         mBatchGeom->setVertexAttribArray(COLOR_ATTRIBUTE, mInstanceColors.get());
+         mBatchGeom->setVertexAttribBinding(COLOR_ATTRIBUTE, osg::Geometry::BIND_PER_VERTEX);
+
+         // GEODE (GEOMETRY NODE) - the instances are spread over the whole scene, so it isn't culled.
+         mBatchGeode = new osg::Geode;
+         mBatchGeode->addDrawable(mBatchGeom.get());
+         mBatchGeode->setCullingActive(false);
+         mBatchGeode->setNodeMask(0x0);
+
+         // STATES - the per instance attributes advance once per marker rather than once per vertex.
+         osg::StateSet* ss = mBatchGeode->getOrCreateStateSet();
+         ss->setAttribute(new osg::VertexAttribDivisor(POSITION_ATTRIBUTE, 1));
+         ss->setAttribute(new osg::VertexAttribDivisor(COLOR_ATTRIBUTE, 1));
+         ss->setMode(GL_BLEND, osg::StateAttribute::ON);
+         ss->setAttributeAndModes(new osg::BlendFunc(osg::BlendFunc::SRC_ALPHA, osg::BlendFunc::ONE_MINUS_SRC_ALPHA));
+         ss->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+         // Attach the shader
+         dtCore::RefPtr<dtCore::ShaderProgram> protoShader
+            = dtCore::ShaderManager::GetInstance().FindShaderPrototype("PositionMarkerBatchShader", "PositionMarkerGroup");
+         if (protoShader.valid())
+         {
+            mBatchShader = dtCore::ShaderManager::GetInstance().AssignShaderFromPrototype(*protoShader, *mBatchGeode);
+            if (mBatchShader.valid())
+            {
+               osg::Program* program = const_cast<osg::Program*>(mBatchShader->GetShaderProgram());
+               program->addBindAttribLocation("markerPosition", POSITION_ATTRIBUTE);
+               program->addBindAttribLocation("markerColor", COLOR_ATTRIBUTE);
+            }
+            else
+            {
+               LOG_ERROR("Could not create and attach the position marker batch shader.");
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::OnAddedToGM()
+      {
+         BaseClass::OnAddedToGM();
+
+         BuildBatch();
+         GetGameManager()->GetScene().GetSceneNode()->addChild(mBatchGeode.get());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::OnRemovedFromGM()
+      {
+         // Give the markers back their own mesh.
+         for (unsigned i = 0; i < mMarkers.size(); ++i)
+         {
+            if (mMarkers[i].valid())
+            {
+               mMarkers[i]->SetMeshVisible(true);
+            }
+         }
+         mMarkers.clear();
+         mNextUpdateTime = 0.0;
+
+         if (mBatchGeode.valid())
+         {
+            GetGameManager()->GetScene().GetSceneNode()->removeChild(mBatchGeode.get());
+         }
+         mBatchGeode = NULL;
+         mBatchGeom = NULL;
+         mInstancePositions = NULL;
+         mInstanceColors = NULL;
+         mBatchShader = NULL;
+
+         BaseClass::OnRemovedFromGM();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void PositionMarkerComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         if (message.GetMessageType() == dtGame::MessageType::TICK_LOCAL)
+         {
+            double simTime = GetGameManager()->GetSimulationTime();
+            // Catches the sim time being set backwards, such as by a replay.
+            if (simTime < mNextUpdateTime - double(mUpdateInterval))
+            {
+               mNextUpdateTime = simTime;
+            }
+
+            if (simTime >= mNextUpdateTime)
+            {
+               mNextUpdateTime = simTime + double(mUpdateInterval);
+               if ( ! mMarkers.empty())
+               {
+                  UpdateMarkers(simTime);
+               }
+            }
+
+            // The fade only changes every interval, but the markers may move, so the batch is updated every tick.
+            UpdateBatch();
+         }
+      }
+   }
+}
@@ -0,0 +1,129 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/ProfilerComponent.h>
+#include <SimCore/FrameProfiler.h>
+#include <SimCore/Messages.h>
+#include <SimCore/MessageType.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/message.h>
+
+#include <sstream>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      const float ProfilerComponent::DEFAULT_STATS_INTERVAL = 1.0f;
+
+      //////////////////////////////////////////////////////////////////////////
+      ProfilerComponent::ProfilerComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mStatsInterval(DEFAULT_STATS_INTERVAL)
+         , mPeriodStartTick(osg::Timer::instance()->tick())
+         , mNumFrames(0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      ProfilerComponent::~ProfilerComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(ProfilerComponent, float, StatsInterval);
+      DT_IMPLEMENT_ACCESSOR(ProfilerComponent, std::string, TraceFile);
+
+      //////////////////////////////////////////////////////////////////////////
+      void ProfilerComponent::CollectFrame()
+      {
+         FrameProfiler::GetInstance().Collect();
+         ++mNumFrames;
+
+         if (mStatsInterval > 0.0f
+                  && osg::Timer::instance()->delta_s(mPeriodStartTick, osg::Timer::instance()->tick()) >= mStatsInterval)
+         {
+            SendStats();
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void ProfilerComponent::SendStats()
+      {
+         FrameProfiler& profiler = FrameProfiler::GetInstance();
+         osg::Timer_t now = osg::Timer::instance()->tick();
+
+         std::ostringstream ss;
+         profiler.WriteStats(ss);
+
+         dtCore::RefPtr<ProfileStatsMessage> msg;
+         GetGameManager()->GetMessageFactory().CreateMessage(SimCore::MessageType::INFO_PROFILE_STATS, msg);
+         msg->SetPeriodSeconds(float(osg::Timer::instance()->delta_s(mPeriodStartTick, now)));
+         msg->SetNumFrames(mNumFrames);
+         msg->SetStats(ss.str());
+         GetGameManager()->SendMessage(*msg);
+
+         profiler.ResetStats();
+         mPeriodStartTick = now;
+         mNumFrames = 0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void ProfilerComponent::OnAddedToGM()
+      {
+         FrameProfiler& profiler = FrameProfiler::GetInstance();
+         profiler.SetTraceEnabled(!mTraceFile.empty());
+         profiler.SetEnabled(true);
+         profiler.ResetStats();
+         mPeriodStartTick = osg::Timer::instance()->tick();
+         mNumFrames = 0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void ProfilerComponent::OnRemovedFromGM()
+      {
+         FrameProfiler& profiler = FrameProfiler::GetInstance();
+         profiler.Collect();
+         profiler.SetEnabled(false);
+
+         if (!mTraceFile.empty())
+         {
+            profiler.WriteChromeTrace(mTraceFile);
+            profiler.ClearTrace();
+         }
+         profiler.SetTraceEnabled(false);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void ProfilerComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         if (message.GetMessageType() == dtGame::MessageType::SYSTEM_FRAME_SYNCH)
+         {
+            CollectFrame();
+         }
+      }
+   }
+}
@@ -22,11 +22,14 @@
 */
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
 #include <SimCore/Actors/EntityActorRegistry.h>
 #include <SimCore/Actors/DynamicLightPrototypeActor.h>
 #include <SimCore/Actors/TerrainActorProxy.h>
 #include <SimCore/MessageType.h>
 #include <SimCore/Messages.h>
+#include <SimCore/FrameProfiler.h>
+#include <SimCore/StartupTracer.h>
 
 #include <SimCore/Actors/FlareActor.h>
 
@@ -210,11 +213,15 @@ namespace SimCore
       {
          // HACK!  Should net be committed!  If it is, delete it.
          mCullVisitor->SetEnablePhysics(false);
+
+         mLightSortJob = new FrameBudgetJob("Light Sort", "RenderingSupportComponent",
+                  dtUtil::MakeFunctor(&RenderingSupportComponent::SortLights, this));
       }
 
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////
       RenderingSupportComponent::~RenderingSupportComponent()
       {
+         mLightSortJob->RemoveFromFrameBudget();
       }
 
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -241,6 +248,7 @@ namespace SimCore
       void RenderingSupportComponent::OnRemovedFromGM()
       {
          dtCore::Camera::RemoveCameraSyncCallback(*this);
+         mLightSortJob->RemoveFromFrameBudget();
       }
 
       ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -722,6 +730,7 @@ namespace SimCore
 
          if (mEnableStaticTerrainPhysics)
          {
+            SimCore::StartupTracer::Phase phase("Static Terrain Physics", "Terrain");
 
             // Get the physics land actor
             SimCore::Actors::PagedTerrainPhysicsActorProxy* landActorProxy = NULL;
@@ -856,6 +865,13 @@ namespace SimCore
 
       ///////////////////////////////////////////////////////////////////////////////////////////////////
       void RenderingSupportComponent::TransformAndSortLights()
+      {
+         TransformLights();
+         SortLights();
+      }
+
+      ///////////////////////////////////////////////////////////////////////////////////////////////////
+      void RenderingSupportComponent::TransformLights()
       {
          LightArray::iterator iter = mLights.begin();
          LightArray::iterator endIter = mLights.end();
@@ -878,7 +894,11 @@ namespace SimCore
                }
             }
          }
+      }
 
+      ///////////////////////////////////////////////////////////////////////////////////////////////////
+      void RenderingSupportComponent::SortLights()
+      {
          //update uniforms by finding the closest lights to the camera
          dtCore::Transform trans;
          GetGameManager()->GetApplication().GetCamera()->GetTransform(trans);
@@ -1006,8 +1026,15 @@ namespace SimCore
       ///////////////////////////////////////////////////////////////////////////////////////////////////
       void RenderingSupportComponent::UpdateDynamicLights(float dt)
       {
+         SIMCORE_PROFILE_SCOPE("RenderingSupportComponent::UpdateDynamicLights");
+
          TimeoutAndDeleteLights(dt);
-         TransformAndSortLights();
+         TransformLights();
+         // The order only decides which lights make it into the uniforms, so it can lag a few frames when the frame is busy.
+         if (!FrameBudgetComponent::RequestJob(*GetGameManager(), *mLightSortJob))
+         {
+            SortLights();
+         }
 
          //now setup the lighting uniforms necessary for rendering the dynamic lights
          osg::StateSet* ss = GetGameManager()->GetScene().GetSceneNode()->getOrCreateStateSet();
@@ -0,0 +1,89 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/StartupTraceComponent.h>
+#include <SimCore/StartupTracer.h>
+
+#include <dtGame/messagetype.h>
+#include <dtGame/message.h>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      StartupTraceComponent::StartupTraceComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mMapChangeStartTick(0)
+         , mMapLoadStartTick(0)
+         , mMapChanging(false)
+         , mMapLoading(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      StartupTraceComponent::~StartupTraceComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void StartupTraceComponent::OnRemovedFromGM()
+      {
+         StartupTracer::GetInstance().WriteOutputFile();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void StartupTraceComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         const dtGame::MessageType& type = message.GetMessageType();
+         StartupTracer& tracer = StartupTracer::GetInstance();
+
+         if (type == dtGame::MessageType::INFO_MAP_CHANGE_BEGIN)
+         {
+            mMapChangeStartTick = tracer.Tick();
+            mMapChanging = true;
+         }
+         else if (type == dtGame::MessageType::INFO_MAP_LOAD_BEGIN)
+         {
+            mMapLoadStartTick = tracer.Tick();
+            mMapLoading = true;
+         }
+         else if (type == dtGame::MessageType::INFO_MAP_LOADED)
+         {
+            osg::Timer_t now = tracer.Tick();
+            if (mMapLoading)
+            {
+               tracer.RecordPhase("Map Load", StartupTracer::DEFAULT_CATEGORY, mMapLoadStartTick, now);
+               mMapLoading = false;
+            }
+            if (mMapChanging)
+            {
+               // This includes unloading the old map and the other components handling the messages.
+               tracer.RecordPhase("Map Change", StartupTracer::DEFAULT_CATEGORY, mMapChangeStartTick, now);
+               mMapChanging = false;
+            }
+
+            tracer.WriteOutputFile();
+         }
+      }
+   }
+}
@@ -0,0 +1,875 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/TerrainPhysicsPagingComponent.h>
+#include <SimCore/Components/RenderingSupportComponent.h>
+#include <SimCore/Actors/EntityActorRegistry.h>
+#include <SimCore/Actors/TerrainActorProxy.h>
+#include <SimCore/MessageType.h>
+
+#include <dtABC/application.h>
+#include <dtCore/camera.h>
+#include <dtCore/transformable.h>
+#include <dtCore/transform.h>
+#include <dtGame/basemessages.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+#include <dtPhysics/physicsactcomp.h>
+#include <dtPhysics/physicsobject.h>
+#include <dtUtil/configproperties.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+
+#include <osg/NodeVisitor>
+#include <osg/ProxyNode>
+#include <osg/Timer>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      // Geode Index Visitor - Finds the active geodes under the terrain and
+      // adds them to the index with their world matrix.
+      //////////////////////////////////////////////////////////////////////////
+      class GeodeIndexVisitor : public osg::NodeVisitor
+      {
+      public:
+         /**
+          * @param baseMatrix The world matrix of the node the traversal starts under.
+          * @param pagedNode The paged node that owns the geodes found outside of any other paged LOD.
+          */
+         GeodeIndexVisitor(TerrainGeodeIndex& index, const osg::Matrix& baseMatrix = osg::Matrix::identity(),
+            bool underProxyNode = false, unsigned pagedNode = TerrainGeodeIndex::NO_PAGED_NODE)
+            : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN)
+            , mIndex(index)
+            , mBaseMatrix(baseMatrix)
+            , mProxyNodeDepth(underProxyNode ? 1 : 0)
+            , mPagedNode(pagedNode)
+         {
+         }
+
+         virtual void apply(osg::ProxyNode& node)
+         {
+            ++mProxyNodeDepth;
+            traverse(node);
+            --mProxyNodeDepth;
+         }
+
+         virtual void apply(osg::PagedLOD& node)
+         {
+            // A tile that is already watched keeps its own entries.
+            if (mIndex.IsPagedNodeWatched(node))
+            {
+               return;
+            }
+
+            unsigned parentPagedNode = mPagedNode;
+            mPagedNode = mIndex.AddPagedNode(node, GetWorldMatrix(), mProxyNodeDepth > 0);
+            traverse(node);
+            mPagedNode = parentPagedNode;
+         }
+
+         virtual void apply(osg::Geode& node)
+         {
+            if (node.getBound().valid())
+            {
+               mIndex.AddGeode(node, GetWorldMatrix(), mProxyNodeDepth > 0, mPagedNode);
+            }
+         }
+
+      private:
+         osg::Matrix GetWorldMatrix() const
+         {
+            return osg::computeLocalToWorld(getNodePath()) * mBaseMatrix;
+         }
+
+         TerrainGeodeIndex& mIndex;
+         osg::Matrix mBaseMatrix;
+         int mProxyNodeDepth;
+         unsigned mPagedNode;
+      };
+
+      //////////////////////////////////////////////////////////////////////////
+      // Terrain Geode Index Code
+      //////////////////////////////////////////////////////////////////////////
+      const float TerrainGeodeIndex::DEFAULT_CELL_SIZE = 500.0f;
+      const unsigned TerrainGeodeIndex::NO_PAGED_NODE = UINT_MAX;
+
+      // Geodes wider than this many cells are kept out of the grid and checked on every query.
+      static const int MAX_CELLS_PER_GEODE_AXIS = 32;
+
+      //////////////////////////////////////////////////////////////////////////
+      TerrainGeodeIndex::Entry::Entry()
+         : mRadius(0.0f)
+         , mUnderProxyNode(false)
+         , mQueryStamp(0)
+         , mPagedNode(NO_PAGED_NODE)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      TerrainGeodeIndex::TerrainGeodeIndex()
+         : mCellSize(DEFAULT_CELL_SIZE)
+         , mQueryStamp(1)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      TerrainGeodeIndex::~TerrainGeodeIndex()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::SetCellSize( float cellSize )
+      {
+         if (cellSize > 0.0f)
+         {
+            mCellSize = cellSize;
+            Clear();
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      float TerrainGeodeIndex::GetCellSize() const
+      {
+         return mCellSize;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::Build( osg::Node& terrainNode )
+      {
+         Clear();
+         GeodeIndexVisitor visitor(*this);
+         terrainNode.accept(visitor);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::Clear()
+      {
+         mEntries.clear();
+         mFreeEntries.clear();
+         mCells.clear();
+         mLargeEntries.clear();
+         mPagedNodes.clear();
+         mWatchedNodes.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainGeodeIndex::GetNumGeodes() const
+      {
+         return unsigned(mEntries.size() - mFreeEntries.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainGeodeIndex::GetNumCells() const
+      {
+         return unsigned(mCells.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainGeodeIndex::GetNumPagedNodes() const
+      {
+         return unsigned(mPagedNodes.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      int TerrainGeodeIndex::ToCell( float value ) const
+      {
+         return int(std::floor(value / mCellSize));
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool TerrainGeodeIndex::GetCellRange( const Entry& entry, int& minX, int& maxX, int& minY, int& maxY ) const
+      {
+         minX = ToCell(entry.mWorldCenter.x() - entry.mRadius);
+         maxX = ToCell(entry.mWorldCenter.x() + entry.mRadius);
+         minY = ToCell(entry.mWorldCenter.y() - entry.mRadius);
+         maxY = ToCell(entry.mWorldCenter.y() + entry.mRadius);
+         return maxX - minX < MAX_CELLS_PER_GEODE_AXIS && maxY - minY < MAX_CELLS_PER_GEODE_AXIS;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::AddGeode( osg::Geode& geode, const osg::Matrix& worldMatrix, bool underProxyNode, unsigned pagedNode )
+      {
+         const osg::BoundingSphere& bound = geode.getBound();
+
+         Entry entry;
+         entry.mGeode = &geode;
+         entry.mWorldCenter = bound.center() * worldMatrix;
+         entry.mRadius = bound.radius();
+         entry.mWorldMatrix = worldMatrix;
+         entry.mUnderProxyNode = underProxyNode;
+         entry.mPagedNode = pagedNode;
+
+         unsigned entryIndex;
+         if (mFreeEntries.empty())
+         {
+            entryIndex = unsigned(mEntries.size());
+            mEntries.push_back(entry);
+         }
+         else
+         {
+            entryIndex = mFreeEntries.back();
+            mFreeEntries.pop_back();
+            mEntries[entryIndex] = entry;
+         }
+
+         if (pagedNode != NO_PAGED_NODE)
+         {
+            mPagedNodes[pagedNode].mEntries.push_back(entryIndex);
+         }
+
+         int minX, maxX, minY, maxY;
+         if (!GetCellRange(entry, minX, maxX, minY, maxY))
+         {
+            mLargeEntries.push_back(entryIndex);
+            return;
+         }
+
+         for (int x = minX; x <= maxX; ++x)
+         {
+            for (int y = minY; y <= maxY; ++y)
+            {
+               mCells[CellKey(x, y)].push_back(entryIndex);
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::RemoveEntry( unsigned entryIndex )
+      {
+         int minX, maxX, minY, maxY;
+         if (!GetCellRange(mEntries[entryIndex], minX, maxX, minY, maxY))
+         {
+            mLargeEntries.erase(std::remove(mLargeEntries.begin(), mLargeEntries.end(), entryIndex), mLargeEntries.end());
+         }
+         else
+         {
+            for (int x = minX; x <= maxX; ++x)
+            {
+               for (int y = minY; y <= maxY; ++y)
+               {
+                  CellMap::iterator cellIter = mCells.find(CellKey(x, y));
+                  if (cellIter == mCells.end())
+                  {
+                     continue;
+                  }
+
+                  std::vector<unsigned>& cell = cellIter->second;
+                  cell.erase(std::remove(cell.begin(), cell.end(), entryIndex), cell.end());
+                  if (cell.empty())
+                  {
+                     mCells.erase(cellIter);
+                  }
+               }
+            }
+         }
+
+         mEntries[entryIndex] = Entry();
+         mFreeEntries.push_back(entryIndex);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainGeodeIndex::AddPagedNode( osg::PagedLOD& node, const osg::Matrix& worldMatrix, bool underProxyNode )
+      {
+         PagedNode pagedNode;
+         pagedNode.mNode = &node;
+         pagedNode.mNodeKey = &node;
+         pagedNode.mNumChildren = node.getNumChildren();
+         pagedNode.mWorldMatrix = worldMatrix;
+         pagedNode.mUnderProxyNode = underProxyNode;
+         mPagedNodes.push_back(pagedNode);
+         mWatchedNodes.insert(&node);
+         return unsigned(mPagedNodes.size() - 1);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool TerrainGeodeIndex::IsPagedNodeWatched( const osg::PagedLOD& node ) const
+      {
+         return mWatchedNodes.find(&node) != mWatchedNodes.end();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::RemovePagedNodeEntries( PagedNode& pagedNode )
+      {
+         for (unsigned i = 0; i < pagedNode.mEntries.size(); ++i)
+         {
+            RemoveEntry(pagedNode.mEntries[i]);
+         }
+         pagedNode.mEntries.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::IndexPagedNode( unsigned pagedNode )
+      {
+         // Copied, since the visitor can add paged nodes found under this one.
+         osg::ref_ptr<osg::PagedLOD> node = mPagedNodes[pagedNode].mNode.get();
+         osg::Matrix worldMatrix = mPagedNodes[pagedNode].mWorldMatrix;
+         bool underProxyNode = mPagedNodes[pagedNode].mUnderProxyNode;
+
+         mPagedNodes[pagedNode].mNumChildren = node->getNumChildren();
+         GeodeIndexVisitor visitor(*this, worldMatrix, underProxyNode, pagedNode);
+         node->traverse(visitor);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainGeodeIndex::UpdatePagedNodes()
+      {
+         unsigned numUpdated = 0;
+
+         // Drop the tiles that were deleted with their parent first, so the parent doesn't find their
+         // entries when it is reindexed.  This changes the paged node indices, so the owners are fixed after.
+         bool removedAny = false;
+         for (unsigned i = 0; i < mPagedNodes.size(); ++i)
+         {
+            if (!mPagedNodes[i].mNode.valid())
+            {
+               RemovePagedNodeEntries(mPagedNodes[i]);
+               mWatchedNodes.erase(mPagedNodes[i].mNodeKey);
+               removedAny = true;
+               ++numUpdated;
+            }
+         }
+
+         if (removedAny)
+         {
+            unsigned numKept = 0;
+            for (unsigned i = 0; i < mPagedNodes.size(); ++i)
+            {
+               if (!mPagedNodes[i].mNode.valid())
+               {
+                  continue;
+               }
+
+               if (numKept != i)
+               {
+                  mPagedNodes[numKept] = mPagedNodes[i];
+                  for (unsigned j = 0; j < mPagedNodes[numKept].mEntries.size(); ++j)
+                  {
+                     mEntries[mPagedNodes[numKept].mEntries[j]].mPagedNode = numKept;
+                  }
+               }
+               ++numKept;
+            }
+            mPagedNodes.resize(numKept);
+         }
+
+         // Tiles added to the end by the reindexing were just indexed, so they aren't checked again.
+         unsigned numPagedNodes = unsigned(mPagedNodes.size());
+         for (unsigned i = 0; i < numPagedNodes; ++i)
+         {
+            if (mPagedNodes[i].mNode->getNumChildren() != mPagedNodes[i].mNumChildren)
+            {
+               RemovePagedNodeEntries(mPagedNodes[i]);
+               IndexPagedNode(i);
+               ++numUpdated;
+            }
+         }
+
+         return numUpdated;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::BeginQueries()
+      {
+         ++mQueryStamp;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::CheckEntry( unsigned entryIndex, const osg::Vec3& point, float radius,
+         std::vector<const Entry*>& result )
+      {
+         Entry& entry = mEntries[entryIndex];
+         if (entry.mQueryStamp == mQueryStamp)
+         {
+            return;
+         }
+
+         if ((entry.mWorldCenter - point).length() - entry.mRadius <= radius)
+         {
+            entry.mQueryStamp = mQueryStamp;
+            result.push_back(&entry);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainGeodeIndex::Query( const osg::Vec3& point, float radius, std::vector<const Entry*>& result )
+      {
+         int minX = ToCell(point.x() - radius);
+         int maxX = ToCell(point.x() + radius);
+         int minY = ToCell(point.y() - radius);
+         int maxY = ToCell(point.y() + radius);
+
+         for (int x = minX; x <= maxX; ++x)
+         {
+            for (int y = minY; y <= maxY; ++y)
+            {
+               CellMap::const_iterator cellIter = mCells.find(CellKey(x, y));
+               if (cellIter == mCells.end())
+               {
+                  continue;
+               }
+
+               const std::vector<unsigned>& cell = cellIter->second;
+               for (unsigned i = 0; i < cell.size(); ++i)
+               {
+                  CheckEntry(cell[i], point, radius, result);
+               }
+            }
+         }
+
+         for (unsigned i = 0; i < mLargeEntries.size(); ++i)
+         {
+            CheckEntry(mLargeEntries[i], point, radius, result);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      // Terrain Physics Paging Component Code
+      //////////////////////////////////////////////////////////////////////////
+      TerrainPhysicsPagingComponent::TerrainPhysicsPagingComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mCookingRadius(1250.0f)
+         , mUpdateInterval(0.5f)
+         , mIncludeCamera(true)
+         , mIncludeLocalPhysicsActors(true)
+         , mIndex(new TerrainGeodeIndex)
+         , mTimeUntilUpdate(0.0f)
+         , mLastNumFocusPoints(0)
+         , mLastNumGeodesChecked(0)
+         , mLastNumTilesReindexed(0)
+         , mLastUpdateTimeMS(0.0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      TerrainPhysicsPagingComponent::~TerrainPhysicsPagingComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(TerrainPhysicsPagingComponent, float, CookingRadius);
+      DT_IMPLEMENT_ACCESSOR(TerrainPhysicsPagingComponent, float, UpdateInterval);
+      DT_IMPLEMENT_ACCESSOR(TerrainPhysicsPagingComponent, bool, IncludeCamera);
+      DT_IMPLEMENT_ACCESSOR(TerrainPhysicsPagingComponent, bool, IncludeLocalPhysicsActors);
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::AddFocusActor( const dtCore::UniqueId& actorId )
+      {
+         mFocusActors.insert(actorId);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::RemoveFocusActor( const dtCore::UniqueId& actorId )
+      {
+         mFocusActors.erase(actorId);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool TerrainPhysicsPagingComponent::IsFocusActor( const dtCore::UniqueId& actorId ) const
+      {
+         return mFocusActors.find(actorId) != mFocusActors.end();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      TerrainGeodeIndex& TerrainPhysicsPagingComponent::GetGeodeIndex()
+      {
+         return *mIndex;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::RebuildIndex()
+      {
+         if (GetGameManager() == NULL)
+         {
+            return;
+         }
+
+         dtCore::ActorProxy* terrainActorProxy = NULL;
+         GetGameManager()->FindActorByName(SimCore::Actors::TerrainActor::DEFAULT_NAME, terrainActorProxy);
+         if (terrainActorProxy == NULL || terrainActorProxy->GetDrawable() == NULL)
+         {
+            SetTerrainNode(NULL);
+            return;
+         }
+
+         SetTerrainNode(terrainActorProxy->GetDrawable()->GetOSGNode());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::SetTerrainNode( osg::Node* terrainNode )
+      {
+         mTerrainNode = terrainNode;
+         if (terrainNode == NULL)
+         {
+            mIndex->Clear();
+         }
+         else
+         {
+            mIndex->Build(*terrainNode);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      osg::Node* TerrainPhysicsPagingComponent::GetTerrainNode()
+      {
+         return mTerrainNode.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainPhysicsPagingComponent::GetNumPhysicsActors() const
+      {
+         return unsigned(mPhysicsActors.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      SimCore::Actors::PagedTerrainPhysicsActor* TerrainPhysicsPagingComponent::GetLandActor()
+      {
+         if (!mLandActor.valid() && GetGameManager() != NULL)
+         {
+            SimCore::Actors::PagedTerrainPhysicsActorProxy* landActorProxy = NULL;
+            GetGameManager()->FindActorByName(SimCore::Actors::PagedTerrainPhysicsActor::DEFAULT_NAME, landActorProxy);
+
+            if (landActorProxy == NULL)
+            {
+               dtCore::RefPtr<SimCore::Actors::PagedTerrainPhysicsActorProxy> terrainPhysicsActorProxy;
+               GetGameManager()->CreateActor(*SimCore::Actors::EntityActorRegistry::PAGED_TERRAIN_PHYSICS_ACTOR_TYPE, terrainPhysicsActorProxy);
+               GetGameManager()->AddActor(*terrainPhysicsActorProxy, false, false);
+               landActorProxy = terrainPhysicsActorProxy.get();
+            }
+
+            SimCore::Actors::PagedTerrainPhysicsActor* landActor = NULL;
+            landActorProxy->GetDrawable(landActor);
+            mLandActor = landActor;
+         }
+
+         return mLandActor.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::AddActorPosition( dtGame::GameActorProxy& actor, std::vector<osg::Vec3>& outPoints )
+      {
+         dtCore::Transformable* xformable = NULL;
+         actor.GetDrawable(xformable);
+         if (xformable != NULL)
+         {
+            dtCore::Transform xform;
+            osg::Vec3 position;
+            xformable->GetTransform(xform);
+            xform.GetTranslation(position);
+            outPoints.push_back(position);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::TrackPhysicsActor( dtGame::GameActorProxy& actor )
+      {
+         if (actor.IsRemote())
+         {
+            return;
+         }
+
+         dtPhysics::PhysicsActComp* physAC = NULL;
+         actor.GetComponent(physAC);
+         if (physAC == NULL)
+         {
+            return;
+         }
+
+         dtPhysics::PhysicsObject* po = physAC->GetMainPhysicsObject();
+         if (po != NULL && po->GetMechanicsType() == dtPhysics::MechanicsType::DYNAMIC)
+         {
+            mPhysicsActors[actor.GetId()] = &actor;
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::TrackAllPhysicsActors()
+      {
+         std::vector<dtGame::GameActorProxy*> allActors;
+         GetGameManager()->GetAllGameActors(allActors);
+         for (unsigned i = 0; i < allActors.size(); ++i)
+         {
+            TrackPhysicsActor(*allActors[i]);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::GetFocusPoints( std::vector<osg::Vec3>& outPoints )
+      {
+         dtGame::GameManager* gm = GetGameManager();
+         if (gm == NULL)
+         {
+            return;
+         }
+
+         if (mIncludeCamera && gm->GetApplication().GetCamera() != NULL)
+         {
+            dtCore::Transform xform;
+            osg::Vec3 position;
+            gm->GetApplication().GetCamera()->GetTransform(xform);
+            xform.GetTranslation(position);
+            outPoints.push_back(position);
+         }
+
+         std::set<dtCore::UniqueId>::iterator focusIter = mFocusActors.begin();
+         while (focusIter != mFocusActors.end())
+         {
+            dtGame::GameActorProxy* actor = gm->FindGameActorById(*focusIter);
+            if (actor == NULL)
+            {
+               mFocusActors.erase(focusIter++);
+               continue;
+            }
+
+            AddActorPosition(*actor, outPoints);
+            ++focusIter;
+         }
+
+         if (mIncludeLocalPhysicsActors)
+         {
+            ActorMap::iterator actorIter = mPhysicsActors.begin();
+            while (actorIter != mPhysicsActors.end())
+            {
+               if (!actorIter->second.valid())
+               {
+                  mPhysicsActors.erase(actorIter++);
+                  continue;
+               }
+
+               if (!IsFocusActor(actorIter->first))
+               {
+                  AddActorPosition(*actorIter->second, outPoints);
+               }
+               ++actorIter;
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::UpdateTerrainPhysics()
+      {
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+         SimCore::Actors::PagedTerrainPhysicsActor* landActor = GetLandActor();
+         if (landActor == NULL)
+         {
+            return;
+         }
+
+         // Only the tiles the pager changed since the last update are reindexed.
+         mLastNumTilesReindexed = mIndex->UpdatePagedNodes();
+
+         mFocusPoints.clear();
+         GetFocusPoints(mFocusPoints);
+
+         mGeodesToCheck.clear();
+         mIndex->BeginQueries();
+         for (unsigned i = 0; i < mFocusPoints.size(); ++i)
+         {
+            mIndex->Query(mFocusPoints[i], mCookingRadius, mGeodesToCheck);
+         }
+
+         for (unsigned i = 0; i < mGeodesToCheck.size(); ++i)
+         {
+            const TerrainGeodeIndex::Entry& entry = *mGeodesToCheck[i];
+            // The geode may have been paged out since the index was built.
+            if (entry.mGeode.valid())
+            {
+               landActor->CheckGeode(*entry.mGeode, entry.mUnderProxyNode, entry.mWorldMatrix);
+            }
+         }
+
+         // Tiles not checked above go back to being disabled.
+         landActor->ResetTerrainIterator();
+         landActor->FinalizeTerrain(1);
+
+         mLastNumFocusPoints = unsigned(mFocusPoints.size());
+         mLastNumGeodesChecked = unsigned(mGeodesToCheck.size());
+         mLastUpdateTimeMS = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainPhysicsPagingComponent::GetLastNumFocusPoints() const
+      {
+         return mLastNumFocusPoints;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainPhysicsPagingComponent::GetLastNumGeodesChecked() const
+      {
+         return mLastNumGeodesChecked;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned TerrainPhysicsPagingComponent::GetLastNumTilesReindexed() const
+      {
+         return mLastNumTilesReindexed;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      double TerrainPhysicsPagingComponent::GetLastUpdateTimeMS() const
+      {
+         return mLastUpdateTimeMS;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::DisableCullVisitorPhysics()
+      {
+         RenderingSupportComponent* renderingComp = NULL;
+         GetGameManager()->GetComponentByName(RenderingSupportComponent::DEFAULT_NAME, renderingComp);
+         if (renderingComp == NULL)
+         {
+            return;
+         }
+
+         if (renderingComp->GetCullVisitor() != NULL && renderingComp->GetCullVisitor()->GetEnablePhysics())
+         {
+            LOG_WARNING("The terrain physics paging component is loading the terrain physics. Disabling the physics in the cull visitor.");
+            renderingComp->GetCullVisitor()->SetEnablePhysics(false);
+         }
+
+         if (renderingComp->GetEnableStaticTerrainPhysics())
+         {
+            LOG_WARNING("Static terrain physics is enabled on the rendering support component, so the terrain physics paging component will page tiles that are already loaded.");
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::Reset()
+      {
+         mIndex->Clear();
+         mTerrainNode = NULL;
+         mFocusActors.clear();
+         mPhysicsActors.clear();
+         mFocusPoints.clear();
+         mGeodesToCheck.clear();
+         mTimeUntilUpdate = 0.0f;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::OnAddedToGM()
+      {
+         BaseClass::OnAddedToGM();
+
+         dtUtil::ConfigProperties& config = GetGameManager()->GetConfiguration();
+
+         std::string value = config.GetConfigPropertyValue(GetName() + ".CookingRadius");
+         if (!value.empty())
+         {
+            SetCookingRadius(dtUtil::ToType<float>(value));
+         }
+
+         value = config.GetConfigPropertyValue(GetName() + ".UpdateInterval");
+         if (!value.empty())
+         {
+            SetUpdateInterval(dtUtil::ToType<float>(value));
+         }
+
+         value = config.GetConfigPropertyValue(GetName() + ".IncludeCamera");
+         if (!value.empty())
+         {
+            SetIncludeCamera(dtUtil::ToType<bool>(value));
+         }
+
+         value = config.GetConfigPropertyValue(GetName() + ".IncludeLocalPhysicsActors");
+         if (!value.empty())
+         {
+            SetIncludeLocalPhysicsActors(dtUtil::ToType<bool>(value));
+         }
+
+         value = config.GetConfigPropertyValue(GetName() + ".IndexCellSize");
+         if (!value.empty())
+         {
+            mIndex->SetCellSize(dtUtil::ToType<float>(value));
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::OnRemovedFromGM()
+      {
+         Reset();
+         mLandActor = NULL;
+         BaseClass::OnRemovedFromGM();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::ProcessTick( float deltaTime )
+      {
+         mTimeUntilUpdate -= deltaTime;
+         if (mTimeUntilUpdate > 0.0f)
+         {
+            return;
+         }
+         mTimeUntilUpdate = mUpdateInterval;
+
+         UpdateTerrainPhysics();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TerrainPhysicsPagingComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         const dtGame::MessageType& type = message.GetMessageType();
+
+         if (type == dtGame::MessageType::TICK_LOCAL)
+         {
+            ProcessTick(float(static_cast<const dtGame::TickMessage&>(message).GetDeltaSimTime()));
+         }
+         else if (type == dtGame::MessageType::INFO_ACTOR_CREATED)
+         {
+            dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(message.GetAboutActorId());
+            if (actor != NULL)
+            {
+               TrackPhysicsActor(*actor);
+            }
+         }
+         else if (type == dtGame::MessageType::INFO_ACTOR_DELETED)
+         {
+            RemoveFocusActor(message.GetAboutActorId());
+            mPhysicsActors.erase(message.GetAboutActorId());
+         }
+         else if (type == SimCore::MessageType::INFO_TERRAIN_LOADED)
+         {
+            RebuildIndex();
+         }
+         else if (type == dtGame::MessageType::INFO_MAP_LOADED)
+         {
+            DisableCullVisitorPhysics();
+            RebuildIndex();
+            // The actors in the map don't all send a create message.
+            TrackAllPhysicsActors();
+         }
+         else if (type == dtGame::MessageType::INFO_RESTARTED
+            || type == dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN)
+         {
+            Reset();
+         }
+      }
+
+   }
+}
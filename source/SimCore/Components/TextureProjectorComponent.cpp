@@ -23,6 +23,7 @@
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/Components/TextureProjectorComponent.h>
 #include <SimCore/Actors/TextureProjectorActor.h>
+#include <SimCore/Actors/EntityActorRegistry.h>
 
 #include <dtGame/gamemanager.h>
 #include <dtGame/messagetype.h>
@@ -32,6 +33,10 @@
 #include <dtABC/application.h>
 
 #include <dtCore/scene.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/log.h>
+
+#include <algorithm>
 using namespace dtGame;
 
 namespace SimCore
@@ -41,7 +46,10 @@ namespace SimCore
       ////////////////////////////////////////////////////////////////////
       TextureProjectorComponent::TextureProjectorComponent(dtCore::SystemComponentType& type)
       : dtGame::GMComponent(type)
-      , mMaxNumberOfProjectedTextures(100)
+      , mMaxNumberOfProjectedTextures(DEFAULT_MAX_NUMBER_OF_PROJECTED_TEXTURES)
+      , mMaxIdleProjectors(DEFAULT_MAX_IDLE_PROJECTORS)
+      , mNextSerial(0)
+      , mSimTime(0.0)
       {
       }
 
@@ -62,58 +70,254 @@ namespace SimCore
          else if(msg.GetMessageType() == MessageType::INFO_ACTOR_PUBLISHED){}
          else if(msg.GetMessageType() == MessageType::INFO_ACTOR_DELETED)
          {
-            //GameActorProxy *ga = GetGameManager()->FindGameActorById(msg.GetAboutActorId());
-            //if(ga && ga->IsPublished())
-            //   ProcessDeleteActor(static_cast<const ActorDeletedMessage&>(msg));
+            // The heap entry for it is skipped once it is no longer active.
+            mActiveProjectors.erase(msg.GetAboutActorId());
+            RemoveIdleProjector(msg.GetAboutActorId());
          }
          else if(msg.GetMessageType() == MessageType::INFO_ACTOR_UPDATED){}
          else if(msg.GetMessageType() == MessageType::INFO_MAP_LOADED){}
          else if(msg.GetMessageType() == MessageType::INFO_MAP_UNLOADED){}
       }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::OnRemovedFromGM()
+      {
+         Clear();
+      }
  
       /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       void TextureProjectorComponent::ProcessTick(const dtGame::TickMessage &msg)
       {
-         std::list<dtCore::RefPtr<Actors::TextureProjectorActor> >::iterator listIter = mActorList.begin();
-         for(; listIter != mActorList.end(); ++listIter)
+         mSimTime = msg.GetSimulationTime();
+
+         // Only the expired projectors are popped.  One whose time was changed after it was
+         // added is checked against its own time and pushed back if it hasn't expired.
+         std::vector<ExpiryEntry> notExpired;
+         while (!mExpiryHeap.empty() && mExpiryHeap.front().mExpireSimTime <= mSimTime)
          {
-            if( (*listIter)->GetCurrTime() > (*listIter)->GetMaxTime() )
+            std::pop_heap(mExpiryHeap.begin(), mExpiryHeap.end());
+            ExpiryEntry entry = mExpiryHeap.back();
+            mExpiryHeap.pop_back();
+
+            if (!IsCurrent(entry))
             {
-               GetGameManager()->DeleteActor((*listIter)->GetGameActorProxy());
-               mActorList.erase(listIter);
-               listIter = mActorList.begin();
+               continue;
             }
+
+            Actors::TextureProjectorActor& actor = *entry.mActor;
+            if (actor.GetCurrTime() > actor.GetMaxTime())
+            {
+               mActiveProjectors.erase(actor.GetUniqueId());
+               RetireProjector(actor);
+            }
+            else
+            {
+               entry.mExpireSimTime = mSimTime + double(actor.GetMaxTime() - actor.GetCurrTime());
+               notExpired.push_back(entry);
+            }
+         }
+
+         for (unsigned i = 0; i < notExpired.size(); ++i)
+         {
+            mExpiryHeap.push_back(notExpired[i]);
+            std::push_heap(mExpiryHeap.begin(), mExpiryHeap.end());
          }
 
-         while(mActorList.size() > mMaxNumberOfProjectedTextures)
+         // Too many projectors, so remove the ones that would have expired first.
+         while (mActiveProjectors.size() > mMaxNumberOfProjectedTextures && !mExpiryHeap.empty())
          {
-            listIter = mActorList.begin();
-            GetGameManager()->DeleteActor((*listIter)->GetGameActorProxy());
-            mActorList.erase(listIter);
+            std::pop_heap(mExpiryHeap.begin(), mExpiryHeap.end());
+            ExpiryEntry entry = mExpiryHeap.back();
+            mExpiryHeap.pop_back();
+
+            if (IsCurrent(entry))
+            {
+               mActiveProjectors.erase(entry.mActor->GetUniqueId());
+               RetireProjector(*entry.mActor);
+            }
          }
+
+         CompactExpiryHeap();
       }
 
       /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       void TextureProjectorComponent::AddTextureProjectorActorToComponent(Actors::TextureProjectorActor &toAdd)
       {
-         mActorList.push_back(&toAdd);
+         // Adding a projector again gives it a new entry, and the old one goes stale.
+         unsigned serial = ++mNextSerial;
+         mActiveProjectors[toAdd.GetUniqueId()] = serial;
+         PushExpiry(toAdd, serial);
       }
 
       /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
       void TextureProjectorComponent::RemoveTextureProjectorActorFromComponent(Actors::TextureProjectorActor &toRemove)
       {
-         std::list<dtCore::RefPtr<Actors::TextureProjectorActor> >::iterator listIter, listIterEnd; 
-         listIter = mActorList.begin();
-         listIterEnd = mActorList.end();
-         
-         for(; listIter != listIterEnd; ++listIter)
+         mActiveProjectors.erase(toRemove.GetUniqueId());
+         RemoveIdleProjector(toRemove.GetUniqueId());
+         CompactExpiryHeap();
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      dtCore::RefPtr<Actors::TextureProjectorActorProxy> TextureProjectorComponent::AcquireTextureProjector(bool& outReused)
+      {
+         outReused = false;
+         dtCore::RefPtr<Actors::TextureProjectorActorProxy> proxy;
+
+         dtGame::GameManager* gm = GetGameManager();
+         if (gm == NULL)
          {
-            if((*listIter)->GetUniqueId() == toRemove.GetUniqueId())
+            LOG_ERROR("The TextureProjectorComponent must be added to a game manager to create texture projectors.");
+            return proxy;
+         }
+
+         while (!mIdleProjectors.empty())
+         {
+            proxy = mIdleProjectors.back();
+            mIdleProjectors.pop_back();
+            if (gm->FindActorById(proxy->GetId()) != NULL)
             {
-               mActorList.erase(listIter);
+               outReused = true;
+               return proxy;
+            }
+         }
+
+         proxy = NULL;
+         try
+         {
+            gm->CreateActor(*Actors::EntityActorRegistry::TEXTURE_PROJECTION_ACTOR_TYPE, proxy);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            ex.LogException(dtUtil::Log::LOG_ERROR);
+            proxy = NULL;
+         }
+         return proxy;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::SetMaxNumberOfProjectedTextures(unsigned maxNum)
+      {
+         mMaxNumberOfProjectedTextures = maxNum;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      unsigned TextureProjectorComponent::GetMaxNumberOfProjectedTextures() const
+      {
+         return mMaxNumberOfProjectedTextures;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::SetMaxIdleProjectors(unsigned maxIdle)
+      {
+         mMaxIdleProjectors = maxIdle;
+
+         // Delete the idle projectors that no longer fit.
+         while (mIdleProjectors.size() > mMaxIdleProjectors)
+         {
+            if (GetGameManager() != NULL)
+            {
+               GetGameManager()->DeleteActor(*mIdleProjectors.back());
+            }
+            mIdleProjectors.pop_back();
+         }
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      unsigned TextureProjectorComponent::GetMaxIdleProjectors() const
+      {
+         return mMaxIdleProjectors;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      unsigned TextureProjectorComponent::GetNumProjectedTextures() const
+      {
+         return unsigned(mActiveProjectors.size());
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      unsigned TextureProjectorComponent::GetNumIdleProjectors() const
+      {
+         return unsigned(mIdleProjectors.size());
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::PushExpiry(Actors::TextureProjectorActor& actor, unsigned serial)
+      {
+         ExpiryEntry entry;
+         entry.mExpireSimTime = mSimTime + double(std::max(0.0f, actor.GetMaxTime() - actor.GetCurrTime()));
+         entry.mSerial = serial;
+         entry.mActor = &actor;
+         mExpiryHeap.push_back(entry);
+         std::push_heap(mExpiryHeap.begin(), mExpiryHeap.end());
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      bool TextureProjectorComponent::IsCurrent(const ExpiryEntry& entry) const
+      {
+         std::map<dtCore::UniqueId, unsigned>::const_iterator found = mActiveProjectors.find(entry.mActor->GetUniqueId());
+         return found != mActiveProjectors.end() && found->second == entry.mSerial;
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::RetireProjector(Actors::TextureProjectorActor& actor)
+      {
+         actor.StopProjecting();
+
+         Actors::TextureProjectorActorProxy* proxy =
+            dynamic_cast<Actors::TextureProjectorActorProxy*>(&actor.GetGameActorProxy());
+         if (proxy != NULL && mIdleProjectors.size() < mMaxIdleProjectors)
+         {
+            mIdleProjectors.push_back(proxy);
+         }
+         else if (GetGameManager() != NULL)
+         {
+            GetGameManager()->DeleteActor(actor.GetGameActorProxy());
+         }
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::CompactExpiryHeap()
+      {
+         // Removed projectors leave their entries behind until they reach the top.  Dropping them all
+         // once they outnumber the live ones keeps the heap small at an amortized constant cost.
+         if (mExpiryHeap.size() <= 2 * mActiveProjectors.size() + 16)
+         {
+            return;
+         }
+
+         std::vector<ExpiryEntry> current;
+         current.reserve(mActiveProjectors.size());
+         for (unsigned i = 0; i < mExpiryHeap.size(); ++i)
+         {
+            if (IsCurrent(mExpiryHeap[i]))
+            {
+               current.push_back(mExpiryHeap[i]);
+            }
+         }
+         mExpiryHeap.swap(current);
+         std::make_heap(mExpiryHeap.begin(), mExpiryHeap.end());
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::RemoveIdleProjector(const dtCore::UniqueId& id)
+      {
+         for (unsigned i = 0; i < mIdleProjectors.size(); ++i)
+         {
+            if (mIdleProjectors[i]->GetId() == id)
+            {
+               mIdleProjectors[i] = mIdleProjectors.back();
+               mIdleProjectors.pop_back();
                return;
             }
          }
       }
+
+      /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void TextureProjectorComponent::Clear()
+      {
+         mExpiryHeap.clear();
+         mActiveProjectors.clear();
+         mIdleProjectors.clear();
+      }
    }
 }
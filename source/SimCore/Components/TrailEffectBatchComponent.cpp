@@ -0,0 +1,73 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/TrailEffectBatchComponent.h>
+#include <SimCore/TrailEffectBatch.h>
+
+#include <dtCore/scene.h>
+#include <dtGame/gamemanager.h>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      TrailEffectBatchComponent::TrailEffectBatchComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      TrailEffectBatchComponent::~TrailEffectBatchComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      SimCore::TrailEffectBatch* TrailEffectBatchComponent::GetBatch()
+      {
+         return mBatch.get();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TrailEffectBatchComponent::OnAddedToGM()
+      {
+         BaseClass::OnAddedToGM();
+
+         mBatch = new SimCore::TrailEffectBatch();
+         // The batch applies the new points from the update traversal.
+         GetGameManager()->GetScene().AddChild(mBatch.get());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TrailEffectBatchComponent::OnRemovedFromGM()
+      {
+         if (mBatch.valid())
+         {
+            GetGameManager()->GetScene().RemoveChild(mBatch.get());
+            mBatch = NULL;
+         }
+
+         BaseClass::OnRemovedFromGM();
+      }
+   }
+}
@@ -31,13 +31,39 @@
 #include <dtABC/application.h>
 #include <dtCore/scene.h>
 
+#include <climits>
+#include <sstream>
+
 namespace SimCore
 {
    namespace Components
    {
+      static const unsigned NOT_FOUND = UINT_MAX;
+      static const std::string DEFAULT_MATERIAL_NAME("DefaultMaterial");
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      ViewerMaterialComponent::MaterialHandle::MaterialHandle()
+      : mIndex(NOT_FOUND)
+      , mGeneration(0)
+      {
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      bool ViewerMaterialComponent::MaterialHandle::operator==(const MaterialHandle& other) const
+      {
+         return mIndex == other.mIndex && mGeneration == other.mGeneration;
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      bool ViewerMaterialComponent::MaterialHandle::operator!=(const MaterialHandle& other) const
+      {
+         return !(*this == other);
+      }
+
       ////////////////////////////////////////////////////////////////////////////////////////////////////////////
       ViewerMaterialComponent::ViewerMaterialComponent(dtCore::SystemComponentType& type)
       : BaseClass(type)
+      , mGeneration(1)
       {
          mClearMaterialsOnMapChange = false;
       }
@@ -99,69 +125,223 @@ namespace SimCore
       void ViewerMaterialComponent::RemoveAllMaterials()
       {
          mOurMaterials.clear();
+         mNameIndex.clear();
+         mFIDIndex.clear();
+         mWarnedFIDs.clear();
+         ++mGeneration;
       }
 
-      //////////////////////////////////////////////////////////////////////////////////////
-      const SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::GetConstMaterialByName(const std::string& materialName)
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void ViewerMaterialComponent::RegisterAMaterialWithComponent(SimCore::Actors::ViewerMaterialActor* material)
+      {
+         if (FindMaterialIndex(material->GetName()) == NOT_FOUND)
+         {
+            AddMaterial(*material);
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void ViewerMaterialComponent::OnMaterialRenamed(SimCore::Actors::ViewerMaterialActor& material)
+      {
+         // The new name may be one an FID code missed before, or the old name one it found.
+         mFIDIndex.clear();
+         RebuildNameIndex();
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void ViewerMaterialComponent::AddMaterial(SimCore::Actors::ViewerMaterialActor& material)
       {
-         static const std::string DEFAULT_MATERIAL_NAME("DefaultMaterial");
+         // The new material may be the one of an FID code that missed.
+         mFIDIndex.clear();
+         // insert won't replace an earlier material with the same name, which is the one the old search found.
+         mNameIndex.insert(std::make_pair(material.GetName(), unsigned(mOurMaterials.size())));
+         mOurMaterials.push_back(&material);
+      }
 
-         std::vector<dtCore::RefPtr<SimCore::Actors::ViewerMaterialActor> >::iterator iter =  mOurMaterials.begin();
-         for (;iter != mOurMaterials.end(); ++iter)
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      void ViewerMaterialComponent::RebuildNameIndex()
+      {
+         mNameIndex.clear();
+         for (unsigned i = 0; i < mOurMaterials.size(); ++i)
          {
-            if((*iter)->GetName() == materialName)
+            mNameIndex.insert(std::make_pair(mOurMaterials[i]->GetName(), i));
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      unsigned ViewerMaterialComponent::FindMaterialIndex(const std::string& materialName)
+      {
+         NameIndex::const_iterator found = mNameIndex.find(materialName);
+         if (found != mNameIndex.end() && mOurMaterials[found->second]->GetName() == materialName)
+         {
+            return found->second;
+         }
+
+         // The name isn't indexed, or a material was renamed after it was added, so search
+         // the slow way, and fix the index if that finds it.
+         for (unsigned i = 0; i < mOurMaterials.size(); ++i)
+         {
+            if (mOurMaterials[i]->GetName() == materialName)
             {
-               return *(*iter).get();
+               RebuildNameIndex();
+               return i;
             }
          }
+         return NOT_FOUND;
+      }
 
-         if (materialName != DEFAULT_MATERIAL_NAME)
+      ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+      unsigned ViewerMaterialComponent::FindMaterialIndexByFID(unsigned fid)
+      {
+         FIDIndex::iterator found = mFIDIndex.find(fid);
+         if (found != mFIDIndex.end())
          {
-            LOG_WARNING("GetConstMaterialByName(const std::string& materialName) Could not find your material. Returning Default Material");
-            if (mOurMaterials.empty())
+            if (found->second.mIndex == NOT_FOUND
+               || mOurMaterials[found->second.mIndex]->GetName() == found->second.mName)
             {
-               LOG_WARNING("Map must not have been intialized, default material wasnt made, making now.");
-               CreateOrChangeMaterialByName(DEFAULT_MATERIAL_NAME);
+               return found->second.mIndex;
             }
+            // Renamed since it was indexed, without the actor telling us.
+            mFIDIndex.erase(found);
          }
-         else
+
+         FIDEntry entry;
+         entry.mName = FID_ID_ToString(fid);
+         entry.mIndex = FindMaterialIndex(entry.mName);
+         mFIDIndex.insert(std::make_pair(fid, entry));
+         return entry.mIndex;
+      }
+
+      //////////////////////////////////////////////////////////////////////////////////////
+      ViewerMaterialComponent::MaterialHandle ViewerMaterialComponent::FindMaterialHandle(const std::string& materialName)
+      {
+         MaterialHandle handle;
+         handle.mIndex = FindMaterialIndex(materialName);
+         if (handle.mIndex != NOT_FOUND)
          {
-            CreateOrChangeMaterialByName(DEFAULT_MATERIAL_NAME);
+            handle.mGeneration = mGeneration;
          }
+         return handle;
+      }
 
-         return GetConstMaterialByName(DEFAULT_MATERIAL_NAME);
+      //////////////////////////////////////////////////////////////////////////////////////
+      ViewerMaterialComponent::MaterialHandle ViewerMaterialComponent::FindMaterialHandleByFID(const unsigned int fidIDToCheckWith)
+      {
+         MaterialHandle handle;
+         handle.mIndex = FindMaterialIndexByFID(fidIDToCheckWith);
+         if (handle.mIndex != NOT_FOUND)
+         {
+            handle.mGeneration = mGeneration;
+         }
+         return handle;
+      }
+
+      //////////////////////////////////////////////////////////////////////////////////////
+      bool ViewerMaterialComponent::IsValidHandle(const MaterialHandle& handle) const
+      {
+         return handle.mGeneration == mGeneration && handle.mIndex < mOurMaterials.size();
+      }
+
+      //////////////////////////////////////////////////////////////////////////////////////
+      const SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::GetConstMaterial(const MaterialHandle& handle)
+      {
+         if (IsValidHandle(handle))
+         {
+            return *mOurMaterials[handle.mIndex];
+         }
+         return GetDefaultMaterial();
+      }
+
+      //////////////////////////////////////////////////////////////////////////////////////
+      unsigned ViewerMaterialComponent::GetNumMaterials() const
+      {
+         return unsigned(mOurMaterials.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////////////////
+      const SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::GetConstMaterialByName(const std::string& materialName)
+      {
+         unsigned index = FindMaterialIndex(materialName);
+         if (index != NOT_FOUND)
+         {
+            return *mOurMaterials[index];
+         }
+
+         if (materialName != DEFAULT_MATERIAL_NAME)
+         {
+            LOG_WARNING("GetConstMaterialByName(const std::string& materialName) Could not find your material. Returning Default Material");
+         }
+         return GetDefaultMaterial();
       }
 
       //////////////////////////////////////////////////////////////////////////////////////
       const SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::GetConstMaterialByFID(const unsigned int fidIDToCheckWith)
       {
-         return GetConstMaterialByName(FID_ID_ToString(fidIDToCheckWith));
+         unsigned index = FindMaterialIndexByFID(fidIDToCheckWith);
+         if (index != NOT_FOUND)
+         {
+            return *mOurMaterials[index];
+         }
+
+         // This is called for every hit on the terrain, so only say it once per code.
+         if (mWarnedFIDs.insert(fidIDToCheckWith).second)
+         {
+            std::ostringstream msg;
+            msg << "GetConstMaterialByFID could not find the material for FID " << fidIDToCheckWith << ". Returning Default Material";
+            LOG_WARNING(msg.str());
+         }
+         return GetDefaultMaterial();
+      }
+
+      //////////////////////////////////////////////////////////////////////////////////////
+      const SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::GetDefaultMaterial()
+      {
+         unsigned index = FindMaterialIndex(DEFAULT_MATERIAL_NAME);
+         if (index != NOT_FOUND)
+         {
+            return *mOurMaterials[index];
+         }
+
+         if (mOurMaterials.empty())
+         {
+            LOG_WARNING("Map must not have been intialized, default material wasnt made, making now.");
+         }
+         return CreateOrChangeMaterialByName(DEFAULT_MATERIAL_NAME);
       }
 
       //////////////////////////////////////////////////////////////////////////////////////
       SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::CreateOrChangeMaterialByName(const std::string& materialName)
       {
-         std::vector<dtCore::RefPtr<SimCore::Actors::ViewerMaterialActor> >::iterator iter = mOurMaterials.begin();
-         for(;iter != mOurMaterials.end(); ++iter)
+         unsigned index = FindMaterialIndex(materialName);
+         if (index != NOT_FOUND)
          {
-            if((*iter)->GetName() == materialName)
-            {
-               return *(*iter).get();
-            }
+            return *mOurMaterials[index];
          }
 
          // Couldnt find material... make a new one.
          dtCore::RefPtr<SimCore::Actors::ViewerMaterialActor> materialToMake;
          GetGameManager()->CreateActor(*SimCore::Actors::EntityActorRegistry::MATERIAL_ACTOR_TYPE, materialToMake);
          materialToMake->SetName(materialName);
-         mOurMaterials.push_back(materialToMake);
+         AddMaterial(*materialToMake);
          return *materialToMake;
       }
 
       //////////////////////////////////////////////////////////////////////////////////////
       SimCore::Actors::ViewerMaterialActor& ViewerMaterialComponent::CreateOrChangeMaterialByFID(const unsigned int fidIDToMakeWith)
       {
-         return CreateOrChangeMaterialByName(FID_ID_ToString(fidIDToMakeWith));
+         unsigned index = FindMaterialIndexByFID(fidIDToMakeWith);
+         if (index != NOT_FOUND)
+         {
+            return *mOurMaterials[index];
+         }
+
+         FIDEntry entry;
+         entry.mName = FID_ID_ToString(fidIDToMakeWith);
+         SimCore::Actors::ViewerMaterialActor& material = CreateOrChangeMaterialByName(entry.mName);
+         // Look the index up, the name may have been there already.
+         entry.mIndex = FindMaterialIndex(entry.mName);
+         mFIDIndex[fidIDToMakeWith] = entry;
+         return material;
       }
 
       //////////////////////////////////////////////////////////////////////////////////////
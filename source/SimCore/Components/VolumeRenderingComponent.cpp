@@ -32,6 +32,7 @@
 #include <dtUtil/noisetexture.h>
 #include <dtUtil/nodemask.h>
 #include <dtUtil/cullmask.h>
+#include <dtUtil/threadpool.h>
 
 #include <dtABC/application.h>
 //#include <dtCore/deltawin.h>
@@ -57,14 +58,44 @@
 #include <osg/Billboard>
 #include <osg/Depth>
 #include <osg/Version>
+#include <osg/Timer>
+#include <algorithm>
 #include <math.h>
 #include <iostream>
 #define SQRT2PI 2.506628274631000502415765284811045253006
 #define ONEOVERSQRT2PI (1.0 / SQRT2PI)
 
 
+// A small seeded random generator (xorshift), so each volume gets its own reproducible
+// sequence no matter which thread generates it or what else is using rand().
+class VolumeRandom
+{
+public:
+   VolumeRandom(unsigned seed)
+      : mState(seed != 0 ? seed : 0x9E3779B9U)
+   {
+   }
+
+   unsigned Next()
+   {
+      mState ^= mState << 13;
+      mState ^= mState >> 17;
+      mState ^= mState << 5;
+      return mState;
+   }
+
+   // Returns a number in [0, 1), like dtUtil::RandPercent.
+   float Percent()
+   {
+      return float(Next() >> 8) * (1.0f / 16777216.0f);
+   }
+
+private:
+   unsigned mState;
+};
+
 // Return a random number with a normal distribution.
-static inline float NRand(float sigma = 1.0f)
+static inline float NRand(VolumeRandom& random, float sigma = 1.0f)
 {
 #define ONE_OVER_SIGMA_EXP (1.0f / 0.7975f)
 
@@ -73,11 +104,12 @@ static inline float NRand(float sigma = 1.0f)
    float y;
    do
    {
-      y = -logf(dtUtil::RandPercent());
+      // 1 - Percent is never 0, so the log is finite.
+      y = -logf(1.0f - random.Percent());
    }
-   while(dtUtil::RandPercent() > expf(-((y - 1.0f)*(y - 1.0f))*0.5f));
+   while(random.Percent() > expf(-((y - 1.0f)*(y - 1.0f))*0.5f));
 
-   if(rand() & 0x1)
+   if(random.Next() & 0x100)
       return y * sigma * ONE_OVER_SIGMA_EXP;
    else
       return -y * sigma * ONE_OVER_SIGMA_EXP;
@@ -236,6 +268,53 @@ namespace SimCore
       }
    };
 
+   struct compareVolumeDistance
+   {
+      template<class T>
+      bool operator()(const T& one, const T& two) const
+      {
+         return one->mCameraDistanceSqr < two->mCameraDistanceSqr;
+      }
+   };
+
+   /////////////////////////////////////////////////////////////
+   //VolumePointTask
+   /////////////////////////////////////////////////////////////
+   //generates the particle positions of a volume on a thread pool thread, it copies what
+   //it needs from the record so the record can change or go away while it runs
+   class VolumePointTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      VolumePointTask(const VolumeRenderingComponent::ShapeVolumeRecord& svr)
+         : mShapeType(svr.mShapeType)
+         , mNumPoints(svr.mNumParticles)
+         , mCenter(svr.mPosition)
+         , mRadius(svr.mRadius)
+         , mSeed(svr.GetRandomSeed())
+         , mMillis(0.0)
+      {
+      }
+
+      virtual void operator()()
+      {
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+         VolumeRenderingComponent::ParticleVolumeDrawable::CreateRandomPointsInVolume(mShapeType, mNumPoints, mCenter, mRadius, mSeed, mPoints);
+         mMillis = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+      }
+
+      const VolumeRenderingComponent::ParticleVolumeDrawable::PointList& GetPoints() const { return mPoints; }
+      double GetMillis() const { return mMillis; }
+
+   private:
+      VolumeRenderingComponent::Shape mShapeType;
+      unsigned mNumPoints;
+      osg::Vec3 mCenter;
+      osg::Vec3 mRadius;
+      unsigned mSeed;
+      VolumeRenderingComponent::ParticleVolumeDrawable::PointList mPoints;
+      double mMillis;
+   };
+
    /////////////////////////////////////////////////////////////
    //ShapeVolumeRecord
    /////////////////////////////////////////////////////////////
@@ -268,6 +347,8 @@ namespace SimCore
       , mTarget(NULL)
       , mShape(NULL)
       , mParticleDrawable(NULL)
+      , mRandomSeed(0)
+      , mCameraDistanceSqr(0.0f)
       , mId(mCounter)
    {
       ++mCounter;
@@ -281,12 +362,36 @@ namespace SimCore
       return mId;
    }
 
+   /////////////////////////////////////////////////////////////
+   unsigned VolumeRenderingComponent::ShapeVolumeRecord::GetRandomSeed() const
+   {
+      if(mRandomSeed != 0)
+      {
+         return mRandomSeed;
+      }
+      //spread the ids out so neighboring volumes don't start from similar states
+      return (unsigned(mId) + 1U) * 2654435761U;
+   }
+
+   /////////////////////////////////////////////////////////////
+   VolumeRenderingComponent::TimingStats::TimingStats()
+      : mNumVolumesCreated(0)
+      , mCreateMillis(0.0)
+      , mPointGenerationMillis(0.0)
+      , mNumUpdates(0)
+      , mUpdateMillis(0.0)
+      , mLastUpdateMillis(0.0)
+   {
+   }
+
    /////////////////////////////////////////////////////////////
    VolumeRenderingComponent::VolumeRenderingComponent(dtCore::SystemComponentType& type)
    : BaseClass(type)
    , mInitialized(false)
    , mRootNode(new osg::Group())
    , mVolumes()
+   , mNumSortedVolumes(0)
+   , mGeneratePointsInBackground(true)
    {
 
    }
@@ -300,7 +405,15 @@ namespace SimCore
    /////////////////////////////////////////////////////////////
    void VolumeRenderingComponent::CleanUp()
    {
+      //the tasks don't touch the records, but make sure they are out of the thread pool
+      for(unsigned i = 0; i < mPendingVolumes.size(); ++i)
+      {
+         mPendingVolumes[i].mTask->WaitUntilComplete();
+      }
+      mPendingVolumes.clear();
+
       mVolumes.clear();
+      mNumSortedVolumes = 0;
       
       unsigned numChildren = mRootNode->getNumChildren();
       if(numChildren > 0)
@@ -347,6 +460,7 @@ namespace SimCore
       if(svr != NULL)
       {
          RemoveDrawable(*svr);
+         //a pending task doesn't hold the record, so it can just finish and be dropped
          mVolumes.erase(std::remove_if(mVolumes.begin(), mVolumes.end(), findVolumeById(svr->GetId())), mVolumes.end());
       }
    }
@@ -362,8 +476,14 @@ namespace SimCore
             Init();
          }
 
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+         //new volumes go on the end and are merged into the sorted order on the next update
          mVolumes.push_back(svr);
          CreateDrawable(*svr);
+
+         ++mTimingStats.mNumVolumesCreated;
+         mTimingStats.mCreateMillis += osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
          return svr->GetId();
       }
       else
@@ -422,9 +542,113 @@ namespace SimCore
    ////////////////////////////////////////////////////////////////////////// 
    void VolumeRenderingComponent::UpdateVolumes(float dt)
    {
+      osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+      CollectFinishedVolumes(false);
       TimeoutAndDeleteVolumes(dt);
       TransformAndSortVolumes();
       UpdateUniforms();
+
+      mTimingStats.mLastUpdateMillis = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+      mTimingStats.mUpdateMillis += mTimingStats.mLastUpdateMillis;
+      ++mTimingStats.mNumUpdates;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   void VolumeRenderingComponent::CollectFinishedVolumes(bool wait)
+   {
+      unsigned i = 0;
+      while(i < mPendingVolumes.size())
+      {
+         PendingVolume& pending = mPendingVolumes[i];
+         if(!wait && !pending.mTask->IsComplete())
+         {
+            ++i;
+            continue;
+         }
+
+         // It is "complete" so wait to make sure the task clears the thread pool.
+         pending.mTask->WaitUntilComplete();
+         mTimingStats.mPointGenerationMillis += pending.mTask->GetMillis();
+
+         //the volume may have been removed while its points were being made
+         ShapeVolumeRecord* svr = pending.mVolume.get();
+         if(svr != NULL && svr->mParticleDrawable.valid() && !svr->mDeleteMe)
+         {
+            FinishParticleVolume(*svr, pending.mTask->GetPoints());
+         }
+
+         pending = mPendingVolumes.back();
+         mPendingVolumes.pop_back();
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   void VolumeRenderingComponent::FinishParticleVolume(ShapeVolumeRecord& svr, const ParticleVolumeDrawable::PointList& points)
+   {
+      svr.mParticleDrawable->SetPoints(points);
+      AssignParticleVolumeUniforms(svr);
+      svr.mParticleDrawable->dirtyBound();
+      if(svr.mParentNode.valid())
+      {
+         svr.mParentNode->setNodeMask(~0U);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   void VolumeRenderingComponent::WaitForPendingVolumes()
+   {
+      CollectFinishedVolumes(true);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   unsigned VolumeRenderingComponent::GetNumPendingVolumes() const
+   {
+      return unsigned(mPendingVolumes.size());
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   bool VolumeRenderingComponent::IsVolumePending(ShapeRecordId id) const
+   {
+      for(unsigned i = 0; i < mPendingVolumes.size(); ++i)
+      {
+         const ShapeVolumeRecord* svr = mPendingVolumes[i].mVolume.get();
+         if(svr != NULL && svr->GetId() == id)
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   void VolumeRenderingComponent::SetGeneratePointsInBackground(bool background)
+   {
+      mGeneratePointsInBackground = background;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   bool VolumeRenderingComponent::GetGeneratePointsInBackground() const
+   {
+      return mGeneratePointsInBackground;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   const VolumeRenderingComponent::ShapeVolumeArray& VolumeRenderingComponent::GetVolumes() const
+   {
+      return mVolumes;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   const VolumeRenderingComponent::TimingStats& VolumeRenderingComponent::GetTimingStats() const
+   {
+      return mTimingStats;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   void VolumeRenderingComponent::ResetTimingStats()
+   {
+      mTimingStats = TimingStats();
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -504,6 +728,15 @@ namespace SimCore
       ShapeVolumeArray::iterator iter = mVolumes.begin();
       ShapeVolumeArray::iterator endIter = mVolumes.end();
 
+      osg::Vec3 cameraPos;
+      dtCore::Camera* camera = GetGameManager() != NULL ? GetGameManager()->GetApplication().GetCamera() : NULL;
+      if(camera != NULL)
+      {
+         dtCore::Transform trans;
+         camera->GetTransform(trans);
+         trans.GetTranslation(cameraPos);
+      }
+
       for(;iter != endIter; ++iter)
       {
          ShapeVolumeRecord* svr = (*iter).get();
@@ -512,15 +745,45 @@ namespace SimCore
             //update the Volume's position
             SetPosition(svr);
          }
+
+         osg::Vec3 center = svr->mParentNode.valid() ? svr->mPosition * svr->mParentNode->getMatrix() : svr->mPosition;
+         svr->mCameraDistanceSqr = (center - cameraPos).length2();
+      }
+
+      SortVolumes();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////////////////
+   void VolumeRenderingComponent::SortVolumes()
+   {
+      //the volumes sorted last time have only moved a little relative to the camera, so an insertion sort
+      //of them is close to linear
+      unsigned numSorted = std::min(mNumSortedVolumes, unsigned(mVolumes.size()));
+      for(unsigned i = 1; i < numSorted; ++i)
+      {
+         if(!compareVolumeDistance()(mVolumes[i], mVolumes[i - 1]))
+         {
+            continue;
+         }
+
+         dtCore::RefPtr<ShapeVolumeRecord> svr = mVolumes[i];
+         unsigned j = i;
+         for(; j > 0 && compareVolumeDistance()(svr, mVolumes[j - 1]); --j)
+         {
+            mVolumes[j] = mVolumes[j - 1];
+         }
+         mVolumes[j] = svr;
       }
 
-      ////update uniforms by finding the closest Volumes to the camera
-      //dtCore::Transform trans;
-      //GetGameManager()->GetApplication().GetCamera()->GetTransform(trans);
-      //osg::Vec3 pos;
-      //trans.GetTranslation(pos);
-      ////sort the Volumes, though a heap may be more efficient here, we will sort so that we can combine Volumes later
-      //std::sort(mVolumes.begin(), mVolumes.end(), funcCompareVolumes(pos));
+      //the volumes created since then are sorted on their own and merged in
+      if(numSorted < mVolumes.size())
+      {
+         ShapeVolumeArray::iterator middle = mVolumes.begin() + numSorted;
+         std::sort(middle, mVolumes.end(), compareVolumeDistance());
+         std::inplace_merge(mVolumes.begin(), middle, mVolumes.end(), compareVolumeDistance());
+      }
+
+      mNumSortedVolumes = unsigned(mVolumes.size());
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -788,11 +1051,29 @@ namespace SimCore
       CreateShape(newShape);
 
       newShape.mParticleDrawable = new ParticleVolumeDrawable();
-      newShape.mParticleDrawable->Init(newShape.mNumParticles, &newShape);
       g->addDrawable(newShape.mParticleDrawable.get());
 
       AssignParticleVolumeShader(newShape, *g);
-      AssignParticleVolumeUniforms(newShape);
+
+      if(mGeneratePointsInBackground)
+      {
+         //the volume stays hidden until its points are ready
+         newShape.mParticleDrawable->InitBillboards(newShape.mNumParticles, &newShape);
+         newShape.mParentNode->setNodeMask(0U);
+
+         PendingVolume pending;
+         pending.mVolume = &newShape;
+         pending.mTask = new VolumePointTask(newShape);
+         mPendingVolumes.push_back(pending);
+         dtUtil::ThreadPool::AddTask(*pending.mTask, dtUtil::ThreadPool::BACKGROUND);
+      }
+      else
+      {
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+         newShape.mParticleDrawable->Init(newShape.mNumParticles, &newShape);
+         mTimingStats.mPointGenerationMillis += osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+         AssignParticleVolumeUniforms(newShape);
+      }
 
       mRootNode->addChild(newShape.mParentNode.get());
    
@@ -966,13 +1247,28 @@ namespace SimCore
 
    ////////////////////////////////////////////////////////////////////////// 
    void VolumeRenderingComponent::ParticleVolumeDrawable::Init(unsigned numPoints, ShapeVolumeRecord* svr)
+   {
+      InitBillboards(numPoints, svr);
+
+      CreateRandomPointsInVolume(svr->mShapeType, mNumParticles, svr->mPosition, svr->mRadius, svr->GetRandomSeed(), mPoints);
+   }
+
+   ////////////////////////////////////////////////////////////////////////// 
+   void VolumeRenderingComponent::ParticleVolumeDrawable::InitBillboards(unsigned numPoints, ShapeVolumeRecord* svr)
    {
       mParticleRadius = svr->mParticleRadius;
       mNumParticles = numPoints;
+      //until the points are set they are all at the center
+      mPoints.assign(numPoints, osg::Vec4(svr->mPosition, 0.0f));
 
       CreateBillboards(mNumParticles, 1.0f, 1.0f);
+   }
 
-      CreateRandomPointsInVolume(svr->mShapeType, mNumParticles, svr->mPosition, svr->mRadius, mPoints);
+   ////////////////////////////////////////////////////////////////////////// 
+   void VolumeRenderingComponent::ParticleVolumeDrawable::SetPoints(const PointList& points)
+   {
+      mPoints = points;
+      mPoints.resize(mNumParticles);
    }
 
    ////////////////////////////////////////////////////////////////////////// 
@@ -1004,8 +1300,11 @@ namespace SimCore
    }
 
    ////////////////////////////////////////////////////////////////////////// 
-   void VolumeRenderingComponent::ParticleVolumeDrawable::CreateRandomPointsInVolume(VolumeRenderingComponent::Shape s, float numPoints, const osg::Vec3& center, const osg::Vec3& radius, PointList& pointArrayToFill)
+   void VolumeRenderingComponent::ParticleVolumeDrawable::CreateRandomPointsInVolume(VolumeRenderingComponent::Shape s, unsigned numPoints, const osg::Vec3& center, const osg::Vec3& radius,
+            unsigned seed, PointList& pointArrayToFill)
    {
+      VolumeRandom random(seed);
+      pointArrayToFill.clear();
       pointArrayToFill.reserve(numPoints);
  
       osg::Vec3 p1, p2;// Box vertices, Sphere center, Cylinder/Cone e`nds
@@ -1030,7 +1329,7 @@ namespace SimCore
             for(unsigned i = 0; i < numPoints; ++i)
             {
                // Place on [-1..1] sphere
-               osg::Vec3 randVec(dtUtil::RandPercent(), dtUtil::RandPercent(), dtUtil::RandPercent());
+               osg::Vec3 randVec(random.Percent(), random.Percent(), random.Percent());
                osg::Vec3 vHalf(0.5f, 0.5f, 0.5f);
                osg::Vec3 pos = randVec - vHalf;
                pos.normalize();
@@ -1044,12 +1343,12 @@ namespace SimCore
                }
                else
                {
-                  //pos = p1 + pos * (radius2 + dtUtil::RandPercent() * (radius1 - radius2));
-                  pos = p1 + pos * (radius2 + dtUtil::RandPercent() * (radius1 - radius2));
+                  //pos = p1 + pos * (radius2 + random.Percent() * (radius1 - radius2));
+                  pos = p1 + pos * (radius2 + random.Percent() * (radius1 - radius2));
                }
 
-               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand());
-               mPoints.push_back(pos4);
+               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand(random));
+               pointArrayToFill.push_back(pos4);
             }
          }
          break;
@@ -1060,11 +1359,11 @@ namespace SimCore
 
             for(unsigned i = 0; i < numPoints; ++i)
             {
-               osg::Vec3 pos(2.0f * radius[0] * (0.5f - dtUtil::RandPercent()), 2.0f * radius[1] * (0.5f - dtUtil::RandPercent()), 2.0f * radius[2] * (0.5f - dtUtil::RandPercent()));
+               osg::Vec3 pos(2.0f * radius[0] * (0.5f - random.Percent()), 2.0f * radius[1] * (0.5f - random.Percent()), 2.0f * radius[2] * (0.5f - random.Percent()));
 
                pos += p1;
-               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand());
-               mPoints.push_back(pos4);
+               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand(random));
+               pointArrayToFill.push_back(pos4);
             }
          }
          break;
@@ -1082,12 +1381,12 @@ namespace SimCore
             {
                osg::Vec3 pos;
 
-               pos[0] = p1[0] + (p2[0]-p1[0]) * dtUtil::RandPercent();
-               pos[1] = p1[1] + (p2[1]-p1[1]) * dtUtil::RandPercent();
-               pos[2] = p1[2] + (p2[2]-p1[2]) * dtUtil::RandPercent();
+               pos[0] = p1[0] + (p2[0]-p1[0]) * random.Percent();
+               pos[1] = p1[1] + (p2[1]-p1[1]) * random.Percent();
+               pos[2] = p1[2] + (p2[2]-p1[2]) * random.Percent();
 
-               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand());
-               mPoints.push_back(pos4);
+               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand(random));
+               pointArrayToFill.push_back(pos4);
             }
          }
          break;
@@ -1148,10 +1447,10 @@ namespace SimCore
                osg::Vec3 pos;
 
                // For a cone, p2 is the apex of the cone.
-               float dist = dtUtil::RandPercent(); // Distance between base and tip
-               float theta = dtUtil::RandPercent() * 2.0f * float(osg::PI); // Angle around axis
+               float dist = random.Percent(); // Distance between base and tip
+               float theta = random.Percent() * 2.0f * float(osg::PI); // Angle around axis
                // Distance from axis
-               float r = radius2 + dtUtil::RandPercent() * (radius1 - radius2);
+               float r = radius2 + random.Percent() * (radius1 - radius2);
 
                float x = r * cosf(theta); // Weighting of each frame vector
                float y = r * sinf(theta);
@@ -1168,8 +1467,8 @@ namespace SimCore
                pos += u * x;
                pos += v * y;
 
-               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand());
-               mPoints.push_back(pos4);
+               osg::Vec4 pos4(pos[0], pos[1], pos[2], NRand(random));
+               pointArrayToFill.push_back(pos4);
             }            
            }
          break;
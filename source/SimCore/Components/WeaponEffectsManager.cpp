@@ -42,6 +42,9 @@
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <SimCore/Components/ParticleManagerComponent.h>
 #include <SimCore/Components/WeaponEffectsManager.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <algorithm>
 
 
 
@@ -56,49 +59,12 @@ namespace SimCore
       //////////////////////////////////////////////////////////////////////////
       namespace WeaponEffectUtils
       {
-         class EntityNodeVisitor : public osg::NodeVisitor
+         // Returns true if the node is an ancestor of the hit geometry, which
+         // is much cheaper than searching the node's subgraph for the hit geode.
+         bool IsNodeInPath( const osg::NodePath& nodePath, const osg::Node* node )
          {
-            public:
-               EntityNodeVisitor()
-                  : mFoundNode(false)
-                  , mNode(NULL)
-               {
-                  setTraversalMode( osg::NodeVisitor::TRAVERSE_ACTIVE_CHILDREN );
-               }
-
-               void SetGeodeToFind( const osg::Geode& node )
-               {
-                  mNode = &node;
-               }
-
-               bool HasFoundNode() const
-               {
-                  return mFoundNode;
-               }
-
-               virtual void apply( osg::Geode& node )
-               {
-                  if( ! mFoundNode )
-                  {
-                     mFoundNode = &node == mNode;
-                  }
-               }
-
-               void Reset()
-               {
-                  mFoundNode = false;
-                  mNode = NULL;
-               }
-
-            protected:
-               virtual ~EntityNodeVisitor()
-               {
-               }
-
-            private:
-               bool mFoundNode;
-               const osg::Geode* mNode;
-         };
+            return std::find( nodePath.begin(), nodePath.end(), node ) != nodePath.end();
+         }
       }
 
 
@@ -979,6 +945,16 @@ namespace SimCore
 
       //////////////////////////////////////////////////////////////////////////
       // Weapon Effect Manager Code
+      //////////////////////////////////////////////////////////////////////////
+      const unsigned WeaponEffectsManager::MAX_IMPACT_QUERIES_PER_UPDATE = 32;
+
+      //////////////////////////////////////////////////////////////////////////
+      WeaponEffectsManager::ImpactQuery::ImpactQuery()
+         : mMaxTime(0.0f)
+         , mTimeToImpact(0.0f)
+      {
+      }
+
       //////////////////////////////////////////////////////////////////////////
       WeaponEffectsManager::WeaponEffectsManager()
          : mEffectTimeMax(5.0f)
@@ -1252,15 +1228,22 @@ namespace SimCore
             // Execute the effect.
             if( isTracerEffect )
             {
-
-               // Determine how far the tracer has to go before it hits an obstacle.
-               float tracerLifeTime = CalcTimeToImpact(
-                  weaponFirePoint, intialVelocity,
-                  effectsInfo.GetTracerLifeTime(), effectRequest.GetOwner() );
-
                // This also sets the initial orientation of the tracer.
                // Setup tracer to update and render.
-               effect->Execute( tracerLifeTime );
+               effect->Execute( effectsInfo.GetTracerLifeTime() );
+
+               // The tracer is shortened to how far it has to go before it hits
+               // an obstacle when all the tracers of this frame are resolved.
+               ImpactQuery query;
+               query.mFirePoint = weaponFirePoint;
+               query.mVelocity = intialVelocity;
+               query.mMaxTime = effectsInfo.GetTracerLifeTime();
+               if( effectRequest.GetOwner() != NULL )
+               {
+                  query.mOwnerNode = effectRequest.GetOwner()->GetOSGNode();
+               }
+               mPendingImpactQueries.push_back( query );
+               mPendingImpactEffects.push_back( effect );
             }
             else
             {
@@ -1404,6 +1387,8 @@ namespace SimCore
 
          UpdateMunitionEffectRequests( deltaTime );
 
+         ResolvePendingImpactQueries();
+
          unsigned limit = mMunitionEffects.size();
          for( unsigned effect = 0; effect < limit; ++effect )
          {
@@ -1541,6 +1526,9 @@ namespace SimCore
          {
             mMunitionEffects.clear();
          }
+
+         mPendingImpactEffects.clear();
+         mPendingImpactQueries.clear();
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -1555,75 +1543,121 @@ namespace SimCore
          const osg::Vec3& weaponFirePoint, const osg::Vec3& initialVelocity,
          float maxTime, SimCore::Actors::BaseEntity* owner )
       {
-         float speed = initialVelocity.length();
-         if( speed == 0.0f )
+         ImpactQueryList queries(1);
+         ImpactQuery& query = queries.front();
+         query.mFirePoint = weaponFirePoint;
+         query.mVelocity = initialVelocity;
+         query.mMaxTime = maxTime;
+         if( owner != NULL )
          {
-            return maxTime;
+            query.mOwnerNode = owner->GetOSGNode();
          }
 
-         dtCore::RefPtr<WeaponEffectUtils::EntityNodeVisitor> subNodeVisitor
-            = new WeaponEffectUtils::EntityNodeVisitor;
-         dtCore::BatchIsector::SingleISector& isector = mIsector->EnableAndGetISector(0);
-         osg::Vec3 endPoint( weaponFirePoint + (initialVelocity*maxTime) );
-         isector.SetSectorAsLineSegment( weaponFirePoint, endPoint);
+         CalcTimesToImpact( queries );
+         return query.mTimeToImpact;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEffectsManager::CalcTimesToImpact( ImpactQueryList& queries )
+      {
+         SIMCORE_PROFILE_SCOPE("WeaponEffectsManager::CalcTimesToImpact");
+         SIMCORE_PROFILE_COUNT("WeaponEffectsManager::ImpactQueries", queries.size());
 
-         if( mIsector->Update( osg::Vec3(0,0,0), true ) )
+         unsigned numQueries = queries.size();
+         for( unsigned first = 0; first < numQueries; first += MAX_IMPACT_QUERIES_PER_UPDATE )
          {
-            if( isector.GetNumberOfHits() > 0 )
+            unsigned last = std::min( numQueries, first + MAX_IMPACT_QUERIES_PER_UPDATE );
+
+            // Set up one line segment per shot so the scene is only traversed once for the whole batch.
+            bool anySegments = false;
+            for( unsigned i = first; i < last; ++i )
             {
-               // Check for self-collision?
-               if( owner != NULL )
+               ImpactQuery& query = queries[i];
+               query.mTimeToImpact = query.mMaxTime;
+               if( query.mVelocity.length2() > 0.0f )
                {
-                  const osg::Geode* geode = NULL;
+                  dtCore::BatchIsector::SingleISector& isector = mIsector->EnableAndGetISector( i - first );
+                  isector.SetSectorAsLineSegment( query.mFirePoint,
+                     query.mFirePoint + (query.mVelocity * query.mMaxTime) );
+                  anySegments = true;
+               }
+            }
+
+            if( ! anySegments )
+            {
+               continue;
+            }
+
+            if( mIsector->Update( osg::Vec3(0,0,0), true ) )
+            {
+               for( unsigned i = first; i < last; ++i )
+               {
+                  ImpactQuery& query = queries[i];
+                  float speed = query.mVelocity.length();
+                  if( speed == 0.0f )
+                  {
+                     continue;
+                  }
+
+                  dtCore::BatchIsector::SingleISector& isector = mIsector->EnableAndGetISector( i - first );
+                  const osg::Node* ownerNode = query.mOwnerNode.get();
+
                   dtCore::BatchIsector::HitList& hitList = isector.GetHitList();
                   dtCore::BatchIsector::HitList::iterator curHitIter = hitList.begin();
                   dtCore::BatchIsector::HitList::iterator endHitList = hitList.end();
-                  for (int index = 0; curHitIter != endHitList; ++curHitIter, ++index)
+                  for( int index = 0; curHitIter != endHitList; ++curHitIter, ++index )
                   {
-                     const dtCore::BatchIsector::Hit& hit = *curHitIter;
-
-                     // Get the drawable of the current hit.
-                     const osg::NodePath& nodePath = hit.getNodePath();
-                     geode = dynamic_cast<osg::Geode*>(nodePath.back());
-                     if (geode == NULL)
-                     {
-                        continue;
-                     }
-
-                     // Determine if the hit drawable object is part of the
-                     // entity that generated this tracer effect.
-                     subNodeVisitor->SetGeodeToFind( *geode );
-                     owner->GetOSGNode()->traverse( *subNodeVisitor );
-                     bool foundNode = subNodeVisitor->HasFoundNode();
-                     subNodeVisitor->Reset();
-
-                     // If the object is part of the entity hierarchy, then
+                     // If the hit is on the entity that fired the shot, then
                      // continue searching for other hit points that are not
                      // hits on the entity itself.
-                     if( foundNode )
+                     if( ownerNode != NULL
+                        && WeaponEffectUtils::IsNodeInPath( curHitIter->getNodePath(), ownerNode ) )
                      {
                         continue;
                      }
 
                      // Point was found. Get it and exit the loop.
-                     isector.GetHitPoint( endPoint, index );
+                     osg::Vec3 hitPoint;
+                     isector.GetHitPoint( hitPoint, index );
+                     query.mTimeToImpact = (hitPoint - query.mFirePoint).length() / speed;
                      break;
                   }
                }
-               else
-               {
-                  // Get the first point, not checking for self-collision.
-                  isector.GetHitPoint( endPoint );
-               }
             }
 
-            maxTime = (endPoint-weaponFirePoint).length()/speed;
-
             // Clear for next use
             mIsector->Reset();
          }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WeaponEffectsManager::GetNumPendingImpactQueries() const
+      {
+         return mPendingImpactQueries.size();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEffectsManager::ResolvePendingImpactQueries()
+      {
+         if( mPendingImpactQueries.empty() )
+         {
+            return;
+         }
+
+         CalcTimesToImpact( mPendingImpactQueries );
+
+         unsigned limit = mPendingImpactEffects.size();
+         for( unsigned i = 0; i < limit; ++i )
+         {
+            MunitionEffect* effect = mPendingImpactEffects[i].get();
+            if( effect != NULL && effect->IsActive() )
+            {
+               effect->SetMaxLifeTime( mPendingImpactQueries[i].mTimeToImpact );
+            }
+         }
 
-         return maxTime;
+         mPendingImpactEffects.clear();
+         mPendingImpactQueries.clear();
       }
 
    }
@@ -0,0 +1,154 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2007-2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <prefix/SimCorePrefix.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+
+#include <SimCore/Components/WeaponEventAggregatorComponent.h>
+#include <SimCore/MessageType.h>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      //////////////////////////////////////////////////////////////////////////
+      WeaponEventAggregatorComponent::WeaponEventAggregatorComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mSendToNetwork(true)
+         , mMaxEventsPerBatch(DEFAULT_MAX_EVENTS_PER_BATCH)
+         , mNumEventsSent(0)
+         , mNumBatchesSent(0)
+         , mNumMessagesSaved(0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      WeaponEventAggregatorComponent::~WeaponEventAggregatorComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(WeaponEventAggregatorComponent, bool, SendToNetwork);
+      DT_IMPLEMENT_ACCESSOR(WeaponEventAggregatorComponent, unsigned, MaxEventsPerBatch);
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEventAggregatorComponent::QueueEvent( const WeaponEvent& weaponEvent )
+      {
+         mQueuedEvents.push_back( weaponEvent );
+
+         unsigned maxEvents = mMaxEventsPerBatch;
+         if( maxEvents > WeaponEventBatchMessage::MAX_EVENTS ) { maxEvents = WeaponEventBatchMessage::MAX_EVENTS; }
+         if( mQueuedEvents.size() >= maxEvents )
+         {
+            Flush();
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WeaponEventAggregatorComponent::GetNumQueuedEvents() const
+      {
+         return unsigned(mQueuedEvents.size());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEventAggregatorComponent::Flush()
+      {
+         if( mQueuedEvents.empty() || GetGameManager() == NULL )
+         {
+            return;
+         }
+
+         dtGame::GameManager& gm = *GetGameManager();
+
+         dtCore::RefPtr<WeaponEventBatchMessage> msg;
+         gm.GetMessageFactory().CreateMessage( SimCore::MessageType::WEAPON_EVENT_BATCH, msg );
+         msg->SetEvents( mQueuedEvents );
+
+         gm.SendMessage( *msg );
+         unsigned sendsPerEvent = 1;
+         if( mSendToNetwork )
+         {
+            gm.SendNetworkMessage( *msg );
+            ++sendsPerEvent;
+         }
+
+         unsigned numEvents = unsigned(mQueuedEvents.size());
+         mNumEventsSent += numEvents;
+         ++mNumBatchesSent;
+         mNumMessagesSaved += (numEvents - 1) * sendsPerEvent;
+
+         mQueuedEvents.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEventAggregatorComponent::ClearQueue()
+      {
+         mQueuedEvents.clear();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WeaponEventAggregatorComponent::GetNumEventsSent() const
+      {
+         return mNumEventsSent;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WeaponEventAggregatorComponent::GetNumBatchesSent() const
+      {
+         return mNumBatchesSent;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WeaponEventAggregatorComponent::GetNumMessagesSaved() const
+      {
+         return mNumMessagesSaved;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEventAggregatorComponent::ResetStatistics()
+      {
+         mNumEventsSent = 0;
+         mNumBatchesSent = 0;
+         mNumMessagesSaved = 0;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponEventAggregatorComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         const dtGame::MessageType& type = message.GetMessageType();
+
+         // Everything fired this frame has been queued by now.
+         if( type == dtGame::MessageType::TICK_END_OF_FRAME )
+         {
+            Flush();
+         }
+         else if( type == dtGame::MessageType::INFO_RESTARTED
+            || type == dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN )
+         {
+            ClearQueue();
+         }
+      }
+
+   }
+}
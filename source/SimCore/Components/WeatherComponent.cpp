@@ -24,6 +24,7 @@
 
 #include <SimCore/Components/WeatherComponent.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
 
 #include <dtABC/application.h>
 #include <dtABC/weather.h>
@@ -82,15 +83,21 @@ namespace SimCore
          , mMaxVisibility(40000.0)
          , mMaxElevationVis(15000.0)
          , mUpdatesEnabled(true)
+         , mWeatherRequested(false)
+         , mDayTimeRequested(false)
          , mCurrentPrecipType(&SimCore::Actors::PrecipitationType::NONE)
       {
          mPrecipRate = 0;
          mPrecipEffect = NULL;
+         mUpdateJob = new FrameBudgetJob("Weather Update", "WeatherComponent",
+            dtUtil::MakeFunctor(&WeatherComponent::RunRequestedUpdates, this));
       }
 
       //////////////////////////////////////////////////////////
       WeatherComponent::~WeatherComponent()
       {
+         mUpdateJob->RemoveFromFrameBudget();
+
          mThunderSounds.clear();
          mRainSounds.clear();
 
@@ -142,6 +149,41 @@ namespace SimCore
 
       }
 
+      //////////////////////////////////////////////////////////
+      void WeatherComponent::OnRemovedFromGM()
+      {
+         mUpdateJob->RemoveFromFrameBudget();
+         mWeatherRequested = false;
+         mDayTimeRequested = false;
+      }
+
+      //////////////////////////////////////////////////////////
+      void WeatherComponent::RequestUpdate(bool weather, bool dayTime)
+      {
+         mWeatherRequested = mWeatherRequested || weather;
+         mDayTimeRequested = mDayTimeRequested || dayTime;
+         if (!FrameBudgetComponent::RequestJob(*GetGameManager(), *mUpdateJob))
+         {
+            RunRequestedUpdates();
+         }
+      }
+
+      //////////////////////////////////////////////////////////
+      void WeatherComponent::RunRequestedUpdates()
+      {
+         if (mWeatherRequested)
+         {
+            mWeatherRequested = false;
+            UpdateWeather();
+         }
+
+         if (mDayTimeRequested)
+         {
+            mDayTimeRequested = false;
+            UpdateDayTime();
+         }
+      }
+
       //////////////////////////////////////////////////////////
       void WeatherComponent::SetEphemerisEnvironment(  SimCore::Actors::IGEnvironmentActor* env  )
       {
@@ -700,7 +742,7 @@ namespace SimCore
                mAtmosphere = uaa;
             }
 
-            UpdateWeather();
+            RequestUpdate(true, false);
          }
          else if (type == *SimCore::Actors::EntityActorRegistry::DAYTIME_ACTOR_TYPE)
          {
@@ -717,7 +759,7 @@ namespace SimCore
                mDayTime = proxy;
             }
 
-            UpdateDayTime();
+            RequestUpdate(false, true);
          }
       }
 
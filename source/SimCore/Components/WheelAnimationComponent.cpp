@@ -0,0 +1,297 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/Components/WheelAnimationComponent.h>
+#include <SimCore/ActComps/WheelActComp.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <dtABC/application.h>
+#include <dtCore/camera.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
+#include <dtGame/basemessages.h>
+#include <dtGame/deadreckoninghelper.h>
+#include <dtGame/gameactor.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+
+namespace SimCore
+{
+   namespace Components
+   {
+      const float WheelAnimationComponent::DEFAULT_LOD_DISTANCE = 300.0f;
+      const float WheelAnimationComponent::DEFAULT_LOD_UPDATE_INTERVAL = 0.25f;
+      const float WheelAnimationComponent::DEFAULT_MAX_DISTANCE = 2000.0f;
+
+      // The far vehicles are spread over this many slots of the LOD interval so they don't all update on the same tick.
+      static const unsigned NUM_LOD_SLOTS = 8;
+
+      //////////////////////////////////////////////////////////////////////////
+      WheelAnimationComponent::VehicleEntry::VehicleEntry()
+         : mFirstAxle(0)
+         , mNumAxles(0)
+         , mPendingTime(0.0f)
+         , mBeyondMaxDistance(false)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      WheelAnimationComponent::WheelAnimationComponent( dtCore::SystemComponentType& type )
+         : BaseClass(type)
+         , mLodDistance(DEFAULT_LOD_DISTANCE)
+         , mLodUpdateInterval(DEFAULT_LOD_UPDATE_INTERVAL)
+         , mMaxDistance(DEFAULT_MAX_DISTANCE)
+         , mAxlesDirty(false)
+         , mNumUpdatedVehicles(0)
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      WheelAnimationComponent::~WheelAnimationComponent()
+      {
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      DT_IMPLEMENT_ACCESSOR(WheelAnimationComponent, float, LodDistance);
+      DT_IMPLEMENT_ACCESSOR(WheelAnimationComponent, float, LodUpdateInterval);
+      DT_IMPLEMENT_ACCESSOR(WheelAnimationComponent, float, MaxDistance);
+
+      //////////////////////////////////////////////////////////////////////////
+      void WheelAnimationComponent::RegisterWheels(SimCore::ActComps::WheelActComp& wheels)
+      {
+         if (IsRegistered(wheels))
+         {
+            return;
+         }
+
+         VehicleEntry entry;
+         entry.mWheels = &wheels;
+
+         dtGame::GameActorProxy* actor = NULL;
+         wheels.GetOwner(actor);
+         if (actor != NULL)
+         {
+            dtCore::Transformable* xformable = NULL;
+            actor->GetDrawable(xformable);
+            entry.mTransformable = xformable;
+
+            dtGame::DeadReckoningActorComponent* drHelper = NULL;
+            actor->GetComponent(drHelper);
+            entry.mDeadReckoning = drHelper;
+         }
+
+         entry.mPendingTime = float(mVehicles.size() % NUM_LOD_SLOTS) * mLodUpdateInterval / float(NUM_LOD_SLOTS);
+
+         mVehicles.push_back(entry);
+         mAxlesDirty = true;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WheelAnimationComponent::UnregisterWheels(SimCore::ActComps::WheelActComp& wheels)
+      {
+         for (unsigned i = 0; i < mVehicles.size(); ++i)
+         {
+            if (mVehicles[i].mWheels.get() == &wheels)
+            {
+               mVehicles[i] = mVehicles.back();
+               mVehicles.pop_back();
+               mAxlesDirty = true;
+               return;
+            }
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      bool WheelAnimationComponent::IsRegistered(const SimCore::ActComps::WheelActComp& wheels) const
+      {
+         for (unsigned i = 0; i < mVehicles.size(); ++i)
+         {
+            if (mVehicles[i].mWheels.get() == &wheels)
+            {
+               return true;
+            }
+         }
+         return false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WheelAnimationComponent::GetNumVehicles() const
+      {
+         return mVehicles.size();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WheelAnimationComponent::GetNumAxles() const
+      {
+         return mAxles.size();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      unsigned WheelAnimationComponent::GetNumUpdatedVehicles() const
+      {
+         return mNumUpdatedVehicles;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WheelAnimationComponent::RefreshAxles()
+      {
+         for (unsigned i = 0; i < mVehicles.size(); )
+         {
+            VehicleEntry& entry = mVehicles[i];
+            if ( ! entry.mWheels.valid() || ! entry.mTransformable.valid())
+            {
+               entry = mVehicles.back();
+               mVehicles.pop_back();
+               mAxlesDirty = true;
+               continue;
+            }
+
+            if (entry.mNumAxles != entry.mWheels->GetNumAxles())
+            {
+               mAxlesDirty = true;
+            }
+            ++i;
+         }
+
+         if ( ! mAxlesDirty)
+         {
+            return;
+         }
+
+         mAxles.clear();
+         for (unsigned i = 0; i < mVehicles.size(); ++i)
+         {
+            VehicleEntry& entry = mVehicles[i];
+            SimCore::ActComps::WheelActComp& wheels = *entry.mWheels;
+            entry.mFirstAxle = mAxles.size();
+            entry.mNumAxles = wheels.GetNumAxles();
+            for (unsigned j = 0; j < entry.mNumAxles; ++j)
+            {
+               mAxles.push_back(wheels.GetAxle(j));
+            }
+         }
+         mAxlesDirty = false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WheelAnimationComponent::UpdateWheels(float dt, const osg::Vec3& viewPosition)
+      {
+         SIMCORE_PROFILE_SCOPE("WheelAnimationComponent::UpdateWheels");
+
+         RefreshAxles();
+
+         mNumUpdatedVehicles = 0;
+         float lodDistance2 = mLodDistance * mLodDistance;
+         float maxDistance2 = mMaxDistance * mMaxDistance;
+
+         dtCore::Transform xform;
+         osg::Vec3 pos, fwd, velocity;
+         for (unsigned i = 0; i < mVehicles.size(); ++i)
+         {
+            VehicleEntry& entry = mVehicles[i];
+            entry.mPendingTime += dt;
+
+            entry.mTransformable->GetTransform(xform);
+            xform.GetTranslation(pos);
+            float distance2 = (pos - viewPosition).length2();
+
+            if (mMaxDistance > 0.0f && distance2 > maxDistance2)
+            {
+               // Too far to see the wheels, so they just stop.
+               entry.mPendingTime = 0.0f;
+               entry.mBeyondMaxDistance = true;
+               continue;
+            }
+
+            if (entry.mPendingTime <= 0.0f
+                     || (distance2 > lodDistance2 && entry.mPendingTime < mLodUpdateInterval))
+            {
+               continue;
+            }
+
+            float heading = 0.0f;
+            velocity.set(0.0f, 0.0f, 0.0f);
+            if (entry.mDeadReckoning.valid())
+            {
+               velocity = entry.mDeadReckoning->GetCurrentInstantVelocity();
+               heading = entry.mDeadReckoning->GetCurrentDeadReckonedRotation()[0];
+            }
+            xform.GetRow(1, fwd);
+
+            if (entry.mBeyondMaxDistance)
+            {
+               // The heading is stale, so steering from it would turn the wheels by the whole change.
+               entry.mWheels->ResetLastFrameHeading(heading);
+               entry.mBeyondMaxDistance = false;
+            }
+
+            float speedMps = 0.0f;
+            float steerAngle = 0.0f;
+            entry.mWheels->CalcWheelMotion(entry.mPendingTime, velocity, heading, fwd, speedMps, steerAngle);
+
+            unsigned endAxle = entry.mFirstAxle + entry.mNumAxles;
+            for (unsigned j = entry.mFirstAxle; j < endAxle; ++j)
+            {
+               mAxles[j]->UpdateAxleRotation(entry.mPendingTime, steerAngle, speedMps);
+            }
+
+            entry.mPendingTime = 0.0f;
+            ++mNumUpdatedVehicles;
+         }
+
+         SIMCORE_PROFILE_COUNT("WheelAnimationComponent::UpdatedVehicles", mNumUpdatedVehicles);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WheelAnimationComponent::OnRemovedFromGM()
+      {
+         mVehicles.clear();
+         mAxles.clear();
+         mAxlesDirty = false;
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WheelAnimationComponent::ProcessMessage( const dtGame::Message& message )
+      {
+         if (message.GetMessageType() == dtGame::MessageType::TICK_REMOTE)
+         {
+            if (mVehicles.empty())
+            {
+               return;
+            }
+
+            osg::Vec3 viewPosition;
+            dtCore::Camera* camera = GetGameManager()->GetApplication().GetCamera();
+            if (camera != NULL)
+            {
+               dtCore::Transform xform;
+               camera->GetTransform(xform);
+               xform.GetTranslation(viewPosition);
+            }
+
+            const dtGame::TickMessage& tick = static_cast<const dtGame::TickMessage&>(message);
+            UpdateWheels(tick.GetDeltaSimTime(), viewPosition);
+         }
+      }
+   }
+}
@@ -22,6 +22,7 @@
 */
 #include <prefix/SimCorePrefix.h>
 #include <SimCore/CustomCullVisitor.h>
+#include <SimCore/FIDCodeIndex.h>
 #include <osg/Billboard>
 #include <osg/ProxyNode>
 #include <iostream>
@@ -30,7 +31,6 @@ namespace SimCore
 {
 
    dtCore::ObserverPtr<osg::Transform> CustomCullVisitor::mTerrainNode;
-   std::vector<int> CustomCullVisitor::mFIDCodes;
 
    ///////////////////////////////////////////////////////////////////////////
    CustomCullVisitor::CustomCullVisitor() : CullVisitor()
@@ -67,31 +67,11 @@ namespace SimCore
    ///////////////////////////////////////////////////////////////////////////
    void CustomCullVisitor::apply(osg::Geode& node)
    {
-
-      for(unsigned int i=0;i<node.getNumDrawables();i++)
+      // The terrain geodes are tagged with their FID codes when the terrain is loaded,
+      // so this is just a check of the flag on the tag.
+      if (FIDCodeIndex::GetInstance().ShouldDraw(node))
       {
-         osg::Drawable* d = node.getDrawable(i);
-         osg::StateSet* tempStateSet = d->getStateSet();
-         
-         if(tempStateSet != NULL)
-         {
-            osg::IntArray* intArray = dynamic_cast<osg::IntArray*>(tempStateSet->getUserData());
-            
-            if(intArray != NULL)
-            {
-               std::vector<int>::iterator iter = std::find(mFIDCodes.begin(), mFIDCodes.end(), intArray->at(0));
-
-               if(iter == mFIDCodes.end())
-               {
-                  osgUtil::CullVisitor::apply(node);
-               }
-            }
-            else
-            {
-               osgUtil::CullVisitor::apply(node);
-            }
-
-         }
+         osgUtil::CullVisitor::apply(node);
       }
    }
 
@@ -110,13 +90,13 @@ namespace SimCore
    ///////////////////////////////////////////////////////////////////////////
    const std::vector<int>& CustomCullVisitor::GetDisabledFIDCodes()
    {
-      return mFIDCodes;
+      return FIDCodeIndex::GetInstance().GetDisabledCodes();
    }
 
    ///////////////////////////////////////////////////////////////////////////
    void CustomCullVisitor::SetDisabledFIDCodes( const std::vector<int>& fidCodeArray )
    {
-      mFIDCodes = fidCodeArray;
+      FIDCodeIndex::GetInstance().SetDisabledCodes(fidCodeArray);
    }
 }
 
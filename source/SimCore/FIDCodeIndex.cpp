@@ -0,0 +1,388 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/FIDCodeIndex.h>
+
+#include <dtCore/refptr.h>
+
+#include <osg/Array>
+#include <osg/Geode>
+#include <osg/NodeVisitor>
+#include <osg/StateSet>
+
+#include <algorithm>
+#include <climits>
+
+namespace SimCore
+{
+   const unsigned FIDCodeIndex::NO_CLASS = UINT_MAX;
+
+   //////////////////////////////////////////////////////////////////////////
+   FIDCodeIndex::GeodeInfo::GeodeInfo()
+      : mHasUncoded(false)
+      , mCulled(false)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   FIDCodeIndex::GeodeInfo::~GeodeInfo()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   class FIDCodeCompileVisitor : public osg::NodeVisitor
+   {
+   public:
+      FIDCodeCompileVisitor(FIDCodeIndex& index)
+         : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+         , mIndex(index)
+      {
+      }
+
+      virtual void apply(osg::Geode& node)
+      {
+         // Don't take over the user data if something else is using it.
+         if (node.getUserData() != NULL && FIDCodeIndex::GetGeodeInfo(node) == NULL)
+         {
+            return;
+         }
+
+         dtCore::RefPtr<FIDCodeIndex::GeodeInfo> info = new FIDCodeIndex::GeodeInfo();
+         for (unsigned i = 0; i < node.getNumDrawables(); ++i)
+         {
+            const osg::Drawable* d = node.getDrawable(i);
+            // The cull visitor has always ignored drawables with no state set.
+            if (d == NULL || d->getStateSet() == NULL)
+            {
+               continue;
+            }
+
+            int fidCode = 0;
+            if (FIDCodeIndex::ReadFIDCode(*d, fidCode))
+            {
+               unsigned classIndex = mIndex.GetOrAddClass(fidCode);
+               if (std::find(info->mClasses.begin(), info->mClasses.end(), classIndex) == info->mClasses.end())
+               {
+                  info->mClasses.push_back(classIndex);
+               }
+            }
+            else
+            {
+               info->mHasUncoded = true;
+            }
+         }
+
+         node.setUserData(info.get());
+         mInfos.push_back(info.get());
+      }
+
+      FIDCodeIndex& mIndex;
+      std::vector<FIDCodeIndex::GeodeInfo*> mInfos;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   class FIDCodeRemoveVisitor : public osg::NodeVisitor
+   {
+   public:
+      FIDCodeRemoveVisitor()
+         : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+         , mNumRemoved(0)
+      {
+      }
+
+      virtual void apply(osg::Geode& node)
+      {
+         if (FIDCodeIndex::GetGeodeInfo(node) != NULL)
+         {
+            // The user data holds the only reference, so this deletes the info.
+            node.setUserData(NULL);
+            ++mNumRemoved;
+         }
+      }
+
+      unsigned mNumRemoved;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   FIDCodeIndex& FIDCodeIndex::GetInstance()
+   {
+      static FIDCodeIndex instance;
+      return instance;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   FIDCodeIndex::FIDCodeIndex()
+      : mNumGeodesUpdated(0)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   FIDCodeIndex::~FIDCodeIndex()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool FIDCodeIndex::ReadFIDCode(const osg::Drawable& drawable, int& fidCode)
+   {
+      const osg::StateSet* ss = drawable.getStateSet();
+      if (ss == NULL)
+      {
+         return false;
+      }
+
+      const osg::IntArray* intArray = dynamic_cast<const osg::IntArray*>(ss->getUserData());
+      if (intArray == NULL || intArray->empty())
+      {
+         return false;
+      }
+
+      fidCode = intArray->front();
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::Compile(osg::Node& node)
+   {
+      FIDCodeCompileVisitor visitor(*this);
+      node.accept(visitor);
+
+      // Compiling a geode again replaces its info, so drop the old ones before adding the new.
+      PruneGeodes();
+
+      for (unsigned i = 0; i < visitor.mInfos.size(); ++i)
+      {
+         GeodeInfo* info = visitor.mInfos[i];
+         for (unsigned j = 0; j < info->mClasses.size(); ++j)
+         {
+            mClassGeodes[info->mClasses[j]].push_back(info);
+         }
+         info->mCulled = IsCulled(*info);
+      }
+      return unsigned(visitor.mInfos.size());
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::Remove(osg::Node& node)
+   {
+      FIDCodeRemoveVisitor visitor;
+      node.accept(visitor);
+      PruneGeodes();
+      return visitor.mNumRemoved;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void FIDCodeIndex::PruneGeodes()
+   {
+      for (unsigned i = 0; i < mClassGeodes.size(); ++i)
+      {
+         GeodeList& geodes = mClassGeodes[i];
+         GeodeList::iterator iter = geodes.begin();
+         while (iter != geodes.end())
+         {
+            if (!iter->valid())
+            {
+               iter = geodes.erase(iter);
+            }
+            else
+            {
+               ++iter;
+            }
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   FIDCodeIndex::GeodeInfo* FIDCodeIndex::GetGeodeInfo(const osg::Geode& geode)
+   {
+      return dynamic_cast<GeodeInfo*>(const_cast<osg::Referenced*>(geode.getUserData()));
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::FindClass(int fidCode) const
+   {
+      ClassMap::const_iterator i = mClassMap.find(fidCode);
+      if (i == mClassMap.end())
+      {
+         return NO_CLASS;
+      }
+      return i->second;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::GetOrAddClass(int fidCode)
+   {
+      std::pair<ClassMap::iterator, bool> result = mClassMap.insert(std::make_pair(fidCode, unsigned(mClassCodes.size())));
+      if (result.second)
+      {
+         mClassCodes.push_back(fidCode);
+         mDisabledClasses.push_back(std::find(mDisabledCodes.begin(), mDisabledCodes.end(), fidCode) != mDisabledCodes.end());
+         mClassGeodes.push_back(GeodeList());
+      }
+      return result.first->second;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::GetNumClasses() const
+   {
+      return unsigned(mClassCodes.size());
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   int FIDCodeIndex::GetFIDCode(unsigned classIndex) const
+   {
+      return mClassCodes[classIndex];
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void FIDCodeIndex::SetDisabledCodes(const std::vector<int>& fidCodes)
+   {
+      mDisabledCodes = fidCodes;
+
+      std::vector<bool> disabled(mDisabledClasses.size(), false);
+      for (unsigned i = 0; i < fidCodes.size(); ++i)
+      {
+         unsigned classIndex = GetOrAddClass(fidCodes[i]);
+         disabled.resize(mDisabledClasses.size(), false);
+         disabled[classIndex] = true;
+      }
+
+      std::vector<unsigned> changed;
+      for (unsigned i = 0; i < disabled.size(); ++i)
+      {
+         if (disabled[i] != mDisabledClasses[i])
+         {
+            changed.push_back(i);
+         }
+      }
+      mDisabledClasses.swap(disabled);
+
+      mNumGeodesUpdated = 0;
+      for (unsigned i = 0; i < changed.size(); ++i)
+      {
+         GeodeList& geodes = mClassGeodes[changed[i]];
+         GeodeList::iterator iter = geodes.begin();
+         while (iter != geodes.end())
+         {
+            // Drop the geodes that have been unloaded or recompiled.
+            if (!iter->valid())
+            {
+               iter = geodes.erase(iter);
+               continue;
+            }
+            (*iter)->mCulled = IsCulled(**iter);
+            ++mNumGeodesUpdated;
+            ++iter;
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const std::vector<int>& FIDCodeIndex::GetDisabledCodes() const
+   {
+      return mDisabledCodes;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool FIDCodeIndex::IsClassDisabled(unsigned classIndex) const
+   {
+      return classIndex < mDisabledClasses.size() && mDisabledClasses[classIndex];
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool FIDCodeIndex::IsCodeDisabled(int fidCode) const
+   {
+      return IsClassDisabled(FindClass(fidCode));
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool FIDCodeIndex::IsCulled(const GeodeInfo& info) const
+   {
+      if (info.mHasUncoded)
+      {
+         return false;
+      }
+
+      for (unsigned i = 0; i < info.mClasses.size(); ++i)
+      {
+         if (!IsClassDisabled(info.mClasses[i]))
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool FIDCodeIndex::ShouldDraw(const osg::Geode& geode) const
+   {
+      const GeodeInfo* info = GetGeodeInfo(geode);
+      if (info != NULL)
+      {
+         return !info->mCulled;
+      }
+
+      // Not compiled, so look at each drawable.
+      for (unsigned i = 0; i < geode.getNumDrawables(); ++i)
+      {
+         const osg::Drawable* d = geode.getDrawable(i);
+         if (d == NULL || d->getStateSet() == NULL)
+         {
+            continue;
+         }
+
+         int fidCode = 0;
+         if (!ReadFIDCode(*d, fidCode) || !IsCodeDisabled(fidCode))
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::GetNumGeodesUpdated() const
+   {
+      return mNumGeodesUpdated;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned FIDCodeIndex::GetNumIndexedGeodes() const
+   {
+      unsigned numGeodes = 0;
+      for (unsigned i = 0; i < mClassGeodes.size(); ++i)
+      {
+         numGeodes += unsigned(mClassGeodes[i].size());
+      }
+      return numGeodes;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void FIDCodeIndex::Clear()
+   {
+      mClassMap.clear();
+      mClassCodes.clear();
+      mDisabledClasses.clear();
+      mClassGeodes.clear();
+      mNumGeodesUpdated = 0;
+   }
+}
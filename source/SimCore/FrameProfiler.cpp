@@ -0,0 +1,462 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/FrameProfiler.h>
+#include <SimCore/StartupTracer.h>
+
+#include <dtUtil/log.h>
+
+#include <OpenThreads/ScopedLock>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+// Each thread finds its buffer through a thread local pointer, so recording doesn't touch the shared lock.
+#if defined(_MSC_VER)
+#define SIMCORE_THREAD_LOCAL __declspec(thread)
+#else
+#define SIMCORE_THREAD_LOCAL __thread
+#endif
+
+namespace SimCore
+{
+   const FrameProfiler::ZoneId FrameProfiler::INVALID_ZONE(~0U);
+   const std::string FrameProfiler::DEFAULT_CATEGORY("Frame");
+
+   bool FrameProfiler::mEnabled(false);
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::ZoneStats::ZoneStats()
+   : mNumCalls(0)
+   , mTotalMillis(0.0)
+   , mMaxMillis(0.0)
+   , mCount(0)
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   /**
+    * The records of one thread, waiting to be collected.  Only the owning thread adds to it, so
+    * its lock is only ever contended while Collect drains it.
+    */
+   class FrameProfiler::ThreadBuffer
+   {
+      public:
+         ThreadBuffer(unsigned index)
+         : mRecords(BUFFER_CAPACITY)
+         , mIndex(index)
+         , mHead(0)
+         , mSize(0)
+         , mNumDropped(0)
+         {
+         }
+
+         unsigned GetIndex() const { return mIndex; }
+
+         void Add(const Record& record)
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            if (mSize == BUFFER_CAPACITY)
+            {
+               ++mNumDropped;
+               return;
+            }
+            mRecords[(mHead + mSize) % BUFFER_CAPACITY] = record;
+            ++mSize;
+         }
+
+         void Drain(std::vector<Record>& recordsOut)
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            for (unsigned i = 0; i < mSize; ++i)
+            {
+               recordsOut.push_back(mRecords[(mHead + i) % BUFFER_CAPACITY]);
+            }
+            mHead = (mHead + mSize) % BUFFER_CAPACITY;
+            mSize = 0;
+         }
+
+         unsigned GetNumDropped() const
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            return mNumDropped;
+         }
+
+      private:
+         mutable OpenThreads::Mutex mMutex;
+         std::vector<Record> mRecords;
+         unsigned mIndex;
+         unsigned mHead;
+         unsigned mSize;
+         unsigned mNumDropped;
+   };
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler& FrameProfiler::GetInstance()
+   {
+      static FrameProfiler instance;
+      return instance;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::FrameProfiler()
+   : mStartTick(osg::Timer::instance()->tick())
+   , mMaxTraceEvents(DEFAULT_MAX_TRACE_EVENTS)
+   , mTraceEnabled(false)
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::~FrameProfiler()
+   {
+      mEnabled = false;
+      for (unsigned i = 0; i < mBuffers.size(); ++i)
+      {
+         delete mBuffers[i];
+      }
+      mBuffers.clear();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetEnabled(bool enabled)
+   {
+      mEnabled = enabled;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::ZoneId FrameProfiler::RegisterZone(const std::string& name, const std::string& category)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (unsigned i = 0; i < mZones.size(); ++i)
+      {
+         if (mZones[i].mName == name)
+         {
+            return i;
+         }
+      }
+
+      Zone zone;
+      zone.mName = name;
+      zone.mCategory = category;
+      mZones.push_back(zone);
+      return ZoneId(mZones.size() - 1);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::ZoneId FrameProfiler::FindZone(const std::string& name) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (unsigned i = 0; i < mZones.size(); ++i)
+      {
+         if (mZones[i].mName == name)
+         {
+            return i;
+         }
+      }
+      return INVALID_ZONE;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetNumZones() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mZones.size());
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   const std::string& FrameProfiler::GetZoneName(ZoneId zone) const
+   {
+      static const std::string EMPTY;
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      if (zone >= mZones.size())
+      {
+         return EMPTY;
+      }
+      return mZones[zone].mName;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::ThreadBuffer& FrameProfiler::GetThreadBuffer()
+   {
+      static SIMCORE_THREAD_LOCAL ThreadBuffer* threadBuffer = NULL;
+      if (threadBuffer == NULL)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         threadBuffer = new ThreadBuffer(unsigned(mBuffers.size()));
+         mBuffers.push_back(threadBuffer);
+      }
+      return *threadBuffer;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::AddRecord(const Record& record)
+   {
+      GetThreadBuffer().Add(record);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::RecordTime(ZoneId zone, osg::Timer_t startTick, osg::Timer_t endTick)
+   {
+      if (!mEnabled || zone == INVALID_ZONE)
+      {
+         return;
+      }
+
+      Record record;
+      record.mZone = zone;
+      record.mIsCount = false;
+      record.mStartTick = startTick;
+      record.mValue = (long long)(endTick);
+      AddRecord(record);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::RecordCount(ZoneId zone, long long value)
+   {
+      if (!mEnabled || zone == INVALID_ZONE)
+      {
+         return;
+      }
+
+      Record record;
+      record.mZone = zone;
+      record.mIsCount = true;
+      record.mStartTick = osg::Timer::instance()->tick();
+      record.mValue = value;
+      AddRecord(record);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::Collect()
+   {
+      osg::Timer* timer = osg::Timer::instance();
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (unsigned b = 0; b < mBuffers.size(); ++b)
+      {
+         mCollectList.clear();
+         mBuffers[b]->Drain(mCollectList);
+
+         for (unsigned i = 0; i < mCollectList.size(); ++i)
+         {
+            const Record& record = mCollectList[i];
+            if (record.mZone >= mZones.size())
+            {
+               continue;
+            }
+
+            ZoneStats& stats = mZones[record.mZone].mStats;
+            double traceValue = 0.0;
+            if (record.mIsCount)
+            {
+               stats.mCount += record.mValue;
+               traceValue = double(record.mValue);
+            }
+            else
+            {
+               osg::Timer_t endTick = osg::Timer_t(record.mValue);
+               double millis = timer->delta_m(record.mStartTick, endTick);
+               ++stats.mNumCalls;
+               stats.mTotalMillis += millis;
+               if (millis > stats.mMaxMillis)
+               {
+                  stats.mMaxMillis = millis;
+               }
+               traceValue = timer->delta_u(record.mStartTick, endTick);
+            }
+
+            if (mTraceEnabled && mTraceEvents.size() < mMaxTraceEvents)
+            {
+               TraceEvent event;
+               event.mZone = record.mZone;
+               event.mIsCount = record.mIsCount;
+               event.mThreadIndex = mBuffers[b]->GetIndex();
+               event.mStartMicros = timer->delta_u(mStartTick, record.mStartTick);
+               event.mValue = traceValue;
+               mTraceEvents.push_back(event);
+            }
+         }
+      }
+      mCollectList.clear();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   FrameProfiler::ZoneStats FrameProfiler::GetZoneStats(ZoneId zone) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      if (zone >= mZones.size())
+      {
+         return ZoneStats();
+      }
+      return mZones[zone].mStats;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::ResetStats()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (unsigned i = 0; i < mZones.size(); ++i)
+      {
+         mZones[i].mStats = ZoneStats();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::WriteStats(std::ostream& stream) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      stream << std::fixed << std::setprecision(3);
+      for (unsigned i = 0; i < mZones.size(); ++i)
+      {
+         const Zone& zone = mZones[i];
+         const ZoneStats& stats = zone.mStats;
+         if (stats.mNumCalls == 0 && stats.mCount == 0)
+         {
+            continue;
+         }
+
+         stream << zone.mName << ":";
+         if (stats.mNumCalls > 0)
+         {
+            stream << " calls " << stats.mNumCalls
+                   << ", total " << stats.mTotalMillis << " ms"
+                   << ", average " << stats.mTotalMillis / double(stats.mNumCalls) << " ms"
+                   << ", max " << stats.mMaxMillis << " ms";
+            if (stats.mCount != 0)
+            {
+               stream << ",";
+            }
+         }
+         if (stats.mCount != 0)
+         {
+            stream << " count " << stats.mCount;
+         }
+         stream << std::endl;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetNumDroppedRecords() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      unsigned numDropped = 0;
+      for (unsigned i = 0; i < mBuffers.size(); ++i)
+      {
+         numDropped += mBuffers[i]->GetNumDropped();
+      }
+      return numDropped;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetTraceEnabled(bool enabled)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mTraceEnabled = enabled;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool FrameProfiler::IsTraceEnabled() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mTraceEnabled;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::SetMaxTraceEvents(unsigned maxEvents)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mMaxTraceEvents = maxEvents;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetMaxTraceEvents() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mMaxTraceEvents;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   unsigned FrameProfiler::GetNumTraceEvents() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mTraceEvents.size());
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::ClearTrace()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mTraceEvents.clear();
+      mStartTick = osg::Timer::instance()->tick();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void FrameProfiler::WriteChromeTrace(std::ostream& stream) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      stream << "{\"traceEvents\":[";
+      stream << std::fixed << std::setprecision(1);
+      for (unsigned i = 0; i < mTraceEvents.size(); ++i)
+      {
+         const TraceEvent& event = mTraceEvents[i];
+         const Zone& zone = mZones[event.mZone];
+         if (i > 0)
+         {
+            stream << ",";
+         }
+         stream << "\n{\"name\":";
+         StartupTracer::WriteJsonString(stream, zone.mName);
+         stream << ",\"cat\":";
+         StartupTracer::WriteJsonString(stream, zone.mCategory);
+         if (event.mIsCount)
+         {
+            stream << ",\"ph\":\"C\",\"ts\":" << event.mStartMicros
+                   << ",\"pid\":1,\"tid\":" << event.mThreadIndex
+                   << ",\"args\":{\"value\":" << event.mValue << "}}";
+         }
+         else
+         {
+            stream << ",\"ph\":\"X\",\"ts\":" << event.mStartMicros
+                   << ",\"dur\":" << event.mValue
+                   << ",\"pid\":1,\"tid\":" << event.mThreadIndex << "}";
+         }
+      }
+      stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool FrameProfiler::WriteChromeTrace(const std::string& fileName) const
+   {
+      std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+      if (!file.is_open())
+      {
+         LOG_ERROR("Unable to open the profile trace file \"" + fileName + "\" for writing.");
+         return false;
+      }
+
+      WriteChromeTrace(file);
+      return !file.fail();
+   }
+}
@@ -42,6 +42,7 @@
 #include <SimCore/Actors/ControlStateActor.h>
 #include <SimCore/Components/MunitionsComponent.h>
 #include <SimCore/Array2DParser.h>
+#include <SimCore/FrameProfiler.h>
 #include <SimCore/HLA/HLACustomParameterTranslator.h>
 
 namespace SimCore
@@ -246,6 +247,8 @@ namespace SimCore
          std::vector<dtCore::RefPtr<const dtGame::MessageParameter> >& parameters,
          const dtHLAGM::OneToManyMapping& mapping) const
       {
+         SIMCORE_PROFILE_SCOPE("HLACustomParameterTranslator::MapFromMessageParameters");
+
          const dtHLAGM::AttributeType& hlaType = mapping.GetHLAType();
 
          if (parameters.size() == 0)
@@ -361,6 +364,7 @@ namespace SimCore
          std::vector<dtCore::RefPtr<dtGame::MessageParameter> >& parameters,
          const dtHLAGM::OneToManyMapping& mapping) const
       {
+         SIMCORE_PROFILE_SCOPE("HLACustomParameterTranslator::MapToMessageParameters");
 
          const dtHLAGM::AttributeType& hlaType = mapping.GetHLAType();
 
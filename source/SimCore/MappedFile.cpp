@@ -0,0 +1,199 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/MappedFile.h>
+
+#include <dtUtil/log.h>
+
+#ifdef DELTA_WIN32
+#include <dtUtil/mswin.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SimCore
+{
+   ////////////////////////////////////////////////////////////////////
+   MappedFile::MappedFile()
+   : mData(NULL)
+   , mSize(0)
+   , mOpen(false)
+#ifdef DELTA_WIN32
+   , mFileHandle(INVALID_HANDLE_VALUE)
+   , mMappingHandle(NULL)
+#else
+   , mFileDescriptor(-1)
+#endif
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   MappedFile::~MappedFile()
+   {
+      Close();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool MappedFile::Open(const std::string& fileName)
+   {
+      Close();
+
+#ifdef DELTA_WIN32
+      HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+      {
+         LOG_ERROR("Unable to open the file \"" + fileName + "\" for mapping.");
+         return false;
+      }
+
+      LARGE_INTEGER fileSize;
+      if (!GetFileSizeEx(file, &fileSize))
+      {
+         CloseHandle(file);
+         LOG_ERROR("Unable to get the size of the file \"" + fileName + "\".");
+         return false;
+      }
+
+      mFileHandle = file;
+      mSize = size_t(fileSize.QuadPart);
+      // An empty file can't be mapped, but it is still open, just with no data.
+      if (mSize > 0)
+      {
+         HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+         void* view = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+         if (view == NULL)
+         {
+            if (mapping != NULL)
+            {
+               CloseHandle(mapping);
+            }
+            CloseHandle(file);
+            mFileHandle = INVALID_HANDLE_VALUE;
+            mSize = 0;
+            LOG_ERROR("Unable to map the file \"" + fileName + "\".");
+            return false;
+         }
+         mMappingHandle = mapping;
+         mData = static_cast<const char*>(view);
+      }
+#else
+      int fd = open(fileName.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         LOG_ERROR("Unable to open the file \"" + fileName + "\" for mapping.");
+         return false;
+      }
+
+      struct stat fileStat;
+      if (fstat(fd, &fileStat) != 0)
+      {
+         close(fd);
+         LOG_ERROR("Unable to get the size of the file \"" + fileName + "\".");
+         return false;
+      }
+
+      mFileDescriptor = fd;
+      mSize = size_t(fileStat.st_size);
+      // An empty file can't be mapped, but it is still open, just with no data.
+      if (mSize > 0)
+      {
+         void* view = mmap(NULL, mSize, PROT_READ, MAP_SHARED, fd, 0);
+         if (view == MAP_FAILED)
+         {
+            close(fd);
+            mFileDescriptor = -1;
+            mSize = 0;
+            LOG_ERROR("Unable to map the file \"" + fileName + "\".");
+            return false;
+         }
+         mData = static_cast<const char*>(view);
+      }
+#endif
+
+      mFileName = fileName;
+      mOpen = true;
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void MappedFile::Close()
+   {
+      if (!mOpen)
+      {
+         return;
+      }
+
+#ifdef DELTA_WIN32
+      if (mData != NULL)
+      {
+         UnmapViewOfFile(mData);
+      }
+      if (mMappingHandle != NULL)
+      {
+         CloseHandle(mMappingHandle);
+      }
+      CloseHandle(mFileHandle);
+      mMappingHandle = NULL;
+      mFileHandle = INVALID_HANDLE_VALUE;
+#else
+      if (mData != NULL)
+      {
+         munmap(const_cast<char*>(mData), mSize);
+      }
+      close(mFileDescriptor);
+      mFileDescriptor = -1;
+#endif
+
+      mData = NULL;
+      mSize = 0;
+      mFileName.clear();
+      mOpen = false;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool MappedFile::IsOpen() const
+   {
+      return mOpen;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   const std::string& MappedFile::GetFileName() const
+   {
+      return mFileName;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   const char* MappedFile::GetData() const
+   {
+      return mData;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   size_t MappedFile::GetSize() const
+   {
+      return mSize;
+   }
+}
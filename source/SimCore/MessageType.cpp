@@ -34,6 +34,8 @@ namespace SimCore
    const MessageType MessageType::ATTACH_TO_ACTOR("Attach To Actor", "StealthViewer", "Attach Camera To Actor", USER_DEFINED_MESSAGE_TYPE + 1, DT_MSG_CLASS(AttachToActorMessage));
    const MessageType MessageType::DETONATION("Detonation", "StealthViewer", "Munition Detonation", USER_DEFINED_MESSAGE_TYPE + 2, DT_MSG_CLASS(DetonationMessage));
    const MessageType MessageType::SHOT_FIRED("Shot Fired", "StealthViewer", "Entity Weapon Fired", USER_DEFINED_MESSAGE_TYPE + 3, DT_MSG_CLASS(ShotFiredMessage));
+   const MessageType MessageType::WEAPON_EVENT_BATCH("Weapon Event Batch", "StealthViewer",
+      "Many shot fired and detonation events packed into one message.", USER_DEFINED_MESSAGE_TYPE + 28, DT_MSG_CLASS(WeaponEventBatchMessage));
 
    const MessageType MessageType::STEALTH_ACTOR_FOV("Stealth Actor Field of View", "StealthViewer",
       "Carries an update or change to the stealth actor field of view.",
@@ -54,6 +56,8 @@ namespace SimCore
 
    const MessageType MessageType::INFO_TERRAIN_LOADED("Terrain Loaded", "Info", "Sent when new terrain has been added an initialized.",
          USER_DEFINED_MESSAGE_TYPE + 27, DT_MSG_CLASS(dtGame::Message));
+   const MessageType MessageType::INFO_PROFILE_STATS("Profile Stats", "Info", "Sent periodically with the time spent in each profiled zone.",
+         USER_DEFINED_MESSAGE_TYPE + 29, DT_MSG_CLASS(ProfileStatsMessage));
 
    MessageType MessageType::BINOCULARS("Binoculars", "Tools", "Binoculars", USER_DEFINED_MESSAGE_TYPE + 10, DT_MSG_CLASS(ToolMessage));
    MessageType MessageType::COMPASS("Compass", "Tools", "Compass", USER_DEFINED_MESSAGE_TYPE + 11, DT_MSG_CLASS(ToolMessage));
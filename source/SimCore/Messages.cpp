@@ -27,10 +27,15 @@
 #include <dtCore/scene.h>
 
 #include <dtGame/messageparameter.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/log.h>
 
 #include <SimCore/Actors/DetonationActor.h>
 #include <SimCore/Actors/ViewerMaterialActor.h>
 
+#include <map>
+
 namespace SimCore
 {
    DT_IMPLEMENT_MESSAGE_BEGIN(BaseWeaponEventMessage)
@@ -71,6 +76,12 @@ namespace SimCore
       DT_ADD_PARAMETER(osg::Vec3, Enabled)
    DT_IMPLEMENT_MESSAGE_END()
 
+   DT_IMPLEMENT_MESSAGE_BEGIN(ProfileStatsMessage)
+      DT_ADD_PARAMETER(float, PeriodSeconds)
+      DT_ADD_PARAMETER(unsigned int, NumFrames)
+      DT_ADD_PARAMETER(std::string, Stats)
+   DT_IMPLEMENT_MESSAGE_END()
+
    /////////////////////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////////////////////
    AttachToActorMessage::AttachToActorMessage()
@@ -436,4 +447,240 @@ namespace SimCore
       dataBufferToFill = mDataParameter->GetValue();
    }
 
+   /////////////////////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////////////////////
+   WeaponEvent::WeaponEvent()
+   : mIsDetonation(false)
+   , mSendingActorId("")
+   , mTargetId("")
+   , mEventIdentifier(0)
+   , mQuantityFired(1)
+   , mRateOfFire(1)
+   , mFuseType(0)
+   , mWarheadType(0)
+   , mDetonationResultCode(0)
+   {
+   }
+
+   ////////////////////////////////////////////////////////
+   void WeaponEvent::FillShotFiredMessage(ShotFiredMessage& msg) const
+   {
+      msg.SetSendingActorId(mSendingActorId);
+      msg.SetAboutActorId(mTargetId);
+      msg.SetEventIdentifier(mEventIdentifier);
+      msg.SetMunitionType(mMunitionType);
+      msg.SetQuantityFired(mQuantityFired);
+      msg.SetRateOfFire(mRateOfFire);
+      msg.SetFuseType(mFuseType);
+      msg.SetWarheadType(mWarheadType);
+      msg.SetFiringLocation(mLocation);
+      msg.SetInitialVelocityVector(mVelocity);
+   }
+
+   ////////////////////////////////////////////////////////
+   void WeaponEvent::FillDetonationMessage(DetonationMessage& msg) const
+   {
+      msg.SetSendingActorId(mSendingActorId);
+      msg.SetAboutActorId(mTargetId);
+      msg.SetEventIdentifier(mEventIdentifier);
+      msg.SetMunitionType(mMunitionType);
+      msg.SetQuantityFired(mQuantityFired);
+      msg.SetRateOfFire(mRateOfFire);
+      msg.SetFuseType(mFuseType);
+      msg.SetWarheadType(mWarheadType);
+      msg.SetDetonationLocation(mLocation);
+      msg.SetFinalVelocityVector(mVelocity);
+      msg.SetRelativeDetonationLocation(mRelativeDetonationLocation);
+      msg.SetDetonationResultCode(mDetonationResultCode);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////////////////////
+   const std::string WeaponEventBatchMessage::PARAM_EVENT_COUNT("Event Count");
+   const std::string WeaponEventBatchMessage::PARAM_DATA("Data");
+
+   // Bits in the flags written for each event.
+   static const unsigned char WEAPON_EVENT_DETONATION = 0x01;
+   static const unsigned char WEAPON_EVENT_HAS_TARGET = 0x02;
+
+   ////////////////////////////////////////////////////////
+   static void WriteVec3(dtUtil::DataStream& ds, const osg::Vec3& vec)
+   {
+      ds << vec.x() << vec.y() << vec.z();
+   }
+
+   ////////////////////////////////////////////////////////
+   static void ReadVec3(dtUtil::DataStream& ds, osg::Vec3& vec)
+   {
+      ds >> vec.x() >> vec.y() >> vec.z();
+   }
+
+   ////////////////////////////////////////////////////////
+   WeaponEventBatchMessage::WeaponEventBatchMessage()
+   {
+      mEventCount = new dtGame::UnsignedIntMessageParameter(PARAM_EVENT_COUNT);
+      AddParameter(mEventCount);
+      mData = new dtGame::StringMessageParameter(PARAM_DATA);
+      AddParameter(mData);
+   }
+
+   ////////////////////////////////////////////////////////
+   WeaponEventBatchMessage::~WeaponEventBatchMessage()
+   {
+   }
+
+   ////////////////////////////////////////////////////////
+   unsigned WeaponEventBatchMessage::GetEventCount() const
+   {
+      return mEventCount->GetValue();
+   }
+
+   ////////////////////////////////////////////////////////
+   void WeaponEventBatchMessage::SetEvents(const std::vector<WeaponEvent>& events)
+   {
+      // Ids and munition names repeat a lot in a batch, so each is written once and referenced by index.
+      std::vector<std::string> strings;
+      std::map<std::string, unsigned short> stringIndices;
+      std::vector<unsigned short> eventStrings;
+      eventStrings.reserve(events.size() * 3);
+
+      std::vector<WeaponEvent>::const_iterator i, iend = events.end();
+      for (i = events.begin(); i != iend; ++i)
+      {
+         const std::string* eventKeys[3] = { &i->mMunitionType, NULL, NULL };
+         std::string sender = i->mSendingActorId.ToString();
+         std::string target = i->mTargetId.ToString();
+         eventKeys[1] = &sender;
+         eventKeys[2] = &target;
+
+         for (unsigned k = 0; k < 3; ++k)
+         {
+            std::pair<std::map<std::string, unsigned short>::iterator, bool> inserted =
+               stringIndices.insert(std::make_pair(*eventKeys[k], (unsigned short)(strings.size())));
+            if (inserted.second)
+            {
+               strings.push_back(*eventKeys[k]);
+            }
+            eventStrings.push_back(inserted.first->second);
+         }
+      }
+
+      dtUtil::DataStream ds;
+      ds.SetForceLittleEndian(true);
+      ds << unsigned(strings.size());
+      for (size_t s = 0; s < strings.size(); ++s)
+      {
+         ds << strings[s];
+      }
+
+      ds << unsigned(events.size());
+      std::vector<unsigned short>::const_iterator stringIter = eventStrings.begin();
+      for (i = events.begin(); i != iend; ++i)
+      {
+         bool hasTarget = !i->mTargetId.ToString().empty();
+         unsigned char flags = 0;
+         if (i->mIsDetonation) { flags |= WEAPON_EVENT_DETONATION; }
+         if (hasTarget) { flags |= WEAPON_EVENT_HAS_TARGET; }
+
+         ds << flags;
+         ds << *stringIter++; // munition
+         ds << *stringIter++; // sender
+         unsigned short targetIndex = *stringIter++;
+         if (hasTarget) { ds << targetIndex; }
+
+         ds << i->mEventIdentifier << i->mQuantityFired << i->mRateOfFire << i->mFuseType << i->mWarheadType;
+         WriteVec3(ds, i->mLocation);
+         WriteVec3(ds, i->mVelocity);
+
+         if (i->mIsDetonation)
+         {
+            ds << i->mDetonationResultCode;
+            if (hasTarget) { WriteVec3(ds, i->mRelativeDetonationLocation); }
+         }
+      }
+
+      mEventCount->SetValue(unsigned(events.size()));
+      mData->SetValue(std::string(ds.GetBuffer(), ds.GetBufferSize()));
+   }
+
+   ////////////////////////////////////////////////////////
+   bool WeaponEventBatchMessage::GetEvents(std::vector<WeaponEvent>& eventsToFill) const
+   {
+      const std::string& data = mData->GetValue();
+      if (data.empty())
+      {
+         return GetEventCount() == 0;
+      }
+
+      dtUtil::DataStream ds(const_cast<char*>(data.data()), unsigned(data.size()), false);
+      ds.SetForceLittleEndian(true);
+
+      std::vector<WeaponEvent> events;
+      try
+      {
+         unsigned stringCount = 0;
+         ds >> stringCount;
+         // Every string takes at least a byte, so anything larger is garbage.
+         if (stringCount > data.size())
+         {
+            return false;
+         }
+
+         std::vector<std::string> strings(stringCount);
+         for (unsigned s = 0; s < stringCount; ++s)
+         {
+            ds >> strings[s];
+         }
+
+         unsigned eventCount = 0;
+         ds >> eventCount;
+         if (eventCount > data.size())
+         {
+            return false;
+         }
+
+         events.resize(eventCount);
+         for (unsigned e = 0; e < eventCount; ++e)
+         {
+            WeaponEvent& event = events[e];
+
+            unsigned char flags = 0;
+            unsigned short munitionIndex = 0, senderIndex = 0, targetIndex = 0;
+            ds >> flags;
+            ds >> munitionIndex;
+            ds >> senderIndex;
+            bool hasTarget = (flags & WEAPON_EVENT_HAS_TARGET) != 0;
+            if (hasTarget) { ds >> targetIndex; }
+
+            if (munitionIndex >= stringCount || senderIndex >= stringCount || targetIndex >= stringCount)
+            {
+               return false;
+            }
+
+            event.mIsDetonation = (flags & WEAPON_EVENT_DETONATION) != 0;
+            event.mMunitionType = strings[munitionIndex];
+            event.mSendingActorId = dtCore::UniqueId(strings[senderIndex]);
+            if (hasTarget) { event.mTargetId = dtCore::UniqueId(strings[targetIndex]); }
+
+            ds >> event.mEventIdentifier >> event.mQuantityFired >> event.mRateOfFire >> event.mFuseType >> event.mWarheadType;
+            ReadVec3(ds, event.mLocation);
+            ReadVec3(ds, event.mVelocity);
+
+            if (event.mIsDetonation)
+            {
+               ds >> event.mDetonationResultCode;
+               if (hasTarget) { ReadVec3(ds, event.mRelativeDetonationLocation); }
+            }
+         }
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         LOG_WARNING("Unable to read a weapon event batch: " + ex.What());
+         return false;
+      }
+
+      eventsToFill.insert(eventsToFill.end(), events.begin(), events.end());
+      return true;
+   }
+
 }
@@ -0,0 +1,488 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/StartupPreloader.h>
+#include <SimCore/StartupTracer.h>
+
+#include <dtUtil/datapathutils.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+
+#include <OpenThreads/ScopedLock>
+#include <osg/Node>
+#include <osgDB/Registry>
+
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace SimCore
+{
+   //////////////////////////////////////////////////////////////////////////
+   // Startup Preload Task Code
+   //////////////////////////////////////////////////////////////////////////
+   StartupPreloadTask::StartupPreloadTask(const std::string& name)
+   : mName(name)
+   , mPreloader(NULL)
+   , mQueued(false)
+   , mFinished(false)
+   {
+      mFinishedBlock.reset();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   StartupPreloadTask::~StartupPreloadTask()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const std::string& StartupPreloadTask::GetName() const
+   {
+      return mName;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloadTask::AddDependency(StartupPreloadTask& dependency)
+   {
+      if (mPreloader != NULL)
+      {
+         LOG_ERROR("Unable to add a dependency to the startup preload task \"" + mName + "\" because it is already in a preloader.");
+         return;
+      }
+      mDependencies.push_back(&dependency);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned StartupPreloadTask::GetNumDependencies() const
+   {
+      return unsigned(mDependencies.size());
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   StartupPreloadTask* StartupPreloadTask::GetDependency(unsigned index)
+   {
+      return mDependencies[index].get();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool StartupPreloadTask::IsFinished() const
+   {
+      if (mPreloader == NULL)
+      {
+         return mFinished;
+      }
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPreloader->mMutex);
+      return mFinished;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloadTask::WaitUntilFinished()
+   {
+      mFinishedBlock.block();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloadTask::operator()()
+   {
+      {
+         StartupTracer::Phase phase(mName, "Preload");
+         try
+         {
+            Run();
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            LOG_ERROR("Startup preload task \"" + mName + "\" failed: " + ex.What());
+         }
+         catch (const std::exception& ex)
+         {
+            LOG_ERROR("Startup preload task \"" + mName + "\" failed: " + ex.what());
+         }
+      }
+
+      if (mPreloader != NULL)
+      {
+         mPreloader->OnTaskFinished(*this);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   // Startup Preloader Code
+   //////////////////////////////////////////////////////////////////////////
+   StartupPreloader::StartupPreloader()
+   : mNumFinished(0)
+   , mStarted(false)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   StartupPreloader::~StartupPreloader()
+   {
+      if (mStarted)
+      {
+         WaitUntilComplete();
+      }
+
+      for (unsigned i = 0; i < mTasks.size(); ++i)
+      {
+         mTasks[i]->mPreloader = NULL;
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool StartupPreloader::AddTask(StartupPreloadTask& task)
+   {
+      std::vector<StartupPreloadTask*> readyTasks;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         if (task.mPreloader != NULL)
+         {
+            LOG_ERROR("The startup preload task \"" + task.GetName() + "\" is already in a preloader.");
+            return false;
+         }
+
+         for (unsigned i = 0; i < task.mDependencies.size(); ++i)
+         {
+            if (task.mDependencies[i]->mPreloader != this)
+            {
+               LOG_ERROR("Unable to add the startup preload task \"" + task.GetName() + "\" because its dependency \""
+                  + task.mDependencies[i]->GetName() + "\" hasn't been added to the preloader.");
+               return false;
+            }
+         }
+
+         task.mPreloader = this;
+         mTasks.push_back(&task);
+
+         if (mStarted && IsReady(task))
+         {
+            task.mQueued = true;
+            readyTasks.push_back(&task);
+         }
+      }
+
+      QueueTasks(readyTasks);
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   StartupPreloadTask* StartupPreloader::FindTask(const std::string& name)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (unsigned i = 0; i < mTasks.size(); ++i)
+      {
+         if (mTasks[i]->GetName() == name)
+         {
+            return mTasks[i].get();
+         }
+      }
+      return NULL;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned StartupPreloader::GetNumTasks() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mTasks.size());
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool StartupPreloader::IsReady(const StartupPreloadTask& task) const
+   {
+      if (task.mQueued || task.mFinished)
+      {
+         return false;
+      }
+
+      for (unsigned i = 0; i < task.mDependencies.size(); ++i)
+      {
+         if (!task.mDependencies[i]->mFinished)
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloader::Start()
+   {
+      std::vector<StartupPreloadTask*> readyTasks;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         if (mStarted)
+         {
+            return;
+         }
+         mStarted = true;
+
+         for (unsigned i = 0; i < mTasks.size(); ++i)
+         {
+            StartupPreloadTask& task = *mTasks[i];
+            if (IsReady(task))
+            {
+               task.mQueued = true;
+               readyTasks.push_back(&task);
+            }
+         }
+      }
+
+      QueueTasks(readyTasks);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool StartupPreloader::IsStarted() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mStarted;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool StartupPreloader::IsComplete() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mStarted && mNumFinished == mTasks.size();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloader::WaitUntilComplete()
+   {
+      if (!IsStarted())
+      {
+         LOG_WARNING("Waiting on a startup preloader that hasn't been started.  Starting it now.");
+         Start();
+      }
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      while (mNumFinished < mTasks.size())
+      {
+         mCompleteCondition.wait(&mMutex);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloader::OnTaskFinished(StartupPreloadTask& task)
+   {
+      std::vector<StartupPreloadTask*> readyTasks;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         task.mFinished = true;
+         task.mFinishedBlock.release();
+         ++mNumFinished;
+
+         for (unsigned i = 0; i < mTasks.size(); ++i)
+         {
+            StartupPreloadTask& waitingTask = *mTasks[i];
+            if (IsReady(waitingTask))
+            {
+               waitingTask.mQueued = true;
+               readyTasks.push_back(&waitingTask);
+            }
+         }
+
+         // The waiting thread can't wake until the mutex is unlocked, and once every task
+         // is finished there is nothing left to queue, so the preloader isn't used after this.
+         if (mNumFinished == mTasks.size())
+         {
+            mCompleteCondition.broadcast();
+         }
+      }
+
+      QueueTasks(readyTasks);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StartupPreloader::QueueTasks(const std::vector<StartupPreloadTask*>& tasks)
+   {
+      for (unsigned i = 0; i < tasks.size(); ++i)
+      {
+         dtUtil::ThreadPool::AddTask(*tasks[i], dtUtil::ThreadPool::IO);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   // Model Preload Task Code
+   //////////////////////////////////////////////////////////////////////////
+   ModelPreloadTask::ModelPreloadTask(const std::string& name)
+   : StartupPreloadTask(name)
+   , mNumLoaded(0)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   ModelPreloadTask::~ModelPreloadTask()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void ModelPreloadTask::AddFile(const std::string& fileName)
+   {
+      mFiles.push_back(fileName);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const std::vector<std::string>& ModelPreloadTask::GetFiles() const
+   {
+      return mFiles;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ModelPreloadTask::GetNumLoaded() const
+   {
+      return mNumLoaded;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void ModelPreloadTask::Run()
+   {
+      // Same options as IGActor::LoadFileStatic, so the cached copy is found.
+      osgDB::ReaderWriter::Options* curOptions = osgDB::Registry::instance()->getOptions();
+      osg::ref_ptr<osgDB::ReaderWriter::Options> options = curOptions ?
+         static_cast<osgDB::ReaderWriter::Options*>(curOptions->clone(osg::CopyOp::SHALLOW_COPY)) :
+         new osgDB::ReaderWriter::Options;
+      options->setObjectCacheHint(osgDB::ReaderWriter::Options::CACHE_ALL);
+
+      for (unsigned i = 0; i < mFiles.size(); ++i)
+      {
+         dtCore::RefPtr<osg::Node> node = dtUtil::FileUtils::GetInstance().ReadNode(mFiles[i], options.get());
+         if (node.valid())
+         {
+            ++mNumLoaded;
+         }
+         else
+         {
+            LOG_WARNING("Unable to preload the model \"" + mFiles[i] + "\".");
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   // Shader Definition Scan Task Code
+   //////////////////////////////////////////////////////////////////////////
+   const std::string ShaderDefinitionScanTask::DEFAULT_NAME("Shader Definition Scan");
+
+   //////////////////////////////////////////////////////////////////////////
+   ShaderDefinitionScanTask::ShaderDefinitionScanTask(const std::string& definitionFile)
+   : StartupPreloadTask(DEFAULT_NAME)
+   , mDefinitionFile(definitionFile)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   ShaderDefinitionScanTask::~ShaderDefinitionScanTask()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const std::vector<std::string>& ShaderDefinitionScanTask::GetSourceFiles() const
+   {
+      return mSourceFiles;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void ShaderDefinitionScanTask::Run()
+   {
+      std::ifstream file(mDefinitionFile.c_str());
+      if (!file.is_open())
+      {
+         LOG_WARNING("Unable to open the shader definition file \"" + mDefinitionFile + "\" to preload the shaders.");
+         return;
+      }
+
+      std::ostringstream contents;
+      contents << file.rdbuf();
+      const std::string text = contents.str();
+
+      // The ShaderManager does the real parsing, so this only needs the text of the <source> elements.
+      static const std::string SOURCE_START("<source");
+      static const std::string SOURCE_END("</source>");
+
+      std::set<std::string> found;
+      std::string::size_type pos = text.find(SOURCE_START);
+      while (pos != std::string::npos)
+      {
+         std::string::size_type valueStart = text.find('>', pos);
+         std::string::size_type valueEnd = valueStart == std::string::npos ? std::string::npos : text.find(SOURCE_END, valueStart);
+         if (valueEnd == std::string::npos)
+         {
+            break;
+         }
+
+         std::string sourceFile = text.substr(valueStart + 1, valueEnd - valueStart - 1);
+         dtUtil::Trim(sourceFile);
+         if (!sourceFile.empty() && found.insert(sourceFile).second)
+         {
+            std::string path = dtUtil::FindFileInPathList(sourceFile);
+            if (!path.empty())
+            {
+               mSourceFiles.push_back(path);
+            }
+         }
+
+         pos = text.find(SOURCE_START, valueEnd);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   // Shader Source Preload Task Code
+   //////////////////////////////////////////////////////////////////////////
+   const std::string ShaderSourcePreloadTask::DEFAULT_NAME("Shader Source Preload");
+
+   //////////////////////////////////////////////////////////////////////////
+   ShaderSourcePreloadTask::ShaderSourcePreloadTask(ShaderDefinitionScanTask& scanTask)
+   : StartupPreloadTask(DEFAULT_NAME)
+   , mScanTask(&scanTask)
+   , mNumBytesRead(0)
+   {
+      AddDependency(scanTask);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   ShaderSourcePreloadTask::~ShaderSourcePreloadTask()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned ShaderSourcePreloadTask::GetNumBytesRead() const
+   {
+      return mNumBytesRead;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void ShaderSourcePreloadTask::Run()
+   {
+      const std::vector<std::string>& files = mScanTask->GetSourceFiles();
+
+      std::vector<char> buffer(64 * 1024);
+      for (unsigned i = 0; i < files.size(); ++i)
+      {
+         std::ifstream file(files[i].c_str(), std::ios::in | std::ios::binary);
+         while (file.good())
+         {
+            file.read(&buffer[0], buffer.size());
+            mNumBytesRead += unsigned(file.gcount());
+         }
+      }
+   }
+}
@@ -0,0 +1,234 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/StartupTracer.h>
+
+#include <dtUtil/log.h>
+
+#include <OpenThreads/ScopedLock>
+#include <OpenThreads/Thread>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+namespace SimCore
+{
+   const std::string StartupTracer::DEFAULT_CATEGORY("Startup");
+
+   ////////////////////////////////////////////////////////////////////
+   void StartupTracer::WriteJsonString(std::ostream& stream, const std::string& value)
+   {
+      stream << '"';
+      for (std::string::const_iterator i = value.begin(); i != value.end(); ++i)
+      {
+         char c = *i;
+         if (c == '"' || c == '\\')
+         {
+            stream << '\\' << c;
+         }
+         else if ((unsigned char)(c) < 0x20)
+         {
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+            stream << "\\u00" << HEX_DIGITS[(c >> 4) & 0xF] << HEX_DIGITS[c & 0xF];
+         }
+         else
+         {
+            stream << c;
+         }
+      }
+      stream << '"';
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   StartupTracer& StartupTracer::GetInstance()
+   {
+      static StartupTracer instance;
+      return instance;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   StartupTracer::StartupTracer()
+   : mStartTick(osg::Timer::instance()->tick())
+   , mEnabled(false)
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   StartupTracer::~StartupTracer()
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void StartupTracer::SetEnabled(bool enabled)
+   {
+      mEnabled = enabled;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool StartupTracer::IsEnabled() const
+   {
+      return mEnabled;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void StartupTracer::SetOutputFile(const std::string& fileName)
+   {
+      mOutputFile = fileName;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   const std::string& StartupTracer::GetOutputFile() const
+   {
+      return mOutputFile;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   osg::Timer_t StartupTracer::Tick() const
+   {
+      return osg::Timer::instance()->tick();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void StartupTracer::RecordPhase(const std::string& name, const std::string& category, osg::Timer_t startTick, osg::Timer_t endTick)
+   {
+      if (!mEnabled)
+      {
+         return;
+      }
+
+      osg::Timer* timer = osg::Timer::instance();
+
+      Event event;
+      event.mName = name;
+      event.mCategory = category;
+      // The main thread isn't an OpenThreads thread, so it gets 0.
+      OpenThreads::Thread* thread = OpenThreads::Thread::CurrentThread();
+      event.mThreadId = thread != NULL ? thread->getThreadId() : 0;
+      event.mStartMicros = timer->delta_u(mStartTick, startTick);
+      event.mDurationMicros = timer->delta_u(startTick, endTick);
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mEvents.push_back(event);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   unsigned StartupTracer::GetNumPhases() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return unsigned(mEvents.size());
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool StartupTracer::HasPhase(const std::string& name) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      for (std::vector<Event>::const_iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+      {
+         if (i->mName == name)
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void StartupTracer::Clear()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mEvents.clear();
+      mStartTick = osg::Timer::instance()->tick();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void StartupTracer::WriteChromeTrace(std::ostream& stream) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      stream << "{\"traceEvents\":[";
+      stream << std::fixed << std::setprecision(1);
+      for (unsigned i = 0; i < mEvents.size(); ++i)
+      {
+         const Event& event = mEvents[i];
+         if (i > 0)
+         {
+            stream << ",";
+         }
+         stream << "\n{\"name\":";
+         WriteJsonString(stream, event.mName);
+         stream << ",\"cat\":";
+         WriteJsonString(stream, event.mCategory);
+         stream << ",\"ph\":\"X\",\"ts\":" << event.mStartMicros
+                << ",\"dur\":" << event.mDurationMicros
+                << ",\"pid\":1,\"tid\":" << event.mThreadId << "}";
+      }
+      stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool StartupTracer::WriteChromeTrace(const std::string& fileName) const
+   {
+      std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+      if (!file.is_open())
+      {
+         LOG_ERROR("Unable to open the startup trace file \"" + fileName + "\" for writing.");
+         return false;
+      }
+
+      WriteChromeTrace(file);
+      return !file.fail();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool StartupTracer::WriteOutputFile() const
+   {
+      if (!mEnabled || mOutputFile.empty())
+      {
+         return false;
+      }
+      return WriteChromeTrace(mOutputFile);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   StartupTracer::Phase::Phase(const std::string& name, const std::string& category)
+   : mStartTick(0)
+   , mEnabled(StartupTracer::GetInstance().IsEnabled())
+   {
+      // Skip the string copies when nothing is being recorded.
+      if (mEnabled)
+      {
+         mName = name;
+         mCategory = category;
+         mStartTick = osg::Timer::instance()->tick();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   StartupTracer::Phase::~Phase()
+   {
+      if (mEnabled)
+      {
+         StartupTracer::GetInstance().RecordPhase(mName, mCategory, mStartTick, osg::Timer::instance()->tick());
+      }
+   }
+}
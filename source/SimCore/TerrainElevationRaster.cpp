@@ -0,0 +1,608 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+
+#include <prefix/SimCorePrefix.h>
+#include <SimCore/TerrainElevationRaster.h>
+#include <SimCore/FrameProfiler.h>
+
+#include <dtUtil/datastream.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+
+#include <osg/ComputeBoundsVisitor>
+#include <osgUtil/IntersectionVisitor>
+#include <osgUtil/LineSegmentIntersector>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace SimCore
+{
+   const float TerrainElevationRaster::DEFAULT_CELL_SIZE = 2.0f;
+   const unsigned TerrainElevationRaster::DEFAULT_TILE_CELLS = 64;
+   const float TerrainElevationRaster::DEFAULT_MAX_STEP = 3.0f;
+   const float TerrainElevationRaster::DEFAULT_MIN_CLEARANCE = 1.0f;
+
+   // "TELV"
+   const unsigned TerrainElevationRaster::CACHE_FILE_MAGIC = 0x564C4554;
+   const unsigned TerrainElevationRaster::CACHE_FILE_VERSION = 1;
+   const std::string TerrainElevationRaster::CACHE_FILE_EXTENSION(".elev");
+
+   // The height of a sample where the ray hit nothing.
+   static const float NO_HEIGHT = -FLT_MAX;
+
+   //////////////////////////////////////////////////////////////////////////
+   TerrainElevationRaster::Level::Level()
+      : mNumPoints(0)
+      , mSpacing(0.0f)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TerrainElevationRaster::TerrainElevationRaster(float cellSize, unsigned tileCells)
+      : mMaxStep(DEFAULT_MAX_STEP)
+      , mMinClearance(DEFAULT_MIN_CLEARANCE)
+      , mBuildOnQuery(true)
+      , mCellSize(cellSize)
+      , mTileCells(1)
+      , mNumLevels(1)
+      , mTileSize(0.0f)
+      , mNumTilesX(0)
+      , mNumTilesY(0)
+      , mNumTilesSampled(0)
+      , mNumTilesLoaded(0)
+   {
+      // A power of two, so every level halves evenly.
+      while (mTileCells < tileCells)
+      {
+         mTileCells *= 2;
+         ++mNumLevels;
+      }
+      mTileSize = mCellSize * float(mTileCells);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TerrainElevationRaster::~TerrainElevationRaster()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   DT_IMPLEMENT_ACCESSOR(TerrainElevationRaster, float, MaxStep);
+   DT_IMPLEMENT_ACCESSOR(TerrainElevationRaster, float, MinClearance);
+   DT_IMPLEMENT_ACCESSOR(TerrainElevationRaster, std::string, CacheDirectory);
+   DT_IMPLEMENT_ACCESSOR(TerrainElevationRaster, std::string, CacheKey);
+   DT_IMPLEMENT_ACCESSOR(TerrainElevationRaster, bool, BuildOnQuery);
+
+   //////////////////////////////////////////////////////////////////////////
+   float TerrainElevationRaster::GetCellSize() const
+   {
+      return mCellSize;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::GetTileCells() const
+   {
+      return mTileCells;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::GetNumLevels() const
+   {
+      return mNumLevels;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TerrainElevationRaster::SetTerrain(osg::Node* terrain)
+   {
+      mTerrain = terrain;
+      mBounds.init();
+      mNumTilesX = 0;
+      mNumTilesY = 0;
+
+      if (terrain != NULL)
+      {
+         osg::ComputeBoundsVisitor boundsVisitor;
+         terrain->accept(boundsVisitor);
+         mBounds = boundsVisitor.getBoundingBox();
+      }
+
+      if (mBounds.valid())
+      {
+         mNumTilesX = std::max(1U, unsigned(std::ceil((mBounds.xMax() - mBounds.xMin()) / mTileSize)));
+         mNumTilesY = std::max(1U, unsigned(std::ceil((mBounds.yMax() - mBounds.yMin()) / mTileSize)));
+      }
+
+      mTiles.clear();
+      mTiles.resize(mNumTilesX * mNumTilesY);
+      mNumTilesSampled = 0;
+      mNumTilesLoaded = 0;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   osg::Node* TerrainElevationRaster::GetTerrain()
+   {
+      return mTerrain.get();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const osg::BoundingBox& TerrainElevationRaster::GetBounds() const
+   {
+      return mBounds;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::GetNumTilesX() const
+   {
+      return mNumTilesX;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::GetNumTilesY() const
+   {
+      return mNumTilesY;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TerrainElevationRaster::BuildTile(unsigned tileX, unsigned tileY)
+   {
+      if (tileX >= mNumTilesX || tileY >= mNumTilesY)
+      {
+         return false;
+      }
+
+      Tile& tile = mTiles[tileY * mNumTilesX + tileX];
+      if (!tile.empty())
+      {
+         return true;
+      }
+
+      Tile newTile;
+      std::vector<unsigned char> multiSurface;
+      bool loaded = LoadTile(tileX, tileY, newTile, multiSurface);
+      if (loaded)
+      {
+         ++mNumTilesLoaded;
+      }
+      else
+      {
+         if (!mTerrain.valid())
+         {
+            return false;
+         }
+
+         newTile.resize(1);
+         SampleTile(tileX, tileY, newTile[0], multiSurface);
+         ++mNumTilesSampled;
+      }
+
+      FinishTile(newTile, multiSurface);
+
+      if (!loaded && !mCacheDirectory.empty())
+      {
+         SaveTile(tileX, tileY, newTile, multiSurface);
+      }
+
+      tile.swap(newTile);
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::BuildAllTiles()
+   {
+      unsigned numBuilt = 0;
+      for (unsigned tileY = 0; tileY < mNumTilesY; ++tileY)
+      {
+         for (unsigned tileX = 0; tileX < mNumTilesX; ++tileX)
+         {
+            if (!IsTileBuilt(tileX, tileY) && BuildTile(tileX, tileY))
+            {
+               ++numBuilt;
+            }
+         }
+      }
+      return numBuilt;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TerrainElevationRaster::IsTileBuilt(unsigned tileX, unsigned tileY) const
+   {
+      return tileX < mNumTilesX && tileY < mNumTilesY && !mTiles[tileY * mNumTilesX + tileX].empty();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::GetNumTilesSampled() const
+   {
+      return mNumTilesSampled;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TerrainElevationRaster::GetNumTilesLoaded() const
+   {
+      return mNumTilesLoaded;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TerrainElevationRaster::ClearTiles()
+   {
+      for (unsigned i = 0; i < mTiles.size(); ++i)
+      {
+         Tile().swap(mTiles[i]);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TerrainElevationRaster::QueryResult TerrainElevationRaster::GetHeight(float x, float y, float& outHeight, unsigned level)
+   {
+      osg::Vec3 normal;
+      return GetHeightAndNormal(x, y, outHeight, normal, level);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TerrainElevationRaster::QueryResult TerrainElevationRaster::GetHeightAndNormal(float x, float y,
+            float& outHeight, osg::Vec3& outNormal, unsigned level)
+   {
+      float localX = 0.0f, localY = 0.0f;
+      const Level* grid = FindLevel(x, y, level, localX, localY);
+      if (grid == NULL)
+      {
+         return NO_DATA;
+      }
+
+      unsigned numPoints = grid->mNumPoints;
+      float gridX = localX / grid->mSpacing;
+      float gridY = localY / grid->mSpacing;
+      unsigned cellX = std::min(unsigned(gridX), numPoints - 2);
+      unsigned cellY = std::min(unsigned(gridY), numPoints - 2);
+      float fracX = std::min(gridX - float(cellX), 1.0f);
+      float fracY = std::min(gridY - float(cellY), 1.0f);
+
+      unsigned index = cellY * numPoints + cellX;
+      float h00 = grid->mHeights[index];
+      float h10 = grid->mHeights[index + 1];
+      float h01 = grid->mHeights[index + numPoints];
+      float h11 = grid->mHeights[index + numPoints + 1];
+      if (h00 == NO_HEIGHT || h10 == NO_HEIGHT || h01 == NO_HEIGHT || h11 == NO_HEIGHT)
+      {
+         return NO_DATA;
+      }
+
+      float bottom = h00 + (h10 - h00) * fracX;
+      float top = h01 + (h11 - h01) * fracX;
+      outHeight = bottom + (top - bottom) * fracY;
+
+      float slopeX = ((h10 - h00) * (1.0f - fracY) + (h11 - h01) * fracY) / grid->mSpacing;
+      float slopeY = ((h01 - h00) * (1.0f - fracX) + (h11 - h10) * fracX) / grid->mSpacing;
+      outNormal.set(-slopeX, -slopeY, 1.0f);
+      outNormal.normalize();
+
+      return grid->mComplex[cellY * (numPoints - 1) + cellX] != 0 ? COMPLEX_TERRAIN : OPEN_TERRAIN;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   std::string TerrainElevationRaster::GetTileCacheFile(unsigned tileX, unsigned tileY) const
+   {
+      if (mCacheDirectory.empty())
+      {
+         return std::string();
+      }
+      return mCacheDirectory + "/tile_" + dtUtil::ToString(tileX) + "_" + dtUtil::ToString(tileY) + CACHE_FILE_EXTENSION;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const TerrainElevationRaster::Level* TerrainElevationRaster::FindLevel(float x, float y, unsigned level,
+            float& outLocalX, float& outLocalY)
+   {
+      if (mTiles.empty())
+      {
+         return NULL;
+      }
+
+      float tileCoordX = (x - mBounds.xMin()) / mTileSize;
+      float tileCoordY = (y - mBounds.yMin()) / mTileSize;
+      if (tileCoordX < 0.0f || tileCoordY < 0.0f)
+      {
+         return NULL;
+      }
+
+      unsigned tileX = unsigned(tileCoordX);
+      unsigned tileY = unsigned(tileCoordY);
+      if (tileX >= mNumTilesX || tileY >= mNumTilesY)
+      {
+         return NULL;
+      }
+
+      Tile& tile = mTiles[tileY * mNumTilesX + tileX];
+      if (tile.empty() && (!mBuildOnQuery || !BuildTile(tileX, tileY)))
+      {
+         return NULL;
+      }
+
+      outLocalX = x - (mBounds.xMin() + float(tileX) * mTileSize);
+      outLocalY = y - (mBounds.yMin() + float(tileY) * mTileSize);
+      return &tile[std::min(level, unsigned(tile.size()) - 1)];
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TerrainElevationRaster::SampleTile(unsigned tileX, unsigned tileY, Level& level, std::vector<unsigned char>& multiSurface)
+   {
+      SIMCORE_PROFILE_SCOPE("TerrainElevationRaster::SampleTile");
+
+      unsigned numPoints = mTileCells + 1;
+      level.mNumPoints = numPoints;
+      level.mSpacing = mCellSize;
+      level.mHeights.assign(numPoints * numPoints, NO_HEIGHT);
+      multiSurface.assign(numPoints * numPoints, 0);
+
+      float originX = mBounds.xMin() + float(tileX) * mTileSize;
+      float originY = mBounds.yMin() + float(tileY) * mTileSize;
+      float top = mBounds.zMax() + 1.0f;
+      float bottom = mBounds.zMin() - 1.0f;
+
+      // All the rays of the tile go in one traversal of the terrain.
+      osg::ref_ptr<osgUtil::IntersectorGroup> group = new osgUtil::IntersectorGroup;
+      std::vector<osgUtil::LineSegmentIntersector*> rays;
+      rays.reserve(numPoints * numPoints);
+      for (unsigned j = 0; j < numPoints; ++j)
+      {
+         for (unsigned i = 0; i < numPoints; ++i)
+         {
+            float x = originX + float(i) * mCellSize;
+            float y = originY + float(j) * mCellSize;
+            osgUtil::LineSegmentIntersector* ray =
+                     new osgUtil::LineSegmentIntersector(osg::Vec3(x, y, top), osg::Vec3(x, y, bottom));
+            group->addIntersector(ray);
+            rays.push_back(ray);
+         }
+      }
+
+      osgUtil::IntersectionVisitor visitor(group.get());
+      mTerrain->accept(visitor);
+
+      for (unsigned k = 0; k < rays.size(); ++k)
+      {
+         const osgUtil::LineSegmentIntersector::Intersections& hits = rays[k]->getIntersections();
+         if (hits.empty())
+         {
+            continue;
+         }
+
+         // The hits are sorted from the top of the ray.
+         osgUtil::LineSegmentIntersector::Intersections::const_iterator hitIter = hits.begin();
+         float topHeight = hitIter->getWorldIntersectPoint().z();
+         level.mHeights[k] = topHeight;
+         for (++hitIter; hitIter != hits.end(); ++hitIter)
+         {
+            if (topHeight - hitIter->getWorldIntersectPoint().z() > mMinClearance)
+            {
+               multiSurface[k] = 1;
+               break;
+            }
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TerrainElevationRaster::FinishTile(Tile& tile, const std::vector<unsigned char>& multiSurface)
+   {
+      tile.resize(mNumLevels);
+
+      Level& base = tile[0];
+      unsigned numPoints = base.mNumPoints;
+      unsigned numCells = numPoints - 1;
+      base.mComplex.assign(numCells * numCells, 0);
+      for (unsigned j = 0; j < numCells; ++j)
+      {
+         for (unsigned i = 0; i < numCells; ++i)
+         {
+            unsigned index = j * numPoints + i;
+            unsigned corners[4] = { index, index + 1, index + numPoints, index + numPoints + 1 };
+            float minHeight = FLT_MAX, maxHeight = -FLT_MAX;
+            bool complex = false;
+            for (unsigned c = 0; c < 4; ++c)
+            {
+               float height = base.mHeights[corners[c]];
+               complex = complex || multiSurface[corners[c]] != 0;
+               if (height != NO_HEIGHT)
+               {
+                  minHeight = std::min(minHeight, height);
+                  maxHeight = std::max(maxHeight, height);
+               }
+            }
+            if (complex || (maxHeight >= minHeight && maxHeight - minHeight > mMaxStep))
+            {
+               base.mComplex[j * numCells + i] = 1;
+            }
+         }
+      }
+
+      // Each coarser level keeps every other sample, and a cell is complex if any of the cells it covers are.
+      for (unsigned l = 1; l < mNumLevels; ++l)
+      {
+         const Level& finer = tile[l - 1];
+         Level& coarser = tile[l];
+         coarser.mNumPoints = (finer.mNumPoints - 1) / 2 + 1;
+         coarser.mSpacing = finer.mSpacing * 2.0f;
+         coarser.mHeights.resize(coarser.mNumPoints * coarser.mNumPoints);
+         for (unsigned j = 0; j < coarser.mNumPoints; ++j)
+         {
+            for (unsigned i = 0; i < coarser.mNumPoints; ++i)
+            {
+               coarser.mHeights[j * coarser.mNumPoints + i] = finer.mHeights[2 * j * finer.mNumPoints + 2 * i];
+            }
+         }
+
+         unsigned finerCells = finer.mNumPoints - 1;
+         unsigned coarserCells = coarser.mNumPoints - 1;
+         coarser.mComplex.assign(coarserCells * coarserCells, 0);
+         for (unsigned j = 0; j < coarserCells; ++j)
+         {
+            for (unsigned i = 0; i < coarserCells; ++i)
+            {
+               unsigned index = 2 * j * finerCells + 2 * i;
+               if (finer.mComplex[index] || finer.mComplex[index + 1]
+                        || finer.mComplex[index + finerCells] || finer.mComplex[index + finerCells + 1])
+               {
+                  coarser.mComplex[j * coarserCells + i] = 1;
+               }
+            }
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TerrainElevationRaster::SaveTile(unsigned tileX, unsigned tileY, const Tile& tile,
+            const std::vector<unsigned char>& multiSurface) const
+   {
+      std::string fileName = GetTileCacheFile(tileX, tileY);
+      try
+      {
+         dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+         if (!fileUtils.DirExists(mCacheDirectory))
+         {
+            fileUtils.MakeDirectory(mCacheDirectory);
+         }
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         LOG_INFO("Unable to make the terrain elevation cache directory \"" + mCacheDirectory + "\": " + ex.What());
+         return false;
+      }
+
+      const Level& base = tile[0];
+      dtUtil::DataStream ds;
+      ds.SetForceLittleEndian(true);
+      ds << CACHE_FILE_MAGIC;
+      ds << CACHE_FILE_VERSION;
+      ds << mCacheKey;
+      ds << mCellSize;
+      ds << mTileCells;
+      ds << mMinClearance;
+      ds << mBounds.xMin();
+      ds << mBounds.yMin();
+      ds << base.mNumPoints;
+      for (unsigned k = 0; k < base.mHeights.size(); ++k)
+      {
+         ds << base.mHeights[k];
+         ds << multiSurface[k];
+      }
+
+      std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!out.is_open())
+      {
+         LOG_INFO("Unable to write the terrain elevation cache \"" + fileName + "\".");
+         return false;
+      }
+
+      out.write(ds.GetBuffer(), ds.GetBufferSize());
+      return out.good();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TerrainElevationRaster::LoadTile(unsigned tileX, unsigned tileY, Tile& tile, std::vector<unsigned char>& multiSurface) const
+   {
+      std::string fileName = GetTileCacheFile(tileX, tileY);
+      if (fileName.empty())
+      {
+         return false;
+      }
+
+      std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+      if (!in.is_open())
+      {
+         return false;
+      }
+
+      // Read it all at once and decode from memory.
+      in.seekg(0, std::ios::end);
+      std::streamoff fileSize = in.tellg();
+      in.seekg(0, std::ios::beg);
+      if (fileSize <= 0)
+      {
+         return false;
+      }
+
+      std::vector<char> buffer(size_t(fileSize));
+      if (!in.read(&buffer[0], fileSize))
+      {
+         return false;
+      }
+
+      dtUtil::DataStream ds(&buffer[0], unsigned(buffer.size()), false);
+      ds.SetForceLittleEndian(true);
+
+      try
+      {
+         unsigned magic = 0, version = 0, tileCells = 0, numPoints = 0;
+         std::string key;
+         float cellSize = 0.0f, minClearance = 0.0f, originX = 0.0f, originY = 0.0f;
+         ds >> magic;
+         ds >> version;
+         if (magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION)
+         {
+            return false;
+         }
+
+         ds >> key;
+         ds >> cellSize;
+         ds >> tileCells;
+         ds >> minClearance;
+         ds >> originX;
+         ds >> originY;
+         ds >> numPoints;
+         if (key != mCacheKey || cellSize != mCellSize || tileCells != mTileCells || minClearance != mMinClearance
+                  || originX != mBounds.xMin() || originY != mBounds.yMin() || numPoints != mTileCells + 1)
+         {
+            LOG_DEBUG("The terrain elevation cache \"" + fileName + "\" is for another terrain or grid.");
+            return false;
+         }
+
+         Tile loaded(1);
+         Level& base = loaded[0];
+         base.mNumPoints = numPoints;
+         base.mSpacing = mCellSize;
+         base.mHeights.resize(numPoints * numPoints);
+         std::vector<unsigned char> loadedMultiSurface(numPoints * numPoints);
+         for (unsigned k = 0; k < base.mHeights.size(); ++k)
+         {
+            ds >> base.mHeights[k];
+            ds >> loadedMultiSurface[k];
+         }
+
+         tile.swap(loaded);
+         multiSurface.swap(loadedMultiSurface);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         std::ostringstream ss;
+         ss << "Failure decoding the terrain elevation cache \"" << fileName << "\": " << ex.What();
+         LOG_WARNING(ss.str());
+         return false;
+      }
+
+      return true;
+   }
+}
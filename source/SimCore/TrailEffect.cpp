@@ -34,6 +34,7 @@
 #include <dtCore/shaderparamfloat.h>
 #include <dtCore/transform.h>
 #include <SimCore/TrailEffect.h>
+#include <SimCore/TrailEffectBatch.h>
 
 
 
@@ -49,6 +50,7 @@ namespace SimCore
       : mCurrentIndex(0)
       , mSegmentCount(0)
       , mWidth(DEFAULT_WIDTH)
+      , mBatchTrailId(TrailEffectBatch::INVALID_TRAIL)
    {
       // This will force build the drawable, if the entered value is valid.
       SetSegmentCount(segmentCount);
@@ -57,6 +59,10 @@ namespace SimCore
    /////////////////////////////////////////////////////////////////////////////
    TrailEffect::~TrailEffect()
    {
+      if (mBatch.valid())
+      {
+         mBatch->RemoveTrail(mBatchTrailId);
+      }
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -65,7 +71,10 @@ namespace SimCore
       if(segmentCount >= 1)
       {
          mSegmentCount = segmentCount;
-         BuildDrawable();
+         if ( ! mBatch.valid())
+         {
+            BuildDrawable();
+         }
       }
    }
    
@@ -79,6 +88,10 @@ namespace SimCore
    void TrailEffect::SetWidth(float width)
    {
       mWidth = width;
+      if (mBatch.valid())
+      {
+         mBatch->SetTrailWidth(mBatchTrailId, width);
+      }
       SetFloatParameter("trailWidth", width);
    }
 
@@ -91,6 +104,13 @@ namespace SimCore
    /////////////////////////////////////////////////////////////////////////////
    void TrailEffect::SetNextPoint(const osg::Vec3& worldPoint)
    {
+      // The batch queues the point and updates all its trails in one pass.
+      if (mBatch.valid())
+      {
+         mBatch->SetNextPoint(mBatchTrailId, worldPoint);
+         return;
+      }
+
       if( ! mGeom.valid())
       {
          return;
@@ -162,7 +182,15 @@ namespace SimCore
    /////////////////////////////////////////////////////////////////////////////
    void TrailEffect::ResetPoints()
    {
-      if(mGeom.valid())
+      if (mBatch.valid())
+      {
+         dtCore::Transform xform;
+         GetTransform(xform);
+         osg::Vec3 pos;
+         xform.GetTranslation(pos);
+         mBatch->ResetPoints(mBatchTrailId, pos);
+      }
+      else if(mGeom.valid())
       {
          // Get this object's current position.
          dtCore::Transform xform;
@@ -272,6 +300,19 @@ namespace SimCore
       mCurrentIndex = 0;
       if(mGeom.valid())
       {
+         // Remove the old geode so rebuilding doesn't leave a stale copy drawing.
+         while (mGeom->getNumParents() > 0)
+         {
+            dtCore::RefPtr<osg::Node> parent = mGeom->getParent(0);
+            GetMatrixNode()->removeChild(parent.get());
+            osg::Geode* geode = parent->asGeode();
+            if (geode == NULL)
+            {
+               break;
+            }
+            geode->removeDrawable(mGeom.get());
+         }
+
          mGeom->setTexCoordArray(0, NULL);
          mGeom->setColorArray(NULL);
          mGeom->setNormalArray(NULL);
@@ -285,6 +326,44 @@ namespace SimCore
       mShader = NULL;
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffect::SetBatch(TrailEffectBatch* batch)
+   {
+      if (mBatch.get() == batch)
+      {
+         return;
+      }
+
+      if (mBatch.valid())
+      {
+         mBatch->RemoveTrail(mBatchTrailId);
+         mBatchTrailId = TrailEffectBatch::INVALID_TRAIL;
+      }
+
+      mBatch = batch;
+
+      if (batch != NULL)
+      {
+         ClearDrawable();
+
+         dtCore::Transform xform;
+         GetTransform(xform);
+         osg::Vec3 pos;
+         xform.GetTranslation(pos);
+         mBatchTrailId = batch->AddTrail(pos, mWidth);
+      }
+      else
+      {
+         BuildDrawable();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TrailEffectBatch* TrailEffect::GetBatch()
+   {
+      return mBatch.get();
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    void TrailEffect::SetFloatParameter(const std::string& paramName, float value)
    {
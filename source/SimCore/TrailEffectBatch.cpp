@@ -0,0 +1,545 @@
+/* -*-c++-*-
+ * Simulation Core
+ * Copyright 2009, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+#include <prefix/SimCorePrefix.h>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/NodeCallback>
+#include <osg/StateSet>
+#include <osg/Timer>
+#include <OpenThreads/Atomic>
+#include <dtCore/observerptr.h>
+#include <dtCore/shadermanager.h>
+#include <dtCore/shaderprogram.h>
+#include <dtUtil/log.h>
+#include <SimCore/TrailEffectBatch.h>
+#include <SimCore/FrameProfiler.h>
+
+
+
+namespace SimCore
+{
+   /////////////////////////////////////////////////////////////////////////////
+   // UPDATE CALLBACK
+   /////////////////////////////////////////////////////////////////////////////
+   class TrailEffectBatchUpdateCallback : public osg::NodeCallback
+   {
+      public:
+         TrailEffectBatchUpdateCallback(TrailEffectBatch& batch)
+            : mBatch(&batch)
+         {
+         }
+
+         virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+         {
+            if (mBatch.valid())
+            {
+               mBatch->Update();
+            }
+            traverse(node, nv);
+         }
+
+      private:
+         dtCore::ObserverPtr<TrailEffectBatch> mBatch;
+   };
+
+
+
+   /////////////////////////////////////////////////////////////////////////////
+   // DRAW COUNTER
+   /////////////////////////////////////////////////////////////////////////////
+   // Counts the draws of the shared geometry, which may happen on the draw thread.
+   class TrailEffectBatchDrawCounter : public osg::Drawable::DrawCallback
+   {
+      public:
+         virtual void drawImplementation(osg::RenderInfo& renderInfo, const osg::Drawable* drawable) const
+         {
+            ++mCount;
+            drawable->drawImplementation(renderInfo);
+         }
+
+         /// @return the number of draws since the last call.
+         unsigned TakeCount()
+         {
+            return mCount.exchange(0);
+         }
+
+      private:
+         mutable OpenThreads::Atomic mCount;
+   };
+
+
+
+   /////////////////////////////////////////////////////////////////////////////
+   // CODE
+   /////////////////////////////////////////////////////////////////////////////
+   TrailEffectBatch::FrameStats::FrameStats()
+      : mActiveTrails(0)
+      , mUpdatedTrails(0)
+      , mPointsApplied(0)
+      , mDrawCalls(0)
+      , mVerticesUploaded(0)
+      , mUpdateTimeMS(0.0)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TrailEffectBatch::TrailSlot::TrailSlot()
+      : mActive(false)
+      , mReset(false)
+      , mDirty(false)
+      , mCurrentIndex(0)
+      , mWidth(1.0f)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TrailEffectBatch::TrailEffectBatch(int segmentCount, int initialCapacity)
+      : mSegmentCount(segmentCount < 1 ? 1 : segmentCount)
+      , mNumActive(0)
+   {
+      BuildDrawable();
+      Grow(initialCapacity < 1 ? 1 : initialCapacity);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   TrailEffectBatch::~TrailEffectBatch()
+   {
+      GetMatrixNode()->setUpdateCallback(NULL);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   int TrailEffectBatch::GetSegmentCount() const
+   {
+      return mSegmentCount;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   int TrailEffectBatch::GetCapacity() const
+   {
+      return int(mSlots.size());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   int TrailEffectBatch::GetNumActiveTrails() const
+   {
+      return mNumActive;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   int TrailEffectBatch::VertsPerTrail() const
+   {
+      return (mSegmentCount + 1) * 2;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   int TrailEffectBatch::IndicesPerTrail() const
+   {
+      // Two triangles per segment.
+      return mSegmentCount * 6;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   int TrailEffectBatch::AddTrail(const osg::Vec3& startPoint, float width)
+   {
+      if (mFreeSlots.empty())
+      {
+         Grow(GetCapacity() * 2);
+      }
+
+      int trailId = mFreeSlots.back();
+      mFreeSlots.pop_back();
+
+      TrailSlot& slot = mSlots[trailId];
+      slot.mActive = true;
+      slot.mWidth = width;
+      slot.mPendingPoints.clear();
+      ResetPoints(trailId, startPoint);
+
+      ++mNumActive;
+      return trailId;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::RemoveTrail(int trailId)
+   {
+      if (!IsTrailActive(trailId))
+      {
+         return;
+      }
+
+      TrailSlot& slot = mSlots[trailId];
+      slot.mActive = false;
+      slot.mReset = false;
+      slot.mPendingPoints.clear();
+      if (!slot.mDirty)
+      {
+         slot.mDirty = true;
+         mDirtySlots.push_back(trailId);
+      }
+
+      mFreeSlots.push_back(trailId);
+      --mNumActive;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool TrailEffectBatch::IsTrailActive(int trailId) const
+   {
+      return trailId >= 0 && trailId < GetCapacity() && mSlots[trailId].mActive;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::SetTrailWidth(int trailId, float width)
+   {
+      if (IsTrailActive(trailId))
+      {
+         TrailSlot& slot = mSlots[trailId];
+         slot.mWidth = width;
+         if (!slot.mDirty)
+         {
+            slot.mDirty = true;
+            mDirtySlots.push_back(trailId);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   float TrailEffectBatch::GetTrailWidth(int trailId) const
+   {
+      return IsTrailActive(trailId) ? mSlots[trailId].mWidth : 0.0f;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::SetNextPoint(int trailId, const osg::Vec3& worldPoint)
+   {
+      if (IsTrailActive(trailId))
+      {
+         TrailSlot& slot = mSlots[trailId];
+         slot.mPendingPoints.push_back(worldPoint);
+         if (!slot.mDirty)
+         {
+            slot.mDirty = true;
+            mDirtySlots.push_back(trailId);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::ResetPoints(int trailId, const osg::Vec3& worldPoint)
+   {
+      if (IsTrailActive(trailId))
+      {
+         TrailSlot& slot = mSlots[trailId];
+         // Points queued before the reset no longer matter.
+         slot.mPendingPoints.clear();
+         slot.mReset = true;
+         slot.mResetPoint = worldPoint;
+         if (!slot.mDirty)
+         {
+            slot.mDirty = true;
+            mDirtySlots.push_back(trailId);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::Update()
+   {
+      SIMCORE_PROFILE_SCOPE("TrailEffectBatch::Update");
+      osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+      mStats = FrameStats();
+      mStats.mActiveTrails = unsigned(mNumActive);
+
+      int vertsPerTrail = VertsPerTrail();
+      std::vector<int>::const_iterator i, iend = mDirtySlots.end();
+      for (i = mDirtySlots.begin(); i != iend; ++i)
+      {
+         int trailId = *i;
+         TrailSlot& slot = mSlots[trailId];
+         slot.mDirty = false;
+
+         if (!slot.mActive)
+         {
+            ClearSlotIndices(trailId);
+            continue;
+         }
+
+         if (slot.mReset)
+         {
+            ApplyReset(trailId, slot.mResetPoint);
+            slot.mReset = false;
+         }
+
+         int numPoints = int(slot.mPendingPoints.size());
+         for (int p = 0; p < numPoints; ++p)
+         {
+            ApplyPoint(trailId, slot.mPendingPoints[p]);
+         }
+         slot.mPendingPoints.clear();
+         mStats.mPointsApplied += unsigned(numPoints);
+
+         // The width is per vertex so that all the trails can share one shader.
+         int base = trailId * vertsPerTrail;
+         for (int v = base; v < base + vertsPerTrail; ++v)
+         {
+            (*mTexCoords)[v].z() = slot.mWidth;
+         }
+
+         WriteSlotIndices(trailId);
+         ++mStats.mUpdatedTrails;
+      }
+
+      if (!mDirtySlots.empty())
+      {
+         mDirtySlots.clear();
+
+         // Dirty each shared array once, no matter how many trails changed.
+         mVerts->dirty();
+         mData->dirty();
+         mTexCoords->dirty();
+         mIndices->dirty();
+         mGeom->dirtyBound();
+         mStats.mVerticesUploaded = unsigned(mVerts->size());
+      }
+
+      // Skip the draw entirely if there is nothing to show.
+      mGeode->setNodeMask(mNumActive > 0 ? 0xFFFFFFFF : 0x0);
+      mStats.mDrawCalls = mDrawCounter->TakeCount();
+
+      mStats.mUpdateTimeMS = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+
+      SIMCORE_PROFILE_COUNT("TrailEffectBatch::ActiveTrails", mStats.mActiveTrails);
+      SIMCORE_PROFILE_COUNT("TrailEffectBatch::UpdatedTrails", mStats.mUpdatedTrails);
+      SIMCORE_PROFILE_COUNT("TrailEffectBatch::PointsApplied", mStats.mPointsApplied);
+      SIMCORE_PROFILE_COUNT("TrailEffectBatch::DrawCalls", mStats.mDrawCalls);
+      SIMCORE_PROFILE_COUNT("TrailEffectBatch::VerticesUploaded", mStats.mVerticesUploaded);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const TrailEffectBatch::FrameStats& TrailEffectBatch::GetLastFrameStats() const
+   {
+      return mStats;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   osg::Geometry* TrailEffectBatch::GetGeometry()
+   {
+      return mGeom.get();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const osg::Geometry* TrailEffectBatch::GetGeometry() const
+   {
+      return mGeom.get();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::ApplyPoint(int trailId, const osg::Vec3& worldPoint)
+   {
+      TrailSlot& slot = mSlots[trailId];
+
+      // Same ring buffer scheme as TrailEffect, offset to this trail's slot.
+      int base = trailId * VertsPerTrail();
+      int numPoints = mSegmentCount + 1;
+      int v0 = base + slot.mCurrentIndex * 2;
+      int v1 = v0 + 1;
+
+      // The last vertex data element will maintain the vector pointing to
+      // the new point.
+      osg::Vec3 vecToNewPoint(worldPoint - (*mVerts)[v0]);
+      osg::Vec4 lastData0(vecToNewPoint.x(), vecToNewPoint.y(), vecToNewPoint.z(), 1.0f);
+      (*mData)[v0] = lastData0;
+      (*mData)[v1] = lastData0;
+      (*mData)[v1].w() = -1.0f;
+
+      // Wrap the index if it exceeds the trail's vertices.
+      slot.mCurrentIndex = (slot.mCurrentIndex + 1) % numPoints;
+
+      v0 = base + slot.mCurrentIndex * 2;
+      v1 = v0 + 1;
+
+      // The new point vertex data will have the same vector as the previous element,
+      // so that vertex pair for the new point can be displaced appropriately.
+      (*mData)[v0] = lastData0;
+      (*mData)[v1] = lastData0;
+      (*mData)[v1].w() = -1.0f;
+
+      (*mVerts)[v0].set(worldPoint);
+      (*mVerts)[v1].set(worldPoint);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::ApplyReset(int trailId, const osg::Vec3& worldPoint)
+   {
+      mSlots[trailId].mCurrentIndex = 0;
+
+      int base = trailId * VertsPerTrail();
+      for (int v = base; v < base + VertsPerTrail(); v += 2)
+      {
+         (*mVerts)[v] = worldPoint;
+         (*mVerts)[v + 1] = worldPoint;
+         (*mData)[v].set(0.0f, 0.0f, 0.0f, 1.0f);
+         (*mData)[v + 1].set(0.0f, 0.0f, 0.0f, -1.0f);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::WriteSlotIndices(int trailId)
+   {
+      int numPoints = mSegmentCount + 1;
+      int base = trailId * VertsPerTrail();
+      int current = mSlots[trailId].mCurrentIndex;
+      unsigned* indices = &(*mIndices)[trailId * IndicesPerTrail()];
+
+      // Walk from the newest vertex pair back to the oldest, two triangles per segment.
+      for (int k = 0; k < mSegmentCount; ++k)
+      {
+         unsigned a0 = unsigned(base + ((current - k + numPoints) % numPoints) * 2);
+         unsigned a1 = unsigned(base + ((current - k - 1 + numPoints) % numPoints) * 2);
+
+         *indices++ = a0;
+         *indices++ = a0 + 1;
+         *indices++ = a1;
+
+         *indices++ = a0 + 1;
+         *indices++ = a1 + 1;
+         *indices++ = a1;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::ClearSlotIndices(int trailId)
+   {
+      unsigned base = unsigned(trailId * VertsPerTrail());
+      int start = trailId * IndicesPerTrail();
+      int end = start + IndicesPerTrail();
+      for (int i = start; i < end; ++i)
+      {
+         (*mIndices)[i] = base;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::Grow(int newCapacity)
+   {
+      int oldCapacity = GetCapacity();
+      if (newCapacity <= oldCapacity)
+      {
+         return;
+      }
+
+      int vertsPerTrail = VertsPerTrail();
+      mSlots.resize(newCapacity);
+      mVerts->resize(newCapacity * vertsPerTrail);
+      mData->resize(newCapacity * vertsPerTrail);
+      mNormals->resize(newCapacity * vertsPerTrail, osg::Vec3(0.0f, 0.0f, 1.0f));
+      mTexCoords->resize(newCapacity * vertsPerTrail);
+      mIndices->resize(newCapacity * IndicesPerTrail());
+
+      float uStep = 1.0f / float(mSegmentCount);
+      for (int trailId = oldCapacity; trailId < newCapacity; ++trailId)
+      {
+         int base = trailId * vertsPerTrail;
+         float uCoord = 0.0f;
+         for (int v0 = base, v1 = base + 1; v1 < base + vertsPerTrail; v0 += 2, v1 += 2)
+         {
+            (*mTexCoords)[v0].set(uCoord, 1.0f, 0.0f);
+            (*mTexCoords)[v1].set(uCoord, 0.0f, 0.0f);
+            (*mData)[v0].set(0.0f, 0.0f, 0.0f, 1.0f);
+            (*mData)[v1].set(0.0f, 0.0f, 0.0f, -1.0f);
+            uCoord += uStep;
+         }
+         ClearSlotIndices(trailId);
+      }
+
+      // Hand out the lowest slots first.
+      for (int trailId = newCapacity - 1; trailId >= oldCapacity; --trailId)
+      {
+         mFreeSlots.push_back(trailId);
+      }
+
+      mVerts->dirty();
+      mData->dirty();
+      mNormals->dirty();
+      mTexCoords->dirty();
+      mIndices->dirty();
+      mGeom->dirtyBound();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void TrailEffectBatch::BuildDrawable()
+   {
+      mVerts = new osg::Vec3Array;
+      mData = new osg::Vec4Array;
+      mNormals = new osg::Vec3Array;
+      mTexCoords = new osg::Vec3Array;
+      mIndices = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES);
+
+      // STATES
+      dtCore::RefPtr<osg::StateSet> states = GetOSGNode()->getOrCreateStateSet();
+      states->setMode(GL_BLEND,osg::StateAttribute::ON);
+      states->setMode(GL_LIGHTING,osg::StateAttribute::OFF);
+      states->setRenderingHint( osg::StateSet::TRANSPARENT_BIN );
+
+      // GEOMETRY - the arrays change every frame, so keep them in buffer objects.
+      mGeom = new osg::Geometry;
+      mGeom->setDataVariance(osg::Object::DYNAMIC);
+      mGeom->setUseDisplayList(false);
+      mGeom->setUseVertexBufferObjects(true);
+      mGeom->addPrimitiveSet(mIndices.get());
+      mGeom->setColorArray(mData.get()); // use colors for uvs and other parameters
+      mGeom->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+      mGeom->setNormalArray(mNormals.get());
+      mGeom->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+      mGeom->setVertexArray(mVerts.get());
+      mGeom->setTexCoordArray(0, mTexCoords.get());
+      mDrawCounter = new TrailEffectBatchDrawCounter;
+      mGeom->setDrawCallback(mDrawCounter.get());
+
+      // GEODE (GEOMETRY NODE)
+      mGeode = new osg::Geode;
+      mGeode->addDrawable(mGeom.get());
+      mGeode->setNodeMask(0x0);
+      GetMatrixNode()->addChild(mGeode.get());
+
+      // The callback goes above the geode, since the geode is masked off when there are no trails.
+      GetMatrixNode()->setUpdateCallback(new TrailEffectBatchUpdateCallback(*this));
+
+      // Attach the shader
+      dtCore::RefPtr<dtCore::ShaderProgram> protoShader
+         = dtCore::ShaderManager::GetInstance().FindShaderPrototype("TrailEffectBatchShader","TrailEffectShaderGroup");
+      if(protoShader.valid())
+      {
+         mShader = dtCore::ShaderManager::GetInstance().AssignShaderFromPrototype(*protoShader, *GetOSGNode());
+
+         if( ! mShader.valid())
+         {
+            LOG_ERROR("Could not create and attach trail effect batch shader.");
+         }
+      }
+   }
+}
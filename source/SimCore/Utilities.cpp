@@ -28,6 +28,7 @@
 
 #include <SimCore/IGExceptionEnum.h>
 #include <SimCore/BaseGameEntryPoint.h>
+#include <SimCore/Actors/TerrainActorProxy.h>
 #include <dtABC/application.h>
 #include <dtCore/project.h>
 #include <dtUtil/stringutils.h>
@@ -194,6 +195,32 @@ namespace Utils
       osg::Vec3 pos;
       xform.GetTranslation(pos);
 
+      float startZ = pos.z() - (underearth ? maxDepthBelow : 1000.0f);
+      float endZ = pos.z() + (tooHigh ? maxHeightAbove : 1000.0f);
+
+      // Open terrain has one surface, so the raster height is the only hit the isector would find.
+      SimCore::Actors::TerrainActor* terrain = dynamic_cast<SimCore::Actors::TerrainActor*>(&terrainActor);
+      TerrainElevationRaster* raster = terrain != NULL ? terrain->GetElevationRaster() : NULL;
+      float rasterHeight = 0.0f;
+      if (raster != NULL && raster->GetHeight(pos.x(), pos.y(), rasterHeight) == TerrainElevationRaster::OPEN_TERRAIN)
+      {
+         if (rasterHeight < startZ || rasterHeight > endZ)
+         {
+            // Can't do anything if there is no ground
+            return false;
+         }
+
+         underearth = underearth && !(pos.z() + maxDepthBelow > rasterHeight);
+         tooHigh = tooHigh && !(pos.z() - maxHeightAbove < rasterHeight);
+         if (underearth || tooHigh)
+         {
+            pos.z() = rasterHeight + dropHeight;
+            xform.SetTranslation(pos);
+            return true;
+         }
+         return false;
+      }
+
       osg::Vec3 hp;
       dtCore::RefPtr<dtCore::BatchIsector> iSector = new dtCore::BatchIsector();
       //iSector->SetScene( &GetGameActorProxy().GetGameManager()->GetScene() );
@@ -201,8 +228,8 @@ namespace Utils
       dtCore::BatchIsector::SingleISector& SingleISector = iSector->EnableAndGetISector(0);
       osg::Vec3 endPos = pos;
       osg::Vec3 startPos = pos;
-      startPos[2] -= underearth ? maxDepthBelow : 1000.0f;
-      endPos[2] += tooHigh ? maxHeightAbove : 1000.0f;
+      startPos[2] = startZ;
+      endPos[2] = endZ;
       float offsettodo = maxDepthBelow;
       float tooHighOffset = maxHeightAbove;
       SingleISector.SetSectorAsLineSegment(startPos, endPos);
@@ -281,6 +308,43 @@ namespace Utils
    ///////////////////////////////////////////////////////////////////////////////////
    bool KeepBodyOnGround(dtPhysics::TransformType& transformToUpdate, float bodyHeight, float dropHeight,
             float maxDepthBelow, float maxHeightAbove, float testRange, dtPhysics::CollisionGroupFilter collisionFlags)
+   {
+      dtPhysics::VectorType pos;
+      transformToUpdate.GetTranslation(pos);
+
+      dtPhysics::RayCast ray;
+      SetupKeepOnGroundRay(ray, pos, testRange, collisionFlags);
+
+      std::vector<dtPhysics::RayCast::Report> hits;
+      hits.reserve(10);
+      dtPhysics::PhysicsWorld::GetInstance().TraceRay(ray, hits, true);
+
+      return KeepBodyOnGroundFromHits(transformToUpdate, hits, bodyHeight, dropHeight, maxDepthBelow, maxHeightAbove, testRange);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void SetupKeepOnGroundRay(dtPhysics::RayCast& ray, const dtPhysics::VectorType& pos, float testRange,
+            dtPhysics::CollisionGroupFilter collisionFlags)
+   {
+      if (testRange <= 0.0f)
+      {
+         testRange = 1000.0f;
+      }
+
+      osg::Vec3 endPos = pos;
+      osg::Vec3 startPos = pos;
+      startPos[2] -= testRange / 2.0f;
+      endPos[2] += testRange / 2.0f;
+
+      ray.SetCollisionGroupFilter(collisionFlags);
+      ray.SetOrigin(startPos);
+      ray.SetDirection(endPos - startPos);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool KeepBodyOnGroundFromHits(dtPhysics::TransformType& transformToUpdate,
+            const std::vector<dtPhysics::RayCast::Report>& hits, float bodyHeight, float dropHeight,
+            float maxDepthBelow, float maxHeightAbove, float testRange)
    {
       // assume we are under earth unless we get proof otherwise.
       // because some checks could THINK we are under earth, especially if you drive / move
@@ -299,22 +363,9 @@ namespace Utils
       osg::Vec3 normal(0.0, 0.0, 1.0);
 
       osg::Vec3 hp;
-      osg::Vec3 endPos = pos;
-      osg::Vec3 startPos = pos;
-      startPos[2] -= testRange / 2.0f;
-      endPos[2] += testRange / 2.0f;
       float offsettodo = maxDepthBelow;
       float tooHighOffset = maxHeightAbove;
 
-      dtPhysics::RayCast ray;
-      ray.SetCollisionGroupFilter(collisionFlags);
-      ray.SetOrigin(startPos);
-      ray.SetDirection(endPos - startPos);
-
-      std::vector<dtPhysics::RayCast::Report> hits;
-      hits.reserve(10);
-      dtPhysics::PhysicsWorld::GetInstance().TraceRay(ray, hits, true);
-
       if (!hits.empty())
       {
          float shortestDistance = testRange;
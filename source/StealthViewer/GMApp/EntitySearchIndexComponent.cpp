@@ -0,0 +1,328 @@
+/* -*-c++-*-
+* Simulation Core
+* Copyright 2007-2008, Alion Science and Technology
+*
+* This library is free software; you can redistribute it and/or modify it under
+* the terms of the GNU Lesser General Public License as published by the Free
+* Software Foundation; either version 2.1 of the License, or (at your option)
+* any later version.
+*
+* This library is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+* details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this library; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+ */
+#include <prefix/SimCorePrefix.h>
+
+#include <StealthViewer/GMApp/EntitySearchIndexComponent.h>
+
+#include <SimCore/Actors/BaseEntity.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/message.h>
+
+namespace StealthGM
+{
+   const dtCore::RefPtr<dtCore::SystemComponentType> EntitySearchIndexComponent::TYPE(new dtCore::SystemComponentType("EntitySearchIndexComponent", "GMComponents.SimCore.StealthGM",
+         "Indexes entity call signs for searching and attach cycling.", BaseClass::BaseGMComponentType));
+   const std::string EntitySearchIndexComponent::DEFAULT_NAME(EntitySearchIndexComponent::TYPE->GetName());
+
+   /////////////////////////////////////////////////////////////////////////
+   EntitySearchIndexComponent::EntitySearchIndexComponent(dtCore::SystemComponentType& type)
+      : dtGame::GMComponent(type)
+   {
+      SetName(DEFAULT_NAME);
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   EntitySearchIndexComponent::~EntitySearchIndexComponent()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::OnAddedToGM()
+   {
+      BaseClass::OnAddedToGM();
+      Rebuild();
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::OnRemovedFromGM()
+   {
+      Clear();
+      BaseClass::OnRemovedFromGM();
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::ProcessMessage(const dtGame::Message& msg)
+   {
+      const dtGame::MessageType& msgType = msg.GetMessageType();
+
+      if (msgType == dtGame::MessageType::INFO_ACTOR_CREATED
+         || msgType == dtGame::MessageType::INFO_ACTOR_UPDATED)
+      {
+         // Name changes are rare, so only look the actor up when the index can't answer.
+         IdToEntryMap::const_iterator found = mIdToEntry.find(msg.GetAboutActorId());
+         if (found == mIdToEntry.end() || msgType == dtGame::MessageType::INFO_ACTOR_CREATED
+            || !mEntries[found->second].mActor.valid()
+            || mEntries[found->second].mActor->GetName() != mEntries[found->second].mName)
+         {
+            dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(msg.GetAboutActorId());
+            if (actor != NULL)
+            {
+               IndexActor(*actor);
+            }
+         }
+      }
+      else if (msgType == dtGame::MessageType::INFO_ACTOR_DELETED)
+      {
+         RemoveActor(msg.GetAboutActorId());
+      }
+      else if (msgType == dtGame::MessageType::INFO_MAP_LOADED)
+      {
+         Rebuild();
+      }
+      else if (msgType == dtGame::MessageType::INFO_MAP_UNLOADED)
+      {
+         Clear();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::Rebuild()
+   {
+      Clear();
+
+      if (GetGameManager() == NULL)
+         return;
+
+      std::vector<dtGame::GameActorProxy*> allProxies;
+      GetGameManager()->GetAllGameActors(allProxies);
+      mEntries.reserve(allProxies.size());
+
+      for (size_t i = 0; i < allProxies.size(); ++i)
+      {
+         IndexActor(*allProxies[i]);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::Clear()
+   {
+      mEntries.clear();
+      mIdToEntry.clear();
+      mNameIndex.clear();
+      mTrigramIndex.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   bool EntitySearchIndexComponent::IndexActor(dtGame::GameActorProxy& actor)
+   {
+      IdToEntryMap::iterator found = mIdToEntry.find(actor.GetId());
+      if (found != mIdToEntry.end())
+      {
+         IndexEntry& entry = mEntries[found->second];
+         entry.mActor = &actor;
+         if (entry.mName != actor.GetName())
+         {
+            RemoveNameKeys(entry);
+            entry.mName = actor.GetName();
+            AddNameKeys(entry);
+         }
+         return true;
+      }
+
+      // Could be the environment actor proxy or something. Skip it
+      if (dynamic_cast<SimCore::Actors::BaseEntityActorProxy*>(&actor) == NULL)
+         return false;
+
+      IndexEntry entry;
+      entry.mId = actor.GetId();
+      entry.mName = actor.GetName();
+      entry.mActor = &actor;
+
+      mIdToEntry.insert(std::make_pair(entry.mId, unsigned(mEntries.size())));
+      mEntries.push_back(entry);
+      AddNameKeys(entry);
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::RemoveActor(const dtCore::UniqueId& id)
+   {
+      IdToEntryMap::iterator found = mIdToEntry.find(id);
+      if (found == mIdToEntry.end())
+         return;
+
+      unsigned index = found->second;
+      RemoveNameKeys(mEntries[index]);
+      mIdToEntry.erase(found);
+
+      // Swap the last entry into the hole to keep the array dense.
+      unsigned last = unsigned(mEntries.size() - 1);
+      if (index != last)
+      {
+         mEntries[index] = mEntries[last];
+         mIdToEntry[mEntries[index].mId] = index;
+      }
+      mEntries.pop_back();
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   unsigned EntitySearchIndexComponent::GetNumEntities() const
+   {
+      return unsigned(mEntries.size());
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   dtGame::GameActorProxy* EntitySearchIndexComponent::GetEntityAt(unsigned index) const
+   {
+      if (index >= mEntries.size())
+         return NULL;
+
+      return const_cast<dtGame::GameActorProxy*>(mEntries[index].mActor.get());
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   dtGame::GameActorProxy* EntitySearchIndexComponent::GetEntity(const dtCore::UniqueId& id) const
+   {
+      IdToEntryMap::const_iterator found = mIdToEntry.find(id);
+      if (found == mIdToEntry.end())
+         return NULL;
+
+      return GetEntityAt(found->second);
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::FindByPrefix(const std::string& prefix, std::vector<dtCore::UniqueId>& toFill, unsigned maxResults) const
+   {
+      unsigned numFound = 0;
+      NameIndex::const_iterator i = mNameIndex.lower_bound(prefix);
+      NameIndex::const_iterator iend = mNameIndex.end();
+      for (; i != iend && (maxResults == 0 || numFound < maxResults); ++i)
+      {
+         if (i->first.compare(0, prefix.size(), prefix) != 0)
+            break;
+
+         toFill.push_back(i->second);
+         ++numFound;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::FindBySubstring(const std::string& text, std::vector<dtCore::UniqueId>& toFill, unsigned maxResults) const
+   {
+      unsigned numFound = 0;
+
+      // Too short for a trigram, so just check the names directly.  It's still only the entities.
+      if (text.size() < 3)
+      {
+         EntryArray::const_iterator i = mEntries.begin(), iend = mEntries.end();
+         for (; i != iend && (maxResults == 0 || numFound < maxResults); ++i)
+         {
+            if (i->mName.find(text) != std::string::npos)
+            {
+               toFill.push_back(i->mId);
+               ++numFound;
+            }
+         }
+         return;
+      }
+
+      std::set<Trigram> trigrams;
+      GetTrigrams(text, trigrams);
+
+      // Every match must contain every trigram, so only the smallest posting set needs to be checked.
+      const std::set<dtCore::UniqueId>* candidates = NULL;
+      std::set<Trigram>::const_iterator t, tend = trigrams.end();
+      for (t = trigrams.begin(); t != tend; ++t)
+      {
+         TrigramIndex::const_iterator posting = mTrigramIndex.find(*t);
+         if (posting == mTrigramIndex.end())
+            return;
+
+         if (candidates == NULL || posting->second.size() < candidates->size())
+         {
+            candidates = &posting->second;
+         }
+      }
+
+      if (candidates == NULL)
+         return;
+
+      std::set<dtCore::UniqueId>::const_iterator c = candidates->begin(), cend = candidates->end();
+      for (; c != cend && (maxResults == 0 || numFound < maxResults); ++c)
+      {
+         IdToEntryMap::const_iterator found = mIdToEntry.find(*c);
+         if (found != mIdToEntry.end() && mEntries[found->second].mName.find(text) != std::string::npos)
+         {
+            toFill.push_back(*c);
+            ++numFound;
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::GetTrigrams(const std::string& name, std::set<Trigram>& toFill)
+   {
+      for (size_t i = 0; i + 3 <= name.size(); ++i)
+      {
+         Trigram t = (Trigram((unsigned char)name[i]) << 16)
+            | (Trigram((unsigned char)name[i + 1]) << 8)
+            | Trigram((unsigned char)name[i + 2]);
+         toFill.insert(t);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::AddNameKeys(const IndexEntry& entry)
+   {
+      mNameIndex.insert(std::make_pair(entry.mName, entry.mId));
+
+      std::set<Trigram> trigrams;
+      GetTrigrams(entry.mName, trigrams);
+      std::set<Trigram>::const_iterator i, iend = trigrams.end();
+      for (i = trigrams.begin(); i != iend; ++i)
+      {
+         mTrigramIndex[*i].insert(entry.mId);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////
+   void EntitySearchIndexComponent::RemoveNameKeys(const IndexEntry& entry)
+   {
+      std::pair<NameIndex::iterator, NameIndex::iterator> range = mNameIndex.equal_range(entry.mName);
+      for (NameIndex::iterator i = range.first; i != range.second; ++i)
+      {
+         if (i->second == entry.mId)
+         {
+            mNameIndex.erase(i);
+            break;
+         }
+      }
+
+      std::set<Trigram> trigrams;
+      GetTrigrams(entry.mName, trigrams);
+      std::set<Trigram>::const_iterator i, iend = trigrams.end();
+      for (i = trigrams.begin(); i != iend; ++i)
+      {
+         TrigramIndex::iterator posting = mTrigramIndex.find(*i);
+         if (posting != mTrigramIndex.end())
+         {
+            posting->second.erase(entry.mId);
+            if (posting->second.empty())
+            {
+               mTrigramIndex.erase(posting);
+            }
+         }
+      }
+   }
+}
@@ -26,6 +26,7 @@
 #include <StealthViewer/GMApp/StealthInputComponent.h>
 #include <StealthViewer/GMApp/StealthMessageProcessor.h>
 #include <StealthViewer/GMApp/ViewerConfigComponent.h>
+#include <StealthViewer/GMApp/EntitySearchIndexComponent.h>
 
 #include <dtCore/camera.h>
 #include <dtCore/system.h>
@@ -62,6 +63,7 @@
 #include <SimCore/Components/MunitionsComponent.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <SimCore/Components/ControlStateComponent.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
 #include <SimCore/Components/VolumeRenderingComponent.h>
 #include <SimCore/Tools/GPS.h>
 #include <SimCore/Tools/Compass.h>
@@ -70,6 +72,7 @@
 #include <SimCore/MessageType.h>
 #include <SimCore/WeaponTypeEnum.h>
 #include <SimCore/CollisionGroupEnum.h>
+#include <SimCore/StartupTracer.h>
 
 #include <SimCore/HLA/HLAConnectionComponent.h>
 
@@ -115,6 +118,8 @@ namespace StealthGM
       , mHasNightVis(false)
       , mHasMap(false)
    {
+      // The viewer draws many remote entities, so spread the deferrable work out unless the config says otherwise.
+      mDefaultFrameBudgetMillis = SimCore::Components::FrameBudgetComponent::DEFAULT_FRAME_BUDGET_MILLIS;
    }
 
    ///////////////////////////////////////////////////////////////////////////
@@ -296,7 +301,7 @@ namespace StealthGM
                                              *StealthInputComponent::TYPE,
                                              IsUIRunning());
 
-      gameManager.AddComponent(*mInputComponent, dtGame::GameManager::ComponentPriority::NORMAL);
+      AddTracedComponent(gameManager, *mInputComponent, dtGame::GameManager::ComponentPriority::NORMAL);
 
       // Capture HLA connection parameters for the input component to use later in record/playback
       // state swapping. Transitions to IDLE should join the network; PLAYBACK should leave
@@ -312,8 +317,8 @@ namespace StealthGM
          dtGame::BinaryLogStream *logStream = new dtGame::BinaryLogStream(gameManager.GetMessageFactory());
          mServerLogger = new dtGame::ServerLoggerComponent(*logStream);
          mLogController = new dtGame::LogController;
-         gameManager.AddComponent(*mServerLogger, dtGame::GameManager::ComponentPriority::NORMAL);
-         gameManager.AddComponent(*mLogController, dtGame::GameManager::ComponentPriority::NORMAL);
+         AddTracedComponent(gameManager, *mServerLogger, dtGame::GameManager::ComponentPriority::NORMAL);
+         AddTracedComponent(gameManager, *mLogController, dtGame::GameManager::ComponentPriority::NORMAL);
 
          // Set auto keyframe interval
          mLogController->RequestSetAutoKeyframeInterval(20.0f);
@@ -334,14 +339,17 @@ namespace StealthGM
                                *StealthHUD::TYPE,
                                IsUIRunning());
 
-      gameManager.AddComponent(*mHudGUI, dtGame::GameManager::ComponentPriority::NORMAL);
+      AddTracedComponent(gameManager, *mHudGUI, dtGame::GameManager::ComponentPriority::NORMAL);
 
-      mHudGUI->Initialize();
+      {
+         SimCore::StartupTracer::Phase phase("StealthHUD Initialize");
+         mHudGUI->Initialize();
+      }
 
       // Control State Component (for swapping weapons on remote HMMWV vehicles)
       dtCore::RefPtr<SimCore::Components::ControlStateComponent> controlsStateComp
          = new SimCore::Components::ControlStateComponent;
-      gameManager.AddComponent(*controlsStateComp, dtGame::GameManager::ComponentPriority::NORMAL);
+      AddTracedComponent(gameManager, *controlsStateComp, dtGame::GameManager::ComponentPriority::NORMAL);
 
       std::vector<dtCore::ResourceDescriptor> weaponModelResourceList;
       SimCore::WeaponTypeEnum::GetModelResourceList( weaponModelResourceList );
@@ -359,9 +367,12 @@ namespace StealthGM
       //}
       dtCore::RefPtr<dtPhysics::PhysicsWorld> physicsWorld = new dtPhysics::PhysicsWorld(gameManager.GetConfiguration());
       //dtCore::RefPtr<dtPhysics::PhysicsWorld> physicsWorld = new dtPhysics::PhysicsWorld(dtPhysics::PhysicsWorld::ODE_ENGINE);
-      physicsWorld->Init();
+      {
+         SimCore::StartupTracer::Phase phase("Physics World Init");
+         physicsWorld->Init();
+      }
       dtCore::RefPtr<dtPhysics::PhysicsComponent> physicsComponent = new dtPhysics::PhysicsComponent(*physicsWorld, false);
-      gameManager.AddComponent(*physicsComponent, dtGame::GameManager::ComponentPriority::NORMAL);
+      AddTracedComponent(gameManager, *physicsComponent, dtGame::GameManager::ComponentPriority::NORMAL);
       SimCore::CollisionGroup::SetupDefaultGroupCollisions(*physicsComponent);
 
       //mStealth->SetName("Stealth");
@@ -371,21 +382,24 @@ namespace StealthGM
       //mStealth->AddChild(gameManager.GetApplication().GetCamera());
 
       RefPtr<SimCore::Components::ViewerMessageProcessor> defMsgProcessor = new SimCore::Components::ViewerMessageProcessor;
-      gameManager.AddComponent(*defMsgProcessor,
+      AddTracedComponent(gameManager, *defMsgProcessor,
                                dtGame::GameManager::ComponentPriority::HIGHEST);
-      gameManager.AddComponent(*new StealthGM::ViewerConfigComponent,
+      AddTracedComponent(gameManager, *new StealthGM::ViewerConfigComponent,
+                               dtGame::GameManager::ComponentPriority::LOWER);
+      // Lower priority so the message processor has already created the remote actors.
+      AddTracedComponent(gameManager, *new StealthGM::EntitySearchIndexComponent,
                                dtGame::GameManager::ComponentPriority::LOWER);
 
       dtCore::RefPtr<SimCore::Components::RenderingSupportComponent> renderingSupportComponent
          = new SimCore::Components::RenderingSupportComponent();
       renderingSupportComponent->SetEnableCullVisitor(false);
 
-      gameManager.AddComponent(*renderingSupportComponent, dtGame::GameManager::ComponentPriority::NORMAL);
+      AddTracedComponent(gameManager, *renderingSupportComponent, dtGame::GameManager::ComponentPriority::NORMAL);
 
       dtCore::RefPtr<SimCore::Components::VolumeRenderingComponent> volumeRenderingComponent
          = new SimCore::Components::VolumeRenderingComponent();
 
-      gameManager.AddComponent(*volumeRenderingComponent, dtGame::GameManager::ComponentPriority::NORMAL);
+      AddTracedComponent(gameManager, *volumeRenderingComponent, dtGame::GameManager::ComponentPriority::NORMAL);
 
       if(!IsUIRunning())
       {
@@ -23,6 +23,7 @@
 
 #include <prefix/SimCorePrefix.h>
 #include <StealthViewer/GMApp/StealthHUD.h>
+#include <SimCore/Components/FrameBudgetComponent.h>
 #include <SimCore/Components/LabelManager.h>
 #include <SimCore/Components/RenderingSupportComponent.h>
 #include <SimCore/Components/StealthHUDElements.h>
@@ -66,6 +67,7 @@
 #include <CEGUI/CEGUIVersion.h>
 
 #include <ctime>
+#include <sstream>
 
 namespace StealthGM
 {
@@ -97,12 +99,21 @@ namespace StealthGM
       , mCoordSystem(&CoordSystem::MGRS)
       , mHasUI(hasUI)
    {
+      mRefreshJob = new SimCore::Components::FrameBudgetJob("HUD Refresh", "StealthHUD",
+         dtUtil::MakeFunctor(&StealthHUD::TickHUD, this));
    }
 
    //////////////////////////////////////////////////////////////////////////
    StealthHUD::~StealthHUD()
    {
       perror("Stealth HUD Destructor\n");
+      mRefreshJob->RemoveFromFrameBudget();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void StealthHUD::OnRemovedFromGM()
+   {
+      mRefreshJob->RemoveFromFrameBudget();
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -112,7 +123,11 @@ namespace StealthGM
 
       if( type == dtGame::MessageType::TICK_LOCAL )
       {
-         TickHUD();
+         // The meters and text are refreshed as a budgeted job; a frame of lag on them is not noticeable.
+         if (!SimCore::Components::FrameBudgetComponent::RequestJob(*GetGameManager(), *mRefreshJob))
+         {
+            TickHUD();
+         }
       }
       else if( type == dtGame::MessageType::TICK_REMOTE )
       {
@@ -127,6 +142,10 @@ namespace StealthGM
          // final positions in the world.
 //         mLabelManager->Update( tick.GetDeltaRealTime() );
       }
+      else if( type == SimCore::MessageType::INFO_PROFILE_STATS )
+      {
+         UpdateProfileText(static_cast<const SimCore::ProfileStatsMessage&>(message));
+      }
       else if( type == dtGame::MessageType::INFO_MAP_LOADED )
       {
          std::vector<dtCore::ActorProxy*> proxies;
@@ -258,6 +277,7 @@ namespace StealthGM
       mLabelManager->Init(GetGUI());
       mLabelManager->SetGameManager( GetGameManager() );
       mLabelManager->SetGUILayer( mLabelLayer.get() );
+      mLabelManager->LoadConfiguration( GetGameManager()->GetConfiguration() );
 
       // Toolbar
       mToolbar = new SimCore::Components::StealthToolbar("StealthToolbar");
@@ -306,11 +326,34 @@ namespace StealthGM
       mCartesianMeter->SetVisible( false );
       mHUDOverlay->Add(mCartesianMeter.get());
 
+      // Profile stats, hidden until the ProfilerComponent sends some.
+      mProfileText = CreateText( "ProfileText", "", 0.0f, 60.0f/1200.0f, 0.5f, 0.5f );
+      mProfileText->SetAlignment( SimCore::Components::HUDAlignment::RIGHT_TOP );
+      mProfileText->SetColor( 1.0f, 1.0f, 0.2f );
+      mProfileText->SetVisible( false );
+      mHUDOverlay->Add( mProfileText.get() );
+
       // Help Overlay
       InitHelpOverlay( mainOverlay );
       SetHelpEnabled( false );
    }
 
+   //////////////////////////////////////////////////////////////////////////
+   void StealthHUD::UpdateProfileText( const SimCore::ProfileStatsMessage& statsMessage )
+   {
+      if( !mProfileText.valid() )
+      {
+         return;
+      }
+
+      std::ostringstream ss;
+      ss << "Profile: " << statsMessage.GetNumFrames() << " frames in "
+         << statsMessage.GetPeriodSeconds() << " s" << std::endl
+         << statsMessage.GetStats();
+      mProfileText->SetText( ss.str() );
+      mProfileText->SetVisible( true );
+   }
+
    void StealthHUD::InitHelpOverlay( SimCore::Components::HUDGroup& hudOverlay )
    {
       mHelpOverlay = new SimCore::Components::HUDGroup("HelpScreen");
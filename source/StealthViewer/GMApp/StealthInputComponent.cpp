@@ -27,6 +27,7 @@
 #include <SimCore/BaseGameEntryPoint.h>
 #include <StealthViewer/GMApp/StealthInputComponent.h>
 #include <StealthViewer/GMApp/StealthHUD.h>
+#include <StealthViewer/GMApp/EntitySearchIndexComponent.h>
 
 #include <dtABC/application.h>
 #include <dtCore/actorproxy.h>
@@ -1146,19 +1147,39 @@ namespace StealthGM
 
    void StealthInputComponent::Cycle(bool forward, bool attach)
    {
+      // The search index holds the entities in a dense array, so there is no need to scan the GM.
+      EntitySearchIndexComponent* entityIndex = NULL;
+      GetGameManager()->GetComponentByName(EntitySearchIndexComponent::DEFAULT_NAME, entityIndex);
+
       std::vector<dtCore::ActorProxy*> actors;
-      //GetGameManager()->GetAllActors(actors);
-      GetGameManager()->GetAllActors(actors);
-      //unsigned int size = actors.size();
-      GetGameManager()->FindActorsByClassName("SimCore::Actors::BaseEntity", actors);
-      if (actors.empty())
+      unsigned numActors = 0;
+      if (entityIndex != NULL)
+      {
+         numActors = entityIndex->GetNumEntities();
+      }
+      else
+      {
+         GetGameManager()->FindActorsByClassName("SimCore::Actors::BaseEntity", actors);
+         numActors = unsigned(actors.size());
+      }
+
+      if (numActors == 0)
          return;
 
-      if (mCycleIndex >= actors.size())
-         mCycleIndex = mCycleIndex % actors.size();
+      if (mCycleIndex >= numActors)
+         mCycleIndex = mCycleIndex % numActors;
+
+      RefPtr<dtCore::ActorProxy> ap;
+      if (entityIndex != NULL)
+      {
+         ap = entityIndex->GetEntityAt(mCycleIndex);
+      }
+      else
+      {
+         ap = actors[mCycleIndex];
+      }
 
-      RefPtr<dtCore::ActorProxy> ap = actors[mCycleIndex];
-      if (ap->GetDrawable() != GetStealthActor() && ap != mTerrainActor &&
+      if (ap.valid() && ap->GetDrawable() != GetStealthActor() && ap != mTerrainActor &&
          ap.get() != GetGameManager()->GetEnvironmentActor())
       {
          RefPtr<dtGame::Message> nMsg = GetGameManager()->GetMessageFactory().CreateMessage(SimCore::MessageType::ATTACH_TO_ACTOR);
@@ -1201,13 +1222,13 @@ namespace StealthGM
          GetGameManager()->SendMessage(*atamsg);
       }
       if (forward)
-         mCycleIndex = (mCycleIndex + 1) % actors.size();
+         mCycleIndex = (mCycleIndex + 1) % numActors;
       else
       {
          if (mCycleIndex > 0)
             mCycleIndex -= 1;
          else
-            mCycleIndex = actors.size() - 1;
+            mCycleIndex = numActors - 1;
       }
    }
 
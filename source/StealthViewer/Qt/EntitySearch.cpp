@@ -28,6 +28,7 @@
  */
 #include <prefix/StealthQtPrefix.h>
 #include <StealthViewer/Qt/EntitySearch.h>
+#include <StealthViewer/GMApp/EntitySearchIndexComponent.h>
 #include <SimCore/Actors/BaseEntity.h>
 #include <dtGame/deadreckoninghelper.h>
 #include <dtGame/gamemanager.h>
@@ -43,54 +44,68 @@ namespace StealthQt
    {
       toFill.clear();
 
+      std::vector<dtCore::UniqueId> candidates;
+      FindCandidateEntities(candidates, gm, callSign);
+
+      for(size_t i = 0; i < candidates.size(); i++)
+      {
+         dtGame::GameActorProxy* actor = gm.FindGameActorById(candidates[i]);
+         if (actor != NULL && MatchesFilter(*actor, force, damageState))
+         {
+            // The name, force, and damage state matches, add it
+            toFill.push_back(actor);
+         }
+      }
+   }
+
+   void EntitySearch::FindCandidateEntities(std::vector<dtCore::UniqueId>& toFill,
+            dtGame::GameManager& gm,
+            const std::string& callSign)
+   {
+      toFill.clear();
+
+      StealthGM::EntitySearchIndexComponent* entityIndex = NULL;
+      gm.GetComponentByName(StealthGM::EntitySearchIndexComponent::DEFAULT_NAME, entityIndex);
+      if (entityIndex != NULL)
+      {
+         entityIndex->FindByPrefix(callSign, toFill);
+         return;
+      }
+
       std::vector<dtGame::GameActorProxy*> allProxies;
       gm.GetAllGameActors(allProxies);
 
       for(size_t i = 0; i < allProxies.size(); i++)
       {
-         SimCore::Actors::BaseEntityActorProxy *eap =
-            dynamic_cast<SimCore::Actors::BaseEntityActorProxy*>(allProxies[i]);
-
          // Could be the environment actor proxy or something. Skip it
-         if(eap == NULL)
+         if (dynamic_cast<SimCore::Actors::BaseEntityActorProxy*>(allProxies[i]) == NULL)
             continue;
 
-         SimCore::Actors::BaseEntity& entity = *eap->GetDrawable<SimCore::Actors::BaseEntity>();
-
-         if (!entity.IsVisible())
+         if (!callSign.empty() && allProxies[i]->GetName().find(callSign) != 0)
             continue;
 
-         if (!callSign.empty())
-         {
-            // Skip it
-            std::string entityName = entity.GetName();
-
-            int index = entityName.find(callSign);
-            if(index != 0)
-               continue;
-         }
+         toFill.push_back(allProxies[i]->GetId());
+      }
+   }
 
-         if (force != "Any")
-         {
-            const std::string &value = entity.GetForceAffiliation().GetName();
+   bool EntitySearch::MatchesFilter(dtGame::GameActorProxy& actor,
+            const std::string& force,
+            const std::string& damageState)
+   {
+      SimCore::Actors::BaseEntity* entity = NULL;
+      actor.GetDrawable(entity);
 
-            // Force search string is not empty, and this doesn't match. Skip it.
-            if(value != force)
-               continue;
-         }
+      if (entity == NULL || !entity->IsVisible())
+         return false;
 
-         if (damageState != "Any")
-         {
-            const std::string &value = entity.GetDamageState().GetName();
+      // Force search string is not empty, and this doesn't match. Skip it.
+      if (force != "Any" && entity->GetForceAffiliation().GetName() != force)
+         return false;
 
-            // Skip it.
-            if (value != damageState)
-               continue;
-         }
+      if (damageState != "Any" && entity->GetDamageState().GetName() != damageState)
+         return false;
 
-         // The name, force, and damage state matches, add it
-         toFill.push_back(&entity.GetGameActorProxy());
-      }
+      return true;
    }
 
    double EntitySearch::GetLastUpdateTime(const dtGame::GameActorProxy& actor)
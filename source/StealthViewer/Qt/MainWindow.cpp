@@ -106,6 +106,7 @@ DT_DISABLE_WARNING_END
 
 #include <cmath>
 #include <cfloat>
+#include <algorithm>
 
 #include <iostream>
 
@@ -172,6 +173,7 @@ namespace StealthQt
    , mLonValidator(new QDoubleValidator(-180, 180, 10, this))
    , mXYZValidator(new QDoubleValidator(-DBL_MAX, DBL_MAX, 10, this))
    , mGtZeroValidator(new QDoubleValidator(0, DBL_MAX, 5, this))
+   , mPendingSearchIndex(0)
    , mShowMissingEntityInfoErrorMessage(true)
    , mPreviousCustomHour(-1)
    , mPreviousCustomMinute(-1)
@@ -415,6 +417,10 @@ namespace StealthQt
       mRefreshEntityInfoTimer.setSingleShot(false);
       mRefreshEntityInfoTimer.start();
 
+      // Zero interval so search results are added between UI events until they are all in.
+      mSearchResultsTimer.setInterval(0);
+      mSearchResultsTimer.setSingleShot(false);
+
       // Disable full screen
       //mUi->mMenuWindow->removeAction(mUi->mActionFullScreen);
    }
@@ -735,6 +741,10 @@ namespace StealthQt
       connect(mUi->mSearchSearchPushButton, SIGNAL(clicked(bool)),
                this,                         SLOT(OnEntitySearchSearchButtonClicked(bool)));
 
+      // The search is indexed, so it's cheap enough to update as the user types.
+      connect(mUi->mSearchCallSignLineEdit, SIGNAL(textEdited(const QString&)),
+               this,                         SLOT(OnEntitySearchSearchButtonClicked()));
+
       connect(mUi->mSearchAttachPushButton, SIGNAL(clicked(bool)),
                this,                        SLOT(OnEntitySearchAttachButtonClicked(bool)));
 
@@ -781,6 +791,8 @@ namespace StealthQt
 
       connect(&mHLAErrorTimer, SIGNAL(timeout()), this, SLOT(OnHLAErrorTimerElapsed()));
 
+      connect(&mSearchResultsTimer, SIGNAL(timeout()), this, SLOT(OnSearchResultsTimerElapsed()));
+
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -1336,6 +1348,7 @@ namespace StealthQt
    ///////////////////////////////////////////////////////////////////////////////
    void MainWindow::OnEntitySearchSearchButtonClicked(bool checked)
    {
+      mSearchResultsTimer.stop();
       mUi->mSearchEntityTableWidget->clear();
       mFoundActors.clear();
 
@@ -1345,26 +1358,43 @@ namespace StealthQt
       headers << "Call Sign" << "Force" << "Damage State";
       mUi->mSearchEntityTableWidget->setHorizontalHeaderLabels(headers);
 
-      EntitySearch::FindEntities(mFoundActors,
-               *mGM,
-               mUi->mSearchCallSignLineEdit->text().toStdString(),
-               mUi->mSearchForceComboBox->currentText().toStdString(),
-               mUi->mSearchDamageStateComboBox->currentText().toStdString());
-
       // According to the Qt 4.2.3 docs, if you do not turn sorting off
       // and reenable after inserting into a table in a for loop you get
       // really weird results. This was experienced visually as well
+      // It is turned back on once all the results are in.
       mUi->mSearchEntityTableWidget->setSortingEnabled(false);
+      mUi->mSearchEntityTableWidget->setRowCount(0);
 
-      // Only use the exact number of rows needed
-      mUi->mSearchEntityTableWidget->setRowCount(int(mFoundActors.size()));
+      // Finding the candidates is just an index lookup.  Checking and adding them to the table
+      // is done in batches so a large result set doesn't block the UI.
+      EntitySearch::FindCandidateEntities(mPendingSearchResults,
+               *mGM,
+               mUi->mSearchCallSignLineEdit->text().toStdString());
+      mPendingSearchIndex = 0;
+      mSearchForce = mUi->mSearchForceComboBox->currentText().toStdString();
+      mSearchDamageState = mUi->mSearchDamageStateComboBox->currentText().toStdString();
+
+      OnSearchResultsTimerElapsed();
+   }
 
-      for(size_t i = 0; i < mFoundActors.size(); i++)
+   ///////////////////////////////////////////////////////////////////////////////
+   void MainWindow::OnSearchResultsTimerElapsed()
+   {
+      static const unsigned SEARCH_RESULTS_PER_UPDATE = 250;
+
+      unsigned end = std::min(unsigned(mPendingSearchResults.size()), mPendingSearchIndex + SEARCH_RESULTS_PER_UPDATE);
+      for (; mPendingSearchIndex < end; ++mPendingSearchIndex)
       {
-         std::string name  = mFoundActors[i]->GetName(),
-         force = mFoundActors[i]->GetProperty("Force Affiliation")->ToString(),
-         ds    = mFoundActors[i]->GetProperty("Damage State")->ToString(),
-         id    = mFoundActors[i]->GetId().ToString();
+         dtGame::GameActorProxy* actor = mGM->FindGameActorById(mPendingSearchResults[mPendingSearchIndex]);
+         if (actor == NULL || !EntitySearch::MatchesFilter(*actor, mSearchForce, mSearchDamageState))
+            continue;
+
+         mFoundActors.push_back(actor);
+
+         std::string name  = actor->GetName(),
+         force = actor->GetProperty("Force Affiliation")->ToString(),
+         ds    = actor->GetProperty("Damage State")->ToString(),
+         id    = actor->GetId().ToString();
 
          QTableWidgetItem *nameItem  = new QTableWidgetItem(tr(name.c_str()));
          QTableWidgetItem *forceItem = new QTableWidgetItem(tr(force.c_str()));
@@ -1374,13 +1404,27 @@ namespace StealthQt
          forceItem->setData(Qt::UserRole, tr(id.c_str()));
          dsItem->setData(Qt::UserRole, tr(id.c_str()));
 
-         mUi->mSearchEntityTableWidget->setItem(i, 0, nameItem);
-         mUi->mSearchEntityTableWidget->setItem(i, 1, forceItem);
-         mUi->mSearchEntityTableWidget->setItem(i, 2, dsItem);
-         //mUi->mSearchEntityTableWidget->setItem(i, 3, newItem);
+         int row = mUi->mSearchEntityTableWidget->rowCount();
+         mUi->mSearchEntityTableWidget->insertRow(row);
+         mUi->mSearchEntityTableWidget->setItem(row, 0, nameItem);
+         mUi->mSearchEntityTableWidget->setItem(row, 1, forceItem);
+         mUi->mSearchEntityTableWidget->setItem(row, 2, dsItem);
       }
 
-      mUi->mSearchEntityTableWidget->setSortingEnabled(true);
+      if (mPendingSearchIndex < mPendingSearchResults.size())
+      {
+         if (!mSearchResultsTimer.isActive())
+         {
+            mSearchResultsTimer.start();
+         }
+      }
+      else
+      {
+         mSearchResultsTimer.stop();
+         mPendingSearchResults.clear();
+         mPendingSearchIndex = 0;
+         mUi->mSearchEntityTableWidget->setSortingEnabled(true);
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -53,6 +53,7 @@ namespace SimCore
          CPPUNIT_TEST_SUITE(AnimationClipActCompTests);
          CPPUNIT_TEST(TestProperties);
          CPPUNIT_TEST(TestOnActor);
+         CPPUNIT_TEST(TestClipPath);
          CPPUNIT_TEST_SUITE_END();
 
          public:
@@ -63,6 +64,7 @@ namespace SimCore
             // Test Functions:
             void TestProperties();
             void TestOnActor();
+            void TestClipPath();
 
          private:
             dtCore::RefPtr<dtGame::GameManager> mGM;
@@ -199,5 +201,53 @@ namespace SimCore
          }
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void AnimationClipActCompTests::TestClipPath()
+      {
+         // A path that moves along X one unit per second for 10 seconds.
+         dtCore::RefPtr<osg::AnimationPath> source = new osg::AnimationPath();
+         for (int i = 0; i <= 10; ++i)
+         {
+            source->insert(double(i), osg::AnimationPath::ControlPoint(osg::Vec3(float(i), 0.0f, 0.0f)));
+         }
+
+         // Two instances share the key frames and play different segments.
+         dtCore::RefPtr<AnimationClipPath> clipA = new AnimationClipPath(*source);
+         dtCore::RefPtr<AnimationClipPath> clipB = new AnimationClipPath(*source);
+         CPPUNIT_ASSERT(clipA->GetSource() == source.get());
+         CPPUNIT_ASSERT(clipB->GetSource() == source.get());
+         CPPUNIT_ASSERT(clipA->getTimeControlPointMap().empty());
+
+         clipA->SetClipTimes(2.0, 4.0);
+         clipB->SetClipTimes(5.0, 9.0);
+         CPPUNIT_ASSERT_EQUAL(2.0, clipA->GetBeginTime());
+         CPPUNIT_ASSERT_EQUAL(4.0, clipA->GetEndTime());
+
+         osg::AnimationPath::ControlPoint cp;
+         clipA->setLoopMode(osg::AnimationPath::NO_LOOPING);
+         CPPUNIT_ASSERT(clipA->getInterpolatedControlPoint(1.0, cp));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, cp.getPosition().x(), 0.001);
+         CPPUNIT_ASSERT(clipA->getInterpolatedControlPoint(7.0, cp));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, cp.getPosition().x(), 0.001);
+
+         clipB->setLoopMode(osg::AnimationPath::LOOP);
+         CPPUNIT_ASSERT(clipB->getInterpolatedControlPoint(5.0, cp));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, cp.getPosition().x(), 0.001);
+
+         clipB->setLoopMode(osg::AnimationPath::SWING);
+         CPPUNIT_ASSERT(clipB->getInterpolatedControlPoint(5.0, cp));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, cp.getPosition().x(), 0.001);
+
+         // Without a segment the whole source plays.
+         dtCore::RefPtr<AnimationClipPath> clipC = new AnimationClipPath(*source);
+         clipC->setLoopMode(osg::AnimationPath::NO_LOOPING);
+         CPPUNIT_ASSERT(clipC->getInterpolatedControlPoint(7.5, cp));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(7.5, cp.getPosition().x(), 0.001);
+
+         // A fresh component hasn't found any callbacks.
+         CPPUNIT_ASSERT_EQUAL(0U, mActComp->GetNumAnimationCallbacks());
+         CPPUNIT_ASSERT( ! mActComp->IsValid());
+      }
+
    }
 }
@@ -35,6 +35,10 @@
 #include <dtUtil/log.h>
 #include <dtUtil/exception.h>
 #include <SimCore/Array2DParser.h>
+#include <SimCore/ByteSwap.h>
+#include <osg/Timer>
+#include <cstdio>
+#include <iostream>
 #include <UnitTestMain.h>
 
 
@@ -47,6 +51,11 @@ class DataTypeTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST_SUITE(DataTypeTests);
 
       CPPUNIT_TEST(TestArray2DParser);
+      CPPUNIT_TEST(TestByteSwap);
+      CPPUNIT_TEST(TestArray2DBulkDecode);
+      CPPUNIT_TEST(TestArray2DView);
+      CPPUNIT_TEST(TestArray2DFile);
+      CPPUNIT_TEST(TestArray2DBenchmark);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -109,6 +118,224 @@ class DataTypeTests : public CPPUNIT_NS::TestFixture
             CPPUNIT_FAIL(e.ToString());
          }
       }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TestByteSwap()
+      {
+         // Odd counts so both the SSE2 blocks and the leftovers are covered.
+         std::vector<unsigned short> shorts(37);
+         std::vector<unsigned> ints(19);
+         std::vector<double> doubles(11);
+         for (unsigned i = 0; i < shorts.size(); ++i)
+         {
+            shorts[i] = (unsigned short)(0x0102 + i);
+         }
+         for (unsigned i = 0; i < ints.size(); ++i)
+         {
+            ints[i] = 0x01020304U + i;
+         }
+         for (unsigned i = 0; i < doubles.size(); ++i)
+         {
+            doubles[i] = 1.5 + i;
+         }
+
+         std::vector<unsigned short> swappedShorts(shorts.size());
+         SimCore::CopySwapBytes(&swappedShorts[0], &shorts[0], shorts.size(), sizeof(unsigned short));
+         for (unsigned i = 0; i < shorts.size(); ++i)
+         {
+            unsigned short expected = shorts[i];
+            osg::swapBytes2(reinterpret_cast<char*>(&expected));
+            CPPUNIT_ASSERT_EQUAL(expected, swappedShorts[i]);
+         }
+
+         std::vector<unsigned> swappedInts(ints);
+         SimCore::SwapBytes(&swappedInts[0], swappedInts.size());
+         for (unsigned i = 0; i < ints.size(); ++i)
+         {
+            unsigned expected = ints[i];
+            osg::swapBytes4(reinterpret_cast<char*>(&expected));
+            CPPUNIT_ASSERT_EQUAL(expected, swappedInts[i]);
+         }
+
+         std::vector<double> swappedDoubles(doubles);
+         SimCore::SwapBytes(&swappedDoubles[0], swappedDoubles.size());
+         SimCore::SwapBytes(&swappedDoubles[0], swappedDoubles.size());
+         for (unsigned i = 0; i < doubles.size(); ++i)
+         {
+            CPPUNIT_ASSERT_EQUAL(doubles[i], swappedDoubles[i]);
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TestArray2DBulkDecode()
+      {
+         for (unsigned pass = 0; pass < 2; ++pass)
+         {
+            bool littleEndian = pass == 1;
+            SimCore::Array2DParser<float> arrayA;
+            SimCore::Array2DParser<float> arrayB;
+            arrayA.SetLittleEndianStorage(littleEndian);
+            arrayB.SetLittleEndianStorage(littleEndian);
+
+            arrayA.Resize(7, 5);
+            CPPUNIT_ASSERT_EQUAL(size_t(7), arrayA.GetRows());
+            for (unsigned row = 0; row < 7; ++row)
+            {
+               for (unsigned col = 0; col < 5; ++col)
+               {
+                  arrayA.SetValue(float(row) * 10.0f + float(col) + 0.25f, row, col);
+               }
+            }
+
+            std::vector<char> buffer(arrayA.GetEncodedSize());
+            CPPUNIT_ASSERT_EQUAL(buffer.size(), arrayA.Encode(&buffer[0], buffer.size()));
+
+            // Make sure it matches what DataStream writes value by value.
+            dtUtil::DataStream ds;
+            ds.SetForceLittleEndian(littleEndian);
+            ds << short(5) << short(7);
+            for (unsigned i = 0; i < arrayA.GetData().size(); ++i)
+            {
+               ds << arrayA.GetData()[i];
+            }
+            CPPUNIT_ASSERT_EQUAL(size_t(ds.GetBufferSize()), buffer.size());
+            CPPUNIT_ASSERT(std::memcmp(ds.GetBuffer(), &buffer[0], buffer.size()) == 0);
+
+            arrayB.Reserve(7, 5);
+            size_t reserved = arrayB.GetData().capacity();
+            arrayB.Decode(&buffer[0], buffer.size());
+            CPPUNIT_ASSERT_EQUAL(size_t(5), arrayB.GetColumns());
+            CPPUNIT_ASSERT_EQUAL(size_t(7), arrayB.GetRows());
+            CPPUNIT_ASSERT_MESSAGE("Decoding into a reserved grid should not reallocate.",
+                     reserved == arrayB.GetData().capacity());
+            CPPUNIT_ASSERT(arrayA.GetData() == arrayB.GetData());
+
+            // A buffer too short for its values decodes to nothing.
+            arrayB.Decode(&buffer[0], buffer.size() - 1);
+            CPPUNIT_ASSERT_EQUAL(size_t(0), arrayB.GetRows());
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TestArray2DView()
+      {
+         SimCore::Array2DParser<float> arrayA;
+         arrayA.SetLittleEndianStorage(SimCore::IsCpuLittleEndian());
+         arrayA.Resize(3, 4);
+         for (unsigned i = 0; i < arrayA.GetData().size(); ++i)
+         {
+            arrayA.GetData()[i] = float(i) * 0.5f;
+         }
+
+         // Back it with floats so the values are aligned.
+         std::vector<float> storage(arrayA.GetData().size() + 1);
+         char* buffer = reinterpret_cast<char*>(&storage[0]);
+         size_t size = arrayA.Encode(buffer, storage.size() * sizeof(float));
+
+         SimCore::Array2DView<float> view;
+         CPPUNIT_ASSERT(arrayA.DecodeView(buffer, size, view));
+         CPPUNIT_ASSERT_EQUAL(size_t(4), view.GetColumns());
+         CPPUNIT_ASSERT_EQUAL(size_t(3), view.GetRows());
+         CPPUNIT_ASSERT_MESSAGE("The view should point into the buffer, not a copy.",
+                  reinterpret_cast<const char*>(view.GetData()) == buffer + SimCore::Array2DParser<float>::HEADER_SIZE);
+         CPPUNIT_ASSERT_EQUAL(arrayA.GetValue(2, 3), view.GetValue(2, 3));
+         CPPUNIT_ASSERT_EQUAL(arrayA.GetValue(1, 0), view.GetRow(1)[0]);
+
+         // The other byte order has to be converted, so it can't be viewed in place.
+         SimCore::Array2DParser<float> arrayB;
+         arrayB.SetLittleEndianStorage(!SimCore::IsCpuLittleEndian());
+         size = arrayB.Encode(buffer, storage.size() * sizeof(float));
+         CPPUNIT_ASSERT(!arrayB.DecodeView(buffer, size, view) || view.IsEmpty());
+
+         SimCore::Array2DView<float> parserView = arrayA.GetView();
+         CPPUNIT_ASSERT_EQUAL(arrayA.GetValue(2, 1), parserView.GetValue(2, 1));
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void TestArray2DFile()
+      {
+         const std::string fileName("Array2DParserTest.grid");
+         for (unsigned pass = 0; pass < 2; ++pass)
+         {
+            SimCore::Array2DParser<short> arrayA;
+            arrayA.SetLittleEndianStorage(pass == 1);
+            arrayA.Resize(16, 9);
+            for (unsigned i = 0; i < arrayA.GetData().size(); ++i)
+            {
+               arrayA.GetData()[i] = short(i * 3 - 100);
+            }
+            CPPUNIT_ASSERT(arrayA.SaveFile(fileName));
+
+            SimCore::Array2DParser<short> arrayB;
+            arrayB.SetLittleEndianStorage(pass == 1);
+            SimCore::Array2DView<short> view;
+            CPPUNIT_ASSERT(arrayB.LoadFile(fileName, view));
+            CPPUNIT_ASSERT_EQUAL(size_t(9), view.GetColumns());
+            CPPUNIT_ASSERT_EQUAL(size_t(16), view.GetRows());
+            for (unsigned i = 0; i < arrayA.GetData().size(); ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(arrayA.GetData()[i], view.GetData()[i]);
+            }
+
+            if (view.GetOwner() != NULL)
+            {
+               // Mapped in place, so the parser has no copy.
+               CPPUNIT_ASSERT(arrayB.GetData().empty());
+            }
+         }
+         std::remove(fileName.c_str());
+
+         SimCore::Array2DParser<short> missing;
+         SimCore::Array2DView<short> view;
+         CPPUNIT_ASSERT(!missing.LoadFile("NotAnArray2DParserTest.grid", view));
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      /// Compares decoding a 1024x1024 grid value by value through a DataStream with the bulk decode.
+      void TestArray2DBenchmark()
+      {
+         const unsigned size = 1024;
+         SimCore::Array2DParser<float> arrayA;
+         arrayA.Resize(size, size);
+         for (unsigned i = 0; i < arrayA.GetData().size(); ++i)
+         {
+            arrayA.GetData()[i] = float(i % 4099) * 0.125f;
+         }
+
+         std::vector<char> buffer(arrayA.GetEncodedSize());
+         size_t encodedSize = arrayA.Encode(&buffer[0], buffer.size());
+
+         osg::Timer* timer = osg::Timer::instance();
+
+         osg::Timer_t start = timer->tick();
+         std::vector<float> streamed;
+         {
+            dtUtil::DataStream ds(&buffer[0], unsigned(encodedSize), false);
+            short cols = 0, rows = 0;
+            ds >> cols >> rows;
+            streamed.reserve(size_t(cols) * size_t(rows));
+            for (unsigned i = 0; i < unsigned(cols) * unsigned(rows); ++i)
+            {
+               float f;
+               ds >> f;
+               streamed.push_back(f);
+            }
+         }
+         double streamedMs = timer->delta_m(start, timer->tick());
+
+         SimCore::Array2DParser<float> arrayB;
+         arrayB.Reserve(size, size);
+         start = timer->tick();
+         arrayB.Decode(&buffer[0], encodedSize);
+         double bulkMs = timer->delta_m(start, timer->tick());
+
+         CPPUNIT_ASSERT(streamed == arrayA.GetData());
+         CPPUNIT_ASSERT(arrayB.GetData() == arrayA.GetData());
+
+         std::cout << "\n\tDecoding a " << size << "x" << size << " float grid took " << streamedMs
+            << " ms value by value and " << bulkMs << " ms in bulk.\n" << std::endl;
+      }
+
    private:
 };
 
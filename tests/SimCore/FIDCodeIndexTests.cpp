@@ -0,0 +1,239 @@
+/* -*-c++-*-
+* Simulation Core - FIDCodeIndexTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <SimCore/FIDCodeIndex.h>
+
+#include <osg/Array>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Group>
+#include <osg/StateSet>
+
+#include <UnitTestMain.h>
+
+using SimCore::FIDCodeIndex;
+
+class FIDCodeIndexTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(FIDCodeIndexTests);
+      CPPUNIT_TEST(TestCompile);
+      CPPUNIT_TEST(TestDisabledCodes);
+      CPPUNIT_TEST(TestUncompiledGeodes);
+      CPPUNIT_TEST(TestReloadAndRemove);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestCompile();
+      void TestDisabledCodes();
+      void TestUncompiledGeodes();
+      void TestReloadAndRemove();
+
+   private:
+      osg::Geode* AddGeode(int fidCode);
+      static void AddDrawable(osg::Geode& geode, int fidCode);
+
+      osg::ref_ptr<osg::Group> mTerrain;
+      osg::Geode* mRoad;
+      osg::Geode* mBush;
+      osg::Geode* mBushAndRoad;
+      osg::Geode* mUncoded;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FIDCodeIndexTests);
+
+static const int ROAD = 101;
+static const int BUSH = 957;
+static const int NO_CODE = -1;
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::setUp()
+{
+   mTerrain = new osg::Group();
+   mRoad = AddGeode(ROAD);
+   mBush = AddGeode(BUSH);
+   mBushAndRoad = AddGeode(BUSH);
+   AddDrawable(*mBushAndRoad, ROAD);
+   mUncoded = AddGeode(NO_CODE);
+}
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::tearDown()
+{
+   mTerrain = NULL;
+}
+
+/////////////////////////////////////////////////////////
+osg::Geode* FIDCodeIndexTests::AddGeode(int fidCode)
+{
+   osg::Geode* geode = new osg::Geode();
+   AddDrawable(*geode, fidCode);
+   mTerrain->addChild(geode);
+   return geode;
+}
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::AddDrawable(osg::Geode& geode, int fidCode)
+{
+   osg::Geometry* geometry = new osg::Geometry();
+   osg::StateSet* ss = geometry->getOrCreateStateSet();
+   if (fidCode != NO_CODE)
+   {
+      osg::IntArray* codes = new osg::IntArray();
+      codes->push_back(fidCode);
+      codes->push_back(1);
+      ss->setUserData(codes);
+   }
+   geode.addDrawable(geometry);
+}
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::TestCompile()
+{
+   FIDCodeIndex index;
+   CPPUNIT_ASSERT_EQUAL(4U, index.Compile(*mTerrain));
+   CPPUNIT_ASSERT_EQUAL(2U, index.GetNumClasses());
+
+   unsigned roadClass = index.FindClass(ROAD);
+   unsigned bushClass = index.FindClass(BUSH);
+   CPPUNIT_ASSERT(roadClass != FIDCodeIndex::NO_CLASS);
+   CPPUNIT_ASSERT(bushClass != FIDCodeIndex::NO_CLASS);
+   CPPUNIT_ASSERT(roadClass != bushClass);
+   CPPUNIT_ASSERT_EQUAL(FIDCodeIndex::NO_CLASS, index.FindClass(12));
+   CPPUNIT_ASSERT_EQUAL(ROAD, index.GetFIDCode(roadClass));
+
+   FIDCodeIndex::GeodeInfo* info = FIDCodeIndex::GetGeodeInfo(*mBushAndRoad);
+   CPPUNIT_ASSERT(info != NULL);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), info->mClasses.size());
+   CPPUNIT_ASSERT(!info->mHasUncoded);
+
+   info = FIDCodeIndex::GetGeodeInfo(*mUncoded);
+   CPPUNIT_ASSERT(info != NULL);
+   CPPUNIT_ASSERT(info->mClasses.empty());
+   CPPUNIT_ASSERT(info->mHasUncoded);
+
+   int fidCode = 0;
+   CPPUNIT_ASSERT(FIDCodeIndex::ReadFIDCode(*mRoad->getDrawable(0), fidCode));
+   CPPUNIT_ASSERT_EQUAL(ROAD, fidCode);
+   CPPUNIT_ASSERT(!FIDCodeIndex::ReadFIDCode(*mUncoded->getDrawable(0), fidCode));
+
+   // Geodes with other user data are left alone.
+   osg::Geode* other = AddGeode(ROAD);
+   osg::ref_ptr<osg::Referenced> otherData = new osg::IntArray();
+   other->setUserData(otherData.get());
+   CPPUNIT_ASSERT_EQUAL(4U, index.Compile(*mTerrain));
+   CPPUNIT_ASSERT(other->getUserData() == otherData.get());
+}
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::TestDisabledCodes()
+{
+   FIDCodeIndex index;
+   // Disabled before the terrain is compiled.
+   std::vector<int> disabled;
+   disabled.push_back(BUSH);
+   index.SetDisabledCodes(disabled);
+   index.Compile(*mTerrain);
+
+   CPPUNIT_ASSERT(index.IsCodeDisabled(BUSH));
+   CPPUNIT_ASSERT(!index.IsCodeDisabled(ROAD));
+   CPPUNIT_ASSERT(index.ShouldDraw(*mRoad));
+   CPPUNIT_ASSERT(!index.ShouldDraw(*mBush));
+   CPPUNIT_ASSERT_MESSAGE("A geode is drawn if any of its codes are enabled.", index.ShouldDraw(*mBushAndRoad));
+   CPPUNIT_ASSERT(index.ShouldDraw(*mUncoded));
+
+   // Only the geodes with the road code change.
+   disabled.push_back(ROAD);
+   index.SetDisabledCodes(disabled);
+   CPPUNIT_ASSERT_EQUAL(2U, index.GetNumGeodesUpdated());
+   CPPUNIT_ASSERT(!index.ShouldDraw(*mRoad));
+   CPPUNIT_ASSERT(!index.ShouldDraw(*mBush));
+   CPPUNIT_ASSERT(!index.ShouldDraw(*mBushAndRoad));
+   CPPUNIT_ASSERT(index.ShouldDraw(*mUncoded));
+
+   // Nothing changed.
+   index.SetDisabledCodes(disabled);
+   CPPUNIT_ASSERT_EQUAL(0U, index.GetNumGeodesUpdated());
+
+   disabled.clear();
+   index.SetDisabledCodes(disabled);
+   CPPUNIT_ASSERT_EQUAL(4U, index.GetNumGeodesUpdated());
+   CPPUNIT_ASSERT(index.ShouldDraw(*mRoad));
+   CPPUNIT_ASSERT(index.ShouldDraw(*mBush));
+   CPPUNIT_ASSERT(index.GetDisabledCodes().empty());
+
+   // Unloaded geodes are dropped.
+   mTerrain->removeChild(mBush);
+   mBush = NULL;
+   disabled.push_back(BUSH);
+   index.SetDisabledCodes(disabled);
+   CPPUNIT_ASSERT_EQUAL(1U, index.GetNumGeodesUpdated());
+}
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::TestUncompiledGeodes()
+{
+   FIDCodeIndex index;
+   std::vector<int> disabled;
+   disabled.push_back(BUSH);
+   index.SetDisabledCodes(disabled);
+
+   CPPUNIT_ASSERT(FIDCodeIndex::GetGeodeInfo(*mBush) == NULL);
+   CPPUNIT_ASSERT(index.ShouldDraw(*mRoad));
+   CPPUNIT_ASSERT(!index.ShouldDraw(*mBush));
+   CPPUNIT_ASSERT(index.ShouldDraw(*mBushAndRoad));
+   CPPUNIT_ASSERT(index.ShouldDraw(*mUncoded));
+}
+
+/////////////////////////////////////////////////////////
+void FIDCodeIndexTests::TestReloadAndRemove()
+{
+   FIDCodeIndex index;
+   index.Compile(*mTerrain);
+   // The bush and road geode is in both lists.
+   CPPUNIT_ASSERT_EQUAL(4U, index.GetNumIndexedGeodes());
+
+   // Compiling the same terrain again replaces the entries instead of adding to them.
+   CPPUNIT_ASSERT_EQUAL(4U, index.Compile(*mTerrain));
+   CPPUNIT_ASSERT_EQUAL(4U, index.GetNumIndexedGeodes());
+
+   std::vector<int> disabled;
+   disabled.push_back(BUSH);
+   index.SetDisabledCodes(disabled);
+
+   CPPUNIT_ASSERT_EQUAL(4U, index.Remove(*mTerrain));
+   CPPUNIT_ASSERT_EQUAL(0U, index.GetNumIndexedGeodes());
+   CPPUNIT_ASSERT(FIDCodeIndex::GetGeodeInfo(*mBush) == NULL);
+
+   // The untagged geodes are still drawn by their codes.
+   CPPUNIT_ASSERT(index.ShouldDraw(*mRoad));
+   CPPUNIT_ASSERT(!index.ShouldDraw(*mBush));
+}
@@ -0,0 +1,287 @@
+/* -*-c++-*-
+* Simulation Core - FrameBudgetComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/system.h>
+#include <dtCore/scene.h>
+#include <dtGame/gamemanager.h>
+
+#include <SimCore/Components/FrameBudgetComponent.h>
+
+#include <osg/Timer>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+#include <sstream>
+#include <vector>
+
+using SimCore::Components::FrameBudgetJob;
+using SimCore::Components::FrameBudgetComponent;
+
+////////////////////////////////////////////////////////
+// Counts its runs and takes as long as it is told to.
+class BudgetWorker : public osg::Referenced
+{
+   public:
+      BudgetWorker(const std::string& name, std::vector<std::string>* order = NULL)
+         : mName(name)
+         , mOrder(order)
+         , mNumRuns(0)
+         , mMillis(0.0)
+      {
+      }
+
+      void Work()
+      {
+         ++mNumRuns;
+         if (mOrder != NULL)
+         {
+            mOrder->push_back(mName);
+         }
+
+         osg::Timer_t startTick = osg::Timer::instance()->tick();
+         while (osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick()) < mMillis)
+         {
+         }
+      }
+
+      std::string mName;
+      std::vector<std::string>* mOrder;
+      unsigned mNumRuns;
+      double mMillis;
+};
+
+class FrameBudgetComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(FrameBudgetComponentTests);
+      CPPUNIT_TEST(TestAddRemoveJobs);
+      CPPUNIT_TEST(TestPriorityOrder);
+      CPPUNIT_TEST(TestDeferAndForce);
+      CPPUNIT_TEST(TestOverrunReport);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestAddRemoveJobs();
+      void TestPriorityOrder();
+      void TestDeferAndForce();
+      void TestOverrunReport();
+
+   private:
+      dtCore::RefPtr<FrameBudgetJob> MakeJob(BudgetWorker& worker, const std::string& subsystem, unsigned priority);
+
+      dtCore::RefPtr<dtGame::GameManager> mGM;
+      dtCore::RefPtr<FrameBudgetComponent> mFrameBudget;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameBudgetComponentTests);
+
+/////////////////////////////////////////////////////////
+void FrameBudgetComponentTests::setUp()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtABC::Application& app = GetGlobalApplication();
+   mGM = new dtGame::GameManager(*app.GetScene());
+   mGM->SetApplication(app);
+
+   mFrameBudget = new FrameBudgetComponent();
+}
+
+/////////////////////////////////////////////////////////
+void FrameBudgetComponentTests::tearDown()
+{
+   dtCore::System::GetInstance().Stop();
+
+   if (mGM.valid())
+   {
+      mGM->DeleteAllActors(true);
+   }
+
+   mFrameBudget = NULL;
+   mGM = NULL;
+}
+
+/////////////////////////////////////////////////////////
+dtCore::RefPtr<FrameBudgetJob> FrameBudgetComponentTests::MakeJob(BudgetWorker& worker, const std::string& subsystem, unsigned priority)
+{
+   return new FrameBudgetJob(worker.mName, subsystem, dtUtil::MakeFunctor(&BudgetWorker::Work, &worker), priority);
+}
+
+/////////////////////////////////////////////////////////
+void FrameBudgetComponentTests::TestAddRemoveJobs()
+{
+   dtCore::RefPtr<BudgetWorker> worker = new BudgetWorker("Job");
+   dtCore::RefPtr<FrameBudgetJob> job = MakeJob(*worker, "Test", FrameBudgetJob::PRIORITY_NORMAL);
+
+   CPPUNIT_ASSERT_MESSAGE("There is no frame budget on the GM yet, so the caller has to do the work.",
+            !FrameBudgetComponent::RequestJob(*mGM, *job));
+   CPPUNIT_ASSERT(job->GetFrameBudget() == NULL);
+
+   mGM->AddComponent(*mFrameBudget, dtGame::GameManager::ComponentPriority::LOWER);
+   CPPUNIT_ASSERT(FrameBudgetComponent::RequestJob(*mGM, *job));
+   CPPUNIT_ASSERT(job->GetFrameBudget() == mFrameBudget.get());
+   CPPUNIT_ASSERT(job->IsRequested());
+   CPPUNIT_ASSERT_EQUAL(1U, mFrameBudget->GetNumJobs());
+   CPPUNIT_ASSERT(mFrameBudget->FindJob("Job") == job.get());
+
+   mFrameBudget->RunFrame();
+   CPPUNIT_ASSERT_EQUAL(1U, worker->mNumRuns);
+   CPPUNIT_ASSERT(!job->IsRequested());
+
+   mFrameBudget->RunFrame();
+   CPPUNIT_ASSERT_MESSAGE("The job should only run when it is requested.", worker->mNumRuns == 1U);
+
+   // The frame synch message runs the frame.
+   job->Request();
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(2U, worker->mNumRuns);
+
+   job->RemoveFromFrameBudget();
+   CPPUNIT_ASSERT(job->GetFrameBudget() == NULL);
+   CPPUNIT_ASSERT_EQUAL(0U, mFrameBudget->GetNumJobs());
+
+   mFrameBudget->AddJob(*job);
+   mGM->RemoveComponent(*mFrameBudget);
+   CPPUNIT_ASSERT_MESSAGE("Removing the component from the GM should let go of the jobs.", job->GetFrameBudget() == NULL);
+}
+
+/////////////////////////////////////////////////////////
+void FrameBudgetComponentTests::TestPriorityOrder()
+{
+   std::vector<std::string> order;
+   dtCore::RefPtr<BudgetWorker> low = new BudgetWorker("Low", &order);
+   dtCore::RefPtr<BudgetWorker> normal = new BudgetWorker("Normal", &order);
+   dtCore::RefPtr<BudgetWorker> high = new BudgetWorker("High", &order);
+
+   dtCore::RefPtr<FrameBudgetJob> lowJob = MakeJob(*low, "A", FrameBudgetJob::PRIORITY_LOW);
+   dtCore::RefPtr<FrameBudgetJob> normalJob = MakeJob(*normal, "B", FrameBudgetJob::PRIORITY_NORMAL);
+   dtCore::RefPtr<FrameBudgetJob> highJob = MakeJob(*high, "B", FrameBudgetJob::PRIORITY_HIGH);
+
+   mFrameBudget->AddJob(*lowJob);
+   mFrameBudget->AddJob(*normalJob);
+   mFrameBudget->AddJob(*highJob);
+
+   lowJob->Request();
+   normalJob->Request();
+   highJob->Request();
+   mFrameBudget->RunFrame();
+
+   CPPUNIT_ASSERT_EQUAL(size_t(3), order.size());
+   CPPUNIT_ASSERT_EQUAL(std::string("High"), order[0]);
+   CPPUNIT_ASSERT_EQUAL(std::string("Normal"), order[1]);
+   CPPUNIT_ASSERT_EQUAL(std::string("Low"), order[2]);
+
+   const FrameBudgetComponent::SubsystemStats* stats = mFrameBudget->GetSubsystemStats("B");
+   CPPUNIT_ASSERT(stats != NULL);
+   CPPUNIT_ASSERT_EQUAL(2U, stats->mNumRuns);
+   CPPUNIT_ASSERT(mFrameBudget->GetSubsystemStats("C") == NULL);
+   CPPUNIT_ASSERT(!mFrameBudget->IsOverBudget());
+}
+
+/////////////////////////////////////////////////////////
+void FrameBudgetComponentTests::TestDeferAndForce()
+{
+   mFrameBudget->SetFrameBudgetMillis(2.0);
+
+   dtCore::RefPtr<BudgetWorker> first = new BudgetWorker("First");
+   dtCore::RefPtr<BudgetWorker> second = new BudgetWorker("Second");
+   first->mMillis = 1.0;
+
+   dtCore::RefPtr<FrameBudgetJob> firstJob = MakeJob(*first, "First", FrameBudgetJob::PRIORITY_HIGH);
+   dtCore::RefPtr<FrameBudgetJob> secondJob = MakeJob(*second, "Second", FrameBudgetJob::PRIORITY_LOW);
+   secondJob->SetExpectedMillis(5.0);
+   secondJob->SetMaxDeferredFrames(2);
+
+   mFrameBudget->AddJob(*firstJob);
+   mFrameBudget->AddJob(*secondJob);
+
+   for (unsigned i = 0; i < 2; ++i)
+   {
+      firstJob->Request();
+      secondJob->Request();
+      mFrameBudget->RunFrame();
+
+      CPPUNIT_ASSERT_EQUAL(i + 1, first->mNumRuns);
+      CPPUNIT_ASSERT_MESSAGE("The low priority job doesn't fit after the first one, so it should wait.", second->mNumRuns == 0U);
+      CPPUNIT_ASSERT_EQUAL(i + 1, secondJob->GetFramesDeferred());
+      CPPUNIT_ASSERT(secondJob->IsRequested());
+      CPPUNIT_ASSERT(mFrameBudget->IsOverBudget());
+   }
+
+   firstJob->Request();
+   mFrameBudget->RunFrame();
+   CPPUNIT_ASSERT_MESSAGE("The job should run once it has waited its maximum frames.", second->mNumRuns == 1U);
+   CPPUNIT_ASSERT_EQUAL(0U, secondJob->GetFramesDeferred());
+
+   const FrameBudgetComponent::SubsystemStats* stats = mFrameBudget->GetSubsystemStats("Second");
+   CPPUNIT_ASSERT(stats != NULL);
+   CPPUNIT_ASSERT_EQUAL(2U, stats->mNumDeferred);
+   CPPUNIT_ASSERT_EQUAL(1U, stats->mNumForced);
+
+   // On its own it always gets to run.
+   secondJob->SetExpectedMillis(5.0);
+   secondJob->Request();
+   mFrameBudget->RunFrame();
+   CPPUNIT_ASSERT_EQUAL(2U, second->mNumRuns);
+}
+
+/////////////////////////////////////////////////////////
+void FrameBudgetComponentTests::TestOverrunReport()
+{
+   mFrameBudget->SetFrameBudgetMillis(1.0);
+
+   dtCore::RefPtr<BudgetWorker> slow = new BudgetWorker("Slow");
+   slow->mMillis = 3.0;
+   dtCore::RefPtr<FrameBudgetJob> slowJob = MakeJob(*slow, "SlowSystem", FrameBudgetJob::PRIORITY_NORMAL);
+   mFrameBudget->AddJob(*slowJob);
+
+   slowJob->Request();
+   mFrameBudget->RunFrame();
+
+   CPPUNIT_ASSERT_EQUAL(1U, slow->mNumRuns);
+   CPPUNIT_ASSERT(mFrameBudget->IsOverBudget());
+   CPPUNIT_ASSERT(mFrameBudget->GetLastFrameMillis() >= 3.0);
+   CPPUNIT_ASSERT(slowJob->GetLastMillis() >= 3.0);
+   CPPUNIT_ASSERT(slowJob->GetExpectedMillis() > 0.0);
+
+   const FrameBudgetComponent::SubsystemStats* stats = mFrameBudget->GetSubsystemStats("SlowSystem");
+   CPPUNIT_ASSERT(stats != NULL);
+   CPPUNIT_ASSERT_EQUAL(1U, stats->mNumOverruns);
+   CPPUNIT_ASSERT(stats->mMaxMillis >= 3.0);
+
+   std::ostringstream report;
+   mFrameBudget->WriteReport(report);
+   CPPUNIT_ASSERT(report.str().find("SlowSystem: runs 1") != std::string::npos);
+   CPPUNIT_ASSERT(report.str().find("overruns 1") != std::string::npos);
+
+   mFrameBudget->ResetStats();
+   CPPUNIT_ASSERT(mFrameBudget->GetSubsystemStats("SlowSystem") == NULL);
+}
@@ -0,0 +1,289 @@
+/* -*-c++-*-
+* Simulation Core - FrameProfilerTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/system.h>
+#include <dtCore/scene.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/testcomponent.h>
+#include <dtUtil/threadpool.h>
+
+#include <SimCore/Components/ProfilerComponent.h>
+#include <SimCore/FrameProfiler.h>
+#include <SimCore/Messages.h>
+#include <SimCore/MessageType.h>
+
+#include <osg/Timer>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+#include <sstream>
+
+using SimCore::FrameProfiler;
+
+////////////////////////////////////////////////////////
+static void ProfiledWork(double millis)
+{
+   SIMCORE_PROFILE_SCOPE("FrameProfilerTests Work");
+
+   osg::Timer_t startTick = osg::Timer::instance()->tick();
+   while (osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick()) < millis)
+   {
+   }
+}
+
+////////////////////////////////////////////////////////
+// Records a few zones on a thread pool thread.
+class ProfiledTask : public dtUtil::ThreadPoolTask
+{
+   public:
+      virtual void operator()()
+      {
+         for (unsigned i = 0; i < 3; ++i)
+         {
+            ProfiledWork(0.1);
+         }
+         SIMCORE_PROFILE_COUNT("FrameProfilerTests Count", 5);
+      }
+};
+
+class FrameProfilerTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(FrameProfilerTests);
+      CPPUNIT_TEST(TestZones);
+      CPPUNIT_TEST(TestDisabled);
+      CPPUNIT_TEST(TestTimesAndCounts);
+      CPPUNIT_TEST(TestThreads);
+      CPPUNIT_TEST(TestChromeTrace);
+      CPPUNIT_TEST(TestProfilerComponent);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestZones();
+      void TestDisabled();
+      void TestTimesAndCounts();
+      void TestThreads();
+      void TestChromeTrace();
+      void TestProfilerComponent();
+
+   private:
+      FrameProfiler::ZoneStats GetStats(const std::string& zoneName);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameProfilerTests);
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::setUp()
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+   profiler.SetEnabled(false);
+   profiler.Collect();
+   profiler.ResetStats();
+   profiler.ClearTrace();
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::tearDown()
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+   profiler.SetEnabled(false);
+   profiler.SetTraceEnabled(false);
+   profiler.Collect();
+   profiler.ResetStats();
+   profiler.ClearTrace();
+}
+
+/////////////////////////////////////////////////////////
+FrameProfiler::ZoneStats FrameProfilerTests::GetStats(const std::string& zoneName)
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+   return profiler.GetZoneStats(profiler.FindZone(zoneName));
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::TestZones()
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+
+   FrameProfiler::ZoneId zone = profiler.RegisterZone("FrameProfilerTests Zone", "Test");
+   CPPUNIT_ASSERT(zone != FrameProfiler::INVALID_ZONE);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Registering a zone again should give the same id.",
+            zone, profiler.RegisterZone("FrameProfilerTests Zone"));
+   CPPUNIT_ASSERT_EQUAL(zone, profiler.FindZone("FrameProfilerTests Zone"));
+   CPPUNIT_ASSERT_EQUAL(std::string("FrameProfilerTests Zone"), profiler.GetZoneName(zone));
+   CPPUNIT_ASSERT(profiler.FindZone("FrameProfilerTests Missing") == FrameProfiler::INVALID_ZONE);
+   CPPUNIT_ASSERT(profiler.GetZoneName(FrameProfiler::INVALID_ZONE).empty());
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::TestDisabled()
+{
+   CPPUNIT_ASSERT(!FrameProfiler::IsEnabled());
+
+   ProfiledWork(0.0);
+   SIMCORE_PROFILE_COUNT("FrameProfilerTests Count", 1);
+   FrameProfiler::GetInstance().Collect();
+
+   CPPUNIT_ASSERT_EQUAL(0U, GetStats("FrameProfilerTests Work").mNumCalls);
+   CPPUNIT_ASSERT_EQUAL(0LL, GetStats("FrameProfilerTests Count").mCount);
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::TestTimesAndCounts()
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+   profiler.SetEnabled(true);
+
+   ProfiledWork(1.0);
+   ProfiledWork(2.0);
+   for (unsigned i = 0; i < 4; ++i)
+   {
+      SIMCORE_PROFILE_COUNT("FrameProfilerTests Count", 2);
+   }
+
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing shows up in the stats until it is collected.",
+            0U, GetStats("FrameProfilerTests Work").mNumCalls);
+
+   profiler.Collect();
+
+   FrameProfiler::ZoneStats stats = GetStats("FrameProfilerTests Work");
+   CPPUNIT_ASSERT_EQUAL(2U, stats.mNumCalls);
+   CPPUNIT_ASSERT(stats.mTotalMillis >= 3.0);
+   CPPUNIT_ASSERT(stats.mMaxMillis >= 2.0);
+   CPPUNIT_ASSERT(stats.mMaxMillis <= stats.mTotalMillis);
+   CPPUNIT_ASSERT_EQUAL(8LL, GetStats("FrameProfilerTests Count").mCount);
+
+   std::ostringstream ss;
+   profiler.WriteStats(ss);
+   CPPUNIT_ASSERT(ss.str().find("FrameProfilerTests Work: calls 2") != std::string::npos);
+   CPPUNIT_ASSERT(ss.str().find("FrameProfilerTests Count: count 8") != std::string::npos);
+
+   profiler.ResetStats();
+   CPPUNIT_ASSERT_EQUAL(0U, GetStats("FrameProfilerTests Work").mNumCalls);
+   std::ostringstream emptyStream;
+   profiler.WriteStats(emptyStream);
+   CPPUNIT_ASSERT_MESSAGE("Unused zones should be left out of the stats.", emptyStream.str().empty());
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::TestThreads()
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+   profiler.SetEnabled(true);
+
+   ProfiledWork(0.1);
+
+   dtCore::RefPtr<ProfiledTask> task = new ProfiledTask;
+   dtUtil::ThreadPool::AddTask(*task, dtUtil::ThreadPool::BACKGROUND);
+   task->WaitUntilComplete();
+
+   profiler.Collect();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The records of both threads should be collected.",
+            4U, GetStats("FrameProfilerTests Work").mNumCalls);
+   CPPUNIT_ASSERT_EQUAL(5LL, GetStats("FrameProfilerTests Count").mCount);
+   CPPUNIT_ASSERT_EQUAL(0U, profiler.GetNumDroppedRecords());
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::TestChromeTrace()
+{
+   FrameProfiler& profiler = FrameProfiler::GetInstance();
+   profiler.SetEnabled(true);
+
+   ProfiledWork(0.1);
+   profiler.Collect();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing is traced until tracing is turned on.", 0U, profiler.GetNumTraceEvents());
+
+   profiler.SetTraceEnabled(true);
+   ProfiledWork(0.1);
+   SIMCORE_PROFILE_COUNT("FrameProfilerTests Count", 3);
+   profiler.Collect();
+   CPPUNIT_ASSERT_EQUAL(2U, profiler.GetNumTraceEvents());
+
+   std::ostringstream ss;
+   profiler.WriteChromeTrace(ss);
+   std::string trace = ss.str();
+   CPPUNIT_ASSERT(trace.find("{\"traceEvents\":[") == 0);
+   CPPUNIT_ASSERT(trace.find("\"name\":\"FrameProfilerTests Work\"") != std::string::npos);
+   CPPUNIT_ASSERT(trace.find("\"ph\":\"X\"") != std::string::npos);
+   CPPUNIT_ASSERT(trace.find("\"ph\":\"C\"") != std::string::npos);
+   CPPUNIT_ASSERT(trace.find("\"args\":{\"value\":3.0}") != std::string::npos);
+
+   profiler.SetMaxTraceEvents(2);
+   ProfiledWork(0.1);
+   profiler.Collect();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The trace should stop growing at the limit.", 2U, profiler.GetNumTraceEvents());
+   profiler.SetMaxTraceEvents(FrameProfiler::DEFAULT_MAX_TRACE_EVENTS);
+
+   profiler.ClearTrace();
+   CPPUNIT_ASSERT_EQUAL(0U, profiler.GetNumTraceEvents());
+}
+
+/////////////////////////////////////////////////////////
+void FrameProfilerTests::TestProfilerComponent()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtABC::Application& app = GetGlobalApplication();
+   dtCore::RefPtr<dtGame::GameManager> gm = new dtGame::GameManager(*app.GetScene());
+   gm->SetApplication(app);
+
+   dtCore::RefPtr<dtGame::TestComponent> tc = new dtGame::TestComponent;
+   gm->AddComponent(*tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   dtCore::RefPtr<SimCore::Components::ProfilerComponent> profilerComp = new SimCore::Components::ProfilerComponent;
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(SimCore::Components::ProfilerComponent::DEFAULT_STATS_INTERVAL, profilerComp->GetStatsInterval(), 1e-5f);
+   profilerComp->SetStatsInterval(0.0f);
+   gm->AddComponent(*profilerComp, dtGame::GameManager::ComponentPriority::LOWER);
+   CPPUNIT_ASSERT_MESSAGE("Adding the component should turn on the profiler.", FrameProfiler::IsEnabled());
+
+   ProfiledWork(0.1);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The component should collect at frame synch.",
+            1U, GetStats("FrameProfilerTests Work").mNumCalls);
+
+   tc->reset();
+   profilerComp->SendStats();
+   dtCore::System::GetInstance().Step();
+
+   dtCore::RefPtr<const SimCore::ProfileStatsMessage> statsMessage =
+            static_cast<const SimCore::ProfileStatsMessage*>(tc->FindProcessMessageOfType(SimCore::MessageType::INFO_PROFILE_STATS).get());
+   CPPUNIT_ASSERT(statsMessage.valid());
+   CPPUNIT_ASSERT(statsMessage->GetNumFrames() >= 1U);
+   CPPUNIT_ASSERT(statsMessage->GetStats().find("FrameProfilerTests Work") != std::string::npos);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Sending the stats should reset them.", 0U, GetStats("FrameProfilerTests Work").mNumCalls);
+
+   gm->RemoveComponent(*profilerComp);
+   CPPUNIT_ASSERT_MESSAGE("Removing the component should turn off the profiler.", !FrameProfiler::IsEnabled());
+
+   dtCore::System::GetInstance().Stop();
+   gm->DeleteAllActors(true);
+}
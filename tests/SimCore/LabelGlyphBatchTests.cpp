@@ -0,0 +1,234 @@
+/* -*-c++-*-
+* Simulation Core - LabelGlyphBatchTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <SimCore/Components/LabelGlyphBatch.h>
+
+#include <dtCore/project.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/mathdefines.h>
+
+#include <osg/Image>
+#include <osg/Texture2D>
+#include <osg/io_utils>
+
+typedef SimCore::Components::LabelGlyphAtlas LabelGlyphAtlas;
+typedef SimCore::Components::LabelGlyphBatch LabelGlyphBatch;
+
+//////////////////////////////////////////////////////////////
+// UNIT TESTS
+//////////////////////////////////////////////////////////////
+// These only check the vertex data, so they don't need a window or a gl context.
+class LabelGlyphBatchTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(LabelGlyphBatchTests);
+
+      CPPUNIT_TEST(TestGridAtlas);
+      CPPUNIT_TEST(TestVertexData);
+      CPPUNIT_TEST(TestDepthOrder);
+      CPPUNIT_TEST(TestIncrementalLayout);
+      CPPUNIT_TEST(TestBackground);
+      CPPUNIT_TEST(TestFontAtlas);
+
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+
+      void setUp()
+      {
+         // A 16 x 16 grid of 8 x 10 pixel glyphs starting with the space.
+         mAtlas = new LabelGlyphAtlas();
+         mAtlas->SetupGrid(16, 16, ' ', 8.0f, 10.0f);
+         mBatch = new LabelGlyphBatch(*mAtlas);
+         mBatch->SetScreenSize(800.0f, 600.0f);
+      }
+
+      void tearDown()
+      {
+         mBatch = NULL;
+         mAtlas = NULL;
+      }
+
+      void TestGridAtlas()
+      {
+         const LabelGlyphAtlas::Glyph* space = mAtlas->GetGlyph(' ');
+         CPPUNIT_ASSERT(space != NULL);
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec2(0.0f, 15.0f / 16.0f), space->mTexMin, 0.0001f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec2(1.0f / 16.0f, 1.0f), space->mTexMax, 0.0001f));
+
+         // 'A' is 33 cells after the space, so it is in the second column of the third row.
+         const LabelGlyphAtlas::Glyph* a = mAtlas->GetGlyph('A');
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec2(1.0f / 16.0f, 13.0f / 16.0f), a->mTexMin, 0.0001f));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0f, a->mAdvance, 0.0001f);
+
+         CPPUNIT_ASSERT_MESSAGE("Characters not in the atlas should use the question mark.",
+                  mAtlas->GetGlyph(7) == mAtlas->GetGlyph('?'));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0f, mAtlas->GetLineHeight(), 0.0001f);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(24.0f, mAtlas->GetTextWidth("A B"), 0.0001f);
+      }
+
+      void TestVertexData()
+      {
+         osg::Vec4 red(1.0f, 0.0f, 0.0f, 0.7f);
+         mBatch->BeginFrame();
+         mBatch->SetLabel(dtCore::UniqueId(), "A B", "", red, osg::Vec2(0.5f, 0.5f), 0.5f);
+         mBatch->EndFrame();
+
+         CPPUNIT_ASSERT_EQUAL(1U, mBatch->GetNumLabels());
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The space shouldn't get a quad.", 2U, mBatch->GetNumQuads());
+         CPPUNIT_ASSERT_EQUAL(size_t(8), mBatch->GetVertices().size());
+         CPPUNIT_ASSERT_EQUAL(size_t(8), mBatch->GetTexCoords().size());
+         CPPUNIT_ASSERT_EQUAL(size_t(8), mBatch->GetColors().size());
+
+         // The text is 24 pixels wide, centered on 400, 300.
+         const osg::Vec3Array& verts = mBatch->GetVertices();
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(388.0f, 300.0f, 0.0f), verts[0], 0.0001f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(396.0f, 310.0f, 0.0f), verts[2], 0.0001f));
+         CPPUNIT_ASSERT_MESSAGE("The B should come after the space.",
+                  dtUtil::Equivalent(osg::Vec3(404.0f, 300.0f, 0.0f), verts[4], 0.0001f));
+
+         const LabelGlyphAtlas::Glyph* a = mAtlas->GetGlyph('A');
+         CPPUNIT_ASSERT(dtUtil::Equivalent(a->mTexMin, mBatch->GetTexCoords()[0], 0.0001f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(a->mTexMax, mBatch->GetTexCoords()[2], 0.0001f));
+
+         CPPUNIT_ASSERT_MESSAGE("Without a background, the text should be the label color.",
+                  dtUtil::Equivalent(red, mBatch->GetColors()[5], 0.0001f));
+
+         // Labels not set in a frame go away.
+         mBatch->BeginFrame();
+         mBatch->EndFrame();
+         CPPUNIT_ASSERT_EQUAL(0U, mBatch->GetNumLabels());
+         CPPUNIT_ASSERT_EQUAL(size_t(0), mBatch->GetVertices().size());
+      }
+
+      void TestDepthOrder()
+      {
+         osg::Vec4 nearColor(0.0f, 1.0f, 0.0f, 1.0f);
+         osg::Vec4 farColor(0.0f, 0.0f, 1.0f, 1.0f);
+
+         mBatch->BeginFrame();
+         mBatch->SetLabel(dtCore::UniqueId(), "N", "", nearColor, osg::Vec2(0.25f, 0.5f), 0.2f);
+         mBatch->SetLabel(dtCore::UniqueId(), "F", "", farColor, osg::Vec2(0.75f, 0.5f), 0.9f);
+         mBatch->EndFrame();
+
+         CPPUNIT_ASSERT_EQUAL(2U, mBatch->GetNumQuads());
+         CPPUNIT_ASSERT_MESSAGE("The farthest label should be drawn first.",
+                  dtUtil::Equivalent(farColor, mBatch->GetColors()[0], 0.0001f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(nearColor, mBatch->GetColors()[4], 0.0001f));
+      }
+
+      void TestIncrementalLayout()
+      {
+         dtCore::UniqueId id;
+         osg::Vec4 white(1.0f, 1.0f, 1.0f, 1.0f);
+
+         mBatch->BeginFrame();
+         mBatch->SetLabel(id, "Tank", "", white, osg::Vec2(0.5f, 0.5f), 0.5f);
+         mBatch->EndFrame();
+         CPPUNIT_ASSERT_EQUAL(1U, mBatch->GetNumLayoutsBuilt());
+
+         // Moving the label doesn't lay out the glyphs again.
+         mBatch->BeginFrame();
+         mBatch->SetLabel(id, "Tank", "", white, osg::Vec2(0.25f, 0.5f), 0.4f);
+         mBatch->EndFrame();
+         CPPUNIT_ASSERT_EQUAL(1U, mBatch->GetNumLayoutsBuilt());
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(200.0f - 16.0f, mBatch->GetVertices()[0].x(), 0.0001f);
+
+         mBatch->BeginFrame();
+         mBatch->SetLabel(id, "Tank", "DESTROYED", white, osg::Vec2(0.25f, 0.5f), 0.4f);
+         mBatch->EndFrame();
+         CPPUNIT_ASSERT_EQUAL(2U, mBatch->GetNumLayoutsBuilt());
+         CPPUNIT_ASSERT_EQUAL(13U, mBatch->GetNumQuads());
+         CPPUNIT_ASSERT_MESSAGE("The text should move up a line to make room for the second line.",
+                  dtUtil::Equivalent(osg::Vec3(184.0f, 310.0f, 0.0f), mBatch->GetVertices()[0], 0.0001f));
+      }
+
+      void TestBackground()
+      {
+         mAtlas->SetSolidTexCoord(osg::Vec2(0.99f, 0.01f));
+         osg::Vec4 blue(0.0f, 0.0f, 1.0f, 0.7f);
+
+         mBatch->BeginFrame();
+         mBatch->SetLabel(dtCore::UniqueId(), "AB", "", blue, osg::Vec2(0.5f, 0.5f), 0.5f);
+         mBatch->EndFrame();
+
+         CPPUNIT_ASSERT_EQUAL(3U, mBatch->GetNumQuads());
+         const osg::Vec3Array& verts = mBatch->GetVertices();
+         float padding = LabelGlyphBatch::BACKGROUND_PADDING;
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(392.0f - padding, 300.0f, 0.0f), verts[0], 0.0001f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec3(408.0f + padding, 310.0f, 0.0f), verts[2], 0.0001f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(osg::Vec2(0.99f, 0.01f), mBatch->GetTexCoords()[1], 0.0001f));
+
+         CPPUNIT_ASSERT_MESSAGE("The background should be the label color.",
+                  dtUtil::Equivalent(blue, mBatch->GetColors()[0], 0.0001f));
+         CPPUNIT_ASSERT_MESSAGE("The text over the background should be white.",
+                  dtUtil::Equivalent(osg::Vec4(1.0f, 1.0f, 1.0f, 1.0f), mBatch->GetColors()[4], 0.0001f));
+      }
+
+      void TestFontAtlas()
+      {
+         dtCore::RefPtr<LabelGlyphAtlas> atlas = new LabelGlyphAtlas();
+         CPPUNIT_ASSERT(!atlas->LoadFont("NotAFont.ttf", 14));
+
+         std::string fontFile = dtCore::Project::GetInstance().GetContext() + "/CEGUI/fonts/DejaVuSans.ttf";
+         CPPUNIT_ASSERT_MESSAGE("The atlas should be built from " + fontFile, atlas->LoadFont(fontFile, 14));
+         CPPUNIT_ASSERT(atlas->GetTexture() != NULL);
+         CPPUNIT_ASSERT(atlas->GetLineHeight() >= 14.0f);
+
+         const LabelGlyphAtlas::Glyph* w = atlas->GetGlyph('W');
+         const LabelGlyphAtlas::Glyph* i = atlas->GetGlyph('i');
+         CPPUNIT_ASSERT(w != NULL && w->mValid && i != NULL && i->mValid);
+         CPPUNIT_ASSERT_MESSAGE("The font isn't fixed width.", w->mAdvance > i->mAdvance);
+         CPPUNIT_ASSERT_EQUAL(atlas->GetLineHeight(), w->mHeight);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(w->mAdvance + i->mAdvance, atlas->GetTextWidth("Wi"), 0.0001f);
+         CPPUNIT_ASSERT(w->mTexMax.x() > w->mTexMin.x() && w->mTexMax.y() > w->mTexMin.y());
+
+         // The glyph has some coverage, and the solid texel is opaque.
+         const osg::Image* image = atlas->GetTexture()->getImage();
+         CPPUNIT_ASSERT(image != NULL);
+         unsigned coverage = 0;
+         for (int y = int(w->mTexMin.y() * image->t()); y < int(w->mTexMax.y() * image->t()); ++y)
+         {
+            for (int x = int(w->mTexMin.x() * image->s()); x < int(w->mTexMax.x() * image->s()); ++x)
+            {
+               coverage += image->data(x, y)[3];
+            }
+         }
+         CPPUNIT_ASSERT(coverage > 0);
+
+         CPPUNIT_ASSERT(atlas->HasSolidTexCoord());
+         const osg::Vec2& solid = atlas->GetSolidTexCoord();
+         CPPUNIT_ASSERT_EQUAL(255, int(image->data(int(solid.x() * image->s()), int(solid.y() * image->t()))[3]));
+      }
+
+   private:
+      dtCore::RefPtr<LabelGlyphAtlas> mAtlas;
+      dtCore::RefPtr<LabelGlyphBatch> mBatch;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LabelGlyphBatchTests);
@@ -79,6 +79,7 @@ class MessageTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestToolMessageTypes);
       CPPUNIT_TEST(TestMagnificationMessage);
       CPPUNIT_TEST(TestEmbeddedDataMessage);
+      CPPUNIT_TEST(TestWeaponEventBatchMessage);
 
    CPPUNIT_TEST_SUITE_END();
 
@@ -695,6 +696,87 @@ class MessageTests : public CPPUNIT_NS::TestFixture
          }
       }
 
+      void TestWeaponEventBatchMessage()
+      {
+         try
+         {
+            RefPtr<SimCore::WeaponEventBatchMessage> msg;
+            mGM->GetMessageFactory().CreateMessage(SimCore::MessageType::WEAPON_EVENT_BATCH, msg);
+            CPPUNIT_ASSERT_MESSAGE("The message factory failed to create the message", msg.valid());
+            CPPUNIT_ASSERT_EQUAL(0U, msg->GetEventCount());
+
+            std::vector<SimCore::WeaponEvent> events(3);
+            dtCore::UniqueId shooter;
+            dtCore::UniqueId target;
+
+            events[0].mSendingActorId = shooter;
+            events[0].mTargetId = target;
+            events[0].mMunitionType = "Grenade";
+            events[0].mEventIdentifier = 7;
+            events[0].mQuantityFired = 3;
+            events[0].mRateOfFire = 600;
+            events[0].mFuseType = 2;
+            events[0].mWarheadType = 5;
+            events[0].mLocation.set(1.0f, 2.0f, 3.0f);
+            events[0].mVelocity.set(-4.0f, 5.0f, 6.5f);
+
+            // Indirect detonation from the same shooter
+            events[1] = events[0];
+            events[1].mIsDetonation = true;
+            events[1].mTargetId = dtCore::UniqueId("");
+            events[1].mDetonationResultCode = 4;
+
+            events[2] = events[0];
+            events[2].mIsDetonation = true;
+            events[2].mMunitionType = "Bullet";
+            events[2].mRelativeDetonationLocation.set(0.5f, 0.0f, -1.0f);
+
+            msg->SetEvents(events);
+            CPPUNIT_ASSERT_EQUAL(3U, msg->GetEventCount());
+
+            // Events are appended to the list.
+            std::vector<SimCore::WeaponEvent> fetched(1);
+            CPPUNIT_ASSERT(msg->GetEvents(fetched));
+            CPPUNIT_ASSERT_EQUAL(size_t(4), fetched.size());
+
+            for (unsigned i = 0; i < events.size(); ++i)
+            {
+               const SimCore::WeaponEvent& expected = events[i];
+               const SimCore::WeaponEvent& actual = fetched[i + 1];
+               CPPUNIT_ASSERT_EQUAL(expected.mIsDetonation, actual.mIsDetonation);
+               CPPUNIT_ASSERT_EQUAL(expected.mSendingActorId, actual.mSendingActorId);
+               CPPUNIT_ASSERT_EQUAL(expected.mTargetId, actual.mTargetId);
+               CPPUNIT_ASSERT_EQUAL(expected.mMunitionType, actual.mMunitionType);
+               CPPUNIT_ASSERT_EQUAL(expected.mEventIdentifier, actual.mEventIdentifier);
+               CPPUNIT_ASSERT_EQUAL(expected.mQuantityFired, actual.mQuantityFired);
+               CPPUNIT_ASSERT_EQUAL(expected.mRateOfFire, actual.mRateOfFire);
+               CPPUNIT_ASSERT_EQUAL(expected.mFuseType, actual.mFuseType);
+               CPPUNIT_ASSERT_EQUAL(expected.mWarheadType, actual.mWarheadType);
+               CPPUNIT_ASSERT(expected.mLocation == actual.mLocation);
+               CPPUNIT_ASSERT(expected.mVelocity == actual.mVelocity);
+            }
+            CPPUNIT_ASSERT_EQUAL(int(events[1].mDetonationResultCode), int(fetched[2].mDetonationResultCode));
+            CPPUNIT_ASSERT(events[2].mRelativeDetonationLocation == fetched[3].mRelativeDetonationLocation);
+
+            RefPtr<SimCore::DetonationMessage> detMsg;
+            mGM->GetMessageFactory().CreateMessage(SimCore::MessageType::DETONATION, detMsg);
+            fetched[3].FillDetonationMessage(*detMsg);
+            CPPUNIT_ASSERT_EQUAL(shooter, detMsg->GetSendingActorId());
+            CPPUNIT_ASSERT_EQUAL(target, detMsg->GetAboutActorId());
+            CPPUNIT_ASSERT_EQUAL(std::string("Bullet"), detMsg->GetMunitionType());
+
+            // Bad data is refused without adding anything.
+            dynamic_cast<dtGame::StringMessageParameter*>(msg->GetParameter(SimCore::WeaponEventBatchMessage::PARAM_DATA))->SetValue("garbage");
+            fetched.clear();
+            CPPUNIT_ASSERT(!msg->GetEvents(fetched));
+            CPPUNIT_ASSERT(fetched.empty());
+         }
+         catch(const dtUtil::Exception &ex)
+         {
+            CPPUNIT_FAIL("Exception caught: " + ex.What());
+         }
+      }
+
    private:
 
       RefPtr<dtGame::GameManager> mGM;
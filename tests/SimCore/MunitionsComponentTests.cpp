@@ -29,12 +29,17 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <osg/io_utils>
+#include <osg/Array>
+#include <osg/Geode>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
 #include <osgSim/DOFTransform>
 #include <dtCore/system.h>
 #include <dtCore/refptr.h>
 #include <dtCore/scene.h>
 #include <dtCore/uniqueid.h>
 #include <dtCore/timer.h>
+#include <dtCore/transformable.h>
 
 #include <dtCore/actorproperty.h>
 #include <dtCore/project.h>
@@ -47,8 +52,12 @@
 #include <dtGame/gamemanager.h>
 
 #include <SimCore/Components/DamageHelper.h>
+#include <SimCore/Components/DetonationActorPool.h>
 #include <SimCore/Components/MunitionDamage.h>
 #include <SimCore/Components/MunitionsComponent.h>
+#include <SimCore/Components/MunitionsConfig.h>
+#include <SimCore/Components/MunitionsConfigCache.h>
+#include <SimCore/Components/WeaponEventAggregatorComponent.h>
 #include <SimCore/MessageType.h>
 #include <SimCore/Messages.h>
 
@@ -57,6 +66,8 @@
 #include <SimCore/Actors/MunitionTypeActor.h>
 #include <SimCore/Actors/ViewerMaterialActor.h>
 
+#include <dtUtil/datastream.h>
+#include <dtUtil/fileutils.h>
 #include <dtUtil/mathdefines.h>
 #include <UnitTestMain.h>
 
@@ -97,6 +108,10 @@ namespace SimCore
 
             void ResetTotalProcessedMessages();
 
+            // This function exposes a protected function
+            void RunIsectorForFIDCodes( bool hitEntity, const DetonationMessage& message, int& fidID )
+            { MunitionsComponent::RunIsectorForFIDCodes(hitEntity, message, fidID); }
+
          protected:
             virtual ~TestMunitionsComponent();
 
@@ -156,6 +171,11 @@ namespace SimCore
          CPPUNIT_TEST(TestMessagingDisabled);
          CPPUNIT_TEST(TestMessageProcessing);
          CPPUNIT_TEST(TestMunitionConfigLoading);
+         CPPUNIT_TEST(TestMunitionConfigCache);
+         CPPUNIT_TEST(TestWeaponEventBatchProcessing);
+         CPPUNIT_TEST(TestDetonationActorPool);
+         CPPUNIT_TEST(TestCreatedMunitionsQueue);
+         CPPUNIT_TEST(TestDetonationFIDCode);
          CPPUNIT_TEST(TestMunitionEffectsInfoActorProperties);
          CPPUNIT_TEST(TestMunitionFamilyProperties);
          CPPUNIT_TEST(TestMunitionTypeActorProperties);
@@ -196,6 +216,11 @@ namespace SimCore
             void TestMessagingDisabled();
             void TestMessageProcessing();
             void TestMunitionConfigLoading();
+            void TestMunitionConfigCache();
+            void TestWeaponEventBatchProcessing();
+            void TestDetonationActorPool();
+            void TestCreatedMunitionsQueue();
+            void TestDetonationFIDCode();
             void TestMunitionEffectsInfoActorProperties();
             void TestMunitionFamilyProperties();
             void TestMunitionTypeActorProperties();
@@ -1886,6 +1911,311 @@ namespace SimCore
          //CPPUNIT_ASSERT( table->GetMunitionDamage("High Explosive") != NULL );
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      template<typename T>
+      void AssertOptionalEqual( const std::string& what, const T* expected, const T* actual )
+      {
+         CPPUNIT_ASSERT_MESSAGE( what + " should both exist or both be NULL", (expected == NULL) == (actual == NULL) );
+         if( expected != NULL )
+         {
+            CPPUNIT_ASSERT_MESSAGE( what + " should match", *expected == *actual );
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void AssertTablesEqual( const MunitionDamageTable& expected, const MunitionDamageTable& actual )
+      {
+         CPPUNIT_ASSERT_EQUAL( expected.GetName(), actual.GetName() );
+         CPPUNIT_ASSERT_EQUAL( expected.IsDefault(), actual.IsDefault() );
+         CPPUNIT_ASSERT_EQUAL( expected.GetCount(), actual.GetCount() );
+
+         std::vector<const MunitionDamage*> expectedDamages, actualDamages;
+         expected.GetMunitionDamageList( expectedDamages );
+         actual.GetMunitionDamageList( actualDamages );
+         CPPUNIT_ASSERT_EQUAL( expectedDamages.size(), actualDamages.size() );
+
+         for( size_t i = 0; i < expectedDamages.size(); ++i )
+         {
+            const MunitionDamage& e = *expectedDamages[i];
+            const MunitionDamage& a = *actualDamages[i];
+            CPPUNIT_ASSERT_EQUAL( e.GetName(), a.GetName() );
+            CPPUNIT_ASSERT_EQUAL( e.GetCutoffRange(), a.GetCutoffRange() );
+            CPPUNIT_ASSERT_EQUAL( e.GetNewtonForce(), a.GetNewtonForce() );
+            CPPUNIT_ASSERT_EQUAL( e.GetAccumulationFactor(), a.GetAccumulationFactor() );
+            AssertOptionalEqual( e.GetName() + " direct fire", e.GetDirectFireProbabilities(), a.GetDirectFireProbabilities() );
+            AssertOptionalEqual( e.GetName() + " indirect fire", e.GetIndirectFireProbabilities(), a.GetIndirectFireProbabilities() );
+            AssertOptionalEqual( e.GetName() + " range 1/3", e.GetDamageRanges1_3(), a.GetDamageRanges1_3() );
+            AssertOptionalEqual( e.GetName() + " range 2/3", e.GetDamageRanges2_3(), a.GetDamageRanges2_3() );
+            AssertOptionalEqual( e.GetName() + " range max", e.GetDamageRangesMax(), a.GetDamageRangesMax() );
+         }
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponentTests::TestWeaponEventBatchProcessing()
+      {
+         dtCore::RefPtr<WeaponEventAggregatorComponent> aggregator = new WeaponEventAggregatorComponent;
+         CPPUNIT_ASSERT( aggregator->GetSendToNetwork() );
+         aggregator->SetSendToNetwork( false );
+         mGM->AddComponent( *aggregator, dtGame::GameManager::ComponentPriority::NORMAL );
+         dtCore::System::GetInstance().Step();
+
+         CPPUNIT_ASSERT_EQUAL( 0U, mDamageComp->GetNumWeaponEventBatchesProcessed() );
+
+         SimCore::WeaponEvent shot;
+         shot.mMunitionType = "Munition1";
+         shot.mLocation.set( 10.0f, 20.0f, 30.0f );
+         SimCore::WeaponEvent detonation( shot );
+         detonation.mIsDetonation = true;
+
+         aggregator->QueueEvent( shot );
+         aggregator->QueueEvent( detonation );
+         aggregator->QueueEvent( detonation );
+         CPPUNIT_ASSERT_EQUAL( 3U, aggregator->GetNumQueuedEvents() );
+         CPPUNIT_ASSERT_EQUAL( 0U, aggregator->GetNumBatchesSent() );
+
+         // The batch goes out at the end of the frame and is processed on the next.
+         dtCore::System::GetInstance().Step();
+         dtCore::System::GetInstance().Step();
+
+         CPPUNIT_ASSERT_EQUAL( 0U, aggregator->GetNumQueuedEvents() );
+         CPPUNIT_ASSERT_EQUAL( 1U, aggregator->GetNumBatchesSent() );
+         CPPUNIT_ASSERT_EQUAL( 3U, aggregator->GetNumEventsSent() );
+         CPPUNIT_ASSERT_EQUAL( 2U, aggregator->GetNumMessagesSaved() );
+
+         CPPUNIT_ASSERT_EQUAL( 1U, mDamageComp->GetNumWeaponEventBatchesProcessed() );
+         CPPUNIT_ASSERT_EQUAL( 3U, mDamageComp->GetNumBatchedWeaponEventsProcessed() );
+
+         // A full queue is sent right away.
+         aggregator->SetMaxEventsPerBatch( 2 );
+         aggregator->QueueEvent( shot );
+         CPPUNIT_ASSERT_EQUAL( 1U, aggregator->GetNumQueuedEvents() );
+         aggregator->QueueEvent( shot );
+         CPPUNIT_ASSERT_EQUAL( 0U, aggregator->GetNumQueuedEvents() );
+         CPPUNIT_ASSERT_EQUAL( 2U, aggregator->GetNumBatchesSent() );
+
+         aggregator->QueueEvent( shot );
+         aggregator->ClearQueue();
+         aggregator->Flush();
+         CPPUNIT_ASSERT_EQUAL( 2U, aggregator->GetNumBatchesSent() );
+
+         aggregator->ResetStatistics();
+         CPPUNIT_ASSERT_EQUAL( 0U, aggregator->GetNumEventsSent() );
+
+         mGM->RemoveComponent( *aggregator );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponentTests::TestDetonationFIDCode()
+      {
+         // A 10 meter patch of terrain at the origin, coded the way the OpenFlight loader codes it.
+         osg::ShapeDrawable* drawable = new osg::ShapeDrawable(new osg::Box(osg::Vec3(), 10.0f));
+         osg::IntArray* codes = new osg::IntArray();
+         codes->push_back(42);
+         drawable->getOrCreateStateSet()->setUserData(codes);
+         osg::Geode* geode = new osg::Geode();
+         geode->addDrawable(drawable);
+         dtCore::RefPtr<dtCore::Transformable> terrain = new dtCore::Transformable("CodedTerrain");
+         terrain->GetMatrixNode()->addChild(geode);
+         mGM->GetScene().AddChild(terrain.get());
+
+         dtCore::RefPtr<DetonationMessage> msg;
+         mGM->GetMessageFactory().CreateMessage( SimCore::MessageType::DETONATION, msg );
+         msg->SetDetonationLocation( osg::Vec3(0.0f, 0.0f, 5.0f) );
+
+         int fidID = -1;
+         mDamageComp->RunIsectorForFIDCodes(false, *msg, fidID);
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("The detonation should pick up the FID code of the terrain it hit.", 42, fidID);
+
+         // Off the terrain, the code goes back to the default.
+         msg->SetDetonationLocation( osg::Vec3(500.0f, 0.0f, 5.0f) );
+         mDamageComp->RunIsectorForFIDCodes(false, *msg, fidID);
+         CPPUNIT_ASSERT_EQUAL(0, fidID);
+
+         mGM->GetScene().RemoveChild(terrain.get());
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponentTests::TestDetonationActorPool()
+      {
+         typedef SimCore::Actors::DetonationActor DetActor;
+
+         CPPUNIT_ASSERT( mDamageComp->GetUseDetonationPool() );
+         CPPUNIT_ASSERT_EQUAL( 0U, mDamageComp->GetDetonationPoolPreloadCount() );
+
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> prototype;
+         mGM->CreateActor( *SimCore::Actors::EntityActorRegistry::DETONATION_ACTOR_TYPE, prototype );
+         prototype->SetInitialOwnership( dtGame::GameActorProxy::Ownership::PROTOTYPE );
+         mGM->AddActor( *prototype, false, false );
+
+         DetonationActorPool& pool = mDamageComp->GetDetonationActorPool();
+         pool.ResetStatistics();
+
+         bool reused = true;
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> detonation
+            = pool.Acquire( prototype->GetId(), DetActor::IMPACT_ENTITY, reused );
+         CPPUNIT_ASSERT( detonation.valid() );
+         CPPUNIT_ASSERT( ! reused );
+
+         DetActor* detActor = detonation->GetDrawable<DetActor>();
+         CPPUNIT_ASSERT( detActor->GetPool() == &pool );
+         CPPUNIT_ASSERT_EQUAL( DetActor::IMPACT_ENTITY, detActor->GetImpactType() );
+
+         // Pooled detonations wait to be told to detonate.
+         mGM->AddActor( *detonation, false, false );
+         CPPUNIT_ASSERT( ! detActor->IsDetonating() );
+         detActor->Detonate();
+         CPPUNIT_ASSERT( detActor->IsDetonating() );
+         CPPUNIT_ASSERT( pool.IsPooled( detonation->GetId() ) );
+         CPPUNIT_ASSERT( ! pool.IsIdle( detonation->GetId() ) );
+
+         CPPUNIT_ASSERT( pool.Release( *detonation ) );
+         CPPUNIT_ASSERT( ! detActor->IsDetonating() );
+         CPPUNIT_ASSERT( pool.IsIdle( detonation->GetId() ) );
+         CPPUNIT_ASSERT_EQUAL( 1U, pool.GetNumIdle() );
+         dtCore::System::GetInstance().Step();
+         CPPUNIT_ASSERT_MESSAGE( "Idle detonations stay in the game manager.",
+            mGM->FindActorById( detonation->GetId() ) != NULL );
+
+         // The same impact type reuses it, a different one doesn't.
+         CPPUNIT_ASSERT( pool.Acquire( prototype->GetId(), DetActor::IMPACT_ENTITY, reused ) == detonation );
+         CPPUNIT_ASSERT( reused );
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> groundDetonation
+            = pool.Acquire( prototype->GetId(), DetActor::IMPACT_TERRAIN, reused );
+         CPPUNIT_ASSERT( ! reused );
+         CPPUNIT_ASSERT( groundDetonation != detonation );
+         mGM->AddActor( *groundDetonation, false, false );
+
+         CPPUNIT_ASSERT_EQUAL( 3U, pool.GetStatistics().mAcquired );
+         CPPUNIT_ASSERT_EQUAL( 1U, pool.GetStatistics().mHits );
+         CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f / 3.0f, pool.GetStatistics().GetHitRate(), 0.0001f );
+
+         // Detonations past the idle limit are deleted.
+         pool.SetMaxIdlePerType( 0 );
+         CPPUNIT_ASSERT( pool.Release( *detonation ) );
+         CPPUNIT_ASSERT( ! pool.IsPooled( detonation->GetId() ) );
+         CPPUNIT_ASSERT_EQUAL( 1U, pool.GetStatistics().mDiscarded );
+         dtCore::System::GetInstance().Step();
+         CPPUNIT_ASSERT( mGM->FindActorById( detonation->GetId() ) == NULL );
+
+         // Deleting a pooled detonation removes it from the pool.
+         mGM->DeleteActor( *groundDetonation );
+         dtCore::System::GetInstance().Step();
+         CPPUNIT_ASSERT( ! pool.IsPooled( groundDetonation->GetId() ) );
+         CPPUNIT_ASSERT_EQUAL( 0U, pool.GetNumPooled() );
+
+         pool.SetMaxIdlePerType( DetonationActorPool::DEFAULT_MAX_IDLE_PER_TYPE );
+         CPPUNIT_ASSERT_EQUAL( 2U, pool.Preload( prototype->GetId(), DetActor::IMPACT_HUMAN, 2 ) );
+         CPPUNIT_ASSERT_EQUAL( 2U, pool.GetNumIdle() );
+
+         pool.RecordSpawnTime( 2.0 );
+         pool.RecordSpawnTime( 4.0 );
+         CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, pool.GetStatistics().GetAverageSpawnTimeMS(), 0.0001 );
+         CPPUNIT_ASSERT_DOUBLES_EQUAL( 4.0, pool.GetStatistics().mMaxSpawnTimeMS, 0.0001 );
+
+         pool.Clear();
+         CPPUNIT_ASSERT_EQUAL( 0U, pool.GetNumPooled() );
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponentTests::TestCreatedMunitionsQueue()
+      {
+         typedef SimCore::Actors::DetonationActor DetActor;
+
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> prototype;
+         mGM->CreateActor( *SimCore::Actors::EntityActorRegistry::DETONATION_ACTOR_TYPE, prototype );
+         prototype->SetInitialOwnership( dtGame::GameActorProxy::Ownership::PROTOTYPE );
+         mGM->AddActor( *prototype, false, false );
+
+         DetonationActorPool& pool = mDamageComp->GetDetonationActorPool();
+         bool reused = false;
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> first
+            = pool.Acquire( prototype->GetId(), DetActor::IMPACT_ENTITY, reused );
+         dtCore::RefPtr<SimCore::Actors::DetonationActorProxy> second
+            = pool.Acquire( prototype->GetId(), DetActor::IMPACT_ENTITY, reused );
+         mGM->AddActor( *first, false, false );
+         mGM->AddActor( *second, false, false );
+
+         mDamageComp->ClearCreatedMunitionsQueue();
+         mDamageComp->SetMaximumActiveMunitions( 10 );
+         mDamageComp->AddMunitionToCreatedMunitionsQueue( first->GetId() );
+         mDamageComp->AddMunitionToCreatedMunitionsQueue( second->GetId() );
+         // Reusing the first detonation replaces its entry rather than adding one.
+         mDamageComp->AddMunitionToCreatedMunitionsQueue( first->GetId() );
+         CPPUNIT_ASSERT_EQUAL( 2U, mDamageComp->GetNumCreatedMunitions() );
+
+         // The replaced entry is skipped, so the second detonation is now the oldest.
+         mDamageComp->RemoveOldestMunitionFromQueue();
+         CPPUNIT_ASSERT( pool.IsIdle( second->GetId() ) );
+         CPPUNIT_ASSERT( ! pool.IsIdle( first->GetId() ) );
+         CPPUNIT_ASSERT_EQUAL( 1U, mDamageComp->GetNumCreatedMunitions() );
+
+         mDamageComp->RemoveOldestMunitionFromQueue();
+         CPPUNIT_ASSERT( pool.IsIdle( first->GetId() ) );
+         CPPUNIT_ASSERT_EQUAL( 0U, mDamageComp->GetNumCreatedMunitions() );
+
+         // Lowering the maximum releases the oldest ones.
+         CPPUNIT_ASSERT( pool.Acquire( prototype->GetId(), DetActor::IMPACT_ENTITY, reused ).valid() );
+         CPPUNIT_ASSERT( pool.Acquire( prototype->GetId(), DetActor::IMPACT_ENTITY, reused ).valid() );
+         mDamageComp->AddMunitionToCreatedMunitionsQueue( first->GetId() );
+         mDamageComp->AddMunitionToCreatedMunitionsQueue( second->GetId() );
+         mDamageComp->SetMaximumActiveMunitions( 1 );
+         CPPUNIT_ASSERT_EQUAL( 1U, mDamageComp->GetNumCreatedMunitions() );
+         CPPUNIT_ASSERT( pool.IsIdle( first->GetId() ) );
+         CPPUNIT_ASSERT( ! pool.IsIdle( second->GetId() ) );
+
+         pool.Clear();
+         mDamageComp->ClearCreatedMunitionsQueue();
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void MunitionsComponentTests::TestMunitionConfigCache()
+      {
+         std::string xmlPath = dtCore::Project::GetInstance()
+            .GetResourcePath( dtCore::ResourceDescriptor( "Configs:UnitTestsConfig.xml" ) );
+         CPPUNIT_ASSERT( ! xmlPath.empty() );
+
+         MunitionsConfigCache::TableList xmlTables;
+         dtCore::RefPtr<MunitionsConfig> parser = new MunitionsConfig();
+         CPPUNIT_ASSERT_EQUAL( 1U, parser->LoadMunitionTables( xmlPath, xmlTables ) );
+
+         // Round trip through a cache file.
+         const std::string cachePath( "TestMunitionConfigCache" + MunitionsConfigCache::CACHE_FILE_EXTENSION );
+         dtCore::RefPtr<MunitionsConfigCache> cache = new MunitionsConfigCache();
+         CPPUNIT_ASSERT( cache->Save( xmlPath, cachePath, xmlTables ) );
+
+         MunitionsConfigCache::TableList cachedTables;
+         CPPUNIT_ASSERT_EQUAL( 1U, cache->Load( xmlPath, cachePath, cachedTables ) );
+         CPPUNIT_ASSERT_EQUAL( xmlTables.size(), cachedTables.size() );
+         for( size_t i = 0; i < xmlTables.size(); ++i )
+         {
+            AssertTablesEqual( *xmlTables[i], *cachedTables[i] );
+         }
+         dtUtil::FileUtils::GetInstance().FileDelete( cachePath );
+
+         // A cache compiled from another version of the xml is refused.
+         MunitionsConfigCache::SourceStamp stamp;
+         CPPUNIT_ASSERT( MunitionsConfigCache::GetSourceStamp( xmlPath, stamp ) );
+         dtUtil::DataStream ds;
+         cache->Encode( ds, stamp, xmlTables );
+
+         dtUtil::DataStream currentStream( ds.GetBuffer(), ds.GetBufferSize(), false );
+         MunitionsConfigCache::TableList decodedTables;
+         CPPUNIT_ASSERT( cache->Decode( currentStream, stamp, decodedTables ) );
+         CPPUNIT_ASSERT_EQUAL( size_t(1), decodedTables.size() );
+
+         MunitionsConfigCache::SourceStamp newerStamp( stamp );
+         newerStamp.mModifiedTime += 1.0;
+         dtUtil::DataStream staleStream( ds.GetBuffer(), ds.GetBufferSize(), false );
+         MunitionsConfigCache::TableList staleTables;
+         CPPUNIT_ASSERT( ! cache->Decode( staleStream, newerStamp, staleTables ) );
+         CPPUNIT_ASSERT( staleTables.empty() );
+
+         // The component loads the same tables whether or not it uses the cache.
+         mDamageComp->SetUseMunitionConfigCache( false );
+         CPPUNIT_ASSERT_EQUAL( 1U, mDamageComp->LoadMunitionDamageTables( "Configs:UnitTestsConfig.xml" ) );
+         AssertTablesEqual( *xmlTables[0], *mDamageComp->GetMunitionDamageTable( xmlTables[0]->GetName() ) );
+      }
+
       //////////////////////////////////////////////////////////////////////////
       void MunitionsComponentTests::TestMunitionEffectsInfoActorProperties()
       {
@@ -2554,6 +2884,8 @@ namespace SimCore
          CPPUNIT_ASSERT( ! effectMgr->ApplyMunitionEffect( pos, initialVelocity, *effectsInfo, *effectRequest ) );
          CPPUNIT_ASSERT( ! effectMgr->ApplyMunitionEffect( pos, initialVelocity, *effectsInfo, *effectRequest ) );
          CPPUNIT_ASSERT( effectMgr->GetMunitionEffectCount() == unsigned(maxTracerEffects) );
+         // --- The tracer time to impact is found for all of them at once on the next update.
+         CPPUNIT_ASSERT_EQUAL( unsigned(maxTracerEffects), effectMgr->GetNumPendingImpactQueries() );
          CPPUNIT_ASSERT( scene->GetNumberOfAddedDrawable() == oldSceneCount + maxTracerEffects );
 
          // --- Add effects without a limit
@@ -2582,7 +2914,9 @@ namespace SimCore
          updateDelta = 1.0f;
          CPPUNIT_ASSERT( effectMgr->GetMunitionEffectActiveCount() == activeCount );
          CPPUNIT_ASSERT( effectMgr->GetMunitionEffectCount() == activeCount );
+         CPPUNIT_ASSERT_EQUAL( activeCount, effectMgr->GetNumPendingImpactQueries() );
          effectMgr->Update( updateDelta );
+         CPPUNIT_ASSERT_EQUAL( 0U, effectMgr->GetNumPendingImpactQueries() );
          effectMgr->Update( updateDelta );
          unsigned curActiveCount = effectMgr->GetMunitionEffectActiveCount();
          CPPUNIT_ASSERT( curActiveCount == activeCount );
@@ -2647,6 +2981,23 @@ namespace SimCore
          //       They are merely invisible and are not updated when inactive.
          CPPUNIT_ASSERT( scene->GetNumberOfAddedDrawable() == oldSceneCount + 3 );
 
+         // --- Shots that hit nothing fly for their whole time, as do shots without a velocity.
+         SimCore::Components::WeaponEffectsManager::ImpactQueryList queries(
+            SimCore::Components::WeaponEffectsManager::MAX_IMPACT_QUERIES_PER_UPDATE + 2 );
+         for( unsigned i = 0; i < queries.size(); ++i )
+         {
+            queries[i].mFirePoint.set( 0.0f, float(i), 10000.0f );
+            queries[i].mVelocity.set( i == 1 ? 0.0f : 5.0f, 0.0f, 0.0f );
+            queries[i].mMaxTime = 2.0f;
+         }
+         effectMgr->CalcTimesToImpact( queries );
+         for( unsigned i = 0; i < queries.size(); ++i )
+         {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0f, queries[i].mTimeToImpact, 0.001f );
+         }
+         CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0f,
+            effectMgr->CalcTimeToImpact( osg::Vec3(0.0f, 0.0f, 10000.0f), osg::Vec3(), 3.0f ), 0.001f );
+
          // Test that Clear calls ClearTracerEffects.
          effectMgr->Clear();
          CPPUNIT_ASSERT( effectMgr->GetMunitionEffectCount() == 0 );
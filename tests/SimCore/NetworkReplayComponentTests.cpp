@@ -0,0 +1,260 @@
+/* -*-c++-*-
+* Simulation Core - NetworkReplayComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/system.h>
+#include <dtCore/scene.h>
+#include <dtCore/timer.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/machineinfo.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/testcomponent.h>
+#include <dtUtil/fileutils.h>
+
+#include <SimCore/Components/NetworkCaptureComponent.h>
+#include <SimCore/Components/NetworkReplayComponent.h>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+#include <fstream>
+
+using SimCore::Components::NetworkCaptureComponent;
+using SimCore::Components::NetworkReplayComponent;
+
+static const std::string CAPTURE_FILE("TestNetworkCapture.bin");
+
+class NetworkReplayComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(NetworkReplayComponentTests);
+      CPPUNIT_TEST(TestCaptureAndReplay);
+      CPPUNIT_TEST(TestBadCaptureFile);
+      CPPUNIT_TEST(TestLostMessagesTimeOut);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestCaptureAndReplay();
+      void TestBadCaptureFile();
+      void TestLostMessagesTimeOut();
+
+   private:
+      // Captures two remote messages into the capture file.
+      void WriteCapture();
+
+      dtCore::RefPtr<dtGame::GameManager> mGM;
+      dtCore::RefPtr<dtGame::TestComponent> mTestComp;
+      dtCore::RefPtr<dtGame::MachineInfo> mRemoteMachine;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NetworkReplayComponentTests);
+
+/////////////////////////////////////////////////////////
+void NetworkReplayComponentTests::setUp()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtABC::Application& app = GetGlobalApplication();
+   mGM = new dtGame::GameManager(*app.GetScene());
+   mGM->SetApplication(app);
+
+   mTestComp = new dtGame::TestComponent();
+   mGM->AddComponent(*mTestComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   mRemoteMachine = new dtGame::MachineInfo("Remote");
+}
+
+/////////////////////////////////////////////////////////
+void NetworkReplayComponentTests::tearDown()
+{
+   dtCore::System::GetInstance().Stop();
+
+   if (mGM.valid())
+   {
+      mGM->DeleteAllActors(true);
+   }
+
+   mTestComp = NULL;
+   mRemoteMachine = NULL;
+   mGM = NULL;
+
+   dtUtil::FileUtils::GetInstance().FileDelete(CAPTURE_FILE);
+}
+
+/////////////////////////////////////////////////////////
+void NetworkReplayComponentTests::WriteCapture()
+{
+   dtCore::RefPtr<NetworkCaptureComponent> captureComp = new NetworkCaptureComponent();
+   captureComp->SetCaptureFile(CAPTURE_FILE);
+   mGM->AddComponent(*captureComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   for (unsigned i = 0; i < 2; ++i)
+   {
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> updateMsg;
+      mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, updateMsg);
+      updateMsg->SetSource(*mRemoteMachine);
+      updateMsg->SetAboutActorId(dtCore::UniqueId());
+      mGM->SendMessage(*updateMsg);
+   }
+
+   dtCore::System::GetInstance().Step();
+   mGM->RemoveComponent(*captureComp);
+}
+
+/////////////////////////////////////////////////////////
+void NetworkReplayComponentTests::TestCaptureAndReplay()
+{
+   dtCore::RefPtr<NetworkCaptureComponent> captureComp = new NetworkCaptureComponent();
+   captureComp->SetCaptureFile(CAPTURE_FILE);
+   mGM->AddComponent(*captureComp, dtGame::GameManager::ComponentPriority::NORMAL);
+   CPPUNIT_ASSERT(captureComp->IsCapturing());
+
+   dtCore::UniqueId remoteActorId;
+   dtCore::RefPtr<dtGame::ActorUpdateMessage> updateMsg;
+   mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, updateMsg);
+   updateMsg->SetSource(*mRemoteMachine);
+   updateMsg->SetAboutActorId(remoteActorId);
+   updateMsg->SetName("Remote Tank");
+   mGM->SendMessage(*updateMsg);
+
+   // Local messages aren't captured.
+   dtCore::RefPtr<dtGame::ActorUpdateMessage> localMsg;
+   mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, localMsg);
+   localMsg->SetAboutActorId(dtCore::UniqueId());
+   mGM->SendMessage(*localMsg);
+
+   dtCore::RefPtr<dtGame::Message> deleteMsg;
+   mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_DELETED, deleteMsg);
+   deleteMsg->SetSource(*mRemoteMachine);
+   deleteMsg->SetAboutActorId(remoteActorId);
+   mGM->SendMessage(*deleteMsg);
+
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(2U, captureComp->GetNumCaptured());
+
+   mGM->RemoveComponent(*captureComp);
+   CPPUNIT_ASSERT(!captureComp->IsCapturing());
+
+   dtCore::RefPtr<NetworkReplayComponent> replayComp = new NetworkReplayComponent();
+   mGM->AddComponent(*replayComp, dtGame::GameManager::ComponentPriority::LOWEST);
+   CPPUNIT_ASSERT(replayComp->LoadCapture(CAPTURE_FILE));
+   CPPUNIT_ASSERT_EQUAL(2U, replayComp->GetNumRecords());
+
+   SimCore::Components::NetworkReplayProbeComponent* probe = NULL;
+   mGM->GetComponentByName(SimCore::Components::NetworkReplayProbeComponent::DEFAULT_NAME, probe);
+   CPPUNIT_ASSERT_MESSAGE("The replay component should add the probe that times the messages off the queue.", probe != NULL);
+   CPPUNIT_ASSERT(probe->GetReplayComponent() == replayComp.get());
+
+   mTestComp->reset();
+   replayComp->SetTimeScale(0.0f);
+   replayComp->SetMaxMessagesPerTick(1);
+   replayComp->StartReplay();
+   CPPUNIT_ASSERT(replayComp->IsReplaying());
+
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Only one message should be sent per tick.", 1U, replayComp->GetNumSent());
+   CPPUNIT_ASSERT(!replayComp->IsFinished());
+
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT(replayComp->IsFinished());
+   CPPUNIT_ASSERT(!replayComp->IsReplaying());
+   CPPUNIT_ASSERT_EQUAL(2U, replayComp->GetNumSent());
+   CPPUNIT_ASSERT_EQUAL(2U, replayComp->GetNumProcessed());
+   CPPUNIT_ASSERT_EQUAL(0U, replayComp->GetNumSkipped());
+   CPPUNIT_ASSERT_EQUAL(0U, replayComp->GetNumDropped());
+   CPPUNIT_ASSERT(replayComp->GetMaxLatencyMillis() >= replayComp->GetMeanLatencyMillis());
+   CPPUNIT_ASSERT(replayComp->GetMeanQueueMillis() >= 0.0);
+   CPPUNIT_ASSERT(replayComp->GetMessagesPerSecond() > 0.0);
+
+   dtCore::RefPtr<const dtGame::Message> replayedUpdate = mTestComp->FindProcessMessageOfType(dtGame::MessageType::INFO_ACTOR_UPDATED);
+   CPPUNIT_ASSERT(replayedUpdate.valid());
+   CPPUNIT_ASSERT(replayedUpdate != updateMsg);
+   CPPUNIT_ASSERT_EQUAL(remoteActorId, replayedUpdate->GetAboutActorId());
+   CPPUNIT_ASSERT_EQUAL(mRemoteMachine->GetUniqueId(), replayedUpdate->GetSource().GetUniqueId());
+   CPPUNIT_ASSERT(replayedUpdate->GetSource() != mGM->GetMachineInfo());
+   CPPUNIT_ASSERT_EQUAL(std::string("Remote Tank"),
+            static_cast<const dtGame::ActorUpdateMessage&>(*replayedUpdate).GetName());
+
+   CPPUNIT_ASSERT(mTestComp->FindProcessMessageOfType(dtGame::MessageType::INFO_ACTOR_DELETED).valid());
+
+   mGM->RemoveComponent(*replayComp);
+   CPPUNIT_ASSERT(probe->GetReplayComponent() == NULL);
+}
+
+/////////////////////////////////////////////////////////
+void NetworkReplayComponentTests::TestBadCaptureFile()
+{
+   dtCore::RefPtr<NetworkReplayComponent> replayComp = new NetworkReplayComponent();
+   mGM->AddComponent(*replayComp, dtGame::GameManager::ComponentPriority::LOWEST);
+
+   CPPUNIT_ASSERT(!replayComp->LoadCapture("NoSuchNetworkCapture.bin"));
+
+   {
+      std::ofstream out(CAPTURE_FILE.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      out << "This is not a capture file.";
+   }
+   CPPUNIT_ASSERT(!replayComp->LoadCapture(CAPTURE_FILE));
+   CPPUNIT_ASSERT_EQUAL(0U, replayComp->GetNumRecords());
+
+   mGM->RemoveComponent(*replayComp);
+}
+
+/////////////////////////////////////////////////////////
+void NetworkReplayComponentTests::TestLostMessagesTimeOut()
+{
+   WriteCapture();
+
+   dtCore::RefPtr<NetworkReplayComponent> replayComp = new NetworkReplayComponent();
+   mGM->AddComponent(*replayComp, dtGame::GameManager::ComponentPriority::LOWEST);
+   CPPUNIT_ASSERT(replayComp->LoadCapture(CAPTURE_FILE));
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, replayComp->GetMessageTimeout(), 0.001f);
+
+   replayComp->SetTimeScale(0.0f);
+   replayComp->SetMessageTimeout(0.001f);
+   replayComp->StartReplay();
+
+   // Send the messages outside of a tick, so they sit in the GM's queue past the timeout.
+   CPPUNIT_ASSERT_EQUAL(2U, replayComp->SendDueMessages());
+   CPPUNIT_ASSERT(!replayComp->IsFinished());
+   dtCore::AppSleep(10);
+
+   CPPUNIT_ASSERT_EQUAL(0U, replayComp->SendDueMessages());
+   CPPUNIT_ASSERT_MESSAGE("Messages that never arrive shouldn't keep the replay from finishing.", replayComp->IsFinished());
+   CPPUNIT_ASSERT_EQUAL(2U, replayComp->GetNumDropped());
+   CPPUNIT_ASSERT_EQUAL(0U, replayComp->GetNumProcessed());
+
+   // They still arrive later, but they aren't counted again.
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(0U, replayComp->GetNumProcessed());
+   CPPUNIT_ASSERT_EQUAL(2U, replayComp->GetNumDropped());
+
+   mGM->RemoveComponent(*replayComp);
+}
@@ -153,6 +153,7 @@ namespace SimCore
          CPPUNIT_TEST(TestProperties); // This will also call tests for ParticleInfo.
          CPPUNIT_TEST(TestMessageProcessing);
          CPPUNIT_TEST(TestForceOrientations);
+         CPPUNIT_TEST(TestBatchedWindUpdates);
 
          CPPUNIT_TEST_SUITE_END();
 
@@ -182,6 +183,7 @@ namespace SimCore
             void TestProperties();
             void TestMessageProcessing();
             void TestForceOrientations();
+            void TestBatchedWindUpdates();
 
             typedef std::vector<dtCore::RefPtr<ParticleLayerRef> > ParticleLayerRefList;
             void GetParticleLayerRefs( dtCore::ParticleSystem& particles, ParticleLayerRefList& outLayerRefs );
@@ -778,6 +780,62 @@ namespace SimCore
          CPPUNIT_ASSERT_DOUBLES_EQUAL( localForce.z(), worldForce.z(), errorTolerance );
       }
 
+      //////////////////////////////////////////////////////////////////////////
+      void ParticleManagerComponentTests::TestBatchedWindUpdates()
+      {
+         std::string forceName("Wind");
+         ParticleInfoAttributeFlags flags = {true,true};
+
+         CreateParticleSystem(mPS);
+         CreateParticleSystem(mPS2);
+         CreateParticleSystem(mPS3);
+         CPPUNIT_ASSERT(mParticleComp->Register(*mPS,&flags));
+         CPPUNIT_ASSERT(mParticleComp->Register(*mPS2,&flags));
+         CPPUNIT_ASSERT(mParticleComp->Register(*mPS3,&flags));
+         CPPUNIT_ASSERT_EQUAL(3U, mParticleComp->GetNumRegistered());
+
+         // Clear out any update left from the setup.
+         mParticleComp->UpdateParticleForces();
+         CPPUNIT_ASSERT(!mParticleComp->IsForceUpdatePending());
+
+         // Several changes in one frame are applied together on the next tick.
+         mParticleComp->SetWind(osg::Vec3(1.0f, 0.0f, 0.0f));
+         mParticleComp->SetWind(osg::Vec3(0.0f, 4.0f, 0.0f));
+         CPPUNIT_ASSERT(mParticleComp->IsForceUpdatePending());
+         osg::Vec3 currentForce;
+         CPPUNIT_ASSERT(ParticleSystemHasForce(forceName, *mPS2, &currentForce));
+         CPPUNIT_ASSERT_MESSAGE("The wind should not change until the next tick.",
+            currentForce != osg::Vec3(0.0f, 4.0f, 0.0f));
+
+         dtCore::System::GetInstance().Step();
+         CPPUNIT_ASSERT(!mParticleComp->IsForceUpdatePending());
+         CPPUNIT_ASSERT(ParticleSystemHasForce(forceName, *mPS, &currentForce));
+         SubTestLocalForceToWorldForce(currentForce, osg::Vec3(0.0f, 4.0f, 0.0f), 0.001f);
+         CPPUNIT_ASSERT(ParticleSystemHasForce(forceName, *mPS3, &currentForce));
+         SubTestLocalForceToWorldForce(currentForce, osg::Vec3(0.0f, 4.0f, 0.0f), 0.001f);
+
+         // Unregistering from the middle keeps the rest registered.
+         CPPUNIT_ASSERT(mParticleComp->Unregister(*mPS2));
+         CPPUNIT_ASSERT_EQUAL(2U, mParticleComp->GetNumRegistered());
+         CPPUNIT_ASSERT(mParticleComp->HasRegistered(mPS->GetUniqueId()));
+         CPPUNIT_ASSERT(mParticleComp->HasRegistered(mPS3->GetUniqueId()));
+
+         // A deleted particle system is dropped by the next force pass.
+         dtCore::UniqueId id1 = mPS->GetUniqueId();
+         RemoveParticlesFromScene(*mPS);
+         mPS = NULL;
+         dtCore::System::GetInstance().Step();
+         mParticleComp->SetWind(osg::Vec3(0.0f, 0.0f, 2.0f));
+         dtCore::System::GetInstance().Step();
+         CPPUNIT_ASSERT(!mParticleComp->HasRegistered(id1));
+         CPPUNIT_ASSERT(mParticleComp->HasRegistered(mPS3->GetUniqueId()));
+         CPPUNIT_ASSERT_EQUAL(1U, mParticleComp->GetNumRegistered());
+
+         // Physics particle actors are only dropped by id, as with a delete message.
+         CPPUNIT_ASSERT(!mParticleComp->UnregisterPhysicsParticles(dtCore::UniqueId()));
+         CPPUNIT_ASSERT_EQUAL(0U, mParticleComp->GetNumPhysicsParticlesRegistered());
+      }
+
       //////////////////////////////////////////////////////////////////////////
       void ParticleManagerComponentTests::TestForceOrientations()
       {
@@ -0,0 +1,219 @@
+/* -*-c++-*-
+* Simulation Core - PhysicsRayQueryComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/system.h>
+#include <dtCore/scene.h>
+#include <dtCore/transformable.h>
+#include <dtGame/gamemanager.h>
+
+#include <SimCore/Components/PhysicsRayQueryComponent.h>
+
+#include <osg/Geode>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+typedef SimCore::Components::PhysicsRayQueryComponent::HitList HitList;
+
+////////////////////////////////////////////////////////
+// Records the hits it is called with.
+class RayQueryReceiver : public osg::Referenced
+{
+   public:
+      RayQueryReceiver() : mNumCalls(0) {}
+
+      void OnHits(const HitList& hits)
+      {
+         ++mNumCalls;
+         mHits = hits;
+      }
+
+      unsigned mNumCalls;
+      HitList mHits;
+};
+
+class PhysicsRayQueryComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(PhysicsRayQueryComponentTests);
+      CPPUNIT_TEST(TestSceneQueries);
+      CPPUNIT_TEST(TestDeletedOwner);
+      CPPUNIT_TEST(TestWorkerThreads);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestSceneQueries();
+      void TestDeletedOwner();
+      void TestWorkerThreads();
+
+   private:
+      SimCore::Components::PhysicsRayQueryComponent::QueryCallback MakeCallback(RayQueryReceiver& receiver);
+
+      dtCore::RefPtr<dtGame::GameManager> mGM;
+      dtCore::RefPtr<SimCore::Components::PhysicsRayQueryComponent> mRayQueryComp;
+      dtCore::RefPtr<dtCore::Transformable> mBox;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PhysicsRayQueryComponentTests);
+
+/////////////////////////////////////////////////////////
+void PhysicsRayQueryComponentTests::setUp()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtABC::Application& app = GetGlobalApplication();
+   mGM = new dtGame::GameManager(*app.GetScene());
+   mGM->SetApplication(app);
+
+   mRayQueryComp = new SimCore::Components::PhysicsRayQueryComponent();
+   mGM->AddComponent(*mRayQueryComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+   // A 10 meter box centered on the origin.
+   osg::Geode* geode = new osg::Geode();
+   geode->addDrawable(new osg::ShapeDrawable(new osg::Box(osg::Vec3(), 10.0f)));
+   mBox = new dtCore::Transformable("Box");
+   mBox->GetMatrixNode()->addChild(geode);
+   mGM->GetScene().AddChild(mBox.get());
+}
+
+/////////////////////////////////////////////////////////
+void PhysicsRayQueryComponentTests::tearDown()
+{
+   dtCore::System::GetInstance().Stop();
+
+   if (mGM.valid())
+   {
+      mGM->GetScene().RemoveChild(mBox.get());
+      mGM->DeleteAllActors(true);
+      mGM->RemoveComponent(*mRayQueryComp);
+   }
+
+   mBox = NULL;
+   mRayQueryComp = NULL;
+   mGM = NULL;
+}
+
+/////////////////////////////////////////////////////////
+SimCore::Components::PhysicsRayQueryComponent::QueryCallback PhysicsRayQueryComponentTests::MakeCallback(RayQueryReceiver& receiver)
+{
+   return SimCore::Components::PhysicsRayQueryComponent::QueryCallback(&receiver, &RayQueryReceiver::OnHits);
+}
+
+/////////////////////////////////////////////////////////
+void PhysicsRayQueryComponentTests::TestSceneQueries()
+{
+   dtCore::RefPtr<RayQueryReceiver> hitReceiver = new RayQueryReceiver();
+   dtCore::RefPtr<RayQueryReceiver> missReceiver = new RayQueryReceiver();
+
+   mRayQueryComp->SubmitSceneQuery(osg::Vec3(0.0f, 0.0f, 100.0f), osg::Vec3(0.0f, 0.0f, -100.0f),
+      MakeCallback(*hitReceiver), hitReceiver.get());
+   mRayQueryComp->SubmitSceneQuery(osg::Vec3(500.0f, 0.0f, 100.0f), osg::Vec3(500.0f, 0.0f, -100.0f),
+      MakeCallback(*missReceiver), missReceiver.get());
+   CPPUNIT_ASSERT_EQUAL(2U, mRayQueryComp->GetNumPendingQueries());
+   CPPUNIT_ASSERT_EQUAL(0U, hitReceiver->mNumCalls);
+
+   mRayQueryComp->RunQueries();
+   CPPUNIT_ASSERT_EQUAL(0U, mRayQueryComp->GetNumPendingQueries());
+
+   CPPUNIT_ASSERT_EQUAL(1U, hitReceiver->mNumCalls);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), hitReceiver->mHits.size());
+   CPPUNIT_ASSERT_MESSAGE("The hits should be sorted, so the top of the box comes first.",
+      hitReceiver->mHits[0].mHitPos.z() > hitReceiver->mHits[1].mHitPos.z());
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, hitReceiver->mHits[0].mHitPos.z(), 0.01f);
+
+   CPPUNIT_ASSERT_EQUAL(1U, missReceiver->mNumCalls);
+   CPPUNIT_ASSERT(missReceiver->mHits.empty());
+
+   CPPUNIT_ASSERT_EQUAL(2U, mRayQueryComp->GetLastBatchQueryCount());
+   CPPUNIT_ASSERT_EQUAL(2U, mRayQueryComp->GetTotalQueryCount());
+   CPPUNIT_ASSERT(mRayQueryComp->GetLastBatchQueryTimeMS() >= 0.0);
+
+   // An empty batch doesn't call anything again.
+   mRayQueryComp->RunQueries();
+   CPPUNIT_ASSERT_EQUAL(1U, hitReceiver->mNumCalls);
+   CPPUNIT_ASSERT_EQUAL(0U, mRayQueryComp->GetLastBatchQueryCount());
+   CPPUNIT_ASSERT_EQUAL(2U, mRayQueryComp->GetTotalQueryCount());
+
+   mRayQueryComp->ResetStatistics();
+   CPPUNIT_ASSERT_EQUAL(0U, mRayQueryComp->GetTotalQueryCount());
+}
+
+/////////////////////////////////////////////////////////
+void PhysicsRayQueryComponentTests::TestDeletedOwner()
+{
+   RayQueryReceiver* deletedReceiver = new RayQueryReceiver();
+   dtCore::RefPtr<RayQueryReceiver> deletedRef = deletedReceiver;
+
+   mRayQueryComp->SubmitSceneQuery(osg::Vec3(0.0f, 0.0f, 100.0f), osg::Vec3(0.0f, 0.0f, -100.0f),
+      MakeCallback(*deletedReceiver), deletedReceiver);
+   deletedRef = NULL;
+
+   // This would crash if the callback were called on the deleted receiver.
+   mRayQueryComp->RunQueries();
+   CPPUNIT_ASSERT_EQUAL(1U, mRayQueryComp->GetLastBatchQueryCount());
+
+   dtCore::RefPtr<RayQueryReceiver> receiver = new RayQueryReceiver();
+   mRayQueryComp->SubmitSceneQuery(osg::Vec3(0.0f, 0.0f, 100.0f), osg::Vec3(0.0f, 0.0f, -100.0f),
+      MakeCallback(*receiver), receiver.get());
+   mRayQueryComp->ClearQueries();
+   mRayQueryComp->RunQueries();
+   CPPUNIT_ASSERT_EQUAL(0U, receiver->mNumCalls);
+}
+
+/////////////////////////////////////////////////////////
+void PhysicsRayQueryComponentTests::TestWorkerThreads()
+{
+   mRayQueryComp->SetUseWorkerThreads(true);
+   mRayQueryComp->SetMinQueriesPerTask(2);
+
+   const unsigned numQueries = 64;
+   std::vector<dtCore::RefPtr<RayQueryReceiver> > receivers;
+   for (unsigned i = 0; i < numQueries; ++i)
+   {
+      receivers.push_back(new RayQueryReceiver());
+      // Every other query misses the box.
+      float x = (i % 2 == 0) ? 0.0f : 500.0f;
+      mRayQueryComp->SubmitSceneQuery(osg::Vec3(x, 0.0f, 100.0f), osg::Vec3(x, 0.0f, -100.0f),
+         MakeCallback(*receivers.back()), receivers.back().get());
+   }
+
+   mRayQueryComp->RunQueries();
+   CPPUNIT_ASSERT_EQUAL(numQueries, mRayQueryComp->GetLastBatchQueryCount());
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Scene queries must not be traced on the worker threads.",
+      0U, mRayQueryComp->GetLastBatchWorkerQueryCount());
+
+   for (unsigned i = 0; i < numQueries; ++i)
+   {
+      CPPUNIT_ASSERT_EQUAL(1U, receivers[i]->mNumCalls);
+      CPPUNIT_ASSERT_EQUAL(i % 2 == 0, !receivers[i]->mHits.empty());
+   }
+}
@@ -38,12 +38,18 @@
 #include <dtCore/system.h>
 #include <dtCore/observerptr.h>
 #include <dtCore/enginepropertytypes.h>
+#include <dtCore/project.h>
+#include <dtCore/transform.h>
 #include <dtGame/gamemanager.h>
 #include <dtGame/deadreckoningcomponent.h>
 
 #include <SimCore/Actors/BaseEntity.h>
 #include <SimCore/Actors/PositionMarker.h>
 #include <SimCore/Actors/EntityActorRegistry.h>
+#include <SimCore/Components/PositionMarkerComponent.h>
+
+#include <osg/Geometry>
+#include <osg/Texture2D>
 
 #include <dtGame/testcomponent.h>
 #include <UnitTestMain.h>
@@ -71,6 +77,9 @@ namespace SimCore
             CPPUNIT_TEST(TestColors);
             CPPUNIT_TEST(TestColorForForce);
             CPPUNIT_TEST(TestPositionMarkerDelete);
+            CPPUNIT_TEST(TestSharedIconTexture);
+            CPPUNIT_TEST(TestMarkerComponent);
+            CPPUNIT_TEST(TestMarkerBatch);
 
          CPPUNIT_TEST_SUITE_END();
 
@@ -336,6 +345,139 @@ namespace SimCore
                CPPUNIT_ASSERT_EQUAL(theColor, expectedColorOT);
             }
 
+            void TestSharedIconTexture()
+            {
+               std::string iconFile = dtCore::Project::GetInstance().GetResourcePath(dtCore::ResourceDescriptor("Textures:needle.png"));
+               unsigned numTextures = PositionMarker::GetNumIconTextures();
+
+               RefPtr<PositionMarkerActorProxy> pmap;
+               PositionMarker* pm = NULL;
+               CreatePositionMarker(pmap, pm);
+
+               RefPtr<PositionMarkerActorProxy> pmap2;
+               PositionMarker* pm2 = NULL;
+               CreatePositionMarker(pmap2, pm2);
+
+               pm->LoadImage(iconFile);
+               pm2->LoadImage(iconFile);
+               CPPUNIT_ASSERT_EQUAL(numTextures + 1, PositionMarker::GetNumIconTextures());
+
+               osg::StateAttribute* tex = pm->GetOSGNode()->getOrCreateStateSet()->getTextureAttribute(0, osg::StateAttribute::TEXTURE);
+               osg::StateAttribute* tex2 = pm2->GetOSGNode()->getOrCreateStateSet()->getTextureAttribute(0, osg::StateAttribute::TEXTURE);
+               CPPUNIT_ASSERT(tex != NULL);
+               CPPUNIT_ASSERT_MESSAGE("Markers with the same icon should share the texture.", tex == tex2);
+               CPPUNIT_ASSERT(PositionMarker::GetIconTexture(iconFile).get() == tex);
+
+               pm->LoadImage("");
+               pm2->LoadImage("");
+               CPPUNIT_ASSERT_EQUAL_MESSAGE("The texture should be freed when no marker uses it.",
+                        numTextures, PositionMarker::GetNumIconTextures());
+            }
+
+            void TestMarkerComponent()
+            {
+               RefPtr<SimCore::Components::PositionMarkerComponent> markerComp = new SimCore::Components::PositionMarkerComponent;
+               mGM->AddComponent(*markerComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+               RefPtr<PositionMarkerActorProxy> pmap;
+               PositionMarker* pm = NULL;
+               CreatePositionMarker(pmap, pm);
+
+               RefPtr<PositionMarkerActorProxy> pmap2;
+               PositionMarker* pm2 = NULL;
+               CreatePositionMarker(pmap2, pm2);
+
+               double simTime = mGM->GetSimulationTime();
+               pm->SetInitialAlpha(1.0);
+               pm->SetFadeOutTime(10.0 / 60.0);
+               pm->SetReportTime(simTime - 5.0);
+               pm->SetDeleteOnFadeOut(true);
+
+               pm2->SetFadeOutTime(10.0 / 60.0);
+               pm2->SetReportTime(simTime - 20.0);
+               pm2->SetDeleteOnFadeOut(true);
+
+               mGM->AddActor(*pmap, false, false);
+               mGM->AddActor(*pmap2, false, false);
+               CPPUNIT_ASSERT_EQUAL(2U, markerComp->GetNumMarkers());
+               CPPUNIT_ASSERT(markerComp->IsRegistered(*pm));
+
+               dtCore::UniqueId fadedId = pmap2->GetId();
+               pmap2 = NULL;
+               pm2 = NULL;
+
+               markerComp->UpdateMarkers(simTime);
+               CPPUNIT_ASSERT_EQUAL_MESSAGE("The faded marker should be dropped from the component.",
+                        1U, markerComp->GetNumMarkers());
+               CPPUNIT_ASSERT_DOUBLES_EQUAL(0.75, pm->GetCurrentColorUniform().w(), 0.01);
+
+               dtCore::System::GetInstance().Step();
+               CPPUNIT_ASSERT_MESSAGE("The faded marker should have been deleted.", mGM->FindActorById(fadedId) == NULL);
+               CPPUNIT_ASSERT(mGM->FindActorById(pmap->GetId()) != NULL);
+
+               markerComp->UpdateMarkers(simTime + 10.0);
+               CPPUNIT_ASSERT_EQUAL(0U, markerComp->GetNumMarkers());
+            }
+
+            void TestMarkerBatch()
+            {
+               RefPtr<SimCore::Components::PositionMarkerComponent> markerComp = new SimCore::Components::PositionMarkerComponent;
+               mGM->AddComponent(*markerComp, dtGame::GameManager::ComponentPriority::NORMAL);
+
+               osg::Geometry* geom = markerComp->GetBatchGeometry();
+               CPPUNIT_ASSERT(geom != NULL);
+
+               RefPtr<PositionMarkerActorProxy> pmap, pmap2;
+               PositionMarker* pm = NULL;
+               PositionMarker* pm2 = NULL;
+               CreatePositionMarker(pmap, pm);
+               CreatePositionMarker(pmap2, pm2);
+
+               dtCore::Transform xform;
+               xform.SetTranslation(osg::Vec3(10.0, 20.0, 30.0));
+               pm->SetTransform(xform);
+               xform.SetTranslation(osg::Vec3(-5.0, 0.0, 1.0));
+               pm2->SetTransform(xform);
+
+               mGM->AddActor(*pmap, false, false);
+               mGM->AddActor(*pmap2, false, false);
+               CPPUNIT_ASSERT_MESSAGE("The batch draws the registered markers, so they hide their own mesh.",
+                        !pm->IsMeshVisible() && !pm2->IsMeshVisible());
+
+               markerComp->UpdateBatch();
+               CPPUNIT_ASSERT_EQUAL(2U, markerComp->GetNumInstances());
+
+               const osg::Vec3Array* positions = dynamic_cast<const osg::Vec3Array*>(
+                        geom->getVertexAttribArray(SimCore::Components::PositionMarkerComponent::POSITION_ATTRIBUTE));
+               const osg::Vec4Array* colors = dynamic_cast<const osg::Vec4Array*>(
+                        geom->getVertexAttribArray(SimCore::Components::PositionMarkerComponent::COLOR_ATTRIBUTE));
+               CPPUNIT_ASSERT(positions != NULL && colors != NULL);
+               CPPUNIT_ASSERT_EQUAL(2U, unsigned(positions->size()));
+               CPPUNIT_ASSERT_EQUAL(2U, unsigned(colors->size()));
+
+               // The component may reorder the markers, so find the first one.
+               unsigned first = (*positions)[0].x() > 0.0f ? 0U : 1U;
+               CPPUNIT_ASSERT_EQUAL(osg::Vec3(10.0, 20.0, 30.0) + PositionMarker::MESH_OFFSET, (*positions)[first]);
+               CPPUNIT_ASSERT_EQUAL(pm->GetCurrentColorUniform(), (*colors)[first]);
+
+               for (unsigned i = 0; i < geom->getNumPrimitiveSets(); ++i)
+               {
+                  CPPUNIT_ASSERT_EQUAL_MESSAGE("All the markers should be drawn in one instanced draw.",
+                           2, int(geom->getPrimitiveSet(i)->getNumInstances()));
+               }
+
+               pm2->SetVisible(false);
+               markerComp->UpdateBatch();
+               CPPUNIT_ASSERT_EQUAL_MESSAGE("Hidden markers aren't drawn.", 1U, markerComp->GetNumInstances());
+               CPPUNIT_ASSERT_EQUAL(osg::Vec3(10.0, 20.0, 30.0) + PositionMarker::MESH_OFFSET, (*positions)[0]);
+
+               markerComp->UnregisterMarker(*pm);
+               CPPUNIT_ASSERT(pm->IsMeshVisible());
+               markerComp->UpdateBatch();
+               CPPUNIT_ASSERT_EQUAL(0U, markerComp->GetNumInstances());
+               CPPUNIT_ASSERT_EQUAL_MESSAGE("The empty batch should be masked off.", 0x0U, geom->getParent(0)->getNodeMask());
+            }
+
          private:
 
             void CreatePositionMarker(RefPtr<PositionMarkerActorProxy>& pmap, PositionMarker*& pm)
@@ -0,0 +1,214 @@
+/* -*-c++-*-
+* Simulation Core - StartupPreloaderTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <SimCore/StartupPreloader.h>
+#include <SimCore/StartupTracer.h>
+
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+#include <sstream>
+#include <vector>
+
+////////////////////////////////////////////////////////
+// Records the order the tasks ran in.
+class OrderRecorder : public osg::Referenced
+{
+   public:
+      void Add(const std::string& name)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         mOrder.push_back(name);
+      }
+
+      int IndexOf(const std::string& name)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         for (unsigned i = 0; i < mOrder.size(); ++i)
+         {
+            if (mOrder[i] == name)
+            {
+               return int(i);
+            }
+         }
+         return -1;
+      }
+
+      OpenThreads::Mutex mMutex;
+      std::vector<std::string> mOrder;
+};
+
+////////////////////////////////////////////////////////
+class RecordingPreloadTask : public SimCore::StartupPreloadTask
+{
+   public:
+      RecordingPreloadTask(const std::string& name, OrderRecorder& recorder)
+      : SimCore::StartupPreloadTask(name)
+      , mRecorder(&recorder)
+      {
+      }
+
+   protected:
+      virtual void Run()
+      {
+         mRecorder->Add(GetName());
+      }
+
+   private:
+      dtCore::RefPtr<OrderRecorder> mRecorder;
+};
+
+class StartupPreloaderTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(StartupPreloaderTests);
+      CPPUNIT_TEST(TestTracer);
+      CPPUNIT_TEST(TestDependencies);
+      CPPUNIT_TEST(TestInvalidDependency);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestTracer();
+      void TestDependencies();
+      void TestInvalidDependency();
+
+   private:
+      dtCore::RefPtr<OrderRecorder> mRecorder;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StartupPreloaderTests);
+
+/////////////////////////////////////////////////////////
+void StartupPreloaderTests::setUp()
+{
+   mRecorder = new OrderRecorder();
+   SimCore::StartupTracer::GetInstance().Clear();
+}
+
+/////////////////////////////////////////////////////////
+void StartupPreloaderTests::tearDown()
+{
+   SimCore::StartupTracer::GetInstance().SetEnabled(false);
+   SimCore::StartupTracer::GetInstance().Clear();
+   mRecorder = NULL;
+}
+
+/////////////////////////////////////////////////////////
+void StartupPreloaderTests::TestTracer()
+{
+   SimCore::StartupTracer& tracer = SimCore::StartupTracer::GetInstance();
+
+   {
+      SimCore::StartupTracer::Phase phase("Disabled Phase");
+   }
+   CPPUNIT_ASSERT_EQUAL(0U, tracer.GetNumPhases());
+
+   tracer.SetEnabled(true);
+   {
+      SimCore::StartupTracer::Phase phase("Registry \"Load\"", "Test");
+   }
+   tracer.RecordPhase("Map Load", SimCore::StartupTracer::DEFAULT_CATEGORY, tracer.Tick(), tracer.Tick());
+   CPPUNIT_ASSERT_EQUAL(2U, tracer.GetNumPhases());
+   CPPUNIT_ASSERT(tracer.HasPhase("Map Load"));
+
+   std::ostringstream json;
+   tracer.WriteChromeTrace(json);
+   const std::string text = json.str();
+   CPPUNIT_ASSERT_EQUAL(size_t(0), text.find("{\"traceEvents\":["));
+   CPPUNIT_ASSERT_MESSAGE("The quotes in the name should be escaped.",
+      text.find("\"name\":\"Registry \\\"Load\\\"\",\"cat\":\"Test\",\"ph\":\"X\"") != std::string::npos);
+   CPPUNIT_ASSERT(text.find("\"name\":\"Map Load\",\"cat\":\"Startup\"") != std::string::npos);
+
+   tracer.Clear();
+   CPPUNIT_ASSERT_EQUAL(0U, tracer.GetNumPhases());
+}
+
+/////////////////////////////////////////////////////////
+void StartupPreloaderTests::TestDependencies()
+{
+   SimCore::StartupTracer::GetInstance().SetEnabled(true);
+
+   dtCore::RefPtr<SimCore::StartupPreloader> preloader = new SimCore::StartupPreloader();
+
+   dtCore::RefPtr<RecordingPreloadTask> scan = new RecordingPreloadTask("Scan", *mRecorder);
+   dtCore::RefPtr<RecordingPreloadTask> read = new RecordingPreloadTask("Read", *mRecorder);
+   dtCore::RefPtr<RecordingPreloadTask> independent = new RecordingPreloadTask("Independent", *mRecorder);
+   dtCore::RefPtr<RecordingPreloadTask> last = new RecordingPreloadTask("Last", *mRecorder);
+   read->AddDependency(*scan);
+   last->AddDependency(*read);
+   last->AddDependency(*independent);
+
+   CPPUNIT_ASSERT(preloader->AddTask(*scan));
+   CPPUNIT_ASSERT(preloader->AddTask(*read));
+   CPPUNIT_ASSERT(preloader->AddTask(*independent));
+   CPPUNIT_ASSERT(!preloader->IsComplete());
+
+   preloader->Start();
+   // Added after the start, so it is queued once its dependencies finish.
+   CPPUNIT_ASSERT(preloader->AddTask(*last));
+   CPPUNIT_ASSERT_EQUAL(4U, preloader->GetNumTasks());
+   CPPUNIT_ASSERT(preloader->FindTask("Read") == read.get());
+
+   read->WaitUntilFinished();
+   CPPUNIT_ASSERT(scan->IsFinished());
+
+   preloader->WaitUntilComplete();
+   CPPUNIT_ASSERT(preloader->IsComplete());
+   CPPUNIT_ASSERT(last->IsFinished());
+
+   CPPUNIT_ASSERT(mRecorder->IndexOf("Scan") < mRecorder->IndexOf("Read"));
+   CPPUNIT_ASSERT(mRecorder->IndexOf("Read") < mRecorder->IndexOf("Last"));
+   CPPUNIT_ASSERT(mRecorder->IndexOf("Independent") < mRecorder->IndexOf("Last"));
+   CPPUNIT_ASSERT_EQUAL(size_t(4), mRecorder->mOrder.size());
+
+   CPPUNIT_ASSERT_MESSAGE("Each task should be in the startup trace.",
+      SimCore::StartupTracer::GetInstance().HasPhase("Independent"));
+}
+
+/////////////////////////////////////////////////////////
+void StartupPreloaderTests::TestInvalidDependency()
+{
+   dtCore::RefPtr<SimCore::StartupPreloader> preloader = new SimCore::StartupPreloader();
+
+   dtCore::RefPtr<RecordingPreloadTask> missing = new RecordingPreloadTask("Missing", *mRecorder);
+   dtCore::RefPtr<RecordingPreloadTask> dependent = new RecordingPreloadTask("Dependent", *mRecorder);
+   dependent->AddDependency(*missing);
+
+   CPPUNIT_ASSERT_MESSAGE("A task can't be added before its dependencies.", !preloader->AddTask(*dependent));
+   CPPUNIT_ASSERT(preloader->AddTask(*missing));
+   CPPUNIT_ASSERT_MESSAGE("A task can only be in one preloader.", !preloader->AddTask(*missing));
+   CPPUNIT_ASSERT_EQUAL(1U, preloader->GetNumTasks());
+
+   // An empty or finished preloader doesn't block.
+   preloader->Start();
+   preloader->WaitUntilComplete();
+   CPPUNIT_ASSERT(missing->IsFinished());
+}
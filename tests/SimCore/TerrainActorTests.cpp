@@ -186,6 +186,14 @@ namespace SimCore
 
          CPPUNIT_ASSERT(tc->FindProcessMessageOfType(SimCore::MessageType::INFO_TERRAIN_LOADED) != NULL);
          CPPUNIT_ASSERT(terrainDrawable->CheckForTerrainLoaded());
+
+         // The height raster is opt-in, and can be turned on after the terrain loads.
+         CPPUNIT_ASSERT(!terrainDrawable->GetElevationRasterEnabled());
+         CPPUNIT_ASSERT(terrainDrawable->GetElevationRaster() == NULL);
+         terrainDrawable->SetElevationRasterEnabled(true);
+         CPPUNIT_ASSERT(terrainDrawable->GetElevationRaster() != NULL);
+         terrainDrawable->SetElevationRasterEnabled(false);
+         CPPUNIT_ASSERT(terrainDrawable->GetElevationRaster() == NULL);
       }
 
    private:
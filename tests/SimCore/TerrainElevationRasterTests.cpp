@@ -0,0 +1,185 @@
+/* -*-c++-*-
+* Simulation Core - TerrainElevationRasterTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/fileutils.h>
+
+#include <SimCore/TerrainElevationRaster.h>
+
+#include <osg/Geode>
+#include <osg/Group>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
+
+#include <UnitTestMain.h>
+
+using SimCore::TerrainElevationRaster;
+
+static const std::string CACHE_DIRECTORY("TestElevationCache");
+
+class TerrainElevationRasterTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(TerrainElevationRasterTests);
+      CPPUNIT_TEST(TestHeights);
+      CPPUNIT_TEST(TestLevels);
+      CPPUNIT_TEST(TestCache);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestHeights();
+      void TestLevels();
+      void TestCache();
+
+   private:
+      void AddBox(const osg::Vec3& center, const osg::Vec3& size);
+
+      osg::ref_ptr<osg::Group> mTerrain;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TerrainElevationRasterTests);
+
+/////////////////////////////////////////////////////////
+void TerrainElevationRasterTests::setUp()
+{
+   mTerrain = new osg::Group();
+   // 100 meters of flat ground with the top at 0.
+   AddBox(osg::Vec3(50.0f, 50.0f, -1.0f), osg::Vec3(100.0f, 100.0f, 2.0f));
+   // A bridge across it, from x 45 to 55, with the deck at 10.5.
+   AddBox(osg::Vec3(50.0f, 50.0f, 10.0f), osg::Vec3(10.0f, 100.0f, 1.0f));
+   // A building from 17 to 23 with the roof at 10.
+   AddBox(osg::Vec3(20.0f, 20.0f, 5.0f), osg::Vec3(6.0f, 6.0f, 10.0f));
+}
+
+/////////////////////////////////////////////////////////
+void TerrainElevationRasterTests::tearDown()
+{
+   mTerrain = NULL;
+
+   dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+   if (fileUtils.DirExists(CACHE_DIRECTORY))
+   {
+      fileUtils.DirDelete(CACHE_DIRECTORY, true);
+   }
+}
+
+/////////////////////////////////////////////////////////
+void TerrainElevationRasterTests::AddBox(const osg::Vec3& center, const osg::Vec3& size)
+{
+   osg::Geode* geode = new osg::Geode();
+   geode->addDrawable(new osg::ShapeDrawable(new osg::Box(center, size.x(), size.y(), size.z())));
+   mTerrain->addChild(geode);
+}
+
+/////////////////////////////////////////////////////////
+void TerrainElevationRasterTests::TestHeights()
+{
+   dtCore::RefPtr<TerrainElevationRaster> raster = new TerrainElevationRaster(2.0f, 16);
+   raster->SetTerrain(mTerrain.get());
+   CPPUNIT_ASSERT_EQUAL(4U, raster->GetNumTilesX());
+   CPPUNIT_ASSERT_EQUAL(4U, raster->GetNumTilesY());
+
+   float height = -1.0f;
+   osg::Vec3 normal;
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::OPEN_TERRAIN, raster->GetHeightAndNormal(10.0f, 80.0f, height, normal));
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, height, 0.01f);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0f, normal.z(), 0.001f);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the queried tile should be sampled.", 1U, raster->GetNumTilesSampled());
+   CPPUNIT_ASSERT(raster->IsTileBuilt(0, 2));
+
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The ground under the bridge makes it complex.",
+            TerrainElevationRaster::COMPLEX_TERRAIN, raster->GetHeight(50.0f, 80.0f, height));
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(10.5f, height, 0.01f);
+
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The wall of the building makes it complex.",
+            TerrainElevationRaster::COMPLEX_TERRAIN, raster->GetHeight(17.5f, 20.0f, height));
+
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::NO_DATA, raster->GetHeight(-10.0f, 5.0f, height));
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::NO_DATA, raster->GetHeight(5.0f, 500.0f, height));
+
+   dtCore::RefPtr<TerrainElevationRaster> prebuiltOnly = new TerrainElevationRaster(2.0f, 16);
+   prebuiltOnly->SetBuildOnQuery(false);
+   prebuiltOnly->SetTerrain(mTerrain.get());
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::NO_DATA, prebuiltOnly->GetHeight(10.0f, 80.0f, height));
+   CPPUNIT_ASSERT_EQUAL(16U, prebuiltOnly->BuildAllTiles());
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::OPEN_TERRAIN, prebuiltOnly->GetHeight(10.0f, 80.0f, height));
+}
+
+/////////////////////////////////////////////////////////
+void TerrainElevationRasterTests::TestLevels()
+{
+   dtCore::RefPtr<TerrainElevationRaster> raster = new TerrainElevationRaster(2.0f, 12);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The tile cells should be rounded up to a power of two.", 16U, raster->GetTileCells());
+   CPPUNIT_ASSERT_EQUAL(5U, raster->GetNumLevels());
+   raster->SetTerrain(mTerrain.get());
+
+   float height = -1.0f;
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::OPEN_TERRAIN, raster->GetHeight(10.0f, 80.0f, height, 2));
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, height, 0.01f);
+
+
+   // The coarsest level is one cell for the whole tile, so the bridge makes all of its tile complex.
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::OPEN_TERRAIN, raster->GetHeight(40.0f, 80.0f, height, 0));
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::COMPLEX_TERRAIN, raster->GetHeight(40.0f, 80.0f, height, 4));
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::COMPLEX_TERRAIN, raster->GetHeight(40.0f, 80.0f, height, 10));
+}
+
+/////////////////////////////////////////////////////////
+void TerrainElevationRasterTests::TestCache()
+{
+   dtCore::RefPtr<TerrainElevationRaster> raster = new TerrainElevationRaster(2.0f, 16);
+   raster->SetCacheDirectory(CACHE_DIRECTORY);
+   raster->SetCacheKey("TestTerrain 1");
+   raster->SetTerrain(mTerrain.get());
+   CPPUNIT_ASSERT_EQUAL(16U, raster->BuildAllTiles());
+   CPPUNIT_ASSERT_EQUAL(16U, raster->GetNumTilesSampled());
+   CPPUNIT_ASSERT(dtUtil::FileUtils::GetInstance().FileExists(raster->GetTileCacheFile(1, 2)));
+
+   float expectedHeight = 0.0f;
+   raster->GetHeight(50.0f, 80.0f, expectedHeight);
+
+   dtCore::RefPtr<TerrainElevationRaster> cached = new TerrainElevationRaster(2.0f, 16);
+   cached->SetCacheDirectory(CACHE_DIRECTORY);
+   cached->SetCacheKey("TestTerrain 1");
+   cached->SetTerrain(mTerrain.get());
+
+   float height = 0.0f;
+   CPPUNIT_ASSERT_EQUAL(TerrainElevationRaster::COMPLEX_TERRAIN, cached->GetHeight(50.0f, 80.0f, height));
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedHeight, height, 0.0001f);
+   CPPUNIT_ASSERT_EQUAL(1U, cached->GetNumTilesLoaded());
+   CPPUNIT_ASSERT_EQUAL(0U, cached->GetNumTilesSampled());
+
+   dtCore::RefPtr<TerrainElevationRaster> otherTerrain = new TerrainElevationRaster(2.0f, 16);
+   otherTerrain->SetCacheDirectory(CACHE_DIRECTORY);
+   otherTerrain->SetCacheKey("TestTerrain 2");
+   otherTerrain->SetTerrain(mTerrain.get());
+   CPPUNIT_ASSERT(otherTerrain->BuildTile(1, 2));
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("A cache for another terrain key should not be used.", 0U, otherTerrain->GetNumTilesLoaded());
+   CPPUNIT_ASSERT_EQUAL(1U, otherTerrain->GetNumTilesSampled());
+}
@@ -0,0 +1,357 @@
+/* -*-c++-*-
+* Simulation Core - TerrainPhysicsPagingComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtABC/application.h>
+#include <dtCore/camera.h>
+#include <dtCore/system.h>
+#include <dtCore/transform.h>
+#include <dtGame/gamemanager.h>
+#include <dtPhysics/palphysicsworld.h>
+#include <dtPhysics/physicscomponent.h>
+
+#include <SimCore/Components/TerrainPhysicsPagingComponent.h>
+
+#include <osg/Geode>
+#include <osg/MatrixTransform>
+#include <osg/PagedLOD>
+#include <osg/ProxyNode>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
+
+#include <UnitTestMain.h>
+
+class TerrainPhysicsPagingComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(TerrainPhysicsPagingComponentTests);
+      CPPUNIT_TEST(TestGeodeIndex);
+      CPPUNIT_TEST(TestGeodeIndexMultipleFocusPoints);
+      CPPUNIT_TEST(TestFocusActors);
+      CPPUNIT_TEST(TestPagedNodes);
+      CPPUNIT_TEST(TestUpdateTerrainPhysics);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestGeodeIndex();
+      void TestGeodeIndexMultipleFocusPoints();
+      void TestFocusActors();
+      void TestPagedNodes();
+      void TestUpdateTerrainPhysics();
+
+   private:
+      // Makes a 100 meter tile centered on the position.
+      osg::Node* CreateTile(const osg::Vec3& position, osg::Geode*& outGeode);
+      // Makes a paged LOD with no tiles loaded, as the database pager leaves it until it is in range.
+      osg::PagedLOD* CreatePagedNode();
+      // Adds the tile the same way the database pager does when it is paged in.
+      void PageIn(osg::PagedLOD& pagedNode, osg::Node& tile);
+
+      dtCore::RefPtr<SimCore::Components::TerrainGeodeIndex> mIndex;
+      osg::ref_ptr<osg::Group> mTerrain;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TerrainPhysicsPagingComponentTests);
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::setUp()
+{
+   mIndex = new SimCore::Components::TerrainGeodeIndex();
+   mTerrain = new osg::Group();
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::tearDown()
+{
+   mIndex = NULL;
+   mTerrain = NULL;
+}
+
+/////////////////////////////////////////////////////////
+osg::Node* TerrainPhysicsPagingComponentTests::CreateTile(const osg::Vec3& position, osg::Geode*& outGeode)
+{
+   outGeode = new osg::Geode();
+   outGeode->addDrawable(new osg::ShapeDrawable(new osg::Box(osg::Vec3(), 100.0f, 100.0f, 1.0f)));
+
+   osg::MatrixTransform* xform = new osg::MatrixTransform(osg::Matrix::translate(position));
+   xform->addChild(outGeode);
+   return xform;
+}
+
+/////////////////////////////////////////////////////////
+osg::PagedLOD* TerrainPhysicsPagingComponentTests::CreatePagedNode()
+{
+   osg::PagedLOD* pagedNode = new osg::PagedLOD();
+   pagedNode->setFileName(0, "UnitTestTile.ive");
+   pagedNode->setRange(0, 0.0f, 1e7f);
+   return pagedNode;
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::PageIn(osg::PagedLOD& pagedNode, osg::Node& tile)
+{
+   pagedNode.addChild(&tile, 0.0f, 1e7f);
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::TestGeodeIndex()
+{
+   osg::Geode* nearGeode = NULL;
+   osg::Geode* farGeode = NULL;
+   osg::Geode* proxyGeode = NULL;
+   mTerrain->addChild(CreateTile(osg::Vec3(0.0f, 0.0f, 0.0f), nearGeode));
+   mTerrain->addChild(CreateTile(osg::Vec3(5000.0f, 5000.0f, 0.0f), farGeode));
+
+   osg::ref_ptr<osg::ProxyNode> proxy = new osg::ProxyNode();
+   proxy->addChild(CreateTile(osg::Vec3(300.0f, 0.0f, 0.0f), proxyGeode));
+   mTerrain->addChild(proxy.get());
+
+   mIndex->Build(*mTerrain);
+   CPPUNIT_ASSERT_EQUAL(3U, mIndex->GetNumGeodes());
+   CPPUNIT_ASSERT(mIndex->GetNumCells() > 0);
+
+   std::vector<const SimCore::Components::TerrainGeodeIndex::Entry*> result;
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(10.0f, 10.0f, 0.0f), 100.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), result.size());
+   CPPUNIT_ASSERT(result[0]->mGeode.get() == nearGeode);
+   CPPUNIT_ASSERT(!result[0]->mUnderProxyNode);
+
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(0.0f, 0.0f, 0.0f), 500.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), result.size());
+
+   const SimCore::Components::TerrainGeodeIndex::Entry* proxyEntry =
+      result[0]->mGeode.get() == proxyGeode ? result[0] : result[1];
+   CPPUNIT_ASSERT(proxyEntry->mGeode.get() == proxyGeode);
+   CPPUNIT_ASSERT_MESSAGE("Geodes under a proxy node should be flagged so they are loaded with their matrix.",
+      proxyEntry->mUnderProxyNode);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(300.0, proxyEntry->mWorldMatrix.getTrans().x(), 0.01);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(300.0, proxyEntry->mWorldCenter.x(), 0.01);
+
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(-3000.0f, -3000.0f, 0.0f), 500.0f, result);
+   CPPUNIT_ASSERT(result.empty());
+
+   mIndex->Clear();
+   CPPUNIT_ASSERT_EQUAL(0U, mIndex->GetNumGeodes());
+   CPPUNIT_ASSERT_EQUAL(0U, mIndex->GetNumCells());
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::TestGeodeIndexMultipleFocusPoints()
+{
+   osg::Geode* geodeA = NULL;
+   osg::Geode* geodeB = NULL;
+   mTerrain->addChild(CreateTile(osg::Vec3(0.0f, 0.0f, 0.0f), geodeA));
+   mTerrain->addChild(CreateTile(osg::Vec3(10000.0f, 0.0f, 0.0f), geodeB));
+   mIndex->Build(*mTerrain);
+
+   std::vector<const SimCore::Components::TerrainGeodeIndex::Entry*> result;
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(0.0f, 0.0f, 0.0f), 200.0f, result);
+   mIndex->Query(osg::Vec3(20.0f, 0.0f, 0.0f), 200.0f, result);
+   mIndex->Query(osg::Vec3(10000.0f, 20.0f, 0.0f), 200.0f, result);
+   CPPUNIT_ASSERT_MESSAGE("Each geode should only be returned once for all the focus points.",
+      result.size() == 2);
+
+   // A new set of queries returns the geodes again.
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(0.0f, 0.0f, 0.0f), 200.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), result.size());
+   CPPUNIT_ASSERT(result[0]->mGeode.get() == geodeA);
+
+   // Geodes that are deleted after the index is built are left as invalid entries.
+   mTerrain->removeChildren(0, mTerrain->getNumChildren());
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(0.0f, 0.0f, 0.0f), 200.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), result.size());
+   CPPUNIT_ASSERT(!result[0]->mGeode.valid());
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::TestFocusActors()
+{
+   dtCore::RefPtr<SimCore::Components::TerrainPhysicsPagingComponent> pagingComp =
+      new SimCore::Components::TerrainPhysicsPagingComponent();
+
+   CPPUNIT_ASSERT(pagingComp->GetIncludeCamera());
+   CPPUNIT_ASSERT(pagingComp->GetIncludeLocalPhysicsActors());
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(1250.0f, pagingComp->GetCookingRadius(), 0.01f);
+
+   dtCore::UniqueId actorId;
+   CPPUNIT_ASSERT(!pagingComp->IsFocusActor(actorId));
+   pagingComp->AddFocusActor(actorId);
+   CPPUNIT_ASSERT(pagingComp->IsFocusActor(actorId));
+   pagingComp->RemoveFocusActor(actorId);
+   CPPUNIT_ASSERT(!pagingComp->IsFocusActor(actorId));
+
+   // Without a game manager there is nothing to focus on.
+   std::vector<osg::Vec3> points;
+   pagingComp->GetFocusPoints(points);
+   CPPUNIT_ASSERT(points.empty());
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::TestPagedNodes()
+{
+   osg::Geode* staticGeode = NULL;
+   mTerrain->addChild(CreateTile(osg::Vec3(0.0f, 0.0f, 0.0f), staticGeode));
+
+   osg::ref_ptr<osg::PagedLOD> pagedNode = CreatePagedNode();
+   osg::ref_ptr<osg::MatrixTransform> pagedXform = new osg::MatrixTransform(osg::Matrix::translate(2000.0f, 0.0f, 0.0f));
+   pagedXform->addChild(pagedNode.get());
+   mTerrain->addChild(pagedXform.get());
+
+   mIndex->Build(*mTerrain);
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->GetNumGeodes());
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->GetNumPagedNodes());
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing has been paged, so nothing should be reindexed.", 0U, mIndex->UpdatePagedNodes());
+
+   // Page in a tile that has a paged LOD of its own.
+   osg::Geode* pagedGeode = NULL;
+   osg::ref_ptr<osg::Group> tile = new osg::Group();
+   tile->addChild(CreateTile(osg::Vec3(0.0f, 0.0f, 0.0f), pagedGeode));
+   osg::ref_ptr<osg::PagedLOD> nestedPagedNode = CreatePagedNode();
+   tile->addChild(nestedPagedNode.get());
+   PageIn(*pagedNode, *tile);
+
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->UpdatePagedNodes());
+   CPPUNIT_ASSERT_EQUAL(2U, mIndex->GetNumGeodes());
+   CPPUNIT_ASSERT_EQUAL(2U, mIndex->GetNumPagedNodes());
+   CPPUNIT_ASSERT_EQUAL(0U, mIndex->UpdatePagedNodes());
+
+   std::vector<const SimCore::Components::TerrainGeodeIndex::Entry*> result;
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(2000.0f, 0.0f, 0.0f), 100.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), result.size());
+   CPPUNIT_ASSERT(result[0]->mGeode.get() == pagedGeode);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(2000.0, result[0]->mWorldCenter.x(), 0.01);
+
+   // Paging in the nested tile only reindexes it.
+   osg::Geode* nestedGeode = NULL;
+   PageIn(*nestedPagedNode, *CreateTile(osg::Vec3(200.0f, 0.0f, 0.0f), nestedGeode));
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->UpdatePagedNodes());
+   CPPUNIT_ASSERT_EQUAL(3U, mIndex->GetNumGeodes());
+
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(2200.0f, 0.0f, 0.0f), 10.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), result.size());
+   CPPUNIT_ASSERT(result[0]->mGeode.get() == nestedGeode);
+
+   // Paging out the outer tile drops the nested one with it.
+   nestedPagedNode = NULL;
+   tile = NULL;
+   pagedNode->removeChildren(0, pagedNode->getNumChildren());
+   CPPUNIT_ASSERT_EQUAL(2U, mIndex->UpdatePagedNodes());
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->GetNumGeodes());
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->GetNumPagedNodes());
+
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(2000.0f, 0.0f, 0.0f), 500.0f, result);
+   CPPUNIT_ASSERT(result.empty());
+
+   // The entries of the paged out tiles are reused.
+   PageIn(*pagedNode, *CreateTile(osg::Vec3(0.0f, 0.0f, 0.0f), pagedGeode));
+   CPPUNIT_ASSERT_EQUAL(1U, mIndex->UpdatePagedNodes());
+   CPPUNIT_ASSERT_EQUAL(2U, mIndex->GetNumGeodes());
+
+   result.clear();
+   mIndex->BeginQueries();
+   mIndex->Query(osg::Vec3(0.0f, 0.0f, 0.0f), 100.0f, result);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), result.size());
+   CPPUNIT_ASSERT(result[0]->mGeode.get() == staticGeode);
+}
+
+/////////////////////////////////////////////////////////
+void TerrainPhysicsPagingComponentTests::TestUpdateTerrainPhysics()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtCore::RefPtr<dtGame::GameManager> gm = new dtGame::GameManager(*GetGlobalApplication().GetScene());
+   gm->SetApplication(GetGlobalApplication());
+
+   dtCore::RefPtr<dtPhysics::PhysicsWorld> physicsWorld = new dtPhysics::PhysicsWorld(GetGlobalApplication());
+   physicsWorld->Init();
+   gm->AddComponent(*new dtPhysics::PhysicsComponent(*physicsWorld, false),
+            dtGame::GameManager::ComponentPriority::NORMAL);
+
+   dtCore::RefPtr<SimCore::Components::TerrainPhysicsPagingComponent> pagingComp =
+      new SimCore::Components::TerrainPhysicsPagingComponent();
+   gm->AddComponent(*pagingComp, dtGame::GameManager::ComponentPriority::NORMAL);
+   pagingComp->SetCookingRadius(500.0f);
+
+   // The camera is the only focus point.
+   dtCore::Transform xform;
+   xform.SetTranslation(osg::Vec3(2000.0f, 0.0f, 10.0f));
+   GetGlobalApplication().GetCamera()->SetTransform(xform);
+
+   osg::Geode* staticGeode = NULL;
+   mTerrain->addChild(CreateTile(osg::Vec3(0.0f, 0.0f, 0.0f), staticGeode));
+   osg::ref_ptr<osg::PagedLOD> pagedNode = CreatePagedNode();
+   mTerrain->addChild(pagedNode.get());
+
+   pagingComp->SetTerrainNode(mTerrain.get());
+   CPPUNIT_ASSERT(pagingComp->GetTerrainNode() == mTerrain.get());
+
+   pagingComp->UpdateTerrainPhysics();
+   CPPUNIT_ASSERT(pagingComp->GetLandActor() != NULL);
+   CPPUNIT_ASSERT_EQUAL(1U, pagingComp->GetLastNumFocusPoints());
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The static tile is out of range of the camera.", 0U, pagingComp->GetLastNumGeodesChecked());
+   CPPUNIT_ASSERT_EQUAL(0U, pagingComp->GetLastNumTilesReindexed());
+
+   // Page in a tile next to the camera.
+   osg::Geode* pagedGeode = NULL;
+   PageIn(*pagedNode, *CreateTile(osg::Vec3(2000.0f, 0.0f, 0.0f), pagedGeode));
+   pagingComp->UpdateTerrainPhysics();
+   CPPUNIT_ASSERT_EQUAL(1U, pagingComp->GetLastNumTilesReindexed());
+   CPPUNIT_ASSERT_EQUAL(1U, pagingComp->GetLastNumGeodesChecked());
+
+   pagingComp->UpdateTerrainPhysics();
+   CPPUNIT_ASSERT_EQUAL(0U, pagingComp->GetLastNumTilesReindexed());
+   CPPUNIT_ASSERT_EQUAL(1U, pagingComp->GetLastNumGeodesChecked());
+
+   // Page it back out.
+   pagedNode->removeChildren(0, pagedNode->getNumChildren());
+   pagingComp->UpdateTerrainPhysics();
+   CPPUNIT_ASSERT_EQUAL(1U, pagingComp->GetLastNumTilesReindexed());
+   CPPUNIT_ASSERT_EQUAL(0U, pagingComp->GetLastNumGeodesChecked());
+   CPPUNIT_ASSERT_EQUAL(1U, pagingComp->GetGeodeIndex().GetNumGeodes());
+
+   dtCore::System::GetInstance().Stop();
+   gm->DeleteAllActors(true);
+   gm->RemoveComponent(*pagingComp);
+   gm->Shutdown();
+}
@@ -0,0 +1,255 @@
+/* -*-c++-*-
+* Simulation Core - TextureProjectorComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/system.h>
+#include <dtCore/scene.h>
+#include <dtGame/basemessages.h>
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagetype.h>
+
+#include <SimCore/Components/TextureProjectorComponent.h>
+#include <SimCore/Actors/TextureProjectorActor.h>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+#include <vector>
+
+class TextureProjectorComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(TextureProjectorComponentTests);
+      CPPUNIT_TEST(TestExpiry);
+      CPPUNIT_TEST(TestMaxProjectedTextures);
+      CPPUNIT_TEST(TestReuse);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestExpiry();
+      void TestMaxProjectedTextures();
+      void TestReuse();
+
+   private:
+      /// Gets a projector from the component, adds it to the game manager and registers it with the component.
+      SimCore::Actors::TextureProjectorActor& AddProjector(float maxTime);
+      void TickTo(double simTime);
+
+      dtCore::RefPtr<dtGame::GameManager> mGM;
+      dtCore::RefPtr<SimCore::Components::TextureProjectorComponent> mProjectorComp;
+      std::vector<dtCore::RefPtr<SimCore::Actors::TextureProjectorActorProxy> > mProjectors;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TextureProjectorComponentTests);
+
+/////////////////////////////////////////////////////////
+void TextureProjectorComponentTests::setUp()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtABC::Application& app = GetGlobalApplication();
+   mGM = new dtGame::GameManager(*app.GetScene());
+   mGM->SetApplication(app);
+
+   mProjectorComp = new SimCore::Components::TextureProjectorComponent();
+   mGM->AddComponent(*mProjectorComp, dtGame::GameManager::ComponentPriority::NORMAL);
+}
+
+/////////////////////////////////////////////////////////
+void TextureProjectorComponentTests::tearDown()
+{
+   dtCore::System::GetInstance().Stop();
+
+   mProjectors.clear();
+   if (mGM.valid())
+   {
+      mGM->DeleteAllActors(true);
+      mGM->RemoveComponent(*mProjectorComp);
+   }
+
+   mProjectorComp = NULL;
+   mGM = NULL;
+}
+
+/////////////////////////////////////////////////////////
+SimCore::Actors::TextureProjectorActor& TextureProjectorComponentTests::AddProjector(float maxTime)
+{
+   bool reused = false;
+   dtCore::RefPtr<SimCore::Actors::TextureProjectorActorProxy> proxy = mProjectorComp->AcquireTextureProjector(reused);
+   CPPUNIT_ASSERT(proxy.valid());
+
+   if (!reused)
+   {
+      // With no node to attach to, the projector can't project when it enters the world.
+      mGM->AddActor(*proxy, false, false);
+      mProjectors.push_back(proxy);
+   }
+
+   SimCore::Actors::TextureProjectorActor* actor = NULL;
+   proxy->GetDrawable(actor);
+   actor->SetMaxTime(maxTime);
+   mProjectorComp->AddTextureProjectorActorToComponent(*actor);
+   return *actor;
+}
+
+/////////////////////////////////////////////////////////
+void TextureProjectorComponentTests::TickTo(double simTime)
+{
+   dtCore::RefPtr<dtGame::TickMessage> tickMsg;
+   mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::TICK_LOCAL, tickMsg);
+   tickMsg->SetSimulationTime(simTime);
+   mProjectorComp->ProcessTick(*tickMsg);
+}
+
+/////////////////////////////////////////////////////////
+void TextureProjectorComponentTests::TestExpiry()
+{
+   SimCore::Actors::TextureProjectorActor& shortLived = AddProjector(1.0f);
+   SimCore::Actors::TextureProjectorActor& longLived = AddProjector(10.0f);
+   CPPUNIT_ASSERT_EQUAL(2U, mProjectorComp->GetNumProjectedTextures());
+
+   // The actors age on their own ticks, so both have to pass their max time.
+   shortLived.SetCurrTime(0.5f);
+   TickTo(0.5);
+   CPPUNIT_ASSERT_EQUAL(2U, mProjectorComp->GetNumProjectedTextures());
+
+   shortLived.SetCurrTime(1.5f);
+   longLived.SetCurrTime(1.5f);
+   TickTo(1.5);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumProjectedTextures());
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+   CPPUNIT_ASSERT_MESSAGE("An expired projector should stay in the game manager to be reused.",
+      mGM->FindActorById(shortLived.GetUniqueId()) != NULL);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, shortLived.GetCurrTime(), 0.001f);
+
+   // Giving the projector more time keeps it around past its first expiry.
+   longLived.SetMaxTime(20.0f);
+   longLived.SetCurrTime(10.5f);
+   TickTo(10.5);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumProjectedTextures());
+
+   longLived.SetCurrTime(20.5f);
+   TickTo(20.5);
+   CPPUNIT_ASSERT_EQUAL(0U, mProjectorComp->GetNumProjectedTextures());
+   CPPUNIT_ASSERT_EQUAL(2U, mProjectorComp->GetNumIdleProjectors());
+
+   // A removed projector doesn't expire.  This one is taken from the idle projectors.
+   SimCore::Actors::TextureProjectorActor& removed = AddProjector(1.0f);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+   mProjectorComp->RemoveTextureProjectorActorFromComponent(removed);
+   CPPUNIT_ASSERT_EQUAL(0U, mProjectorComp->GetNumProjectedTextures());
+   removed.SetCurrTime(5.0f);
+   TickTo(25.0);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+}
+
+/////////////////////////////////////////////////////////
+void TextureProjectorComponentTests::TestMaxProjectedTextures()
+{
+   mProjectorComp->SetMaxNumberOfProjectedTextures(3);
+   mProjectorComp->SetMaxIdleProjectors(1);
+
+   std::vector<SimCore::Actors::TextureProjectorActor*> actors;
+   for (unsigned i = 0; i < 5; ++i)
+   {
+      // Added with the longest time first, so the last ones added expire first.
+      actors.push_back(&AddProjector(float(10 - i)));
+   }
+
+   TickTo(0.0);
+   CPPUNIT_ASSERT_EQUAL(3U, mProjectorComp->GetNumProjectedTextures());
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+
+   // Let the game manager process the delete.
+   dtCore::System::GetInstance().Step();
+
+   for (unsigned i = 0; i < 3; ++i)
+   {
+      CPPUNIT_ASSERT_MESSAGE("The projectors closest to expiring should be removed first.",
+         mGM->FindActorById(actors[i]->GetUniqueId()) != NULL);
+   }
+
+   // One of the two evicted projectors is kept idle, and the other is deleted.
+   unsigned numInGM = 0;
+   for (unsigned i = 3; i < 5; ++i)
+   {
+      if (mGM->FindActorById(actors[i]->GetUniqueId()) != NULL)
+      {
+         ++numInGM;
+      }
+   }
+   CPPUNIT_ASSERT_EQUAL(1U, numInGM);
+}
+
+/////////////////////////////////////////////////////////
+void TextureProjectorComponentTests::TestReuse()
+{
+   SimCore::Actors::TextureProjectorActor& actor = AddProjector(1.0f);
+   actor.SetCurrTime(2.0f);
+   TickTo(2.0);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+   CPPUNIT_ASSERT(!actor.IsProjecting());
+
+   bool reused = false;
+   dtCore::RefPtr<SimCore::Actors::TextureProjectorActorProxy> proxy = mProjectorComp->AcquireTextureProjector(reused);
+   CPPUNIT_ASSERT(reused);
+   CPPUNIT_ASSERT(proxy->GetId() == actor.GetUniqueId());
+   CPPUNIT_ASSERT_EQUAL(0U, mProjectorComp->GetNumIdleProjectors());
+
+   // An idle projector deleted from the game manager isn't handed out again.
+   actor.SetCurrTime(0.0f);
+   mProjectorComp->AddTextureProjectorActorToComponent(actor);
+   actor.SetCurrTime(2.0f);
+   TickTo(4.0);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+
+   mGM->DeleteActor(*proxy);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(0U, mProjectorComp->GetNumIdleProjectors());
+
+   proxy = mProjectorComp->AcquireTextureProjector(reused);
+   CPPUNIT_ASSERT(proxy.valid());
+   CPPUNIT_ASSERT(!reused);
+
+   // Lowering the bound deletes the idle projectors that no longer fit.
+   mGM->AddActor(*proxy, false, false);
+   mProjectors.push_back(proxy);
+   SimCore::Actors::TextureProjectorActor* newActor = NULL;
+   proxy->GetDrawable(newActor);
+   newActor->SetMaxTime(1.0f);
+   mProjectorComp->AddTextureProjectorActorToComponent(*newActor);
+   newActor->SetCurrTime(2.0f);
+   TickTo(6.0);
+   CPPUNIT_ASSERT_EQUAL(1U, mProjectorComp->GetNumIdleProjectors());
+
+   mProjectorComp->SetMaxIdleProjectors(0);
+   CPPUNIT_ASSERT_EQUAL(0U, mProjectorComp->GetNumIdleProjectors());
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT(mGM->FindActorById(proxy->GetId()) == NULL);
+}
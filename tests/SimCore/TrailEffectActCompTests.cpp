@@ -26,6 +26,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <string>
+#include <vector>
 #include <dtGame/gamemanager.h>
 #include <dtGame/deadreckoningcomponent.h>
 #include <dtGame/drpublishingactcomp.h>
@@ -41,6 +42,9 @@
 #include <SimCore/Actors/EntityActorRegistry.h>
 #include <SimCore/Actors/Platform.h>
 #include <SimCore/ActComps/TrailEffectActComp.h>
+#include <SimCore/Components/TrailEffectBatchComponent.h>
+#include <SimCore/TrailEffectBatch.h>
+#include <dtCore/transform.h>
 
 #include <dtGame/testcomponent.h>
 #include <UnitTestMain.h>
@@ -62,6 +66,7 @@ namespace SimCore
 
          CPPUNIT_TEST(TestProperties);
          CPPUNIT_TEST(TestOnActor);
+         CPPUNIT_TEST(TestRibbonsInBatch);
 
          CPPUNIT_TEST_SUITE_END();
 
@@ -115,6 +120,12 @@ namespace SimCore
                CPPUNIT_ASSERT(constComp->GetTrailEnableDistance() != 7.0f);
                actComp->SetTrailEnableDistance(7.0f);
                CPPUNIT_ASSERT(constComp->GetTrailEnableDistance() == 7.0f);
+
+               // Trails go through the ribbon batch unless turned off.
+               CPPUNIT_ASSERT(TrailEffectActComp::DEFAULT_TRAIL_RIBBON_WIDTH > 0.0f);
+               CPPUNIT_ASSERT(constComp->GetTrailRibbonWidth() == TrailEffectActComp::DEFAULT_TRAIL_RIBBON_WIDTH);
+               actComp->SetTrailRibbonWidth(0.0f);
+               CPPUNIT_ASSERT(constComp->GetTrailRibbonWidth() == 0.0f);
                
                std::string nodeName("TestNodeName");
                CPPUNIT_ASSERT(constComp->GetTrailAttachNodeName().empty());
@@ -152,6 +163,86 @@ namespace SimCore
                CPPUNIT_ASSERT(actComp->IsEnabled());
             }
 
+            void TestRibbonsInBatch()
+            {
+               using namespace SimCore::ActComps;
+               using namespace SimCore::Actors;
+
+               RefPtr<SimCore::Components::TrailEffectBatchComponent> batchComp = new SimCore::Components::TrailEffectBatchComponent;
+               mGM->AddComponent(*batchComp, dtGame::GameManager::ComponentPriority::NORMAL);
+               SimCore::TrailEffectBatch* batch = batchComp->GetBatch();
+               CPPUNIT_ASSERT(batch != NULL);
+
+               const unsigned numTrails = 3;
+               std::vector<RefPtr<PlatformActorProxy> > platforms;
+               std::vector<TrailEffectActComp*> actComps;
+               for (unsigned i = 0; i < numTrails; ++i)
+               {
+                  RefPtr<PlatformActorProxy> platform;
+                  mGM->CreateActor(*EntityActorRegistry::HELO_PLATFORM_ACTOR_TYPE, platform);
+                  TrailEffectActComp* actComp = platform->GetComponent<TrailEffectActComp>();
+                  CPPUNIT_ASSERT(actComp != NULL);
+                  actComp->SetTrailAttached(false);
+                  actComp->SetTrailRibbonWidth(0.5f);
+                  // Only clamp on the first update, since there is no terrain to clamp to.
+                  actComp->SetTrailClampInterval(1000.0f);
+
+                  mGM->AddActor(*platform, false, false);
+                  CPPUNIT_ASSERT(actComp->HasRibbon());
+                  platforms.push_back(platform);
+                  actComps.push_back(actComp);
+               }
+               CPPUNIT_ASSERT_EQUAL(int(numTrails), batch->GetNumActiveTrails());
+
+               for (unsigned i = 0; i < numTrails; ++i)
+               {
+                  // The failed clamp disables the trail, so turn it back on.
+                  actComps[i]->Update(0.1f);
+                  actComps[i]->SetEnabled(true);
+                  actComps[i]->Update(0.1f);
+               }
+               batch->Update();
+               CPPUNIT_ASSERT_EQUAL(numTrails, batch->GetLastFrameStats().mUpdatedTrails);
+
+               // Move each platform twice, far enough for a new point each time, and once not far enough.
+               const float steps[] = { 5.0f, 10.0f, 10.5f };
+               for (unsigned s = 0; s < 3; ++s)
+               {
+                  for (unsigned i = 0; i < numTrails; ++i)
+                  {
+                     dtCore::Transformable* drawable = NULL;
+                     platforms[i]->GetDrawable(drawable);
+                     dtCore::Transform xform;
+                     xform.SetTranslation(osg::Vec3(float(i) * 20.0f, steps[s], 0.0f));
+                     drawable->SetTransform(xform);
+                     actComps[i]->Update(0.1f);
+                  }
+               }
+               batch->Update();
+               CPPUNIT_ASSERT_EQUAL(numTrails, batch->GetLastFrameStats().mUpdatedTrails);
+               CPPUNIT_ASSERT_EQUAL(numTrails * 2, batch->GetLastFrameStats().mPointsApplied);
+
+               // The width change goes to the trail in the batch.
+               actComps[0]->SetTrailRibbonWidth(2.0f);
+               unsigned numWide = 0;
+               for (int trailId = 0; trailId < batch->GetCapacity(); ++trailId)
+               {
+                  if (batch->GetTrailWidth(trailId) == 2.0f)
+                  {
+                     ++numWide;
+                  }
+               }
+               CPPUNIT_ASSERT_EQUAL(1U, numWide);
+
+               // Removing the actors frees their trails.
+               for (unsigned i = 0; i < numTrails; ++i)
+               {
+                  mGM->DeleteActor(*platforms[i]);
+               }
+               dtCore::System::GetInstance().Step();
+               CPPUNIT_ASSERT_EQUAL(0, batch->GetNumActiveTrails());
+            }
+
          private:
 
             RefPtr<dtGame::GameManager> mGM;
@@ -0,0 +1,167 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2008, Alion Science and Technology
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// INCLUDE DIRECTIVES
+////////////////////////////////////////////////////////////////////////////////
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <osg/Geometry>
+#include <dtCore/refptr.h>
+
+#include <SimCore/TrailEffect.h>
+#include <SimCore/TrailEffectBatch.h>
+
+#include <UnitTestMain.h>
+
+
+
+namespace SimCore
+{
+   class TrailEffectBatchTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(TrailEffectBatchTests);
+
+      CPPUNIT_TEST(TestAddRemove);
+      CPPUNIT_TEST(TestSinglePassUpdate);
+      CPPUNIT_TEST(TestGrow);
+      CPPUNIT_TEST(TestTrailEffectInBatch);
+
+      CPPUNIT_TEST_SUITE_END();
+
+      public:
+
+         void setUp()
+         {
+            mBatch = new TrailEffectBatch(4, 2);
+         }
+
+         void tearDown()
+         {
+            mBatch = NULL;
+         }
+
+         void TestAddRemove()
+         {
+            CPPUNIT_ASSERT_EQUAL(4, mBatch->GetSegmentCount());
+            CPPUNIT_ASSERT_EQUAL(2, mBatch->GetCapacity());
+            CPPUNIT_ASSERT_EQUAL(0, mBatch->GetNumActiveTrails());
+
+            int trail0 = mBatch->AddTrail(osg::Vec3(1.0f, 2.0f, 3.0f), 2.0f);
+            int trail1 = mBatch->AddTrail(osg::Vec3(4.0f, 5.0f, 6.0f));
+            CPPUNIT_ASSERT(trail0 != trail1);
+            CPPUNIT_ASSERT(mBatch->IsTrailActive(trail0));
+            CPPUNIT_ASSERT_EQUAL(2.0f, mBatch->GetTrailWidth(trail0));
+            CPPUNIT_ASSERT_EQUAL(2, mBatch->GetNumActiveTrails());
+
+            mBatch->Update();
+            // The draws are counted as they happen, and nothing is rendered here.
+            CPPUNIT_ASSERT_EQUAL(0U, mBatch->GetLastFrameStats().mDrawCalls);
+            CPPUNIT_ASSERT(mBatch->GetGeometry()->getDrawCallback() != NULL);
+            CPPUNIT_ASSERT_EQUAL(2U, mBatch->GetLastFrameStats().mUpdatedTrails);
+
+            mBatch->RemoveTrail(trail0);
+            CPPUNIT_ASSERT( ! mBatch->IsTrailActive(trail0));
+            CPPUNIT_ASSERT_EQUAL(1, mBatch->GetNumActiveTrails());
+
+            // The freed slot is reused.
+            CPPUNIT_ASSERT_EQUAL(trail0, mBatch->AddTrail(osg::Vec3()));
+
+            mBatch->RemoveTrail(trail0);
+            mBatch->RemoveTrail(trail1);
+            mBatch->Update();
+            CPPUNIT_ASSERT_EQUAL(0U, mBatch->GetLastFrameStats().mDrawCalls);
+         }
+
+         void TestSinglePassUpdate()
+         {
+            int trail = mBatch->AddTrail(osg::Vec3());
+            mBatch->Update();
+
+            const osg::Geometry* geom = mBatch->GetGeometry();
+            const osg::Vec3Array* verts = static_cast<const osg::Vec3Array*>(geom->getVertexArray());
+            CPPUNIT_ASSERT_EQUAL(1U, geom->getNumPrimitiveSets());
+
+            // Points are only queued until the update.
+            osg::Vec3 point(10.0f, 0.0f, 0.0f);
+            mBatch->SetNextPoint(trail, point);
+            mBatch->SetNextPoint(trail, point * 2.0f);
+            CPPUNIT_ASSERT(verts->at(2) != point);
+
+            mBatch->Update();
+            const TrailEffectBatch::FrameStats& stats = mBatch->GetLastFrameStats();
+            CPPUNIT_ASSERT_EQUAL(2U, stats.mPointsApplied);
+            CPPUNIT_ASSERT_EQUAL(1U, stats.mUpdatedTrails);
+            CPPUNIT_ASSERT(stats.mUpdateTimeMS >= 0.0);
+
+            CPPUNIT_ASSERT(verts->at(2) == point);
+            CPPUNIT_ASSERT(verts->at(3) == point);
+            CPPUNIT_ASSERT(verts->at(4) == point * 2.0f);
+
+            // Nothing changed, so nothing is uploaded.
+            mBatch->Update();
+            CPPUNIT_ASSERT_EQUAL(0U, mBatch->GetLastFrameStats().mVerticesUploaded);
+            CPPUNIT_ASSERT_EQUAL(0U, mBatch->GetLastFrameStats().mUpdatedTrails);
+         }
+
+         void TestGrow()
+         {
+            mBatch->AddTrail(osg::Vec3());
+            mBatch->AddTrail(osg::Vec3());
+            int trail = mBatch->AddTrail(osg::Vec3(1.0f, 1.0f, 1.0f));
+            CPPUNIT_ASSERT_EQUAL(4, mBatch->GetCapacity());
+            CPPUNIT_ASSERT(mBatch->IsTrailActive(trail));
+
+            mBatch->Update();
+            const osg::Geometry* geom = mBatch->GetGeometry();
+            const osg::Vec3Array* verts = static_cast<const osg::Vec3Array*>(geom->getVertexArray());
+            // 5 points per trail, 2 verts per point.
+            CPPUNIT_ASSERT_EQUAL(size_t(4 * 10), verts->size());
+            CPPUNIT_ASSERT(verts->at(trail * 10) == osg::Vec3(1.0f, 1.0f, 1.0f));
+            CPPUNIT_ASSERT_EQUAL(3U, mBatch->GetLastFrameStats().mActiveTrails);
+         }
+
+         void TestTrailEffectInBatch()
+         {
+            dtCore::RefPtr<TrailEffect> trail = new TrailEffect(8);
+            trail->SetWidth(3.0f);
+            trail->SetBatch(mBatch.get());
+            CPPUNIT_ASSERT(trail->GetBatch() == mBatch.get());
+            CPPUNIT_ASSERT_EQUAL(1, mBatch->GetNumActiveTrails());
+
+            trail->SetNextPoint(osg::Vec3(0.0f, 5.0f, 0.0f));
+            mBatch->Update();
+            CPPUNIT_ASSERT_EQUAL(1U, mBatch->GetLastFrameStats().mPointsApplied);
+
+            trail->SetBatch(NULL);
+            CPPUNIT_ASSERT_EQUAL(0, mBatch->GetNumActiveTrails());
+
+            trail->SetBatch(mBatch.get());
+            CPPUNIT_ASSERT_EQUAL(1, mBatch->GetNumActiveTrails());
+            trail = NULL;
+            CPPUNIT_ASSERT_EQUAL(0, mBatch->GetNumActiveTrails());
+         }
+
+      private:
+         dtCore::RefPtr<TrailEffectBatch> mBatch;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION(TrailEffectBatchTests);
+}
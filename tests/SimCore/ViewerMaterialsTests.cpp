@@ -47,10 +47,20 @@
 #include <UnitTestMain.h>
 #include <dtABC/application.h>
 
+#include <osg/Timer>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using SimCore::Components::ViewerMaterialComponent;
+
 class ViewerMaterialsTests : public CPPUNIT_NS::TestFixture
 {
    CPPUNIT_TEST_SUITE(ViewerMaterialsTests);
       CPPUNIT_TEST(TestFunction);
+      CPPUNIT_TEST(TestIndexedLookups);
+      CPPUNIT_TEST(TestFIDMisses);
+      CPPUNIT_TEST(TestLookupBenchmark);
    CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -84,6 +94,9 @@ class ViewerMaterialsTests : public CPPUNIT_NS::TestFixture
       }
 
       void TestFunction();
+      void TestIndexedLookups();
+      void TestFIDMisses();
+      void TestLookupBenchmark();
 
    private:
       dtCore::RefPtr<SimCore::Components::ViewerMaterialComponent> mMaterialComponent;
@@ -111,3 +124,144 @@ void ViewerMaterialsTests::TestFunction()
    const SimCore::Actors::ViewerMaterialActor& anotherMaterial2 = mMaterialComponent->GetConstMaterialByName("hummagass");
    CPPUNIT_ASSERT_MESSAGE("Should have returned the default material", anotherMaterial2.GetName() == "DefaultMaterial");
 }
+
+void ViewerMaterialsTests::TestIndexedLookups()
+{
+   SimCore::Actors::ViewerMaterialActor& dirt = mMaterialComponent->CreateOrChangeMaterialByName("Dirt");
+   SimCore::Actors::ViewerMaterialActor& fid100 = mMaterialComponent->CreateOrChangeMaterialByFID(100);
+   CPPUNIT_ASSERT_EQUAL(2U, mMaterialComponent->GetNumMaterials());
+
+   CPPUNIT_ASSERT(&mMaterialComponent->CreateOrChangeMaterialByName("Dirt") == &dirt);
+   CPPUNIT_ASSERT(&mMaterialComponent->CreateOrChangeMaterialByFID(100) == &fid100);
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByName("Dirt") == &dirt);
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByFID(100) == &fid100);
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByName(fid100.GetName()) == &fid100);
+   CPPUNIT_ASSERT_EQUAL(2U, mMaterialComponent->GetNumMaterials());
+
+   ViewerMaterialComponent::MaterialHandle dirtHandle = mMaterialComponent->FindMaterialHandle("Dirt");
+   ViewerMaterialComponent::MaterialHandle fidHandle = mMaterialComponent->FindMaterialHandleByFID(100);
+   CPPUNIT_ASSERT(mMaterialComponent->IsValidHandle(dirtHandle));
+   CPPUNIT_ASSERT(mMaterialComponent->IsValidHandle(fidHandle));
+   CPPUNIT_ASSERT(dirtHandle != fidHandle);
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterial(dirtHandle) == &dirt);
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterial(fidHandle) == &fid100);
+
+   ViewerMaterialComponent::MaterialHandle missing = mMaterialComponent->FindMaterialHandle("hummagass");
+   CPPUNIT_ASSERT(!mMaterialComponent->IsValidHandle(missing));
+   CPPUNIT_ASSERT(!mMaterialComponent->IsValidHandle(mMaterialComponent->FindMaterialHandleByFID(101)));
+   CPPUNIT_ASSERT_EQUAL(std::string("DefaultMaterial"), mMaterialComponent->GetConstMaterial(missing).GetName());
+
+   // Renaming a material after it was added still finds it by the new name.
+   dirt.SetName("Mud");
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByName("Mud") == &dirt);
+   CPPUNIT_ASSERT(!mMaterialComponent->IsValidHandle(mMaterialComponent->FindMaterialHandle("Dirt")));
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterial(dirtHandle) == &dirt);
+
+   // A renamed FID material is no longer the material of the code, so the code gets a new one.
+   fid100.SetName("Gravel");
+   CPPUNIT_ASSERT_EQUAL(std::string("DefaultMaterial"), mMaterialComponent->GetConstMaterialByFID(100).GetName());
+   unsigned numMaterials = mMaterialComponent->GetNumMaterials();
+   SimCore::Actors::ViewerMaterialActor& newFid100 = mMaterialComponent->CreateOrChangeMaterialByFID(100);
+   CPPUNIT_ASSERT(&newFid100 != &fid100);
+   CPPUNIT_ASSERT_EQUAL(numMaterials + 1, mMaterialComponent->GetNumMaterials());
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByFID(100) == &newFid100);
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByName("Gravel") == &fid100);
+}
+
+void ViewerMaterialsTests::TestFIDMisses()
+{
+   mMaterialComponent->CreateOrChangeMaterialByName("DefaultMaterial");
+
+   // The misses are remembered, and asking again still gives the default.
+   CPPUNIT_ASSERT(!mMaterialComponent->IsValidHandle(mMaterialComponent->FindMaterialHandleByFID(200)));
+   CPPUNIT_ASSERT_EQUAL(std::string("DefaultMaterial"), mMaterialComponent->GetConstMaterialByFID(200).GetName());
+   CPPUNIT_ASSERT_EQUAL(std::string("DefaultMaterial"), mMaterialComponent->GetConstMaterialByFID(200).GetName());
+
+   // Adding the material of the code replaces the remembered miss.
+   SimCore::Actors::ViewerMaterialActor& fid200 = mMaterialComponent->CreateOrChangeMaterialByName("MATERIAL: 200 TYPE: FID");
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByFID(200) == &fid200);
+
+   // So does renaming a material to the name of the code.
+   SimCore::Actors::ViewerMaterialActor& sand = mMaterialComponent->CreateOrChangeMaterialByName("Sand");
+   mGM->AddActor(sand, false, false);
+   CPPUNIT_ASSERT(!mMaterialComponent->IsValidHandle(mMaterialComponent->FindMaterialHandleByFID(201)));
+   sand.SetName("MATERIAL: 201 TYPE: FID");
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByFID(201) == &sand);
+
+   // And renaming it away makes the code miss again.
+   sand.SetName("Sand");
+   CPPUNIT_ASSERT(!mMaterialComponent->IsValidHandle(mMaterialComponent->FindMaterialHandleByFID(201)));
+   CPPUNIT_ASSERT(&mMaterialComponent->GetConstMaterialByName("Sand") == &sand);
+}
+
+void ViewerMaterialsTests::TestLookupBenchmark()
+{
+   const unsigned numMaterials = 300;
+   const unsigned numLookups = 100000;
+
+   std::vector<dtCore::RefPtr<SimCore::Actors::ViewerMaterialActor> > materials;
+   for (unsigned i = 0; i < numMaterials; ++i)
+   {
+      materials.push_back(&mMaterialComponent->CreateOrChangeMaterialByFID(1000 + i));
+   }
+   CPPUNIT_ASSERT_EQUAL(numMaterials, mMaterialComponent->GetNumMaterials());
+
+   osg::Timer* timer = osg::Timer::instance();
+
+   // The old lookup, which made the name from the FID and then searched the list.
+   osg::Timer_t start = timer->tick();
+   unsigned linearFound = 0;
+   for (unsigned i = 0; i < numLookups; ++i)
+   {
+      std::ostringstream name;
+      name << "MATERIAL: " << (1000 + (i * 7) % numMaterials) << " TYPE: FID";
+      const std::string nameString = name.str();
+      for (unsigned j = 0; j < materials.size(); ++j)
+      {
+         if (materials[j]->GetName() == nameString)
+         {
+            ++linearFound;
+            break;
+         }
+      }
+   }
+   double linearMs = timer->delta_m(start, timer->tick());
+
+   start = timer->tick();
+   unsigned hashFound = 0;
+   for (unsigned i = 0; i < numLookups; ++i)
+   {
+      const SimCore::Actors::ViewerMaterialActor& material
+         = mMaterialComponent->GetConstMaterialByFID(1000 + (i * 7) % numMaterials);
+      if (&material == materials[(i * 7) % numMaterials].get())
+      {
+         ++hashFound;
+      }
+   }
+   double hashMs = timer->delta_m(start, timer->tick());
+
+   std::vector<ViewerMaterialComponent::MaterialHandle> handles;
+   for (unsigned i = 0; i < numMaterials; ++i)
+   {
+      handles.push_back(mMaterialComponent->FindMaterialHandleByFID(1000 + i));
+   }
+   start = timer->tick();
+   unsigned handleFound = 0;
+   for (unsigned i = 0; i < numLookups; ++i)
+   {
+      const SimCore::Actors::ViewerMaterialActor& material
+         = mMaterialComponent->GetConstMaterial(handles[(i * 7) % numMaterials]);
+      if (&material == materials[(i * 7) % numMaterials].get())
+      {
+         ++handleFound;
+      }
+   }
+   double handleMs = timer->delta_m(start, timer->tick());
+
+   CPPUNIT_ASSERT_EQUAL(numLookups, linearFound);
+   CPPUNIT_ASSERT_EQUAL(numLookups, hashFound);
+   CPPUNIT_ASSERT_EQUAL(numLookups, handleFound);
+
+   std::cout << "\n\t" << numLookups << " lookups in " << numMaterials << " materials took " << linearMs
+      << " ms by name search, " << hashMs << " ms by FID and " << handleMs << " ms by handle.\n" << std::endl;
+}
@@ -32,6 +32,9 @@
 
 #include <dtCore/refptr.h>
 #include <dtCore/observerptr.h>
+#include <dtCore/camera.h>
+#include <dtCore/transform.h>
+#include <dtABC/application.h>
 #include <dtUtil/mathdefines.h>
 
 #include <UnitTestMain.h>
@@ -52,6 +55,9 @@ namespace SimCore
          CPPUNIT_TEST(TestShapeVolumeRecordClass);
          CPPUNIT_TEST(TestAddRemoveVolume);
          CPPUNIT_TEST(TestAutoDeleteVolumes);
+         CPPUNIT_TEST(TestSeededPoints);
+         CPPUNIT_TEST(TestBackgroundPointGeneration);
+         CPPUNIT_TEST(TestSortByCameraDistance);
          //CPPUNIT_TEST(TestTransformVolumes);
 
          CPPUNIT_TEST_SUITE_END();
@@ -204,6 +210,108 @@ namespace SimCore
             CPPUNIT_ASSERT_MESSAGE("the fading volume intensity should less that or equal to zero.", volume3->mIntensity <= 0.0f);
          }
 
+         void TestSeededPoints()
+         {
+            const osg::Vec3 center(1.0f, 2.0f, 3.0f);
+            const osg::Vec3 radius(4.0f, 5.0f, 6.0f);
+
+            VolumeRenderingComponent::ParticleVolumeDrawable::PointList points1, points2, points3;
+            VolumeRenderingComponent::ParticleVolumeDrawable::CreateRandomPointsInVolume(VolumeRenderingComponent::BOX, 100, center, radius, 17, points1);
+            VolumeRenderingComponent::ParticleVolumeDrawable::CreateRandomPointsInVolume(VolumeRenderingComponent::BOX, 100, center, radius, 17, points2);
+            VolumeRenderingComponent::ParticleVolumeDrawable::CreateRandomPointsInVolume(VolumeRenderingComponent::BOX, 100, center, radius, 18, points3);
+
+            CPPUNIT_ASSERT_EQUAL(size_t(100), points1.size());
+            CPPUNIT_ASSERT_MESSAGE("The same seed should give the same points", points1 == points2);
+            CPPUNIT_ASSERT_MESSAGE("A different seed should give different points", points1 != points3);
+
+            dtCore::RefPtr<VolumeRenderingComponent::ShapeVolumeRecord> volume1 = new VolumeRenderingComponent::ShapeVolumeRecord;
+            dtCore::RefPtr<VolumeRenderingComponent::ShapeVolumeRecord> volume2 = new VolumeRenderingComponent::ShapeVolumeRecord;
+            CPPUNIT_ASSERT_MESSAGE("Each volume should get its own seed by default", volume1->GetRandomSeed() != volume2->GetRandomSeed());
+            volume2->mRandomSeed = 99;
+            CPPUNIT_ASSERT_EQUAL(99U, volume2->GetRandomSeed());
+         }
+
+         void TestBackgroundPointGeneration()
+         {
+            CPPUNIT_ASSERT(mVolumeRenderingComponent->GetGeneratePointsInBackground());
+
+            dtCore::RefPtr<VolumeRenderingComponent::ShapeVolumeRecord> volume1 = new VolumeRenderingComponent::ShapeVolumeRecord;
+            volume1->mRadius.set(3.0f, 3.0f, 3.0f);
+            volume1->mRandomSeed = 5;
+            mVolumeRenderingComponent->CreateShapeVolume(volume1.get());
+
+            // Make the same volume in the foreground to compare the points.
+            dtCore::RefPtr<VolumeRenderingComponent::ShapeVolumeRecord> volume2 = new VolumeRenderingComponent::ShapeVolumeRecord;
+            volume2->mRadius = volume1->mRadius;
+            volume2->mRandomSeed = 5;
+            mVolumeRenderingComponent->SetGeneratePointsInBackground(false);
+            mVolumeRenderingComponent->CreateShapeVolume(volume2.get());
+            CPPUNIT_ASSERT(!mVolumeRenderingComponent->IsVolumePending(volume2->GetId()));
+
+            mVolumeRenderingComponent->WaitForPendingVolumes();
+            CPPUNIT_ASSERT_EQUAL(0U, mVolumeRenderingComponent->GetNumPendingVolumes());
+            CPPUNIT_ASSERT(!mVolumeRenderingComponent->IsVolumePending(volume1->GetId()));
+
+            VolumeRenderingComponent::ParticleVolumeDrawable* drawable1 = volume1->mParticleDrawable.get();
+            VolumeRenderingComponent::ParticleVolumeDrawable* drawable2 = volume2->mParticleDrawable.get();
+            CPPUNIT_ASSERT(drawable1 != NULL && drawable2 != NULL);
+            CPPUNIT_ASSERT_EQUAL(drawable2->GetNumParticles(), drawable1->GetNumParticles());
+            for(unsigned i = 0; i < drawable1->GetNumParticles(); ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(drawable2->GetPointLocation(i), drawable1->GetPointLocation(i));
+            }
+
+            // A volume removed while its points are being made should just be dropped.
+            mVolumeRenderingComponent->SetGeneratePointsInBackground(true);
+            dtCore::RefPtr<VolumeRenderingComponent::ShapeVolumeRecord> volume3 = new VolumeRenderingComponent::ShapeVolumeRecord;
+            mVolumeRenderingComponent->CreateShapeVolume(volume3.get());
+            dtCore::ObserverPtr<VolumeRenderingComponent::ShapeVolumeRecord> volume3ob = volume3.get();
+            volume3 = NULL;
+            mVolumeRenderingComponent->RemoveShapeVolume(volume3ob.get());
+            CPPUNIT_ASSERT(!volume3ob.valid());
+
+            mVolumeRenderingComponent->WaitForPendingVolumes();
+            CPPUNIT_ASSERT_EQUAL(0U, mVolumeRenderingComponent->GetNumPendingVolumes());
+
+            const VolumeRenderingComponent::TimingStats& stats = mVolumeRenderingComponent->GetTimingStats();
+            CPPUNIT_ASSERT_EQUAL(3U, stats.mNumVolumesCreated);
+            CPPUNIT_ASSERT(stats.mPointGenerationMillis >= 0.0);
+            mVolumeRenderingComponent->ResetTimingStats();
+            CPPUNIT_ASSERT_EQUAL(0U, stats.mNumVolumesCreated);
+            CPPUNIT_ASSERT_EQUAL(0.0, stats.mPointGenerationMillis);
+         }
+
+         void TestSortByCameraDistance()
+         {
+            dtCore::Transform xform;
+            xform.SetTranslation(osg::Vec3(0.0f, 0.0f, 0.0f));
+            GetGlobalApplication().GetCamera()->SetTransform(xform);
+
+            const float distances[] = { 40.0f, 10.0f, 30.0f, 20.0f };
+            std::vector<dtCore::RefPtr<VolumeRenderingComponent::ShapeVolumeRecord> > volumes;
+            for(unsigned i = 0; i < 4; ++i)
+            {
+               volumes.push_back(new VolumeRenderingComponent::ShapeVolumeRecord);
+               volumes.back()->mPosition.set(0.0f, distances[i], 0.0f);
+               mVolumeRenderingComponent->CreateShapeVolume(volumes.back().get());
+            }
+
+            mVolumeRenderingComponent->TransformAndSortVolumes();
+            CheckSortedVolumes();
+            CPPUNIT_ASSERT(mVolumeRenderingComponent->GetVolumes().front() == volumes[1]);
+
+            // Move one and add one, so both the sorted and new volumes are merged.
+            volumes[0]->mPosition.set(0.0f, 5.0f, 0.0f);
+            volumes.push_back(new VolumeRenderingComponent::ShapeVolumeRecord);
+            volumes.back()->mPosition.set(0.0f, 25.0f, 0.0f);
+            mVolumeRenderingComponent->CreateShapeVolume(volumes.back().get());
+
+            mVolumeRenderingComponent->TransformAndSortVolumes();
+            CheckSortedVolumes();
+            CPPUNIT_ASSERT_EQUAL(size_t(5), mVolumeRenderingComponent->GetVolumes().size());
+            CPPUNIT_ASSERT(mVolumeRenderingComponent->GetVolumes().front() == volumes[0]);
+         }
+
          //void TestTransformVolumes()
          //{
          //   dtCore::RefPtr<VolumeRenderingComponent::ShapeVolume> volume1 = new VolumeRenderingComponent::ShapeVolume;
@@ -277,6 +385,16 @@ namespace SimCore
 
       private:
 
+         void CheckSortedVolumes()
+         {
+            const VolumeRenderingComponent::ShapeVolumeArray& sorted = mVolumeRenderingComponent->GetVolumes();
+            for(unsigned i = 1; i < sorted.size(); ++i)
+            {
+               CPPUNIT_ASSERT_MESSAGE("The volumes should be sorted nearest to the camera first",
+                        sorted[i - 1]->mCameraDistanceSqr <= sorted[i]->mCameraDistanceSqr);
+            }
+         }
+
          void TestSingleVolume(const VolumeRenderingComponent::ShapeVolumeRecord& testvolume)
          {
             CPPUNIT_ASSERT_EQUAL(VolumeRenderingComponent::SPHERE, testvolume.mShapeType);
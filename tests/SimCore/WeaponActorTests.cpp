@@ -28,6 +28,7 @@
 #include <prefix/SimCorePrefix.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <cmath>
 #include <dtUtil/macros.h>
 
 #include <dtCore/system.h>
@@ -77,6 +78,8 @@ namespace SimCore
          CPPUNIT_TEST(TestWeaponProperties);
          CPPUNIT_TEST(TestRemoveFromWorld);
          CPPUNIT_TEST(TestMessageProcessing);
+         CPPUNIT_TEST(TestBallisticSolver);
+         CPPUNIT_TEST(TestBallisticRounds);
 
          CPPUNIT_TEST_SUITE_END();
 
@@ -89,6 +92,8 @@ namespace SimCore
             void TestWeaponProperties();
             void TestRemoveFromWorld();
             void TestMessageProcessing();
+            void TestBallisticSolver();
+            void TestBallisticRounds();
 
             // Utility Functions -----------------------------------------------
 
@@ -787,5 +792,109 @@ namespace SimCore
          CPPUNIT_ASSERT_EQUAL(5U, mTestComp->GetShotMessageCount());
          CPPUNIT_ASSERT_EQUAL(5U, mTestComp->GetDetonationMessageCount());
       }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponActorTests::TestBallisticSolver()
+      {
+         typedef SimCore::Actors::MunitionParticlesActor Shooter;
+         const osg::Vec3 gravity(0.0f, 0.0f, -10.0f);
+         const osg::Vec3 startVelocity(300.0f, 0.0f, 50.0f);
+
+         Shooter::BallisticRoundList rounds(2);
+         rounds[0].mVelocity = startVelocity;
+         rounds[0].mTimeLeft = 5.0f;
+         rounds[1].mPosition.set(10.0f, 0.0f, 0.0f);
+         rounds[1].mVelocity = startVelocity;
+         rounds[1].mTimeLeft = 5.0f;
+
+         // Without drag it is a parabola, whatever the step size.
+         for (unsigned i = 0; i < 20; ++i)
+         {
+            Shooter::AdvanceBallisticRounds(rounds, gravity, 0.0f, 0.05f);
+         }
+         osg::Vec3 expected = startVelocity + gravity * 0.5f;
+         CPPUNIT_ASSERT(dtUtil::Equivalent(rounds[0].mPosition, expected, 1e-2f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(rounds[1].mPosition, expected + osg::Vec3(10.0f, 0.0f, 0.0f), 1e-2f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(rounds[0].mVelocity, startVelocity + gravity, 1e-3f));
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0f, rounds[0].mTimeLeft, 1e-4f);
+         CPPUNIT_ASSERT_MESSAGE("The last position should be where the last step started.",
+                  dtUtil::Equivalent(rounds[0].mLastPosition, rounds[0].mPosition - (rounds[0].mVelocity - gravity * 0.025f) * 0.05f, 1e-2f));
+
+         // With drag, many small steps should land where one big step does, since each step is exact.
+         const float drag = 0.5f;
+         Shooter::BallisticRoundList smallSteps(1), bigStep(1);
+         smallSteps[0].mVelocity = startVelocity;
+         bigStep[0].mVelocity = startVelocity;
+         for (unsigned i = 0; i < 100; ++i)
+         {
+            Shooter::AdvanceBallisticRounds(smallSteps, gravity, drag, 0.02f);
+         }
+         Shooter::AdvanceBallisticRounds(bigStep, gravity, drag, 2.0f);
+         CPPUNIT_ASSERT(dtUtil::Equivalent(smallSteps[0].mPosition, bigStep[0].mPosition, 1e-1f));
+         CPPUNIT_ASSERT(dtUtil::Equivalent(smallSteps[0].mVelocity, bigStep[0].mVelocity, 1e-2f));
+
+         // Drag slows the round toward the terminal velocity.
+         osg::Vec3 terminalVelocity = gravity / drag;
+         float e = std::exp(-drag * 2.0f);
+         osg::Vec3 expectedVelocity = terminalVelocity + (startVelocity - terminalVelocity) * e;
+         CPPUNIT_ASSERT(dtUtil::Equivalent(bigStep[0].mVelocity, expectedVelocity, 1e-2f));
+         CPPUNIT_ASSERT(bigStep[0].mPosition.x() < startVelocity.x() * 2.0f);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      void WeaponActorTests::TestBallisticRounds()
+      {
+         mGM->AddActor( *mWeaponProxy, false, false );
+         CreateShooter();
+         SimCore::Actors::MunitionParticlesActorProxy* shooterProxy = mWeapon->GetShooter();
+         CPPUNIT_ASSERT(shooterProxy != NULL);
+
+         SimCore::Actors::MunitionParticlesActor* shooter = NULL;
+         shooterProxy->GetDrawable(shooter);
+         CPPUNIT_ASSERT(!shooter->GetUseBallisticSolver());
+         shooter->SetUseBallisticSolver(true);
+         shooter->SetSystemToUseTracers(true);
+         shooter->SetFrequencyOfTracers(2);
+         shooter->SetParticleLengthofStay(1.0f);
+         shooter->SetLinearVelocityStartMin(osg::Vec3(0.0f, 100.0f, 0.0f));
+         shooter->SetLinearVelocityStartMax(osg::Vec3(0.0f, 100.0f, 0.0f));
+         mGM->AddActor(*shooterProxy, false, false);
+
+         for (unsigned i = 0; i < 6; ++i)
+         {
+            shooter->Fire();
+         }
+
+         CPPUNIT_ASSERT_EQUAL(6U, shooter->GetNumBallisticRounds());
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Ballistic rounds should not make physics particles.",
+                  0U, shooter->GetHowManyParticlesThisSystemHasSpawnedCurrently());
+         CPPUNIT_ASSERT_EQUAL(6U, shooter->GetHowManyParticlesHaveBeenMadeSinceStart());
+
+         unsigned numTracers = 0;
+         for (unsigned i = 0; i < shooter->GetNumBallisticRounds(); ++i)
+         {
+            if (shooter->GetBallisticRound(i).mTracer.valid())
+            {
+               ++numTracers;
+            }
+         }
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the tracer rounds should get visuals.", 2U, numTracers);
+
+         dtCore::RefPtr<dtGame::TickMessage> tickMsg;
+         mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::TICK_LOCAL, tickMsg);
+         tickMsg->SetDeltaSimTime(0.5f);
+         shooter->OnTickLocal(*tickMsg);
+         CPPUNIT_ASSERT_EQUAL(6U, shooter->GetNumBallisticRounds());
+         CPPUNIT_ASSERT(shooter->GetBallisticRound(0).mPosition.y() > 49.0f);
+
+         // The rounds time out, and are dropped on the tick after.
+         shooter->OnTickLocal(*tickMsg);
+         shooter->OnTickLocal(*tickMsg);
+         CPPUNIT_ASSERT_EQUAL(0U, shooter->GetNumBallisticRounds());
+
+         shooter->Fire();
+         shooter->ClearBallisticRounds();
+         CPPUNIT_ASSERT_EQUAL(0U, shooter->GetNumBallisticRounds());
+      }
    }
 }
@@ -0,0 +1,251 @@
+/* -*-c++-*-
+* Simulation Core - WheelAnimationComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2007-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/system.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/gamemanager.h>
+
+#include <SimCore/ActComps/WheelActComp.h>
+#include <SimCore/Actors/EntityActorRegistry.h>
+#include <SimCore/Components/WheelAnimationComponent.h>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+using SimCore::Components::WheelAnimationComponent;
+using SimCore::ActComps::WheelActComp;
+
+////////////////////////////////////////////////////////
+// Counts the rotation updates instead of turning any wheels.
+class CountingAxle : public SimCore::ActComps::Axle
+{
+   public:
+      CountingAxle()
+         : mNumUpdates(0)
+         , mTotalTime(0.0f)
+      {
+      }
+
+      virtual unsigned GetNumWheels() const { return 2; }
+
+      virtual void UpdateAxleRotation(float dt, float steerAngle, float speedmps)
+      {
+         ++mNumUpdates;
+         mTotalTime += dt;
+      }
+
+      virtual void UpdateWheelPosition(unsigned whichWheel, float jounceRebound) {}
+      virtual void SetWheelBaseTransform(unsigned whichWheel, const osg::Matrix& xform, bool worldRelative) {}
+      virtual void GetWheelBaseTransform(unsigned whichWheel, osg::Matrix& xform, bool worldRelative) {}
+
+      unsigned mNumUpdates;
+      float mTotalTime;
+
+   protected:
+      virtual ~CountingAxle() {}
+};
+
+class WheelAnimationComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(WheelAnimationComponentTests);
+      CPPUNIT_TEST(TestRegistration);
+      CPPUNIT_TEST(TestDistanceLod);
+      CPPUNIT_TEST(TestResetHeading);
+   CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp();
+      void tearDown();
+
+      void TestRegistration();
+      void TestDistanceLod();
+      void TestResetHeading();
+
+   private:
+      dtCore::RefPtr<dtGame::GameActorProxy> CreateVehicle(CountingAxle& axle, const osg::Vec3& position);
+
+      dtCore::RefPtr<dtGame::GameManager> mGM;
+      dtCore::RefPtr<WheelAnimationComponent> mWheelAnimation;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WheelAnimationComponentTests);
+
+/////////////////////////////////////////////////////////
+void WheelAnimationComponentTests::setUp()
+{
+   dtCore::System::GetInstance().Start();
+
+   dtABC::Application& app = GetGlobalApplication();
+   mGM = new dtGame::GameManager(*app.GetScene());
+   mGM->SetApplication(app);
+
+   mWheelAnimation = new WheelAnimationComponent();
+   mGM->AddComponent(*mWheelAnimation, dtGame::GameManager::ComponentPriority::NORMAL);
+}
+
+/////////////////////////////////////////////////////////
+void WheelAnimationComponentTests::tearDown()
+{
+   dtCore::System::GetInstance().Stop();
+
+   if (mGM.valid())
+   {
+      mGM->DeleteAllActors(true);
+   }
+
+   mWheelAnimation = NULL;
+   mGM = NULL;
+}
+
+/////////////////////////////////////////////////////////
+dtCore::RefPtr<dtGame::GameActorProxy> WheelAnimationComponentTests::CreateVehicle(CountingAxle& axle, const osg::Vec3& position)
+{
+   dtCore::RefPtr<dtGame::GameActorProxy> vehicle;
+   mGM->CreateActor(*SimCore::Actors::EntityActorRegistry::GROUND_PLATFORM_ACTOR_TYPE, vehicle);
+   CPPUNIT_ASSERT(vehicle.valid());
+
+   WheelActComp* wheels = vehicle->GetComponent<WheelActComp>();
+   CPPUNIT_ASSERT(wheels != NULL);
+   // Having an axle already keeps it from looking for wheels in the model.
+   wheels->AddAxle(&axle);
+
+   dtCore::Transformable* xformable = NULL;
+   vehicle->GetDrawable(xformable);
+   dtCore::Transform xform;
+   xform.SetTranslation(position);
+   xformable->SetTransform(xform);
+
+   // Remote, so it animates its wheels.
+   mGM->AddActor(*vehicle, true, false);
+   return vehicle;
+}
+
+/////////////////////////////////////////////////////////
+void WheelAnimationComponentTests::TestRegistration()
+{
+   dtCore::RefPtr<CountingAxle> axle = new CountingAxle;
+   dtCore::RefPtr<dtGame::GameActorProxy> vehicle = CreateVehicle(*axle, osg::Vec3(0.0f, 10.0f, 0.0f));
+
+   WheelActComp* wheels = vehicle->GetComponent<WheelActComp>();
+   CPPUNIT_ASSERT(mWheelAnimation->IsRegistered(*wheels));
+   CPPUNIT_ASSERT_EQUAL(1U, mWheelAnimation->GetNumVehicles());
+
+   // Registering again does nothing.
+   mWheelAnimation->RegisterWheels(*wheels);
+   CPPUNIT_ASSERT_EQUAL(1U, mWheelAnimation->GetNumVehicles());
+
+   // Close vehicles update every tick.
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   CPPUNIT_ASSERT_EQUAL(1U, mWheelAnimation->GetNumAxles());
+   CPPUNIT_ASSERT_EQUAL(1U, mWheelAnimation->GetNumUpdatedVehicles());
+   CPPUNIT_ASSERT_EQUAL(1U, axle->mNumUpdates);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1f, axle->mTotalTime, 0.0001f);
+
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   CPPUNIT_ASSERT_EQUAL(2U, axle->mNumUpdates);
+
+   // Adding an axle rebuilds the array.
+   dtCore::RefPtr<CountingAxle> axle2 = new CountingAxle;
+   wheels->AddAxle(axle2.get());
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   CPPUNIT_ASSERT_EQUAL(2U, mWheelAnimation->GetNumAxles());
+   CPPUNIT_ASSERT_EQUAL(3U, axle->mNumUpdates);
+   CPPUNIT_ASSERT_EQUAL(1U, axle2->mNumUpdates);
+
+   // Removing the vehicle from the world unregisters it.
+   mGM->DeleteActor(*vehicle);
+   dtCore::System::GetInstance().Step();
+   CPPUNIT_ASSERT_EQUAL(0U, mWheelAnimation->GetNumVehicles());
+
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   CPPUNIT_ASSERT_EQUAL(0U, mWheelAnimation->GetNumAxles());
+   CPPUNIT_ASSERT_EQUAL(0U, mWheelAnimation->GetNumUpdatedVehicles());
+}
+
+/////////////////////////////////////////////////////////
+void WheelAnimationComponentTests::TestDistanceLod()
+{
+   mWheelAnimation->SetLodDistance(300.0f);
+   mWheelAnimation->SetLodUpdateInterval(0.25f);
+   mWheelAnimation->SetMaxDistance(1000.0f);
+
+   dtCore::RefPtr<CountingAxle> axle = new CountingAxle;
+   CreateVehicle(*axle, osg::Vec3(0.0f, 500.0f, 0.0f));
+
+   // Past the LOD distance it waits for the interval, then turns the wheels for the whole time.
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   CPPUNIT_ASSERT_EQUAL(0U, axle->mNumUpdates);
+   CPPUNIT_ASSERT_EQUAL(0U, mWheelAnimation->GetNumUpdatedVehicles());
+
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3());
+   CPPUNIT_ASSERT_EQUAL(1U, axle->mNumUpdates);
+   CPPUNIT_ASSERT_EQUAL(1U, mWheelAnimation->GetNumUpdatedVehicles());
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(0.3f, axle->mTotalTime, 0.0001f);
+
+   // Up close it updates every tick.
+   mWheelAnimation->UpdateWheels(0.1f, osg::Vec3(0.0f, 450.0f, 0.0f));
+   CPPUNIT_ASSERT_EQUAL(2U, axle->mNumUpdates);
+
+   // Past the max distance it isn't animated at all.
+   for (unsigned i = 0; i < 5; ++i)
+   {
+      mWheelAnimation->UpdateWheels(0.1f, osg::Vec3(0.0f, -600.0f, 0.0f));
+   }
+   CPPUNIT_ASSERT_EQUAL(2U, axle->mNumUpdates);
+   CPPUNIT_ASSERT_EQUAL(0U, mWheelAnimation->GetNumUpdatedVehicles());
+
+   // No limit.
+   mWheelAnimation->SetMaxDistance(0.0f);
+   for (unsigned i = 0; i < 3; ++i)
+   {
+      mWheelAnimation->UpdateWheels(0.1f, osg::Vec3(0.0f, -600.0f, 0.0f));
+   }
+   CPPUNIT_ASSERT_EQUAL(3U, axle->mNumUpdates);
+}
+
+/////////////////////////////////////////////////////////
+void WheelAnimationComponentTests::TestResetHeading()
+{
+   dtCore::RefPtr<WheelActComp> wheels = new WheelActComp;
+   osg::Vec3 forward(0.0f, 1.0f, 0.0f);
+   osg::Vec3 velocity(0.0f, 5.0f, 0.0f);
+   float speedMps = 0.0f;
+   float steerAngle = 0.0f;
+
+   wheels->CalcWheelMotion(0.1f, velocity, 10.0f, forward, speedMps, steerAngle);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0f, speedMps, 0.0001f);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0f, steerAngle, 0.0001f);
+
+   // After a time without updates, the wheels steer from the reset heading, not the stale one.
+   wheels->ResetLastFrameHeading(90.0f);
+   wheels->CalcWheelMotion(0.1f, velocity, 91.0f, forward, speedMps, steerAngle);
+   CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0f, steerAngle, 0.0001f);
+}
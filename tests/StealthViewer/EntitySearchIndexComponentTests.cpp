@@ -0,0 +1,172 @@
+/* -*-c++-*-
+* Simulation Core - EntitySearchIndexComponentTests (.h & .cpp) - Using 'The MIT License'
+* Copyright (C) 2006-2008, Alion Science and Technology Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* This software was developed by Alion Science and Technology Corporation under
+* circumstances in which the U. S. Government may have rights in the software.
+*/
+#include <prefix/SimCorePrefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <StealthViewer/GMApp/EntitySearchIndexComponent.h>
+
+#include <SimCore/Actors/EntityActorRegistry.h>
+#include <SimCore/Actors/Platform.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtCore/system.h>
+#include <dtCore/scene.h>
+
+#include <algorithm>
+
+#include <UnitTestMain.h>
+#include <dtABC/application.h>
+
+class EntitySearchIndexComponentTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(EntitySearchIndexComponentTests);
+
+      CPPUNIT_TEST(TestPrefixSearch);
+      CPPUNIT_TEST(TestSubstringSearch);
+      CPPUNIT_TEST(TestRenameAndRemove);
+
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+
+   void setUp()
+   {
+      dtCore::System::GetInstance().Start();
+      mGM = new dtGame::GameManager(*GetGlobalApplication().GetScene());
+      mGM->SetApplication(GetGlobalApplication());
+
+      mIndex = new StealthGM::EntitySearchIndexComponent;
+      mGM->AddComponent(*mIndex, dtGame::GameManager::ComponentPriority::NORMAL);
+   }
+
+   void tearDown()
+   {
+      mIndex = NULL;
+      mGM->DeleteAllActors(true);
+      mGM = NULL;
+      dtCore::System::GetInstance().Stop();
+   }
+
+   dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> CreateEntity(const std::string& name)
+   {
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> eap;
+      mGM->CreateActor(*SimCore::Actors::EntityActorRegistry::PLATFORM_ACTOR_TYPE, eap);
+      CPPUNIT_ASSERT(eap.valid());
+      eap->SetName(name);
+      mGM->AddActor(*eap, false, false);
+      CPPUNIT_ASSERT(mIndex->IndexActor(*eap));
+      return eap;
+   }
+
+   bool Contains(const std::vector<dtCore::UniqueId>& ids, const dtGame::GameActorProxy& actor)
+   {
+      return std::find(ids.begin(), ids.end(), actor.GetId()) != ids.end();
+   }
+
+   void TestPrefixSearch()
+   {
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> alpha1 = CreateEntity("Alpha11");
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> alpha2 = CreateEntity("Alpha12");
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> bravo = CreateEntity("Bravo21");
+
+      CPPUNIT_ASSERT_EQUAL(3U, mIndex->GetNumEntities());
+
+      std::vector<dtCore::UniqueId> results;
+      mIndex->FindByPrefix("Alpha", results);
+      CPPUNIT_ASSERT_EQUAL(size_t(2), results.size());
+      CPPUNIT_ASSERT(Contains(results, *alpha1));
+      CPPUNIT_ASSERT(Contains(results, *alpha2));
+
+      results.clear();
+      mIndex->FindByPrefix("", results);
+      CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+
+      results.clear();
+      mIndex->FindByPrefix("Alpha", results, 1);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), results.size());
+
+      results.clear();
+      mIndex->FindByPrefix("Charlie", results);
+      CPPUNIT_ASSERT(results.empty());
+   }
+
+   void TestSubstringSearch()
+   {
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> alpha1 = CreateEntity("Alpha11");
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> alpha2 = CreateEntity("Alpha12");
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> bravo = CreateEntity("Bravo21");
+
+      std::vector<dtCore::UniqueId> results;
+      mIndex->FindBySubstring("a12", results);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), results.size());
+      CPPUNIT_ASSERT(Contains(results, *alpha2));
+
+      // Shorter than a trigram.
+      results.clear();
+      mIndex->FindBySubstring("1", results);
+      CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+
+      // Every trigram exists, but not in this order.
+      results.clear();
+      mIndex->FindBySubstring("lphavo", results);
+      CPPUNIT_ASSERT(results.empty());
+   }
+
+   void TestRenameAndRemove()
+   {
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> alpha1 = CreateEntity("Alpha11");
+      dtCore::RefPtr<SimCore::Actors::PlatformActorProxy> bravo = CreateEntity("Bravo21");
+
+      alpha1->SetName("Charlie31");
+      CPPUNIT_ASSERT(mIndex->IndexActor(*alpha1));
+      CPPUNIT_ASSERT_EQUAL(2U, mIndex->GetNumEntities());
+
+      std::vector<dtCore::UniqueId> results;
+      mIndex->FindByPrefix("Alpha", results);
+      CPPUNIT_ASSERT(results.empty());
+      mIndex->FindBySubstring("lie", results);
+      CPPUNIT_ASSERT(Contains(results, *alpha1));
+
+      mIndex->RemoveActor(alpha1->GetId());
+      CPPUNIT_ASSERT_EQUAL(1U, mIndex->GetNumEntities());
+      CPPUNIT_ASSERT(mIndex->GetEntity(alpha1->GetId()) == NULL);
+      CPPUNIT_ASSERT(mIndex->GetEntityAt(0) == bravo.get());
+
+      results.clear();
+      mIndex->FindBySubstring("lie", results);
+      CPPUNIT_ASSERT(results.empty());
+
+      // The index rebuilds from what is in the GM.
+      mIndex->Rebuild();
+      CPPUNIT_ASSERT_EQUAL(2U, mIndex->GetNumEntities());
+   }
+
+private:
+   dtCore::RefPtr<dtGame::GameManager> mGM;
+   dtCore::RefPtr<StealthGM::EntitySearchIndexComponent> mIndex;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EntitySearchIndexComponentTests);